@@ -15,6 +15,7 @@
 #include "google/cloud/bigtable/admin_client.h"
 #include "google/cloud/bigtable/internal/common_client.h"
 #include <google/longrunning/operations.grpc.pb.h>
+#include <grpcpp/alarm.h>
 
 namespace {
 namespace btadmin = google::bigtable::admin::v2;
@@ -230,6 +231,25 @@ class DefaultAdminClient : public google::cloud::bigtable::AdminClient {
     return impl_.Stub()->AsyncDeleteSnapshot(context, request, cq);
   };
 
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+  AsyncSnapshotTable(
+      grpc::ClientContext* context,
+      google::bigtable::admin::v2::SnapshotTableRequest const& request,
+      grpc::CompletionQueue* cq) override {
+    return impl_.Stub()->AsyncSnapshotTable(context, request, cq);
+  }
+
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+  AsyncCreateTableFromSnapshot(
+      grpc::ClientContext* context,
+      google::bigtable::admin::v2::CreateTableFromSnapshotRequest const&
+          request,
+      grpc::CompletionQueue* cq) override {
+    return impl_.Stub()->AsyncCreateTableFromSnapshot(context, request, cq);
+  }
+
   std::unique_ptr<
       grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
   AsyncGetOperation(grpc::ClientContext* context,
@@ -245,12 +265,69 @@ class DefaultAdminClient : public google::cloud::bigtable::AdminClient {
   std::string project_;
   Impl impl_;
 };
+
+/**
+ * Completes the asynchronous RPCs that an `AdminClient` does not override.
+ *
+ * The readers returned by the gRPC stubs are allocated in the call arena, and
+ * `std::unique_ptr<>` is specialized to never delete them. This reader owns
+ * itself instead, and it is deleted once `Finish()` has posted its tag.
+ */
+class UnimplementedOperationReader
+    : public grpc::ClientAsyncResponseReaderInterface<
+          google::longrunning::Operation> {
+ public:
+  UnimplementedOperationReader(grpc::CompletionQueue* cq, char const* rpc)
+      : cq_(cq), rpc_(rpc) {}
+
+  void StartCall() override {}
+  void ReadInitialMetadata(void* tag) override { PostTag(tag); }
+  void Finish(google::longrunning::Operation*, grpc::Status* status,
+              void* tag) override {
+    *status = grpc::Status(
+        grpc::StatusCode::UNIMPLEMENTED,
+        std::string(rpc_) + "() is not implemented by this AdminClient");
+    PostTag(tag);
+    delete this;
+  }
+
+ private:
+  void PostTag(void* tag) {
+    // An alarm with an expired deadline posts its tag before `Set()` returns,
+    // so it is safe to destroy the alarm right away.
+    grpc::Alarm alarm;
+    alarm.Set(cq_, gpr_inf_past(GPR_CLOCK_MONOTONIC), tag);
+  }
+
+  grpc::CompletionQueue* cq_;
+  char const* rpc_;
+};
 }  // anonymous namespace
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+AdminClient::AsyncSnapshotTable(grpc::ClientContext*,
+                                btadmin::SnapshotTableRequest const&,
+                                grpc::CompletionQueue* cq) {
+  return std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>(
+      new UnimplementedOperationReader(cq, "AsyncSnapshotTable"));
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+AdminClient::AsyncCreateTableFromSnapshot(
+    grpc::ClientContext*, btadmin::CreateTableFromSnapshotRequest const&,
+    grpc::CompletionQueue* cq) {
+  return std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>(
+      new UnimplementedOperationReader(cq, "AsyncCreateTableFromSnapshot"));
+}
+
 std::shared_ptr<AdminClient> CreateDefaultAdminClient(std::string project,
                                                       ClientOptions options) {
   return std::make_shared<DefaultAdminClient>(std::move(project),
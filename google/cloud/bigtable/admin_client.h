@@ -30,6 +30,8 @@ class TableAdmin;
 namespace internal {
 class AsyncAwaitConsistency;
 class AsyncCheckConsistency;
+template <typename Client, typename ResponseType>
+class AsyncLongrunningOp;
 }  // namespace internal
 namespace noex {
 class TableAdmin;
@@ -87,6 +89,8 @@ class AdminClient {
   friend class noex::TableAdmin;
   friend class internal::AsyncAwaitConsistency;
   friend class internal::AsyncCheckConsistency;
+  template <typename Client, typename ResponseType>
+  friend class internal::AsyncLongrunningOp;
   template <typename ResultType, typename ClientType>
   friend ResultType internal::PollLongRunningOperation(
       std::shared_ptr<ClientType> client,
@@ -218,6 +222,35 @@ class AdminClient {
       grpc::ClientContext* context,
       google::bigtable::admin::v2::DeleteSnapshotRequest const& request,
       grpc::CompletionQueue* cq) = 0;
+
+  /**
+   * Start an asynchronous `SnapshotTable` request.
+   *
+   * The default implementation completes with `UNIMPLEMENTED`, so existing
+   * `AdminClient` implementations continue to compile. Override it to support
+   * `TableAdmin::AsyncSnapshotTable()`.
+   */
+  virtual std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+  AsyncSnapshotTable(
+      grpc::ClientContext* context,
+      google::bigtable::admin::v2::SnapshotTableRequest const& request,
+      grpc::CompletionQueue* cq);
+
+  /**
+   * Start an asynchronous `CreateTableFromSnapshot` request.
+   *
+   * The default implementation completes with `UNIMPLEMENTED`, so existing
+   * `AdminClient` implementations continue to compile. Override it to support
+   * `TableAdmin::AsyncCreateTableFromSnapshot()`.
+   */
+  virtual std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+  AsyncCreateTableFromSnapshot(
+      grpc::ClientContext* context,
+      google::bigtable::admin::v2::CreateTableFromSnapshotRequest const&
+          request,
+      grpc::CompletionQueue* cq);
   //@}
 
   //@{
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/admin_client.h"
+#include "google/cloud/bigtable/testing/mock_admin_client.h"
 #include <gmock/gmock.h>
 
 namespace bigtable = google::cloud::bigtable;
@@ -34,3 +35,37 @@ TEST(AdminClientTest, Default) {
   EXPECT_TRUE(channel1);
   EXPECT_NE(channel0.get(), channel1.get());
 }
+
+/// @test Verify the default implementation of the snapshot async RPCs.
+TEST(AdminClientTest, AsyncSnapshotDefaultsToUnimplemented) {
+  bigtable::testing::MockAdminClient client;
+  grpc::CompletionQueue cq;
+
+  grpc::ClientContext snapshot_context;
+  auto snapshot = client.AdminClient::AsyncSnapshotTable(
+      &snapshot_context, google::bigtable::admin::v2::SnapshotTableRequest{},
+      &cq);
+  google::longrunning::Operation response;
+  grpc::Status status;
+  snapshot->Finish(&response, &status, &snapshot_context);
+  EXPECT_EQ(grpc::StatusCode::UNIMPLEMENTED, status.error_code());
+
+  void* tag;
+  bool ok;
+  ASSERT_TRUE(cq.Next(&tag, &ok));
+  EXPECT_EQ(&snapshot_context, tag);
+  EXPECT_TRUE(ok);
+
+  grpc::ClientContext create_context;
+  auto create = client.AdminClient::AsyncCreateTableFromSnapshot(
+      &create_context,
+      google::bigtable::admin::v2::CreateTableFromSnapshotRequest{}, &cq);
+  create->Finish(&response, &status, &create_context);
+  EXPECT_EQ(grpc::StatusCode::UNIMPLEMENTED, status.error_code());
+  ASSERT_TRUE(cq.Next(&tag, &ok));
+  EXPECT_EQ(&create_context, tag);
+  EXPECT_TRUE(ok);
+
+  cq.Shutdown();
+  EXPECT_FALSE(cq.Next(&tag, &ok));
+}
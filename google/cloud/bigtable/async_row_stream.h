@@ -0,0 +1,179 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ASYNC_ROW_STREAM_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ASYNC_ROW_STREAM_H_
+
+#include "google/cloud/bigtable/internal/async_row_stream_impl.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/optional.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Control how much data an `AsyncRowStream` reads ahead of the application.
+ *
+ * The stream stops reading from the service once it holds `max_buffered_rows`
+ * rows, or `max_buffered_bytes` bytes, whichever comes first. The limits can
+ * be exceeded by the rows in a single response from the service.
+ */
+class AsyncRowStreamOptions {
+ public:
+  AsyncRowStreamOptions()
+      : max_buffered_rows_(1000),
+        max_buffered_bytes_(16 * 1024 * 1024),
+        rows_limit_(0) {}
+
+  AsyncRowStreamOptions& set_max_buffered_rows(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "AsyncRowStreamOptions::set_max_buffered_rows requires v > 0");
+    }
+    max_buffered_rows_ = v;
+    return *this;
+  }
+  std::size_t max_buffered_rows() const { return max_buffered_rows_; }
+
+  AsyncRowStreamOptions& set_max_buffered_bytes(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "AsyncRowStreamOptions::set_max_buffered_bytes requires v > 0");
+    }
+    max_buffered_bytes_ = v;
+    return *this;
+  }
+  std::size_t max_buffered_bytes() const { return max_buffered_bytes_; }
+
+  /// Read at most this many rows, 0 reads all the rows.
+  AsyncRowStreamOptions& set_rows_limit(std::int64_t v) {
+    if (v < 0) {
+      google::cloud::internal::ThrowRangeError(
+          "AsyncRowStreamOptions::set_rows_limit requires v >= 0");
+    }
+    rows_limit_ = v;
+    return *this;
+  }
+  std::int64_t rows_limit() const { return rows_limit_; }
+
+ private:
+  std::size_t max_buffered_rows_;
+  std::size_t max_buffered_bytes_;
+  std::int64_t rows_limit_;
+};
+
+/**
+ * Read rows asynchronously, at the pace of the application.
+ *
+ * Objects of this class are returned by `Table::AsyncReadRows()`. The
+ * application pulls rows using `Next()` or `NextBatch()`, and the stream only
+ * reads a new response from the service while its buffer has room, as
+ * configured by `AsyncRowStreamOptions`. Once the buffer is full, gRPC flow
+ * control stops the service from sending more data. Slow consumers never
+ * block the completion queue threads, and the memory used by the stream is
+ * bounded.
+ *
+ * Only one call to `Next()` or `NextBatch()` is needed at a time, but the
+ * application may queue several of them, they are satisfied in order.
+ *
+ * Failed streams are resumed after the last row received, as configured by
+ * the table's retry and backoff policies. The destructor cancels the stream.
+ *
+ * @par Example
+ * @code
+ * auto stream = table.AsyncReadRows(
+ *     cq, bigtable::RowSet(bigtable::RowRange::Prefix("a")),
+ *     bigtable::Filter::PassAllFilter());
+ * for (auto row = stream.Next().get(); row; row = stream.Next().get()) {
+ *   std::cout << row->row_key() << "\n";
+ * }
+ * @endcode
+ */
+class AsyncRowStream {
+ public:
+  AsyncRowStream(AsyncRowStream&&) noexcept = default;
+  AsyncRowStream& operator=(AsyncRowStream&& rhs) noexcept {
+    Cancel();
+    impl_ = std::move(rhs.impl_);
+    return *this;
+  }
+
+  ~AsyncRowStream() { Cancel(); }
+
+  /**
+   * Return the next row.
+   *
+   * @return a future satisfied with the next row, or with an empty optional
+   *     at the end of the stream. If the stream fails the future is satisfied
+   *     with a `bigtable::GRpcError` exception, after all the rows received
+   *     before the error are returned.
+   */
+  future<optional<Row>> Next() {
+    return impl_->NextBatch(1).then(
+        [](future<std::vector<Row>> f) -> optional<Row> {
+          auto rows = f.get();
+          if (rows.empty()) {
+            return optional<Row>();
+          }
+          return optional<Row>(std::move(rows.front()));
+        });
+  }
+
+  /**
+   * Return up to @p max_rows rows, waiting for at least one.
+   *
+   * @return a future satisfied with the rows, or with an empty vector at the
+   *     end of the stream. Errors are reported as in `Next()`.
+   */
+  future<std::vector<Row>> NextBatch(std::size_t max_rows) {
+    return impl_->NextBatch(max_rows);
+  }
+
+  /// Stop the stream, any pending futures fail with `CANCELLED`.
+  void Cancel() {
+    if (impl_) {
+      impl_->Cancel();
+    }
+  }
+
+  /// The number of rows received and not yet returned to the application.
+  std::size_t buffered_rows() const { return impl_->buffered_rows(); }
+  /// The approximate memory used by the rows in the buffer.
+  std::size_t buffered_bytes() const { return impl_->buffered_bytes(); }
+  /// The largest value of `buffered_bytes()` since the stream started.
+  std::size_t peak_buffered_bytes() const {
+    return impl_->peak_buffered_bytes();
+  }
+
+ private:
+  friend class Table;
+  explicit AsyncRowStream(std::shared_ptr<internal::AsyncRowStreamImpl> impl)
+      : impl_(std::move(impl)) {}
+
+  std::shared_ptr<internal::AsyncRowStreamImpl> impl_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ASYNC_ROW_STREAM_H_
@@ -13,12 +13,16 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/bigtable/benchmarks/open_loop.h"
 #include "google/cloud/bigtable/benchmarks/random_mutation.h"
+#include "google/cloud/bigtable/hedging_policy.h"
+#include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <future>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 
 /**
  * @file
@@ -69,6 +73,19 @@
  * benchmark.  If this parameter is not used the benchmark uses the default
  * configuration, that is, a production instance of Cloud Bigtable unless the
  * CLOUD_BIGTABLE_EMULATOR environment variable is set.
+ *
+ * If the `--enable-hedging=true` option is given (before any other argument)
+ * the `ReadRow()` calls are hedged using a `PercentileHedgingPolicy`, and the
+ * benchmark reports how many duplicate requests were sent and how many of them
+ * won the race against the original request.
+ *
+ * If the `--target-qps=N` option is given the benchmark runs in open-loop
+ * mode: the threads start operations at a combined rate of N per second, with
+ * Poisson arrivals, and measure the latency from the intended start time of
+ * each operation. The latencies are recorded in fixed-size histograms instead
+ * of keeping every sample. With `--report-interval=S` the benchmark prints the
+ * p50, p99, p99.9 and maximum latency of the last S seconds, in the format
+ * selected by `--report-format=csv` (the default) or `--report-format=json`.
  */
 
 /// Helper functions and types for the apply_read_latency_benchmark.
@@ -82,10 +99,26 @@ struct LatencyBenchmarkResult {
 };
 
 /// Run an iteration of the test.
-LatencyBenchmarkResult RunBenchmark(bigtable::benchmarks::Benchmark& benchmark,
-                                    bigtable::AppProfileId app_profile_id,
-                                    std::string const& table_id,
-                                    std::chrono::seconds test_duration);
+LatencyBenchmarkResult RunBenchmark(
+    bigtable::benchmarks::Benchmark& benchmark,
+    bigtable::AppProfileId app_profile_id, std::string const& table_id,
+    std::chrono::seconds test_duration,
+    std::shared_ptr<bigtable::HedgingPolicy> hedging_policy);
+
+/// Run the test in open-loop mode and print the results.
+void RunOpenLoopBenchmark(
+    bigtable::benchmarks::Benchmark& benchmark,
+    bigtable::benchmarks::BenchmarkSetup const& setup,
+    OpenLoopOptions const& options, BenchmarkResult& populate_results,
+    std::shared_ptr<bigtable::PercentileHedgingPolicy> hedging_policy);
+
+/// Print the hedging statistics, if hedging is enabled.
+void PrintHedgingResult(
+    std::ostream& os,
+    std::shared_ptr<bigtable::PercentileHedgingPolicy> const& hedging_policy);
+
+/// Remove the `--enable-hedging=` option from the command-line, if present.
+bool ParseEnableHedging(int& argc, char* argv[]);
 
 //@{
 /// @name Test constants.  Defined as requirements in the original bug (#189).
@@ -96,6 +129,8 @@ constexpr int kBenchmarkProgressMarks = 4;
 }  // anonymous namespace
 
 int main(int argc, char* argv[]) try {
+  bool const enable_hedging = ParseEnableHedging(argc, argv);
+  auto const open_loop = ParseOpenLoopOptions(argc, argv);
   bigtable::benchmarks::BenchmarkSetup setup("perf", argc, argv);
 
   Benchmark benchmark(setup);
@@ -108,6 +143,19 @@ int main(int argc, char* argv[]) try {
                                   populate_results);
 
   auto data_client = benchmark.MakeDataClient();
+  // All the threads share the hedging policy, so it observes the latency of all
+  // the requests and enforces a single budget.
+  auto hedging_policy = std::make_shared<bigtable::PercentileHedgingPolicy>();
+  if (!enable_hedging) {
+    hedging_policy.reset();
+  }
+  if (open_loop.enabled()) {
+    RunOpenLoopBenchmark(benchmark, setup, open_loop, populate_results,
+                         hedging_policy);
+    benchmark.DeleteTable();
+    return 0;
+  }
+
   // Start the threads running the latency test.
   std::cout << "Running Latency Benchmark " << std::flush;
   auto latency_test_start = std::chrono::steady_clock::now();
@@ -121,7 +169,7 @@ int main(int argc, char* argv[]) try {
     tasks.emplace_back(
         std::async(launch_policy, RunBenchmark, std::ref(benchmark),
                    bigtable::AppProfileId(setup.app_profile_id()),
-                   setup.table_id(), setup.test_duration()));
+                   setup.table_id(), setup.test_duration(), hedging_policy));
   }
 
   // Wait for the threads and combine all the results.
@@ -160,6 +208,7 @@ int main(int argc, char* argv[]) try {
                                combined.apply_results);
   benchmark.PrintLatencyResult(std::cout, "perf", "ReadRow()",
                                combined.read_results);
+  PrintHedgingResult(std::cout, hedging_policy);
 
   std::cout << bigtable::benchmarks::Benchmark::ResultsCsvHeader() << std::endl;
   benchmark.PrintResultCsv(std::cout, "perf", "BulkApply()", "Latency",
@@ -178,6 +227,21 @@ int main(int argc, char* argv[]) try {
 }
 
 namespace {
+/// The operations in the open-loop test, in the order used by the recorders.
+enum OpenLoopOperation { kApplyOp = 0, kReadRowOp = 1 };
+
+bigtable::Table MakeTable(
+    bigtable::benchmarks::Benchmark& benchmark,
+    bigtable::AppProfileId const& app_profile_id, std::string const& table_id,
+    std::shared_ptr<bigtable::HedgingPolicy> hedging_policy) {
+  auto data_client = benchmark.MakeDataClient();
+  return hedging_policy
+             ? bigtable::Table(std::move(data_client), app_profile_id,
+                               table_id, std::move(hedging_policy))
+             : bigtable::Table(std::move(data_client), app_profile_id,
+                               table_id);
+}
+
 OperationResult RunOneApply(bigtable::Table& table, std::string row_key,
                             std::mt19937_64& generator) {
   bigtable::SingleRowMutation mutation(std::move(row_key));
@@ -197,14 +261,15 @@ OperationResult RunOneReadRow(bigtable::Table& table, std::string row_key) {
   return Benchmark::TimeOperation(std::move(op));
 }
 
-LatencyBenchmarkResult RunBenchmark(bigtable::benchmarks::Benchmark& benchmark,
-                                    bigtable::AppProfileId app_profile_id,
-                                    std::string const& table_id,
-                                    std::chrono::seconds test_duration) {
+LatencyBenchmarkResult RunBenchmark(
+    bigtable::benchmarks::Benchmark& benchmark,
+    bigtable::AppProfileId app_profile_id, std::string const& table_id,
+    std::chrono::seconds test_duration,
+    std::shared_ptr<bigtable::HedgingPolicy> hedging_policy) {
   LatencyBenchmarkResult result = {};
 
-  auto data_client = benchmark.MakeDataClient();
-  bigtable::Table table(std::move(data_client), app_profile_id, table_id);
+  auto table = MakeTable(benchmark, app_profile_id, table_id,
+                         std::move(hedging_policy));
 
   auto generator = google::cloud::internal::MakeDefaultPRNG();
   std::uniform_int_distribution<int> prng_operation(0, 1);
@@ -232,4 +297,126 @@ LatencyBenchmarkResult RunBenchmark(bigtable::benchmarks::Benchmark& benchmark,
   return result;
 }
 
+/// Run the open-loop test in one thread, at @p qps operations per second.
+void RunOpenLoopThread(bigtable::benchmarks::Benchmark& benchmark,
+                       bigtable::AppProfileId app_profile_id,
+                       std::string const& table_id,
+                       std::chrono::seconds test_duration, double qps,
+                       std::shared_ptr<bigtable::HedgingPolicy> hedging_policy,
+                       std::shared_ptr<LatencyRecorder> recorder) {
+  auto table = MakeTable(benchmark, app_profile_id, table_id,
+                         std::move(hedging_policy));
+
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  std::uniform_int_distribution<int> prng_operation(0, 1);
+
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + test_duration;
+  PoissonArrivals arrivals(qps, start);
+  for (auto intended = arrivals.Next(); intended < end;
+       intended = arrivals.Next()) {
+    // Prepare the request before the intended start time, only the time spent
+    // in the client library and the service is counted.
+    auto row_key = benchmark.MakeRandomKey(generator);
+    if (prng_operation(generator) == 0) {
+      bigtable::SingleRowMutation mutation(std::move(row_key));
+      for (int field = 0; field != kNumFields; ++field) {
+        mutation.emplace_back(MakeRandomMutation(generator, field));
+      }
+      std::this_thread::sleep_until(intended);
+      auto r = TimeOperationSince(intended, [&table, &mutation]() {
+        table.Apply(std::move(mutation));
+      });
+      recorder->Record(kApplyOp, r.first, r.second);
+      continue;
+    }
+    std::this_thread::sleep_until(intended);
+    auto r = TimeOperationSince(intended, [&table, &row_key]() {
+      auto row = table.ReadRow(std::move(row_key),
+                               bigtable::Filter::ColumnRangeClosed(
+                                   kColumnFamily, "field0", "field9"));
+    });
+    recorder->Record(kReadRowOp, r.first, r.second);
+  }
+}
+
+void RunOpenLoopBenchmark(
+    bigtable::benchmarks::Benchmark& benchmark,
+    bigtable::benchmarks::BenchmarkSetup const& setup,
+    OpenLoopOptions const& options, BenchmarkResult& populate_results,
+    std::shared_ptr<bigtable::PercentileHedgingPolicy> hedging_policy) {
+  std::cout << "Running Open-Loop Latency Benchmark at " << options.target_qps
+            << " ops/s" << std::endl;
+  auto const thread_qps = options.target_qps / setup.thread_count();
+  auto latency_test_start = std::chrono::steady_clock::now();
+  IntervalReporter reporter(std::cout, "perf", {"Apply()", "ReadRow()"},
+                            options);
+  std::vector<std::future<void>> tasks;
+  for (int i = 0; i != setup.thread_count(); ++i) {
+    tasks.emplace_back(std::async(
+        std::launch::async, RunOpenLoopThread, std::ref(benchmark),
+        bigtable::AppProfileId(setup.app_profile_id()), setup.table_id(),
+        setup.test_duration(), thread_qps, hedging_policy,
+        reporter.MakeRecorder()));
+  }
+  int count = 0;
+  for (auto& future : tasks) {
+    try {
+      future.get();
+    } catch (std::exception const& ex) {
+      std::cerr << "Standard exception raised by task[" << count
+                << "]: " << ex.what() << std::endl;
+    }
+    ++count;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - latency_test_start);
+  auto totals = reporter.Stop();
+  std::cout << "# DONE. Elapsed=" << FormatDuration(elapsed) << std::endl;
+
+  benchmark.PrintLatencyResult(std::cout, "perf", "Apply()", totals[kApplyOp],
+                               elapsed);
+  benchmark.PrintLatencyResult(std::cout, "perf", "ReadRow()",
+                               totals[kReadRowOp], elapsed);
+  PrintHedgingResult(std::cout, hedging_policy);
+
+  std::cout << bigtable::benchmarks::Benchmark::ResultsCsvHeader() << std::endl;
+  benchmark.PrintResultCsv(std::cout, "perf", "BulkApply()", "Latency",
+                           populate_results);
+  benchmark.PrintResultCsv(std::cout, "perf", "Apply()", "OpenLoopLatency",
+                           totals[kApplyOp], elapsed);
+  benchmark.PrintResultCsv(std::cout, "perf", "ReadRow()", "OpenLoopLatency",
+                           totals[kReadRowOp], elapsed);
+}
+
+void PrintHedgingResult(
+    std::ostream& os,
+    std::shared_ptr<bigtable::PercentileHedgingPolicy> const& hedging_policy) {
+  if (!hedging_policy) {
+    return;
+  }
+  os << "ReadRow() hedging: requests=" << hedging_policy->request_count()
+     << ", hedges=" << hedging_policy->hedge_count()
+     << ", hedges won=" << hedging_policy->hedge_won_count() << std::endl;
+}
+
+bool ParseEnableHedging(int& argc, char* argv[]) {
+  std::string const option = "--enable-hedging=";
+  bool enable_hedging = false;
+  int j = 1;
+  for (int i = 1; i != argc; ++i) {
+    std::string argument(argv[i]);
+    if (argument.rfind(option, 0) != 0) {
+      argv[j++] = argv[i];
+      continue;
+    }
+    auto value = argument.substr(option.size());
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](char x) { return std::tolower(x); });
+    enable_hedging = value == "true";
+  }
+  argc = j;
+  return enable_hedging;
+}
+
 }  // anonymous namespace
@@ -0,0 +1,189 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/async_row_stream.h"
+#include "google/cloud/bigtable/benchmarks/data_emulator.h"
+#include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/bigtable/table.h"
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+using namespace bigtable::benchmarks;
+using std::chrono::milliseconds;
+
+namespace {
+int const kRowCount = 2000;
+std::size_t const kValueSize = 1024;
+
+class AsyncRowStreamTest : public ::testing::Test {
+ protected:
+  void StartServer(EmulatorOptions options) {
+    // Small responses make the bound on the buffered data tighter.
+    options.max_response_bytes = 16 * 1024;
+    server_ = CreateEmulatorServer(std::move(options));
+    wait_thread_ = std::thread([this]() { server_->Wait(); });
+    bigtable::ClientOptions client_options(grpc::InsecureChannelCredentials());
+    client_options.set_data_endpoint(server_->address());
+    client_options.set_admin_endpoint(server_->address());
+    data_client_ = bigtable::CreateDefaultDataClient(
+        "fake-project", "fake-instance", client_options);
+    cq_thread_ = std::thread([this] { cq_.Run(); });
+  }
+
+  void SetUp() override { StartServer(EmulatorOptions{}); }
+
+  void TearDown() override {
+    cq_.Shutdown();
+    cq_thread_.join();
+    server_->Shutdown();
+    wait_thread_.join();
+  }
+
+  void RestartServer(EmulatorOptions options) {
+    TearDown();
+    cq_ = bigtable::CompletionQueue();
+    StartServer(std::move(options));
+  }
+
+  static std::string Key(int i) {
+    char key[16];
+    std::snprintf(key, sizeof(key), "row-%06d", i);
+    return key;
+  }
+
+  bigtable::Table Populate() {
+    bigtable::Table table(data_client_, "fake-table");
+    bigtable::BulkMutation bulk;
+    for (int i = 0; i != kRowCount; ++i) {
+      bulk.emplace_back(bigtable::SingleRowMutation(
+          Key(i), {bigtable::SetCell("fam", "col", milliseconds(0),
+                                     std::string(kValueSize, 'x'))}));
+    }
+    table.BulkApply(std::move(bulk));
+    return table;
+  }
+
+  std::unique_ptr<EmbeddedServer> server_;
+  std::thread wait_thread_;
+  std::shared_ptr<bigtable::DataClient> data_client_;
+  bigtable::CompletionQueue cq_;
+  std::thread cq_thread_;
+};
+}  // anonymous namespace
+
+/// @test Verify that a slow consumer does not make the stream buffer all rows.
+TEST_F(AsyncRowStreamTest, SlowConsumerHasBoundedMemory) {
+  auto table = Populate();
+  auto stream = table.AsyncReadRows(
+      cq_, bigtable::RowSet(), bigtable::Filter::PassAllFilter(),
+      bigtable::AsyncRowStreamOptions().set_max_buffered_rows(10));
+
+  // The stream holds at most 10 rows, plus the rows in one 16KiB response.
+  std::size_t const row_size = kValueSize + 100;
+  std::size_t const bound = 10 * row_size + 2 * 16 * 1024;
+  int count = 0;
+  for (auto row = stream.Next().get(); row; row = stream.Next().get()) {
+    EXPECT_EQ(Key(count), row->row_key());
+    if (++count % 100 == 0) {
+      // Give the stream time to fill its buffer, if it were unbounded it
+      // would read the rest of the table during these pauses.
+      std::this_thread::sleep_for(milliseconds(10));
+      EXPECT_GE(bound, stream.buffered_bytes());
+    }
+  }
+  EXPECT_EQ(kRowCount, count);
+  EXPECT_GE(bound, stream.peak_buffered_bytes());
+  EXPECT_LT(0U, stream.peak_buffered_bytes());
+  EXPECT_EQ(0U, stream.buffered_rows());
+}
+
+/// @test Verify that NextBatch() returns all the rows in order.
+TEST_F(AsyncRowStreamTest, NextBatch) {
+  auto table = Populate();
+  auto stream = table.AsyncReadRows(
+      cq_, bigtable::RowSet(bigtable::RowRange::RightOpen(Key(100), Key(400))),
+      bigtable::Filter::PassAllFilter(),
+      bigtable::AsyncRowStreamOptions().set_max_buffered_bytes(32 * 1024));
+  int count = 100;
+  for (auto rows = stream.NextBatch(64).get(); !rows.empty();
+       rows = stream.NextBatch(64).get()) {
+    EXPECT_GE(64U, rows.size());
+    for (auto const& row : rows) {
+      EXPECT_EQ(Key(count++), row.row_key());
+    }
+  }
+  EXPECT_EQ(400, count);
+}
+
+/// @test Verify that the rows limit is respected.
+TEST_F(AsyncRowStreamTest, RowsLimit) {
+  auto table = Populate();
+  auto stream = table.AsyncReadRows(
+      cq_, bigtable::RowSet(), bigtable::Filter::PassAllFilter(),
+      bigtable::AsyncRowStreamOptions().set_rows_limit(25));
+  int count = 0;
+  for (auto row = stream.Next().get(); row; row = stream.Next().get()) {
+    ++count;
+  }
+  EXPECT_EQ(25, count);
+}
+
+/// @test Verify that interrupted streams resume after the last row.
+TEST_F(AsyncRowStreamTest, ResumesAfterErrors) {
+  EmulatorOptions options;
+  options.error_rate = 0.2;
+  options.seed = 42;
+  RestartServer(options);
+
+  // Populate() uses BulkApply(), which retries the failed mutations.
+  Populate();
+  bigtable::Table table(data_client_, "fake-table",
+                        bigtable::LimitedErrorCountRetryPolicy(1000),
+                        bigtable::ExponentialBackoffPolicy(
+                            std::chrono::microseconds(100), milliseconds(1)));
+  auto stream = table.AsyncReadRows(
+      cq_, bigtable::RowSet(), bigtable::Filter::PassAllFilter(),
+      bigtable::AsyncRowStreamOptions().set_max_buffered_rows(50));
+  int count = 0;
+  for (auto row = stream.Next().get(); row; row = stream.Next().get()) {
+    EXPECT_EQ(Key(count++), row->row_key());
+  }
+  EXPECT_EQ(kRowCount, count);
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that cancelled streams stop and report the cancellation.
+TEST_F(AsyncRowStreamTest, Cancel) {
+  auto table = Populate();
+  auto stream = table.AsyncReadRows(
+      cq_, bigtable::RowSet(), bigtable::Filter::PassAllFilter(),
+      bigtable::AsyncRowStreamOptions().set_max_buffered_rows(10));
+  ASSERT_TRUE(stream.Next().get().has_value());
+  stream.Cancel();
+
+  // The rows already buffered are returned before the error.
+  int count = 1;
+  try {
+    while (stream.Next().get()) {
+      ++count;
+    }
+    ADD_FAILURE() << "expected an exception";
+  } catch (bigtable::GRpcError const& ex) {
+    EXPECT_EQ(grpc::StatusCode::CANCELLED, ex.error_code());
+  }
+  EXPECT_GT(kRowCount, count);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
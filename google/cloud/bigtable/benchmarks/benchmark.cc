@@ -15,6 +15,8 @@
 #include "google/cloud/bigtable/benchmarks/benchmark.h"
 #include "google/cloud/bigtable/benchmarks/random_mutation.h"
 #include "google/cloud/bigtable/table_admin.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <algorithm>
 #include <future>
 #include <iomanip>
 #include <sstream>
@@ -32,7 +34,9 @@ Benchmark::Benchmark(BenchmarkSetup const& setup)
       key_width_(KeyWidth()),
       client_options_(grpc::InsecureChannelCredentials()) {
   if (setup_.use_embedded_server()) {
-    server_ = CreateEmbeddedServer();
+    server_ = setup_.use_emulator()
+                  ? CreateEmulatorServer(setup_.emulator_options())
+                  : CreateEmbeddedServer();
     std::string address = server_->address();
     std::cout << "Running embedded Cloud Bigtable server at " << address
               << std::endl;
@@ -177,6 +181,26 @@ void Benchmark::PrintLatencyResult(std::ostream& os,
   os << std::endl;
 }
 
+void Benchmark::PrintLatencyResult(std::ostream& os,
+                                   std::string const& test_name,
+                                   std::string const& operation,
+                                   LatencyStats const& stats,
+                                   std::chrono::milliseconds elapsed) const {
+  auto const nsamples = stats.histogram.count();
+  auto const ms = (std::max)(elapsed, std::chrono::milliseconds(1));
+  auto ops_throughput = 1000 * nsamples / ms.count();
+  os << "# Test=" << test_name << ", " << operation
+     << " Throughput = " << ops_throughput << " ops/s, Errors = "
+     << stats.errors << ", Latency: ";
+  char const* sep = "";
+  for (double p : kResultPercentiles) {
+    os << sep << "p" << std::setprecision(3) << p << "=" << std::setprecision(2)
+       << FormatDuration(stats.histogram.ValueAtPercentile(p));
+    sep = ", ";
+  }
+  os << std::endl;
+}
+
 std::string Benchmark::ResultsCsvHeader() {
   return "name,start,op.name,measurement,nsamples,min,p50,p90,p95,p99,p99.9,max"
          ",units,throughput.rows,throughput.ops,notes";
@@ -208,6 +232,24 @@ void Benchmark::PrintResultCsv(std::ostream& os, std::string const& test_name,
      << setup_.notes() << "\n";
 }
 
+void Benchmark::PrintResultCsv(std::ostream& os, std::string const& test_name,
+                               std::string const& op_name,
+                               std::string const& measurement,
+                               LatencyStats const& stats,
+                               std::chrono::milliseconds elapsed) const {
+  auto const nsamples = stats.histogram.count();
+  os << test_name << "," << setup_.start_time() << "," << op_name << ","
+     << measurement << "," << nsamples;
+  for (double p : kResultPercentiles) {
+    os << "," << stats.histogram.ValueAtPercentile(p).count();
+  }
+  // In open-loop tests each operation reads or writes a single row.
+  auto const ms = (std::max)(elapsed, std::chrono::milliseconds(1));
+  auto ops_throughput = 1000 * nsamples / ms.count();
+  os << ",us," << ops_throughput << "," << ops_throughput << ","
+     << setup_.notes() << "\n";
+}
+
 int Benchmark::create_table_count() const {
   if (!server_) {
     return 0;
@@ -344,6 +386,44 @@ std::ostream& operator<<(std::ostream& os, FormatDuration duration) {
   return os << buf;
 }
 
+bool MatchOption(std::string const& argument, std::string const& name,
+                 std::string& value) {
+  auto const prefix = "--" + name + "=";
+  if (argument.rfind(prefix, 0) != 0) {
+    return false;
+  }
+  value = argument.substr(prefix.size());
+  return true;
+}
+
+RetryLimitOptions ParseRetryLimitOptions(int& argc, char* argv[]) {
+  RetryLimitOptions options;
+  int j = 1;
+  for (int i = 1; i != argc; ++i) {
+    std::string argument(argv[i]);
+    std::string value;
+    if (MatchOption(argument, "retry-budget", value)) {
+      options.retry_budget = std::stod(value);
+      if (options.retry_budget < 0) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--retry-budget must be >= 0");
+      }
+      continue;
+    }
+    if (MatchOption(argument, "circuit-breaker-threshold", value)) {
+      options.circuit_breaker_threshold = std::stoi(value);
+      if (options.circuit_breaker_threshold < 0) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--circuit-breaker-threshold must be >= 0");
+      }
+      continue;
+    }
+    argv[j++] = argv[i];
+  }
+  argc = j;
+  return options;
+}
+
 }  // namespace benchmarks
 }  // namespace bigtable
 }  // namespace cloud
@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_BENCHMARK_H_
 
 #include "google/cloud/bigtable/benchmarks/embedded_server.h"
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
 #include "google/cloud/bigtable/benchmarks/setup.h"
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/internal/random.h"
@@ -94,6 +95,12 @@ class Benchmark {
                           std::string const& operation,
                           BenchmarkResult& result) const;
 
+  /// Print the latency histogram of an open-loop test in human readable form.
+  void PrintLatencyResult(std::ostream& os, std::string const& test_name,
+                          std::string const& operation,
+                          LatencyStats const& stats,
+                          std::chrono::milliseconds elapsed) const;
+
   /// Return the header for CSV results.
   static std::string ResultsCsvHeader();
 
@@ -103,6 +110,13 @@ class Benchmark {
                       std::string const& measurement,
                       BenchmarkResult& result) const;
 
+  /// Print the latency histogram of an open-loop test as a CSV line.
+  void PrintResultCsv(std::ostream& os, std::string const& test_name,
+                      std::string const& op_name,
+                      std::string const& measurement,
+                      LatencyStats const& stats,
+                      std::chrono::milliseconds elapsed) const;
+
   //@{
   /**
    * @name Embedded server counter accessors.
@@ -163,6 +177,40 @@ struct FormatDuration {
  */
 std::ostream& operator<<(std::ostream& os, FormatDuration duration);
 
+/**
+ * Return true and set @p value if @p argument is `--<name>=<value>`.
+ *
+ * The benchmarks use this function to remove their own options from the
+ * command-line before the positional arguments are parsed.
+ */
+bool MatchOption(std::string const& argument, std::string const& name,
+                 std::string& value);
+
+/**
+ * Configure the limits on retries shared by all the benchmark threads.
+ *
+ * With these options the benchmark shows how a `RetryBudget` and a
+ * `CircuitBreaker` behave while the service is failing, for example, when
+ * using the embedded emulator with `--emulator-error-rate`.
+ */
+struct RetryLimitOptions {
+  /// The retries allowed for each successful operation, 0 disables the budget.
+  double retry_budget = 0;
+  /// The consecutive failures to open the breaker, 0 disables the breaker.
+  int circuit_breaker_threshold = 0;
+};
+
+/**
+ * Remove the retry limit options from the command-line and return their values.
+ *
+ * The options are `--retry-budget=<ratio>` and
+ * `--circuit-breaker-threshold=<count>`. They can appear anywhere in the
+ * command-line.
+ *
+ * @throws std::invalid_argument if any option has an invalid value.
+ */
+RetryLimitOptions ParseRetryLimitOptions(int& argc, char* argv[]);
+
 }  // namespace benchmarks
 }  // namespace bigtable
 }  // namespace cloud
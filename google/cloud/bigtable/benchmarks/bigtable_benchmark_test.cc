@@ -191,3 +191,37 @@ TEST(BenchmarkTest, PrintCsv) {
   // The output includes the throughput.
   EXPECT_THAT(output, HasSubstr(",123,"));
 }
+
+/// @test Verify that MatchOption() only matches `--<name>=<value>`.
+TEST(BenchmarkTest, MatchOption) {
+  std::string value = "unchanged";
+  EXPECT_TRUE(MatchOption("--foo=bar", "foo", value));
+  EXPECT_EQ("bar", value);
+  EXPECT_TRUE(MatchOption("--foo=", "foo", value));
+  EXPECT_EQ("", value);
+
+  value = "unchanged";
+  EXPECT_FALSE(MatchOption("--foo", "foo", value));
+  EXPECT_FALSE(MatchOption("--foobar=baz", "foo", value));
+  EXPECT_FALSE(MatchOption("x--foo=bar", "foo", value));
+  EXPECT_FALSE(MatchOption("foo=bar", "foo", value));
+  EXPECT_EQ("unchanged", value);
+}
+
+/// @test Verify that the retry limit options are removed from the command-line.
+TEST(BenchmarkTest, ParseRetryLimitOptions) {
+  char budget[] = "--retry-budget=0.2";
+  char threshold[] = "--circuit-breaker-threshold=5";
+  char* argv[] = {arg0, budget, arg1, threshold, arg2};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto options = ParseRetryLimitOptions(argc, argv);
+  EXPECT_DOUBLE_EQ(0.2, options.retry_budget);
+  EXPECT_EQ(5, options.circuit_breaker_threshold);
+  ASSERT_EQ(3, argc);
+  EXPECT_EQ(std::string("foo"), argv[1]);
+  EXPECT_EQ(std::string("bar"), argv[2]);
+
+  auto defaults = ParseRetryLimitOptions(argc, argv);
+  EXPECT_DOUBLE_EQ(0.0, defaults.retry_budget);
+  EXPECT_EQ(0, defaults.circuit_breaker_threshold);
+}
@@ -0,0 +1,1040 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/data_emulator.h"
+#include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/bigtable/internal/endian.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <google/bigtable/admin/v2/bigtable_table_admin.grpc.pb.h>
+#include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace btproto = google::bigtable::v2;
+namespace btadmin = google::bigtable::admin::v2;
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+namespace {
+/// The versions of a column, newest first, as returned by Cloud Bigtable.
+using ColumnData =
+    std::map<std::int64_t, std::string, std::greater<std::int64_t>>;
+/// The columns in a family, indexed by column qualifier.
+using FamilyData = std::map<std::string, ColumnData>;
+/// The families in a row, indexed by family name.
+using RowData = std::map<std::string, FamilyData>;
+
+/// A table in the emulator, with its own lock.
+struct EmulatedTable {
+  std::mutex mu;
+  std::map<std::string, RowData> rows;
+};
+
+/// A cell as seen by the filters.
+struct FilteredCell {
+  std::string family;
+  std::string qualifier;
+  std::int64_t timestamp;
+  std::string value;
+  std::vector<std::string> labels;
+};
+
+/// The cells in a row, in the order returned by `ReadRows`.
+std::vector<FilteredCell> FlattenRow(RowData const& row) {
+  std::vector<FilteredCell> cells;
+  for (auto const& family : row) {
+    for (auto const& column : family.second) {
+      for (auto const& cell : column.second) {
+        cells.push_back(FilteredCell{family.first, column.first, cell.first,
+                                     cell.second, {}});
+      }
+    }
+  }
+  return cells;
+}
+
+std::int64_t NowMicros() {
+  // Cloud Bigtable uses millisecond granularity for the server timestamps.
+  auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+/**
+ * The regular expressions used by the filter of a request.
+ *
+ * Compiling a `std::regex` is far more expensive than matching it. Each
+ * expression is compiled the first time it is used, and then reused for all
+ * the rows in the request.
+ */
+class RegexCache {
+ public:
+  /// Return the compiled expression, throws `std::regex_error` if invalid.
+  std::regex const& Get(std::string const& pattern) {
+    auto loc = regexes_.find(pattern);
+    if (loc == regexes_.end()) {
+      loc = regexes_.emplace(pattern, std::regex(pattern)).first;
+    }
+    return loc->second;
+  }
+
+ private:
+  std::map<std::string, std::regex> regexes_;
+};
+
+template <typename Predicate>
+void RemoveCellsIf(std::vector<FilteredCell>& cells, Predicate&& predicate) {
+  cells.erase(std::remove_if(cells.begin(), cells.end(), predicate),
+              cells.end());
+}
+
+/// Return true if @p v is in the range with the given (optional) endpoints.
+bool InRange(std::string const& v, std::string const* start, bool start_open,
+             std::string const* end, bool end_open) {
+  if (start != nullptr) {
+    if (start_open ? v <= *start : v < *start) {
+      return false;
+    }
+  }
+  if (end != nullptr) {
+    if (end_open ? v >= *end : v > *end) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool InColumnRange(btproto::ColumnRange const& range,
+                   FilteredCell const& cell) {
+  if (cell.family != range.family_name()) {
+    return false;
+  }
+  std::string const* start = nullptr;
+  bool start_open = false;
+  if (range.start_qualifier_case() ==
+      btproto::ColumnRange::kStartQualifierClosed) {
+    start = &range.start_qualifier_closed();
+  } else if (range.start_qualifier_case() ==
+             btproto::ColumnRange::kStartQualifierOpen) {
+    start = &range.start_qualifier_open();
+    start_open = true;
+  }
+  std::string const* end = nullptr;
+  bool end_open = false;
+  if (range.end_qualifier_case() == btproto::ColumnRange::kEndQualifierClosed) {
+    end = &range.end_qualifier_closed();
+  } else if (range.end_qualifier_case() ==
+             btproto::ColumnRange::kEndQualifierOpen) {
+    end = &range.end_qualifier_open();
+    end_open = true;
+  }
+  return InRange(cell.qualifier, start, start_open, end, end_open);
+}
+
+bool InValueRange(btproto::ValueRange const& range, std::string const& value) {
+  std::string const* start = nullptr;
+  bool start_open = false;
+  if (range.start_value_case() == btproto::ValueRange::kStartValueClosed) {
+    start = &range.start_value_closed();
+  } else if (range.start_value_case() == btproto::ValueRange::kStartValueOpen) {
+    start = &range.start_value_open();
+    start_open = true;
+  }
+  std::string const* end = nullptr;
+  bool end_open = false;
+  if (range.end_value_case() == btproto::ValueRange::kEndValueClosed) {
+    end = &range.end_value_closed();
+  } else if (range.end_value_case() == btproto::ValueRange::kEndValueOpen) {
+    end = &range.end_value_open();
+    end_open = true;
+  }
+  return InRange(value, start, start_open, end, end_open);
+}
+
+/// Apply @p filter to the cells of the row @p row_key.
+grpc::Status ApplyFilter(btproto::RowFilter const& filter,
+                         std::string const& row_key,
+                         std::vector<FilteredCell>& cells,
+                         RegexCache& regexes) {
+  switch (filter.filter_case()) {
+    case btproto::RowFilter::FILTER_NOT_SET:
+      return grpc::Status::OK;
+
+    case btproto::RowFilter::kChain:
+      for (auto const& f : filter.chain().filters()) {
+        auto status = ApplyFilter(f, row_key, cells, regexes);
+        if (!status.ok()) {
+          return status;
+        }
+      }
+      return grpc::Status::OK;
+
+    case btproto::RowFilter::kInterleave: {
+      std::vector<FilteredCell> result;
+      for (auto const& f : filter.interleave().filters()) {
+        auto copy = cells;
+        auto status = ApplyFilter(f, row_key, copy, regexes);
+        if (!status.ok()) {
+          return status;
+        }
+        std::move(copy.begin(), copy.end(), std::back_inserter(result));
+      }
+      std::stable_sort(result.begin(), result.end(),
+                       [](FilteredCell const& a, FilteredCell const& b) {
+                         if (a.family != b.family) {
+                           return a.family < b.family;
+                         }
+                         if (a.qualifier != b.qualifier) {
+                           return a.qualifier < b.qualifier;
+                         }
+                         return a.timestamp > b.timestamp;
+                       });
+      cells = std::move(result);
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kCondition: {
+      auto const& condition = filter.condition();
+      auto copy = cells;
+      auto status =
+          ApplyFilter(condition.predicate_filter(), row_key, copy, regexes);
+      if (!status.ok()) {
+        return status;
+      }
+      bool const matched = !copy.empty();
+      if (matched && condition.has_true_filter()) {
+        return ApplyFilter(condition.true_filter(), row_key, cells, regexes);
+      }
+      if (!matched && condition.has_false_filter()) {
+        return ApplyFilter(condition.false_filter(), row_key, cells, regexes);
+      }
+      cells.clear();
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kPassAllFilter:
+      return grpc::Status::OK;
+
+    case btproto::RowFilter::kBlockAllFilter:
+      cells.clear();
+      return grpc::Status::OK;
+
+    case btproto::RowFilter::kRowKeyRegexFilter:
+      if (!std::regex_match(row_key,
+                            regexes.Get(filter.row_key_regex_filter()))) {
+        cells.clear();
+      }
+      return grpc::Status::OK;
+
+    case btproto::RowFilter::kFamilyNameRegexFilter: {
+      auto const& re = regexes.Get(filter.family_name_regex_filter());
+      RemoveCellsIf(cells, [&re](FilteredCell const& c) {
+        return !std::regex_match(c.family, re);
+      });
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kColumnQualifierRegexFilter: {
+      auto const& re = regexes.Get(filter.column_qualifier_regex_filter());
+      RemoveCellsIf(cells, [&re](FilteredCell const& c) {
+        return !std::regex_match(c.qualifier, re);
+      });
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kValueRegexFilter: {
+      auto const& re = regexes.Get(filter.value_regex_filter());
+      RemoveCellsIf(cells, [&re](FilteredCell const& c) {
+        return !std::regex_match(c.value, re);
+      });
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kColumnRangeFilter: {
+      auto const& range = filter.column_range_filter();
+      RemoveCellsIf(cells, [&range](FilteredCell const& c) {
+        return !InColumnRange(range, c);
+      });
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kValueRangeFilter: {
+      auto const& range = filter.value_range_filter();
+      RemoveCellsIf(cells, [&range](FilteredCell const& c) {
+        return !InValueRange(range, c.value);
+      });
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kTimestampRangeFilter: {
+      auto const& range = filter.timestamp_range_filter();
+      RemoveCellsIf(cells, [&range](FilteredCell const& c) {
+        if (c.timestamp < range.start_timestamp_micros()) {
+          return true;
+        }
+        return range.end_timestamp_micros() != 0 &&
+               c.timestamp >= range.end_timestamp_micros();
+      });
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kCellsPerRowOffsetFilter: {
+      auto offset = static_cast<std::size_t>(
+          (std::max)(filter.cells_per_row_offset_filter(), 0));
+      cells.erase(cells.begin(),
+                  cells.begin() + (std::min)(offset, cells.size()));
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kCellsPerRowLimitFilter: {
+      auto limit = static_cast<std::size_t>(
+          (std::max)(filter.cells_per_row_limit_filter(), 0));
+      if (cells.size() > limit) {
+        cells.resize(limit);
+      }
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kCellsPerColumnLimitFilter: {
+      auto const limit = filter.cells_per_column_limit_filter();
+      std::vector<FilteredCell> result;
+      std::string const* family = nullptr;
+      std::string const* qualifier = nullptr;
+      int count = 0;
+      for (auto& c : cells) {
+        if (family == nullptr || *family != c.family ||
+            *qualifier != c.qualifier) {
+          family = &c.family;
+          qualifier = &c.qualifier;
+          count = 0;
+        }
+        if (count++ < limit) {
+          result.push_back(std::move(c));
+          // `c` is moved-from, keep pointing to the copy in `result`.
+          family = &result.back().family;
+          qualifier = &result.back().qualifier;
+        }
+      }
+      cells = std::move(result);
+      return grpc::Status::OK;
+    }
+
+    case btproto::RowFilter::kStripValueTransformer:
+      if (filter.strip_value_transformer()) {
+        for (auto& c : cells) {
+          c.value.clear();
+        }
+      }
+      return grpc::Status::OK;
+
+    case btproto::RowFilter::kApplyLabelTransformer:
+      for (auto& c : cells) {
+        c.labels.push_back(filter.apply_label_transformer());
+      }
+      return grpc::Status::OK;
+
+    default:
+      break;
+  }
+  return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+                      "filter not supported by the emulator: " +
+                          filter.ShortDebugString());
+}
+
+/// Apply a filter, converting regex errors into a `grpc::Status`.
+grpc::Status SafeApplyFilter(btproto::RowFilter const& filter,
+                             std::string const& row_key,
+                             std::vector<FilteredCell>& cells,
+                             RegexCache& regexes) {
+  try {
+    return ApplyFilter(filter, row_key, cells, regexes);
+  } catch (std::regex_error const& ex) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                        std::string("invalid regular expression: ") +
+                            ex.what());
+  }
+}
+
+/// Remove any empty columns and families from @p row.
+void CompactRow(RowData& row) {
+  for (auto f = row.begin(); f != row.end();) {
+    for (auto c = f->second.begin(); c != f->second.end();) {
+      c = c->second.empty() ? f->second.erase(c) : std::next(c);
+    }
+    f = f->second.empty() ? row.erase(f) : std::next(f);
+  }
+}
+
+/// Apply @p mutations to @p row, the mutations are validated first.
+grpc::Status ApplyMutations(
+    RowData& row,
+    google::protobuf::RepeatedPtrField<btproto::Mutation> const& mutations) {
+  for (auto const& m : mutations) {
+    if (m.mutation_case() == btproto::Mutation::MUTATION_NOT_SET) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "mutation type not set");
+    }
+    if (m.has_set_cell() && m.set_cell().timestamp_micros() < -1) {
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "invalid timestamp in SetCell");
+    }
+  }
+  auto const now = NowMicros();
+  for (auto const& m : mutations) {
+    switch (m.mutation_case()) {
+      case btproto::Mutation::kSetCell: {
+        auto const& set_cell = m.set_cell();
+        auto ts = set_cell.timestamp_micros();
+        if (ts == -1) {
+          ts = now;
+        }
+        row[set_cell.family_name()][set_cell.column_qualifier()][ts] =
+            set_cell.value();
+        break;
+      }
+      case btproto::Mutation::kDeleteFromColumn: {
+        auto const& d = m.delete_from_column();
+        auto f = row.find(d.family_name());
+        if (f == row.end()) {
+          break;
+        }
+        auto c = f->second.find(d.column_qualifier());
+        if (c == f->second.end()) {
+          break;
+        }
+        auto const start = d.time_range().start_timestamp_micros();
+        auto const end = d.time_range().end_timestamp_micros();
+        for (auto cell = c->second.begin(); cell != c->second.end();) {
+          bool const in_range =
+              cell->first >= start && (end == 0 || cell->first < end);
+          cell = in_range ? c->second.erase(cell) : std::next(cell);
+        }
+        break;
+      }
+      case btproto::Mutation::kDeleteFromFamily:
+        row.erase(m.delete_from_family().family_name());
+        break;
+      case btproto::Mutation::kDeleteFromRow:
+        row.clear();
+        break;
+      default:
+        break;
+    }
+  }
+  CompactRow(row);
+  return grpc::Status::OK;
+}
+
+/// A range of row keys, used to iterate over the rows in a `RowSet`.
+struct KeyRange {
+  std::string start;
+  bool start_open;
+  std::string end;
+  bool end_open;
+  bool end_unbounded;
+};
+
+std::vector<KeyRange> MakeKeyRanges(btproto::RowSet const& row_set) {
+  std::vector<KeyRange> ranges;
+  for (auto const& key : row_set.row_keys()) {
+    ranges.push_back(KeyRange{key, false, key, false, false});
+  }
+  for (auto const& r : row_set.row_ranges()) {
+    KeyRange range{"", false, "", false, true};
+    if (r.start_key_case() == btproto::RowRange::kStartKeyClosed) {
+      range.start = r.start_key_closed();
+    } else if (r.start_key_case() == btproto::RowRange::kStartKeyOpen) {
+      range.start = r.start_key_open();
+      range.start_open = true;
+    }
+    if (r.end_key_case() == btproto::RowRange::kEndKeyClosed) {
+      range.end = r.end_key_closed();
+      range.end_unbounded = range.end.empty();
+    } else if (r.end_key_case() == btproto::RowRange::kEndKeyOpen) {
+      range.end = r.end_key_open();
+      range.end_open = true;
+      range.end_unbounded = range.end.empty();
+    }
+    ranges.push_back(std::move(range));
+  }
+  if (row_set.row_keys().empty() && row_set.row_ranges().empty()) {
+    // An empty row set means "all the rows".
+    ranges.push_back(KeyRange{"", false, "", false, true});
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [](KeyRange const& a, KeyRange const& b) {
+              if (a.start != b.start) {
+                return a.start < b.start;
+              }
+              return !a.start_open && b.start_open;
+            });
+  return ranges;
+}
+
+/// The state shared by the data and admin services.
+class Emulator {
+ public:
+  explicit Emulator(EmulatorOptions options)
+      : options_(std::move(options)),
+        generator_(options_.seed == 0
+                       ? google::cloud::internal::MakeDefaultPRNG()
+                       : google::cloud::internal::DefaultPRNG(
+                             static_cast<std::uint_fast64_t>(options_.seed))) {
+  }
+
+  EmulatorOptions const& options() const { return options_; }
+
+  std::shared_ptr<EmulatedTable> GetTable(std::string const& name) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& table = tables_[name];
+    if (!table) {
+      table = std::make_shared<EmulatedTable>();
+    }
+    return table;
+  }
+
+  void DeleteTable(std::string const& name) {
+    std::lock_guard<std::mutex> lk(mu_);
+    tables_.erase(name);
+  }
+
+  /// Return true if the next operation should fail.
+  bool InjectFault() {
+    if (options_.error_rate <= 0) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    return std::bernoulli_distribution(options_.error_rate)(generator_);
+  }
+
+  /// Return how many rows a `ReadRows` stream returns before failing, or -1.
+  std::int64_t RowsBeforeFault() {
+    if (!InjectFault()) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    return std::uniform_int_distribution<std::int64_t>(0, 100)(generator_);
+  }
+
+  /// Simulate the latency at the start of each RPC.
+  void Delay() const {
+    if (options_.latency.count() > 0) {
+      std::this_thread::sleep_for(options_.latency);
+    }
+  }
+
+  /// Simulate the time to transfer @p bytes.
+  void Throttle(std::size_t bytes) const {
+    if (options_.bandwidth_bytes_per_second <= 0) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(
+        bytes / options_.bandwidth_bytes_per_second));
+  }
+
+ private:
+  EmulatorOptions options_;
+  std::mutex mu_;
+  google::cloud::internal::DefaultPRNG generator_;
+  std::map<std::string, std::shared_ptr<EmulatedTable>> tables_;
+};
+
+grpc::Status Unavailable() {
+  return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                      "fault injected by the emulator");
+}
+
+/**
+ * Implement the `google.bigtable.v2.Bigtable` data APIs in memory.
+ */
+class EmulatorBigtableImpl final : public btproto::Bigtable::Service {
+ public:
+  explicit EmulatorBigtableImpl(Emulator& emulator)
+      : emulator_(emulator),
+        mutate_row_count_(0),
+        mutate_rows_count_(0),
+        read_rows_count_(0) {}
+
+  grpc::Status ReadRows(
+      grpc::ServerContext*, btproto::ReadRowsRequest const* request,
+      grpc::ServerWriter<btproto::ReadRowsResponse>* writer) override {
+    ++read_rows_count_;
+    emulator_.Delay();
+    auto const fault_after = emulator_.RowsBeforeFault();
+    auto table = emulator_.GetTable(request->table_name());
+
+    std::int64_t rows_sent = 0;
+    std::string last_key;
+    bool has_last_key = false;
+    btproto::ReadRowsResponse msg;
+    std::size_t msg_bytes = 0;
+    RegexCache regexes;
+    auto flush = [&] {
+      if (msg.chunks_size() == 0) {
+        return true;
+      }
+      emulator_.Throttle(msg_bytes);
+      bool ok = writer->Write(msg);
+      msg.Clear();
+      msg_bytes = 0;
+      return ok;
+    };
+
+    for (auto const& range : MakeKeyRanges(request->rows())) {
+      std::string cursor = range.start;
+      bool cursor_open = range.start_open;
+      if (has_last_key && cursor <= last_key) {
+        cursor = last_key;
+        cursor_open = true;
+      }
+      while (true) {
+        if (rows_sent == fault_after) {
+          flush();
+          return Unavailable();
+        }
+        if (request->rows_limit() != 0 && rows_sent >= request->rows_limit()) {
+          break;
+        }
+        std::string key;
+        std::vector<FilteredCell> cells;
+        {
+          std::lock_guard<std::mutex> lk(table->mu);
+          auto it = cursor_open ? table->rows.upper_bound(cursor)
+                                : table->rows.lower_bound(cursor);
+          if (it == table->rows.end()) {
+            break;
+          }
+          if (!range.end_unbounded &&
+              (range.end_open ? it->first >= range.end
+                              : it->first > range.end)) {
+            break;
+          }
+          key = it->first;
+          cells = FlattenRow(it->second);
+        }
+        cursor = key;
+        cursor_open = true;
+        auto status = SafeApplyFilter(request->filter(), key, cells, regexes);
+        if (!status.ok()) {
+          return status;
+        }
+        if (cells.empty()) {
+          continue;
+        }
+        msg_bytes += AppendRow(msg, key, cells);
+        ++rows_sent;
+        last_key = std::move(key);
+        has_last_key = true;
+        if (msg_bytes >= emulator_.options().max_response_bytes && !flush()) {
+          return grpc::Status(grpc::StatusCode::CANCELLED, "stream closed");
+        }
+      }
+    }
+    flush();
+    return grpc::Status::OK;
+  }
+
+  grpc::Status SampleRowKeys(
+      grpc::ServerContext*, btproto::SampleRowKeysRequest const* request,
+      grpc::ServerWriter<btproto::SampleRowKeysResponse>* writer) override {
+    emulator_.Delay();
+    if (emulator_.InjectFault()) {
+      return Unavailable();
+    }
+    auto table = emulator_.GetTable(request->table_name());
+    std::vector<btproto::SampleRowKeysResponse> samples;
+    {
+      std::lock_guard<std::mutex> lk(table->mu);
+      std::int64_t offset = 0;
+      std::int64_t count = 0;
+      auto const interval =
+          (std::max)(emulator_.options().sample_row_keys_interval,
+                     std::int64_t(1));
+      for (auto const& row : table->rows) {
+        for (auto const& cell : FlattenRow(row.second)) {
+          offset += static_cast<std::int64_t>(
+              row.first.size() + cell.family.size() + cell.qualifier.size() +
+              cell.value.size() + sizeof(cell.timestamp));
+        }
+        if (++count % interval == 0) {
+          btproto::SampleRowKeysResponse sample;
+          sample.set_row_key(row.first);
+          sample.set_offset_bytes(offset);
+          samples.push_back(std::move(sample));
+        }
+      }
+      // The last sample is always the end of the table.
+      btproto::SampleRowKeysResponse sample;
+      sample.set_offset_bytes(offset);
+      samples.push_back(std::move(sample));
+    }
+    for (auto const& s : samples) {
+      if (!writer->Write(s)) {
+        break;
+      }
+    }
+    return grpc::Status::OK;
+  }
+
+  grpc::Status MutateRow(grpc::ServerContext*,
+                         btproto::MutateRowRequest const* request,
+                         btproto::MutateRowResponse*) override {
+    ++mutate_row_count_;
+    emulator_.Delay();
+    emulator_.Throttle(request->ByteSizeLong());
+    if (emulator_.InjectFault()) {
+      return Unavailable();
+    }
+    auto table = emulator_.GetTable(request->table_name());
+    std::lock_guard<std::mutex> lk(table->mu);
+    return MutateRowLocked(*table, request->row_key(), request->mutations());
+  }
+
+  grpc::Status MutateRows(
+      grpc::ServerContext*, btproto::MutateRowsRequest const* request,
+      grpc::ServerWriter<btproto::MutateRowsResponse>* writer) override {
+    ++mutate_rows_count_;
+    emulator_.Delay();
+    emulator_.Throttle(request->ByteSizeLong());
+    auto table = emulator_.GetTable(request->table_name());
+    btproto::MutateRowsResponse msg;
+    for (int index = 0; index != request->entries_size(); ++index) {
+      auto const& entry = request->entries(index);
+      grpc::Status status;
+      if (emulator_.InjectFault()) {
+        status = Unavailable();
+      } else {
+        std::lock_guard<std::mutex> lk(table->mu);
+        status = MutateRowLocked(*table, entry.row_key(), entry.mutations());
+      }
+      auto& e = *msg.add_entries();
+      e.set_index(index);
+      e.mutable_status()->set_code(status.error_code());
+      e.mutable_status()->set_message(status.error_message());
+    }
+    writer->WriteLast(msg, grpc::WriteOptions());
+    return grpc::Status::OK;
+  }
+
+  grpc::Status CheckAndMutateRow(
+      grpc::ServerContext*, btproto::CheckAndMutateRowRequest const* request,
+      btproto::CheckAndMutateRowResponse* response) override {
+    emulator_.Delay();
+    if (emulator_.InjectFault()) {
+      return Unavailable();
+    }
+    auto table = emulator_.GetTable(request->table_name());
+    std::lock_guard<std::mutex> lk(table->mu);
+    std::vector<FilteredCell> cells;
+    auto row = table->rows.find(request->row_key());
+    if (row != table->rows.end()) {
+      cells = FlattenRow(row->second);
+    }
+    RegexCache regexes;
+    auto status = SafeApplyFilter(request->predicate_filter(),
+                                  request->row_key(), cells, regexes);
+    if (!status.ok()) {
+      return status;
+    }
+    bool const matched = !cells.empty();
+    response->set_predicate_matched(matched);
+    return MutateRowLocked(
+        *table, request->row_key(),
+        matched ? request->true_mutations() : request->false_mutations());
+  }
+
+  grpc::Status ReadModifyWriteRow(
+      grpc::ServerContext*, btproto::ReadModifyWriteRowRequest const* request,
+      btproto::ReadModifyWriteRowResponse* response) override {
+    emulator_.Delay();
+    if (emulator_.InjectFault()) {
+      return Unavailable();
+    }
+    auto table = emulator_.GetTable(request->table_name());
+    std::lock_guard<std::mutex> lk(table->mu);
+    // Work on a copy, so the row is unchanged if any rule fails.
+    RowData row;
+    auto loc = table->rows.find(request->row_key());
+    if (loc != table->rows.end()) {
+      row = loc->second;
+    }
+    auto const now = NowMicros();
+    std::set<std::pair<std::string, std::string>> modified;
+    for (auto const& rule : request->rules()) {
+      auto& column = row[rule.family_name()][rule.column_qualifier()];
+      std::string value;
+      std::int64_t timestamp = now;
+      if (!column.empty()) {
+        value = column.begin()->second;
+        // The new cell must be the latest version.
+        timestamp = (std::max)(now, column.begin()->first);
+      }
+      if (rule.rule_case() == btproto::ReadModifyWriteRule::kAppendValue) {
+        value += rule.append_value();
+      } else if (rule.rule_case() ==
+                 btproto::ReadModifyWriteRule::kIncrementAmount) {
+        std::int64_t current = 0;
+        if (!value.empty()) {
+          if (value.size() != sizeof(std::int64_t)) {
+            return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                                "cannot increment a non 64-bit value");
+          }
+          current = bigtable::internal::Encoder<bigendian64_t>::Decode(value)
+                        .get();
+        }
+        value = bigtable::internal::Encoder<bigendian64_t>::Encode(
+            bigendian64_t(current + rule.increment_amount()));
+      } else {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                            "rule type not set");
+      }
+      column[timestamp] = std::move(value);
+      modified.emplace(rule.family_name(), rule.column_qualifier());
+    }
+    table->rows[request->row_key()] = row;
+
+    auto& result = *response->mutable_row();
+    result.set_key(request->row_key());
+    btproto::Family* family = nullptr;
+    for (auto const& m : modified) {
+      if (family == nullptr || family->name() != m.first) {
+        family = result.add_families();
+        family->set_name(m.first);
+      }
+      auto const& versions = row[m.first][m.second];
+      auto& column = *family->add_columns();
+      column.set_qualifier(m.second);
+      auto& cell = *column.add_cells();
+      cell.set_timestamp_micros(versions.begin()->first);
+      cell.set_value(versions.begin()->second);
+    }
+    return grpc::Status::OK;
+  }
+
+  int mutate_row_count() const { return mutate_row_count_.load(); }
+  int mutate_rows_count() const { return mutate_rows_count_.load(); }
+  int read_rows_count() const { return read_rows_count_.load(); }
+
+ private:
+  /// Apply the mutations to a row, the caller must hold the table lock.
+  static grpc::Status MutateRowLocked(
+      EmulatedTable& table, std::string const& row_key,
+      google::protobuf::RepeatedPtrField<btproto::Mutation> const& mutations) {
+    auto& row = table.rows[row_key];
+    auto status = ApplyMutations(row, mutations);
+    if (row.empty()) {
+      table.rows.erase(row_key);
+    }
+    return status;
+  }
+
+  /// Append the chunks for a row to @p msg, return the number of bytes added.
+  std::size_t AppendRow(btproto::ReadRowsResponse& msg, std::string const& key,
+                        std::vector<FilteredCell>& cells) const {
+    auto const max_chunk =
+        (std::max)(emulator_.options().max_chunk_value_size, std::size_t(1));
+    std::size_t bytes = key.size();
+    std::string const* family = nullptr;
+    std::string const* qualifier = nullptr;
+    bool first = true;
+    for (auto& c : cells) {
+      bytes += c.family.size() + c.qualifier.size() + c.value.size();
+      auto const value_size = c.value.size();
+      std::size_t offset = 0;
+      do {
+        auto& chunk = *msg.add_chunks();
+        auto const length = (std::min)(max_chunk, value_size - offset);
+        if (offset == 0) {
+          if (first) {
+            chunk.set_row_key(key);
+            first = false;
+          }
+          if (family == nullptr || *family != c.family) {
+            chunk.mutable_family_name()->set_value(c.family);
+            chunk.mutable_qualifier()->set_value(c.qualifier);
+          } else if (*qualifier != c.qualifier) {
+            chunk.mutable_qualifier()->set_value(c.qualifier);
+          }
+          family = &c.family;
+          qualifier = &c.qualifier;
+          chunk.set_timestamp_micros(c.timestamp);
+          for (auto& label : c.labels) {
+            chunk.add_labels(std::move(label));
+          }
+        }
+        chunk.set_value(c.value.substr(offset, length));
+        offset += length;
+        if (offset < value_size) {
+          // Only the chunks before the last one in a cell carry the size.
+          chunk.set_value_size(static_cast<std::int32_t>(value_size));
+        }
+      } while (offset < value_size);
+    }
+    msg.mutable_chunks()->rbegin()->set_commit_row(true);
+    return bytes;
+  }
+
+  Emulator& emulator_;
+  std::atomic<int> mutate_row_count_;
+  std::atomic<int> mutate_rows_count_;
+  std::atomic<int> read_rows_count_;
+};
+
+/**
+ * Implement the table admin APIs needed by the benchmarks.
+ */
+class EmulatorTableAdminImpl final
+    : public btadmin::BigtableTableAdmin::Service {
+ public:
+  explicit EmulatorTableAdminImpl(Emulator& emulator)
+      : emulator_(emulator), create_table_count_(0), delete_table_count_(0) {}
+
+  grpc::Status CreateTable(grpc::ServerContext*,
+                           btadmin::CreateTableRequest const* request,
+                           btadmin::Table* response) override {
+    ++create_table_count_;
+    auto name = request->parent() + "/tables/" + request->table_id();
+    emulator_.GetTable(name);
+    response->set_name(std::move(name));
+    *response->mutable_column_families() =
+        request->table().column_families();
+    return grpc::Status::OK;
+  }
+
+  grpc::Status DeleteTable(grpc::ServerContext*,
+                           btadmin::DeleteTableRequest const* request,
+                           ::google::protobuf::Empty*) override {
+    ++delete_table_count_;
+    emulator_.DeleteTable(request->name());
+    return grpc::Status::OK;
+  }
+
+  int create_table_count() const { return create_table_count_.load(); }
+  int delete_table_count() const { return delete_table_count_.load(); }
+
+ private:
+  Emulator& emulator_;
+  std::atomic<int> create_table_count_;
+  std::atomic<int> delete_table_count_;
+};
+
+/// The implementation of EmbeddedServer using the emulator.
+class EmulatorServer : public EmbeddedServer {
+ public:
+  explicit EmulatorServer(EmulatorOptions options)
+      : emulator_(std::move(options)),
+        bigtable_service_(emulator_),
+        admin_service_(emulator_) {
+    int port;
+    std::string server_address("[::]:0");
+    builder_.AddListeningPort(server_address, grpc::InsecureServerCredentials(),
+                              &port);
+    builder_.RegisterService(&bigtable_service_);
+    builder_.RegisterService(&admin_service_);
+    server_ = builder_.BuildAndStart();
+    address_ = "localhost:" + std::to_string(port);
+  }
+
+  std::string address() const override { return address_; }
+  void Shutdown() override { server_->Shutdown(); }
+  void Wait() override { server_->Wait(); }
+
+  int create_table_count() const override {
+    return admin_service_.create_table_count();
+  }
+  int delete_table_count() const override {
+    return admin_service_.delete_table_count();
+  }
+  int mutate_row_count() const override {
+    return bigtable_service_.mutate_row_count();
+  }
+  int mutate_rows_count() const override {
+    return bigtable_service_.mutate_rows_count();
+  }
+  int read_rows_count() const override {
+    return bigtable_service_.read_rows_count();
+  }
+
+ private:
+  Emulator emulator_;
+  EmulatorBigtableImpl bigtable_service_;
+  EmulatorTableAdminImpl admin_service_;
+  grpc::ServerBuilder builder_;
+  std::unique_ptr<grpc::Server> server_;
+  std::string address_;
+};
+}  // anonymous namespace
+
+EmulatorOptions ParseEmulatorOptions(int& argc, char* argv[]) {
+  EmulatorOptions options;
+  int j = 1;
+  for (int i = 1; i != argc; ++i) {
+    std::string argument(argv[i]);
+    std::string value;
+    if (MatchOption(argument, "emulator-latency-us", value)) {
+      auto latency = std::stol(value);
+      if (latency < 0) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--emulator-latency-us must be >= 0");
+      }
+      options.latency = std::chrono::microseconds(latency);
+      continue;
+    }
+    if (MatchOption(argument, "emulator-bandwidth-mbps", value)) {
+      auto bandwidth = std::stod(value);
+      if (bandwidth < 0) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--emulator-bandwidth-mbps must be >= 0");
+      }
+      options.bandwidth_bytes_per_second = bandwidth * 1024 * 1024;
+      continue;
+    }
+    if (MatchOption(argument, "emulator-error-rate", value)) {
+      options.error_rate = std::stod(value);
+      if (options.error_rate < 0 || options.error_rate > 1) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--emulator-error-rate must be in the [0, 1] range");
+      }
+      continue;
+    }
+    if (MatchOption(argument, "emulator-seed", value)) {
+      options.seed = std::stoull(value);
+      continue;
+    }
+    argv[j++] = argv[i];
+  }
+  argc = j;
+  return options;
+}
+
+std::unique_ptr<EmbeddedServer> CreateEmulatorServer(EmulatorOptions options) {
+  return std::unique_ptr<EmbeddedServer>(
+      new EmulatorServer(std::move(options)));
+}
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,100 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_DATA_EMULATOR_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_DATA_EMULATOR_H_
+
+#include "google/cloud/bigtable/benchmarks/embedded_server.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+/**
+ * Configure the behavior of the in-memory data emulator.
+ *
+ * The defaults make the emulator as fast as possible, with no injected
+ * faults. Use a fixed `seed` to make the injected faults reproducible.
+ */
+struct EmulatorOptions {
+  /// A delay added to the start of each RPC.
+  std::chrono::microseconds latency = std::chrono::microseconds(0);
+  /// Limit the bytes per second sent by streaming RPCs, 0 means no limit.
+  double bandwidth_bytes_per_second = 0;
+  /**
+   * The probability of injecting an `UNAVAILABLE` error.
+   *
+   * Unary RPCs fail before applying any change, `MutateRows` fails individual
+   * entries, and `ReadRows` fails at a random point in the stream.
+   */
+  double error_rate = 0;
+  /// The seed for the fault injection, 0 uses a random seed.
+  std::uint64_t seed = 0;
+  /// Values larger than this are split across several chunks.
+  std::size_t max_chunk_value_size = 1024 * 1024;
+  /// The (approximate) maximum size of each `ReadRowsResponse`.
+  std::size_t max_response_bytes = 256 * 1024;
+  /// `SampleRowKeys` returns one sample every this many rows.
+  std::int64_t sample_row_keys_interval = 1000;
+};
+
+/**
+ * Remove the emulator options from the command-line and return their values.
+ *
+ * The options are `--emulator-latency-us=<microseconds>`,
+ * `--emulator-bandwidth-mbps=<megabytes per second>`,
+ * `--emulator-error-rate=<probability>`, and `--emulator-seed=<number>`.
+ *
+ * @throws std::invalid_argument if any option has an invalid value.
+ */
+EmulatorOptions ParseEmulatorOptions(int& argc, char* argv[]);
+
+/**
+ * Create an embedded server backed by an in-memory Bigtable emulator.
+ *
+ * Unlike `CreateEmbeddedServer()`, which returns canned responses, this server
+ * keeps the data in sorted, multi-version, in-memory tables. It implements
+ * `ReadRows` (row sets, row limits, filters, and chunked responses),
+ * `MutateRow`, `MutateRows`, `CheckAndMutateRow`, `ReadModifyWriteRow`,
+ * `SampleRowKeys`, and the `CreateTable` and `DeleteTable` admin RPCs. Tables
+ * are also created on their first use.
+ *
+ * The emulator supports the following filters: `pass_all_filter`,
+ * `block_all_filter`, `chain`, `interleave`, `condition`,
+ * `row_key_regex_filter`, `family_name_regex_filter`,
+ * `column_qualifier_regex_filter`, `value_regex_filter`,
+ * `column_range_filter`, `value_range_filter`, `timestamp_range_filter`,
+ * `cells_per_row_offset_filter`, `cells_per_row_limit_filter`,
+ * `cells_per_column_limit_filter`,
+ * `strip_value_transformer`, and `apply_label_transformer`. The regular
+ * expressions use `std::regex` (ECMAScript syntax) rather than RE2, so they
+ * match the service for the common cases only. Other filters fail with
+ * `UNIMPLEMENTED`.
+ *
+ * It is intended to measure the client library, on a single machine, with
+ * reproducible conditions. It is not a replacement for the Cloud Bigtable
+ * Emulator, and does not implement all the validation done by the service.
+ */
+std::unique_ptr<EmbeddedServer> CreateEmulatorServer(
+    EmulatorOptions options = {});
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_DATA_EMULATOR_H_
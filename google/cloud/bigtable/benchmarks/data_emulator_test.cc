@@ -0,0 +1,372 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/data_emulator.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/table_admin.h"
+#include "google/cloud/bigtable/version.h"
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+using namespace bigtable::benchmarks;
+using std::chrono::milliseconds;
+
+namespace {
+class DataEmulatorTest : public ::testing::Test {
+ protected:
+  void StartServer(EmulatorOptions options = {}) {
+    server_ = CreateEmulatorServer(std::move(options));
+    wait_thread_ = std::thread([this]() { server_->Wait(); });
+    bigtable::ClientOptions client_options(grpc::InsecureChannelCredentials());
+    client_options.set_data_endpoint(server_->address());
+    client_options.set_admin_endpoint(server_->address());
+    data_client_ = bigtable::CreateDefaultDataClient(
+        "fake-project", "fake-instance", client_options);
+    admin_client_ =
+        bigtable::CreateDefaultAdminClient("fake-project", client_options);
+  }
+
+  void SetUp() override { StartServer(); }
+
+  void TearDown() override {
+    server_->Shutdown();
+    wait_thread_.join();
+  }
+
+  void RestartServer(EmulatorOptions options) {
+    TearDown();
+    StartServer(std::move(options));
+  }
+
+  bigtable::Table MakeTable() {
+    return bigtable::Table(data_client_, "fake-table");
+  }
+
+  /// Create rows "row-00" to "row-<count>", each with two columns.
+  void Populate(bigtable::Table& table, int count) {
+    bigtable::BulkMutation bulk;
+    for (int i = 0; i != count; ++i) {
+      char key[16];
+      std::snprintf(key, sizeof(key), "row-%02d", i);
+      bulk.emplace_back(bigtable::SingleRowMutation(
+          key, {bigtable::SetCell("fam", "c0", milliseconds(1000), "v0"),
+                bigtable::SetCell("fam", "c0", milliseconds(2000), "v1"),
+                bigtable::SetCell("fam", "c1", milliseconds(1000),
+                                  std::to_string(i))}));
+    }
+    table.BulkApply(std::move(bulk));
+  }
+
+  std::vector<std::string> ReadKeys(bigtable::Table& table,
+                                    bigtable::RowSet const& row_set,
+                                    std::int64_t rows_limit,
+                                    bigtable::Filter filter) {
+    std::vector<std::string> keys;
+    for (auto const& row :
+         table.ReadRows(row_set, rows_limit, std::move(filter))) {
+      keys.push_back(row.row_key());
+    }
+    return keys;
+  }
+
+  std::unique_ptr<EmbeddedServer> server_;
+  std::thread wait_thread_;
+  std::shared_ptr<bigtable::DataClient> data_client_;
+  std::shared_ptr<bigtable::AdminClient> admin_client_;
+};
+}  // anonymous namespace
+
+/// @test Verify that the emulator keeps the data written by BulkApply().
+TEST_F(DataEmulatorTest, BulkApplyAndReadRows) {
+  auto table = MakeTable();
+  Populate(table, 20);
+  EXPECT_EQ(1, server_->mutate_rows_count());
+
+  auto keys = ReadKeys(table, bigtable::RowSet(), 0,
+                       bigtable::Filter::PassAllFilter());
+  ASSERT_EQ(20U, keys.size());
+  EXPECT_EQ("row-00", keys.front());
+  EXPECT_EQ("row-19", keys.back());
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+  auto row = table.ReadRow("row-07", bigtable::Filter::PassAllFilter());
+  ASSERT_TRUE(row.first);
+  auto const& cells = row.second.cells();
+  ASSERT_EQ(3U, cells.size());
+  // Cells are sorted by column, and then newest first.
+  EXPECT_EQ("c0", cells[0].column_qualifier());
+  EXPECT_EQ("v1", cells[0].value());
+  EXPECT_EQ(2000000, cells[0].timestamp().count());
+  EXPECT_EQ("v0", cells[1].value());
+  EXPECT_EQ("c1", cells[2].column_qualifier());
+  EXPECT_EQ("7", cells[2].value());
+}
+
+/// @test Verify that ReadRows() honors row sets and row limits.
+TEST_F(DataEmulatorTest, ReadRowsRowSetAndLimit) {
+  auto table = MakeTable();
+  Populate(table, 20);
+
+  bigtable::RowSet row_set(bigtable::RowRange::Range("row-03", "row-06"),
+                           bigtable::RowRange::Closed("row-05", "row-08"));
+  row_set.Append("row-15");
+  row_set.Append("row-not-there");
+  auto keys = ReadKeys(table, row_set, 0, bigtable::Filter::PassAllFilter());
+  EXPECT_THAT(keys, ::testing::ElementsAre("row-03", "row-04", "row-05",
+                                           "row-06", "row-07", "row-08",
+                                           "row-15"));
+
+  keys = ReadKeys(table, row_set, 2, bigtable::Filter::PassAllFilter());
+  EXPECT_THAT(keys, ::testing::ElementsAre("row-03", "row-04"));
+}
+
+/// @test Verify that ReadRows() applies the filters.
+TEST_F(DataEmulatorTest, ReadRowsFilters) {
+  auto table = MakeTable();
+  Populate(table, 20);
+  using F = bigtable::Filter;
+
+  auto keys =
+      ReadKeys(table, bigtable::RowSet(), 0, F::RowKeysRegex(".*-1.*"));
+  EXPECT_EQ(10U, keys.size());
+
+  // Rows without any matching cells are not returned.
+  keys = ReadKeys(table, bigtable::RowSet(), 0,
+                  F::Chain(F::ColumnName("fam", "c1"), F::ValueRegex("1.")));
+  EXPECT_EQ(10U, keys.size());
+
+  auto row = table.ReadRow(
+      "row-02", F::Chain(F::Latest(1), F::StripValueTransformer()));
+  ASSERT_TRUE(row.first);
+  ASSERT_EQ(2U, row.second.cells().size());
+  EXPECT_EQ(2000000, row.second.cells()[0].timestamp().count());
+  EXPECT_EQ("", row.second.cells()[0].value());
+
+  row = table.ReadRow(
+      "row-02", F::Interleave(F::ColumnName("fam", "c1"),
+                              F::Chain(F::ColumnName("fam", "c0"),
+                                       F::ApplyLabelTransformer("label"))));
+  ASSERT_TRUE(row.first);
+  ASSERT_EQ(3U, row.second.cells().size());
+  EXPECT_EQ("c0", row.second.cells()[0].column_qualifier());
+  EXPECT_THAT(row.second.cells()[0].labels(),
+              ::testing::ElementsAre("label"));
+  EXPECT_EQ("c1", row.second.cells()[2].column_qualifier());
+
+  row = table.ReadRow("row-02",
+                      F::Chain(F::CellsRowOffset(1), F::CellsRowLimit(1)));
+  ASSERT_TRUE(row.first);
+  ASSERT_EQ(1U, row.second.cells().size());
+  EXPECT_EQ("v0", row.second.cells()[0].value());
+
+  row = table.ReadRow("row-02", F::TimestampRange(milliseconds(0),
+                                                  milliseconds(1500)));
+  ASSERT_TRUE(row.first);
+  EXPECT_EQ(2U, row.second.cells().size());
+
+  row = table.ReadRow("row-02", F::BlockAllFilter());
+  EXPECT_FALSE(row.first);
+}
+
+/// @test Verify that the emulator rejects filters it does not implement.
+TEST_F(DataEmulatorTest, ReadRowsUnimplementedFilter) {
+  auto table = MakeTable();
+  Populate(table, 2);
+  auto reader = table.ReadRows(bigtable::RowSet(),
+                               bigtable::Filter::RowSample(0.5));
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  EXPECT_THROW(std::distance(reader.begin(), reader.end()), std::exception);
+#else
+  EXPECT_DEATH_IF_SUPPORTED(std::distance(reader.begin(), reader.end()),
+                            "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+/// @test Verify that large values are split across several chunks.
+TEST_F(DataEmulatorTest, ReadRowsLargeValues) {
+  EmulatorOptions options;
+  options.max_chunk_value_size = 10;
+  options.max_response_bytes = 64;
+  RestartServer(options);
+
+  auto table = MakeTable();
+  std::string const large(1000, 'x');
+  bigtable::BulkMutation bulk;
+  for (auto const& key : {"a", "b", "c"}) {
+    bulk.emplace_back(bigtable::SingleRowMutation(
+        key, {bigtable::SetCell("fam", "col", milliseconds(0), large),
+              bigtable::SetCell("fam", "col2", milliseconds(0), "small")}));
+  }
+  table.BulkApply(std::move(bulk));
+
+  int count = 0;
+  for (auto const& row :
+       table.ReadRows(bigtable::RowSet(), bigtable::Filter::PassAllFilter())) {
+    ASSERT_EQ(2U, row.cells().size());
+    EXPECT_EQ(large, row.cells()[0].value());
+    EXPECT_EQ("small", row.cells()[1].value());
+    ++count;
+  }
+  EXPECT_EQ(3, count);
+}
+
+/// @test Verify that Apply() supports all the mutation types.
+TEST_F(DataEmulatorTest, ApplyDeletes) {
+  auto table = MakeTable();
+  Populate(table, 3);
+
+  table.Apply(bigtable::SingleRowMutation(
+      "row-00", {bigtable::DeleteFromColumn("fam", "c0", milliseconds(1500),
+                                            milliseconds(2500))}));
+  auto row = table.ReadRow("row-00", bigtable::Filter::PassAllFilter());
+  ASSERT_TRUE(row.first);
+  EXPECT_EQ(2U, row.second.cells().size());
+
+  table.Apply(bigtable::SingleRowMutation(
+      "row-01", {bigtable::DeleteFromFamily("fam")}));
+  EXPECT_FALSE(
+      table.ReadRow("row-01", bigtable::Filter::PassAllFilter()).first);
+
+  table.Apply(
+      bigtable::SingleRowMutation("row-02", {bigtable::DeleteFromRow()}));
+  EXPECT_FALSE(
+      table.ReadRow("row-02", bigtable::Filter::PassAllFilter()).first);
+  EXPECT_EQ(3, server_->mutate_row_count());
+}
+
+/// @test Verify that CheckAndMutateRow() evaluates the predicate.
+TEST_F(DataEmulatorTest, CheckAndMutateRow) {
+  auto table = MakeTable();
+  Populate(table, 1);
+  using F = bigtable::Filter;
+
+  auto matched = table.CheckAndMutateRow(
+      "row-00", F::ValueRegex("v1"),
+      {bigtable::SetCell("fam", "matched", milliseconds(0), "true")},
+      {bigtable::SetCell("fam", "matched", milliseconds(0), "false")});
+  EXPECT_TRUE(matched);
+  matched = table.CheckAndMutateRow(
+      "row-00", F::ValueRegex("not-there"),
+      {bigtable::SetCell("fam", "other", milliseconds(0), "true")},
+      {bigtable::SetCell("fam", "other", milliseconds(0), "false")});
+  EXPECT_FALSE(matched);
+
+  auto row = table.ReadRow(
+      "row-00", F::ColumnRangeClosed("fam", "matched", "other"));
+  ASSERT_TRUE(row.first);
+  ASSERT_EQ(2U, row.second.cells().size());
+  EXPECT_EQ("true", row.second.cells()[0].value());
+  EXPECT_EQ("false", row.second.cells()[1].value());
+}
+
+/// @test Verify that ReadModifyWriteRow() appends and increments values.
+TEST_F(DataEmulatorTest, ReadModifyWriteRow) {
+  auto table = MakeTable();
+
+  auto row = table.ReadModifyWriteRow(
+      "counter", bigtable::ReadModifyWriteRule::IncrementAmount("fam", "n", 5),
+      bigtable::ReadModifyWriteRule::AppendValue("fam", "s", "foo"));
+  ASSERT_EQ(2U, row.cells().size());
+  row = table.ReadModifyWriteRow(
+      "counter", bigtable::ReadModifyWriteRule::IncrementAmount("fam", "n", 37),
+      bigtable::ReadModifyWriteRule::AppendValue("fam", "s", "bar"));
+  ASSERT_EQ(2U, row.cells().size());
+  EXPECT_EQ("n", row.cells()[0].column_qualifier());
+  EXPECT_EQ(42, row.cells()[0].value_as<bigtable::bigendian64_t>().get());
+  EXPECT_EQ("foobar", row.cells()[1].value());
+
+  // The previous versions are kept.
+  auto read = table.ReadRow("counter", bigtable::Filter::PassAllFilter());
+  ASSERT_TRUE(read.first);
+  EXPECT_LE(2U, read.second.cells().size());
+}
+
+/// @test Verify that SampleRows() returns keys in the table.
+TEST_F(DataEmulatorTest, SampleRows) {
+  EmulatorOptions options;
+  options.sample_row_keys_interval = 5;
+  RestartServer(options);
+
+  auto table = MakeTable();
+  Populate(table, 20);
+  auto samples = table.SampleRows<std::vector>();
+  ASSERT_EQ(5U, samples.size());
+  EXPECT_EQ("row-04", samples[0].row_key);
+  EXPECT_EQ("", samples.back().row_key);
+  for (std::size_t i = 1; i != samples.size(); ++i) {
+    EXPECT_LE(samples[i - 1].offset_bytes, samples[i].offset_bytes);
+  }
+}
+
+/// @test Verify that the admin RPCs create and delete tables.
+TEST_F(DataEmulatorTest, Admin) {
+  bigtable::TableAdmin admin(admin_client_, "fake-instance");
+  admin.CreateTable("fake-table",
+                    bigtable::TableConfig(
+                        {{"fam", bigtable::GcRule::MaxNumVersions(1)}}, {}));
+  EXPECT_EQ(1, server_->create_table_count());
+
+  auto table = MakeTable();
+  Populate(table, 3);
+  admin.DeleteTable("fake-table");
+  EXPECT_EQ(1, server_->delete_table_count());
+  EXPECT_TRUE(ReadKeys(table, bigtable::RowSet(), 0,
+                       bigtable::Filter::PassAllFilter())
+                  .empty());
+}
+
+/// @test Verify that the emulator injects errors.
+TEST_F(DataEmulatorTest, InjectErrors) {
+  EmulatorOptions options;
+  options.error_rate = 1.0;
+  options.seed = 42;
+  RestartServer(options);
+
+  auto table = MakeTable();
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  // CheckAndMutateRow() is not idempotent, so it is not retried.
+  EXPECT_THROW(table.CheckAndMutateRow(
+                   "row", bigtable::Filter::PassAllFilter(),
+                   {bigtable::SetCell("fam", "col", milliseconds(0), "v")}, {}),
+               std::exception);
+#else
+  EXPECT_DEATH_IF_SUPPORTED(
+      table.CheckAndMutateRow(
+          "row", bigtable::Filter::PassAllFilter(),
+          {bigtable::SetCell("fam", "col", milliseconds(0), "v")}, {}),
+      "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+/// @test Verify that ParseEmulatorOptions() removes the emulator flags.
+TEST(DataEmulatorOptions, Parse) {
+  char arg0[] = "program";
+  char arg1[] = "--emulator-latency-us=100";
+  char arg2[] = "positional";
+  char arg3[] = "--emulator-bandwidth-mbps=2";
+  char arg4[] = "--emulator-error-rate=0.5";
+  char arg5[] = "--emulator-seed=7";
+  char* argv[] = {arg0, arg1, arg2, arg3, arg4, arg5};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+
+  auto options = ParseEmulatorOptions(argc, argv);
+  ASSERT_EQ(2, argc);
+  EXPECT_EQ(std::string("positional"), argv[1]);
+  EXPECT_EQ(100, options.latency.count());
+  EXPECT_DOUBLE_EQ(2.0 * 1024 * 1024, options.bandwidth_bytes_per_second);
+  EXPECT_DOUBLE_EQ(0.5, options.error_rate);
+  EXPECT_EQ(7U, options.seed);
+}
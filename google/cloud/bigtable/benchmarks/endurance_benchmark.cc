@@ -13,10 +13,12 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/bigtable/benchmarks/open_loop.h"
 #include "google/cloud/bigtable/benchmarks/random_mutation.h"
 #include <future>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 
 /**
  * @file
@@ -44,7 +46,23 @@
  *   - Select a row at random, write to it.
  *
  * The test then waits for all the threads to finish and reports effective
- * throughput.
+ * throughput, and the latency percentiles for each operation. The latencies
+ * are recorded in fixed-size histograms, so the memory usage does not grow
+ * with the duration of the test.
+ *
+ * If the `--target-qps=N` option is given the benchmark runs in open-loop
+ * mode: the threads start operations at a combined rate of N per second, with
+ * Poisson arrivals, and measure the latency from the intended start time of
+ * each operation. With `--report-interval=S` the benchmark prints the p50,
+ * p99, p99.9 and maximum latency of the last S seconds, in the format selected
+ * by `--report-format=csv` (the default) or `--report-format=json`.
+ *
+ * With `--retry-budget=R` all the threads share a `bigtable::RetryBudget`
+ * allowing R retries for each successful operation, and with
+ * `--circuit-breaker-threshold=N` they share a `bigtable::CircuitBreaker` that
+ * opens after N consecutive transient failures. The benchmark reports how many
+ * retries and requests were rejected, which is most interesting when running
+ * against the embedded emulator with `--emulator-error-rate`.
  *
  * Using a command-line parameter the benchmark can be configured to create a
  * local gRPC server that implements the Cloud Bigtable APIs used by the
@@ -58,23 +76,52 @@ namespace {
 namespace bigtable = google::cloud::bigtable;
 using namespace bigtable::benchmarks;
 
+/// The operations in the test, in the order used by the recorders.
+enum EnduranceOperation { kReadRowOp = 0, kApplyOp = 1 };
+
+/// The retry limits shared by all the threads, null when disabled.
+struct SharedRetryLimits {
+  std::shared_ptr<bigtable::RetryBudget> budget;
+  std::shared_ptr<bigtable::CircuitBreaker> breaker;
+};
+
 /// Run an iteration of the test, returns the number of operations.
 long RunBenchmark(bigtable::benchmarks::Benchmark& benchmark,
                   bigtable::AppProfileId app_profile_id,
                   std::string const& table_id,
-                  std::chrono::seconds test_duration);
+                  std::chrono::seconds test_duration, double qps,
+                  SharedRetryLimits limits,
+                  std::shared_ptr<LatencyRecorder> recorder);
+
+/// Print the counters of the retry budget and circuit breaker, if enabled.
+void PrintRetryLimits(std::ostream& os, SharedRetryLimits const& limits);
 
 }  // anonymous namespace
 
 int main(int argc, char* argv[]) try {
+  auto const open_loop = ParseOpenLoopOptions(argc, argv);
+  auto const retry_limit_options = ParseRetryLimitOptions(argc, argv);
   bigtable::benchmarks::BenchmarkSetup setup("long", argc, argv);
   Benchmark benchmark(setup);
   // Create and populate the table for the benchmark.
   benchmark.CreateTable();
 
+  SharedRetryLimits limits;
+  if (retry_limit_options.retry_budget > 0) {
+    limits.budget = std::make_shared<bigtable::RetryBudget>(
+        retry_limit_options.retry_budget);
+  }
+  if (retry_limit_options.circuit_breaker_threshold > 0) {
+    limits.breaker = std::make_shared<bigtable::CircuitBreaker>(
+        retry_limit_options.circuit_breaker_threshold);
+  }
+
   // Start the threads running the latency test.
   std::cout << "# Running Endurance Benchmark:" << std::endl;
   auto latency_test_start = std::chrono::steady_clock::now();
+  IntervalReporter reporter(std::cout, "long", {"ReadRow()", "Apply()"},
+                            open_loop);
+  auto const thread_qps = open_loop.target_qps / setup.thread_count();
   std::vector<std::future<long>> tasks;
   for (int i = 0; i != setup.thread_count(); ++i) {
     auto launch_policy = std::launch::async;
@@ -85,7 +132,8 @@ int main(int argc, char* argv[]) try {
     tasks.emplace_back(
         std::async(launch_policy, RunBenchmark, std::ref(benchmark),
                    bigtable::AppProfileId(setup.app_profile_id()),
-                   setup.table_id(), setup.test_duration()));
+                   setup.table_id(), setup.test_duration(), thread_qps,
+                   limits, reporter.MakeRecorder()));
   }
 
   // Wait for the threads and combine all the results.
@@ -107,6 +155,12 @@ int main(int argc, char* argv[]) try {
   std::cout << "# DONE. Elapsed=" << FormatDuration(elapsed)
             << ", Ops=" << combined << ", Throughput: " << throughput
             << " ops/sec" << std::endl;
+  auto totals = reporter.Stop();
+  benchmark.PrintLatencyResult(std::cout, "long", "ReadRow()",
+                               totals[kReadRowOp], elapsed);
+  benchmark.PrintLatencyResult(std::cout, "long", "Apply()", totals[kApplyOp],
+                               elapsed);
+  PrintRetryLimits(std::cout, limits);
 
   benchmark.DeleteTable();
   return 0;
@@ -116,60 +170,121 @@ int main(int argc, char* argv[]) try {
 }
 
 namespace {
-OperationResult RunOneApply(bigtable::Table& table, Benchmark const& benchmark,
-                            google::cloud::internal::DefaultPRNG& generator) {
+/**
+ * Return the time used to measure the latency of an operation.
+ *
+ * In closed-loop mode there is no intended start time (@p intended_start is
+ * the default value) and the operation starts immediately. In open-loop mode
+ * wait until the intended start time and measure the latency from it.
+ */
+std::chrono::steady_clock::time_point StartTime(
+    std::chrono::steady_clock::time_point intended_start) {
+  if (intended_start == std::chrono::steady_clock::time_point{}) {
+    return std::chrono::steady_clock::now();
+  }
+  std::this_thread::sleep_until(intended_start);
+  return intended_start;
+}
+
+void RunOneApply(bigtable::Table& table, Benchmark const& benchmark,
+                 google::cloud::internal::DefaultPRNG& generator,
+                 std::chrono::steady_clock::time_point intended_start,
+                 LatencyRecorder& recorder) {
   auto row_key = benchmark.MakeRandomKey(generator);
   bigtable::SingleRowMutation mutation(std::move(row_key));
   for (int field = 0; field != kNumFields; ++field) {
     mutation.emplace_back(MakeRandomMutation(generator, field));
   }
   auto op = [&table, &mutation]() { table.Apply(std::move(mutation)); };
-  return Benchmark::TimeOperation(std::move(op));
+  auto r = TimeOperationSince(StartTime(intended_start), std::move(op));
+  recorder.Record(kApplyOp, r.first, r.second);
 }
 
-OperationResult RunOneReadRow(bigtable::Table& table,
-                              Benchmark const& benchmark,
-                              google::cloud::internal::DefaultPRNG& generator) {
+void RunOneReadRow(bigtable::Table& table, Benchmark const& benchmark,
+                   google::cloud::internal::DefaultPRNG& generator,
+                   std::chrono::steady_clock::time_point intended_start,
+                   LatencyRecorder& recorder) {
   auto row_key = benchmark.MakeRandomKey(generator);
   auto op = [&table, &row_key]() {
     auto row = table.ReadRow(
         std::move(row_key),
         bigtable::Filter::ColumnRangeClosed(kColumnFamily, "field0", "field9"));
   };
-  return Benchmark::TimeOperation(std::move(op));
+  auto r = TimeOperationSince(StartTime(intended_start), std::move(op));
+  recorder.Record(kReadRowOp, r.first, r.second);
+}
+
+/// Decorate the default retry policy with the shared retry limits.
+std::unique_ptr<bigtable::RPCRetryPolicy> MakeRetryPolicy(
+    SharedRetryLimits const& limits) {
+  auto policy =
+      bigtable::DefaultRPCRetryPolicy(bigtable::internal::kBigtableLimits);
+  if (limits.budget) {
+    policy.reset(new bigtable::BudgetedRetryPolicy(*policy, limits.budget));
+  }
+  if (limits.breaker) {
+    policy.reset(
+        new bigtable::CircuitBreakerRetryPolicy(*policy, limits.breaker));
+  }
+  return policy;
 }
 
 long RunBenchmark(bigtable::benchmarks::Benchmark& benchmark,
                   bigtable::AppProfileId app_profile_id,
                   std::string const& table_id,
-                  std::chrono::seconds test_duration) {
+                  std::chrono::seconds test_duration, double qps,
+                  SharedRetryLimits limits,
+                  std::shared_ptr<LatencyRecorder> recorder) {
   long total_ops = 0;
 
-  BenchmarkResult partial = {};
-
   auto data_client = benchmark.MakeDataClient();
-  bigtable::Table table(std::move(data_client), app_profile_id, table_id);
+  auto retry_policy = MakeRetryPolicy(limits);
+  bigtable::Table table(std::move(data_client), app_profile_id, table_id,
+                        *retry_policy);
 
   auto generator = google::cloud::internal::MakeDefaultPRNG();
 
   auto start = std::chrono::steady_clock::now();
   auto end = start + test_duration;
 
+  if (qps > 0) {
+    // In open-loop mode keep the same mix of operations: two reads for each
+    // write.
+    PoissonArrivals arrivals(qps, start);
+    for (auto intended = arrivals.Next(); intended < end;
+         intended = arrivals.Next()) {
+      if (total_ops % 3 == 2) {
+        RunOneApply(table, benchmark, generator, intended, *recorder);
+      } else {
+        RunOneReadRow(table, benchmark, generator, intended, *recorder);
+      }
+      ++total_ops;
+    }
+    return total_ops;
+  }
+
+  std::chrono::steady_clock::time_point const closed_loop{};
   for (auto now = start; now < end; now = std::chrono::steady_clock::now()) {
-    partial.operations.emplace_back(RunOneReadRow(table, benchmark, generator));
-    ++partial.row_count;
-    partial.operations.emplace_back(RunOneReadRow(table, benchmark, generator));
-    ++partial.row_count;
-    partial.operations.emplace_back(RunOneApply(table, benchmark, generator));
-    ++partial.row_count;
+    RunOneReadRow(table, benchmark, generator, closed_loop, *recorder);
+    RunOneReadRow(table, benchmark, generator, closed_loop, *recorder);
+    RunOneApply(table, benchmark, generator, closed_loop, *recorder);
+    total_ops += 3;
   }
-  partial.elapsed =
-      std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-  std::ostringstream msg;
-  benchmark.PrintLatencyResult(msg, "long", "Partial::Op", partial);
-  std::cout << msg.str() << std::flush;
-  total_ops = partial.operations.size();
   return total_ops;
 }
 
+void PrintRetryLimits(std::ostream& os, SharedRetryLimits const& limits) {
+  if (limits.budget) {
+    os << "# Retry Budget: Successes=" << limits.budget->success_count()
+       << ", Retries=" << limits.budget->retry_count()
+       << ", Rejected Retries=" << limits.budget->rejected_retry_count()
+       << std::endl;
+  }
+  if (limits.breaker) {
+    os << "# Circuit Breaker: Opened=" << limits.breaker->open_count()
+       << ", Rejected Requests=" << limits.breaker->rejected_count()
+       << std::endl;
+  }
+}
+
 }  // anonymous namespace
@@ -0,0 +1,281 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/future.h"
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Measure the cost of creating, satisfying, and chaining `future<T>` objects.
+ *
+ * The asynchronous APIs create (at least) one `future<T>` for each RPC, and
+ * often chain several continuations to it. This benchmark measures the
+ * throughput and memory allocations for the following scenarios:
+ *
+ * - `create-set-get`: create a promise, get its future, set the value, and
+ *   then get the value from the future.
+ * - `then-chain`: attach a chain of continuations to a future, then set the
+ *   value of the promise and get the result at the end of the chain.
+ * - `then-ready`: attach a continuation to a future that is already satisfied.
+ * - `cross-thread`: satisfy the promise in one thread while another thread
+ *   blocks in `future<T>::get()`.
+ * - `fan-out-get`: satisfy the promises in one thread, while another thread
+ *   calls `future<T>::get()` on each future in a batch.
+ * - `fan-out-when-all`: like `fan-out-get`, but the consumer waits for each
+ *   batch using `when_all()`.
+ * - `coroutine-chain`: like `then-chain`, but each link in the chain is a
+ *   coroutine that uses `co_await`. Only when the compiler supports C++20
+ *   coroutines.
+ * - `coroutine-ready`: like `then-ready`, but using `co_await`.
+ *
+ * The benchmark replaces the global `operator new` to count allocations.
+ *
+ * Usage: future_benchmark [iterations] [chain-length] [fan-out]
+ */
+
+namespace {
+std::atomic<std::uint64_t> allocation_count(0);
+}  // anonymous namespace
+
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+/// Helper functions and types for the future_benchmark.
+namespace {
+using google::cloud::future;
+using google::cloud::promise;
+using google::cloud::bigtable::benchmarks::FormatDuration;
+
+/// The results of running one of the scenarios.
+struct ScenarioResult {
+  std::string name;
+  long iterations;
+  std::uint64_t allocations;
+  std::chrono::nanoseconds elapsed;
+};
+
+template <typename Functor>
+ScenarioResult RunScenario(std::string name, long iterations,
+                           Functor&& functor) {
+  auto const initial_count = allocation_count.load();
+  auto const start = std::chrono::steady_clock::now();
+  long checksum = 0;
+  for (long i = 0; i != iterations; ++i) {
+    checksum += functor(i);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  auto const allocations = allocation_count.load() - initial_count;
+  if (checksum == 0) {
+    // Prevent the optimizer from removing the loop, the checksum is never 0.
+    std::cerr << "unexpected checksum" << std::endl;
+  }
+  return ScenarioResult{std::move(name), iterations, allocations, elapsed};
+}
+
+long CreateSetGet(long i) {
+  promise<long> p;
+  auto f = p.get_future();
+  p.set_value(i + 1);
+  return f.get();
+}
+
+long ThenChain(long i, int chain_length) {
+  promise<long> p;
+  auto f = p.get_future();
+  for (int j = 0; j != chain_length; ++j) {
+    f = f.then([](future<long> g) { return g.get() + 1; });
+  }
+  p.set_value(i);
+  return f.get();
+}
+
+long ThenReady(long i) {
+  promise<long> p;
+  auto f = p.get_future();
+  p.set_value(i);
+  return f.then([](future<long> g) { return g.get() + 1; }).get();
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+future<long> AddOne(future<long> f) { co_return co_await std::move(f) + 1; }
+
+long CoroutineChain(long i, int chain_length) {
+  promise<long> p;
+  auto f = p.get_future();
+  for (int j = 0; j != chain_length; ++j) {
+    f = AddOne(std::move(f));
+  }
+  p.set_value(i);
+  return f.get();
+}
+
+long CoroutineReady(long i) {
+  promise<long> p;
+  auto f = p.get_future();
+  p.set_value(i);
+  return AddOne(std::move(f)).get();
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+
+/// Satisfy the promises in a separate thread, block on each future.
+ScenarioResult CrossThread(long iterations) {
+  std::vector<promise<long>> promises(iterations);
+  std::vector<future<long>> futures;
+  futures.reserve(iterations);
+  for (auto& p : promises) {
+    futures.push_back(p.get_future());
+  }
+  auto const initial_count = allocation_count.load();
+  auto const start = std::chrono::steady_clock::now();
+  std::thread producer([&promises] {
+    long i = 0;
+    for (auto& p : promises) {
+      p.set_value(++i);
+    }
+  });
+  long checksum = 0;
+  for (auto& f : futures) {
+    checksum += f.get();
+  }
+  producer.join();
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  auto const allocations = allocation_count.load() - initial_count;
+  if (checksum == 0) {
+    std::cerr << "unexpected checksum" << std::endl;
+  }
+  return ScenarioResult{"cross-thread", iterations, allocations, elapsed};
+}
+
+/**
+ * Satisfy the promises in a separate thread, wait for them in batches.
+ *
+ * The consumer either blocks on each future in turn, or combines each batch
+ * with `when_all()` and blocks once.
+ */
+ScenarioResult FanOut(long iterations, int fan_out, bool use_when_all) {
+  std::vector<promise<long>> promises(iterations);
+  std::vector<future<long>> futures;
+  futures.reserve(iterations);
+  for (auto& p : promises) {
+    futures.push_back(p.get_future());
+  }
+  auto const initial_count = allocation_count.load();
+  auto const start = std::chrono::steady_clock::now();
+  std::thread producer([&promises] {
+    long i = 0;
+    for (auto& p : promises) {
+      p.set_value(++i);
+    }
+  });
+  long checksum = 0;
+  for (auto batch = futures.begin(); batch != futures.end();) {
+    auto const remaining = std::distance(batch, futures.end());
+    auto end = batch + (std::min<long>)(fan_out, remaining);
+    if (use_when_all) {
+      for (auto& f : when_all(batch, end).get()) {
+        checksum += f.get();
+      }
+    } else {
+      for (auto i = batch; i != end; ++i) {
+        checksum += i->get();
+      }
+    }
+    batch = end;
+  }
+  producer.join();
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  auto const allocations = allocation_count.load() - initial_count;
+  if (checksum == 0) {
+    std::cerr << "unexpected checksum" << std::endl;
+  }
+  return ScenarioResult{use_when_all ? "fan-out-when-all" : "fan-out-get",
+                        iterations, allocations, elapsed};
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  long iterations = 1000000;
+  int chain_length = 4;
+  int fan_out = 100;
+  if (argc > 1) {
+    iterations = std::stol(argv[1]);
+  }
+  if (argc > 2) {
+    chain_length = std::stoi(argv[2]);
+  }
+  if (argc > 3) {
+    fan_out = std::stoi(argv[3]);
+  }
+  if (iterations <= 0 || chain_length <= 0 || fan_out <= 0) {
+    std::cerr << "Usage: " << argv[0]
+              << " [iterations] [chain-length] [fan-out]" << std::endl;
+    return 1;
+  }
+
+  std::vector<ScenarioResult> results;
+  results.push_back(RunScenario("create-set-get", iterations, CreateSetGet));
+  results.push_back(RunScenario(
+      "then-chain", iterations,
+      [chain_length](long i) { return ThenChain(i, chain_length); }));
+  results.push_back(RunScenario("then-ready", iterations, ThenReady));
+  results.push_back(CrossThread(iterations));
+  results.push_back(FanOut(iterations, fan_out, false));
+  results.push_back(FanOut(iterations, fan_out, true));
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+  results.push_back(RunScenario(
+      "coroutine-chain", iterations,
+      [chain_length](long i) { return CoroutineChain(i, chain_length); }));
+  results.push_back(RunScenario("coroutine-ready", iterations, CoroutineReady));
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+
+  std::cout << "# Iterations: " << iterations
+            << ", Chain Length: " << chain_length << ", Fan Out: " << fan_out
+            << "\n"
+            << "Scenario,Allocations/Op,Time/Op,Ops/s\n";
+  for (auto const& r : results) {
+    auto const seconds = std::chrono::duration<double>(r.elapsed).count();
+    std::cout << r.name << "," << std::fixed << std::setprecision(2)
+              << static_cast<double>(r.allocations) / r.iterations << ","
+              << FormatDuration(r.elapsed / r.iterations) << ","
+              << std::setprecision(0) << r.iterations / seconds << "\n";
+  }
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
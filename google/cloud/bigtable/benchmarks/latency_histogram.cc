@@ -0,0 +1,128 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+/// Values below this threshold get their own bucket.
+constexpr std::int64_t kExactBuckets = 128;
+/// Each power of two above kExactBuckets is split in 2^kSubBucketBits buckets.
+constexpr int kSubBucketBits = 6;
+constexpr std::int64_t kSubBuckets = std::int64_t(1) << kSubBucketBits;
+/// The number of powers of two above kExactBuckets, up to 2^62.
+constexpr std::int64_t kGroups = 62 - kSubBucketBits;
+constexpr std::size_t kBucketCount = kExactBuckets + kGroups * kSubBuckets;
+}  // anonymous namespace
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+LatencyHistogram::LatencyHistogram()
+    : buckets_(kBucketCount), count_(0), min_(0), max_(0) {}
+
+void LatencyHistogram::Record(std::chrono::microseconds latency) {
+  std::int64_t value = (std::max)(std::int64_t(latency.count()),
+                                  std::int64_t(0));
+  ++buckets_[BucketIndex(value)];
+  min_ = count_ == 0 ? value : (std::min)(min_, value);
+  max_ = count_ == 0 ? value : (std::max)(max_, value);
+  ++count_;
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& rhs) {
+  if (rhs.count_ == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i != buckets_.size(); ++i) {
+    buckets_[i] += rhs.buckets_[i];
+  }
+  min_ = count_ == 0 ? rhs.min_ : (std::min)(min_, rhs.min_);
+  max_ = count_ == 0 ? rhs.max_ : (std::max)(max_, rhs.max_);
+  count_ += rhs.count_;
+}
+
+void LatencyHistogram::Clear() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+}
+
+std::chrono::microseconds LatencyHistogram::min() const {
+  return std::chrono::microseconds(min_);
+}
+
+std::chrono::microseconds LatencyHistogram::max() const {
+  return std::chrono::microseconds(max_);
+}
+
+std::chrono::microseconds LatencyHistogram::ValueAtPercentile(
+    double percentile) const {
+  if (count_ == 0) {
+    return std::chrono::microseconds(0);
+  }
+  if (percentile <= 0) {
+    return min();
+  }
+  auto const target = (std::max)(
+      std::int64_t(1),
+      static_cast<std::int64_t>(std::ceil(count_ * percentile / 100.0)));
+  std::int64_t seen = 0;
+  for (std::size_t i = 0; i != buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      auto value = (std::min)(BucketUpperBound(i), max_);
+      return std::chrono::microseconds((std::max)(value, min_));
+    }
+  }
+  return max();
+}
+
+std::size_t LatencyHistogram::BucketIndex(std::int64_t value) {
+  if (value < kExactBuckets) {
+    return static_cast<std::size_t>(value);
+  }
+  int msb = 0;
+  for (auto v = value; v > 1; v >>= 1) {
+    ++msb;
+  }
+  // For values in [2^msb, 2^(msb+1)) keep the top kSubBucketBits + 1 bits, the
+  // highest of these bits is always set.
+  int const shift = msb - kSubBucketBits;
+  auto const top = value >> shift;
+  return static_cast<std::size_t>(kExactBuckets + (shift - 1) * kSubBuckets +
+                                  (top - kSubBuckets));
+}
+
+std::int64_t LatencyHistogram::BucketUpperBound(std::size_t index) {
+  auto const i = static_cast<std::int64_t>(index);
+  if (i < kExactBuckets) {
+    return i;
+  }
+  auto const shift = (i - kExactBuckets) / kSubBuckets + 1;
+  auto const top = kSubBuckets + (i - kExactBuckets) % kSubBuckets;
+  if (shift >= kGroups) {
+    return (std::numeric_limits<std::int64_t>::max)();
+  }
+  return ((top + 1) << shift) - 1;
+}
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
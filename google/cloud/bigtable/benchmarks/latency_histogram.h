@@ -0,0 +1,96 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_LATENCY_HISTOGRAM_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_LATENCY_HISTOGRAM_H_
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+/**
+ * A fixed-size histogram of latencies, in the style of HdrHistogram.
+ *
+ * Values (in microseconds) below 128 are recorded exactly. Larger values are
+ * recorded in log-linear buckets: each power of two is split in 64 buckets, so
+ * the reported percentiles are within 1/64 (about 1.6%) of the actual values.
+ * The histogram uses the same memory regardless of how many values are
+ * recorded, and histograms from different threads can be merged.
+ *
+ * This class is not thread-safe, each thread should record into its own
+ * histogram and merge them at the end.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  /// Record @p latency, negative values are recorded as 0.
+  void Record(std::chrono::microseconds latency);
+
+  /// Add all the values recorded in @p rhs to this histogram.
+  void Merge(LatencyHistogram const& rhs);
+
+  /// Discard all the recorded values.
+  void Clear();
+
+  /// The number of recorded values.
+  std::int64_t count() const { return count_; }
+
+  /// The smallest recorded value, 0 if the histogram is empty.
+  std::chrono::microseconds min() const;
+
+  /// The largest recorded value, 0 if the histogram is empty.
+  std::chrono::microseconds max() const;
+
+  /**
+   * Return the value at the given percentile.
+   *
+   * The result is the largest value in the bucket holding the percentile, and
+   * never exceeds `max()`. Returns 0 if the histogram is empty.
+   *
+   * @param percentile a value in the [0, 100] range.
+   */
+  std::chrono::microseconds ValueAtPercentile(double percentile) const;
+
+ private:
+  static std::size_t BucketIndex(std::int64_t value);
+  static std::int64_t BucketUpperBound(std::size_t index);
+
+  std::vector<std::int64_t> buckets_;
+  std::int64_t count_;
+  std::int64_t min_;
+  std::int64_t max_;
+};
+
+/// Latency and error counts for one operation type.
+struct LatencyStats {
+  LatencyHistogram histogram;
+  std::int64_t errors = 0;
+
+  void Merge(LatencyStats const& rhs) {
+    histogram.Merge(rhs.histogram);
+    errors += rhs.errors;
+  }
+};
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_LATENCY_HISTOGRAM_H_
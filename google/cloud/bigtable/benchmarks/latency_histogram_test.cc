@@ -0,0 +1,102 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
+#include <gmock/gmock.h>
+#include <limits>
+
+using namespace google::cloud::bigtable::benchmarks;
+using std::chrono::microseconds;
+
+/// @test Verify that an empty histogram reports zeros.
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram h;
+  EXPECT_EQ(0, h.count());
+  EXPECT_EQ(0, h.min().count());
+  EXPECT_EQ(0, h.max().count());
+  EXPECT_EQ(0, h.ValueAtPercentile(50).count());
+}
+
+/// @test Verify that small values are recorded exactly.
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int i = 1; i <= 100; ++i) {
+    h.Record(microseconds(i));
+  }
+  EXPECT_EQ(100, h.count());
+  EXPECT_EQ(1, h.min().count());
+  EXPECT_EQ(100, h.max().count());
+  EXPECT_EQ(1, h.ValueAtPercentile(0).count());
+  EXPECT_EQ(50, h.ValueAtPercentile(50).count());
+  EXPECT_EQ(99, h.ValueAtPercentile(99).count());
+  EXPECT_EQ(100, h.ValueAtPercentile(100).count());
+}
+
+/// @test Verify that large values are recorded with bounded relative error.
+TEST(LatencyHistogramTest, LargeValuesRelativeError) {
+  LatencyHistogram h;
+  for (std::int64_t i = 1; i <= 100000; ++i) {
+    h.Record(microseconds(i * 100));
+  }
+  for (double p : {10.0, 50.0, 90.0, 99.0, 99.9}) {
+    auto expected = static_cast<double>(p * 100000 * 100 / 100);
+    auto actual = static_cast<double>(h.ValueAtPercentile(p).count());
+    EXPECT_NEAR(expected, actual, expected / 64) << "p=" << p;
+    EXPECT_LE(expected, actual) << "p=" << p;
+  }
+  EXPECT_EQ(100, h.min().count());
+  EXPECT_EQ(10000000, h.max().count());
+  EXPECT_EQ(h.max(), h.ValueAtPercentile(100));
+}
+
+/// @test Verify that negative and very large values do not break the buckets.
+TEST(LatencyHistogramTest, ExtremeValues) {
+  LatencyHistogram h;
+  h.Record(microseconds(-5));
+  h.Record(microseconds(std::numeric_limits<std::int64_t>::max()));
+  EXPECT_EQ(2, h.count());
+  EXPECT_EQ(0, h.min().count());
+  EXPECT_EQ(std::numeric_limits<std::int64_t>::max(), h.max().count());
+  EXPECT_EQ(h.max(), h.ValueAtPercentile(100));
+}
+
+/// @test Verify that merging histograms combines their values.
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram a;
+  LatencyHistogram b;
+  for (int i = 1; i <= 50; ++i) {
+    a.Record(microseconds(i));
+    b.Record(microseconds(50 + i));
+  }
+  LatencyHistogram merged;
+  merged.Merge(b);
+  merged.Merge(a);
+  EXPECT_EQ(100, merged.count());
+  EXPECT_EQ(1, merged.min().count());
+  EXPECT_EQ(100, merged.max().count());
+  EXPECT_EQ(50, merged.ValueAtPercentile(50).count());
+
+  LatencyStats stats;
+  stats.errors = 2;
+  LatencyStats other;
+  other.histogram = a;
+  other.errors = 3;
+  stats.Merge(other);
+  EXPECT_EQ(5, stats.errors);
+  EXPECT_EQ(50, stats.histogram.count());
+
+  merged.Clear();
+  EXPECT_EQ(0, merged.count());
+  EXPECT_EQ(0, merged.ValueAtPercentile(50).count());
+}
@@ -0,0 +1,149 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/log.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Measure the throughput of `GCP_LOG()` calls when many threads log at once.
+ *
+ * The benchmark runs several threads, each one logs a number of `DEBUG`
+ * messages, as the library does with debug logging enabled. It reports the
+ * number of log calls per second for the following scenarios:
+ *
+ * - `sync`: the backend is called in the thread that logs.
+ * - `async`: the records are buffered and delivered from a background thread,
+ *   the time includes a final `LogSink::Flush()`.
+ * - `async-rate-limited`: like `async`, with a rate limit.
+ *
+ * The backend formats each record into a string, to simulate the cost of a
+ * backend such as `std::clog` without producing any output.
+ *
+ * Usage: log_benchmark [thread-count] [iterations-per-thread]
+ */
+
+/// Helper functions and types for the log_benchmark.
+namespace {
+using google::cloud::LogBackend;
+using google::cloud::LogRecord;
+using google::cloud::LogSink;
+using google::cloud::bigtable::benchmarks::FormatDuration;
+
+class FormattingBackend : public LogBackend {
+ public:
+  void Process(LogRecord const& lr) override {
+    std::ostringstream os;
+    os << lr;
+    bytes_.fetch_add(os.str().size(), std::memory_order_relaxed);
+    records_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void ProcessWithOwnership(LogRecord lr) override { Process(lr); }
+
+  long records() const { return records_.load(); }
+
+ private:
+  std::atomic<std::size_t> bytes_{0};
+  std::atomic<long> records_{0};
+};
+
+struct ScenarioResult {
+  std::string name;
+  long calls;
+  long delivered;
+  std::uint64_t dropped;
+  std::chrono::nanoseconds elapsed;
+};
+
+ScenarioResult RunScenario(std::string name, int thread_count,
+                           long iterations, bool async, long rate_limit) {
+  LogSink sink;
+  auto backend = std::make_shared<FormattingBackend>();
+  sink.AddBackend(backend);
+  sink.set_minimum_severity(google::cloud::Severity::GCP_LS_DEBUG);
+  sink.set_rate_limit(rate_limit);
+  if (async) {
+    sink.EnableAsync();
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t != thread_count; ++t) {
+    threads.emplace_back([&sink, t, iterations] {
+      for (long i = 0; i != iterations; ++i) {
+        GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_DEBUG, sink)
+            << "thread=" << t << " iteration=" << i << " some payload";
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  sink.Flush();
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  sink.DisableAsync();
+
+  return ScenarioResult{std::move(name), thread_count * iterations,
+                        backend->records(),
+                        sink.dropped_count() + sink.rate_limited_count(),
+                        elapsed};
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  int thread_count = 8;
+  long iterations = 100000;
+  if (argc > 1) {
+    thread_count = std::stoi(argv[1]);
+  }
+  if (argc > 2) {
+    iterations = std::stol(argv[2]);
+  }
+  if (thread_count <= 0 || iterations <= 0) {
+    std::cerr << "Usage: " << argv[0]
+              << " [thread-count] [iterations-per-thread]" << std::endl;
+    return 1;
+  }
+
+  std::vector<ScenarioResult> results;
+  results.push_back(RunScenario("sync", thread_count, iterations, false, 0));
+  results.push_back(RunScenario("async", thread_count, iterations, true, 0));
+  results.push_back(RunScenario("async-rate-limited", thread_count, iterations,
+                                true, 100000));
+
+  std::cout << "# Threads: " << thread_count
+            << ", Iterations/Thread: " << iterations << "\n"
+            << "Scenario,Calls,Delivered,Dropped,Time/Call,Calls/s\n";
+  for (auto const& r : results) {
+    auto const seconds = std::chrono::duration<double>(r.elapsed).count();
+    std::cout << r.name << "," << r.calls << "," << r.delivered << ","
+              << r.dropped << "," << FormatDuration(r.elapsed / r.calls) << ","
+              << std::fixed << std::setprecision(0) << r.calls / seconds
+              << "\n";
+  }
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
@@ -0,0 +1,210 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/open_loop.h"
+#include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+OpenLoopOptions ParseOpenLoopOptions(int& argc, char* argv[]) {
+  OpenLoopOptions options;
+  int j = 1;
+  for (int i = 1; i != argc; ++i) {
+    std::string argument(argv[i]);
+    std::string value;
+    if (MatchOption(argument, "target-qps", value)) {
+      options.target_qps = std::stod(value);
+      if (options.target_qps < 0) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--target-qps must be >= 0");
+      }
+      continue;
+    }
+    if (MatchOption(argument, "report-interval", value)) {
+      auto seconds = std::stol(value);
+      if (seconds < 0) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--report-interval must be >= 0");
+      }
+      options.report_interval = std::chrono::seconds(seconds);
+      continue;
+    }
+    if (MatchOption(argument, "report-format", value)) {
+      std::transform(value.begin(), value.end(), value.begin(),
+                     [](char x) { return std::tolower(x); });
+      if (value != "csv" && value != "json") {
+        google::cloud::internal::ThrowInvalidArgument(
+            "--report-format must be csv or json");
+      }
+      options.report_format = value;
+      continue;
+    }
+    argv[j++] = argv[i];
+  }
+  argc = j;
+  return options;
+}
+
+PoissonArrivals::PoissonArrivals(double qps,
+                                 std::chrono::steady_clock::time_point start)
+    : interval_(qps),
+      generator_(google::cloud::internal::MakeDefaultPRNG()),
+      next_(start) {}
+
+std::chrono::steady_clock::time_point PoissonArrivals::Next() {
+  using std::chrono::duration_cast;
+  auto delay = std::chrono::duration<double>(interval_(generator_));
+  next_ += duration_cast<std::chrono::steady_clock::duration>(delay);
+  return next_;
+}
+
+LatencyRecorder::LatencyRecorder(std::size_t operation_count)
+    : interval_(operation_count), totals_(operation_count) {}
+
+void LatencyRecorder::Record(std::size_t operation, bool successful,
+                             std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  interval_[operation].histogram.Record(latency);
+  totals_[operation].histogram.Record(latency);
+  if (!successful) {
+    ++interval_[operation].errors;
+    ++totals_[operation].errors;
+  }
+}
+
+void LatencyRecorder::DrainInterval(std::vector<LatencyStats>& destination) {
+  std::lock_guard<std::mutex> lk(mu_);
+  for (std::size_t i = 0; i != interval_.size(); ++i) {
+    destination[i].Merge(interval_[i]);
+    interval_[i].histogram.Clear();
+    interval_[i].errors = 0;
+  }
+}
+
+void LatencyRecorder::MergeTotals(
+    std::vector<LatencyStats>& destination) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  for (std::size_t i = 0; i != totals_.size(); ++i) {
+    destination[i].Merge(totals_[i]);
+  }
+}
+
+IntervalReporter::IntervalReporter(std::ostream& os, std::string test_name,
+                                   std::vector<std::string> operation_names,
+                                   OpenLoopOptions const& options)
+    : os_(os),
+      test_name_(std::move(test_name)),
+      operation_names_(std::move(operation_names)),
+      report_interval_(options.report_interval),
+      json_(options.report_format == "json"),
+      start_(std::chrono::steady_clock::now()),
+      stopped_(false) {
+  if (report_interval_.count() == 0) {
+    return;
+  }
+  if (!json_) {
+    os_ << IntervalCsvHeader() << std::endl;
+  }
+  reporter_ = std::thread(&IntervalReporter::ReportLoop, this);
+}
+
+IntervalReporter::~IntervalReporter() { Stop(); }
+
+std::shared_ptr<LatencyRecorder> IntervalReporter::MakeRecorder() {
+  auto recorder = std::make_shared<LatencyRecorder>(operation_names_.size());
+  std::lock_guard<std::mutex> lk(mu_);
+  recorders_.push_back(recorder);
+  return recorder;
+}
+
+std::vector<LatencyStats> IntervalReporter::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  std::unique_lock<std::mutex> lk(mu_);
+  if (reporter_.joinable()) {
+    // The reporting thread needs the lock to exit.
+    lk.unlock();
+    reporter_.join();
+    lk.lock();
+    // Report the last (partial) interval.
+    Report(std::chrono::steady_clock::now());
+  }
+  std::vector<LatencyStats> totals(operation_names_.size());
+  for (auto const& r : recorders_) {
+    r->MergeTotals(totals);
+  }
+  return totals;
+}
+
+std::string IntervalReporter::IntervalCsvHeader() {
+  return "name,elapsed,op.name,nsamples,errors,p50,p99,p99.9,max,units";
+}
+
+void IntervalReporter::ReportLoop() {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto next = start_ + report_interval_;
+  while (!cv_.wait_until(lk, next, [this] { return stopped_; })) {
+    Report(next);
+    next += report_interval_;
+  }
+}
+
+// The caller must hold `mu_`.
+void IntervalReporter::Report(std::chrono::steady_clock::time_point now) {
+  std::vector<LatencyStats> interval(operation_names_.size());
+  for (auto const& r : recorders_) {
+    r->DrainInterval(interval);
+  }
+  auto const elapsed = std::chrono::duration<double>(now - start_).count();
+
+  std::ostringstream os;
+  for (std::size_t i = 0; i != interval.size(); ++i) {
+    auto const& h = interval[i].histogram;
+    if (json_) {
+      os << R"({"name":")" << test_name_ << R"(","elapsed":)" << std::fixed
+         << std::setprecision(3) << elapsed << R"(,"op.name":")"
+         << operation_names_[i] << R"(","nsamples":)" << h.count()
+         << R"(,"errors":)" << interval[i].errors
+         << R"(,"p50":)" << h.ValueAtPercentile(50).count()
+         << R"(,"p99":)" << h.ValueAtPercentile(99).count()
+         << R"(,"p99.9":)" << h.ValueAtPercentile(99.9).count()
+         << R"(,"max":)" << h.max().count() << R"(,"units":"us"})"
+         << "\n";
+      continue;
+    }
+    os << test_name_ << "," << std::fixed << std::setprecision(3) << elapsed
+       << "," << operation_names_[i] << "," << h.count() << ","
+       << interval[i].errors << "," << h.ValueAtPercentile(50).count() << ","
+       << h.ValueAtPercentile(99).count() << ","
+       << h.ValueAtPercentile(99.9).count() << "," << h.max().count()
+       << ",us\n";
+  }
+  os_ << os.str() << std::flush;
+}
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
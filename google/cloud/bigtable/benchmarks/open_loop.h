@@ -0,0 +1,183 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_OPEN_LOOP_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_OPEN_LOOP_H_
+
+#include "google/cloud/bigtable/benchmarks/latency_histogram.h"
+#include "google/cloud/internal/random.h"
+#include <chrono>
+#include <condition_variable>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+namespace benchmarks {
+/**
+ * Configure the open-loop mode of the latency benchmarks.
+ *
+ * In the default (closed-loop) mode each benchmark thread starts a new
+ * operation as soon as the previous one completes. When the service slows
+ * down the benchmark also slows down, and the latency the application would
+ * have observed is never recorded (this is known as "coordinated omission").
+ *
+ * In open-loop mode the benchmark threads start operations at the target rate,
+ * with exponentially distributed inter-arrival times (a Poisson process). The
+ * latency of each operation is measured from the time it was supposed to
+ * start, so any queueing caused by slow operations is included.
+ */
+struct OpenLoopOptions {
+  /// The target rate for all the threads combined, 0 disables open-loop mode.
+  double target_qps = 0;
+  /// How often to report the latency of the last interval, 0 disables reports.
+  std::chrono::seconds report_interval = std::chrono::seconds(0);
+  /// The format for the interval reports, either "csv" or "json".
+  std::string report_format = "csv";
+
+  bool enabled() const { return target_qps > 0; }
+};
+
+/**
+ * Remove the open-loop options from the command-line and return their values.
+ *
+ * The options are `--target-qps=<number>`, `--report-interval=<seconds>`, and
+ * `--report-format=<csv|json>`. They can appear anywhere in the command-line.
+ *
+ * @throws std::invalid_argument if any option has an invalid value.
+ */
+OpenLoopOptions ParseOpenLoopOptions(int& argc, char* argv[]);
+
+/// Generate the start times for a Poisson process with the given rate.
+class PoissonArrivals {
+ public:
+  PoissonArrivals(double qps, std::chrono::steady_clock::time_point start);
+
+  /// Return the intended start time for the next operation.
+  std::chrono::steady_clock::time_point Next();
+
+ private:
+  std::exponential_distribution<double> interval_;
+  google::cloud::internal::DefaultPRNG generator_;
+  std::chrono::steady_clock::time_point next_;
+};
+
+/**
+ * Measure the latency of an operation from its intended start time.
+ *
+ * If the benchmark is falling behind the operation starts after
+ * @p intended_start, and the difference is included in the latency.
+ */
+template <typename Operation>
+std::pair<bool, std::chrono::microseconds> TimeOperationSince(
+    std::chrono::steady_clock::time_point intended_start, Operation&& op) {
+  bool successful = false;
+  try {
+    op();
+    successful = true;
+  } catch (...) {
+  }
+  using std::chrono::duration_cast;
+  auto elapsed = duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - intended_start);
+  return {successful, elapsed};
+}
+
+/**
+ * Record the latency of the operations run by one benchmark thread.
+ *
+ * The recorder keeps the statistics for the current reporting interval and for
+ * the whole run. Only the owning thread calls `Record()`, the mutex is only
+ * contended when `IntervalReporter` collects the results for an interval.
+ */
+class LatencyRecorder {
+ public:
+  explicit LatencyRecorder(std::size_t operation_count);
+
+  /// Record the result of an operation of type @p operation.
+  void Record(std::size_t operation, bool successful,
+              std::chrono::microseconds latency);
+
+  /// Merge the current interval into @p destination and start a new interval.
+  void DrainInterval(std::vector<LatencyStats>& destination);
+
+  /// Merge the statistics for the whole run into @p destination.
+  void MergeTotals(std::vector<LatencyStats>& destination) const;
+
+ private:
+  mutable std::mutex mu_;
+  std::vector<LatencyStats> interval_;
+  std::vector<LatencyStats> totals_;
+};
+
+/**
+ * Periodically print the latency percentiles of all the benchmark threads.
+ *
+ * Each benchmark thread records into its own `LatencyRecorder`, created with
+ * `MakeRecorder()`. Every `report_interval` a background thread merges the
+ * recorders and prints one line per operation with the number of samples,
+ * errors, p50, p99, p99.9 and maximum latency (in microseconds) of the last
+ * interval, using the CSV or JSON format. `Stop()` prints the last partial
+ * interval and returns the statistics for the whole run.
+ */
+class IntervalReporter {
+ public:
+  IntervalReporter(std::ostream& os, std::string test_name,
+                   std::vector<std::string> operation_names,
+                   OpenLoopOptions const& options);
+  ~IntervalReporter();
+
+  IntervalReporter(IntervalReporter const&) = delete;
+  IntervalReporter& operator=(IntervalReporter const&) = delete;
+
+  /// Create a recorder for a new benchmark thread.
+  std::shared_ptr<LatencyRecorder> MakeRecorder();
+
+  /// Stop the reporting thread, return the totals for each operation.
+  std::vector<LatencyStats> Stop();
+
+  /// Return the header for the CSV interval reports.
+  static std::string IntervalCsvHeader();
+
+ private:
+  void ReportLoop();
+  void Report(std::chrono::steady_clock::time_point now);
+
+  std::ostream& os_;
+  std::string test_name_;
+  std::vector<std::string> operation_names_;
+  std::chrono::seconds report_interval_;
+  bool json_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stopped_;
+  std::vector<std::shared_ptr<LatencyRecorder>> recorders_;
+  std::thread reporter_;
+};
+
+}  // namespace benchmarks
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_OPEN_LOOP_H_
@@ -0,0 +1,191 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/open_loop.h"
+#include "google/cloud/bigtable/version.h"
+#include <gmock/gmock.h>
+#include <sstream>
+
+using namespace google::cloud::bigtable::benchmarks;
+using std::chrono::microseconds;
+using testing::HasSubstr;
+
+namespace {
+char arg0[] = "program";
+char arg1[] = "--target-qps=250.5";
+char arg2[] = "foo";
+char arg3[] = "--report-interval=10";
+char arg4[] = "--report-format=JSON";
+char arg5[] = "bar";
+}  // anonymous namespace
+
+/// @test Verify that the open-loop options are removed from the command-line.
+TEST(OpenLoopTest, ParseOptions) {
+  char* argv[] = {arg0, arg1, arg2, arg3, arg4, arg5};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto options = ParseOpenLoopOptions(argc, argv);
+  EXPECT_TRUE(options.enabled());
+  EXPECT_DOUBLE_EQ(250.5, options.target_qps);
+  EXPECT_EQ(10, options.report_interval.count());
+  EXPECT_EQ("json", options.report_format);
+  ASSERT_EQ(3, argc);
+  EXPECT_EQ(std::string("program"), argv[0]);
+  EXPECT_EQ(std::string("foo"), argv[1]);
+  EXPECT_EQ(std::string("bar"), argv[2]);
+}
+
+/// @test Verify that the open-loop mode is disabled by default.
+TEST(OpenLoopTest, ParseDefaults) {
+  char* argv[] = {arg0, arg2, arg5};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  auto options = ParseOpenLoopOptions(argc, argv);
+  EXPECT_FALSE(options.enabled());
+  EXPECT_EQ(0, options.report_interval.count());
+  EXPECT_EQ("csv", options.report_format);
+  EXPECT_EQ(3, argc);
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that invalid options are rejected.
+TEST(OpenLoopTest, ParseInvalid) {
+  char bad_format[] = "--report-format=xml";
+  char* argv[] = {arg0, bad_format};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  EXPECT_THROW(ParseOpenLoopOptions(argc, argv), std::invalid_argument);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+/// @test Verify that the arrivals are increasing and match the target rate.
+TEST(OpenLoopTest, PoissonArrivals) {
+  auto const start = std::chrono::steady_clock::now();
+  PoissonArrivals arrivals(1000.0, start);
+  auto previous = start;
+  int const count = 100000;
+  for (int i = 0; i != count; ++i) {
+    auto next = arrivals.Next();
+    EXPECT_LE(previous, next);
+    previous = next;
+  }
+  // 100,000 arrivals at 1,000 per second should take about 100 seconds, the
+  // standard deviation is about 0.3 seconds.
+  auto elapsed = std::chrono::duration<double>(previous - start).count();
+  EXPECT_NEAR(100.0, elapsed, 3.0);
+}
+
+/// @test Verify that the latency is measured from the intended start time.
+TEST(OpenLoopTest, TimeOperationSince) {
+  auto const intended = std::chrono::steady_clock::now() -
+                        std::chrono::milliseconds(20);
+  auto r = TimeOperationSince(intended, [] {});
+  EXPECT_TRUE(r.first);
+  EXPECT_LE(20000, r.second.count());
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  r = TimeOperationSince(intended, [] { throw std::runtime_error("uh-oh"); });
+  EXPECT_FALSE(r.first);
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+/// @test Verify that the recorder separates intervals from totals.
+TEST(OpenLoopTest, LatencyRecorder) {
+  LatencyRecorder recorder(2);
+  recorder.Record(0, true, microseconds(10));
+  recorder.Record(1, false, microseconds(20));
+  std::vector<LatencyStats> interval(2);
+  recorder.DrainInterval(interval);
+  EXPECT_EQ(1, interval[0].histogram.count());
+  EXPECT_EQ(1, interval[1].histogram.count());
+  EXPECT_EQ(1, interval[1].errors);
+
+  recorder.Record(0, true, microseconds(30));
+  std::vector<LatencyStats> next(2);
+  recorder.DrainInterval(next);
+  EXPECT_EQ(1, next[0].histogram.count());
+  EXPECT_EQ(30, next[0].histogram.max().count());
+  EXPECT_EQ(0, next[1].histogram.count());
+  EXPECT_EQ(0, next[1].errors);
+
+  std::vector<LatencyStats> totals(2);
+  recorder.MergeTotals(totals);
+  EXPECT_EQ(2, totals[0].histogram.count());
+  EXPECT_EQ(1, totals[1].histogram.count());
+  EXPECT_EQ(1, totals[1].errors);
+}
+
+/// @test Verify that the reporter merges all the recorders.
+TEST(OpenLoopTest, ReporterTotals) {
+  std::ostringstream os;
+  OpenLoopOptions options;
+  IntervalReporter reporter(os, "test", {"Apply()", "ReadRow()"}, options);
+  auto r1 = reporter.MakeRecorder();
+  auto r2 = reporter.MakeRecorder();
+  r1->Record(0, true, microseconds(10));
+  r2->Record(0, false, microseconds(20));
+  r2->Record(1, true, microseconds(30));
+  auto totals = reporter.Stop();
+  ASSERT_EQ(2U, totals.size());
+  EXPECT_EQ(2, totals[0].histogram.count());
+  EXPECT_EQ(1, totals[0].errors);
+  EXPECT_EQ(1, totals[1].histogram.count());
+  // Without a report interval nothing is printed.
+  EXPECT_EQ("", os.str());
+}
+
+/// @test Verify the format of the CSV interval reports.
+TEST(OpenLoopTest, ReporterCsv) {
+  std::ostringstream os;
+  OpenLoopOptions options;
+  options.report_interval = std::chrono::seconds(3600);
+  IntervalReporter reporter(os, "test", {"Apply()"}, options);
+  auto r = reporter.MakeRecorder();
+  r->Record(0, true, microseconds(10));
+  r->Record(0, false, microseconds(20));
+  reporter.Stop();
+  auto output = os.str();
+  EXPECT_THAT(output, HasSubstr(IntervalReporter::IntervalCsvHeader() + "\n"));
+  EXPECT_THAT(output, HasSubstr(",Apply(),2,1,10,20,20,20,us\n"));
+  EXPECT_EQ(0U, output.find("name,"));
+  EXPECT_THAT(output, HasSubstr("test,"));
+}
+
+/// @test Verify the format of the JSON interval reports.
+TEST(OpenLoopTest, ReporterJson) {
+  std::ostringstream os;
+  OpenLoopOptions options;
+  options.report_interval = std::chrono::seconds(3600);
+  options.report_format = "json";
+  IntervalReporter reporter(os, "test", {"ReadRow()"}, options);
+  reporter.MakeRecorder()->Record(0, true, microseconds(42));
+  reporter.Stop();
+  auto output = os.str();
+  EXPECT_EQ(0U, output.find(R"({"name":"test","elapsed":)"));
+  EXPECT_THAT(output,
+              HasSubstr(R"js("op.name":"ReadRow()","nsamples":1,)js"
+                        R"js("errors":0,"p50":42,"p99":42,"p99.9":42,)js"
+                        R"js("max":42,"units":"us"})js"));
+}
+
+/// @test Verify that the reporter prints a report after each interval.
+TEST(OpenLoopTest, ReporterInterval) {
+  std::ostringstream os;
+  OpenLoopOptions options;
+  options.report_interval = std::chrono::seconds(1);
+  IntervalReporter reporter(os, "test", {"Apply()"}, options);
+  reporter.MakeRecorder()->Record(0, true, microseconds(10));
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  reporter.Stop();
+  auto output = os.str();
+  EXPECT_THAT(output, HasSubstr("test,1.000,Apply(),1,0,10,10,10,10,us\n"));
+  // The last (partial) interval has no samples.
+  EXPECT_THAT(output, HasSubstr(",Apply(),0,0,0,0,0,0,us\n"));
+}
@@ -0,0 +1,214 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/bigtable/benchmarks/constants.h"
+#include "google/cloud/bigtable/internal/readrowsparser.h"
+#include <google/protobuf/arena.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Count the memory allocations needed to parse `ReadRows()` responses.
+ *
+ * This benchmark does not contact any server. It serializes a "typical"
+ * `ReadRowsResponse` (rows with a single column family, 10 columns, each
+ * column with a 100 byte value), and then parses it as many times as requested
+ * using each one of the following strategies:
+ *
+ * - `heap-move`: the response is a heap-allocated message, and each chunk is
+ *   moved into a temporary before being handed to the parser. This is how
+ *   `RowReader` used to consume responses.
+ * - `heap-reuse`: the response is a heap-allocated message reused for all the
+ *   responses, and the parser swaps the data out of each chunk in place.
+ * - `arena-reuse`: like `heap-reuse`, but the response is allocated in a
+ *   `google::protobuf::Arena`. This is what `RowReader` and `AsyncRowReader`
+ *   do now.
+ *
+ * The benchmark replaces the global `operator new` to count allocations, and
+ * reports the number of allocations per response and per row, as well as the
+ * average time to parse each response.
+ *
+ * Usage: read_rows_allocation_benchmark [iterations] [rows-per-response]
+ */
+
+namespace {
+std::atomic<std::uint64_t> allocation_count(0);
+}  // anonymous namespace
+
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+/// Helper functions and types for the read_rows_allocation_benchmark.
+namespace {
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace bigtable::benchmarks;
+
+/// The results of running one of the strategies.
+struct AllocationResult {
+  std::string name;
+  std::uint64_t allocations;
+  std::chrono::nanoseconds elapsed;
+};
+
+/// Create a serialized response with @p row_count rows.
+std::string MakeSerializedResponse(int row_count) {
+  btproto::ReadRowsResponse response;
+  for (int row = 0; row != row_count; ++row) {
+    std::ostringstream os;
+    os << "user" << std::setw(12) << std::setfill('0') << row;
+    for (int field = 0; field != kNumFields; ++field) {
+      auto& chunk = *response.add_chunks();
+      if (field == 0) {
+        chunk.set_row_key(os.str());
+        chunk.mutable_family_name()->set_value(kColumnFamily);
+      }
+      chunk.mutable_qualifier()->set_value("field" + std::to_string(field));
+      chunk.set_timestamp_micros(1000);
+      chunk.set_value(std::string(kFieldSize, 'a' + (field % 26)));
+      chunk.set_commit_row(field == kNumFields - 1);
+    }
+  }
+  return response.SerializeAsString();
+}
+
+/// Feed the chunks in @p response to @p parser, return the number of rows.
+template <typename ChunkConsumer>
+long ParseResponse(bigtable::internal::ReadRowsParser& parser,
+                   btproto::ReadRowsResponse& response,
+                   ChunkConsumer const& consume) {
+  long rows = 0;
+  grpc::Status status;
+  for (auto& chunk : *response.mutable_chunks()) {
+    consume(parser, chunk, status);
+    if (!status.ok()) {
+      throw std::runtime_error("error parsing chunk: " +
+                               status.error_message());
+    }
+    if (parser.HasNext()) {
+      auto row = parser.Next(status);
+      ++rows;
+    }
+  }
+  return rows;
+}
+
+/// Parse @p data @p iterations times, reading into @p response.
+template <typename ChunkConsumer>
+AllocationResult RunStrategy(std::string name, std::string const& data,
+                             long iterations,
+                             btproto::ReadRowsResponse& response,
+                             ChunkConsumer const& consume) {
+  auto const start = std::chrono::steady_clock::now();
+  auto const initial_count = allocation_count.load();
+  for (long i = 0; i != iterations; ++i) {
+    // Each iteration simulates a new stream, the parser rejects repeated keys.
+    bigtable::internal::ReadRowsParser parser;
+    if (!response.ParseFromString(data)) {
+      throw std::runtime_error("cannot parse serialized response");
+    }
+    ParseResponse(parser, response, consume);
+  }
+  auto const allocations = allocation_count.load() - initial_count;
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  return AllocationResult{std::move(name), allocations, elapsed};
+}
+
+void MoveChunk(bigtable::internal::ReadRowsParser& parser,
+               btproto::ReadRowsResponse_CellChunk& chunk,
+               grpc::Status& status) {
+  btproto::ReadRowsResponse_CellChunk tmp(std::move(chunk));
+  parser.HandleChunk(tmp, status);
+}
+
+void InPlaceChunk(bigtable::internal::ReadRowsParser& parser,
+                  btproto::ReadRowsResponse_CellChunk& chunk,
+                  grpc::Status& status) {
+  parser.HandleChunk(chunk, status);
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  long iterations = 1000;
+  int rows_per_response = 100;
+  if (argc > 1) {
+    iterations = std::stol(argv[1]);
+  }
+  if (argc > 2) {
+    rows_per_response = std::stoi(argv[2]);
+  }
+  if (iterations <= 0 || rows_per_response <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [iterations] [rows-per-response]"
+              << std::endl;
+    return 1;
+  }
+
+  auto const data = MakeSerializedResponse(rows_per_response);
+  std::vector<AllocationResult> results;
+  {
+    btproto::ReadRowsResponse response;
+    results.push_back(
+        RunStrategy("heap-move", data, iterations, response, MoveChunk));
+  }
+  {
+    btproto::ReadRowsResponse response;
+    results.push_back(
+        RunStrategy("heap-reuse", data, iterations, response, InPlaceChunk));
+  }
+  {
+    google::protobuf::Arena arena;
+    auto& response =
+        *google::protobuf::Arena::CreateMessage<btproto::ReadRowsResponse>(
+            &arena);
+    results.push_back(
+        RunStrategy("arena-reuse", data, iterations, response, InPlaceChunk));
+  }
+
+  std::cout << "# Iterations: " << iterations
+            << ", Rows per Response: " << rows_per_response
+            << ", Response Size: " << data.size() << "\n"
+            << "Strategy,Allocations/Response,Allocations/Row,"
+            << "Time/Response\n";
+  for (auto const& r : results) {
+    std::cout << r.name << "," << r.allocations / iterations << ","
+              << std::fixed << std::setprecision(2)
+              << static_cast<double>(r.allocations) /
+                     (iterations * rows_per_response)
+              << "," << FormatDuration(r.elapsed / iterations) << "\n";
+  }
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
@@ -0,0 +1,143 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/benchmarks/benchmark.h"
+#include "google/cloud/bigtable/row_set.h"
+#include <google/bigtable/v2/bigtable.pb.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ *
+ * Measure the cost of retrying a `ReadRows()` request over a large `RowSet`.
+ *
+ * Each time a scan is retried the readers remove the rows already returned
+ * from the row set and build a new request. This benchmark simulates a scan
+ * over N keys, appended in random order, that is retried at evenly spaced
+ * points. It reports the time for the following scenarios:
+ *
+ * - `intersect-copy`: trim with `RowSet::Intersect()` and copy the set into
+ *   the request, as the readers used to do.
+ * - `remove-swap`: trim with `RowSet::RemoveRowsUpTo()` and swap the set into
+ *   the request and back.
+ * - `split`: split the set into 16 sets for parallel requests.
+ *
+ * Usage: row_set_benchmark [max-key-count] [retry-count]
+ */
+
+/// Helper functions and types for the row_set_benchmark.
+namespace {
+namespace bigtable = google::cloud::bigtable;
+using bigtable::benchmarks::FormatDuration;
+
+std::string MakeKey(long i) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "user%012ld", i);
+  return buf;
+}
+
+bigtable::RowSet MakeRowSet(long key_count) {
+  std::vector<long> ids(key_count);
+  for (long i = 0; i != key_count; ++i) {
+    ids[i] = i;
+  }
+  std::mt19937_64 generator(key_count);
+  std::shuffle(ids.begin(), ids.end(), generator);
+  bigtable::RowSet row_set;
+  for (auto id : ids) {
+    row_set.Append(MakeKey(id));
+  }
+  return row_set;
+}
+
+template <typename Functor>
+std::chrono::nanoseconds TimeIt(Functor&& functor) {
+  auto const start = std::chrono::steady_clock::now();
+  functor();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+void Report(long key_count, char const* scenario, int operations,
+            std::chrono::nanoseconds elapsed) {
+  std::cout << key_count << "," << scenario << "," << operations << ","
+            << FormatDuration(elapsed) << ","
+            << FormatDuration(elapsed / operations) << std::endl;
+}
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) try {
+  long max_key_count = 1000000;
+  int retry_count = 10;
+  if (argc > 1) {
+    max_key_count = std::stol(argv[1]);
+  }
+  if (argc > 2) {
+    retry_count = std::stoi(argv[2]);
+  }
+  if (max_key_count <= 0 || retry_count <= 0) {
+    std::cerr << "Usage: " << argv[0] << " [max-key-count] [retry-count]"
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "Keys,Scenario,Operations,Time,Time/Operation\n";
+  for (long key_count = 1000; key_count <= max_key_count; key_count *= 10) {
+    std::vector<std::string> retry_keys;
+    for (int r = 1; r <= retry_count; ++r) {
+      retry_keys.push_back(MakeKey(key_count * r / (retry_count + 1)));
+    }
+
+    auto row_set = MakeRowSet(key_count);
+    auto elapsed = TimeIt([&] {
+      for (auto const& key : retry_keys) {
+        row_set = row_set.Intersect(bigtable::RowRange::Open(key, ""));
+        google::bigtable::v2::ReadRowsRequest request;
+        auto row_set_proto = row_set.as_proto();
+        request.mutable_rows()->Swap(&row_set_proto);
+      }
+    });
+    Report(key_count, "intersect-copy", retry_count, elapsed);
+
+    row_set = MakeRowSet(key_count);
+    elapsed = TimeIt([&] {
+      for (auto const& key : retry_keys) {
+        row_set.RemoveRowsUpTo(key);
+        google::bigtable::v2::ReadRowsRequest request;
+        bigtable::internal::SwapRowSetProto(row_set, *request.mutable_rows());
+        bigtable::internal::SwapRowSetProto(row_set, *request.mutable_rows());
+      }
+    });
+    Report(key_count, "remove-swap", retry_count, elapsed);
+
+    row_set = MakeRowSet(key_count);
+    std::size_t part_count = 0;
+    elapsed = TimeIt([&] { part_count = row_set.Split(16).size(); });
+    Report(key_count, "split", 1, elapsed);
+    if (part_count != 16) {
+      std::cerr << "Unexpected number of parts: " << part_count << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+} catch (std::exception const& ex) {
+  std::cerr << "Standard exception raised: " << ex.what() << std::endl;
+  return 1;
+}
@@ -74,10 +74,14 @@ BenchmarkSetup::BenchmarkSetup(std::string const& prefix, int& argc,
               << " [thread-count (" << kDefaultThreads << ")]"
               << " [test-duration-seconds (" << kDefaultTestDuration << "min)]"
               << " [table-size (" << kDefaultTableSize << ")]"
-              << " [use-embedded-server (false)]" << std::endl;
+              << " [use-embedded-server (false|true|emulator)]"
+              << " [--emulator-latency-us=N] [--emulator-bandwidth-mbps=N]"
+              << " [--emulator-error-rate=P] [--emulator-seed=N]" << std::endl;
     google::cloud::internal::ThrowRuntimeError(msg);
   };
 
+  emulator_options_ = ParseEmulatorOptions(argc, argv);
+
   if (argc < 4) {
     usage("too few arguments for program.");
   }
@@ -123,7 +127,8 @@ BenchmarkSetup::BenchmarkSetup(std::string const& prefix, int& argc,
   std::string value = shift();
   std::transform(value.begin(), value.end(), value.begin(),
                  [](char x) { return std::tolower(x); });
-  use_embedded_server_ = value == "true";
+  use_emulator_ = value == "emulator";
+  use_embedded_server_ = value == "true" || use_emulator_;
 }
 
 }  // namespace benchmarks
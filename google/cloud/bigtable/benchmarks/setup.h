@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BENCHMARKS_SETUP_H_
 
 #include "google/cloud/bigtable/benchmarks/constants.h"
+#include "google/cloud/bigtable/benchmarks/data_emulator.h"
 #include <chrono>
 #include <string>
 #include <vector>
@@ -46,6 +47,9 @@ class BenchmarkSetup {
   int thread_count() const { return thread_count_; }
   std::chrono::seconds test_duration() const { return test_duration_; }
   bool use_embedded_server() const { return use_embedded_server_; }
+  /// If true, the embedded server is the in-memory data emulator.
+  bool use_emulator() const { return use_emulator_; }
+  EmulatorOptions const& emulator_options() const { return emulator_options_; }
 
  private:
   std::string start_time_;
@@ -59,6 +63,8 @@ class BenchmarkSetup {
   std::chrono::seconds test_duration_ =
       std::chrono::seconds(kDefaultTestDuration * 60);
   bool use_embedded_server_ = false;
+  bool use_emulator_ = false;
+  EmulatorOptions emulator_options_;
 };
 
 }  // namespace benchmarks
@@ -153,3 +153,28 @@ TEST(BenchmarkSetup, TableSize) {
   // TableSize parameter should be >= 100.
   EXPECT_THROW(BenchmarkSetup("table-size", argc, argv), std::exception);
 }
+
+TEST(BenchmarkSetup, Emulator) {
+  char emulator[] = "emulator";
+  char latency[] = "--emulator-latency-us=250";
+  char error_rate[] = "--emulator-error-rate=0.25";
+  char seed[] = "--emulator-seed=42";
+  char* argv[] = {arg0, latency, arg1, arg2,     arg3, arg4,
+                  arg5, arg6,    seed, emulator, error_rate};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  BenchmarkSetup setup("emulator", argc, argv);
+
+  EXPECT_EQ(1, argc);
+  EXPECT_TRUE(setup.use_embedded_server());
+  EXPECT_TRUE(setup.use_emulator());
+  EXPECT_EQ(250, setup.emulator_options().latency.count());
+  EXPECT_DOUBLE_EQ(0.25, setup.emulator_options().error_rate);
+  EXPECT_EQ(42U, setup.emulator_options().seed);
+}
+
+TEST(BenchmarkSetup, EmulatorInvalidErrorRate) {
+  char error_rate[] = "--emulator-error-rate=2";
+  char* argv[] = {arg0, arg1, arg2, arg3, error_rate};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  EXPECT_THROW(BenchmarkSetup("emulator", argc, argv), std::exception);
+}
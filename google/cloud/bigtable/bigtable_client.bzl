@@ -20,16 +20,23 @@ bigtable_client_hdrs = [
     "admin_client.h",
     "app_profile_config.h",
     "async_operation.h",
+    "async_row_stream.h",
     "bigtable_strong_types.h",
+    "bulk_apply_options.h",
+    "bulk_loader.h",
     "cell.h",
     "client_options.h",
     "cluster_config.h",
     "cluster_list_responses.h",
     "column_family.h",
+    "columnar_batch.h",
+    "columnar_reader.h",
     "completion_queue.h",
+    "counter_aggregator.h",
     "data_client.h",
     "filters.h",
     "grpc_error.h",
+    "hedging_policy.h",
     "instance_admin_client.h",
     "instance_admin.h",
     "instance_config.h",
@@ -38,6 +45,7 @@ bigtable_client_hdrs = [
     "internal/async_bulk_apply.h",
     "internal/async_check_consistency.h",
     "internal/async_future_from_callback.h",
+    "internal/async_hedged_read_row.h",
     "internal/async_list_app_profiles.h",
     "internal/async_list_clusters.h",
     "internal/async_list_instances.h",
@@ -52,7 +60,9 @@ bigtable_client_hdrs = [
     "internal/async_retry_unary_rpc.h",
     "internal/async_retry_unary_rpc_and_poll.h",
     "internal/async_row_reader.h",
+    "internal/async_row_stream_impl.h",
     "internal/bulk_mutator.h",
+    "internal/columnar_parser.h",
     "internal/completion_queue_impl.h",
     "internal/common_client.h",
     "internal/conjunction.h",
@@ -63,9 +73,11 @@ bigtable_client_hdrs = [
     "internal/poll_longrunning_operation.h",
     "internal/prefix_range_end.h",
     "internal/readrowsparser.h",
+    "internal/record_parser.h",
     "internal/rpc_policy_parameters.inc",
     "internal/rpc_policy_parameters.h",
     "internal/rowreaderiterator.h",
+    "internal/sorted_row_file.h",
     "internal/strong_type.h",
     "internal/table.h",
     "internal/table_admin.h",
@@ -74,17 +86,22 @@ bigtable_client_hdrs = [
     "mutations.h",
     "polling_policy.h",
     "read_modify_write_rule.h",
+    "read_row_coalescer.h",
     "row.h",
+    "row_cache.h",
     "row_key_sample.h",
     "row_range.h",
     "row_reader.h",
     "row_set.h",
     "rpc_backoff_policy.h",
     "rpc_retry_policy.h",
+    "retry_budget.h",
+    "circuit_breaker.h",
     "metadata_update_policy.h",
     "table.h",
     "table_admin.h",
     "table_config.h",
+    "table_export.h",
     "table_strong_types.h",
     "version.h",
 ]
@@ -92,17 +109,22 @@ bigtable_client_hdrs = [
 bigtable_client_srcs = [
     "admin_client.cc",
     "app_profile_config.cc",
+    "bulk_loader.cc",
     "client_options.cc",
     "cluster_config.cc",
+    "columnar_reader.cc",
     "completion_queue.cc",
+    "counter_aggregator.cc",
     "data_client.cc",
     "grpc_error.cc",
     "instance_admin_client.cc",
     "instance_admin.cc",
     "instance_config.cc",
     "instance_update_config.cc",
+    "internal/async_row_stream_impl.cc",
     "internal/async_sample_row_keys.cc",
     "internal/bulk_mutator.cc",
+    "internal/columnar_parser.cc",
     "internal/completion_queue_impl.cc",
     "internal/common_client.cc",
     "internal/endian.cc",
@@ -110,20 +132,27 @@ bigtable_client_srcs = [
     "internal/instance_admin.cc",
     "internal/prefix_range_end.cc",
     "internal/readrowsparser.cc",
+    "internal/record_parser.cc",
     "internal/rowreaderiterator.cc",
+    "internal/sorted_row_file.cc",
     "internal/table.cc",
     "internal/table_admin.cc",
     "idempotent_mutation_policy.cc",
     "mutations.cc",
     "polling_policy.cc",
+    "read_row_coalescer.cc",
+    "row_cache.cc",
     "row_range.cc",
     "row_reader.cc",
     "row_set.cc",
     "rpc_backoff_policy.cc",
     "rpc_retry_policy.cc",
+    "retry_budget.cc",
+    "circuit_breaker.cc",
     "metadata_update_policy.cc",
     "table.cc",
     "table_admin.cc",
     "table_config.cc",
+    "table_export.cc",
     "version.cc",
 ]
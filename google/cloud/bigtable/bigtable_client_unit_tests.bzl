@@ -20,11 +20,13 @@ bigtable_client_unit_tests = [
     "admin_client_test.cc",
     "app_profile_config_test.cc",
     "bigtable_version_test.cc",
+    "bulk_loader_test.cc",
     "cell_test.cc",
     "client_options_test.cc",
     "cluster_config_test.cc",
     "column_family_test.cc",
     "completion_queue_test.cc",
+    "counter_aggregator_test.cc",
     "data_client_test.cc",
     "filters_test.cc",
     "force_sanitizer_failures_test.cc",
@@ -36,6 +38,7 @@ bigtable_client_unit_tests = [
     "instance_update_config_test.cc",
     "internal/async_check_consistency_test.cc",
     "internal/async_future_from_callback_test.cc",
+    "internal/async_hedged_read_row_test.cc",
     "internal/async_list_app_profiles_test.cc",
     "internal/async_list_clusters_test.cc",
     "internal/async_list_instances_test.cc",
@@ -45,10 +48,13 @@ bigtable_client_unit_tests = [
     "internal/async_retry_op_test.cc",
     "internal/async_retry_unary_rpc_and_poll_test.cc",
     "internal/bulk_mutator_test.cc",
+    "internal/columnar_parser_test.cc",
     "internal/table_async_check_and_mutate_row_test.cc",
     "internal/instance_admin_test.cc",
     "internal/grpc_error_delegate_test.cc",
     "internal/prefix_range_end_test.cc",
+    "internal/record_parser_test.cc",
+    "internal/sorted_row_file_test.cc",
     "internal/table_admin_test.cc",
     "internal/table_async_apply_test.cc",
     "internal/table_async_bulk_apply_test.cc",
@@ -61,12 +67,16 @@ bigtable_client_unit_tests = [
     "table_bulk_apply_test.cc",
     "table_check_and_mutate_row_test.cc",
     "table_config_test.cc",
+    "table_export_test.cc",
+    "table_readcolumns_test.cc",
     "table_readrow_test.cc",
     "table_readrows_test.cc",
     "table_sample_row_keys_test.cc",
     "table_test.cc",
     "table_readmodifywriterow_test.cc",
     "read_modify_write_rule_test.cc",
+    "read_row_coalescer_test.cc",
+    "row_cache_test.cc",
     "row_reader_test.cc",
     "row_test.cc",
     "row_range_test.cc",
@@ -74,5 +84,7 @@ bigtable_client_unit_tests = [
     "rpc_backoff_policy_test.cc",
     "metadata_update_policy_test.cc",
     "rpc_retry_policy_test.cc",
+    "retry_budget_test.cc",
+    "circuit_breaker_test.cc",
     "polling_policy_test.cc",
 ]
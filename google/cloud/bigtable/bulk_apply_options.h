@@ -0,0 +1,121 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_APPLY_OPTIONS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_APPLY_OPTIONS_H_
+
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <cstddef>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Control how `Table::BulkApply()` splits large `BulkMutation` objects.
+ *
+ * Cloud Bigtable limits the number of mutations in a single `MutateRows`
+ * request. `Table::BulkApply()` and `Table::AsyncBulkApply()` split any
+ * `BulkMutation` exceeding the limits in this class into several requests,
+ * and send up to `max_concurrent_requests()` of these requests at the same
+ * time. Because `DataClient` rotates over its channels for each request, the
+ * concurrent requests are spread over all the channels in the client.
+ *
+ * The failures are always reported using the index of the mutation in the
+ * original `BulkMutation`.
+ *
+ * The default values match the limits enforced by the service, and send up to
+ * 4 requests at a time.
+ */
+class BulkApplyOptions {
+ public:
+  BulkApplyOptions()
+      : max_entries_per_request_(100000),
+        max_mutations_per_request_(100000),
+        max_bytes_per_request_(128 * 1024 * 1024),
+        max_concurrent_requests_(4) {}
+
+  /// Set the maximum number of rows in each request.
+  BulkApplyOptions& set_max_entries_per_request(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkApplyOptions::set_max_entries_per_request requires v > 0");
+    }
+    max_entries_per_request_ = v;
+    return *this;
+  }
+  std::size_t max_entries_per_request() const {
+    return max_entries_per_request_;
+  }
+
+  /**
+   * Set the maximum number of mutations in each request.
+   *
+   * A row with more mutations than this limit is sent in a request of its own.
+   */
+  BulkApplyOptions& set_max_mutations_per_request(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkApplyOptions::set_max_mutations_per_request requires v > 0");
+    }
+    max_mutations_per_request_ = v;
+    return *this;
+  }
+  std::size_t max_mutations_per_request() const {
+    return max_mutations_per_request_;
+  }
+
+  /**
+   * Set the maximum size, in serialized bytes, of the mutations in each
+   * request.
+   *
+   * A row larger than this limit is sent in a request of its own.
+   */
+  BulkApplyOptions& set_max_bytes_per_request(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkApplyOptions::set_max_bytes_per_request requires v > 0");
+    }
+    max_bytes_per_request_ = v;
+    return *this;
+  }
+  std::size_t max_bytes_per_request() const { return max_bytes_per_request_; }
+
+  /// Set the maximum number of requests sent at the same time.
+  BulkApplyOptions& set_max_concurrent_requests(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkApplyOptions::set_max_concurrent_requests requires v > 0");
+    }
+    max_concurrent_requests_ = v;
+    return *this;
+  }
+  std::size_t max_concurrent_requests() const {
+    return max_concurrent_requests_;
+  }
+
+ private:
+  std::size_t max_entries_per_request_;
+  std::size_t max_mutations_per_request_;
+  std::size_t max_bytes_per_request_;
+  std::size_t max_concurrent_requests_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_APPLY_OPTIONS_H_
@@ -0,0 +1,212 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/bulk_loader.h"
+#include "google/cloud/bigtable/internal/record_parser.h"
+#include <algorithm>
+#include <iterator>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+std::vector<std::string> ParseCsvRecord(std::string const& record,
+                                        char separator) {
+  return internal::ParseCsvRecord(record, separator);
+}
+
+BulkLoader::BulkLoader(Table const& table, CompletionQueue cq,
+                       BulkLoaderMapper mapper, BulkLoaderOptions options)
+    : table_(table.impl_),
+      cq_(std::move(cq)),
+      mapper_(std::move(mapper)),
+      options_(std::move(options)),
+      start_(std::chrono::steady_clock::now()),
+      inflight_bytes_(0),
+      shutdown_(false),
+      finished_(false),
+      row_count_(0),
+      byte_count_(0),
+      skipped_count_(0) {
+  workers_.reserve(options_.parser_thread_count());
+  for (std::size_t i = 0; i != options_.parser_thread_count(); ++i) {
+    workers_.emplace_back(&BulkLoader::WorkerLoop, this);
+  }
+}
+
+BulkLoader::~BulkLoader() {
+  try {
+    Finish();
+  } catch (...) {
+    // The application did not call Finish(), there is nobody to report the
+    // mapper errors to.
+  }
+}
+
+void BulkLoader::AddChunk(std::string chunk) {
+  if (chunk.empty()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lk(mu_);
+  if (shutdown_) {
+    google::cloud::internal::ThrowLogicError(
+        "BulkLoader::AddChunk() called after Finish()");
+  }
+  budget_cv_.wait(lk, [this, &chunk] {
+    return inflight_bytes_ == 0 ||
+           inflight_bytes_ + chunk.size() <= options_.max_inflight_bytes();
+  });
+  inflight_bytes_ += chunk.size();
+  chunks_.push_back(std::move(chunk));
+  lk.unlock();
+  work_cv_.notify_one();
+}
+
+std::vector<FailedMutation> BulkLoader::Finish() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!shutdown_) {
+    shutdown_ = true;
+    lk.unlock();
+    work_cv_.notify_all();
+    for (auto& t : workers_) {
+      t.join();
+    }
+    lk.lock();
+    // The workers have sent all the chunks, wait for the last requests.
+    budget_cv_.wait(lk, [this] { return inflight_bytes_ == 0; });
+    finished_ = true;
+    finish_time_ = std::chrono::steady_clock::now();
+  }
+  if (mapper_error_) {
+    auto error = mapper_error_;
+    mapper_error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+  std::vector<FailedMutation> result;
+  result.swap(failures_);
+  return result;
+}
+
+double BulkLoader::rows_per_second() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return Rate(row_count_);
+}
+
+double BulkLoader::bytes_per_second() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return Rate(byte_count_);
+}
+
+double BulkLoader::Rate(std::int64_t count) const {
+  auto const end = finished_ ? finish_time_ : std::chrono::steady_clock::now();
+  auto const elapsed = std::chrono::duration<double>(end - start_).count();
+  if (elapsed <= 0) {
+    return 0;
+  }
+  return static_cast<double>(count) / elapsed;
+}
+
+void BulkLoader::WorkerLoop() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    work_cv_.wait(lk, [this] { return shutdown_ || !chunks_.empty(); });
+    if (chunks_.empty()) {
+      return;
+    }
+    auto chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    lk.unlock();
+    ParseChunk(chunk);
+    lk.lock();
+  }
+}
+
+void BulkLoader::ParseChunk(std::string const& chunk) {
+  bool const is_csv = options_.format() == BulkLoaderOptions::Format::kCsv;
+  // Each batch releases the input bytes of its records when it completes, the
+  // last batch also releases the bytes of any skipped records.
+  std::size_t unassigned_bytes = chunk.size();
+  std::size_t batch_bytes = 0;
+  std::size_t batch_rows = 0;
+  std::int64_t skipped = 0;
+  BulkMutation batch;
+  for (auto& record : internal::SplitRecords(chunk, is_csv)) {
+    // Count the terminator too, the last record may not have one.
+    batch_bytes = (std::min)(batch_bytes + record.size() + 1, unassigned_bytes);
+    std::vector<std::string> fields;
+    if (is_csv) {
+      fields = internal::ParseCsvRecord(record, options_.separator());
+    } else {
+      fields.push_back(std::move(record));
+    }
+    optional<SingleRowMutation> mutation;
+    try {
+      mutation = mapper_(fields);
+    } catch (...) {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (!mapper_error_) {
+        mapper_error_ = std::current_exception();
+      }
+    }
+    if (!mutation) {
+      ++skipped;
+      continue;
+    }
+    batch.emplace_back(std::move(*mutation));
+    if (++batch_rows == options_.max_rows_per_request()) {
+      unassigned_bytes -= batch_bytes;
+      SendBatch(std::move(batch), batch_rows, batch_bytes);
+      batch = BulkMutation();
+      batch_rows = 0;
+      batch_bytes = 0;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    skipped_count_ += skipped;
+  }
+  SendBatch(std::move(batch), batch_rows, unassigned_bytes);
+}
+
+void BulkLoader::SendBatch(BulkMutation batch, std::size_t rows,
+                           std::size_t bytes) {
+  if (rows == 0) {
+    std::vector<FailedMutation> failed;
+    OnBatchComplete(0, bytes, failed);
+    return;
+  }
+  table_.AsyncBulkApply(
+      cq_,
+      [this, rows, bytes](CompletionQueue&, std::vector<FailedMutation>& failed,
+                          grpc::Status&) {
+        OnBatchComplete(rows, bytes, failed);
+      },
+      std::move(batch));
+}
+
+void BulkLoader::OnBatchComplete(std::size_t rows, std::size_t bytes,
+                                 std::vector<FailedMutation>& failed) {
+  std::unique_lock<std::mutex> lk(mu_);
+  row_count_ += static_cast<std::int64_t>(rows - failed.size());
+  byte_count_ += static_cast<std::int64_t>(bytes);
+  inflight_bytes_ -= bytes;
+  std::move(failed.begin(), failed.end(), std::back_inserter(failures_));
+  lk.unlock();
+  budget_cv_.notify_all();
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
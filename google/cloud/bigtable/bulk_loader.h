@@ -0,0 +1,275 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_LOADER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_LOADER_H_
+
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/optional.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Control how `BulkLoader` parses its input and how much data it buffers.
+ */
+class BulkLoaderOptions {
+ public:
+  /// The format of the records passed to `BulkLoader::AddChunk()`.
+  enum class Format {
+    /// Comma separated values, as described in RFC 4180.
+    kCsv,
+    /// One record per line, the mapper receives each line as a single field.
+    kNewlineDelimited,
+  };
+
+  BulkLoaderOptions()
+      : format_(Format::kCsv),
+        separator_(','),
+        max_inflight_bytes_(64 * 1024 * 1024),
+        parser_thread_count_(4),
+        max_rows_per_request_(1000) {}
+
+  BulkLoaderOptions& set_format(Format v) {
+    format_ = v;
+    return *this;
+  }
+  Format format() const { return format_; }
+
+  /// Set the character separating fields in `Format::kCsv` records.
+  BulkLoaderOptions& set_separator(char v) {
+    separator_ = v;
+    return *this;
+  }
+  char separator() const { return separator_; }
+
+  /**
+   * Set the maximum number of input bytes parsed or being applied.
+   *
+   * `BulkLoader::AddChunk()` blocks while this limit is exceeded. A chunk
+   * larger than the limit is accepted when nothing else is in flight.
+   */
+  BulkLoaderOptions& set_max_inflight_bytes(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkLoaderOptions::set_max_inflight_bytes requires v > 0");
+    }
+    max_inflight_bytes_ = v;
+    return *this;
+  }
+  std::size_t max_inflight_bytes() const { return max_inflight_bytes_; }
+
+  /// Set the number of threads parsing chunks and creating mutations.
+  BulkLoaderOptions& set_parser_thread_count(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkLoaderOptions::set_parser_thread_count requires v > 0");
+    }
+    parser_thread_count_ = v;
+    return *this;
+  }
+  std::size_t parser_thread_count() const { return parser_thread_count_; }
+
+  /// Set the maximum number of rows in each `AsyncBulkApply()` request.
+  BulkLoaderOptions& set_max_rows_per_request(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "BulkLoaderOptions::set_max_rows_per_request requires v > 0");
+    }
+    max_rows_per_request_ = v;
+    return *this;
+  }
+  std::size_t max_rows_per_request() const { return max_rows_per_request_; }
+
+ private:
+  Format format_;
+  char separator_;
+  std::size_t max_inflight_bytes_;
+  std::size_t parser_thread_count_;
+  std::size_t max_rows_per_request_;
+};
+
+/**
+ * Convert the fields of a record into a mutation.
+ *
+ * Return an empty optional to skip the record, for example, a CSV header. The
+ * mapper is called from several threads at the same time.
+ */
+using BulkLoaderMapper = std::function<optional<SingleRowMutation>(
+    std::vector<std::string> const& fields)>;
+
+/**
+ * Split a CSV record into fields, using the same rules as `BulkLoader`.
+ *
+ * Applications can use this function to parse header lines, or other records
+ * they need to process before the load starts.
+ */
+std::vector<std::string> ParseCsvRecord(std::string const& record,
+                                        char separator = ',');
+
+/**
+ * Load large amounts of text records into a table.
+ *
+ * The application passes chunks of text, each containing complete records,
+ * from as many threads as it wants, for example, one thread for each file or
+ * byte range being read. A pool of threads owned by this object parses the
+ * chunks, converts each record into a `SingleRowMutation` using the mapper,
+ * and sends the mutations using `AsyncBulkApply()`.
+ *
+ * The memory used by the loader is bounded: `AddChunk()` blocks while the
+ * chunks being parsed or applied exceed `max_inflight_bytes()`, so readers
+ * never get too far ahead of the service.
+ *
+ * @par Example
+ * @code
+ * bigtable::CompletionQueue cq;
+ * std::thread t([&cq] { cq.Run(); });
+ * using MaybeMutation = google::cloud::optional<bigtable::SingleRowMutation>;
+ * bigtable::BulkLoader loader(
+ *     table, cq, [](std::vector<std::string> const& fields) {
+ *       return MaybeMutation(bigtable::SingleRowMutation(
+ *           fields.at(0), bigtable::SetCell("fam", "c0", fields.at(1))));
+ *     });
+ * for (auto& chunk : chunks) loader.AddChunk(std::move(chunk));
+ * auto failures = loader.Finish();
+ * std::cout << loader.rows_per_second() << " rows/s\n";
+ * @endcode
+ *
+ * @par Thread-safety
+ * `AddChunk()` and the accessors are thread-safe. `Finish()` must be called
+ * after all the calls to `AddChunk()` have returned.
+ */
+class BulkLoader {
+ public:
+  /**
+   * Create a loader for @p table.
+   *
+   * @param table the table to load. The loader uses a copy of this object,
+   *     including its retry, backoff, and `BulkApplyOptions` policies.
+   * @param cq the completion queue used for the `AsyncBulkApply()` requests,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()` until the loader is destroyed.
+   * @param mapper converts each record to a mutation.
+   * @param options how to parse the records and how much data to buffer.
+   */
+  BulkLoader(Table const& table, CompletionQueue cq, BulkLoaderMapper mapper,
+             BulkLoaderOptions options = BulkLoaderOptions());
+
+  BulkLoader(BulkLoader const&) = delete;
+  BulkLoader& operator=(BulkLoader const&) = delete;
+
+  /// Apply all the pending chunks and wait for the requests to complete.
+  ~BulkLoader();
+
+  /**
+   * Parse and apply a chunk of records.
+   *
+   * The chunk must contain complete records, records are never split across
+   * chunks. This function blocks while the loader is at its in-flight limit.
+   */
+  void AddChunk(std::string chunk);
+
+  /**
+   * Wait until all the chunks are applied.
+   *
+   * @return the mutations that could not be applied. Their
+   *     `original_index()` is relative to the request that contained them, use
+   *     the row key to identify them.
+   * @throws the first exception raised by the mapper, if any.
+   */
+  std::vector<FailedMutation> Finish();
+
+  /// The number of rows successfully applied.
+  std::int64_t row_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return row_count_;
+  }
+
+  /// The number of input bytes completely applied.
+  std::int64_t byte_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return byte_count_;
+  }
+
+  /// The number of records skipped by the mapper.
+  std::int64_t skipped_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return skipped_count_;
+  }
+
+  /// The number of input bytes parsed, or being applied.
+  std::size_t inflight_bytes() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return inflight_bytes_;
+  }
+
+  /// The rate at which rows were applied, since the loader was created.
+  double rows_per_second() const;
+
+  /// The rate at which input bytes were applied, since the loader was created.
+  double bytes_per_second() const;
+
+ private:
+  void WorkerLoop();
+  void ParseChunk(std::string const& chunk);
+  void SendBatch(BulkMutation batch, std::size_t rows, std::size_t bytes);
+  void OnBatchComplete(std::size_t rows, std::size_t bytes,
+                       std::vector<FailedMutation>& failed);
+  double Rate(std::int64_t count) const;
+
+  noex::Table table_;
+  CompletionQueue cq_;
+  BulkLoaderMapper mapper_;
+  BulkLoaderOptions const options_;
+  std::chrono::steady_clock::time_point const start_;
+
+  mutable std::mutex mu_;
+  /// Signaled when chunks are added, or the loader is finishing.
+  std::condition_variable work_cv_;
+  /// Signaled when in-flight bytes are released.
+  std::condition_variable budget_cv_;
+  std::deque<std::string> chunks_;
+  std::size_t inflight_bytes_;
+  bool shutdown_;
+  bool finished_;
+  std::chrono::steady_clock::time_point finish_time_;
+  std::int64_t row_count_;
+  std::int64_t byte_count_;
+  std::int64_t skipped_count_;
+  std::vector<FailedMutation> failures_;
+  std::exception_ptr mapper_error_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_BULK_LOADER_H_
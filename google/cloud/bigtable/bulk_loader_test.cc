@@ -0,0 +1,196 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/bulk_loader.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/mock_mutate_rows_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/internal/make_unique.h"
+#include <gmock/gmock.h>
+#include <future>
+#include <thread>
+
+namespace btproto = ::google::bigtable::v2;
+namespace bigtable = google::cloud::bigtable;
+using namespace ::testing;
+using bigtable::testing::MockClientAsyncReaderInterface;
+using MaybeMutation = google::cloud::optional<bigtable::SingleRowMutation>;
+
+namespace {
+class BulkLoaderTest : public bigtable::testing::TableTestFixture {
+ protected:
+  BulkLoaderTest()
+      : impl_(std::make_shared<bigtable::testing::MockCompletionQueue>()),
+        cq_(impl_) {}
+
+  /// Expect @p count requests, reporting @p code for each of their entries.
+  void ExpectRequests(int count, grpc::StatusCode code) {
+    EXPECT_CALL(*client_, AsyncMutateRows(_, _, _, _))
+        .Times(count)
+        .WillRepeatedly(Invoke([this, code](grpc::ClientContext*,
+                                            btproto::MutateRowsRequest const& r,
+                                            grpc::CompletionQueue*, void*) {
+          std::lock_guard<std::mutex> lk(mu_);
+          for (auto const& e : r.entries()) {
+            row_keys_.push_back(e.row_key());
+          }
+          return MakeReader(r.entries_size(), code);
+        }));
+  }
+
+  static std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<btproto::MutateRowsResponse>>
+  MakeReader(int count, grpc::StatusCode code) {
+    auto reader = google::cloud::internal::make_unique<
+        MockClientAsyncReaderInterface<btproto::MutateRowsResponse>>();
+    EXPECT_CALL(*reader, Read(_, _))
+        .WillOnce(Invoke([count, code](btproto::MutateRowsResponse* r, void*) {
+          for (int i = 0; i != count; ++i) {
+            auto& e = *r->add_entries();
+            e.set_index(i);
+            e.mutable_status()->set_code(code);
+          }
+        }))
+        .WillOnce(Invoke([](btproto::MutateRowsResponse*, void*) {}));
+    EXPECT_CALL(*reader, Finish(_, _))
+        .WillOnce(Invoke([](grpc::Status* status, void*) {
+          *status = grpc::Status::OK;
+        }));
+    return std::move(reader);
+  }
+
+  /// Wait until @p count requests are started, then complete them.
+  void CompleteRequests(std::size_t count) {
+    while (impl_->size() < count) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Start, read the response, end of stream, and finish.
+    impl_->SimulateCompletion(cq_, true);
+    impl_->SimulateCompletion(cq_, true);
+    impl_->SimulateCompletion(cq_, false);
+    impl_->SimulateCompletion(cq_, false);
+  }
+
+  static MaybeMutation Mapper(std::vector<std::string> const& fields) {
+    if (fields.at(0) == "key") {
+      return MaybeMutation();
+    }
+    return MaybeMutation(bigtable::SingleRowMutation(
+        fields.at(0), bigtable::SetCell("fam", "col", fields.at(1))));
+  }
+
+  std::shared_ptr<bigtable::testing::MockCompletionQueue> impl_;
+  bigtable::CompletionQueue cq_;
+  std::mutex mu_;
+  std::vector<std::string> row_keys_;
+};
+}  // anonymous namespace
+
+/// @test Verify that records are parsed, mapped, and applied in batches.
+TEST_F(BulkLoaderTest, LoadsRecords) {
+  ExpectRequests(2, grpc::StatusCode::OK);
+  std::string const chunk = "key,value\nr1,v1\n\"r,2\",v2\nr3,v3\n";
+
+  bigtable::BulkLoader loader(table_, cq_, &BulkLoaderTest::Mapper,
+                              bigtable::BulkLoaderOptions()
+                                  .set_parser_thread_count(1)
+                                  .set_max_rows_per_request(2));
+  loader.AddChunk(chunk);
+  CompleteRequests(2);
+  auto failures = loader.Finish();
+
+  EXPECT_TRUE(failures.empty());
+  EXPECT_THAT(row_keys_, UnorderedElementsAre("r1", "r,2", "r3"));
+  EXPECT_EQ(3, loader.row_count());
+  EXPECT_EQ(1, loader.skipped_count());
+  EXPECT_EQ(static_cast<std::int64_t>(chunk.size()), loader.byte_count());
+  EXPECT_EQ(0U, loader.inflight_bytes());
+  EXPECT_LT(0.0, loader.rows_per_second());
+  EXPECT_LT(0.0, loader.bytes_per_second());
+}
+
+/// @test Verify that newline-delimited records are passed as a single field.
+TEST_F(BulkLoaderTest, NewlineDelimited) {
+  ExpectRequests(1, grpc::StatusCode::OK);
+  std::vector<std::string> records;
+  std::mutex mu;
+  bigtable::BulkLoader loader(
+      table_, cq_,
+      [&records, &mu](std::vector<std::string> const& fields) {
+        std::lock_guard<std::mutex> lk(mu);
+        records.insert(records.end(), fields.begin(), fields.end());
+        return MaybeMutation(bigtable::SingleRowMutation(
+            fields.at(0), bigtable::SetCell("fam", "col", "v")));
+      },
+      bigtable::BulkLoaderOptions().set_format(
+          bigtable::BulkLoaderOptions::Format::kNewlineDelimited));
+  loader.AddChunk("{\"a\": 1, \"b\": 2}\n{\"a\": 3}\n");
+  CompleteRequests(1);
+  loader.Finish();
+  EXPECT_THAT(records, ElementsAre("{\"a\": 1, \"b\": 2}", "{\"a\": 3}"));
+}
+
+/// @test Verify that mutations rejected by the service are returned.
+TEST_F(BulkLoaderTest, ReportsFailures) {
+  ExpectRequests(1, grpc::StatusCode::PERMISSION_DENIED);
+  bigtable::BulkLoader loader(
+      table_, cq_, &BulkLoaderTest::Mapper,
+      bigtable::BulkLoaderOptions().set_parser_thread_count(1));
+  loader.AddChunk("r1,v1\nr2,v2\n");
+  CompleteRequests(1);
+  auto failures = loader.Finish();
+
+  ASSERT_EQ(2U, failures.size());
+  EXPECT_EQ(grpc::StatusCode::PERMISSION_DENIED,
+            failures[0].status().error_code());
+  EXPECT_EQ(0, loader.row_count());
+  EXPECT_EQ(0U, loader.inflight_bytes());
+}
+
+/// @test Verify that AddChunk() blocks while the loader is at its limit.
+TEST_F(BulkLoaderTest, BoundedInflightBytes) {
+  ExpectRequests(2, grpc::StatusCode::OK);
+  bigtable::BulkLoader loader(table_, cq_, &BulkLoaderTest::Mapper,
+                              bigtable::BulkLoaderOptions()
+                                  .set_parser_thread_count(1)
+                                  .set_max_inflight_bytes(8));
+  loader.AddChunk("r1,v1\n");
+  EXPECT_EQ(6U, loader.inflight_bytes());
+
+  auto second = std::async(std::launch::async,
+                           [&loader] { loader.AddChunk("r2,v2\n"); });
+  EXPECT_EQ(std::future_status::timeout,
+            second.wait_for(std::chrono::milliseconds(50)));
+
+  CompleteRequests(1);
+  second.get();
+  CompleteRequests(1);
+  loader.Finish();
+  EXPECT_EQ(2, loader.row_count());
+  EXPECT_EQ(12, loader.byte_count());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that exceptions raised by the mapper are reported.
+TEST_F(BulkLoaderTest, MapperError) {
+  EXPECT_CALL(*client_, AsyncMutateRows(_, _, _, _)).Times(0);
+  bigtable::BulkLoader loader(
+      table_, cq_, [](std::vector<std::string> const&) -> MaybeMutation {
+        throw std::runtime_error("bad record");
+      });
+  loader.AddChunk("r1,v1\n");
+  EXPECT_THROW(loader.Finish(), std::runtime_error);
+  EXPECT_THROW(loader.AddChunk("r2,v2\n"), std::logic_error);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
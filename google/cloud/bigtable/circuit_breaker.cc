@@ -0,0 +1,162 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/circuit_breaker.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+CircuitBreaker::CircuitBreaker(int failure_threshold,
+                               std::chrono::milliseconds open_duration,
+                               int half_open_probes)
+    : failure_threshold_(std::max(failure_threshold, 1)),
+      open_duration_(open_duration),
+      half_open_probes_(std::max(half_open_probes, 1)),
+      state_(State::kClosed),
+      consecutive_failures_(0),
+      probes_(0),
+      rejected_count_(0),
+      open_count_(0) {}
+
+bool CircuitBreaker::AllowRequest(Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (state_ == State::kOpen && now >= open_until_) {
+    state_ = State::kHalfOpen;
+    probes_ = 0;
+  }
+  switch (state_) {
+    case State::kClosed:
+      return true;
+    case State::kHalfOpen:
+      if (probes_ < half_open_probes_) {
+        ++probes_;
+        return true;
+      }
+      break;
+    case State::kOpen:
+      break;
+  }
+  ++rejected_count_;
+  return false;
+}
+
+void CircuitBreaker::OnSuccess() {
+  std::lock_guard<std::mutex> lk(mu_);
+  consecutive_failures_ = 0;
+  if (state_ == State::kHalfOpen) {
+    state_ = State::kClosed;
+  }
+}
+
+void CircuitBreaker::OnFailure(Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  switch (state_) {
+    case State::kClosed:
+      if (++consecutive_failures_ >= failure_threshold_) {
+        Open(now);
+      }
+      break;
+    case State::kHalfOpen:
+      Open(now);
+      break;
+    case State::kOpen:
+      // Requests sent before the breaker opened, nothing new to learn.
+      break;
+  }
+}
+
+CircuitBreaker::State CircuitBreaker::state() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return state_;
+}
+
+std::uint64_t CircuitBreaker::rejected_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return rejected_count_;
+}
+
+std::uint64_t CircuitBreaker::open_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return open_count_;
+}
+
+void CircuitBreaker::Open(Clock::time_point now) {
+  state_ = State::kOpen;
+  open_until_ = now + open_duration_;
+  consecutive_failures_ = 0;
+  ++open_count_;
+}
+
+CircuitBreakerRetryPolicy::CircuitBreakerRetryPolicy(
+    RPCRetryPolicy const& policy, std::shared_ptr<CircuitBreaker> breaker)
+    : policy_(policy.clone()),
+      breaker_(std::move(breaker)),
+      attempt_pending_(false),
+      attempt_rejected_(false) {}
+
+CircuitBreakerRetryPolicy::~CircuitBreakerRetryPolicy() {
+  if (attempt_pending_) {
+    breaker_->OnSuccess();
+  }
+}
+
+std::unique_ptr<RPCRetryPolicy> CircuitBreakerRetryPolicy::clone() const {
+  return std::unique_ptr<RPCRetryPolicy>(
+      new CircuitBreakerRetryPolicy(*policy_, breaker_));
+}
+
+void CircuitBreakerRetryPolicy::Setup(grpc::ClientContext& context) const {
+  policy_->Setup(context);
+  if (breaker_->AllowRequest()) {
+    attempt_pending_ = true;
+    attempt_rejected_ = false;
+    return;
+  }
+  // Cancelling a context before the call starts makes the call fail
+  // immediately, without contacting the service.
+  context.TryCancel();
+  attempt_pending_ = false;
+  attempt_rejected_ = true;
+}
+
+bool CircuitBreakerRetryPolicy::OnFailure(grpc::Status const& status) {
+  attempt_pending_ = false;
+  // Always update the decorated policy, it may track the attempts too.
+  bool retry = policy_->OnFailure(status);
+  if (attempt_rejected_) {
+    return false;
+  }
+  if (SafeGrpcRetry::IsTransientFailure(status)) {
+    breaker_->OnFailure();
+  } else {
+    breaker_->OnSuccess();
+  }
+  return retry;
+}
+
+grpc::Status CircuitBreakerRetryPolicy::FinalStatus(
+    grpc::Status const& status) const {
+  if (attempt_rejected_) {
+    return grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                        "circuit breaker is open, the request was not sent");
+  }
+  return policy_->FinalStatus(status);
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,138 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CIRCUIT_BREAKER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CIRCUIT_BREAKER_H_
+
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/bigtable/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Stop sending requests to a service that is consistently failing.
+ *
+ * The breaker starts *closed*, and all requests are allowed. After
+ * `failure_threshold` consecutive transient failures it *opens*, and rejects
+ * all requests for `open_duration`. Then it becomes *half-open*, allowing up
+ * to `half_open_probes` requests: if one succeeds the breaker closes, if one
+ * fails it opens again.
+ *
+ * This class is thread-safe, use it with `CircuitBreakerRetryPolicy`.
+ */
+class CircuitBreaker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class State { kClosed, kOpen, kHalfOpen };
+
+  explicit CircuitBreaker(
+      int failure_threshold = 10,
+      std::chrono::milliseconds open_duration = std::chrono::seconds(5),
+      int half_open_probes = 1);
+
+  /// Return true if a new request can be sent.
+  bool AllowRequest(Clock::time_point now = Clock::now());
+
+  /// Record a request that reached the service.
+  void OnSuccess();
+
+  /// Record a request that failed with a transient error.
+  void OnFailure(Clock::time_point now = Clock::now());
+
+  State state() const;
+
+  /// The number of requests rejected while the breaker was open.
+  std::uint64_t rejected_count() const;
+
+  /// The number of times the breaker has opened.
+  std::uint64_t open_count() const;
+
+ private:
+  void Open(Clock::time_point now);
+
+  int const failure_threshold_;
+  std::chrono::milliseconds const open_duration_;
+  int const half_open_probes_;
+
+  mutable std::mutex mu_;
+  State state_;
+  int consecutive_failures_;
+  int probes_;
+  Clock::time_point open_until_;
+  std::uint64_t rejected_count_;
+  std::uint64_t open_count_;
+};
+
+/**
+ * Decorate a retry policy to fail fast while a `CircuitBreaker` is open.
+ *
+ * Each clone of this policy (the library clones the policy for each
+ * operation) shares the same breaker. Typically an application creates one
+ * breaker for each `DataClient` and uses it in all the `Table` objects
+ * created with that client.
+ *
+ * When the breaker rejects an attempt the policy cancels its
+ * `grpc::ClientContext`, so the request fails locally without contacting the
+ * service, and is not retried. The operation reports `UNAVAILABLE`, with a
+ * message saying that the circuit breaker is open. Only transient failures
+ * count against the breaker, any other result shows that the service is
+ * reachable.
+ *
+ * @note Operations that are never retried, such as `CheckAndMutateRow()`, do
+ *     not report their failures to the retry policy, and the breaker counts
+ *     them as successful requests. They are still rejected while it is open.
+ *
+ * @par Example
+ * @code
+ * auto breaker = std::make_shared<bigtable::CircuitBreaker>(10);
+ * bigtable::Table table(data_client, "my-table",
+ *                       bigtable::CircuitBreakerRetryPolicy(
+ *                           bigtable::LimitedErrorCountRetryPolicy(5),
+ *                           breaker));
+ * @endcode
+ */
+class CircuitBreakerRetryPolicy : public RPCRetryPolicy {
+ public:
+  CircuitBreakerRetryPolicy(RPCRetryPolicy const& policy,
+                            std::shared_ptr<CircuitBreaker> breaker);
+  ~CircuitBreakerRetryPolicy() override;
+
+  std::unique_ptr<RPCRetryPolicy> clone() const override;
+  void Setup(grpc::ClientContext& context) const override;
+  bool OnFailure(grpc::Status const& status) override;
+  grpc::Status FinalStatus(grpc::Status const& status) const override;
+
+ private:
+  std::unique_ptr<RPCRetryPolicy> policy_;
+  std::shared_ptr<CircuitBreaker> breaker_;
+  // `Setup()` is called before each attempt, and `OnFailure()` after each
+  // failed attempt. If the last attempt has not failed when the policy is
+  // destroyed the call succeeded.
+  mutable bool attempt_pending_;
+  mutable bool attempt_rejected_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_CIRCUIT_BREAKER_H_
@@ -0,0 +1,163 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/circuit_breaker.h"
+#include "google/cloud/bigtable/retry_budget.h"
+#include <gmock/gmock.h>
+
+namespace {
+namespace bigtable = google::cloud::bigtable;
+using ::testing::HasSubstr;
+using State = bigtable::CircuitBreaker::State;
+using ms = std::chrono::milliseconds;
+
+grpc::Status CreateTransientError() {
+  return grpc::Status(grpc::StatusCode::UNAVAILABLE, "please try again");
+}
+
+}  // anonymous namespace
+
+/// @test Verify the transitions between the breaker states.
+TEST(CircuitBreakerTest, OpenAndClose) {
+  bigtable::CircuitBreaker tested(3, ms(100));
+  auto now = bigtable::CircuitBreaker::Clock::now();
+  tested.OnFailure(now);
+  tested.OnFailure(now);
+  // A success resets the count of consecutive failures.
+  tested.OnSuccess();
+  tested.OnFailure(now);
+  tested.OnFailure(now);
+  EXPECT_EQ(State::kClosed, tested.state());
+  EXPECT_TRUE(tested.AllowRequest(now));
+
+  tested.OnFailure(now);
+  EXPECT_EQ(State::kOpen, tested.state());
+  EXPECT_FALSE(tested.AllowRequest(now + ms(50)));
+  EXPECT_EQ(1U, tested.rejected_count());
+
+  // After the open period a single probe is allowed.
+  EXPECT_TRUE(tested.AllowRequest(now + ms(100)));
+  EXPECT_EQ(State::kHalfOpen, tested.state());
+  EXPECT_FALSE(tested.AllowRequest(now + ms(100)));
+
+  tested.OnSuccess();
+  EXPECT_EQ(State::kClosed, tested.state());
+  EXPECT_EQ(1U, tested.open_count());
+}
+
+/// @test Verify that a failed probe opens the breaker again.
+TEST(CircuitBreakerTest, FailedProbe) {
+  bigtable::CircuitBreaker tested(1, ms(100), 2);
+  auto now = bigtable::CircuitBreaker::Clock::now();
+  tested.OnFailure(now);
+  EXPECT_EQ(State::kOpen, tested.state());
+
+  now += ms(100);
+  EXPECT_TRUE(tested.AllowRequest(now));
+  EXPECT_TRUE(tested.AllowRequest(now));
+  EXPECT_FALSE(tested.AllowRequest(now));
+  tested.OnFailure(now);
+  EXPECT_EQ(State::kOpen, tested.state());
+  EXPECT_FALSE(tested.AllowRequest(now + ms(50)));
+  EXPECT_EQ(2U, tested.open_count());
+}
+
+/// @test Verify that the policy rejects attempts while the breaker is open.
+TEST(CircuitBreakerRetryPolicyTest, FailFast) {
+  auto breaker =
+      std::make_shared<bigtable::CircuitBreaker>(2, std::chrono::minutes(1));
+  bigtable::CircuitBreakerRetryPolicy prototype(
+      bigtable::LimitedErrorCountRetryPolicy(10), breaker);
+
+  auto tested = prototype.clone();
+  {
+    grpc::ClientContext context;
+    tested->Setup(context);
+    EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+  }
+  {
+    grpc::ClientContext context;
+    tested->Setup(context);
+    EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+  }
+  EXPECT_EQ(State::kOpen, breaker->state());
+
+  // Other operations fail fast, and are not retried.
+  auto other = prototype.clone();
+  grpc::ClientContext context;
+  other->Setup(context);
+  grpc::Status cancelled(grpc::StatusCode::CANCELLED, "cancelled");
+  EXPECT_FALSE(other->OnFailure(cancelled));
+  EXPECT_EQ(1U, breaker->rejected_count());
+
+  // The operation reports the breaker, not the cancelled context.
+  auto status = other->FinalStatus(cancelled);
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+  EXPECT_THAT(status.error_message(), HasSubstr("circuit breaker is open"));
+}
+
+/// @test Verify that successful and permanently failed calls close the breaker.
+TEST(CircuitBreakerRetryPolicyTest, SuccessResets) {
+  auto breaker = std::make_shared<bigtable::CircuitBreaker>(2);
+  bigtable::CircuitBreakerRetryPolicy prototype(
+      bigtable::LimitedErrorCountRetryPolicy(10), breaker);
+
+  {
+    auto tested = prototype.clone();
+    grpc::ClientContext context;
+    tested->Setup(context);
+    EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+    tested->Setup(context);
+    // The second attempt succeeds when the policy is destroyed.
+  }
+  {
+    auto tested = prototype.clone();
+    grpc::ClientContext context;
+    tested->Setup(context);
+    EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+    tested->Setup(context);
+    grpc::Status failed(grpc::StatusCode::FAILED_PRECONDITION, "failed");
+    EXPECT_FALSE(tested->OnFailure(failed));
+    // Errors returned by the service are reported unchanged.
+    auto status = tested->FinalStatus(failed);
+    EXPECT_EQ(grpc::StatusCode::FAILED_PRECONDITION, status.error_code());
+    EXPECT_EQ("failed", status.error_message());
+  }
+  EXPECT_EQ(State::kClosed, breaker->state());
+  EXPECT_EQ(0U, breaker->open_count());
+}
+
+/// @test Verify that other decorators report the breaker rejections.
+TEST(CircuitBreakerRetryPolicyTest, DecoratedFinalStatus) {
+  auto breaker = std::make_shared<bigtable::CircuitBreaker>(1);
+  auto budget = std::make_shared<bigtable::RetryBudget>(1.0, 100.0);
+  bigtable::BudgetedRetryPolicy prototype(
+      bigtable::CircuitBreakerRetryPolicy(
+          bigtable::LimitedErrorCountRetryPolicy(10), breaker),
+      budget);
+
+  auto tested = prototype.clone();
+  grpc::ClientContext context;
+  tested->Setup(context);
+  EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+  EXPECT_EQ(State::kOpen, breaker->state());
+
+  grpc::ClientContext retry_context;
+  tested->Setup(retry_context);
+  grpc::Status cancelled(grpc::StatusCode::CANCELLED, "cancelled");
+  EXPECT_FALSE(tested->OnFailure(cancelled));
+  auto status = tested->FinalStatus(cancelled);
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+  EXPECT_THAT(status.error_message(), HasSubstr("circuit breaker is open"));
+}
@@ -58,6 +58,10 @@ inline std::size_t CalculateDefaultConnectionPoolSize() {
 ClientOptions::ClientOptions(std::shared_ptr<grpc::ChannelCredentials> creds)
     : credentials_(std::move(creds)),
       connection_pool_size_(CalculateDefaultConnectionPoolSize()),
+      eager_connection_(false),
+      connection_timeout_(std::chrono::seconds(10)),
+      max_transient_failure_(0),
+      channel_refresh_period_(0),
       data_endpoint_("bigtable.googleapis.com"),
       admin_endpoint_("bigtableadmin.googleapis.com"),
       instance_admin_endpoint_("bigtableadmin.googleapis.com") {
@@ -18,6 +18,7 @@
 #include "google/cloud/bigtable/version.h"
 #include "google/cloud/internal/throw_delegate.h"
 #include <grpcpp/grpcpp.h>
+#include <chrono>
 
 namespace google {
 namespace cloud {
@@ -114,6 +115,75 @@ class ClientOptions {
   }
   std::size_t connection_pool_size() const { return connection_pool_size_; }
 
+  /**
+   * Connect all the channels in the pool when the client is created.
+   *
+   * By default the channels are created, and connected, on the first RPC.
+   * With this option the client constructor creates all the channels, and
+   * blocks until they are connected or `connection_timeout()` expires. This
+   * moves the cost of name resolution, and the TCP, TLS and HTTP/2 handshakes
+   * out of the first RPCs. Failing to connect is not an error, the channels
+   * keep trying to connect in the background.
+   */
+  ClientOptions& set_eager_connection(bool v) {
+    eager_connection_ = v;
+    return *this;
+  }
+  bool eager_connection() const { return eager_connection_; }
+
+  /// Set how long the client constructor waits for the eager connections.
+  ClientOptions& set_connection_timeout(std::chrono::milliseconds v) {
+    if (v.count() <= 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ClientOptions::set_connection_timeout requires v > 0");
+    }
+    connection_timeout_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds connection_timeout() const {
+    return connection_timeout_;
+  }
+
+  /**
+   * Replace channels that stay in `TRANSIENT_FAILURE` for longer than @p v.
+   *
+   * A background thread monitors the state of each channel in the pool, and
+   * replaces any channel that cannot connect for longer than this value with
+   * a new channel, using a new connection. Zero, the default, disables the
+   * monitoring.
+   */
+  ClientOptions& set_max_transient_failure(std::chrono::milliseconds v) {
+    if (v.count() < 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ClientOptions::set_max_transient_failure requires v >= 0");
+    }
+    max_transient_failure_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds max_transient_failure() const {
+    return max_transient_failure_;
+  }
+
+  /**
+   * Replace each channel in the pool after it has been in use for @p v.
+   *
+   * Refreshing the channels periodically spreads the load as the service
+   * rebalances its frontends. The refreshes are staggered, so only one
+   * channel is replaced at a time. Requests already started on the old
+   * channel are not interrupted. Zero, the default, disables the refresh.
+   */
+  ClientOptions& set_channel_refresh_period(std::chrono::milliseconds v) {
+    if (v.count() < 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ClientOptions::set_channel_refresh_period requires v >= 0");
+    }
+    channel_refresh_period_ = v;
+    return *this;
+  }
+  std::chrono::milliseconds channel_refresh_period() const {
+    return channel_refresh_period_;
+  }
+
   /// Return the current credentials.
   std::shared_ptr<grpc::ChannelCredentials> credentials() const {
     return credentials_;
@@ -300,6 +370,10 @@ class ClientOptions {
   grpc::ChannelArguments channel_arguments_;
   std::string connection_pool_name_;
   std::size_t connection_pool_size_;
+  bool eager_connection_;
+  std::chrono::milliseconds connection_timeout_;
+  std::chrono::milliseconds max_transient_failure_;
+  std::chrono::milliseconds channel_refresh_period_;
   std::string data_endpoint_;
   std::string admin_endpoint_;
   // The endpoint for instance admin operations, in most scenarios this should
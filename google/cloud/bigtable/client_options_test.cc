@@ -165,6 +165,43 @@ TEST(ClientOptionsTest, InvalidConnectionPoolSize) {
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 }
 
+TEST(ClientOptionsTest, EditChannelManagement) {
+  bigtable::ClientOptions client_options_object;
+  EXPECT_FALSE(client_options_object.eager_connection());
+  EXPECT_EQ(0, client_options_object.max_transient_failure().count());
+  EXPECT_EQ(0, client_options_object.channel_refresh_period().count());
+
+  auto& returned =
+      client_options_object.set_eager_connection(true)
+          .set_connection_timeout(std::chrono::milliseconds(100))
+          .set_max_transient_failure(std::chrono::milliseconds(200))
+          .set_channel_refresh_period(std::chrono::minutes(30));
+  EXPECT_EQ(&returned, &client_options_object);
+  EXPECT_TRUE(returned.eager_connection());
+  EXPECT_EQ(std::chrono::milliseconds(100), returned.connection_timeout());
+  EXPECT_EQ(std::chrono::milliseconds(200), returned.max_transient_failure());
+  EXPECT_EQ(std::chrono::minutes(30), returned.channel_refresh_period());
+}
+
+TEST(ClientOptionsTest, InvalidChannelManagement) {
+  bigtable::ClientOptions client_options_object;
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  EXPECT_THROW(client_options_object.set_connection_timeout(
+                   std::chrono::milliseconds(0)),
+               std::range_error);
+  EXPECT_THROW(client_options_object.set_max_transient_failure(
+                   std::chrono::milliseconds(-1)),
+               std::range_error);
+  EXPECT_THROW(client_options_object.set_channel_refresh_period(
+                   std::chrono::milliseconds(-1)),
+               std::range_error);
+#else
+  EXPECT_DEATH_IF_SUPPORTED(client_options_object.set_connection_timeout(
+                                std::chrono::milliseconds(0)),
+                            "exceptions are disabled");
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
 TEST(ClientOptionsTest, SetGrpclbFallbackTimeoutMS) {
   // Test milliseconds are set properly to channel_arguments
   bigtable::ClientOptions client_options_object = bigtable::ClientOptions();
@@ -0,0 +1,179 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_BATCH_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_BATCH_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+class ColumnarParser;
+}  // namespace internal
+
+/// The types of the columns in a columnar scan.
+enum class ColumnType {
+  /**
+   * A 64-bit integer stored in big-endian order, as used by
+   * `bigtable::bigendian64_t` and the `ReadModifyWriteRule::IncrementAmount()`
+   * counters.
+   */
+  INT64,
+  /// The raw bytes of the cell value.
+  BYTES,
+};
+
+/**
+ * Describe a column in a columnar scan.
+ *
+ * Only the newest cell in each column is extracted, use a filter such as
+ * `Filter::Latest(1)` to avoid downloading the older cells.
+ */
+struct ColumnSpec {
+  std::string family_name;
+  std::string column_qualifier;
+  ColumnType type;
+};
+
+/**
+ * The values of one column in a `ColumnarBatch`.
+ *
+ * The values are stored in contiguous buffers, one entry per row in the batch.
+ * Rows that do not have a cell for this column are null, they are tracked in a
+ * validity bitmap and their slots in the value buffers are empty (zero for
+ * `INT64` columns, a zero-length range for `BYTES` columns).
+ */
+class ColumnarColumn {
+ public:
+  explicit ColumnarColumn(ColumnType type = ColumnType::BYTES)
+      : type_(type), size_(0), null_count_(0), raw_begin_(0), offsets_(1, 0) {}
+
+  ColumnType type() const { return type_; }
+
+  /// The number of values, including nulls.
+  std::size_t size() const { return size_; }
+
+  /// The number of null values.
+  std::size_t null_count() const { return null_count_; }
+
+  /// Return true if the value in row @p i is null.
+  bool is_null(std::size_t i) const {
+    return (validity_[i / 64] & (std::uint64_t(1) << (i % 64))) == 0;
+  }
+
+  /**
+   * The validity bitmap.
+   *
+   * Bit `i % 64` of element `i / 64` is set if the value in row `i` is not
+   * null.
+   */
+  std::vector<std::uint64_t> const& validity() const { return validity_; }
+
+  /// The values of an `INT64` column, already converted to native byte order.
+  std::vector<std::int64_t> const& int64_values() const {
+    return int64_values_;
+  }
+
+  /**
+   * The concatenated values of a `BYTES` column.
+   *
+   * The value in row `i` is in the range `[offsets()[i], offsets()[i + 1])`.
+   */
+  std::string const& bytes_data() const { return bytes_data_; }
+
+  /// The offsets into `bytes_data()`, this vector has `size() + 1` elements.
+  std::vector<std::size_t> const& offsets() const { return offsets_; }
+
+  /// Return a copy of the value in row @p i of a `BYTES` column.
+  std::string bytes_value(std::size_t i) const {
+    return bytes_data_.substr(offsets_[i], offsets_[i + 1] - offsets_[i]);
+  }
+
+ private:
+  friend class internal::ColumnarParser;
+
+  ColumnType type_;
+  std::size_t size_;
+  std::size_t null_count_;
+  /// The first value in `int64_values_` still in big-endian order.
+  std::size_t raw_begin_;
+  std::vector<std::uint64_t> validity_;
+  std::vector<std::int64_t> int64_values_;
+  std::string bytes_data_;
+  std::vector<std::size_t> offsets_;
+};
+
+/**
+ * A batch of rows returned by a columnar scan.
+ *
+ * The batch holds the row keys and one `ColumnarColumn` for each `ColumnSpec`
+ * in the scan schema, in the same order. Reusing the same batch object for
+ * consecutive calls to `ColumnarReader::NextBatch()` reuses its buffers, so
+ * after the first few batches a scan performs no memory allocations to store
+ * the values.
+ */
+class ColumnarBatch {
+ public:
+  ColumnarBatch() : row_count_(0), row_key_offsets_(1, 0) {}
+
+  /// The number of rows in the batch.
+  std::size_t row_count() const { return row_count_; }
+
+  /// Return a copy of the key of row @p i.
+  std::string row_key(std::size_t i) const {
+    return row_keys_data_.substr(row_key_offsets_[i],
+                                 row_key_offsets_[i + 1] - row_key_offsets_[i]);
+  }
+
+  /**
+   * The concatenated row keys.
+   *
+   * The key of row `i` is in the range
+   * `[row_key_offsets()[i], row_key_offsets()[i + 1])`.
+   */
+  std::string const& row_keys_data() const { return row_keys_data_; }
+
+  /// The offsets into `row_keys_data()`, with `row_count() + 1` elements.
+  std::vector<std::size_t> const& row_key_offsets() const {
+    return row_key_offsets_;
+  }
+
+  /// The number of columns, this is the size of the scan schema.
+  std::size_t column_count() const { return columns_.size(); }
+
+  /// The values of the column described by the @p i-th `ColumnSpec`.
+  ColumnarColumn const& column(std::size_t i) const { return columns_[i]; }
+
+ private:
+  friend class internal::ColumnarParser;
+
+  std::size_t row_count_;
+  std::string row_keys_data_;
+  std::vector<std::size_t> row_key_offsets_;
+  std::vector<ColumnarColumn> columns_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_BATCH_H_
@@ -0,0 +1,217 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/columnar_reader.h"
+#include "google/cloud/bigtable/internal/table.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/log.h"
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+std::size_t constexpr ColumnarReader::DEFAULT_BATCH_SIZE;
+
+ColumnarReader::ColumnarReader(
+    std::shared_ptr<DataClient> client, bigtable::AppProfileId app_profile_id,
+    bigtable::TableId table_name, RowSet row_set, Filter filter,
+    std::vector<ColumnSpec> schema, std::size_t batch_size,
+    std::unique_ptr<RPCRetryPolicy> retry_policy,
+    std::unique_ptr<RPCBackoffPolicy> backoff_policy,
+    MetadataUpdatePolicy metadata_update_policy, bool raise_on_error)
+    : client_(std::move(client)),
+      app_profile_id_(std::move(app_profile_id)),
+      table_name_(std::move(table_name)),
+      row_set_(std::move(row_set)),
+      filter_(std::move(filter)),
+      schema_(std::move(schema)),
+      batch_size_(batch_size == 0 ? DEFAULT_BATCH_SIZE : batch_size),
+      retry_policy_(std::move(retry_policy)),
+      backoff_policy_(std::move(backoff_policy)),
+      metadata_update_policy_(std::move(metadata_update_policy)),
+      context_(),
+      stream_is_open_(false),
+      operation_cancelled_(false),
+      done_(false),
+      arena_(google::cloud::internal::make_unique<google::protobuf::Arena>()),
+      response_(google::protobuf::Arena::CreateMessage<
+                google::bigtable::v2::ReadRowsResponse>(arena_.get())),
+      processed_chunks_count_(0),
+      status_(grpc::Status::OK),
+      raise_on_error_(raise_on_error),
+      error_retrieved_(raise_on_error) {}
+
+bool ColumnarReader::NextBatch(ColumnarBatch& batch) {
+  internal::ColumnarParser::StartBatch(schema_, batch);
+  if (operation_cancelled_) {
+    if (raise_on_error_) {
+      google::cloud::internal::ThrowRuntimeError(
+          "Operation already cancelled.");
+    }
+    status_ = grpc::Status::CANCELLED;
+    return false;
+  }
+  if (done_) {
+    return false;
+  }
+  if (!stream_) {
+    MakeRequest();
+  }
+
+  while (true) {
+    grpc::Status status;
+    status_ = status = FillOrFail(batch);
+    if (batch.row_count() != 0) {
+      last_read_row_key_ = batch.row_key(batch.row_count() - 1);
+    }
+    if (status.ok()) {
+      break;
+    }
+
+    // The rows committed to the batch are kept, the retry starts after them.
+    parser_->DiscardRow(batch);
+    if (!last_read_row_key_.empty()) {
+      row_set_.RemoveRowsUpTo(last_read_row_key_);
+    }
+
+    // If we receive an error, but the retriable set is empty, stop.
+    if (row_set_.IsEmpty()) {
+      done_ = true;
+      break;
+    }
+
+    if (!retry_policy_->OnFailure(status)) {
+      done_ = true;
+      status_ = retry_policy_->FinalStatus(status);
+      if (raise_on_error_) {
+        google::cloud::internal::ThrowRuntimeError("Unretriable error: " +
+                                                   status_.error_message());
+        /*NOTREACHED*/
+      }
+      break;
+    }
+
+    auto delay = backoff_policy_->OnCompletion(status);
+    std::this_thread::sleep_for(delay);
+
+    // If we reach this place, we failed and need to restart the call.
+    MakeRequest();
+  }
+
+  internal::ColumnarParser::FinishBatch(batch);
+  return batch.row_count() != 0;
+}
+
+grpc::Status ColumnarReader::FillOrFail(ColumnarBatch& batch) {
+  grpc::Status status;
+  // Rows never span two batches, keep reading until the current row is done.
+  while (batch.row_count() < batch_size_ || parser_->InRow()) {
+    if (NextChunk()) {
+      parser_->HandleChunk(*response_->mutable_chunks(processed_chunks_count_),
+                           batch, status);
+      if (!status.ok()) {
+        return status;
+      }
+      continue;
+    }
+
+    // Here, there are no more chunks to look at. Close the stream and
+    // finalize the parser.
+    stream_is_open_ = false;
+    status = stream_->Finish();
+    if (!status.ok()) {
+      return status;
+    }
+    parser_->HandleEndOfStream(status);
+    done_ = status.ok();
+    return status;
+  }
+  return status;
+}
+
+bool ColumnarReader::NextChunk() {
+  ++processed_chunks_count_;
+  while (processed_chunks_count_ >= response_->chunks_size()) {
+    processed_chunks_count_ = 0;
+    bool response_is_valid = stream_->Read(response_);
+    if (!response_is_valid) {
+      response_->Clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+void ColumnarReader::MakeRequest() {
+  response_->Clear();
+  processed_chunks_count_ = 0;
+
+  google::bigtable::v2::ReadRowsRequest request;
+
+  bigtable::internal::SetCommonTableOperationRequest<
+      google::bigtable::v2::ReadRowsRequest>(request, app_profile_id_.get(),
+                                             table_name_.get());
+  // Move the row set into the request to avoid copying what can be a very
+  // large number of keys, it is moved back once the stub sends the request.
+  bigtable::internal::SwapRowSetProto(row_set_, *request.mutable_rows());
+
+  auto filter_proto = filter_.as_proto();
+  request.mutable_filter()->Swap(&filter_proto);
+
+  context_ = google::cloud::internal::make_unique<grpc::ClientContext>();
+  retry_policy_->Setup(*context_);
+  backoff_policy_->Setup(*context_);
+  metadata_update_policy_.Setup(*context_);
+  stream_ = client_->ReadRows(context_.get(), request);
+  bigtable::internal::SwapRowSetProto(row_set_, *request.mutable_rows());
+  stream_is_open_ = true;
+
+  parser_ = google::cloud::internal::make_unique<internal::ColumnarParser>(
+      schema_);
+}
+
+void ColumnarReader::Cancel() {
+  operation_cancelled_ = true;
+  if (!stream_is_open_) {
+    return;
+  }
+  context_->TryCancel();
+
+  // Also drain any data left unread
+  google::bigtable::v2::ReadRowsResponse response;
+  while (stream_->Read(&response)) {
+  }
+
+  stream_is_open_ = false;
+  (void)stream_->Finish();  // ignore errors
+}
+
+ColumnarReader::~ColumnarReader() {
+  // Make sure we don't leave open streams.
+  Cancel();
+  if (!raise_on_error_ && !error_retrieved_ && !status_.ok()) {
+    GCP_LOG(ERROR)
+        << "Exceptions are disabled, ColumnarReader has an error,"
+        << " and the error status was not retrieved by the application: "
+        << "status_code=" << status_.error_code()
+        << ", error_message=" << status_.error_message();
+  }
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
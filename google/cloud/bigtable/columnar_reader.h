@@ -0,0 +1,159 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_READER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_READER_H_
+
+#include "google/cloud/bigtable/bigtable_strong_types.h"
+#include "google/cloud/bigtable/columnar_batch.h"
+#include "google/cloud/bigtable/data_client.h"
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/internal/columnar_parser.h"
+#include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/bigtable/table_strong_types.h"
+#include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <google/protobuf/arena.h>
+#include <grpcpp/grpcpp.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Object returned by Table::ReadColumns(), reads the rows in column batches.
+ *
+ * A columnar scan extracts the newest value of each column in a schema, and
+ * stores the values for many rows in contiguous, typed buffers. The values
+ * are copied from the ReadRows responses directly to these buffers, the scan
+ * does not create a `Row` or `Cell` object for each row.
+ *
+ * @par Example
+ * @code
+ * std::vector<bigtable::ColumnSpec> schema{
+ *     {"fam", "counter", bigtable::ColumnType::INT64},
+ *     {"fam", "name", bigtable::ColumnType::BYTES}};
+ * auto reader = table.ReadColumns(bigtable::RowSet(""),
+ *                                 bigtable::Filter::Latest(1), schema);
+ * bigtable::ColumnarBatch batch;
+ * std::int64_t total = 0;
+ * while (reader.NextBatch(batch)) {
+ *   auto const& counters = batch.column(0);
+ *   for (std::size_t i = 0; i != counters.size(); ++i) {
+ *     total += counters.int64_values()[i];
+ *   }
+ * }
+ * @endcode
+ */
+class ColumnarReader {
+ public:
+  /// The default number of rows in each batch.
+  static std::size_t constexpr DEFAULT_BATCH_SIZE = 1024;
+
+  ColumnarReader(std::shared_ptr<DataClient> client,
+                 bigtable::AppProfileId app_profile_id,
+                 bigtable::TableId table_name, RowSet row_set, Filter filter,
+                 std::vector<ColumnSpec> schema, std::size_t batch_size,
+                 std::unique_ptr<RPCRetryPolicy> retry_policy,
+                 std::unique_ptr<RPCBackoffPolicy> backoff_policy,
+                 MetadataUpdatePolicy metadata_update_policy,
+                 bool raise_on_error);
+
+  ColumnarReader(ColumnarReader&& rhs) noexcept = default;
+
+  ~ColumnarReader();
+
+  /**
+   * Read the next batch of rows.
+   *
+   * The previous contents of @p batch are discarded, but its buffers are
+   * reused. The batch receives `batch_size` complete rows, or fewer for the
+   * last batch in the scan.
+   *
+   * Retry and backoff policies are honored.
+   *
+   * @return false if there are no more rows, or the read failed. Use
+   *     `Finish()` to find out which.
+   *
+   * @throws std::runtime_error if the read failed after retries and the
+   *     reader was created to raise on errors.
+   */
+  bool NextBatch(ColumnarBatch& batch);
+
+  /// Gracefully terminate a streaming read.
+  void Cancel();
+
+  grpc::Status Finish() {
+    error_retrieved_ = true;
+    return status_;
+  }
+
+ private:
+  /// Fill @p batch from the current stream, does not handle retries.
+  grpc::Status FillOrFail(ColumnarBatch& batch);
+
+  /// Move to the next chunk, reading a new response if needed.
+  bool NextChunk();
+
+  /// Sends the ReadRows request to the stub.
+  void MakeRequest();
+
+  std::shared_ptr<DataClient> client_;
+  bigtable::AppProfileId app_profile_id_;
+  bigtable::TableId table_name_;
+  RowSet row_set_;
+  Filter filter_;
+  std::vector<ColumnSpec> schema_;
+  std::size_t batch_size_;
+  std::unique_ptr<RPCRetryPolicy> retry_policy_;
+  std::unique_ptr<RPCBackoffPolicy> backoff_policy_;
+  MetadataUpdatePolicy metadata_update_policy_;
+
+  std::unique_ptr<grpc::ClientContext> context_;
+
+  std::unique_ptr<internal::ColumnarParser> parser_;
+  std::unique_ptr<
+      grpc::ClientReaderInterface<google::bigtable::v2::ReadRowsResponse>>
+      stream_;
+  bool stream_is_open_;
+  bool operation_cancelled_;
+  /// Set when the scan completes or fails, NextBatch() returns no more rows.
+  bool done_;
+
+  /// Owns the memory for `response_`, see `RowReader` for the details.
+  std::unique_ptr<google::protobuf::Arena> arena_;
+  google::bigtable::v2::ReadRowsResponse* response_;
+  /// Number of chunks already parsed in response_.
+  int processed_chunks_count_;
+
+  /// Holds the last read row key, for retries.
+  std::string last_read_row_key_;
+
+  grpc::Status status_;
+  bool raise_on_error_;
+  bool error_retrieved_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COLUMNAR_READER_H_
@@ -205,6 +205,48 @@ class CompletionQueue {
     return op;
   }
 
+  /**
+   * Make an asynchronous streaming read RPC with flow control.
+   *
+   * Unlike `MakeUnaryStreamRpc()`, the responses are only read when the caller
+   * asks for them, using `RequestNext()` on the returned operation. The first
+   * response is not read until `RequestNext()` is called.
+   *
+   * The parameters and template parameters have the same requirements as in
+   * `MakeUnaryStreamRpc()`.
+   *
+   * @return an operation to request the next response or cancel the stream.
+   */
+  template <typename Client, typename MemberFunction, typename Request,
+            typename DataFunctor, typename FinishedFunctor,
+            typename Sig =
+                internal::CheckAsyncUnaryStreamRpcSignature<MemberFunction>,
+            typename std::enable_if<Sig::value, int>::type
+                valid_member_function_type = 0,
+            typename std::enable_if<
+                internal::CheckUnaryStreamRpcDataCallback<
+                    DataFunctor, typename Sig::ResponseType>::value,
+                int>::type valid_data_callback_type = 0,
+            typename std::enable_if<
+                internal::CheckUnaryStreamRpcFinishedCallback<
+                    FinishedFunctor, typename Sig::ResponseType>::value,
+                int>::type valid_finished_callback_type = 0>
+  std::shared_ptr<internal::AsyncPullStreamOperation> MakePullStreamRpc(
+      Client& client, MemberFunction Client::*call, Request const& request,
+      std::unique_ptr<grpc::ClientContext> context, DataFunctor&& data_functor,
+      FinishedFunctor&& finished_functor) {
+    static_assert(std::is_same<typename Sig::RequestType,
+                               typename std::decay<Request>::type>::value,
+                  "Mismatched pointer to member function and request types");
+    auto op = std::make_shared<internal::AsyncPullStreamRpcFunctor<
+        typename Sig::RequestType, typename Sig::ResponseType, DataFunctor,
+        FinishedFunctor>>(std::forward<DataFunctor>(data_functor),
+                          std::forward<FinishedFunctor>(finished_functor));
+    void* tag = impl_->RegisterOperation(op);
+    op->Set(client, call, std::move(context), request, &impl_->cq(), tag);
+    return op;
+  }
+
   /**
    * Asynchronously run a functor on a thread `Run()`ning the `CompletionQueue`.
    *
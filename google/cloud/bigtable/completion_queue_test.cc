@@ -75,6 +75,34 @@ TEST(CompletionQueueTest, CancelAlarm) {
   t.join();
 }
 
+/// @test Verify that RunUntilIdle() returns once all operations complete.
+TEST(CompletionQueueTest, RunUntilIdle) {
+  auto impl = std::make_shared<internal::CompletionQueueImpl>();
+  CompletionQueue cq(impl);
+
+  int fired = 0;
+  int cancelled = 0;
+  // Operations started by a callback also run before RunUntilIdle() returns.
+  cq.MakeRelativeTimer(2_ms, [&fired](CompletionQueue& cq, AsyncTimerResult&) {
+    ++fired;
+    cq.MakeRelativeTimer(
+        2_ms, [&fired](CompletionQueue&, AsyncTimerResult&) { ++fired; });
+  });
+  auto alarm = cq.MakeRelativeTimer(
+      std::chrono::hours(1),
+      [&cancelled](CompletionQueue&, AsyncTimerResult& result) {
+        if (result.cancelled) {
+          ++cancelled;
+        }
+      });
+  alarm->Cancel();
+
+  impl->RunUntilIdle(cq);
+  EXPECT_EQ(2, fired);
+  EXPECT_EQ(1, cancelled);
+  cq.Shutdown();
+}
+
 class MockClient {
  public:
   MOCK_METHOD3(
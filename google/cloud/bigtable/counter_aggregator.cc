@@ -0,0 +1,167 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/counter_aggregator.h"
+#include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+CounterAggregator::CounterAggregator(Table const& table,
+                                     std::chrono::microseconds flush_interval,
+                                     std::size_t max_counters,
+                                     std::size_t thread_count)
+    : table_(table.impl_),
+      flush_interval_(flush_interval),
+      max_counters_((std::max)(max_counters, std::size_t(1))),
+      shutdown_(false),
+      increment_count_(0),
+      request_count_(0) {
+  thread_count = (std::max)(thread_count, std::size_t(1));
+  workers_.reserve(thread_count);
+  for (std::size_t i = 0; i != thread_count; ++i) {
+    workers_.emplace_back(&CounterAggregator::WorkerLoop, this);
+  }
+}
+
+CounterAggregator::~CounterAggregator() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : workers_) {
+    t.join();
+  }
+}
+
+future<std::int64_t> CounterAggregator::AsyncIncrement(
+    std::string row_key, std::string family_name, std::string column_qualifier,
+    std::int64_t amount) {
+  CounterKey key(std::move(row_key), std::move(family_name),
+                 std::move(column_qualifier));
+  promise<std::int64_t> p;
+  auto result = p.get_future();
+
+  std::unique_lock<std::mutex> lk(mu_);
+  ++increment_count_;
+  auto loc = open_.find(key);
+  if (loc != open_.end()) {
+    loc->second->total += amount;
+    loc->second->waiters.emplace_back(amount, std::move(p));
+    return result;
+  }
+  if (open_.size() >= max_counters_) {
+    FlushOldest();
+  }
+  auto counter = google::cloud::internal::make_unique<Counter>();
+  counter->key = key;
+  counter->deadline = std::chrono::steady_clock::now() + flush_interval_;
+  counter->total = amount;
+  counter->waiters.emplace_back(amount, std::move(p));
+  open_.emplace(std::move(key), std::move(counter));
+  lk.unlock();
+  // Either a counter was evicted, or there is a new deadline the workers need
+  // to wait for.
+  cv_.notify_one();
+  return result;
+}
+
+void CounterAggregator::FlushOldest() {
+  auto oldest = std::min_element(
+      open_.begin(), open_.end(),
+      [](std::pair<CounterKey const, std::unique_ptr<Counter>> const& a,
+         std::pair<CounterKey const, std::unique_ptr<Counter>> const& b) {
+        return a.second->deadline < b.second->deadline;
+      });
+  ready_.push_back(std::move(oldest->second));
+  open_.erase(oldest);
+}
+
+void CounterAggregator::WorkerLoop() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    auto const now = std::chrono::steady_clock::now();
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    for (auto i = open_.begin(); i != open_.end();) {
+      if (shutdown_ || i->second->deadline <= now) {
+        ready_.push_back(std::move(i->second));
+        i = open_.erase(i);
+        continue;
+      }
+      next_deadline = (std::min)(next_deadline, i->second->deadline);
+      ++i;
+    }
+    if (!ready_.empty()) {
+      auto counter = std::move(ready_.front());
+      ready_.pop_front();
+      ++request_count_;
+      lk.unlock();
+      SendCounter(*counter);
+      lk.lock();
+      continue;
+    }
+    if (shutdown_) {
+      return;
+    }
+    if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+      cv_.wait(lk);
+    } else {
+      cv_.wait_until(lk, next_deadline);
+    }
+  }
+}
+
+void CounterAggregator::SendCounter(Counter& counter) {
+  auto const& family_name = std::get<1>(counter.key);
+  auto const& column_qualifier = std::get<2>(counter.key);
+  grpc::Status status;
+  auto row = table_.ReadModifyWriteRow(
+      std::get<0>(counter.key), status,
+      ReadModifyWriteRule::IncrementAmount(family_name, column_qualifier,
+                                           counter.total));
+  auto cell = std::find_if(row.cells().begin(), row.cells().end(),
+                           [&](Cell const& c) {
+                             return c.family_name() == family_name &&
+                                    c.column_qualifier() == column_qualifier;
+                           });
+  if (status.ok() && cell == row.cells().end()) {
+    status = grpc::Status(grpc::StatusCode::INTERNAL,
+                          "ReadModifyWriteRow() response is missing the "
+                          "incremented counter");
+  }
+  if (!status.ok()) {
+    for (auto& w : counter.waiters) {
+      w.second.set_exception(std::make_exception_ptr(
+          GRpcError("CounterAggregator::AsyncIncrement", status)));
+    }
+    return;
+  }
+
+  // The service returns the value after all the increments, rebuild the value
+  // seen by each caller as if their increments were applied one at a time.
+  std::int64_t value = cell->value_as<bigendian64_t>().get() - counter.total;
+  for (auto& w : counter.waiters) {
+    value += w.first;
+    w.second.set_value(value);
+  }
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
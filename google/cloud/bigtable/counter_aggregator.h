@@ -0,0 +1,167 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COUNTER_AGGREGATOR_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COUNTER_AGGREGATOR_H_
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/future.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Combine concurrent increments to the same counter into a single request.
+ *
+ * Cloud Bigtable serializes the `ReadModifyWriteRow()` requests that modify
+ * the same row, so applications updating a few hot counters at high rates are
+ * limited by the latency of each request. This class accumulates the
+ * increments to the same row, column family and column, and sends their sum
+ * as a single `ReadModifyWriteRule::IncrementAmount()` request.
+ *
+ * Each caller receives the value of the counter right after its own increment
+ * was applied. That is, the increments in a combined request are applied, in
+ * the order they were received, immediately before the value returned by the
+ * service.
+ *
+ * The accumulated increments for a counter are sent at most `flush_interval`
+ * after the first increment was received. At most `max_counters` counters are
+ * accumulated at a time; when that limit is reached the counter with the
+ * oldest pending increment is sent immediately.
+ *
+ * @par Example
+ * @code
+ * bigtable::Table table(client, "my-table");
+ * bigtable::CounterAggregator aggregator(table);
+ * auto f = aggregator.AsyncIncrement("row-key", "fam", "counter", 1);
+ * // ... do something else ...
+ * std::int64_t value = f.get();
+ * @endcode
+ *
+ * @par Thread-safety
+ * Instances of this class are meant to be shared by many threads, all the
+ * member functions are thread-safe.
+ *
+ * @warning `ReadModifyWriteRow()` requests are not idempotent and are never
+ *     retried. If a combined request fails, all the increments in it are
+ *     reported as failed.
+ */
+class CounterAggregator {
+ public:
+  /**
+   * Create an aggregator for the counters in @p table.
+   *
+   * @param table the table containing the counters. The aggregator uses a
+   *     copy of this object, including its metadata policy.
+   * @param flush_interval the maximum time an increment waits for other
+   *     increments to the same counter.
+   * @param max_counters the maximum number of counters with pending
+   *     increments.
+   * @param thread_count the number of threads sending requests.
+   */
+  explicit CounterAggregator(
+      Table const& table,
+      std::chrono::microseconds flush_interval = std::chrono::milliseconds(10),
+      std::size_t max_counters = 1000, std::size_t thread_count = 4);
+
+  CounterAggregator(CounterAggregator const&) = delete;
+  CounterAggregator& operator=(CounterAggregator const&) = delete;
+
+  /// Send all the pending increments and wait for them to complete.
+  ~CounterAggregator();
+
+  /**
+   * Increment a counter, combining the request with other concurrent
+   * increments to the same counter.
+   *
+   * @return a future satisfied with the value of the counter after this
+   *     increment. If the combined request fails, the future is satisfied with
+   *     a `bigtable::GRpcError` exception.
+   */
+  future<std::int64_t> AsyncIncrement(std::string row_key,
+                                      std::string family_name,
+                                      std::string column_qualifier,
+                                      std::int64_t amount);
+
+  /// Increment a counter, blocking until the combined request completes.
+  std::int64_t Increment(std::string row_key, std::string family_name,
+                         std::string column_qualifier, std::int64_t amount) {
+    return AsyncIncrement(std::move(row_key), std::move(family_name),
+                          std::move(column_qualifier), amount)
+        .get();
+  }
+
+  /// The number of calls to `AsyncIncrement()` or `Increment()`.
+  std::int64_t increment_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return increment_count_;
+  }
+
+  /// The number of `ReadModifyWriteRow()` requests sent to the service.
+  std::int64_t request_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return request_count_;
+  }
+
+ private:
+  using CounterKey = std::tuple<std::string, std::string, std::string>;
+
+  struct Counter {
+    CounterKey key;
+    std::chrono::steady_clock::time_point deadline;
+    std::int64_t total = 0;
+    std::vector<std::pair<std::int64_t, promise<std::int64_t>>> waiters;
+  };
+
+  void FlushOldest();
+  void WorkerLoop();
+  void SendCounter(Counter& counter);
+
+  noex::Table table_;
+  std::chrono::microseconds const flush_interval_;
+  std::size_t const max_counters_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  /// The counters accepting new increments.
+  std::map<CounterKey, std::unique_ptr<Counter>> open_;
+  /// The counters that are expired or evicted, waiting for a thread.
+  std::deque<std::unique_ptr<Counter>> ready_;
+  bool shutdown_;
+  std::int64_t increment_count_;
+  std::int64_t request_count_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_COUNTER_AGGREGATOR_H_
@@ -0,0 +1,142 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/counter_aggregator.h"
+#include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include <gmock/gmock.h>
+
+namespace btproto = ::google::bigtable::v2;
+namespace bigtable = google::cloud::bigtable;
+using namespace ::testing;
+
+namespace {
+class CounterAggregatorTest : public bigtable::testing::TableTestFixture {};
+
+/**
+ * Simulate a ReadModifyWriteRow() on a counter with the given initial value.
+ *
+ * The returned functor records the increment received by the service.
+ */
+std::function<grpc::Status(grpc::ClientContext*,
+                           btproto::ReadModifyWriteRowRequest const&,
+                           btproto::ReadModifyWriteRowResponse*)>
+SimulateCounter(std::int64_t initial, std::vector<std::int64_t>& increments) {
+  return [initial, &increments](grpc::ClientContext*,
+                                btproto::ReadModifyWriteRowRequest const& r,
+                                btproto::ReadModifyWriteRowResponse* response) {
+    EXPECT_EQ(1, r.rules_size());
+    auto const& rule = r.rules(0);
+    increments.push_back(rule.increment_amount());
+    auto& row = *response->mutable_row();
+    row.set_key(r.row_key());
+    auto& family = *row.add_families();
+    family.set_name(rule.family_name());
+    auto& column = *family.add_columns();
+    column.set_qualifier(rule.column_qualifier());
+    column.add_cells()->set_value(
+        bigtable::internal::Encoder<bigtable::bigendian64_t>::Encode(
+            bigtable::bigendian64_t(initial + rule.increment_amount())));
+    return grpc::Status::OK;
+  };
+}
+}  // anonymous namespace
+
+/// @test Verify that increments to the same counter are combined.
+TEST_F(CounterAggregatorTest, CombinesIncrements) {
+  std::vector<std::int64_t> increments;
+  EXPECT_CALL(*client_, ReadModifyWriteRow(_, _, _))
+      .WillOnce(Invoke(SimulateCounter(100, increments)));
+
+  google::cloud::future<std::int64_t> f1, f2, f3;
+  {
+    bigtable::CounterAggregator aggregator(table_, std::chrono::hours(1), 10,
+                                           1);
+    f1 = aggregator.AsyncIncrement("row", "fam", "col", 1);
+    f2 = aggregator.AsyncIncrement("row", "fam", "col", 2);
+    f3 = aggregator.AsyncIncrement("row", "fam", "col", 3);
+    EXPECT_EQ(3, aggregator.increment_count());
+    EXPECT_EQ(0, aggregator.request_count());
+    // The destructor sends the pending increments.
+  }
+  EXPECT_EQ(101, f1.get());
+  EXPECT_EQ(103, f2.get());
+  EXPECT_EQ(106, f3.get());
+  EXPECT_THAT(increments, ElementsAre(6));
+}
+
+/// @test Verify that different counters use different requests.
+TEST_F(CounterAggregatorTest, DifferentCounters) {
+  std::vector<std::int64_t> increments;
+  EXPECT_CALL(*client_, ReadModifyWriteRow(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(SimulateCounter(0, increments)));
+
+  google::cloud::future<std::int64_t> f1, f2;
+  {
+    bigtable::CounterAggregator aggregator(table_, std::chrono::hours(1), 10,
+                                           1);
+    f1 = aggregator.AsyncIncrement("row", "fam", "c1", 1);
+    f2 = aggregator.AsyncIncrement("row", "fam", "c2", 2);
+  }
+  EXPECT_EQ(1, f1.get());
+  EXPECT_EQ(2, f2.get());
+  EXPECT_THAT(increments, UnorderedElementsAre(1, 2));
+}
+
+/// @test Verify that the increments are sent after the flush interval.
+TEST_F(CounterAggregatorTest, FlushInterval) {
+  std::vector<std::int64_t> increments;
+  EXPECT_CALL(*client_, ReadModifyWriteRow(_, _, _))
+      .WillOnce(Invoke(SimulateCounter(0, increments)));
+
+  bigtable::CounterAggregator aggregator(table_, std::chrono::milliseconds(5),
+                                         10, 2);
+  EXPECT_EQ(7, aggregator.Increment("row", "fam", "col", 7));
+  EXPECT_EQ(1, aggregator.request_count());
+}
+
+/// @test Verify that the oldest counter is sent when the limit is reached.
+TEST_F(CounterAggregatorTest, MaxCounters) {
+  std::vector<std::int64_t> increments;
+  EXPECT_CALL(*client_, ReadModifyWriteRow(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(SimulateCounter(10, increments)));
+
+  bigtable::CounterAggregator aggregator(table_, std::chrono::hours(1), 1, 1);
+  auto f1 = aggregator.AsyncIncrement("r1", "fam", "col", 1);
+  auto f2 = aggregator.AsyncIncrement("r2", "fam", "col", 2);
+  // The first counter is evicted and sent without waiting for the interval.
+  EXPECT_EQ(11, f1.get());
+  EXPECT_EQ(1, aggregator.request_count());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that errors are reported to all the callers.
+TEST_F(CounterAggregatorTest, PermanentFailure) {
+  EXPECT_CALL(*client_, ReadModifyWriteRow(_, _, _))
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh")));
+
+  google::cloud::future<std::int64_t> f1, f2;
+  {
+    bigtable::CounterAggregator aggregator(table_, std::chrono::hours(1), 10,
+                                           1);
+    f1 = aggregator.AsyncIncrement("row", "fam", "col", 1);
+    f2 = aggregator.AsyncIncrement("row", "fam", "col", 2);
+  }
+  EXPECT_THROW(f1.get(), bigtable::GRpcError);
+  EXPECT_THROW(f2.get(), bigtable::GRpcError);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -31,6 +31,7 @@ class Table;
 }  // namespace noex
 namespace internal {
 class AsyncBulkMutator;
+class AsyncRowStreamImpl;
 class AsyncSampleRowKeys;
 class BulkMutator;
 template <typename ReadRowCallback,
@@ -91,9 +92,11 @@ class DataClient {
   friend class Table;
   friend class noex::Table;
   friend class internal::AsyncBulkMutator;
+  friend class internal::AsyncRowStreamImpl;
   friend class internal::AsyncSampleRowKeys;
   friend class internal::BulkMutator;
   friend class RowReader;
+  friend class ColumnarReader;
   template <typename ReadRowCallback,
             typename std::enable_if<google::cloud::internal::is_invocable<
                                         ReadRowCallback, CompletionQueue&, Row,
@@ -15,6 +15,8 @@
 #include "google/cloud/bigtable/data_client.h"
 
 #include <gmock/gmock.h>
+#include <chrono>
+#include <thread>
 
 namespace bigtable = google::cloud::bigtable;
 
@@ -37,3 +39,60 @@ TEST(DataClientTest, Default) {
   EXPECT_TRUE(channel1);
   EXPECT_NE(channel0.get(), channel1.get());
 }
+
+namespace {
+/// Options to connect to an endpoint where (most likely) nothing listens.
+bigtable::ClientOptions UnreachableOptions() {
+  return bigtable::ClientOptions(grpc::InsecureChannelCredentials())
+      .set_data_endpoint("localhost:1")
+      .set_connection_pool_size(2);
+}
+
+/// Wait until @p client returns a channel other than @p channel.
+bool WaitForReplacement(std::shared_ptr<bigtable::DataClient> const& client,
+                        std::shared_ptr<grpc::Channel> const& channel) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (int i = 0; i != 2; ++i) {
+      if (client->Channel().get() != channel.get()) {
+        return true;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+}  // anonymous namespace
+
+TEST(DataClientTest, EagerConnectionTimeout) {
+  auto start = std::chrono::steady_clock::now();
+  auto data_client = bigtable::CreateDefaultDataClient(
+      "test-project", "test-instance",
+      UnreachableOptions()
+          .set_eager_connection(true)
+          .set_connection_timeout(std::chrono::milliseconds(100)));
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LE(std::chrono::milliseconds(100), elapsed);
+  EXPECT_GT(std::chrono::seconds(5), elapsed);
+  EXPECT_TRUE(data_client->Channel());
+}
+
+TEST(DataClientTest, ReplaceFailingChannels) {
+  auto data_client = bigtable::CreateDefaultDataClient(
+      "test-project", "test-instance",
+      UnreachableOptions()
+          .set_eager_connection(true)
+          .set_connection_timeout(std::chrono::milliseconds(10))
+          .set_max_transient_failure(std::chrono::milliseconds(50)));
+  auto channel = data_client->Channel();
+  EXPECT_TRUE(WaitForReplacement(data_client, channel));
+}
+
+TEST(DataClientTest, RefreshChannels) {
+  auto data_client = bigtable::CreateDefaultDataClient(
+      "test-project", "test-instance",
+      UnreachableOptions().set_channel_refresh_period(
+          std::chrono::milliseconds(50)));
+  auto channel = data_client->Channel();
+  EXPECT_TRUE(WaitForReplacement(data_client, channel));
+}
@@ -0,0 +1,47 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H_
+
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/hedging_policy.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Define the interface for controlling how `ReadRow()` requests are hedged.
+ *
+ * When a `Table` is configured with a hedging policy, `ReadRow()` and
+ * `AsyncReadRow()` send a duplicate request if the first request is slower
+ * than the delay returned by the policy, and use the first response.
+ *
+ * Unlike the other policies, the `Table` shares the policy object across all
+ * its requests (and with any copies of the `Table`), so the policy can observe
+ * the latency distribution and enforce a budget for the additional requests.
+ */
+using HedgingPolicy = google::cloud::internal::HedgingPolicy;
+
+/// Hedge requests slower than a given latency percentile.
+using PercentileHedgingPolicy =
+    google::cloud::internal::PercentileHedgingPolicy;
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_HEDGING_POLICY_H_
@@ -63,6 +63,35 @@ std::future<google::bigtable::admin::v2::Cluster> InstanceAdmin::CreateCluster(
                     std::move(cluster_config), instance_id, cluster_id);
 }
 
+future<btadmin::Instance> InstanceAdmin::AsyncCreateInstance(
+    CompletionQueue& cq, InstanceConfig instance_config) {
+  promise<btadmin::Instance> p;
+  auto result = p.get_future();
+
+  impl_.AsyncCreateInstance(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p),
+                                            "AsyncCreateInstance"),
+      std::move(instance_config));
+
+  return result;
+}
+
+future<btadmin::Cluster> InstanceAdmin::AsyncCreateCluster(
+    CompletionQueue& cq, ClusterConfig cluster_config,
+    bigtable::InstanceId const& instance_id,
+    bigtable::ClusterId const& cluster_id) {
+  promise<btadmin::Cluster> p;
+  auto result = p.get_future();
+
+  impl_.AsyncCreateCluster(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p), "AsyncCreateCluster"),
+      std::move(cluster_config), instance_id, cluster_id);
+
+  return result;
+}
+
 google::bigtable::admin::v2::Instance InstanceAdmin::CreateInstanceImpl(
     InstanceConfig instance_config) {
   // Copy the policies in effect for the operation.
@@ -108,6 +137,20 @@ InstanceAdmin::UpdateInstance(InstanceUpdateConfig instance_update_config) {
                     this, std::move(instance_update_config));
 }
 
+future<btadmin::Instance> InstanceAdmin::AsyncUpdateInstance(
+    CompletionQueue& cq, InstanceUpdateConfig instance_update_config) {
+  promise<btadmin::Instance> p;
+  auto result = p.get_future();
+
+  impl_.AsyncUpdateInstance(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p),
+                                            "AsyncUpdateInstance"),
+      std::move(instance_update_config));
+
+  return result;
+}
+
 google::bigtable::admin::v2::Instance InstanceAdmin::UpdateInstanceImpl(
     InstanceUpdateConfig instance_update_config) {
   // Copy the policies in effect for the operation.
@@ -232,6 +275,19 @@ std::future<google::bigtable::admin::v2::Cluster> InstanceAdmin::UpdateCluster(
                     std::move(cluster_config));
 }
 
+future<btadmin::Cluster> InstanceAdmin::AsyncUpdateCluster(
+    CompletionQueue& cq, ClusterConfig cluster_config) {
+  promise<btadmin::Cluster> p;
+  auto result = p.get_future();
+
+  impl_.AsyncUpdateCluster(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p), "AsyncUpdateCluster"),
+      std::move(cluster_config));
+
+  return result;
+}
+
 google::bigtable::admin::v2::Cluster InstanceAdmin::UpdateClusterImpl(
     ClusterConfig cluster_config) {
   // Copy the policies in effect for the operation.
@@ -305,6 +361,21 @@ std::future<btadmin::AppProfile> InstanceAdmin::UpdateAppProfile(
                     std::move(config));
 }
 
+future<btadmin::AppProfile> InstanceAdmin::AsyncUpdateAppProfile(
+    CompletionQueue& cq, bigtable::InstanceId const& instance_id,
+    bigtable::AppProfileId profile_id, AppProfileUpdateConfig config) {
+  promise<btadmin::AppProfile> p;
+  auto result = p.get_future();
+
+  impl_.AsyncUpdateAppProfile(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p),
+                                            "AsyncUpdateAppProfile"),
+      instance_id, std::move(profile_id), std::move(config));
+
+  return result;
+}
+
 std::vector<btadmin::AppProfile> InstanceAdmin::ListAppProfiles(
     std::string const& instance_id) {
   grpc::Status status;
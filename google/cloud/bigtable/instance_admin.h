@@ -104,12 +104,41 @@ class InstanceAdmin {
    *   time allocated by the retry policies has expired, in which case the
    *   future contains an exception of type `bigtable::PollTimeout`.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncCreateInstance()` when many operations are
+   *   in progress at the same time.
+   *
    * @par Example
    * @snippet bigtable_samples_instance_admin.cc create instance
    */
   std::future<google::bigtable::admin::v2::Instance> CreateInstance(
       InstanceConfig instance_config);
 
+  /**
+   * Create a new instance of Cloud Bigtable, without blocking any threads.
+   *
+   * The operation is polled using timers in @p cq, a single thread running
+   * the completion queue can track many of these operations.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param instance_config a description of the new instance to be created.
+   * @return a future that becomes satisfied when (a) the operation has
+   *   completed successfully, in which case it returns a proto with the
+   *   Instance details, (b) the operation has failed, in which case the future
+   *   contains an exception (typically `bigtable::GrpcError`) with the details
+   *   of the failure, or (c) the polling policy expires before the state of
+   *   the operation is known, in which case the future contains an exception
+   *   of type `bigtable::GrpcError`.
+   */
+  future<google::bigtable::admin::v2::Instance> AsyncCreateInstance(
+      CompletionQueue& cq, InstanceConfig instance_config);
+
   /**
    * Create a new Cluster of Cloud Bigtable.
    *
@@ -118,6 +147,10 @@ class InstanceAdmin {
    * @param cluster_id the id of the cluster in the project that needs to be
    *   created. It must be between 6 and 30 characters.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncCreateCluster()` when many operations are
+   *   in progress at the same time.
+   *
    *  @par Example
    *  @snippet bigtable_samples_instance_admin.cc create cluster
    */
@@ -125,6 +158,33 @@ class InstanceAdmin {
       ClusterConfig cluster_config, bigtable::InstanceId const& instance_id,
       bigtable::ClusterId const& cluster_id);
 
+  /**
+   * Create a new Cluster of Cloud Bigtable, without blocking any threads.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param cluster_config a description of the new cluster to be created.
+   * @param instance_id the id of the instance in the project
+   * @param cluster_id the id of the cluster in the project that needs to be
+   *   created. It must be between 6 and 30 characters.
+   * @return a future that becomes satisfied when (a) the operation has
+   *   completed successfully, in which case it returns a proto with the
+   *   Cluster details, (b) the operation has failed, in which case the future
+   *   contains an exception (typically `bigtable::GrpcError`) with the details
+   *   of the failure, or (c) the polling policy expires before the state of
+   *   the operation is known, in which case the future contains an exception
+   *   of type `bigtable::GrpcError`.
+   */
+  future<google::bigtable::admin::v2::Cluster> AsyncCreateCluster(
+      CompletionQueue& cq, ClusterConfig cluster_config,
+      bigtable::InstanceId const& instance_id,
+      bigtable::ClusterId const& cluster_id);
+
   /**
    * Update an existing instance of Cloud Bigtable.
    *
@@ -141,12 +201,39 @@ class InstanceAdmin {
    *   time allocated by the retry policies has expired, in which case the
    *   future contains an exception of type `bigtable::PollTimeout`.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncUpdateInstance()` when many operations are
+   *   in progress at the same time.
+   *
    * @par Example
    * @snippet bigtable_samples_instance_admin.cc update instance
    */
   std::future<google::bigtable::admin::v2::Instance> UpdateInstance(
       InstanceUpdateConfig instance_update_config);
 
+  /**
+   * Update an existing instance of Cloud Bigtable, without blocking any
+   * threads.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param instance_update_config config with modified instance.
+   * @return a future that becomes satisfied when (a) the operation has
+   *   completed successfully, in which case it returns a proto with the
+   *   Instance details, (b) the operation has failed, in which case the future
+   *   contains an exception (typically `bigtable::GrpcError`) with the details
+   *   of the failure, or (c) the polling policy expires before the state of
+   *   the operation is known, in which case the future contains an exception
+   *   of type `bigtable::GrpcError`.
+   */
+  future<google::bigtable::admin::v2::Instance> AsyncUpdateInstance(
+      CompletionQueue& cq, InstanceUpdateConfig instance_update_config);
+
   /**
    * Obtain the list of instances in the project.
    *
@@ -325,12 +412,39 @@ class InstanceAdmin {
    *   time allocated by the retry policies has expired, in which case the
    *   future contains an exception of type `bigtable::PollTimeout`.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncUpdateCluster()` when many operations are
+   *   in progress at the same time.
+   *
    * @par Example
    * @snippet bigtable_samples_instance_admin.cc update cluster
    */
   std::future<google::bigtable::admin::v2::Cluster> UpdateCluster(
       ClusterConfig cluster_config);
 
+  /**
+   * Update an existing cluster of Cloud Bigtable, without blocking any
+   * threads.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param cluster_config cluster with updated values.
+   * @return a future that becomes satisfied when (a) the operation has
+   *   completed successfully, in which case it returns a proto with the
+   *   Cluster details, (b) the operation has failed, in which case the future
+   *   contains an exception (typically `bigtable::GrpcError`) with the details
+   *   of the failure, or (c) the polling policy expires before the state of
+   *   the operation is known, in which case the future contains an exception
+   *   of type `bigtable::GrpcError`.
+   */
+  future<google::bigtable::admin::v2::Cluster> AsyncUpdateCluster(
+      CompletionQueue& cq, ClusterConfig cluster_config);
+
   /**
    * Deletes the specified cluster of an instance in the project.
    *
@@ -429,6 +543,10 @@ class InstanceAdmin {
    * @par Example
    * @snippet bigtable_samples_instance_admin.cc update app profile description
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncUpdateAppProfile()` when many operations
+   *   are in progress at the same time.
+   *
    * @par Example
    * @snippet bigtable_samples_instance_admin.cc update app profile routing any
    *
@@ -439,6 +557,31 @@ class InstanceAdmin {
       bigtable::InstanceId instance_id, bigtable::AppProfileId profile_id,
       AppProfileUpdateConfig config);
 
+  /**
+   * Update an existing application profile, without blocking any threads.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param instance_id the instance for the application profile.
+   * @param profile_id the id (not the full name) of the profile to update.
+   * @param config the changes to the application profile.
+   * @return a future that becomes satisfied when (a) the operation has
+   *   completed successfully, in which case it returns a proto with the
+   *   AppProfile details, (b) the operation has failed, in which case the
+   *   future contains an exception (typically `bigtable::GrpcError`) with the
+   *   details of the failure, or (c) the polling policy expires before the
+   *   state of the operation is known, in which case the future contains an
+   *   exception of type `bigtable::GrpcError`.
+   */
+  future<google::bigtable::admin::v2::AppProfile> AsyncUpdateAppProfile(
+      CompletionQueue& cq, bigtable::InstanceId const& instance_id,
+      bigtable::AppProfileId profile_id, AppProfileUpdateConfig config);
+
   /**
    * List the application profiles in an instance.
    *
@@ -14,7 +14,9 @@
 
 #include "google/cloud/bigtable/instance_admin.h"
 #include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
 #include "google/cloud/bigtable/testing/mock_instance_admin_client.h"
+#include "google/cloud/bigtable/testing/mock_response_reader.h"
 #include "google/cloud/internal/make_unique.h"
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
@@ -25,6 +27,8 @@ namespace btadmin = google::bigtable::admin::v2;
 namespace bigtable = google::cloud::bigtable;
 
 using MockAdminClient = bigtable::testing::MockInstanceAdminClient;
+using MockAsyncLongrunningOpReader =
+    bigtable::testing::MockAsyncResponseReader<google::longrunning::Operation>;
 
 std::string const kProjectId = "the-project";
 
@@ -157,6 +161,62 @@ struct MockRpcFactory {
   }
 };
 
+/// Create a reader for the request that starts a long running operation.
+std::unique_ptr<MockAsyncLongrunningOpReader> MakeStartOperationReader() {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  auto reader =
+      google::cloud::internal::make_unique<MockAsyncLongrunningOpReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](google::longrunning::Operation* response,
+                          grpc::Status* status, void*) {
+        response->set_name("operation-name");
+        *status = grpc::Status::OK;
+      }));
+  return reader;
+}
+
+/// Create a reader for an `AsyncGetOperation` returning a completed operation.
+template <typename Result>
+std::unique_ptr<MockAsyncLongrunningOpReader> MakeDoneOperationReader(
+    Result const& result) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  auto reader =
+      google::cloud::internal::make_unique<MockAsyncLongrunningOpReader>();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([result](google::longrunning::Operation* response,
+                                grpc::Status* status, void*) {
+        response->set_done(true);
+        auto any =
+            google::cloud::internal::make_unique<google::protobuf::Any>();
+        any->PackFrom(result);
+        response->set_allocated_response(any.release());
+        *status = grpc::Status::OK;
+      }));
+  return reader;
+}
+
+/// Return @p reader from `AsyncGetOperation()` for "operation-name".
+void ExpectAsyncGetOperation(MockAdminClient& client,
+                             MockAsyncLongrunningOpReader* reader) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  EXPECT_CALL(client, AsyncGetOperation(_, _, _))
+      .WillOnce(Invoke(
+          [reader](grpc::ClientContext*,
+                   google::longrunning::GetOperationRequest const& request,
+                   grpc::CompletionQueue*) {
+            EXPECT_EQ("operation-name", request.name());
+            // This is safe, see comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                google::longrunning::Operation>>(reader);
+          }));
+}
+
 }  // anonymous namespace
 
 /// @test Verify basic functionality in the `bigtable::InstanceAdmin` class.
@@ -2047,3 +2107,303 @@ TEST_F(InstanceAdminTest, TestIamPermissionsRecoverableError) {
 
   EXPECT_EQ(2U, permission_set.size());
 }
+
+/// @test Verify that `InstanceAdmin::AsyncCreateInstance` uses the queue.
+TEST_F(InstanceAdminTest, AsyncCreateInstance) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::InstanceAdmin tested(client_);
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto create_reader = MakeStartOperationReader();
+  EXPECT_CALL(*client_, AsyncCreateInstance(_, _, _))
+      .WillOnce(Invoke([&create_reader](
+                           grpc::ClientContext*,
+                           btadmin::CreateInstanceRequest const& request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("projects/the-project", request.parent());
+        EXPECT_EQ("test-instance", request.instance_id());
+        EXPECT_EQ("foo bar", request.instance().display_name());
+        EXPECT_EQ("projects/the-project/locations/a-zone",
+                  request.clusters().at("c1").location());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(create_reader.get());
+      }));
+
+  btadmin::Instance expected;
+  expected.set_name("projects/the-project/instances/test-instance");
+  expected.set_display_name("foo bar");
+  auto get_operation_reader = MakeDoneOperationReader(expected);
+  ExpectAsyncGetOperation(*client_, get_operation_reader.get());
+
+  auto future = tested.AsyncCreateInstance(
+      cq, bigtable::InstanceConfig(
+              bigtable::InstanceId("test-instance"),
+              bigtable::DisplayName("foo bar"),
+              {{"c1", {"a-zone", 3, bigtable::ClusterConfig::SSD}}}));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncCreateInstance
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncGetOperation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  auto actual = future.get();
+  std::string delta;
+  google::protobuf::util::MessageDifferencer differencer;
+  differencer.ReportDifferencesToString(&delta);
+  EXPECT_TRUE(differencer.Compare(expected, actual)) << delta;
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that `InstanceAdmin::AsyncCreateInstance` reports errors.
+TEST_F(InstanceAdminTest, AsyncCreateInstanceFailure) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::InstanceAdmin tested(client_);
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto create_reader =
+      google::cloud::internal::make_unique<MockAsyncLongrunningOpReader>();
+  EXPECT_CALL(*create_reader, Finish(_, _, _))
+      .WillOnce(Invoke(
+          [](google::longrunning::Operation*, grpc::Status* status, void*) {
+            *status = grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh");
+          }));
+  EXPECT_CALL(*client_, AsyncCreateInstance(_, _, _))
+      .WillOnce(Invoke([&create_reader](grpc::ClientContext*,
+                                        btadmin::CreateInstanceRequest const&,
+                                        grpc::CompletionQueue*) {
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(create_reader.get());
+      }));
+
+  auto future = tested.AsyncCreateInstance(
+      cq, bigtable::InstanceConfig(
+              bigtable::InstanceId("test-instance"),
+              bigtable::DisplayName("foo bar"),
+              {{"c1", {"a-zone", 3, bigtable::ClusterConfig::SSD}}}));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncCreateInstance
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  EXPECT_THROW(future.get(), bigtable::GRpcError);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+/// @test Verify that `InstanceAdmin::AsyncCreateCluster` uses the queue.
+TEST_F(InstanceAdminTest, AsyncCreateCluster) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::InstanceAdmin tested(client_);
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto create_reader = MakeStartOperationReader();
+  EXPECT_CALL(*client_, AsyncCreateCluster(_, _, _))
+      .WillOnce(Invoke([&create_reader](
+                           grpc::ClientContext*,
+                           btadmin::CreateClusterRequest const& request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("projects/the-project/instances/test-instance",
+                  request.parent());
+        EXPECT_EQ("other-cluster", request.cluster_id());
+        EXPECT_EQ("projects/the-project/locations/fake-zone",
+                  request.cluster().location());
+        EXPECT_EQ(10, request.cluster().serve_nodes());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(create_reader.get());
+      }));
+
+  btadmin::Cluster expected;
+  expected.set_name(
+      "projects/the-project/instances/test-instance/clusters/other-cluster");
+  expected.set_serve_nodes(10);
+  auto get_operation_reader = MakeDoneOperationReader(expected);
+  ExpectAsyncGetOperation(*client_, get_operation_reader.get());
+
+  auto future = tested.AsyncCreateCluster(
+      cq,
+      bigtable::ClusterConfig("fake-zone", 10, bigtable::ClusterConfig::SSD),
+      bigtable::InstanceId("test-instance"),
+      bigtable::ClusterId("other-cluster"));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncCreateCluster
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncGetOperation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  auto actual = future.get();
+  std::string delta;
+  google::protobuf::util::MessageDifferencer differencer;
+  differencer.ReportDifferencesToString(&delta);
+  EXPECT_TRUE(differencer.Compare(expected, actual)) << delta;
+}
+
+/// @test Verify that `InstanceAdmin::AsyncUpdateInstance` uses the queue.
+TEST_F(InstanceAdminTest, AsyncUpdateInstance) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::InstanceAdmin tested(client_);
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto update_reader = MakeStartOperationReader();
+  EXPECT_CALL(*client_, AsyncUpdateInstance(_, _, _))
+      .WillOnce(Invoke([&update_reader](
+                           grpc::ClientContext*,
+                           btadmin::PartialUpdateInstanceRequest const& request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("projects/the-project/instances/test-instance",
+                  request.instance().name());
+        EXPECT_EQ("foo bar", request.instance().display_name());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(update_reader.get());
+      }));
+
+  btadmin::Instance expected;
+  expected.set_name("projects/the-project/instances/test-instance");
+  expected.set_display_name("foo bar");
+  auto get_operation_reader = MakeDoneOperationReader(expected);
+  ExpectAsyncGetOperation(*client_, get_operation_reader.get());
+
+  auto future =
+      tested.AsyncUpdateInstance(cq, bigtable::InstanceUpdateConfig(expected));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncUpdateInstance
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncGetOperation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  auto actual = future.get();
+  std::string delta;
+  google::protobuf::util::MessageDifferencer differencer;
+  differencer.ReportDifferencesToString(&delta);
+  EXPECT_TRUE(differencer.Compare(expected, actual)) << delta;
+}
+
+/// @test Verify that `InstanceAdmin::AsyncUpdateCluster` uses the queue.
+TEST_F(InstanceAdminTest, AsyncUpdateCluster) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::InstanceAdmin tested(client_);
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto update_reader = MakeStartOperationReader();
+  EXPECT_CALL(*client_, AsyncUpdateCluster(_, _, _))
+      .WillOnce(Invoke([&update_reader](grpc::ClientContext*,
+                                        btadmin::Cluster const& request,
+                                        grpc::CompletionQueue*) {
+        EXPECT_EQ(
+            "projects/the-project/instances/test-instance/clusters/"
+            "test-cluster",
+            request.name());
+        EXPECT_EQ(7, request.serve_nodes());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(update_reader.get());
+      }));
+
+  btadmin::Cluster expected;
+  expected.set_name(
+      "projects/the-project/instances/test-instance/clusters/test-cluster");
+  expected.set_serve_nodes(7);
+  auto get_operation_reader = MakeDoneOperationReader(expected);
+  ExpectAsyncGetOperation(*client_, get_operation_reader.get());
+
+  auto future =
+      tested.AsyncUpdateCluster(cq, bigtable::ClusterConfig(expected));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncUpdateCluster
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncGetOperation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  auto actual = future.get();
+  std::string delta;
+  google::protobuf::util::MessageDifferencer differencer;
+  differencer.ReportDifferencesToString(&delta);
+  EXPECT_TRUE(differencer.Compare(expected, actual)) << delta;
+}
+
+/// @test Verify that `InstanceAdmin::AsyncUpdateAppProfile` uses the queue.
+TEST_F(InstanceAdminTest, AsyncUpdateAppProfile) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::InstanceAdmin tested(client_);
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto update_reader = MakeStartOperationReader();
+  EXPECT_CALL(*client_, AsyncUpdateAppProfile(_, _, _))
+      .WillOnce(Invoke([&update_reader](
+                           grpc::ClientContext*,
+                           btadmin::UpdateAppProfileRequest const& request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ(
+            "projects/the-project/instances/test-instance/appProfiles/"
+            "my-profile",
+            request.app_profile().name());
+        EXPECT_EQ("Test Profile", request.app_profile().description());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(update_reader.get());
+      }));
+
+  btadmin::AppProfile expected;
+  expected.set_name(
+      "projects/the-project/instances/test-instance/appProfiles/my-profile");
+  expected.set_description("Test Profile");
+  auto get_operation_reader = MakeDoneOperationReader(expected);
+  ExpectAsyncGetOperation(*client_, get_operation_reader.get());
+
+  auto future = tested.AsyncUpdateAppProfile(
+      cq, bigtable::InstanceId("test-instance"),
+      bigtable::AppProfileId("my-profile"),
+      bigtable::AppProfileUpdateConfig().set_description("Test Profile"));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncUpdateAppProfile
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncGetOperation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  auto actual = future.get();
+  std::string delta;
+  google::protobuf::util::MessageDifferencer differencer;
+  differencer.ReportDifferencesToString(&delta);
+  EXPECT_TRUE(differencer.Compare(expected, actual)) << delta;
+}
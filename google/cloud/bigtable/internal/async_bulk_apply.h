@@ -25,6 +25,11 @@
 #include "google/cloud/bigtable/table_strong_types.h"
 #include "google/cloud/internal/invoke_result.h"
 #include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -69,7 +74,7 @@ class AsyncRetryBulkApply : public AsyncRetryOp<ConstantIdempotencyPolicy,
                       std::shared_ptr<bigtable::DataClient> client,
                       bigtable::AppProfileId const& app_profile_id,
                       bigtable::TableId const& table_name, BulkMutation&& mut,
-                      Functor&& callback)
+                      Functor&& callback, int index_offset = 0)
       : AsyncRetryOp<ConstantIdempotencyPolicy, Functor, AsyncBulkMutator>(
             __func__, std::move(rpc_retry_policy),
             // BulkMutator is idempotent because it keeps track of idempotency
@@ -78,7 +83,180 @@ class AsyncRetryBulkApply : public AsyncRetryOp<ConstantIdempotencyPolicy,
             std::move(metadata_update_policy), std::forward<Functor>(callback),
             AsyncBulkMutator(client, std::move(app_profile_id),
                              std::move(table_name), idempotent_policy,
-                             std::forward<BulkMutation>(mut))) {}
+                             std::forward<BulkMutation>(mut), index_offset)) {}
+};
+
+/// The callback used for each batch in `AsyncSplitBulkApply`.
+using AsyncBulkApplyBatchCallback = std::function<void(
+    CompletionQueue&, std::vector<FailedMutation>&, grpc::Status&)>;
+
+/// Start an `AsyncRetryBulkApply` for one batch of an `AsyncSplitBulkApply`.
+using AsyncBulkApplyStartBatch = std::function<std::shared_ptr<AsyncOperation>(
+    CompletionQueue&, BulkMutationBatch, AsyncBulkApplyBatchCallback)>;
+
+/**
+ * Perform an AsyncBulkApply split in several concurrent requests.
+ *
+ * Each batch is sent, with its own retry loop, by the function provided in the
+ * constructor. At most `max_concurrent` batches are pending at a time, a new
+ * batch is started as soon as a pending batch completes. Once all the batches
+ * complete the callback receives the failures of all the batches, sorted by
+ * their index in the original `BulkMutation`, and the first error status, if
+ * any.
+ *
+ * @tparam Functor the type of the function-like object that will receive the
+ *     results. It must satisfy (using C++17 types):
+ *     static_assert(std::is_invocable_v<
+ *         Functor, CompletionQueue&, std::vector<FailedMutation>&,
+ *             grpc::Status&>);
+ */
+template <typename Functor,
+          typename std::enable_if<
+              google::cloud::internal::is_invocable<
+                  Functor, CompletionQueue&, std::vector<FailedMutation>&,
+                  grpc::Status&>::value,
+              int>::type valid_callback_type = 0>
+class AsyncSplitBulkApply
+    : public AsyncOperation,
+      public std::enable_shared_from_this<AsyncSplitBulkApply<Functor>> {
+ public:
+  AsyncSplitBulkApply(AsyncBulkApplyStartBatch start_batch,
+                      std::vector<BulkMutationBatch> batches,
+                      std::size_t max_concurrent, Functor&& callback)
+      : start_batch_(std::move(start_batch)),
+        batches_(std::move(batches)),
+        max_concurrent_((std::max)(max_concurrent, std::size_t(1))),
+        callback_(std::forward<Functor>(callback)),
+        operations_(batches_.size()),
+        completed_batches_(batches_.size()),
+        next_(0),
+        completed_(0),
+        cancelled_(false),
+        finished_(false) {}
+
+  std::shared_ptr<AsyncOperation> Start(CompletionQueue& cq) {
+    auto self = this->shared_from_this();
+    auto const initial = (std::min)(max_concurrent_, batches_.size());
+    for (std::size_t i = 0; i != initial; ++i) {
+      StartNext(cq);
+    }
+    return self;
+  }
+
+  void Cancel() override {
+    std::vector<std::shared_ptr<AsyncOperation>> pending;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      cancelled_ = true;
+      for (auto const& op : operations_) {
+        if (op) {
+          pending.push_back(op);
+        }
+      }
+    }
+    for (auto& op : pending) {
+      op->Cancel();
+    }
+  }
+
+ private:
+  void StartNext(CompletionQueue& cq) {
+    std::unique_lock<std::mutex> lk(mu_);
+    while (next_ != batches_.size() && cancelled_) {
+      // Report the batches that never started as cancelled.
+      CancelBatch(batches_[next_++]);
+      ++completed_;
+    }
+    if (next_ == batches_.size()) {
+      if (completed_ == batches_.size() && !finished_) {
+        finished_ = true;
+        lk.unlock();
+        Finish(cq);
+      }
+      return;
+    }
+    auto const index = next_++;
+    auto batch = std::move(batches_[index]);
+    lk.unlock();
+
+    auto self = this->shared_from_this();
+    auto op = start_batch_(
+        cq, std::move(batch),
+        [self, index](CompletionQueue& cq, std::vector<FailedMutation>& f,
+                      grpc::Status& status) {
+          self->OnBatchDone(cq, index, f, status);
+        });
+
+    lk.lock();
+    if (completed_batches_[index]) {
+      // The batch completed before `start_batch_` returned, do not keep a
+      // reference to it.
+      return;
+    }
+    operations_[index] = op;
+    bool const cancel = cancelled_;
+    lk.unlock();
+    if (cancel) {
+      op->Cancel();
+    }
+  }
+
+  void OnBatchDone(CompletionQueue& cq, std::size_t index,
+                   std::vector<FailedMutation>& failures,
+                   grpc::Status& status) {
+    std::unique_lock<std::mutex> lk(mu_);
+    std::move(failures.begin(), failures.end(), std::back_inserter(failures_));
+    if (!status.ok() && status_.ok()) {
+      status_ = status;
+    }
+    // The operation holds a reference to this object through the callback,
+    // release it to break the cycle.
+    operations_[index].reset();
+    completed_batches_[index] = true;
+    ++completed_;
+    lk.unlock();
+    StartNext(cq);
+  }
+
+  void CancelBatch(BulkMutationBatch& batch) {
+    google::bigtable::v2::MutateRowsRequest request;
+    batch.mutation.MoveTo(&request);
+    google::rpc::Status status;
+    status.set_code(grpc::StatusCode::CANCELLED);
+    status.set_message("Operation cancelled before this mutation was sent");
+    int index = batch.index_offset;
+    for (auto& entry : *request.mutable_entries()) {
+      failures_.emplace_back(SingleRowMutation(std::move(entry)), status,
+                             index++);
+    }
+    if (status_.ok()) {
+      status_ = grpc::Status(grpc::StatusCode::CANCELLED,
+                             "AsyncBulkApply() cancelled");
+    }
+  }
+
+  void Finish(CompletionQueue& cq) {
+    std::sort(failures_.begin(), failures_.end(),
+              [](FailedMutation const& a, FailedMutation const& b) {
+                return a.original_index() < b.original_index();
+              });
+    callback_(cq, failures_, status_);
+  }
+
+  AsyncBulkApplyStartBatch start_batch_;
+  std::vector<BulkMutationBatch> batches_;
+  std::size_t const max_concurrent_;
+  Functor callback_;
+
+  std::mutex mu_;
+  std::vector<std::shared_ptr<AsyncOperation>> operations_;
+  std::vector<bool> completed_batches_;
+  std::size_t next_;
+  std::size_t completed_;
+  bool cancelled_;
+  bool finished_;
+  std::vector<FailedMutation> failures_;
+  grpc::Status status_;
 };
 
 }  // namespace internal
@@ -0,0 +1,223 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_HEDGED_READ_ROW_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_HEDGED_READ_ROW_H_
+
+#include "google/cloud/bigtable/async_operation.h"
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/hedging_policy.h"
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/invoke_result.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+
+/// The callback used by each hedged `AsyncReadRow()` attempt.
+using HedgedReadRowCallback = std::function<void(
+    CompletionQueue&, std::pair<bool, Row>, grpc::Status const&)>;
+
+/// Start a new hedged `AsyncReadRow()` attempt.
+using HedgedReadRowAttempt = std::function<std::shared_ptr<AsyncOperation>(
+    CompletionQueue&, HedgedReadRowCallback)>;
+
+/**
+ * Read a single row, sending a duplicate request if the first one is slow.
+ *
+ * This class starts a first attempt immediately, and a timer for the delay
+ * returned by the `HedgingPolicy`. If the timer expires before the first
+ * attempt completes, and the policy has budget for it, a second attempt is
+ * started. Because `DataClient` rotates over its channels for each new request
+ * the second attempt uses a different channel than the first one (as long as
+ * the client has more than one channel).
+ *
+ * The first successful attempt wins, and the other attempt is cancelled. If
+ * an attempt fails while the other attempt is still pending, the operation
+ * waits for the other attempt before reporting the error.
+ *
+ * @tparam Functor the type of the function-like object that will receive the
+ *     results. It must satisfy (using C++17 types):
+ *     static_assert(std::is_invocable_v<
+ *         Functor, CompletionQueue&, std::pair<bool, Row>,
+ *             grpc::Status&>);
+ */
+template <typename Functor, typename std::enable_if<
+                                google::cloud::internal::is_invocable<
+                                    Functor, CompletionQueue&,
+                                    std::pair<bool, Row>, grpc::Status&>::value,
+                                int>::type valid_callback_type = 0>
+class AsyncHedgedReadRowOperation
+    : public AsyncOperation,
+      public std::enable_shared_from_this<
+          AsyncHedgedReadRowOperation<Functor>> {
+ public:
+  AsyncHedgedReadRowOperation(std::shared_ptr<HedgingPolicy> hedging_policy,
+                              HedgedReadRowAttempt attempt, Functor&& callback)
+      : hedging_policy_(std::move(hedging_policy)),
+        attempt_(std::move(attempt)),
+        callback_(std::forward<Functor>(callback)),
+        pending_(0),
+        done_(false),
+        cancelled_(false),
+        hedged_(false) {}
+
+  /**
+   * Start the first attempt and the hedging timer.
+   *
+   * @return a handle to cancel all the attempts.
+   */
+  std::shared_ptr<AsyncOperation> Start(CompletionQueue& cq) {
+    auto delay = hedging_policy_->HedgeDelay();
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      start_ = std::chrono::steady_clock::now();
+      pending_ = 1;
+    }
+    auto op = StartAttempt(cq, 0);
+    auto self = this->shared_from_this();
+    std::unique_lock<std::mutex> lk(mu_);
+    if (done_) {
+      return self;
+    }
+    operations_[0] = std::move(op);
+    if (delay.count() == 0) {
+      return self;
+    }
+    timer_ = cq.MakeRelativeTimer(
+        delay, [self](CompletionQueue& cq, AsyncTimerResult& result) {
+          self->OnTimer(cq, result.cancelled);
+        });
+    return self;
+  }
+
+  void Cancel() override {
+    std::unique_lock<std::mutex> lk(mu_);
+    cancelled_ = true;
+    auto timer = timer_;
+    auto first = operations_[0];
+    auto second = operations_[1];
+    lk.unlock();
+    if (timer) {
+      timer->Cancel();
+    }
+    if (first) {
+      first->Cancel();
+    }
+    if (second) {
+      second->Cancel();
+    }
+  }
+
+ private:
+  std::shared_ptr<AsyncOperation> StartAttempt(CompletionQueue& cq,
+                                               int index) {
+    auto self = this->shared_from_this();
+    return attempt_(cq, [self, index](CompletionQueue& cq,
+                                      std::pair<bool, Row> result,
+                                      grpc::Status const& status) {
+      self->OnAttemptDone(cq, index, std::move(result), status);
+    });
+  }
+
+  void OnTimer(CompletionQueue& cq, bool cancelled) {
+    std::unique_lock<std::mutex> lk(mu_);
+    timer_.reset();
+    if (cancelled || done_ || cancelled_) {
+      return;
+    }
+    if (!hedging_policy_->OnHedge()) {
+      return;
+    }
+    hedged_ = true;
+    ++pending_;
+    lk.unlock();
+    auto op = StartAttempt(cq, 1);
+    lk.lock();
+    if (done_) {
+      // The first attempt completed while the duplicate was being started.
+      lk.unlock();
+      op->Cancel();
+      return;
+    }
+    operations_[1] = op;
+    bool const cancel = cancelled_;
+    lk.unlock();
+    if (cancel) {
+      op->Cancel();
+    }
+  }
+
+  void OnAttemptDone(CompletionQueue& cq, int index,
+                     std::pair<bool, Row> result, grpc::Status const& status) {
+    std::unique_lock<std::mutex> lk(mu_);
+    --pending_;
+    if (done_) {
+      // The other attempt already reported a result, discard this one.
+      return;
+    }
+    if (!status.ok() && pending_ != 0) {
+      // Give the other attempt a chance to succeed.
+      return;
+    }
+    done_ = true;
+    auto timer = std::move(timer_);
+    // Release the attempts, they hold a reference to this object through their
+    // callbacks.
+    std::shared_ptr<AsyncOperation> attempts[2] = {std::move(operations_[0]),
+                                                   std::move(operations_[1])};
+    auto other = std::move(attempts[1 - index]);
+    bool const hedged = hedged_;
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_);
+    lk.unlock();
+    if (timer) {
+      timer->Cancel();
+    }
+    if (other) {
+      other->Cancel();
+    }
+    hedging_policy_->OnCompletion(latency, hedged, index == 1);
+    grpc::Status final_status = status;
+    callback_(cq, std::move(result), final_status);
+  }
+
+  std::shared_ptr<HedgingPolicy> hedging_policy_;
+  HedgedReadRowAttempt attempt_;
+  Functor callback_;
+
+  std::mutex mu_;
+  std::chrono::steady_clock::time_point start_;
+  std::shared_ptr<AsyncOperation> timer_;
+  std::shared_ptr<AsyncOperation> operations_[2];
+  int pending_;
+  bool done_;
+  bool cancelled_;
+  bool hedged_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_HEDGED_READ_ROW_H_
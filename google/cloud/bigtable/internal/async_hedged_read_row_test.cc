@@ -0,0 +1,239 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/async_hedged_read_row.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+
+/// A hedging policy with a fixed delay and budget, recording its calls.
+class FixedHedgingPolicy : public HedgingPolicy {
+ public:
+  FixedHedgingPolicy(std::chrono::milliseconds delay, bool allow_hedge)
+      : delay_(delay), allow_hedge_(allow_hedge) {}
+
+  std::unique_ptr<HedgingPolicy> clone() const override {
+    return std::unique_ptr<HedgingPolicy>(new FixedHedgingPolicy(*this));
+  }
+  std::chrono::milliseconds HedgeDelay() override { return delay_; }
+  bool OnHedge() override {
+    ++hedge_requests;
+    return allow_hedge_;
+  }
+  void OnCompletion(std::chrono::milliseconds, bool h, bool w) override {
+    ++completions;
+    hedged = h;
+    hedge_won = w;
+  }
+
+  int hedge_requests = 0;
+  int completions = 0;
+  bool hedged = false;
+  bool hedge_won = false;
+
+ private:
+  std::chrono::milliseconds delay_;
+  bool allow_hedge_;
+};
+
+/// An attempt that completes only when the test says so.
+class FakeAttempt : public AsyncOperation {
+ public:
+  explicit FakeAttempt(HedgedReadRowCallback cb)
+      : callback(std::move(cb)), cancelled(false) {}
+
+  void Cancel() override { cancelled = true; }
+
+  void Complete(CompletionQueue& cq, std::string row_key,
+                grpc::Status status) {
+    bool found = !row_key.empty();
+    callback(cq, std::make_pair(found, Row(std::move(row_key), {})), status);
+    callback = nullptr;
+  }
+
+  HedgedReadRowCallback callback;
+  bool cancelled;
+};
+
+class AsyncHedgedReadRowTest : public ::testing::Test {
+ protected:
+  AsyncHedgedReadRowTest()
+      : impl_(std::make_shared<bigtable::testing::MockCompletionQueue>()),
+        cq_(impl_) {}
+
+  std::shared_ptr<AsyncOperation> Start(
+      std::shared_ptr<HedgingPolicy> policy) {
+    auto attempt = [this](CompletionQueue&, HedgedReadRowCallback cb) {
+      attempts_.push_back(std::make_shared<FakeAttempt>(std::move(cb)));
+      return attempts_.back();
+    };
+    auto callback = [this](CompletionQueue&, std::pair<bool, Row> result,
+                           grpc::Status& status) {
+      ++callback_count_;
+      found_ = result.first;
+      row_key_ = result.second.row_key();
+      status_ = status;
+    };
+    using Operation = AsyncHedgedReadRowOperation<decltype(callback)>;
+    auto op = std::make_shared<Operation>(std::move(policy), attempt,
+                                          std::move(callback));
+    return op->Start(cq_);
+  }
+
+  std::shared_ptr<bigtable::testing::MockCompletionQueue> impl_;
+  CompletionQueue cq_;
+  std::vector<std::shared_ptr<FakeAttempt>> attempts_;
+  int callback_count_ = 0;
+  bool found_ = false;
+  std::string row_key_;
+  grpc::Status status_;
+};
+
+/// @test Verify that no duplicate request is sent when the first is fast.
+TEST_F(AsyncHedgedReadRowTest, FastRequest) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(10), true);
+  Start(policy);
+  ASSERT_EQ(1U, attempts_.size());
+  EXPECT_EQ(1U, impl_->size());
+
+  attempts_[0]->Complete(cq_, "r1", grpc::Status::OK);
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_TRUE(found_);
+  EXPECT_EQ("r1", row_key_);
+
+  // The timer was cancelled, and it fires with `ok == false`.
+  impl_->SimulateCompletion(cq_, false);
+  EXPECT_TRUE(impl_->empty());
+  EXPECT_EQ(1U, attempts_.size());
+  EXPECT_EQ(0, policy->hedge_requests);
+  EXPECT_EQ(1, policy->completions);
+  EXPECT_FALSE(policy->hedged);
+}
+
+/// @test Verify that a duplicate request is sent and can win.
+TEST_F(AsyncHedgedReadRowTest, HedgeWins) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(10), true);
+  Start(policy);
+  impl_->SimulateCompletion(cq_, true);
+  ASSERT_EQ(2U, attempts_.size());
+  EXPECT_EQ(1, policy->hedge_requests);
+
+  attempts_[1]->Complete(cq_, "r1", grpc::Status::OK);
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_TRUE(status_.ok());
+  EXPECT_TRUE(attempts_[0]->cancelled);
+  EXPECT_TRUE(policy->hedged);
+  EXPECT_TRUE(policy->hedge_won);
+
+  // The cancelled attempt reports its result, which is discarded.
+  attempts_[0]->Complete(cq_, "",
+                         grpc::Status(grpc::StatusCode::CANCELLED, "cancel"));
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_EQ(1, policy->completions);
+}
+
+/// @test Verify that a failure waits for the other attempt.
+TEST_F(AsyncHedgedReadRowTest, FailureWaitsForHedge) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(10), true);
+  Start(policy);
+  impl_->SimulateCompletion(cq_, true);
+  ASSERT_EQ(2U, attempts_.size());
+
+  attempts_[0]->Complete(
+      cq_, "", grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh"));
+  EXPECT_EQ(0, callback_count_);
+
+  attempts_[1]->Complete(cq_, "", grpc::Status::OK);
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_TRUE(status_.ok());
+  EXPECT_FALSE(found_);
+}
+
+/// @test Verify that both failures are reported once.
+TEST_F(AsyncHedgedReadRowTest, BothFail) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(10), true);
+  Start(policy);
+  impl_->SimulateCompletion(cq_, true);
+  ASSERT_EQ(2U, attempts_.size());
+
+  attempts_[1]->Complete(
+      cq_, "", grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh"));
+  EXPECT_EQ(0, callback_count_);
+  attempts_[0]->Complete(
+      cq_, "", grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh"));
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_EQ(grpc::StatusCode::PERMISSION_DENIED, status_.error_code());
+  EXPECT_FALSE(policy->hedge_won);
+}
+
+/// @test Verify that no duplicate request is sent without budget.
+TEST_F(AsyncHedgedReadRowTest, NoBudget) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(10), false);
+  Start(policy);
+  impl_->SimulateCompletion(cq_, true);
+  EXPECT_EQ(1U, attempts_.size());
+  EXPECT_EQ(1, policy->hedge_requests);
+
+  attempts_[0]->Complete(cq_, "r1", grpc::Status::OK);
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_FALSE(policy->hedged);
+}
+
+/// @test Verify that hedging is skipped when the policy returns no delay.
+TEST_F(AsyncHedgedReadRowTest, NoDelay) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(0), true);
+  Start(policy);
+  EXPECT_TRUE(impl_->empty());
+  ASSERT_EQ(1U, attempts_.size());
+  attempts_[0]->Complete(cq_, "r1", grpc::Status::OK);
+  EXPECT_EQ(1, callback_count_);
+}
+
+/// @test Verify that cancelling the operation cancels all the attempts.
+TEST_F(AsyncHedgedReadRowTest, Cancel) {
+  auto policy = std::make_shared<FixedHedgingPolicy>(
+      std::chrono::milliseconds(10), true);
+  auto op = Start(policy);
+  impl_->SimulateCompletion(cq_, true);
+  ASSERT_EQ(2U, attempts_.size());
+
+  op->Cancel();
+  EXPECT_TRUE(attempts_[0]->cancelled);
+  EXPECT_TRUE(attempts_[1]->cancelled);
+  attempts_[0]->Complete(cq_, "",
+                         grpc::Status(grpc::StatusCode::CANCELLED, "cancel"));
+  attempts_[1]->Complete(cq_, "",
+                         grpc::Status(grpc::StatusCode::CANCELLED, "cancel"));
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_EQ(grpc::StatusCode::CANCELLED, status_.error_code());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -108,8 +108,11 @@ class MultipageRetriableAdapter {
   template <typename AttemptFunctor>
   void OnCompletion(CompletionQueue& cq, bool finished, grpc::Status& status,
                     AttemptFunctor&& attempt_completed_callback) {
-    if (status.error_code() == grpc::StatusCode::CANCELLED) {
-      // Cancelled, no retry necessary.
+    if (status.error_code() == grpc::StatusCode::CANCELLED &&
+        rpc_retry_policy_->FinalStatus(status).error_code() ==
+            grpc::StatusCode::CANCELLED) {
+      // Cancelled, no retry necessary. If the retry policy cancelled the
+      // attempt, e.g. because a circuit breaker is open, report its error.
       Cancel(cq);
       attempt_completed_callback(cq, true);
       return;
@@ -127,6 +130,7 @@ class MultipageRetriableAdapter {
       rpc_backoff_policy_ = rpc_backoff_policy_prototype_->clone();
     }
     if (!rpc_retry_policy_->OnFailure(status)) {
+      status = rpc_retry_policy_->FinalStatus(status);
       std::string full_message =
           FullErrorMessageUnlocked(RPCRetryPolicy::IsPermanentFailure(status)
                                        ? "permanent error"
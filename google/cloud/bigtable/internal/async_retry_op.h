@@ -158,8 +158,11 @@ class RetriableLoopAdapter {
   template <typename AttemptFunctor>
   void OnCompletion(CompletionQueue& cq, grpc::Status& status,
                     AttemptFunctor&& attempt_completed_callback) {
-    if (status.error_code() == grpc::StatusCode::CANCELLED) {
-      // Cancelled, no retry necessary.
+    if (status.error_code() == grpc::StatusCode::CANCELLED &&
+        rpc_retry_policy_->FinalStatus(status).error_code() ==
+            grpc::StatusCode::CANCELLED) {
+      // Cancelled, no retry necessary. If the retry policy cancelled the
+      // attempt, e.g. because a circuit breaker is open, report its error.
       Cancel(cq);
       attempt_completed_callback(cq, true);
       return;
@@ -172,6 +175,7 @@ class RetriableLoopAdapter {
       return;
     }
     if (!idempotent_policy_.is_idempotent()) {
+      status = rpc_retry_policy_->FinalStatus(status);
       grpc::Status res_status(
           status.error_code(),
           FullErrorMessageUnlocked("non-idempotent operation failed", status),
@@ -182,6 +186,7 @@ class RetriableLoopAdapter {
       return;
     }
     if (!rpc_retry_policy_->OnFailure(status)) {
+      status = rpc_retry_policy_->FinalStatus(status);
       std::string full_message =
           FullErrorMessageUnlocked(RPCRetryPolicy::IsPermanentFailure(status)
                                        ? "permanent error"
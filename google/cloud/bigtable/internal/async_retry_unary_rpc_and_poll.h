@@ -101,7 +101,7 @@ class AsyncRetryAndPollUnaryRpc
         call_(call),
         request(std::move(request)),
         cancelled_(),
-        callback_(callback) {}
+        callback_(std::forward<Functor>(callback)) {}
 
   void Cancel() override {
     std::lock_guard<std::mutex> lk(mu_);
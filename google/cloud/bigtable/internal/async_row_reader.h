@@ -83,9 +83,8 @@ class AsyncRowReader {
                        google::bigtable::v2::ReadRowsResponse& response) {
     int processed_chunks_count_ = 0;
     while (processed_chunks_count_ < response.chunks_size()) {
-      parser_->HandleChunk(
-          std::move(*(response.mutable_chunks(processed_chunks_count_))),
-          status_);
+      parser_->HandleChunk(*response.mutable_chunks(processed_chunks_count_),
+                           status_);
       if (!status_.ok()) {
         // An error must result in a retry, so we return without calling the
         // callback function and check for status before finishing the call
@@ -121,10 +120,11 @@ class AsyncRowReader {
     if (!last_read_row_key_.empty()) {
       // We've returned some rows and need to make sure we don't
       // request them again.
-      row_set_ = row_set_.Intersect(RowRange::Open(last_read_row_key_, ""));
+      row_set_.RemoveRowsUpTo(last_read_row_key_);
     }
-    auto row_set_proto = row_set_.as_proto();
-    request.mutable_rows()->Swap(&row_set_proto);
+    // Move the row set into the request to avoid copying what can be a very
+    // large number of keys, it is moved back once the request is sent.
+    SwapRowSetProto(row_set_, *request.mutable_rows());
 
     auto filter_proto = filter_.as_proto();
     request.mutable_filter()->Swap(&filter_proto);
@@ -134,13 +134,15 @@ class AsyncRowReader {
     }
     context_ = google::cloud::internal::make_unique<grpc::ClientContext>();
 
-    return cq.MakeUnaryStreamRpc(
+    auto op = cq.MakeUnaryStreamRpc(
         *client_, &DataClient::AsyncReadRows, request, std::move(context),
         [this](CompletionQueue& cq, const grpc::ClientContext& context,
                google::bigtable::v2::ReadRowsResponse& response) {
           ProcessResponse(cq, response);
         },
         FinishedCallback<Functor>(*this, std::forward<Functor>(callback)));
+    SwapRowSetProto(row_set_, *request.mutable_rows());
+    return op;
   }
 
   bool AccumulatedResult() { return status_.ok(); }
@@ -0,0 +1,317 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/async_row_stream_impl.h"
+#include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace btproto = ::google::bigtable::v2;
+
+AsyncRowStreamImpl::AsyncRowStreamImpl(
+    CompletionQueue cq, std::shared_ptr<DataClient> client,
+    bigtable::AppProfileId app_profile_id, bigtable::TableId table_name,
+    std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+    std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+    MetadataUpdatePolicy metadata_update_policy, RowSet row_set,
+    std::int64_t rows_limit, Filter filter, std::size_t max_buffered_rows,
+    std::size_t max_buffered_bytes)
+    : cq_(std::move(cq)),
+      client_(std::move(client)),
+      app_profile_id_(std::move(app_profile_id)),
+      table_name_(std::move(table_name)),
+      rpc_retry_policy_(std::move(rpc_retry_policy)),
+      rpc_backoff_policy_(std::move(rpc_backoff_policy)),
+      metadata_update_policy_(std::move(metadata_update_policy)),
+      filter_(std::move(filter)),
+      max_buffered_rows_(max_buffered_rows),
+      max_buffered_bytes_(max_buffered_bytes),
+      row_set_(std::move(row_set)),
+      rows_limit_(rows_limit),
+      rows_count_(0),
+      reading_(false),
+      finished_(false),
+      cancelled_(false),
+      buffered_bytes_(0),
+      peak_buffered_bytes_(0) {}
+
+void AsyncRowStreamImpl::Start() { StartAttempt(); }
+
+future<std::vector<Row>> AsyncRowStreamImpl::NextBatch(std::size_t max_rows) {
+  promise<std::vector<Row>> p;
+  auto f = p.get_future();
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    waiters_.push_back(Waiter{(std::max)(max_rows, std::size_t(1)),
+                              std::move(p)});
+  }
+  Deliver();
+  return f;
+}
+
+void AsyncRowStreamImpl::Cancel() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (finished_ || cancelled_) {
+    return;
+  }
+  cancelled_ = true;
+  auto stream = stream_;
+  auto timer = timer_;
+  lk.unlock();
+  // The stream (or the timer) completes with an error, and OnFinish() (or
+  // StartAttempt()) reports the cancellation to any waiters.
+  if (stream) {
+    stream->Cancel();
+  }
+  if (timer) {
+    timer->Cancel();
+  }
+}
+
+std::size_t AsyncRowStreamImpl::buffered_rows() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return buffer_.size();
+}
+
+std::size_t AsyncRowStreamImpl::buffered_bytes() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return buffered_bytes_;
+}
+
+std::size_t AsyncRowStreamImpl::peak_buffered_bytes() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return peak_buffered_bytes_;
+}
+
+std::size_t AsyncRowStreamImpl::RowBytes(Row const& row) {
+  std::size_t bytes = sizeof(Row) + row.row_key().size();
+  for (auto const& cell : row.cells()) {
+    bytes += sizeof(Cell) + cell.row_key().size() + cell.family_name().size() +
+             cell.column_qualifier().size() + cell.value().size();
+    for (auto const& label : cell.labels()) {
+      bytes += sizeof(label) + label.size();
+    }
+  }
+  return bytes;
+}
+
+void AsyncRowStreamImpl::StartAttempt() {
+  btproto::ReadRowsRequest request;
+  request.set_app_profile_id(app_profile_id_.get());
+  request.set_table_name(table_name_.get());
+  auto filter_proto = filter_.as_proto();
+  request.mutable_filter()->Swap(&filter_proto);
+
+  std::unique_lock<std::mutex> lk(mu_);
+  timer_.reset();
+  if (cancelled_) {
+    lk.unlock();
+    Fail(grpc::Status(grpc::StatusCode::CANCELLED, "stream cancelled"));
+    return;
+  }
+  if (!last_read_row_key_.empty()) {
+    // Do not request the rows already received again.
+    row_set_.RemoveRowsUpTo(last_read_row_key_);
+  }
+  if (row_set_.IsEmpty() || (rows_limit_ != 0 && rows_limit_ <= rows_count_)) {
+    finished_ = true;
+    lk.unlock();
+    Deliver();
+    return;
+  }
+  // Move the row set into the request to avoid copying what can be a very
+  // large number of keys, it is moved back once the request is sent. Only
+  // this function uses the row set, and it never runs concurrently.
+  SwapRowSetProto(row_set_, *request.mutable_rows());
+  if (rows_limit_ != 0) {
+    request.set_rows_limit(rows_limit_ - rows_count_);
+  }
+  lk.unlock();
+
+  parser_ = ReadRowsParserFactory().Create();
+  parser_status_ = grpc::Status::OK;
+  auto context = google::cloud::internal::make_unique<grpc::ClientContext>();
+  rpc_retry_policy_->Setup(*context);
+  rpc_backoff_policy_->Setup(*context);
+  metadata_update_policy_.Setup(*context);
+
+  auto self = shared_from_this();
+  auto stream = cq_.MakePullStreamRpc(
+      *client_, &DataClient::AsyncReadRows, request, std::move(context),
+      [self](CompletionQueue&, grpc::ClientContext const&,
+             btproto::ReadRowsResponse& response) {
+        self->OnResponse(response);
+      },
+      [self](CompletionQueue&, grpc::ClientContext&, grpc::Status& status) {
+        self->OnFinish(status);
+      });
+
+  lk.lock();
+  SwapRowSetProto(row_set_, *request.mutable_rows());
+  stream_ = stream;
+  bool const cancelled = cancelled_;
+  lk.unlock();
+  if (cancelled) {
+    // Cancel() was called before stream_ was set.
+    stream->Cancel();
+    return;
+  }
+  MaybeRequestNext();
+}
+
+void AsyncRowStreamImpl::OnResponse(btproto::ReadRowsResponse& response) {
+  std::vector<Row> rows;
+  for (auto& chunk : *response.mutable_chunks()) {
+    parser_->HandleChunk(chunk, parser_status_);
+    if (!parser_status_.ok()) {
+      break;
+    }
+    if (parser_->HasNext()) {
+      rows.push_back(parser_->Next(parser_status_));
+      if (!parser_status_.ok()) {
+        rows.pop_back();
+        break;
+      }
+    }
+  }
+
+  std::unique_lock<std::mutex> lk(mu_);
+  reading_ = false;
+  for (auto& row : rows) {
+    ++rows_count_;
+    last_read_row_key_ = std::string(row.row_key());
+    buffered_bytes_ += RowBytes(row);
+    buffer_.push_back(std::move(row));
+  }
+  peak_buffered_bytes_ = (std::max)(peak_buffered_bytes_, buffered_bytes_);
+  auto stream = stream_;
+  lk.unlock();
+  if (!parser_status_.ok() && stream) {
+    // Stop this stream, OnFinish() retries after the last complete row.
+    stream->Cancel();
+    return;
+  }
+  Deliver();
+}
+
+void AsyncRowStreamImpl::OnFinish(grpc::Status status) {
+  std::unique_lock<std::mutex> lk(mu_);
+  stream_.reset();
+  reading_ = false;
+  if (cancelled_) {
+    lk.unlock();
+    Fail(grpc::Status(grpc::StatusCode::CANCELLED, "stream cancelled"));
+    return;
+  }
+  lk.unlock();
+
+  if (!parser_status_.ok()) {
+    status = grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                          "Some rows were not returned");
+  } else if (status.ok()) {
+    parser_->HandleEndOfStream(status);
+  }
+  if (status.ok()) {
+    lk.lock();
+    finished_ = true;
+    lk.unlock();
+    Deliver();
+    return;
+  }
+
+  lk.lock();
+  bool const limit_reached = rows_limit_ != 0 && rows_limit_ <= rows_count_;
+  lk.unlock();
+  if (limit_reached || !rpc_retry_policy_->OnFailure(status)) {
+    Fail(rpc_retry_policy_->FinalStatus(status));
+    return;
+  }
+  auto delay = rpc_backoff_policy_->OnCompletion(status);
+  auto self = shared_from_this();
+  auto timer = cq_.MakeRelativeTimer(
+      delay, [self](CompletionQueue&, AsyncTimerResult&) {
+        self->StartAttempt();
+      });
+  lk.lock();
+  timer_ = std::move(timer);
+}
+
+void AsyncRowStreamImpl::Fail(grpc::Status const& status) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    finished_ = true;
+    error_ = std::make_exception_ptr(GRpcError("AsyncReadRows", status));
+  }
+  Deliver();
+}
+
+void AsyncRowStreamImpl::Deliver() {
+  struct Ready {
+    promise<std::vector<Row>> result;
+    std::vector<Row> rows;
+    std::exception_ptr error;
+  };
+  std::vector<Ready> ready;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    while (!waiters_.empty() && (!buffer_.empty() || finished_)) {
+      auto& w = waiters_.front();
+      Ready r{std::move(w.result), {}, nullptr};
+      while (!buffer_.empty() && r.rows.size() < w.max_rows) {
+        buffered_bytes_ -= RowBytes(buffer_.front());
+        r.rows.push_back(std::move(buffer_.front()));
+        buffer_.pop_front();
+      }
+      // Report errors only once all the rows received are delivered.
+      if (r.rows.empty()) {
+        r.error = error_;
+      }
+      waiters_.pop_front();
+      ready.push_back(std::move(r));
+    }
+  }
+  // Satisfy the promises without holding the lock, they may run callbacks.
+  for (auto& r : ready) {
+    if (r.error) {
+      r.result.set_exception(r.error);
+    } else {
+      r.result.set_value(std::move(r.rows));
+    }
+  }
+  MaybeRequestNext();
+}
+
+void AsyncRowStreamImpl::MaybeRequestNext() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!stream_ || reading_ || cancelled_ ||
+      buffer_.size() >= max_buffered_rows_ ||
+      buffered_bytes_ >= max_buffered_bytes_) {
+    return;
+  }
+  reading_ = true;
+  auto stream = stream_;
+  lk.unlock();
+  stream->RequestNext();
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
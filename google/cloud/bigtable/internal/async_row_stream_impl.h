@@ -0,0 +1,144 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_ROW_STREAM_IMPL_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_ROW_STREAM_IMPL_H_
+
+#include "google/cloud/bigtable/bigtable_strong_types.h"
+#include "google/cloud/bigtable/completion_queue.h"
+#include "google/cloud/bigtable/data_client.h"
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/internal/readrowsparser.h"
+#include "google/cloud/bigtable/metadata_update_policy.h"
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/row_set.h"
+#include "google/cloud/bigtable/rpc_backoff_policy.h"
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/bigtable/table_strong_types.h"
+#include "google/cloud/future.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Implement `bigtable::AsyncRowStream`.
+ *
+ * The rows received from the service are kept in a buffer until the
+ * application asks for them. A new response is only read from the stream
+ * while the buffer is below both limits, so the buffer never holds more than
+ * the limits plus the rows in one `ReadRowsResponse`. Each row removed by the
+ * application returns some credit, and may trigger the next read.
+ *
+ * Failed streams are resumed after the last row received, using the retry
+ * and backoff policies, just like `RowReader`.
+ *
+ * The callbacks of the stream hold a reference to this object, so it lives
+ * until the stream finishes. Use `Cancel()` to finish it early.
+ */
+class AsyncRowStreamImpl
+    : public std::enable_shared_from_this<AsyncRowStreamImpl> {
+ public:
+  AsyncRowStreamImpl(CompletionQueue cq, std::shared_ptr<DataClient> client,
+                     bigtable::AppProfileId app_profile_id,
+                     bigtable::TableId table_name,
+                     std::unique_ptr<RPCRetryPolicy> rpc_retry_policy,
+                     std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy,
+                     MetadataUpdatePolicy metadata_update_policy,
+                     RowSet row_set, std::int64_t rows_limit, Filter filter,
+                     std::size_t max_buffered_rows,
+                     std::size_t max_buffered_bytes);
+
+  /// Send the first request, must be called once after construction.
+  void Start();
+
+  /**
+   * Return up to @p max_rows rows, waiting for at least one.
+   *
+   * The future is satisfied with an empty vector at the end of the stream.
+   */
+  future<std::vector<Row>> NextBatch(std::size_t max_rows);
+
+  /// Stop reading from the stream, the pending requests fail with `CANCELLED`.
+  void Cancel();
+
+  std::size_t buffered_rows() const;
+  std::size_t buffered_bytes() const;
+  std::size_t peak_buffered_bytes() const;
+
+  /// The approximate memory used by @p row.
+  static std::size_t RowBytes(Row const& row);
+
+ private:
+  struct Waiter {
+    std::size_t max_rows;
+    promise<std::vector<Row>> result;
+  };
+
+  void StartAttempt();
+  void OnResponse(google::bigtable::v2::ReadRowsResponse& response);
+  void OnFinish(grpc::Status status);
+  void Fail(grpc::Status const& status);
+  /// Satisfy any waiters that can be satisfied, then read more if possible.
+  void Deliver();
+  void MaybeRequestNext();
+
+  CompletionQueue cq_;
+  std::shared_ptr<DataClient> client_;
+  bigtable::AppProfileId app_profile_id_;
+  bigtable::TableId table_name_;
+  std::unique_ptr<RPCRetryPolicy> rpc_retry_policy_;
+  std::unique_ptr<RPCBackoffPolicy> rpc_backoff_policy_;
+  MetadataUpdatePolicy metadata_update_policy_;
+  Filter filter_;
+  std::size_t const max_buffered_rows_;
+  std::size_t const max_buffered_bytes_;
+
+  // Only used by the stream callbacks, which never run concurrently.
+  std::unique_ptr<ReadRowsParser> parser_;
+  grpc::Status parser_status_;
+
+  mutable std::mutex mu_;
+  RowSet row_set_;
+  std::int64_t rows_limit_;
+  std::int64_t rows_count_;
+  std::string last_read_row_key_;
+  std::shared_ptr<AsyncPullStreamOperation> stream_;
+  std::shared_ptr<AsyncOperation> timer_;
+  bool reading_;
+  bool finished_;
+  bool cancelled_;
+  std::exception_ptr error_;
+  std::deque<Row> buffer_;
+  std::size_t buffered_bytes_;
+  std::size_t peak_buffered_bytes_;
+  std::deque<Waiter> waiters_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_ASYNC_ROW_STREAM_IMPL_H_
@@ -26,10 +26,57 @@ namespace internal {
 
 namespace btproto = google::bigtable::v2;
 
+std::vector<BulkMutationBatch> SplitBulkMutation(
+    BulkMutation&& mut, BulkApplyOptions const& options) {
+  btproto::MutateRowsRequest request;
+  mut.MoveTo(&request);
+
+  std::vector<BulkMutationBatch> batches;
+  batches.push_back(BulkMutationBatch{BulkMutation(), 0});
+  std::size_t entries = 0;
+  std::size_t mutations = 0;
+  std::size_t bytes = 0;
+  int index = 0;
+  for (auto& entry : *request.mutable_entries()) {
+    std::size_t const entry_mutations = entry.mutations_size();
+    std::size_t const entry_bytes = entry.ByteSizeLong();
+    bool const full =
+        entries + 1 > options.max_entries_per_request() ||
+        mutations + entry_mutations > options.max_mutations_per_request() ||
+        bytes + entry_bytes > options.max_bytes_per_request();
+    if (entries != 0 && full) {
+      batches.push_back(BulkMutationBatch{BulkMutation(), index});
+      entries = 0;
+      mutations = 0;
+      bytes = 0;
+    }
+    batches.back().mutation.emplace_back(SingleRowMutation(std::move(entry)));
+    ++entries;
+    mutations += entry_mutations;
+    bytes += entry_bytes;
+    ++index;
+  }
+  return batches;
+}
+
+std::vector<std::string> BulkMutationRowKeys(BulkMutation& mut) {
+  // BulkMutation does not expose its entries, move them out and back, this
+  // does not copy the mutations.
+  btproto::MutateRowsRequest request;
+  mut.MoveTo(&request);
+  std::vector<std::string> row_keys;
+  row_keys.reserve(request.entries_size());
+  for (auto& entry : *request.mutable_entries()) {
+    row_keys.push_back(entry.row_key());
+    mut.emplace_back(SingleRowMutation(std::move(entry)));
+  }
+  return row_keys;
+}
+
 BulkMutator::BulkMutator(bigtable::AppProfileId const& app_profile_id,
                          bigtable::TableId const& table_name,
                          IdempotentMutationPolicy& idempotent_policy,
-                         BulkMutation&& mut) {
+                         BulkMutation&& mut, int index_offset) {
   // Every time the client library calls MakeOneRequest(), the data in the
   // "pending_*" variables initializes the next request.  So in the constructor
   // we start by putting the data on the "pending_*" variables.
@@ -44,7 +91,7 @@ BulkMutator::BulkMutator(bigtable::AppProfileId const& app_profile_id,
   // in the original sequence provided by the user.  So this vector maps from
   // the index in the current array to the index in the original array.
   pending_annotations_.reserve(pending_mutations_.entries_size());
-  int index = 0;
+  int index = index_offset;
   for (auto const& e : pending_mutations_.entries()) {
     // This is a giant && across all the mutations for each row.
     auto r = std::all_of(e.mutations().begin(), e.mutations().end(),
@@ -17,24 +17,53 @@
 
 #include "google/cloud/bigtable/async_operation.h"
 #include "google/cloud/bigtable/bigtable_strong_types.h"
+#include "google/cloud/bigtable/bulk_apply_options.h"
 #include "google/cloud/bigtable/completion_queue.h"
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/idempotent_mutation_policy.h"
 #include "google/cloud/bigtable/table_strong_types.h"
 #include "google/cloud/internal/invoke_result.h"
 #include "google/cloud/internal/make_unique.h"
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
+/// A piece of a `BulkMutation` and the index of its first row in the original.
+struct BulkMutationBatch {
+  BulkMutation mutation;
+  int index_offset;
+};
+
+/**
+ * Split @p mut into batches that satisfy the limits in @p options.
+ *
+ * The batches preserve the order of the mutations. A single row that exceeds
+ * the limits on its own is placed in a batch by itself. An empty `BulkMutation`
+ * results in a single empty batch.
+ */
+std::vector<BulkMutationBatch> SplitBulkMutation(
+    BulkMutation&& mut, BulkApplyOptions const& options);
+
+/// Return the row keys modified by @p mut, in order.
+std::vector<std::string> BulkMutationRowKeys(BulkMutation& mut);
+
 /// Keep the state in the Table::BulkApply() member function.
 class BulkMutator {
  public:
+  /**
+   * Create a mutator for @p mut.
+   *
+   * @param index_offset added to the index of each mutation when reporting
+   *     failures. Used when @p mut is a piece of a larger `BulkMutation`.
+   */
   BulkMutator(bigtable::AppProfileId const& app_profile_id,
               bigtable::TableId const& table_name,
-              IdempotentMutationPolicy& idempotent_policy, BulkMutation&& mut);
+              IdempotentMutationPolicy& idempotent_policy, BulkMutation&& mut,
+              int index_offset = 0);
 
   /// Return true if there are pending mutations in the mutator
   bool HasPendingMutations() const {
@@ -108,9 +137,9 @@ class AsyncBulkMutator : private BulkMutator {
                    bigtable::AppProfileId const& app_profile_id,
                    bigtable::TableId const& table_name,
                    IdempotentMutationPolicy& idempotent_policy,
-                   BulkMutation&& mut)
+                   BulkMutation&& mut, int index_offset = 0)
       : BulkMutator(app_profile_id, table_name, idempotent_policy,
-                    std::move(mut)),
+                    std::move(mut), index_offset),
         client_(std::move(client)) {}
 
   using Request = google::bigtable::v2::MutateRowsRequest;
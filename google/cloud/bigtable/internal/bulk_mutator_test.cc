@@ -598,3 +598,107 @@ TEST(MultipleRowsMutatorTest, SimpleAsyncFailure) {
   // callback fired
   EXPECT_TRUE(mutator_finished);
 }
+
+/// @test Verify that SplitBulkMutation() respects the entry limits.
+TEST(MultipleRowsMutatorTest, SplitByEntries) {
+  bt::BulkMutation mut;
+  for (int i = 0; i != 5; ++i) {
+    mut.emplace_back(bt::SingleRowMutation(
+        "row" + std::to_string(i), {bt::SetCell("fam", "col", 0_ms, "v")}));
+  }
+  auto batches = bt::internal::SplitBulkMutation(
+      std::move(mut), bt::BulkApplyOptions().set_max_entries_per_request(2));
+  ASSERT_EQ(3UL, batches.size());
+  std::vector<int> offsets;
+  std::vector<int> sizes;
+  for (auto& b : batches) {
+    offsets.push_back(b.index_offset);
+    btproto::MutateRowsRequest request;
+    b.mutation.MoveTo(&request);
+    sizes.push_back(request.entries_size());
+  }
+  EXPECT_THAT(offsets, ElementsAre(0, 2, 4));
+  EXPECT_THAT(sizes, ElementsAre(2, 2, 1));
+}
+
+/// @test Verify that SplitBulkMutation() respects the mutation and byte limits.
+TEST(MultipleRowsMutatorTest, SplitByMutationsAndBytes) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("r0", {bt::SetCell("fam", "c0", 0_ms, "v"),
+                                   bt::SetCell("fam", "c1", 0_ms, "v")}),
+      bt::SingleRowMutation("r1", {bt::SetCell("fam", "c0", 0_ms, "v"),
+                                   bt::SetCell("fam", "c1", 0_ms, "v"),
+                                   bt::SetCell("fam", "c2", 0_ms, "v")}),
+      bt::SingleRowMutation("r2", {bt::SetCell("fam", "c0", 0_ms, "v")}));
+  auto batches = bt::internal::SplitBulkMutation(
+      std::move(mut), bt::BulkApplyOptions().set_max_mutations_per_request(2));
+  // The second row exceeds the limit on its own, it gets its own batch.
+  ASSERT_EQ(3UL, batches.size());
+  EXPECT_EQ(0, batches[0].index_offset);
+  EXPECT_EQ(1, batches[1].index_offset);
+  EXPECT_EQ(2, batches[2].index_offset);
+
+  bt::BulkMutation large(
+      bt::SingleRowMutation("r0", {bt::SetCell("fam", "col", 0_ms,
+                                               std::string(1000, 'a'))}),
+      bt::SingleRowMutation("r1", {bt::SetCell("fam", "col", 0_ms, "small")}),
+      bt::SingleRowMutation("r2", {bt::SetCell("fam", "col", 0_ms, "small")}));
+  batches = bt::internal::SplitBulkMutation(
+      std::move(large), bt::BulkApplyOptions().set_max_bytes_per_request(500));
+  ASSERT_EQ(2UL, batches.size());
+  EXPECT_EQ(0, batches[0].index_offset);
+  EXPECT_EQ(1, batches[1].index_offset);
+}
+
+/// @test Verify that SplitBulkMutation() keeps small mutations in one batch.
+TEST(MultipleRowsMutatorTest, SplitNotNeeded) {
+  auto batches = bt::internal::SplitBulkMutation(bt::BulkMutation(),
+                                                 bt::BulkApplyOptions());
+  ASSERT_EQ(1UL, batches.size());
+  EXPECT_TRUE(batches[0].mutation.empty());
+
+  batches = bt::internal::SplitBulkMutation(
+      bt::BulkMutation(
+          bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "v")}),
+          bt::SingleRowMutation("bar",
+                                {bt::SetCell("fam", "col", 0_ms, "v")})),
+      bt::BulkApplyOptions());
+  ASSERT_EQ(1UL, batches.size());
+  EXPECT_EQ(0, batches[0].index_offset);
+}
+
+/// @test Verify that BulkMutator reports failures using the index offset.
+TEST(MultipleRowsMutatorTest, IndexOffset) {
+  bt::BulkMutation mut(
+      bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "baz")}),
+      bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "qux")}));
+
+  auto r1 = google::cloud::internal::make_unique<MockMutateRowsReader>();
+  EXPECT_CALL(*r1, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        auto& e0 = *r->add_entries();
+        e0.set_index(0);
+        e0.mutable_status()->set_code(grpc::StatusCode::OK);
+        auto& e1 = *r->add_entries();
+        e1.set_index(1);
+        e1.mutable_status()->set_code(grpc::StatusCode::OUT_OF_RANGE);
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*r1, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  bigtable::testing::MockDataClient client;
+  EXPECT_CALL(client, MutateRows(_, _))
+      .WillOnce(Invoke(r1.release()->MakeMockReturner()));
+
+  auto policy = bt::DefaultIdempotentMutationPolicy();
+  bt::internal::BulkMutator mutator(bigtable::AppProfileId(""),
+                                    bigtable::TableId("foo/bar/baz/table"),
+                                    *policy, std::move(mut), 10);
+  grpc::ClientContext context;
+  EXPECT_TRUE(mutator.MakeOneRequest(client, context).ok());
+  auto failures = mutator.ExtractFinalFailures();
+  ASSERT_EQ(1UL, failures.size());
+  EXPECT_EQ(11, failures[0].original_index());
+  EXPECT_EQ("bar", failures[0].mutation().row_key());
+}
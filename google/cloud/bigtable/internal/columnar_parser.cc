@@ -0,0 +1,259 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/columnar_parser.h"
+#include "google/cloud/internal/big_endian.h"
+#include <algorithm>
+#include <cstring>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+using google::bigtable::v2::ReadRowsResponse_CellChunk;
+
+ColumnarParser::ColumnarParser(std::vector<ColumnSpec> schema)
+    : schema_(std::move(schema)),
+      column_(-1),
+      capture_(false),
+      row_in_progress_(false),
+      pending_int64_(schema_.size()),
+      seen_(schema_.size()),
+      cell_first_chunk_(true),
+      end_of_stream_(false) {}
+
+void ColumnarParser::StartBatch(std::vector<ColumnSpec> const& schema,
+                                ColumnarBatch& batch) {
+  batch.row_count_ = 0;
+  batch.row_keys_data_.clear();
+  batch.row_key_offsets_.assign(1, 0);
+  // Keep the existing columns, and their buffers, if the batch is reused.
+  batch.columns_.resize(schema.size());
+  for (std::size_t i = 0; i != schema.size(); ++i) {
+    auto& column = batch.columns_[i];
+    column.type_ = schema[i].type;
+    column.size_ = 0;
+    column.null_count_ = 0;
+    column.raw_begin_ = 0;
+    column.validity_.clear();
+    column.int64_values_.clear();
+    column.bytes_data_.clear();
+    column.offsets_.assign(1, 0);
+  }
+}
+
+void ColumnarParser::FinishBatch(ColumnarBatch& batch) {
+  for (auto& column : batch.columns_) {
+    if (column.type_ != ColumnType::INT64) {
+      continue;
+    }
+    google::cloud::internal::FromBigEndianArray(
+        column.int64_values_.data() + column.raw_begin_,
+        column.size_ - column.raw_begin_);
+    column.raw_begin_ = column.size_;
+  }
+}
+
+void ColumnarParser::HandleChunk(ReadRowsResponse_CellChunk& chunk,
+                                 ColumnarBatch& batch, grpc::Status& status) {
+  if (end_of_stream_) {
+    status = grpc::Status(grpc::StatusCode::INTERNAL,
+                          "HandleChunk after end of stream");
+    return;
+  }
+
+  if (!chunk.row_key().empty()) {
+    if (last_seen_row_key_.compare(chunk.row_key()) >= 0) {
+      status = grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Row keys are expected in increasing order");
+      return;
+    }
+    chunk.mutable_row_key()->swap(cell_row_);
+  }
+
+  if (chunk.has_family_name()) {
+    if (!chunk.has_qualifier()) {
+      status = grpc::Status(grpc::StatusCode::INTERNAL,
+                            "New column family must specify qualifier");
+      return;
+    }
+    chunk.mutable_family_name()->mutable_value()->swap(family_);
+  }
+
+  if (chunk.has_qualifier()) {
+    chunk.mutable_qualifier()->mutable_value()->swap(qualifier_);
+    LookupColumn();
+  }
+
+  if (cell_first_chunk_) {
+    // The cells in a column are sorted by decreasing timestamp, only the first
+    // cell for each column in the row is captured.
+    capture_ = column_ >= 0 && seen_[column_] == 0;
+    int64_value_.clear();
+  }
+
+  if (capture_) {
+    if (schema_[column_].type == ColumnType::INT64) {
+      int64_value_.append(chunk.value());
+    } else {
+      batch.columns_[column_].bytes_data_.append(chunk.value());
+    }
+  }
+
+  cell_first_chunk_ = false;
+
+  // Last chunk in the cell has zero for value size
+  if (chunk.value_size() == 0) {
+    if (!row_in_progress_) {
+      if (cell_row_.empty()) {
+        status = grpc::Status(grpc::StatusCode::INTERNAL,
+                              "Missing row key at last chunk in cell");
+        return;
+      }
+      row_key_ = cell_row_;
+    } else {
+      if (row_key_ != cell_row_) {
+        status = grpc::Status(grpc::StatusCode::INTERNAL,
+                              "Different row key in cell chunk");
+        return;
+      }
+    }
+    if (capture_) {
+      if (schema_[column_].type == ColumnType::INT64) {
+        if (int64_value_.size() != sizeof(std::int64_t)) {
+          status = grpc::Status(
+              grpc::StatusCode::INVALID_ARGUMENT,
+              "Value in column " + family_ + ":" + qualifier_ +
+                  " is not a 64-bit big-endian integer, row=" + row_key_);
+          return;
+        }
+        std::memcpy(&pending_int64_[column_], int64_value_.data(),
+                    sizeof(std::int64_t));
+      }
+      seen_[column_] = 1;
+    }
+    row_in_progress_ = true;
+    cell_first_chunk_ = true;
+    capture_ = false;
+  }
+
+  if (chunk.reset_row()) {
+    DiscardRow(batch);
+    if (!cell_first_chunk_) {
+      status = grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Reset row with an unfinished cell");
+      return;
+    }
+  } else if (chunk.commit_row()) {
+    if (!cell_first_chunk_) {
+      status = grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Commit row with an unfinished cell");
+      return;
+    }
+    if (!row_in_progress_) {
+      status = grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Commit row missing the row key");
+      return;
+    }
+    CommitRow(batch);
+  }
+}
+
+void ColumnarParser::HandleEndOfStream(grpc::Status& status) {
+  if (end_of_stream_) {
+    status = grpc::Status(grpc::StatusCode::INTERNAL,
+                          "HandleEndOfStream called twice");
+    return;
+  }
+  end_of_stream_ = true;
+
+  if (!cell_first_chunk_) {
+    status = grpc::Status(grpc::StatusCode::INTERNAL,
+                          "end of stream with unfinished cell");
+    return;
+  }
+
+  if (row_in_progress_) {
+    status = grpc::Status(grpc::StatusCode::INTERNAL,
+                          "end of stream with unfinished row");
+    return;
+  }
+}
+
+void ColumnarParser::DiscardRow(ColumnarBatch& batch) {
+  // Only the `BYTES` values are appended to the batch before the row is
+  // committed, the other per-row state lives in the parser.
+  for (auto& column : batch.columns_) {
+    column.bytes_data_.resize(column.offsets_.back());
+  }
+  std::fill(seen_.begin(), seen_.end(), 0);
+  cell_row_.clear();
+  family_.clear();
+  qualifier_.clear();
+  column_ = -1;
+  capture_ = false;
+  row_key_.clear();
+  row_in_progress_ = false;
+}
+
+void ColumnarParser::LookupColumn() {
+  column_ = -1;
+  for (std::size_t i = 0; i != schema_.size(); ++i) {
+    if (schema_[i].column_qualifier == qualifier_ &&
+        schema_[i].family_name == family_) {
+      column_ = static_cast<int>(i);
+      return;
+    }
+  }
+}
+
+void ColumnarParser::CommitRow(ColumnarBatch& batch) {
+  auto const row = batch.row_count_;
+  auto const mask = std::uint64_t(1) << (row % 64);
+  batch.row_keys_data_.append(row_key_);
+  batch.row_key_offsets_.push_back(batch.row_keys_data_.size());
+  for (std::size_t i = 0; i != schema_.size(); ++i) {
+    auto& column = batch.columns_[i];
+    if (row % 64 == 0) {
+      column.validity_.push_back(0);
+    }
+    bool const valid = seen_[i] != 0;
+    if (valid) {
+      column.validity_.back() |= mask;
+    } else {
+      ++column.null_count_;
+    }
+    if (column.type_ == ColumnType::INT64) {
+      // Zero has the same representation in both byte orders.
+      column.int64_values_.push_back(valid ? pending_int64_[i] : 0);
+    } else {
+      column.offsets_.push_back(column.bytes_data_.size());
+    }
+    ++column.size_;
+    seen_[i] = 0;
+  }
+  ++batch.row_count_;
+
+  last_seen_row_key_ = std::move(row_key_);
+  row_key_.clear();
+  cell_row_.clear();
+  row_in_progress_ = false;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,113 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COLUMNAR_PARSER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COLUMNAR_PARSER_H_
+
+#include "google/cloud/bigtable/columnar_batch.h"
+#include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Transforms a stream of ReadRows chunks into the columns of a ColumnarBatch.
+ *
+ * This class validates the chunks exactly as `ReadRowsParser` does, but
+ * instead of creating a `Row` with a `Cell` for each cell in the response, it
+ * appends the values of the columns in the schema directly to the buffers in
+ * a `ColumnarBatch`. Cells in other columns, and older cells in the schema
+ * columns, are validated and skipped without copying their values.
+ *
+ * `INT64` values are copied to their column in big-endian order, and converted
+ * to native order for the whole batch at once in `FinishBatch()`.
+ *
+ * Like `ReadRowsParser` a new parser must be used for each stream.
+ */
+class ColumnarParser {
+ public:
+  explicit ColumnarParser(std::vector<ColumnSpec> schema);
+
+  /// Discard the contents of @p batch and prepare its columns for @p schema.
+  static void StartBatch(std::vector<ColumnSpec> const& schema,
+                         ColumnarBatch& batch);
+
+  /// Convert any values in @p batch that are still in big-endian order.
+  static void FinishBatch(ColumnarBatch& batch);
+
+  /**
+   * Pass an input chunk to the parser, committed rows are added to @p batch.
+   *
+   * The parser may swap the strings out of @p chunk. On error @p status is
+   * set and the parser is left in an unspecified state.
+   */
+  void HandleChunk(google::bigtable::v2::ReadRowsResponse_CellChunk& chunk,
+                   ColumnarBatch& batch, grpc::Status& status);
+
+  /// Signal that the input stream reached the end.
+  void HandleEndOfStream(grpc::Status& status);
+
+  /// True if the parser has received some, but not all, chunks of a row.
+  bool InRow() const { return row_in_progress_ || !cell_first_chunk_; }
+
+  /**
+   * Remove the data of a partially parsed row from @p batch.
+   *
+   * Callers must use this function before abandoning a parser in the middle of
+   * a row, for example to retry a failed stream.
+   */
+  void DiscardRow(ColumnarBatch& batch);
+
+ private:
+  /// Find the schema column for the current family and qualifier.
+  void LookupColumn();
+  void CommitRow(ColumnarBatch& batch);
+
+  std::vector<ColumnSpec> schema_;
+
+  /// The row key, family and qualifier of the current cell.
+  std::string cell_row_;
+  std::string family_;
+  std::string qualifier_;
+  /// The index of the current cell's column in the schema, or -1.
+  int column_;
+  /// True if the value of the current cell is being captured.
+  bool capture_;
+  /// Accumulates the value of an `INT64` cell.
+  std::string int64_value_;
+
+  /// The key of the current row.
+  std::string row_key_;
+  bool row_in_progress_;
+  /// The raw `INT64` value of each schema column in the current row.
+  std::vector<std::int64_t> pending_int64_;
+  /// Whether each schema column has a value in the current row.
+  std::vector<char> seen_;
+
+  bool cell_first_chunk_;
+  std::string last_seen_row_key_;
+  bool end_of_stream_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COLUMNAR_PARSER_H_
@@ -0,0 +1,347 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/columnar_parser.h"
+#include <google/protobuf/text_format.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+using google::bigtable::v2::ReadRowsResponse_CellChunk;
+
+std::vector<ColumnSpec> TestSchema() {
+  return {{"fam", "counter", ColumnType::INT64},
+          {"fam", "name", ColumnType::BYTES},
+          {"other", "name", ColumnType::BYTES}};
+}
+
+/// Parse each chunk in @p chunks, stop at the first error.
+grpc::Status HandleChunks(ColumnarParser& parser, ColumnarBatch& batch,
+                          std::vector<std::string> const& chunks) {
+  grpc::Status status;
+  for (auto const& text : chunks) {
+    ReadRowsResponse_CellChunk chunk;
+    EXPECT_TRUE(google::protobuf::TextFormat::ParseFromString(text, &chunk));
+    parser.HandleChunk(chunk, batch, status);
+    if (!status.ok()) {
+      break;
+    }
+  }
+  return status;
+}
+
+TEST(ColumnarParserTest, ExtractColumns) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "counter" >
+                                    timestamp_micros: 20
+                                    value: "\000\000\000\000\000\000\001\002")",
+                                 R"(qualifier: < value: "ignored" >
+                                    timestamp_micros: 20
+                                    value: "not in the schema")",
+                                 R"(qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "name-1"
+                                    commit_row: true)",
+                                 R"(row_key: "r2"
+                                    family_name: < value: "other" >
+                                    qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "other-2"
+                                    commit_row: true)",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_FALSE(parser.InRow());
+  parser.HandleEndOfStream(status);
+  EXPECT_TRUE(status.ok());
+  ColumnarParser::FinishBatch(batch);
+
+  ASSERT_EQ(2U, batch.row_count());
+  EXPECT_EQ("r1", batch.row_key(0));
+  EXPECT_EQ("r2", batch.row_key(1));
+  ASSERT_EQ(3U, batch.column_count());
+
+  auto const& counter = batch.column(0);
+  EXPECT_EQ(ColumnType::INT64, counter.type());
+  ASSERT_EQ(2U, counter.size());
+  EXPECT_EQ(1U, counter.null_count());
+  EXPECT_FALSE(counter.is_null(0));
+  EXPECT_TRUE(counter.is_null(1));
+  EXPECT_EQ(0x0102, counter.int64_values()[0]);
+  EXPECT_EQ(0, counter.int64_values()[1]);
+
+  auto const& name = batch.column(1);
+  EXPECT_EQ(ColumnType::BYTES, name.type());
+  EXPECT_FALSE(name.is_null(0));
+  EXPECT_TRUE(name.is_null(1));
+  EXPECT_EQ("name-1", name.bytes_value(0));
+  EXPECT_EQ("", name.bytes_value(1));
+  EXPECT_EQ("name-1", name.bytes_data());
+
+  auto const& other = batch.column(2);
+  EXPECT_TRUE(other.is_null(0));
+  EXPECT_FALSE(other.is_null(1));
+  EXPECT_EQ("other-2", other.bytes_value(1));
+  EXPECT_EQ(std::vector<std::uint64_t>{0x2}, other.validity());
+}
+
+TEST(ColumnarParserTest, NewestCellIsExtracted) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "newest")",
+                                 R"(timestamp_micros: 10
+                                    value: "older"
+                                    commit_row: true)",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  ASSERT_EQ(1U, batch.row_count());
+  EXPECT_EQ("newest", batch.column(1).bytes_value(0));
+  EXPECT_EQ("newest", batch.column(1).bytes_data());
+}
+
+TEST(ColumnarParserTest, MultipleChunksPerCell) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "counter" >
+                                    timestamp_micros: 20
+                                    value: "\000\000\000\000"
+                                    value_size: 8)",
+                                 R"(value: "\000\000\000\052")",
+                                 R"(qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "split-"
+                                    value_size: 11)",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_TRUE(parser.InRow());
+  status = HandleChunks(parser, batch, {R"(value: "value" commit_row: true)"});
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_FALSE(parser.InRow());
+  ColumnarParser::FinishBatch(batch);
+
+  ASSERT_EQ(1U, batch.row_count());
+  EXPECT_EQ(42, batch.column(0).int64_values()[0]);
+  EXPECT_EQ("split-value", batch.column(1).bytes_value(0));
+}
+
+TEST(ColumnarParserTest, ResetRowDiscardsValues) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "discarded")",
+                                 R"(reset_row: true)",
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "counter" >
+                                    timestamp_micros: 20
+                                    value: "\000\000\000\000\000\000\000\007"
+                                    commit_row: true)",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  ColumnarParser::FinishBatch(batch);
+
+  ASSERT_EQ(1U, batch.row_count());
+  EXPECT_EQ(7, batch.column(0).int64_values()[0]);
+  EXPECT_TRUE(batch.column(1).is_null(0));
+  EXPECT_EQ("", batch.column(1).bytes_data());
+}
+
+TEST(ColumnarParserTest, DiscardPartialRow) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "committed"
+                                    commit_row: true)",
+                                 R"(row_key: "r2"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    timestamp_micros: 20
+                                    value: "partial")",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_TRUE(parser.InRow());
+  parser.DiscardRow(batch);
+  EXPECT_FALSE(parser.InRow());
+  ASSERT_EQ(1U, batch.row_count());
+  EXPECT_EQ("committed", batch.column(1).bytes_data());
+}
+
+TEST(ColumnarParserTest, ManyRows) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  int const row_count = 200;
+  for (int i = 0; i != row_count; ++i) {
+    char key[16];
+    std::snprintf(key, sizeof(key), "row-%04d", i);
+    ReadRowsResponse_CellChunk chunk;
+    chunk.set_row_key(key);
+    chunk.mutable_family_name()->set_value("fam");
+    chunk.mutable_qualifier()->set_value("counter");
+    std::int64_t const value = i;
+    std::string encoded(8, '\0');
+    for (int b = 0; b != 8; ++b) {
+      encoded[7 - b] = static_cast<char>((value >> (8 * b)) & 0xFF);
+    }
+    chunk.set_value(encoded);
+    // Only the odd rows have a value for the counter.
+    if (i % 2 == 0) {
+      chunk.mutable_qualifier()->set_value("ignored");
+    }
+    chunk.set_commit_row(true);
+    grpc::Status status;
+    parser.HandleChunk(chunk, batch, status);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+  }
+  ColumnarParser::FinishBatch(batch);
+
+  ASSERT_EQ(static_cast<std::size_t>(row_count), batch.row_count());
+  auto const& counter = batch.column(0);
+  EXPECT_EQ(static_cast<std::size_t>(row_count / 2), counter.null_count());
+  EXPECT_EQ(4U, counter.validity().size());
+  for (int i = 0; i != row_count; ++i) {
+    EXPECT_EQ(i % 2 == 0, counter.is_null(i));
+    EXPECT_EQ(i % 2 == 0 ? 0 : i, counter.int64_values()[i]);
+  }
+  EXPECT_EQ("row-0199", batch.row_key(row_count - 1));
+}
+
+TEST(ColumnarParserTest, InvalidInt64Value) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "counter" >
+                                    timestamp_micros: 20
+                                    value: "not-a-counter"
+                                    commit_row: true)",
+                             });
+  EXPECT_EQ(grpc::StatusCode::INVALID_ARGUMENT, status.error_code());
+  EXPECT_EQ(0U, batch.row_count());
+}
+
+TEST(ColumnarParserTest, RowKeysOutOfOrder) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r2"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    value: "v"
+                                    commit_row: true)",
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    value: "v"
+                                    commit_row: true)",
+                             });
+  EXPECT_EQ(grpc::StatusCode::INTERNAL, status.error_code());
+  EXPECT_EQ(1U, batch.row_count());
+}
+
+TEST(ColumnarParserTest, EndOfStreamWithUnfinishedRow) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    value: "v")",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  parser.HandleEndOfStream(status);
+  EXPECT_EQ(grpc::StatusCode::INTERNAL, status.error_code());
+}
+
+TEST(ColumnarParserTest, StartBatchReusesBatch) {
+  ColumnarParser parser(TestSchema());
+  ColumnarBatch batch;
+  ColumnarParser::StartBatch(TestSchema(), batch);
+  auto status = HandleChunks(parser, batch,
+                             {
+                                 R"(row_key: "r1"
+                                    family_name: < value: "fam" >
+                                    qualifier: < value: "name" >
+                                    value: "v"
+                                    commit_row: true)",
+                             });
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  ASSERT_EQ(1U, batch.row_count());
+
+  ColumnarParser::StartBatch(TestSchema(), batch);
+  EXPECT_EQ(0U, batch.row_count());
+  EXPECT_EQ(3U, batch.column_count());
+  EXPECT_EQ(0U, batch.column(1).size());
+  EXPECT_EQ("", batch.column(1).bytes_data());
+  EXPECT_EQ(1U, batch.column(1).offsets().size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -16,7 +16,14 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_COMMON_CLIENT_H_
 
 #include "google/cloud/bigtable/client_options.h"
+#include "google/cloud/internal/make_unique.h"
 #include <grpcpp/grpcpp.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -28,6 +35,16 @@ namespace internal {
 std::vector<std::shared_ptr<grpc::Channel>> CreateChannelPool(
     std::string const& endpoint, bigtable::ClientOptions const& options);
 
+/**
+ * Create the channel for position @p index in the pool.
+ *
+ * Channels with a different @p generation use different connections, even if
+ * all the other options are the same. `CreateChannelPool()` uses generation 0.
+ */
+std::shared_ptr<grpc::Channel> CreateChannel(
+    std::string const& endpoint, bigtable::ClientOptions const& options,
+    std::size_t index, int generation);
+
 /**
  * Refactor implementation of `bigtable::{Data,Admin,InstanceAdmin}Client`.
  *
@@ -39,6 +56,11 @@ std::vector<std::shared_ptr<grpc::Channel>> CreateChannelPool(
  * The class exposes the channels because they are needed for clients that
  * use more than one type of Stub.
  *
+ * Depending on the client options, the channels are connected when the object
+ * is created, and a background thread monitors the connectivity state of each
+ * channel, replacing channels that cannot connect, or that have been in use
+ * for longer than the refresh period.
+ *
  * @tparam Traits encapsulates variations between the clients.  Currently, which
  *   `*_endpoint()` member function is used.
  * @tparam Interface the gRPC object returned by `Stub()`.
@@ -53,7 +75,28 @@ class CommonClient {
   //@}
 
   CommonClient(bigtable::ClientOptions options)
-      : options_(std::move(options)), current_index_(0) {}
+      : options_(std::move(options)),
+        current_index_(0),
+        generation_(0),
+        shutdown_(false) {
+    if (options_.eager_connection()) {
+      WaitForConnected(std::chrono::system_clock::now() +
+                       options_.connection_timeout());
+    }
+  }
+
+  ~CommonClient() {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (!monitor_.joinable()) {
+      return;
+    }
+    // The pending watches complete (at most) one poll period after the
+    // shutdown, then the monitor thread exits.
+    shutdown_ = true;
+    cq_->Shutdown();
+    lk.unlock();
+    monitor_.join();
+  }
 
   /**
    * Reset the channel and stub.
@@ -83,6 +126,29 @@ class CommonClient {
     return channel;
   }
 
+  /**
+   * Create the channels, if needed, and wait until all of them are connected.
+   *
+   * @return true if all the channels connected before @p deadline.
+   */
+  bool WaitForConnected(std::chrono::system_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lk(mu_);
+    CheckConnections(lk);
+    auto channels = channels_;
+    lk.unlock();
+    // Start connecting all the channels before blocking on any of them.
+    for (auto const& channel : channels) {
+      channel->GetState(true);
+    }
+    bool connected = true;
+    for (auto const& channel : channels) {
+      if (!channel->WaitForConnected(deadline)) {
+        connected = false;
+      }
+    }
+    return connected;
+  }
+
  private:
   /// Make sure the connections exit, and create them if needed.
   void CheckConnections(std::unique_lock<std::mutex>& lk) {
@@ -112,6 +178,137 @@ class CommonClient {
       tmp.swap(stubs_);
       current_index_ = 0;
     }
+    StartMonitor(lk);
+  }
+
+  /// The tag for each `NotifyOnStateChange()` call.
+  struct Watch {
+    std::size_t index;
+    ChannelPtr channel;
+  };
+
+  /// The monitoring state for each position in the pool.
+  struct Slot {
+    bool failing;
+    std::chrono::steady_clock::time_point failing_since;
+    std::chrono::steady_clock::time_point refresh_at;
+  };
+
+  /// Start the monitoring thread, if enabled and not already running.
+  void StartMonitor(std::unique_lock<std::mutex>&) {
+    if (monitor_.joinable() || shutdown_ ||
+        (options_.max_transient_failure().count() == 0 &&
+         options_.channel_refresh_period().count() == 0)) {
+      return;
+    }
+    cq_ = google::cloud::internal::make_unique<grpc::CompletionQueue>();
+    auto const now = std::chrono::steady_clock::now();
+    auto const size = channels_.size();
+    slots_.resize(size);
+    for (std::size_t i = 0; i != size; ++i) {
+      // Stagger the refreshes, so only one channel is replaced at a time.
+      slots_[i] = Slot{false, now, NextRefresh(now, i + 1, size)};
+      WatchChannel(i, channels_[i]);
+    }
+    monitor_ = std::thread(&CommonClient::MonitorLoop, this);
+  }
+
+  /// Return when to refresh a channel, as a fraction of the refresh period.
+  std::chrono::steady_clock::time_point NextRefresh(
+      std::chrono::steady_clock::time_point now, std::size_t num,
+      std::size_t den) const {
+    auto const period = options_.channel_refresh_period();
+    if (period.count() == 0) {
+      return std::chrono::steady_clock::time_point::max();
+    }
+    using rep = std::chrono::milliseconds::rep;
+    return now + period * static_cast<rep>(num) / static_cast<rep>(den);
+  }
+
+  /// How often the monitor checks the channels, even without state changes.
+  std::chrono::milliseconds PollPeriod() const {
+    std::chrono::milliseconds period = std::chrono::seconds(1);
+    for (auto p : {options_.max_transient_failure(),
+                   options_.channel_refresh_period()}) {
+      if (p.count() != 0) {
+        period = (std::min)(period, p);
+      }
+    }
+    return period;
+  }
+
+  /// Wait for the next state change of @p channel, must hold the lock.
+  void WatchChannel(std::size_t index, ChannelPtr const& channel) {
+    // With eager connections, reconnect idle channels right away, otherwise
+    // leave them alone until the next RPC.
+    auto const state = channel->GetState(options_.eager_connection());
+    auto* watch = new Watch{index, channel};
+    channel->NotifyOnStateChange(
+        state, std::chrono::system_clock::now() + PollPeriod(), cq_.get(),
+        watch);
+  }
+
+  void MonitorLoop() {
+    void* tag;
+    bool ok;
+    while (cq_->Next(&tag, &ok)) {
+      // `ok` is false if the deadline expired, the channel needs a check in
+      // both cases.
+      std::unique_ptr<Watch> watch(static_cast<Watch*>(tag));
+      CheckChannel(watch->index);
+    }
+  }
+
+  /// Replace the channel at @p index if it is stuck or needs a refresh.
+  void CheckChannel(std::size_t index) {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (shutdown_) {
+      return;
+    }
+    auto channel = channels_[index];
+    auto& slot = slots_[index];
+    auto const now = std::chrono::steady_clock::now();
+    auto const state = channel->GetState(false);
+    if (state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+      if (!slot.failing) {
+        slot.failing = true;
+        slot.failing_since = now;
+      }
+    } else if (state != GRPC_CHANNEL_CONNECTING) {
+      // While reconnecting the channel goes back and forth between
+      // TRANSIENT_FAILURE and CONNECTING, only a connection (or giving up
+      // and becoming idle) resets the failure timer.
+      slot.failing = false;
+    }
+    auto const max_failure = options_.max_transient_failure();
+    bool const stuck = max_failure.count() != 0 && slot.failing &&
+                       now - slot.failing_since >= max_failure;
+    if (!stuck && now < slot.refresh_at) {
+      WatchChannel(index, channel);
+      return;
+    }
+
+    auto const generation = ++generation_;
+    lk.unlock();
+    // Create the channel and stub without holding the lock, just like
+    // CheckConnections().
+    auto replacement = CreateChannel(Traits::Endpoint(options_), options_,
+                                     index, generation);
+    auto stub = Interface::NewStub(replacement);
+    // Start connecting now, rather than on the first RPC.
+    replacement->GetState(true);
+    lk.lock();
+    if (shutdown_) {
+      return;
+    }
+    // RPCs already started on the old channel keep a reference to it, they
+    // are not interrupted.
+    channels_[index] = replacement;
+    if (!stubs_.empty()) {
+      stubs_[index] = std::move(stub);
+    }
+    slots_[index] = Slot{false, now, NextRefresh(now, 1, 1)};
+    WatchChannel(index, replacement);
   }
 
   /// Get the current index for round-robin over connections.
@@ -130,6 +327,11 @@ class CommonClient {
   std::vector<ChannelPtr> channels_;
   std::vector<StubPtr> stubs_;
   std::size_t current_index_;
+  int generation_;
+  bool shutdown_;
+  std::vector<Slot> slots_;
+  std::unique_ptr<grpc::CompletionQueue> cq_;
+  std::thread monitor_;
 };
 
 }  // namespace internal
@@ -28,27 +28,44 @@ inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
 void CompletionQueueImpl::Run(CompletionQueue& cq) {
   while (!shutdown_.load()) {
-    void* tag;
-    bool ok;
     auto deadline = std::chrono::system_clock::now() + LOOP_TIMEOUT;
-    auto status = cq_.AsyncNext(&tag, &ok, deadline);
-    if (status == grpc::CompletionQueue::SHUTDOWN) {
+    if (!ProcessNextEvent(cq, deadline)) {
       break;
     }
-    if (status == grpc::CompletionQueue::TIMEOUT) {
-      continue;
-    }
-    if (status != grpc::CompletionQueue::GOT_EVENT) {
-      google::cloud::internal::ThrowRuntimeError(
-          "unexpected status from AsyncNext()");
-    }
-    auto op = FindOperation(tag);
-    if (op->Notify(cq, ok)) {
-      ForgetOperation(tag);
+  }
+}
+
+void CompletionQueueImpl::RunUntilIdle(CompletionQueue& cq) {
+  while (!shutdown_.load() && !empty()) {
+    auto deadline = std::chrono::system_clock::now() + LOOP_TIMEOUT;
+    if (!ProcessNextEvent(cq, deadline)) {
+      break;
     }
   }
 }
 
+bool CompletionQueueImpl::ProcessNextEvent(
+    CompletionQueue& cq, std::chrono::system_clock::time_point deadline) {
+  void* tag;
+  bool ok;
+  auto status = cq_.AsyncNext(&tag, &ok, deadline);
+  if (status == grpc::CompletionQueue::SHUTDOWN) {
+    return false;
+  }
+  if (status == grpc::CompletionQueue::TIMEOUT) {
+    return true;
+  }
+  if (status != grpc::CompletionQueue::GOT_EVENT) {
+    google::cloud::internal::ThrowRuntimeError(
+        "unexpected status from AsyncNext()");
+  }
+  auto op = FindOperation(tag);
+  if (op->Notify(cq, ok)) {
+    ForgetOperation(tag);
+  }
+  return true;
+}
+
 void CompletionQueueImpl::Shutdown() {
   shutdown_.store(true);
   cq_.Shutdown();
@@ -18,12 +18,15 @@
 #include "google/cloud/bigtable/async_operation.h"
 #include "google/cloud/internal/invoke_result.h"
 #include "google/cloud/internal/throw_delegate.h"
+#include <google/protobuf/arena.h>
 #include <grpcpp/alarm.h>
 #include <grpcpp/support/async_stream.h>
 #include <grpcpp/support/async_unary_call.h>
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace google {
 namespace cloud {
@@ -245,7 +248,10 @@ class AsyncUnaryStreamRpcFunctor : public AsyncGrpcOperation {
       : tag_(nullptr),
         state_(CREATING),
         data_functor_(std::forward<DataFunctor>(data_functor)),
-        finished_functor_(std::forward<FinishedFunctor>(finished_functor)) {}
+        finished_functor_(std::forward<FinishedFunctor>(finished_functor)),
+        response_(google::protobuf::Arena::CreateMessage<Response>(&arena_)),
+        received_(google::protobuf::Arena::CreateMessage<Response>(&arena_)) {
+  }
 
   /// Make the RPC request and prepare the response callback.
   template <typename Client, typename MemberFunction>
@@ -271,7 +277,7 @@ class AsyncUnaryStreamRpcFunctor : public AsyncGrpcOperation {
     switch (state_) {
       case CREATING:
         if (ok) {
-          response_reader_->Read(&response_, tag_);
+          response_reader_->Read(response_, tag_);
           state_ = PROCESSING;
         } else {
           response_reader_->Finish(&status_, tag_);
@@ -280,12 +286,11 @@ class AsyncUnaryStreamRpcFunctor : public AsyncGrpcOperation {
         return false;
       case PROCESSING:
         if (ok) {
-          Response received;
-          response_.Swap(&received);
+          std::swap(response_, received_);
           lk.unlock();
           // The simple way to assure that we don't reorder callbacks is not
           // submitting the next Read() until the user callback finishes.
-          data_functor_(cq, *context_, received);
+          data_functor_(cq, *context_, *received_);
           lk.lock();
           // We must hold the lock while calling Read(): this operation may
           // trigger a callback in other threads running the completion event
@@ -294,7 +299,7 @@ class AsyncUnaryStreamRpcFunctor : public AsyncGrpcOperation {
           // that this is an asynchronous operation, blocking for a long time
           // would make it impossible to write asynchronous applications
           // efficiently.
-          response_reader_->Read(&response_, tag_);
+          response_reader_->Read(response_, tag_);
         } else {
           response_reader_->Finish(&status_, tag_);
           state_ = FINISHING;
@@ -333,6 +338,163 @@ class AsyncUnaryStreamRpcFunctor : public AsyncGrpcOperation {
   grpc::Status status_;
   DataFunctor data_functor_;
   FinishedFunctor finished_functor_;
+  // The responses are allocated from a per-stream arena and reused: gRPC reads
+  // into `response_` while `received_` holds the data passed to the callback,
+  // and the two are swapped on each message. Protobuf keeps the cleared
+  // repeated fields and strings, so long streams do not allocate a new set of
+  // sub-messages for each response.
+  google::protobuf::Arena arena_;
+  Response* response_;
+  Response* received_;
+  std::unique_ptr<grpc::ClientContext> context_;
+  std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> response_reader_;
+};
+
+/**
+ * A streaming RPC where the caller controls when each response is read.
+ *
+ * `AsyncUnaryStreamRpcFunctor` reads the next response as soon as the data
+ * callback returns, so a slow consumer can only push back by blocking the
+ * completion queue thread. Operations of this type only `Read()` a response
+ * when `RequestNext()` is called, the gRPC flow control then stops the server
+ * once its send window is full.
+ */
+class AsyncPullStreamOperation : public AsyncGrpcOperation {
+ public:
+  /**
+   * Read the next response.
+   *
+   * The data callback is called once the response arrives. Calling this
+   * function while a previous read is pending has no effect.
+   */
+  virtual void RequestNext() = 0;
+};
+
+/**
+ * Wrap the callbacks of a pull-based streaming RPC into an `AsyncOperation`.
+ *
+ * Note that this class lives in the `internal` namespace and thus is
+ * not intended for general use.
+ *
+ * @tparam Request the type of the RPC request.
+ * @tparam Response the type of the RPC response piece.
+ * @tparam DataFunctor the callback type for notifying about data portions.
+ * @tparam FinishedFunctor the callback type for notifying about end of stream.
+ */
+template <typename Request, typename Response, typename DataFunctor,
+          typename FinishedFunctor,
+          typename std::enable_if<
+              CheckUnaryStreamRpcDataCallback<DataFunctor, Response>::value,
+              int>::type = 0,
+          typename std::enable_if<CheckUnaryStreamRpcFinishedCallback<
+                                      FinishedFunctor, Response>::value,
+                                  int>::type = 0>
+class AsyncPullStreamRpcFunctor : public AsyncPullStreamOperation {
+ public:
+  explicit AsyncPullStreamRpcFunctor(DataFunctor&& data_functor,
+                                     FinishedFunctor&& finished_functor)
+      : tag_(nullptr),
+        state_(CREATING),
+        read_requested_(false),
+        in_callback_(false),
+        cancelled_(false),
+        data_functor_(std::forward<DataFunctor>(data_functor)),
+        finished_functor_(std::forward<FinishedFunctor>(finished_functor)) {}
+
+  /// Make the RPC request and prepare the response callback.
+  template <typename Client, typename MemberFunction>
+  void Set(Client& client, MemberFunction Client::*call,
+           std::unique_ptr<grpc::ClientContext> context, Request const& request,
+           grpc::CompletionQueue* cq, void* tag) {
+    std::unique_lock<std::mutex> lk(mu_);
+    tag_ = tag;
+    context_ = std::move(context);
+    response_reader_ = (client.*call)(context_.get(), request, cq, tag);
+  }
+
+  void RequestNext() override {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (state_ == CREATING || in_callback_) {
+      read_requested_ = true;
+      return;
+    }
+    if (state_ == IDLE) {
+      response_reader_->Read(&response_, tag_);
+      state_ = READING;
+    }
+  }
+
+  void Cancel() override {
+    std::unique_lock<std::mutex> lk(mu_);
+    cancelled_ = true;
+    context_->TryCancel();
+    // Without a pending operation the stream would never finish, read the
+    // next response to learn about the cancellation. If the data callback is
+    // running it still uses the response, Notify() reads once it returns.
+    if (state_ == IDLE && !in_callback_) {
+      response_reader_->Read(&response_, tag_);
+      state_ = READING;
+    }
+  }
+
+ private:
+  enum State { CREATING, IDLE, READING, FINISHING };
+  bool Notify(CompletionQueue& cq, bool ok) override {
+    std::unique_lock<std::mutex> lk(mu_);
+
+    switch (state_) {
+      case CREATING:
+        if (!ok) {
+          response_reader_->Finish(&status_, tag_);
+          state_ = FINISHING;
+        } else if (read_requested_ || cancelled_) {
+          response_reader_->Read(&response_, tag_);
+          state_ = READING;
+        } else {
+          state_ = IDLE;
+        }
+        return false;
+      case IDLE:
+        break;
+      case READING:
+        if (ok && !cancelled_) {
+          state_ = IDLE;
+          in_callback_ = true;
+          read_requested_ = false;
+          lk.unlock();
+          // The callback may call RequestNext(), which needs the lock. The
+          // response is not reused until the callback returns.
+          data_functor_(cq, *context_, response_);
+          lk.lock();
+          in_callback_ = false;
+          if (read_requested_ || cancelled_) {
+            response_reader_->Read(&response_, tag_);
+            state_ = READING;
+          }
+        } else {
+          response_reader_->Finish(&status_, tag_);
+          state_ = FINISHING;
+        }
+        return false;
+      case FINISHING:
+        lk.unlock();
+        finished_functor_(cq, *context_, status_);
+        return true;
+    }
+    google::cloud::internal::ThrowRuntimeError(
+        "unexpected state in AsyncPullStreamRpcFunctor: " +
+        std::to_string(state_));
+  }
+
+  std::mutex mu_;
+  void* tag_;
+  State state_;
+  bool read_requested_;
+  bool in_callback_;
+  bool cancelled_;
+  grpc::Status status_;
+  DataFunctor data_functor_;
+  FinishedFunctor finished_functor_;
   Response response_;
   std::unique_ptr<grpc::ClientContext> context_;
   std::unique_ptr<grpc::ClientAsyncReaderInterface<Response>> response_reader_;
@@ -418,6 +580,18 @@ class CompletionQueueImpl {
    */
   void Run(CompletionQueue& cq);
 
+  /**
+   * Run the event loop until there are no pending operations.
+   *
+   * Synchronous functions implemented with the asynchronous operations use
+   * this to run the event loop in the calling thread, on a completion queue
+   * owned by that function.
+   *
+   * @param cq the completion queue wrapping this implementation class, used to
+   *   notify any asynchronous operation that completes.
+   */
+  void RunUntilIdle(CompletionQueue& cq);
+
   /// Terminate the event loop.
   void Shutdown();
 
@@ -455,6 +629,10 @@ class CompletionQueueImpl {
   }
 
  private:
+  /// Wait for the next event, until @p deadline, and notify its operation.
+  bool ProcessNextEvent(CompletionQueue& cq,
+                        std::chrono::system_clock::time_point deadline);
+
   grpc::CompletionQueue cq_;
   std::atomic<bool> shutdown_;
   mutable std::mutex mu_;
@@ -22,7 +22,7 @@ inline namespace BIGTABLE_CLIENT_NS {
 namespace internal {
 using google::bigtable::v2::ReadRowsResponse_CellChunk;
 
-void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk chunk,
+void ReadRowsParser::HandleChunk(ReadRowsResponse_CellChunk& chunk,
                                  grpc::Status& status) {
   if (end_of_stream_) {
     status = grpc::Status(grpc::StatusCode::INTERNAL,
@@ -64,13 +64,19 @@ class ReadRowsParser {
   /**
    * Pass an input chunk proto to the parser.
    *
+   * The parser takes ownership of the strings in @p chunk by swapping them, the
+   * chunk is left in a valid but unspecified state. Taking the chunk by
+   * reference lets callers keep their responses in a `google::protobuf::Arena`
+   * and reuse them, moving an arena-allocated message into a heap-allocated
+   * one would copy all the data.
+   *
    * @throws std::runtime_error if called while a row is available
    * (HasNext() is true).
    *
    * @throws std::runtime_error if validation failed.
    */
   virtual void HandleChunk(
-      google::bigtable::v2::ReadRowsResponse_CellChunk chunk,
+      google::bigtable::v2::ReadRowsResponse_CellChunk& chunk,
       grpc::Status& status);
 
   /**
@@ -152,7 +152,7 @@ TEST(ReadRowsParserTest, SingleChunkValueIsMoved) {
   chunk.mutable_value()->swap(value);
   grpc::Status status;
   ASSERT_FALSE(parser.HasNext());
-  parser.HandleChunk(std::move(chunk), status);
+  parser.HandleChunk(chunk, status);
   EXPECT_TRUE(status.ok());
   ASSERT_TRUE(parser.HasNext());
   google::cloud::bigtable::Row r = parser.Next(status);
@@ -224,7 +224,7 @@ class AcceptanceTest : public ::testing::Test {
 
   void FeedChunks(std::vector<ReadRowsResponse_CellChunk> chunks) {
     grpc::Status status;
-    for (auto const& chunk : chunks) {
+    for (auto& chunk : chunks) {
       parser_.HandleChunk(chunk, status);
       if (!status.ok()) {
         google::cloud::internal::ThrowRuntimeError(status.error_message());
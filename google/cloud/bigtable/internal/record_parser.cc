@@ -0,0 +1,89 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/record_parser.h"
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+std::vector<std::string> SplitRecords(std::string const& text, bool quoted) {
+  std::vector<std::string> records;
+  auto add_record = [&records, &text](std::size_t begin, std::size_t end) {
+    if (end != begin && text[end - 1] == '\r') {
+      --end;
+    }
+    if (end != begin) {
+      records.emplace_back(text, begin, end - begin);
+    }
+  };
+
+  std::size_t begin = 0;
+  bool in_quotes = false;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    char const c = text[i];
+    if (quoted && c == '"') {
+      // An escaped quote ("") toggles twice, which leaves the state unchanged.
+      in_quotes = !in_quotes;
+      continue;
+    }
+    if (c != '\n' || in_quotes) {
+      continue;
+    }
+    add_record(begin, i);
+    begin = i + 1;
+  }
+  add_record(begin, text.size());
+  return records;
+}
+
+std::vector<std::string> ParseCsvRecord(std::string const& record,
+                                        char separator) {
+  std::vector<std::string> fields(1);
+  bool in_quotes = false;
+  bool field_start = true;
+  for (std::size_t i = 0; i != record.size(); ++i) {
+    char const c = record[i];
+    if (in_quotes) {
+      if (c != '"') {
+        fields.back().push_back(c);
+      } else if (i + 1 != record.size() && record[i + 1] == '"') {
+        fields.back().push_back('"');
+        ++i;
+      } else {
+        in_quotes = false;
+      }
+      continue;
+    }
+    if (c == separator) {
+      fields.emplace_back();
+      field_start = true;
+      continue;
+    }
+    if (c == '"' && field_start) {
+      in_quotes = true;
+    } else {
+      fields.back().push_back(c);
+    }
+    field_start = false;
+  }
+  return fields;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,56 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_RECORD_PARSER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_RECORD_PARSER_H_
+
+#include "google/cloud/bigtable/version.h"
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Split @p text into newline terminated records.
+ *
+ * The terminators, including any `\r` before a `\n`, are not part of the
+ * records. The last record does not need a terminator. Empty records are
+ * skipped.
+ *
+ * @param text the text to split.
+ * @param quoted if true, newlines inside double-quoted CSV fields do not
+ *     terminate the record.
+ */
+std::vector<std::string> SplitRecords(std::string const& text, bool quoted);
+
+/**
+ * Split a CSV record into fields, as described in RFC 4180.
+ *
+ * Fields starting with a double quote may contain @p separator, newlines, and
+ * double quotes escaped as `""`. Characters after the closing quote of a field
+ * are kept as-is, and an unterminated quote extends to the end of the record.
+ */
+std::vector<std::string> ParseCsvRecord(std::string const& record,
+                                        char separator);
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_RECORD_PARSER_H_
@@ -0,0 +1,59 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/record_parser.h"
+#include <gmock/gmock.h>
+
+namespace bigtable = google::cloud::bigtable;
+using ::testing::ElementsAre;
+
+TEST(RecordParserTest, SplitRecords) {
+  EXPECT_THAT(bigtable::internal::SplitRecords("a,b\nc,d\n", false),
+              ElementsAre("a,b", "c,d"));
+  EXPECT_THAT(bigtable::internal::SplitRecords("a\r\n\nb", false),
+              ElementsAre("a", "b"));
+  EXPECT_TRUE(bigtable::internal::SplitRecords("", false).empty());
+}
+
+TEST(RecordParserTest, SplitRecordsQuoted) {
+  std::string const text = "k1,\"multi\nline\"\nk2,\"a \"\"quote\"\"\"\n";
+  EXPECT_THAT(bigtable::internal::SplitRecords(text, true),
+              ElementsAre("k1,\"multi\nline\"", "k2,\"a \"\"quote\"\"\""));
+  // Without quote handling every newline ends a record.
+  EXPECT_EQ(3U, bigtable::internal::SplitRecords(text, false).size());
+}
+
+TEST(RecordParserTest, ParseCsvRecord) {
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord("a,b,,c", ','),
+              ElementsAre("a", "b", "", "c"));
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord("a|b", '|'),
+              ElementsAre("a", "b"));
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord("", ','), ElementsAre(""));
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord("a,", ','),
+              ElementsAre("a", ""));
+}
+
+TEST(RecordParserTest, ParseCsvRecordQuoted) {
+  EXPECT_THAT(
+      bigtable::internal::ParseCsvRecord(R"("a,b","say ""hi""",c)", ','),
+      ElementsAre("a,b", "say \"hi\"", "c"));
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord("\"multi\nline\",x", ','),
+              ElementsAre("multi\nline", "x"));
+  // Quotes in the middle of a field are not special.
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord(R"(a"b,c)", ','),
+              ElementsAre("a\"b", "c"));
+  // An unterminated quote extends to the end of the record.
+  EXPECT_THAT(bigtable::internal::ParseCsvRecord(R"(a,"b,c)", ','),
+              ElementsAre("a", "b,c"));
+}
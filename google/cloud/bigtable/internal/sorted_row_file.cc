@@ -0,0 +1,389 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/sorted_row_file.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+namespace {
+/// Identifies the files created by `SortedRowFileWriter`, "btrows01".
+std::uint64_t const kMagic = 0x313073776f727462ULL;
+std::size_t const kFooterSize = 3 * sizeof(std::uint64_t);
+std::size_t const kChecksumSize = sizeof(std::uint32_t);
+
+/// The cell uses the same column family as the previous cell in the row.
+char const kSameFamily = 0x1;
+/// The cell uses the same column qualifier as the previous cell in the row.
+char const kSameQualifier = 0x2;
+
+void PutVarint(std::string& out, std::uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+    v >>= 7;
+  }
+  out.push_back(static_cast<char>(v));
+}
+
+void PutString(std::string& out, std::string const& s) {
+  PutVarint(out, s.size());
+  out.append(s);
+}
+
+void PutFixed(std::string& out, std::uint64_t v, std::size_t size) {
+  for (std::size_t i = 0; i != size; ++i) {
+    out.push_back(static_cast<char>(v & 0xFF));
+    v >>= 8;
+  }
+}
+
+std::uint64_t ZigZag(std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^
+         static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t UnZigZag(std::uint64_t v) {
+  return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+/// Decode the values created by the `Put*()` functions, with bounds checks.
+class Decoder {
+ public:
+  Decoder(char const* begin, char const* end) : p_(begin), end_(end) {}
+
+  bool ok() const { return ok_; }
+  bool done() const { return p_ == end_; }
+
+  std::uint64_t Varint() {
+    std::uint64_t v = 0;
+    for (int shift = 0; shift < 64 && p_ != end_; shift += 7) {
+      auto const byte = static_cast<std::uint8_t>(*p_++);
+      v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return v;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  std::string String() {
+    auto const size = Varint();
+    if (!ok_ || size > static_cast<std::uint64_t>(end_ - p_)) {
+      ok_ = false;
+      return std::string();
+    }
+    std::string s(p_, static_cast<std::size_t>(size));
+    p_ += size;
+    return s;
+  }
+
+  std::uint64_t Fixed(std::size_t size) {
+    if (size > static_cast<std::size_t>(end_ - p_)) {
+      ok_ = false;
+      return 0;
+    }
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i != size; ++i) {
+      v |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(*p_++))
+           << (8 * i);
+    }
+    return v;
+  }
+
+  char Byte() {
+    if (p_ == end_) {
+      ok_ = false;
+      return 0;
+    }
+    return *p_++;
+  }
+
+ private:
+  char const* p_;
+  char const* end_;
+  bool ok_ = true;
+};
+
+[[noreturn]] void ThrowCorrupted(std::string const& path, char const* what) {
+  google::cloud::internal::ThrowRuntimeError("corrupted sorted row file " +
+                                             path + ": " + what);
+}
+
+std::string ReadAt(std::ifstream& is, std::string const& path,
+                   std::uint64_t offset, std::uint64_t size) {
+  std::string data(static_cast<std::size_t>(size), '\0');
+  is.seekg(static_cast<std::streamoff>(offset));
+  is.read(&data[0], static_cast<std::streamsize>(data.size()));
+  if (static_cast<std::uint64_t>(is.gcount()) != size) {
+    ThrowCorrupted(path, "short read");
+  }
+  return data;
+}
+
+/// Verify the checksum at the end of @p data, and return the data size.
+std::size_t CheckedSize(std::string const& data, std::string const& path,
+                        char const* what) {
+  if (data.size() < kChecksumSize) {
+    ThrowCorrupted(path, what);
+  }
+  auto const size = data.size() - kChecksumSize;
+  Decoder d(data.data() + size, data.data() + data.size());
+  auto const expected = static_cast<std::uint32_t>(d.Fixed(kChecksumSize));
+  if (Crc32c(0, data.data(), size) != expected) {
+    ThrowCorrupted(path, what);
+  }
+  return size;
+}
+}  // namespace
+
+std::uint32_t Crc32c(std::uint32_t crc, char const* data, std::size_t size) {
+  struct Table {
+    Table() {
+      for (std::uint32_t i = 0; i != 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k != 8; ++k) {
+          c = (c & 1) != 0 ? 0x82F63B78U ^ (c >> 1) : c >> 1;
+        }
+        values[i] = c;
+      }
+    }
+    std::uint32_t values[256];
+  };
+  static Table const table;
+
+  crc = ~crc;
+  for (std::size_t i = 0; i != size; ++i) {
+    crc = table.values[(crc ^ static_cast<std::uint8_t>(data[i])) & 0xFF] ^
+          (crc >> 8);
+  }
+  return ~crc;
+}
+
+SortedRowFileWriter::SortedRowFileWriter(std::string path,
+                                         std::size_t block_size)
+    : path_(std::move(path)),
+      os_(path_, std::ios::binary | std::ios::trunc),
+      block_size_(block_size),
+      block_row_count_(0),
+      block_count_(0),
+      offset_(0),
+      row_count_(0) {
+  if (!os_.is_open()) {
+    google::cloud::internal::ThrowRuntimeError("cannot create " + path_);
+  }
+}
+
+void SortedRowFileWriter::Append(Row const& row) {
+  auto const& key = row.row_key();
+  if (row_count_ != 0 && key <= last_key_) {
+    google::cloud::internal::ThrowInvalidArgument(
+        "SortedRowFileWriter::Append() requires increasing row keys, got <" +
+        key + "> after <" + last_key_ + ">");
+  }
+  std::size_t shared = 0;
+  if (block_row_count_ == 0) {
+    block_first_key_ = key;
+  } else {
+    auto const limit = (std::min)(key.size(), last_key_.size());
+    while (shared != limit && key[shared] == last_key_[shared]) {
+      ++shared;
+    }
+  }
+  PutVarint(block_, shared);
+  PutString(block_, key.substr(shared));
+  PutVarint(block_, row.cells().size());
+
+  Cell const* previous = nullptr;
+  for (auto const& cell : row.cells()) {
+    char flags = 0;
+    if (previous != nullptr && previous->family_name() == cell.family_name()) {
+      flags |= kSameFamily;
+      if (previous->column_qualifier() == cell.column_qualifier()) {
+        flags |= kSameQualifier;
+      }
+    }
+    block_.push_back(flags);
+    if ((flags & kSameFamily) == 0) {
+      PutString(block_, cell.family_name());
+    }
+    if ((flags & kSameQualifier) == 0) {
+      PutString(block_, cell.column_qualifier());
+    }
+    PutVarint(block_, ZigZag(cell.timestamp().count()));
+    PutString(block_, cell.value());
+    previous = &cell;
+  }
+
+  last_key_ = key;
+  ++block_row_count_;
+  ++row_count_;
+  if (block_.size() >= block_size_) {
+    FlushBlock();
+  }
+}
+
+void SortedRowFileWriter::Close() {
+  FlushBlock();
+  std::string index;
+  PutVarint(index, block_count_);
+  index += index_;
+  PutFixed(index, Crc32c(0, index.data(), index.size()), kChecksumSize);
+  auto const index_offset = offset_;
+  Write(index);
+
+  std::string footer;
+  PutFixed(footer, index_offset, sizeof(std::uint64_t));
+  PutFixed(footer, index.size(), sizeof(std::uint64_t));
+  PutFixed(footer, kMagic, sizeof(std::uint64_t));
+  Write(footer);
+  os_.close();
+  if (!os_) {
+    google::cloud::internal::ThrowRuntimeError("cannot close " + path_);
+  }
+}
+
+void SortedRowFileWriter::FlushBlock() {
+  if (block_row_count_ == 0) {
+    return;
+  }
+  PutString(index_, block_first_key_);
+  PutVarint(index_, offset_);
+  PutVarint(index_, block_.size());
+  PutVarint(index_, static_cast<std::uint64_t>(block_row_count_));
+  ++block_count_;
+
+  PutFixed(block_, Crc32c(0, block_.data(), block_.size()), kChecksumSize);
+  Write(block_);
+  block_.clear();
+  block_row_count_ = 0;
+}
+
+void SortedRowFileWriter::Write(std::string const& data) {
+  os_.write(data.data(), static_cast<std::streamsize>(data.size()));
+  if (!os_) {
+    google::cloud::internal::ThrowRuntimeError("cannot write to " + path_);
+  }
+  offset_ += data.size();
+}
+
+SortedRowFileReader::SortedRowFileReader(std::string path)
+    : path_(std::move(path)), row_count_(0) {
+  std::ifstream is(path_, std::ios::binary);
+  if (!is.is_open()) {
+    google::cloud::internal::ThrowRuntimeError("cannot open " + path_);
+  }
+  is.seekg(0, std::ios::end);
+  auto const file_size = static_cast<std::uint64_t>(is.tellg());
+  if (file_size < kFooterSize) {
+    ThrowCorrupted(path_, "missing footer");
+  }
+  auto const footer = ReadAt(is, path_, file_size - kFooterSize, kFooterSize);
+  Decoder f(footer.data(), footer.data() + footer.size());
+  auto const index_offset = f.Fixed(sizeof(std::uint64_t));
+  auto const index_size = f.Fixed(sizeof(std::uint64_t));
+  if (f.Fixed(sizeof(std::uint64_t)) != kMagic ||
+      index_offset > file_size - kFooterSize ||
+      index_size != file_size - kFooterSize - index_offset) {
+    ThrowCorrupted(path_, "invalid footer");
+  }
+
+  auto const index = ReadAt(is, path_, index_offset, index_size);
+  auto const size = CheckedSize(index, path_, "index checksum mismatch");
+  Decoder d(index.data(), index.data() + size);
+  auto const count = d.Varint();
+  for (std::uint64_t i = 0; d.ok() && i != count; ++i) {
+    BlockHandle handle;
+    handle.first_key = d.String();
+    handle.offset = d.Varint();
+    handle.size = d.Varint();
+    handle.row_count = static_cast<std::int64_t>(d.Varint());
+    if (handle.offset > index_offset ||
+        handle.size + kChecksumSize > index_offset - handle.offset) {
+      ThrowCorrupted(path_, "invalid block handle");
+    }
+    row_count_ += handle.row_count;
+    blocks_.push_back(std::move(handle));
+  }
+  if (!d.ok() || !d.done()) {
+    ThrowCorrupted(path_, "invalid index");
+  }
+}
+
+std::size_t SortedRowFileReader::FindBlock(std::string const& row_key) const {
+  auto i = std::upper_bound(blocks_.begin(), blocks_.end(), row_key,
+                            [](std::string const& key, BlockHandle const& b) {
+                              return key < b.first_key;
+                            });
+  if (i == blocks_.begin()) {
+    return 0;
+  }
+  return static_cast<std::size_t>(std::distance(blocks_.begin(), i) - 1);
+}
+
+std::vector<Row> SortedRowFileReader::ReadBlock(std::size_t index) const {
+  auto const& handle = blocks_.at(index);
+  std::ifstream is(path_, std::ios::binary);
+  if (!is.is_open()) {
+    google::cloud::internal::ThrowRuntimeError("cannot open " + path_);
+  }
+  auto const data =
+      ReadAt(is, path_, handle.offset, handle.size + kChecksumSize);
+  auto const size = CheckedSize(data, path_, "block checksum mismatch");
+
+  Decoder d(data.data(), data.data() + size);
+  std::vector<Row> rows;
+  std::string key;
+  for (std::int64_t i = 0; d.ok() && i != handle.row_count; ++i) {
+    auto const shared = d.Varint();
+    if (shared > key.size()) {
+      ThrowCorrupted(path_, "invalid key prefix");
+    }
+    key.resize(static_cast<std::size_t>(shared));
+    key += d.String();
+
+    auto const cell_count = d.Varint();
+    std::vector<Cell> cells;
+    std::string family;
+    std::string qualifier;
+    for (std::uint64_t j = 0; d.ok() && j != cell_count; ++j) {
+      char const flags = d.Byte();
+      if ((flags & kSameFamily) == 0) {
+        family = d.String();
+      }
+      if ((flags & kSameQualifier) == 0) {
+        qualifier = d.String();
+      }
+      auto const timestamp = UnZigZag(d.Varint());
+      auto value = d.String();
+      cells.emplace_back(key, family, qualifier, timestamp, std::move(value),
+                         std::vector<std::string>{});
+    }
+    rows.emplace_back(key, std::move(cells));
+  }
+  if (!d.ok() || !d.done()) {
+    ThrowCorrupted(path_, "invalid block");
+  }
+  return rows;
+}
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,136 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SORTED_ROW_FILE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SORTED_ROW_FILE_H_
+
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/version.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace internal {
+/**
+ * Compute the CRC32C (Castagnoli) checksum of @p size bytes at @p data.
+ *
+ * @param crc the checksum of any previous data, use 0 to start a new checksum.
+ */
+std::uint32_t Crc32c(std::uint32_t crc, char const* data, std::size_t size);
+
+/**
+ * Write rows, sorted by key, to a local file.
+ *
+ * The file is a sequence of blocks, followed by an index and a fixed size
+ * footer:
+ *
+ * - Each block contains complete rows. Each row key is stored as the length
+ *   of the prefix it shares with the previous key in the block, followed by
+ *   the remaining bytes. Cells only store their column family and qualifier
+ *   when they differ from the previous cell in the row. All the lengths and
+ *   timestamps are varints. A CRC32C checksum of the block follows its contents.
+ * - The index contains the first key, offset, size and row count of each
+ *   block, followed by its own CRC32C checksum.
+ * - The footer contains the offset and size of the index, and a magic number.
+ *
+ * Blocks are independent of each other, readers can decode any block using
+ * only the index. Cell labels are not saved.
+ */
+class SortedRowFileWriter {
+ public:
+  SortedRowFileWriter(std::string path, std::size_t block_size);
+
+  /**
+   * Append a row to the file.
+   *
+   * The rows must be appended in strictly increasing key order.
+   */
+  void Append(Row const& row);
+
+  /// Write any pending block, the index and the footer, then close the file.
+  void Close();
+
+  std::string const& path() const { return path_; }
+  std::int64_t row_count() const { return row_count_; }
+  /// The size of the file, only valid after `Close()`.
+  std::uint64_t file_size() const { return offset_; }
+
+ private:
+  void FlushBlock();
+  void Write(std::string const& data);
+
+  std::string path_;
+  std::ofstream os_;
+  std::size_t block_size_;
+  std::string block_;
+  std::string block_first_key_;
+  std::int64_t block_row_count_;
+  std::string last_key_;
+  std::string index_;
+  std::uint64_t block_count_;
+  std::uint64_t offset_;
+  std::int64_t row_count_;
+};
+
+/**
+ * Read the files created by `SortedRowFileWriter`.
+ *
+ * The constructor reads and validates the index. Each call to `ReadBlock()`
+ * opens the file again, so a single reader can be shared by many threads.
+ */
+class SortedRowFileReader {
+ public:
+  explicit SortedRowFileReader(std::string path);
+
+  std::string const& path() const { return path_; }
+  std::size_t block_count() const { return blocks_.size(); }
+  std::int64_t row_count() const { return row_count_; }
+
+  /// The first key in block @p index.
+  std::string const& first_key(std::size_t index) const {
+    return blocks_.at(index).first_key;
+  }
+
+  /// Return the index of the only block that may contain @p row_key.
+  std::size_t FindBlock(std::string const& row_key) const;
+
+  /// Read and validate all the rows in block @p index.
+  std::vector<Row> ReadBlock(std::size_t index) const;
+
+ private:
+  struct BlockHandle {
+    std::string first_key;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::int64_t row_count;
+  };
+
+  std::string path_;
+  std::vector<BlockHandle> blocks_;
+  std::int64_t row_count_;
+};
+
+}  // namespace internal
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_SORTED_ROW_FILE_H_
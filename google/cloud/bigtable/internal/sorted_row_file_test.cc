@@ -0,0 +1,161 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/internal/sorted_row_file.h"
+#include "google/cloud/internal/random.h"
+#include <gmock/gmock.h>
+#include <cstdio>
+
+namespace bigtable = google::cloud::bigtable;
+using bigtable::internal::SortedRowFileReader;
+using bigtable::internal::SortedRowFileWriter;
+
+namespace {
+class SortedRowFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto generator = google::cloud::internal::MakeDefaultPRNG();
+    path_ = ::testing::TempDir() + "sorted-row-file-" +
+            google::cloud::internal::Sample(
+                generator, 16, "abcdefghijklmnopqrstuvwxyz0123456789");
+  }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  static bigtable::Row MakeRow(int i) {
+    char key[32];
+    std::snprintf(key, sizeof(key), "row-key-%06d", i);
+    std::vector<bigtable::Cell> cells{
+        {key, "fam", "c0", 2000, "v0-" + std::to_string(i), {}},
+        {key, "fam", "c0", 1000, "old", {}},
+        {key, "fam", "c1", 1000, std::string(i % 7, 'x'), {}},
+        {key, "other", "", 3000, "", {}},
+    };
+    return bigtable::Row(key, std::move(cells));
+  }
+
+  static void ExpectSameRow(bigtable::Row const& expected,
+                            bigtable::Row const& actual) {
+    EXPECT_EQ(expected.row_key(), actual.row_key());
+    ASSERT_EQ(expected.cells().size(), actual.cells().size());
+    for (std::size_t i = 0; i != expected.cells().size(); ++i) {
+      auto const& e = expected.cells()[i];
+      auto const& a = actual.cells()[i];
+      EXPECT_EQ(e.row_key(), a.row_key());
+      EXPECT_EQ(e.family_name(), a.family_name());
+      EXPECT_EQ(e.column_qualifier(), a.column_qualifier());
+      EXPECT_EQ(e.timestamp(), a.timestamp());
+      EXPECT_EQ(e.value(), a.value());
+    }
+  }
+
+  void WriteRows(int count, std::size_t block_size) {
+    SortedRowFileWriter writer(path_, block_size);
+    for (int i = 0; i != count; ++i) {
+      writer.Append(MakeRow(i));
+    }
+    writer.Close();
+    EXPECT_EQ(count, writer.row_count());
+  }
+
+  void CorruptByte(long offset) {
+    std::FILE* f = std::fopen(path_.c_str(), "r+b");
+    ASSERT_NE(nullptr, f);
+    std::fseek(f, offset, offset < 0 ? SEEK_END : SEEK_SET);
+    int c = std::fgetc(f);
+    std::fseek(f, -1, SEEK_CUR);
+    std::fputc(c ^ 0x55, f);
+    std::fclose(f);
+  }
+
+  std::string path_;
+};
+}  // anonymous namespace
+
+TEST(Crc32cTest, KnownValues) {
+  std::string const data = "123456789";
+  EXPECT_EQ(0xE3069283U,
+            bigtable::internal::Crc32c(0, data.data(), data.size()));
+  // Computing the checksum in pieces produces the same value.
+  auto partial = bigtable::internal::Crc32c(0, data.data(), 4);
+  EXPECT_EQ(0xE3069283U,
+            bigtable::internal::Crc32c(partial, data.data() + 4, 5));
+}
+
+TEST_F(SortedRowFileTest, RoundTrip) {
+  int const count = 1000;
+  WriteRows(count, 1024);
+
+  SortedRowFileReader reader(path_);
+  EXPECT_EQ(count, reader.row_count());
+  ASSERT_LT(1U, reader.block_count());
+  int i = 0;
+  for (std::size_t b = 0; b != reader.block_count(); ++b) {
+    auto rows = reader.ReadBlock(b);
+    ASSERT_FALSE(rows.empty());
+    EXPECT_EQ(reader.first_key(b), rows.front().row_key());
+    for (auto const& row : rows) {
+      ExpectSameRow(MakeRow(i++), row);
+    }
+  }
+  EXPECT_EQ(count, i);
+}
+
+TEST_F(SortedRowFileTest, FindBlock) {
+  WriteRows(1000, 1024);
+  SortedRowFileReader reader(path_);
+  EXPECT_EQ(0U, reader.FindBlock(""));
+  EXPECT_EQ(reader.block_count() - 1, reader.FindBlock("zzz"));
+  auto const target = MakeRow(500).row_key();
+  auto rows = reader.ReadBlock(reader.FindBlock(target));
+  EXPECT_LE(rows.front().row_key(), target);
+  EXPECT_GE(rows.back().row_key(), target);
+}
+
+TEST_F(SortedRowFileTest, Empty) {
+  WriteRows(0, 1024);
+  SortedRowFileReader reader(path_);
+  EXPECT_EQ(0U, reader.block_count());
+  EXPECT_EQ(0, reader.row_count());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST_F(SortedRowFileTest, RejectsUnsortedRows) {
+  SortedRowFileWriter writer(path_, 1024);
+  writer.Append(MakeRow(2));
+  EXPECT_THROW(writer.Append(MakeRow(1)), std::invalid_argument);
+  EXPECT_THROW(writer.Append(MakeRow(2)), std::invalid_argument);
+}
+
+TEST_F(SortedRowFileTest, DetectsBlockCorruption) {
+  WriteRows(100, 1024);
+  CorruptByte(10);
+  SortedRowFileReader reader(path_);
+  EXPECT_THROW(reader.ReadBlock(0), std::runtime_error);
+  // The other blocks are still readable.
+  EXPECT_FALSE(reader.ReadBlock(1).empty());
+}
+
+TEST_F(SortedRowFileTest, DetectsIndexCorruption) {
+  WriteRows(100, 1024);
+  // The last byte of the index checksum is just before the footer.
+  CorruptByte(-25);
+  EXPECT_THROW(SortedRowFileReader{path_}, std::runtime_error);
+}
+
+TEST_F(SortedRowFileTest, DetectsFooterCorruption) {
+  WriteRows(100, 1024);
+  CorruptByte(-1);
+  EXPECT_THROW(SortedRowFileReader{path_}, std::runtime_error);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
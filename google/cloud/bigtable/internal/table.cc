@@ -16,6 +16,10 @@
 #include "google/cloud/bigtable/internal/bulk_mutator.h"
 #include "google/cloud/bigtable/internal/unary_client_utils.h"
 #include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 
@@ -31,9 +35,20 @@ using ClientUtils = bigtable::internal::noex::UnaryClientUtils<DataClient>;
 static_assert(std::is_copy_assignable<bigtable::noex::Table>::value,
               "bigtable::noex::Table must be CopyAssignable");
 
+std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
+  if (!row_cache_) {
+    return ApplyImpl(std::move(mut));
+  }
+  // Invalidate the row even if the mutation failed, it may have been applied.
+  auto row_key = mut.row_key();
+  auto failures = ApplyImpl(std::move(mut));
+  row_cache_->Invalidate(table_name(), row_key);
+  return failures;
+}
+
 // Call the `google.bigtable.v2.Bigtable.MutateRow` RPC repeatedly until
 // successful, or until the policies in effect tell us to stop.
-std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
+std::vector<FailedMutation> Table::ApplyImpl(SingleRowMutation&& mut) {
   // Copy the policies in effect for this operation.  Many policy classes change
   // their state as the operation makes progress (or fails to make progress), so
   // we need fresh instances.
@@ -68,6 +83,7 @@ std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
     // It is up to the policy to terminate this loop, it could run
     // forever, but that would be a bad policy (pun intended).
     if (!rpc_policy->OnFailure(status) || !is_idempotent) {
+      status = rpc_policy->FinalStatus(status);
       google::rpc::Status rpc_status;
       rpc_status.set_code(status.error_code());
       rpc_status.set_message(status.error_message());
@@ -89,6 +105,65 @@ std::vector<FailedMutation> Table::Apply(SingleRowMutation&& mut) {
 // not succeed.
 std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
                                              grpc::Status& status) {
+  if (!row_cache_) {
+    return BulkApplyImpl(std::move(mut), status);
+  }
+  auto row_keys = bigtable::internal::BulkMutationRowKeys(mut);
+  auto failures = BulkApplyImpl(std::move(mut), status);
+  for (auto const& row_key : row_keys) {
+    row_cache_->Invalidate(table_name(), row_key);
+  }
+  return failures;
+}
+
+std::vector<FailedMutation> Table::BulkApplyImpl(BulkMutation&& mut,
+                                                 grpc::Status& status) {
+  auto batches = bigtable::internal::SplitBulkMutation(std::move(mut),
+                                                       bulk_apply_options_);
+  if (batches.size() == 1) {
+    return BulkApplyBatch(std::move(batches.front()), status);
+  }
+
+  // Send the batches from a few threads. Because the client rotates over its
+  // channels for each request the batches are spread over all the channels.
+  std::mutex mu;
+  std::size_t next = 0;
+  std::vector<FailedMutation> failures;
+  status = grpc::Status::OK;
+  auto worker = [&] {
+    std::unique_lock<std::mutex> lk(mu);
+    while (next != batches.size()) {
+      auto batch = std::move(batches[next++]);
+      lk.unlock();
+      grpc::Status batch_status;
+      auto batch_failures = BulkApplyBatch(std::move(batch), batch_status);
+      lk.lock();
+      std::move(batch_failures.begin(), batch_failures.end(),
+                std::back_inserter(failures));
+      if (!batch_status.ok() && status.ok()) {
+        status = std::move(batch_status);
+      }
+    }
+  };
+  auto const thread_count = (std::min)(
+      bulk_apply_options_.max_concurrent_requests(), batches.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::sort(failures.begin(), failures.end(),
+            [](FailedMutation const& a, FailedMutation const& b) {
+              return a.original_index() < b.original_index();
+            });
+  return failures;
+}
+
+std::vector<FailedMutation> Table::BulkApplyBatch(
+    bigtable::internal::BulkMutationBatch batch, grpc::Status& status) {
   // Copy the policies in effect for this operation.  Many policy classes change
   // their state as the operation makes progress (or fails to make progress), so
   // we need fresh instances.
@@ -96,9 +171,9 @@ std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
   auto retry_policy = rpc_retry_policy_->clone();
   auto idemponent_policy = idempotent_mutation_policy_->clone();
 
-  bigtable::internal::BulkMutator mutator(app_profile_id_, table_name_,
-                                          *idemponent_policy,
-                                          std::forward<BulkMutation>(mut));
+  bigtable::internal::BulkMutator mutator(
+      app_profile_id_, table_name_, *idemponent_policy,
+      std::move(batch.mutation), batch.index_offset);
   while (mutator.HasPendingMutations()) {
     grpc::ClientContext client_context;
     backoff_policy->Setup(client_context);
@@ -106,6 +181,7 @@ std::vector<FailedMutation> Table::BulkApply(BulkMutation&& mut,
     metadata_update_policy_.Setup(client_context);
     status = mutator.MakeOneRequest(*client_, client_context);
     if (!status.ok() && !retry_policy->OnFailure(status)) {
+      status = retry_policy->FinalStatus(status);
       break;
     }
     auto delay = backoff_policy->OnCompletion(status);
@@ -143,8 +219,76 @@ RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
                    raise_on_error);
 }
 
+ColumnarReader Table::ReadColumns(RowSet row_set, Filter filter,
+                                  std::vector<ColumnSpec> schema,
+                                  std::size_t batch_size,
+                                  bool raise_on_error) {
+  return ColumnarReader(client_, app_profile_id_, table_name_,
+                        std::move(row_set), std::move(filter),
+                        std::move(schema), batch_size,
+                        rpc_retry_policy_->clone(),
+                        rpc_backoff_policy_->clone(), metadata_update_policy_,
+                        raise_on_error);
+}
+
+std::shared_ptr<internal::AsyncRowStreamImpl> Table::MakeAsyncRowStream(
+    CompletionQueue& cq, RowSet row_set, std::int64_t rows_limit,
+    Filter filter, std::size_t max_buffered_rows,
+    std::size_t max_buffered_bytes) {
+  auto stream = std::make_shared<internal::AsyncRowStreamImpl>(
+      cq, client_, app_profile_id_, table_name_, rpc_retry_policy_->clone(),
+      rpc_backoff_policy_->clone(), metadata_update_policy_,
+      std::move(row_set), rows_limit, std::move(filter), max_buffered_rows,
+      max_buffered_bytes);
+  stream->Start();
+  return stream;
+}
+
 std::pair<bool, Row> Table::ReadRow(std::string row_key, Filter filter,
                                     grpc::Status& status) {
+  if (row_cache_) {
+    return CachedReadRow(std::move(row_key), std::move(filter), status);
+  }
+  return UncachedReadRow(std::move(row_key), std::move(filter), status);
+}
+
+// Only the first of several concurrent reads for the same row and filter
+// sends a request, the other reads block until its result is available.
+std::pair<bool, Row> Table::CachedReadRow(std::string row_key, Filter filter,
+                                          grpc::Status& status) {
+  auto key = RowCache::MakeKey(table_name(), row_key, filter);
+  std::pair<bool, Row> result(false, Row("", {}));
+  std::promise<void> done;
+  auto on_pending = [&result, &status, &done](
+                        std::pair<bool, Row> const& r, grpc::Status const& s) {
+    result = r;
+    status = s;
+    done.set_value();
+  };
+  switch (row_cache_->Lookup(key, result, on_pending)) {
+    case RowCache::LookupResult::HIT:
+      return result;
+    case RowCache::LookupResult::PENDING:
+      done.get_future().wait();
+      return result;
+    case RowCache::LookupResult::MISS:
+      break;
+  }
+  result = UncachedReadRow(std::move(row_key), std::move(filter), status);
+  row_cache_->Complete(key, result, status);
+  return result;
+}
+
+std::pair<bool, Row> Table::UncachedReadRow(std::string row_key, Filter filter,
+                                            grpc::Status& status) {
+  if (hedging_policy_) {
+    return HedgedReadRow(std::move(row_key), std::move(filter), status);
+  }
+  return ReadRowImpl(std::move(row_key), std::move(filter), status);
+}
+
+std::pair<bool, Row> Table::ReadRowImpl(std::string row_key, Filter filter,
+                                        grpc::Status& status) {
   RowSet row_set(std::move(row_key));
   std::int64_t const rows_limit = 1;
   RowReader reader =
@@ -164,6 +308,29 @@ std::pair<bool, Row> Table::ReadRow(std::string row_key, Filter filter,
   return result;
 }
 
+// Run the hedged attempts with the asynchronous ReadRows() operations, on a
+// completion queue owned by this call. The calling thread runs the event loop,
+// so no threads are created. The losing attempt is cancelled, and the loop runs
+// until it completes, because no operations may be pending when the completion
+// queue is destroyed.
+std::pair<bool, Row> Table::HedgedReadRow(std::string row_key, Filter filter,
+                                          grpc::Status& status) {
+  auto impl = std::make_shared<internal::CompletionQueueImpl>();
+  CompletionQueue cq(impl);
+  auto result = std::make_pair(false, Row("", {}));
+  UncachedAsyncReadRow(
+      cq,
+      [&result, &status](CompletionQueue&, std::pair<bool, Row> response,
+                         grpc::Status& s) {
+        result = std::move(response);
+        status = s;
+      },
+      std::move(row_key), std::move(filter), false);
+  impl->RunUntilIdle(cq);
+  cq.Shutdown();
+  return result;
+}
+
 bool Table::CheckAndMutateRow(std::string row_key, Filter filter,
                               std::vector<Mutation> true_mutations,
                               std::vector<Mutation> false_mutations,
@@ -186,6 +353,9 @@ bool Table::CheckAndMutateRow(std::string row_key, Filter filter,
       *client_, rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
       metadata_update_policy_, &DataClient::CheckAndMutateRow, request,
       "Table::CheckAndMutateRow", status, is_idempotent);
+  if (row_cache_) {
+    row_cache_->Invalidate(table_name(), request.row_key());
+  }
 
   return response.predicate_matched();
 }
@@ -196,6 +366,9 @@ Row Table::CallReadModifyWriteRowRequest(
       *client_, rpc_retry_policy_->clone(), metadata_update_policy_,
       &DataClient::ReadModifyWriteRow, request, "ReadModifyWriteRowRequest",
       status);
+  if (row_cache_) {
+    row_cache_->Invalidate(table_name(), request.row_key());
+  }
   if (!status.ok()) {
     return Row("", {});
   }
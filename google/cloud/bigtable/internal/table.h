@@ -16,18 +16,24 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_INTERNAL_TABLE_H_
 
 #include "google/cloud/bigtable/bigtable_strong_types.h"
+#include "google/cloud/bigtable/bulk_apply_options.h"
+#include "google/cloud/bigtable/columnar_reader.h"
 #include "google/cloud/bigtable/completion_queue.h"
 #include "google/cloud/bigtable/data_client.h"
 #include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/hedging_policy.h"
 #include "google/cloud/bigtable/idempotent_mutation_policy.h"
 #include "google/cloud/bigtable/internal/async_bulk_apply.h"
+#include "google/cloud/bigtable/internal/async_hedged_read_row.h"
 #include "google/cloud/bigtable/internal/async_read_row_operation.h"
 #include "google/cloud/bigtable/internal/async_retry_unary_rpc.h"
+#include "google/cloud/bigtable/internal/async_row_stream_impl.h"
 #include "google/cloud/bigtable/internal/async_sample_row_keys.h"
 #include "google/cloud/bigtable/internal/bulk_mutator.h"
 #include "google/cloud/bigtable/metadata_update_policy.h"
 #include "google/cloud/bigtable/mutations.h"
 #include "google/cloud/bigtable/read_modify_write_rule.h"
+#include "google/cloud/bigtable/row_cache.h"
 #include "google/cloud/bigtable/row_key_sample.h"
 #include "google/cloud/bigtable/row_reader.h"
 #include "google/cloud/bigtable/row_set.h"
@@ -125,6 +131,54 @@ class UnwrapReadModifyWriteRowResponse {
   Functor callback_;
 };
 
+/**
+ * Remove the rows modified by an asynchronous mutation from the row cache
+ * before calling the application callback.
+ *
+ * The rows are invalidated even if the mutation failed, as some of the
+ * mutations may have been applied.
+ */
+template <typename Functor>
+class InvalidateRowCacheAdapter {
+ public:
+  InvalidateRowCacheAdapter(Functor&& callback,
+                            std::shared_ptr<RowCache> row_cache,
+                            std::string table_name,
+                            std::vector<std::string> row_keys)
+      : callback_(std::forward<Functor>(callback)),
+        row_cache_(std::move(row_cache)),
+        table_name_(std::move(table_name)),
+        row_keys_(std::move(row_keys)) {}
+
+  template <typename... Args>
+  void operator()(CompletionQueue& cq, Args&&... args) {
+    if (row_cache_) {
+      for (auto const& row_key : row_keys_) {
+        row_cache_->Invalidate(table_name_, row_key);
+      }
+    }
+    callback_(cq, std::forward<Args>(args)...);
+  }
+
+ private:
+  typename std::decay<Functor>::type callback_;
+  std::shared_ptr<RowCache> row_cache_;
+  std::string table_name_;
+  std::vector<std::string> row_keys_;
+};
+
+/**
+ * The operation returned by `AsyncReadRow()` when it waits for a concurrent
+ * read of the same row in the row cache.
+ *
+ * The read is shared with other callers, cancelling one of them does not
+ * cancel it.
+ */
+class PendingRowCacheRead : public AsyncOperation {
+ public:
+  void Cancel() override {}
+};
+
 }  // namespace internal
 
 /**
@@ -254,16 +308,19 @@ class Table {
         typename internal::ExtractMemberFunctionType<decltype(
             &DataClient::AsyncMutateRow)>::MemberFunction;
 
+    using Callback = internal::InvalidateRowCacheAdapter<Functor>;
     using Retry =
         internal::AsyncRetryUnaryRpc<DataClient, MemberFunction,
                                      internal::ConstantIdempotencyPolicy,
-                                     Functor>;
+                                     Callback>;
 
+    auto invalidate_callback = InvalidateRowCacheOnCompletion(
+        std::forward<Functor>(callback), request.row_key());
     auto retry = std::make_shared<Retry>(
         __func__, rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
         internal::ConstantIdempotencyPolicy(is_idempotent),
         metadata_update_policy_, client_, &DataClient::AsyncMutateRow,
-        std::move(request), std::forward<Functor>(callback));
+        std::move(request), std::move(invalidate_callback));
     return retry->Start(cq);
   }
 
@@ -296,13 +353,32 @@ class Table {
   std::shared_ptr<AsyncOperation> AsyncBulkApply(CompletionQueue& cq,
                                                  Functor&& callback,
                                                  BulkMutation&& mut) {
-    auto op =
-        std::make_shared<bigtable::internal::AsyncRetryBulkApply<Functor>>(
-            rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
-            *idempotent_mutation_policy_, metadata_update_policy_, client_,
-            app_profile_id_, table_name_, std::move(mut),
-            std::forward<Functor>(callback));
+    using Callback = internal::InvalidateRowCacheAdapter<Functor>;
+    std::vector<std::string> row_keys;
+    if (row_cache_) {
+      row_keys = bigtable::internal::BulkMutationRowKeys(mut);
+    }
+    auto invalidate_callback = InvalidateRowCacheOnCompletion(
+        std::forward<Functor>(callback), std::move(row_keys));
+    auto batches = bigtable::internal::SplitBulkMutation(std::move(mut),
+                                                         bulk_apply_options_);
+    if (batches.size() == 1) {
+      auto op =
+          std::make_shared<bigtable::internal::AsyncRetryBulkApply<Callback>>(
+              rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
+              *idempotent_mutation_policy_, metadata_update_policy_, client_,
+              app_profile_id_, table_name_,
+              std::move(batches.front().mutation),
+              std::move(invalidate_callback));
+
+      return op->Start(cq);
+    }
 
+    auto op =
+        std::make_shared<bigtable::internal::AsyncSplitBulkApply<Callback>>(
+            MakeAsyncBulkApplyStartBatch(), std::move(batches),
+            bulk_apply_options_.max_concurrent_requests(),
+            std::move(invalidate_callback));
     return op->Start(cq);
   }
 
@@ -318,6 +394,24 @@ class Table {
   std::pair<bool, Row> ReadRow(std::string row_key, Filter filter,
                                grpc::Status& status);
 
+  ColumnarReader ReadColumns(
+      RowSet row_set, Filter filter, std::vector<ColumnSpec> schema,
+      std::size_t batch_size = ColumnarReader::DEFAULT_BATCH_SIZE,
+      bool raise_on_error = false);
+
+  /**
+   * Start a flow-controlled asynchronous read of a set of rows.
+   *
+   * The stream reads responses only while it buffers fewer than
+   * @p max_buffered_rows rows and @p max_buffered_bytes bytes.
+   *
+   * @param rows_limit the maximum number of rows to read, 0 reads all rows.
+   */
+  std::shared_ptr<internal::AsyncRowStreamImpl> MakeAsyncRowStream(
+      CompletionQueue& cq, RowSet row_set, std::int64_t rows_limit,
+      Filter filter, std::size_t max_buffered_rows,
+      std::size_t max_buffered_bytes);
+
   /**
    * Reads a limited set of rows from the table asynchronously.
    *
@@ -386,6 +480,13 @@ class Table {
    * @return a handle to the submitted operation
    *
    * @tparam Functor the type of the callback.
+   *
+   * If the table is configured with a `HedgingPolicy` and the read takes
+   * longer than the delay returned by the policy, a second request is sent on
+   * the next channel of the client, and the first response is used.
+   *
+   * If the table is configured with a `RowCache` the callback may receive a
+   * cached result, it is always called from a thread running @p cq.
    */
   template <
       typename Functor,
@@ -398,20 +499,14 @@ class Table {
                                                std::string row_key,
                                                Filter filter,
                                                bool raise_on_error = false) {
-    RowSet row_set(std::move(row_key));
-    std::int64_t const rows_limit = 1;
-    auto rows = std::make_shared<std::vector<Row>>();
-
-    auto read_row_callback = [rows](CompletionQueue& cq, Row row,
-                                    grpc::Status& status) {
-      rows->emplace_back(std::move(row));
-    };
-
-    return AsyncReadRows(cq, std::move(read_row_callback),
-                         internal::ReadRowCallbackAdapter<Functor>(
-                             std::forward<Functor>(callback), rows),
-                         std::move(row_set), rows_limit, std::move(filter),
-                         raise_on_error);
+    if (row_cache_) {
+      return CachedAsyncReadRow(cq, std::forward<Functor>(callback),
+                                std::move(row_key), std::move(filter),
+                                raise_on_error);
+    }
+    return UncachedAsyncReadRow(cq, std::forward<Functor>(callback),
+                                std::move(row_key), std::move(filter),
+                                raise_on_error);
   }
 
   bool CheckAndMutateRow(std::string row_key, Filter filter,
@@ -474,19 +569,22 @@ class Table {
         typename internal::ExtractMemberFunctionType<decltype(
             &DataClient::AsyncCheckAndMutateRow)>::MemberFunction;
 
+    using Callback = internal::InvalidateRowCacheAdapter<Functor>;
     using Retry = internal::AsyncRetryUnaryRpc<
         DataClient, MemberFunction, internal::ConstantIdempotencyPolicy,
-        internal::UnwrapCheckAndMutateResponse<Functor>>;
+        internal::UnwrapCheckAndMutateResponse<Callback>>;
 
     bool const is_idempotent =
         idempotent_mutation_policy_->is_idempotent(request);
+    auto invalidate_callback = InvalidateRowCacheOnCompletion(
+        std::forward<Functor>(callback), request.row_key());
     auto retry = std::make_shared<Retry>(
         __func__, rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
         internal::ConstantIdempotencyPolicy(is_idempotent),
         metadata_update_policy_, client_, &DataClient::AsyncCheckAndMutateRow,
         std::move(request),
-        internal::UnwrapCheckAndMutateResponse<Functor>(
-            std::forward<Functor>(callback)));
+        internal::UnwrapCheckAndMutateResponse<Callback>(
+            std::move(invalidate_callback)));
     return retry->Start(cq);
   }
 
@@ -573,16 +671,19 @@ class Table {
         typename internal::ExtractMemberFunctionType<decltype(
             &DataClient::AsyncReadModifyWriteRow)>::MemberFunction;
 
+    using Callback = internal::InvalidateRowCacheAdapter<Functor>;
     using Retry = internal::AsyncRetryUnaryRpc<
         DataClient, MemberFunction, internal::ConstantIdempotencyPolicy,
-        internal::UnwrapReadModifyWriteRowResponse<Functor>>;
+        internal::UnwrapReadModifyWriteRowResponse<Callback>>;
 
+    auto invalidate_callback = InvalidateRowCacheOnCompletion(
+        std::forward<Functor>(callback), request.row_key());
     auto retry = std::make_shared<Retry>(
         __func__, rpc_retry_policy_->clone(), rpc_backoff_policy_->clone(),
         internal::ConstantIdempotencyPolicy(false), metadata_update_policy_,
         client_, &DataClient::AsyncReadModifyWriteRow, std::move(request),
-        internal::UnwrapReadModifyWriteRowResponse<Functor>(
-            std::forward<Functor>(callback)));
+        internal::UnwrapReadModifyWriteRowResponse<Callback>(
+            std::move(invalidate_callback)));
     return retry->Start(cq);
   }
 
@@ -649,6 +750,20 @@ class Table {
     idempotent_mutation_policy_ = policy.clone();
   }
 
+  void ChangePolicy(HedgingPolicy& policy) { hedging_policy_ = policy.clone(); }
+
+  void ChangePolicy(std::shared_ptr<HedgingPolicy> policy) {
+    hedging_policy_ = std::move(policy);
+  }
+
+  void ChangePolicy(BulkApplyOptions const& options) {
+    bulk_apply_options_ = options;
+  }
+
+  void ChangePolicy(std::shared_ptr<RowCache> row_cache) {
+    row_cache_ = std::move(row_cache);
+  }
+
   template <typename Policy, typename... Policies>
   void ChangePolicies(Policy&& policy, Policies&&... policies) {
     ChangePolicy(policy);
@@ -657,6 +772,199 @@ class Table {
   void ChangePolicies() {}
   //@}
 
+  /// Apply a mutation, without invalidating the row cache.
+  std::vector<FailedMutation> ApplyImpl(SingleRowMutation&& mut);
+
+  /// Apply a bulk mutation, without invalidating the row cache.
+  std::vector<FailedMutation> BulkApplyImpl(BulkMutation&& mut,
+                                            grpc::Status& status);
+
+  /// Apply one batch of a (possibly split) `BulkApply()`.
+  std::vector<FailedMutation> BulkApplyBatch(
+      bigtable::internal::BulkMutationBatch batch, grpc::Status& status);
+
+  /// Create the function used to start each batch of a split AsyncBulkApply.
+  internal::AsyncBulkApplyStartBatch MakeAsyncBulkApplyStartBatch() {
+    auto client = client_;
+    auto app_profile_id = app_profile_id_;
+    auto table_name = table_name_;
+    auto rpc_retry_policy = rpc_retry_policy_;
+    auto rpc_backoff_policy = rpc_backoff_policy_;
+    auto metadata_update_policy = metadata_update_policy_;
+    auto idempotent_mutation_policy = idempotent_mutation_policy_;
+    return [client, app_profile_id, table_name, rpc_retry_policy,
+            rpc_backoff_policy, metadata_update_policy,
+            idempotent_mutation_policy](
+               CompletionQueue& cq, internal::BulkMutationBatch batch,
+               internal::AsyncBulkApplyBatchCallback callback) {
+      auto op = std::make_shared<internal::AsyncRetryBulkApply<
+          internal::AsyncBulkApplyBatchCallback>>(
+          rpc_retry_policy->clone(), rpc_backoff_policy->clone(),
+          *idempotent_mutation_policy, metadata_update_policy, client,
+          app_profile_id, table_name, std::move(batch.mutation),
+          std::move(callback), batch.index_offset);
+      return op->Start(cq);
+    };
+  }
+
+  /// Read a single row through the row cache.
+  std::pair<bool, Row> CachedReadRow(std::string row_key, Filter filter,
+                                     grpc::Status& status);
+
+  /// Read a single row, without the row cache.
+  std::pair<bool, Row> UncachedReadRow(std::string row_key, Filter filter,
+                                       grpc::Status& status);
+
+  /// Read a single row, without hedging.
+  std::pair<bool, Row> ReadRowImpl(std::string row_key, Filter filter,
+                                   grpc::Status& status);
+
+  /// Read a single row, sending a duplicate request if the first one is slow.
+  std::pair<bool, Row> HedgedReadRow(std::string row_key, Filter filter,
+                                     grpc::Status& status);
+
+  /// Create the function used to start each attempt of a hedged AsyncReadRow.
+  internal::HedgedReadRowAttempt MakeHedgedReadRowAttempt(
+      std::string row_key, Filter filter, bool raise_on_error) {
+    auto client = client_;
+    auto app_profile_id = app_profile_id_;
+    auto table_name = table_name_;
+    auto rpc_retry_policy = rpc_retry_policy_;
+    auto rpc_backoff_policy = rpc_backoff_policy_;
+    auto metadata_update_policy = metadata_update_policy_;
+    return [client, app_profile_id, table_name, rpc_retry_policy,
+            rpc_backoff_policy, metadata_update_policy, row_key, filter,
+            raise_on_error](CompletionQueue& cq,
+                            internal::HedgedReadRowCallback callback) {
+      auto rows = std::make_shared<std::vector<Row>>();
+      auto read_row_callback = [rows](CompletionQueue& cq, Row row,
+                                      grpc::Status& status) {
+        rows->emplace_back(std::move(row));
+      };
+      using ReadRowCallback = decltype(read_row_callback);
+      using DoneCallback =
+          internal::ReadRowCallbackAdapter<internal::HedgedReadRowCallback>;
+      auto op = std::make_shared<
+          internal::AsyncReadRowsOperation<ReadRowCallback, DoneCallback>>(
+          rpc_retry_policy->clone(), rpc_backoff_policy->clone(),
+          metadata_update_policy, client, app_profile_id, table_name,
+          RowSet(row_key), 1, filter, raise_on_error,
+          google::cloud::internal::make_unique<
+              bigtable::internal::ReadRowsParserFactory>(),
+          std::move(read_row_callback),
+          DoneCallback(std::move(callback), rows));
+      return op->Start(cq);
+    };
+  }
+
+  /// Start an asynchronous read of a single row, without the row cache.
+  template <typename Functor>
+  std::shared_ptr<AsyncOperation> UncachedAsyncReadRow(CompletionQueue& cq,
+                                                       Functor&& callback,
+                                                       std::string row_key,
+                                                       Filter filter,
+                                                       bool raise_on_error) {
+    if (hedging_policy_) {
+      auto op =
+          std::make_shared<internal::AsyncHedgedReadRowOperation<Functor>>(
+              hedging_policy_,
+              MakeHedgedReadRowAttempt(std::move(row_key), std::move(filter),
+                                       raise_on_error),
+              std::forward<Functor>(callback));
+      return op->Start(cq);
+    }
+
+    RowSet row_set(std::move(row_key));
+    std::int64_t const rows_limit = 1;
+    auto rows = std::make_shared<std::vector<Row>>();
+
+    auto read_row_callback = [rows](CompletionQueue& cq, Row row,
+                                    grpc::Status& status) {
+      rows->emplace_back(std::move(row));
+    };
+
+    return AsyncReadRows(cq, std::move(read_row_callback),
+                         internal::ReadRowCallbackAdapter<Functor>(
+                             std::forward<Functor>(callback), rows),
+                         std::move(row_set), rows_limit, std::move(filter),
+                         raise_on_error);
+  }
+
+  /// Start an asynchronous read of a single row, using the row cache.
+  template <typename Functor>
+  std::shared_ptr<AsyncOperation> CachedAsyncReadRow(CompletionQueue& cq,
+                                                     Functor&& callback,
+                                                     std::string row_key,
+                                                     Filter filter,
+                                                     bool raise_on_error) {
+    auto key = RowCache::MakeKey(table_name(), row_key, filter);
+    // The callback is called by this read, or by the read of the same row
+    // that was already in progress.
+    auto shared_callback =
+        std::make_shared<typename std::decay<Functor>::type>(
+            std::forward<Functor>(callback));
+    CompletionQueue callback_cq = cq;
+    auto on_pending = [callback_cq, shared_callback](
+                          std::pair<bool, Row> const& result,
+                          grpc::Status const& status) mutable {
+      callback_cq.RunAsync([shared_callback, result,
+                            status](CompletionQueue& cq) {
+        grpc::Status s = status;
+        (*shared_callback)(cq, result, s);
+      });
+    };
+    std::pair<bool, Row> result(false, Row("", {}));
+    switch (row_cache_->Lookup(key, result, std::move(on_pending))) {
+      case RowCache::LookupResult::HIT:
+        return cq.RunAsync(
+            [shared_callback, result](CompletionQueue& cq) {
+              grpc::Status status;
+              (*shared_callback)(cq, result, status);
+            });
+      case RowCache::LookupResult::PENDING:
+        return std::make_shared<internal::PendingRowCacheRead>();
+      case RowCache::LookupResult::MISS:
+        break;
+    }
+    auto row_cache = row_cache_;
+    auto populate_cache = [row_cache, key, shared_callback](
+                              CompletionQueue& cq, std::pair<bool, Row> result,
+                              grpc::Status const& status) {
+      row_cache->Complete(key, result, status);
+      grpc::Status s = status;
+      (*shared_callback)(cq, std::move(result), s);
+    };
+    return UncachedAsyncReadRow(cq, std::move(populate_cache),
+                                std::move(row_key), std::move(filter),
+                                raise_on_error);
+  }
+
+  //@{
+  /// @name Wrap the callback of an asynchronous mutation to update the cache.
+  template <typename Functor>
+  internal::InvalidateRowCacheAdapter<Functor> InvalidateRowCacheOnCompletion(
+      Functor&& callback, std::vector<std::string> row_keys) {
+    if (!row_cache_) {
+      return internal::InvalidateRowCacheAdapter<Functor>(
+          std::forward<Functor>(callback), {}, {}, {});
+    }
+    return internal::InvalidateRowCacheAdapter<Functor>(
+        std::forward<Functor>(callback), row_cache_, table_name(),
+        std::move(row_keys));
+  }
+
+  template <typename Functor>
+  internal::InvalidateRowCacheAdapter<Functor> InvalidateRowCacheOnCompletion(
+      Functor&& callback, std::string const& row_key) {
+    if (!row_cache_) {
+      return InvalidateRowCacheOnCompletion(std::forward<Functor>(callback),
+                                            std::vector<std::string>{});
+    }
+    return InvalidateRowCacheOnCompletion(std::forward<Functor>(callback),
+                                          std::vector<std::string>{row_key});
+  }
+  //@}
+
   /**
    * Send request ReadModifyWriteRowRequest to modify the row and get it back
    */
@@ -695,6 +1003,9 @@ class Table {
   std::shared_ptr<RPCBackoffPolicy> rpc_backoff_policy_;
   MetadataUpdatePolicy metadata_update_policy_;
   std::shared_ptr<IdempotentMutationPolicy> idempotent_mutation_policy_;
+  std::shared_ptr<HedgingPolicy> hedging_policy_;
+  BulkApplyOptions bulk_apply_options_;
+  std::shared_ptr<RowCache> row_cache_;
 };
 
 }  // namespace noex
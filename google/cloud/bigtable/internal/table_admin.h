@@ -20,12 +20,14 @@
 #include "google/cloud/bigtable/column_family.h"
 #include "google/cloud/bigtable/internal/async_check_consistency.h"
 #include "google/cloud/bigtable/internal/async_retry_unary_rpc.h"
+#include "google/cloud/bigtable/internal/async_retry_unary_rpc_and_poll.h"
 #include "google/cloud/bigtable/metadata_update_policy.h"
 #include "google/cloud/bigtable/polling_policy.h"
 #include "google/cloud/bigtable/rpc_backoff_policy.h"
 #include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/table_config.h"
 #include <google/bigtable/admin/v2/bigtable_table_admin.grpc.pb.h>
+#include <chrono>
 #include <future>
 #include <memory>
 #include <sstream>
@@ -356,6 +358,49 @@ class TableAdmin {
     return op->Start(cq, std::forward<Functor>(callback));
   }
 
+  /**
+   * Asynchronously wait until the replication catches up with a token.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * Unlike `AsyncAwaitConsistency()` the consistency token is provided by the
+   * caller. The table is polled, using timers in @p cq, until the replication
+   * has caught up or the polling policy expires.
+   *
+   * @param table_id the table to wait on.
+   * @param consistency_token the token returned by
+   *     `GenerateConsistencyToken()`.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param callback a functor to be called when the operation completes. It
+   *     must satisfy (using C++17 types):
+   *     static_assert(std::is_invocable_v<
+   *         Functor, CompletionQueue&, bool, grpc::Status&>);
+   * @return a handle to the submitted operation
+   *
+   * @tparam Functor the type of the callback.
+   */
+  template <typename Functor,
+            typename std::enable_if<
+                google::cloud::internal::is_invocable<
+                    Functor, CompletionQueue&, bool, grpc::Status&>::value,
+                int>::type valid_callback_type = 0>
+  std::shared_ptr<AsyncOperation> AsyncWaitForConsistencyCheck(
+      CompletionQueue& cq, Functor&& callback,
+      bigtable::TableId const& table_id,
+      bigtable::ConsistencyToken const& consistency_token) {
+    auto op = std::make_shared<internal::AsyncPollCheckConsistency<Functor>>(
+        __func__, polling_policy_->clone(),
+        MetadataUpdatePolicy(instance_name(), MetadataParamTypes::NAME,
+                             table_id.get()),
+        client_, consistency_token, TableName(table_id.get()),
+        std::forward<Functor>(callback));
+    return op->Start(cq);
+  }
+
   void DeleteSnapshot(bigtable::ClusterId const& cluster_id,
                       bigtable::SnapshotId const& snapshot_id,
                       grpc::Status& status);
@@ -609,6 +654,137 @@ class TableAdmin {
     return retry->Start(cq);
   }
 
+  /**
+   * Make an asynchronous request to create a snapshot and poll its result.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @warning This is a private alpha release of Cloud Bigtable snapshots. This
+   * feature is not currently available to most Cloud Bigtable customers. This
+   * feature might be changed in backward-incompatible ways and is not
+   * recommended for production use. It is not subject to any SLA or deprecation
+   * policy.
+   *
+   * @param cluster_id the cluster id to which snapshot is created.
+   * @param snapshot_id the id of the snapshot.
+   * @param table_id the id of the table for which snapshot is created.
+   * @param duration_ttl time to live for snapshot being created.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param callback a functor to be called when the operation completes. It
+   *     must satisfy (using C++17 types):
+   *     static_assert(std::is_invocable_v<
+   *         Functor, CompletionQueue&, google::bigtable::admin::v2::Snapshot&,
+   *         grpc::Status&>);
+   * @return a handle to the submitted operation
+   *
+   * @tparam Functor the type of the callback.
+   */
+  template <typename Functor,
+            typename std::enable_if<google::cloud::internal::is_invocable<
+                                        Functor, CompletionQueue&,
+                                        google::bigtable::admin::v2::Snapshot&,
+                                        grpc::Status&>::value,
+                                    int>::type valid_callback_type = 0>
+  std::shared_ptr<AsyncOperation> AsyncSnapshotTable(
+      CompletionQueue& cq, Functor&& callback,
+      bigtable::ClusterId const& cluster_id,
+      bigtable::SnapshotId const& snapshot_id,
+      bigtable::TableId const& table_id, std::chrono::seconds duration_ttl) {
+    google::bigtable::admin::v2::SnapshotTableRequest request;
+    request.set_name(TableName(table_id.get()));
+    request.set_cluster(ClusterName(cluster_id));
+    request.set_snapshot_id(snapshot_id.get());
+    request.mutable_ttl()->set_seconds(duration_ttl.count());
+    MetadataUpdatePolicy metadata_update_policy(
+        instance_name(), MetadataParamTypes::NAME, cluster_id, snapshot_id);
+
+    static_assert(internal::ExtractMemberFunctionType<decltype(
+                      &AdminClient::AsyncSnapshotTable)>::value,
+                  "Cannot extract member function type");
+    using MemberFunction =
+        typename internal::ExtractMemberFunctionType<decltype(
+            &AdminClient::AsyncSnapshotTable)>::MemberFunction;
+
+    using Operation = internal::AsyncRetryAndPollUnaryRpc<
+        AdminClient, google::bigtable::admin::v2::Snapshot, MemberFunction,
+        internal::ConstantIdempotencyPolicy, Functor>;
+
+    auto op = std::make_shared<Operation>(
+        __func__, polling_policy_->clone(), rpc_retry_policy_->clone(),
+        rpc_backoff_policy_->clone(), internal::ConstantIdempotencyPolicy(true),
+        metadata_update_policy, client_, &AdminClient::AsyncSnapshotTable,
+        std::move(request), std::forward<Functor>(callback));
+    return op->Start(cq);
+  }
+
+  /**
+   * Make an asynchronous request to create a table from a snapshot and poll
+   * its result.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @warning This is a private alpha release of Cloud Bigtable snapshots. This
+   * feature is not currently available to most Cloud Bigtable customers. This
+   * feature might be changed in backward-incompatible ways and is not
+   * recommended for production use. It is not subject to any SLA or deprecation
+   * policy.
+   *
+   * @param cluster_id the id of the cluster to which snapshot belongs.
+   * @param snapshot_id the id of the snapshot to which table belongs.
+   * @param table_id the id of the table which needs to be created.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param callback a functor to be called when the operation completes. It
+   *     must satisfy (using C++17 types):
+   *     static_assert(std::is_invocable_v<
+   *         Functor, CompletionQueue&, google::bigtable::admin::v2::Table&,
+   *         grpc::Status&>);
+   * @return a handle to the submitted operation
+   *
+   * @tparam Functor the type of the callback.
+   */
+  template <typename Functor,
+            typename std::enable_if<
+                google::cloud::internal::is_invocable<
+                    Functor, CompletionQueue&,
+                    google::bigtable::admin::v2::Table&, grpc::Status&>::value,
+                int>::type valid_callback_type = 0>
+  std::shared_ptr<AsyncOperation> AsyncCreateTableFromSnapshot(
+      CompletionQueue& cq, Functor&& callback,
+      bigtable::ClusterId const& cluster_id,
+      bigtable::SnapshotId const& snapshot_id, std::string table_id) {
+    google::bigtable::admin::v2::CreateTableFromSnapshotRequest request;
+    request.set_parent(instance_name());
+    request.set_source_snapshot(SnapshotName(cluster_id, snapshot_id));
+    request.set_table_id(std::move(table_id));
+
+    static_assert(internal::ExtractMemberFunctionType<decltype(
+                      &AdminClient::AsyncCreateTableFromSnapshot)>::value,
+                  "Cannot extract member function type");
+    using MemberFunction =
+        typename internal::ExtractMemberFunctionType<decltype(
+            &AdminClient::AsyncCreateTableFromSnapshot)>::MemberFunction;
+
+    using Operation = internal::AsyncRetryAndPollUnaryRpc<
+        AdminClient, google::bigtable::admin::v2::Table, MemberFunction,
+        internal::ConstantIdempotencyPolicy, Functor>;
+
+    auto op = std::make_shared<Operation>(
+        __func__, polling_policy_->clone(), rpc_retry_policy_->clone(),
+        rpc_backoff_policy_->clone(), internal::ConstantIdempotencyPolicy(true),
+        metadata_update_policy_, client_,
+        &AdminClient::AsyncCreateTableFromSnapshot, std::move(request),
+        std::forward<Functor>(callback));
+    return op->Start(cq);
+  }
+
   /**
    * Make an asynchronous request to delete a snapshot.
    *
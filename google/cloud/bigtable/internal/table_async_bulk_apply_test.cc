@@ -336,6 +336,150 @@ TEST_F(NoexTableAsyncBulkApplyTest, CancelledInTimer) {
   EXPECT_TRUE(mutator_finished);
 }
 
+/// An operation for a batch in the AsyncSplitBulkApply tests.
+struct FakeBatchOperation : public AsyncOperation {
+  void Cancel() override { cancelled = true; }
+
+  bool cancelled = false;
+};
+
+/// Record the batches started by AsyncSplitBulkApply.
+struct StartedBatch {
+  int index_offset;
+  std::vector<std::string> row_keys;
+  bigtable::internal::AsyncBulkApplyBatchCallback callback;
+  std::shared_ptr<FakeBatchOperation> op;
+};
+
+std::vector<bigtable::internal::BulkMutationBatch> MakeBatches(
+    std::vector<std::vector<std::string>> const& row_keys) {
+  std::vector<bigtable::internal::BulkMutationBatch> batches;
+  int offset = 0;
+  for (auto const& keys : row_keys) {
+    bt::BulkMutation mut;
+    for (auto const& k : keys) {
+      mut.emplace_back(
+          bt::SingleRowMutation(k, {bt::SetCell("fam", "col", 0_ms, "v")}));
+    }
+    batches.push_back(
+        bigtable::internal::BulkMutationBatch{std::move(mut), offset});
+    offset += static_cast<int>(keys.size());
+  }
+  return batches;
+}
+
+/// @test Verify that AsyncSplitBulkApply limits the concurrent batches.
+TEST_F(NoexTableAsyncBulkApplyTest, SplitConcurrency) {
+  std::vector<StartedBatch> started;
+  auto start_batch = [&started](
+                         CompletionQueue&,
+                         bigtable::internal::BulkMutationBatch batch,
+                         bigtable::internal::AsyncBulkApplyBatchCallback cb) {
+    btproto::MutateRowsRequest request;
+    batch.mutation.MoveTo(&request);
+    StartedBatch s{batch.index_offset, {}, std::move(cb),
+                   std::make_shared<FakeBatchOperation>()};
+    for (auto const& e : request.entries()) {
+      s.row_keys.push_back(e.row_key());
+    }
+    started.push_back(s);
+    return std::shared_ptr<AsyncOperation>(started.back().op);
+  };
+
+  int callback_count = 0;
+  std::vector<int> failed_indexes;
+  grpc::Status final_status;
+  auto callback = [&](CompletionQueue&, std::vector<FailedMutation>& failures,
+                      grpc::Status& status) {
+    ++callback_count;
+    for (auto const& f : failures) {
+      failed_indexes.push_back(f.original_index());
+    }
+    final_status = status;
+  };
+  using Operation = bigtable::internal::AsyncSplitBulkApply<decltype(callback)>;
+  auto op = std::make_shared<Operation>(
+      start_batch, MakeBatches({{"r0", "r1"}, {"r2", "r3"}, {"r4"}}), 2,
+      std::move(callback));
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  op->Start(cq);
+  ASSERT_EQ(2U, started.size());
+  EXPECT_EQ(0, started[0].index_offset);
+  EXPECT_EQ(2, started[1].index_offset);
+
+  google::rpc::Status failed;
+  failed.set_code(grpc::StatusCode::OUT_OF_RANGE);
+  std::vector<FailedMutation> f1{FailedMutation(
+      bt::SingleRowMutation("r3", {bt::SetCell("fam", "col", 0_ms, "v")}),
+      failed, 3)};
+  grpc::Status s1 = grpc::Status(grpc::StatusCode::INTERNAL, "failed");
+  started[1].callback(cq, f1, s1);
+  ASSERT_EQ(3U, started.size());
+  EXPECT_EQ(4, started[2].index_offset);
+  EXPECT_THAT(started[2].row_keys, ElementsAre("r4"));
+
+  std::vector<FailedMutation> f2{FailedMutation(
+      bt::SingleRowMutation("r4", {bt::SetCell("fam", "col", 0_ms, "v")}),
+      failed, 4)};
+  grpc::Status s2 = grpc::Status(grpc::StatusCode::INTERNAL, "failed");
+  started[2].callback(cq, f2, s2);
+  EXPECT_EQ(0, callback_count);
+
+  std::vector<FailedMutation> f0{FailedMutation(
+      bt::SingleRowMutation("r0", {bt::SetCell("fam", "col", 0_ms, "v")}),
+      failed, 0)};
+  grpc::Status s0 = grpc::Status(grpc::StatusCode::INTERNAL, "failed");
+  started[0].callback(cq, f0, s0);
+  EXPECT_EQ(1, callback_count);
+  EXPECT_THAT(failed_indexes, ElementsAre(0, 3, 4));
+  EXPECT_EQ(grpc::StatusCode::INTERNAL, final_status.error_code());
+}
+
+/// @test Verify that cancelling AsyncSplitBulkApply reports unsent batches.
+TEST_F(NoexTableAsyncBulkApplyTest, SplitCancel) {
+  std::vector<StartedBatch> started;
+  auto start_batch = [&started](
+                         CompletionQueue&,
+                         bigtable::internal::BulkMutationBatch batch,
+                         bigtable::internal::AsyncBulkApplyBatchCallback cb) {
+    started.push_back(StartedBatch{batch.index_offset, {}, std::move(cb),
+                                   std::make_shared<FakeBatchOperation>()});
+    return std::shared_ptr<AsyncOperation>(started.back().op);
+  };
+
+  int callback_count = 0;
+  std::vector<int> failed_indexes;
+  grpc::Status final_status;
+  auto callback = [&](CompletionQueue&, std::vector<FailedMutation>& failures,
+                      grpc::Status& status) {
+    ++callback_count;
+    for (auto const& f : failures) {
+      failed_indexes.push_back(f.original_index());
+    }
+    final_status = status;
+  };
+  using Operation = bigtable::internal::AsyncSplitBulkApply<decltype(callback)>;
+  auto op = std::make_shared<Operation>(
+      start_batch, MakeBatches({{"r0"}, {"r1", "r2"}, {"r3"}}), 1,
+      std::move(callback));
+  auto impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(impl);
+  auto handle = op->Start(cq);
+  ASSERT_EQ(1U, started.size());
+
+  handle->Cancel();
+  EXPECT_TRUE(started[0].op->cancelled);
+  std::vector<FailedMutation> none;
+  grpc::Status cancelled(grpc::StatusCode::CANCELLED, "cancelled");
+  started[0].callback(cq, none, cancelled);
+
+  EXPECT_EQ(1U, started.size());
+  EXPECT_EQ(1, callback_count);
+  EXPECT_THAT(failed_indexes, ElementsAre(1, 2, 3));
+  EXPECT_EQ(grpc::StatusCode::CANCELLED, final_status.error_code());
+}
+
 }  // namespace
 }  // namespace noex
 }  // namespace BIGTABLE_CLIENT_NS
@@ -181,6 +181,7 @@ struct UnaryClientUtils {
         break;
       }
       if (!rpc_policy.OnFailure(status)) {
+        status = rpc_policy.FinalStatus(status);
         std::string full_message = error_message;
         full_message += "(" + metadata_update_policy.value() + ") ";
         full_message += status.error_message();
@@ -238,6 +239,8 @@ struct UnaryClientUtils {
     status = (client.*function)(&client_context, request, &response);
 
     if (!status.ok()) {
+      // The call is not retried, but the policy may have rejected it.
+      status = rpc_policy->FinalStatus(status);
       std::string full_message = error_message;
       full_message += "(" + metadata_update_policy.value() + ") ";
       full_message += status.error_message();
@@ -0,0 +1,149 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/read_row_coalescer.h"
+#include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+ReadRowCoalescer::ReadRowCoalescer(Table const& table, std::size_t max_keys,
+                                   std::chrono::microseconds max_delay,
+                                   std::size_t thread_count)
+    : table_(table.impl_),
+      max_keys_((std::max)(max_keys, std::size_t(1))),
+      max_delay_(max_delay),
+      shutdown_(false),
+      read_count_(0),
+      batch_count_(0) {
+  thread_count = (std::max)(thread_count, std::size_t(1));
+  workers_.reserve(thread_count);
+  for (std::size_t i = 0; i != thread_count; ++i) {
+    workers_.emplace_back(&ReadRowCoalescer::WorkerLoop, this);
+  }
+}
+
+ReadRowCoalescer::~ReadRowCoalescer() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : workers_) {
+    t.join();
+  }
+}
+
+future<std::pair<bool, Row>> ReadRowCoalescer::AsyncReadRow(
+    std::string row_key, Filter filter) {
+  // Only reads with identical filters can share a request.
+  auto key = filter.as_proto().SerializeAsString();
+  promise<std::pair<bool, Row>> p;
+  auto result = p.get_future();
+
+  std::unique_lock<std::mutex> lk(mu_);
+  ++read_count_;
+  auto& batch = open_[key];
+  bool const new_batch = !batch;
+  if (new_batch) {
+    batch = google::cloud::internal::make_unique<Batch>(std::move(filter));
+    batch->deadline = std::chrono::steady_clock::now() + max_delay_;
+  }
+  batch->waiters[std::move(row_key)].push_back(std::move(p));
+  if (batch->waiters.size() >= max_keys_) {
+    ready_.push_back(std::move(batch));
+    open_.erase(key);
+  } else if (!new_batch) {
+    return result;
+  }
+  lk.unlock();
+  // Either a batch is ready to send, or there is a new deadline the workers
+  // need to wait for.
+  cv_.notify_one();
+  return result;
+}
+
+void ReadRowCoalescer::WorkerLoop() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    auto const now = std::chrono::steady_clock::now();
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    for (auto i = open_.begin(); i != open_.end();) {
+      if (shutdown_ || i->second->deadline <= now) {
+        ready_.push_back(std::move(i->second));
+        i = open_.erase(i);
+        continue;
+      }
+      next_deadline = (std::min)(next_deadline, i->second->deadline);
+      ++i;
+    }
+    if (!ready_.empty()) {
+      auto batch = std::move(ready_.front());
+      ready_.pop_front();
+      ++batch_count_;
+      lk.unlock();
+      SendBatch(*batch);
+      lk.lock();
+      continue;
+    }
+    if (shutdown_) {
+      return;
+    }
+    if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+      cv_.wait(lk);
+    } else {
+      cv_.wait_until(lk, next_deadline);
+    }
+  }
+}
+
+void ReadRowCoalescer::SendBatch(Batch& batch) {
+  RowSet row_set;
+  for (auto const& kv : batch.waiters) {
+    row_set.Append(kv.first);
+  }
+  auto reader = table_.ReadRows(std::move(row_set), std::move(batch.filter),
+                                /*raise_on_error=*/false);
+  for (auto& row : reader) {
+    auto w = batch.waiters.find(row.row_key());
+    if (w == batch.waiters.end()) {
+      continue;
+    }
+    auto waiters = std::move(w->second);
+    batch.waiters.erase(w);
+    for (std::size_t i = 0; i + 1 < waiters.size(); ++i) {
+      waiters[i].set_value(std::make_pair(true, row));
+    }
+    waiters.back().set_value(std::make_pair(true, std::move(row)));
+  }
+  auto status = reader.Finish();
+  for (auto& kv : batch.waiters) {
+    for (auto& p : kv.second) {
+      if (!status.ok()) {
+        p.set_exception(std::make_exception_ptr(
+            GRpcError("ReadRowCoalescer::AsyncReadRow", status)));
+        continue;
+      }
+      p.set_value(std::make_pair(false, Row("", {})));
+    }
+  }
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
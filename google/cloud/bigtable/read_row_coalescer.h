@@ -0,0 +1,151 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_READ_ROW_COALESCER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_READ_ROW_COALESCER_H_
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/future.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Combine concurrent point reads into a single `ReadRows()` request.
+ *
+ * Applications that read many individual rows from many threads pay for a
+ * separate streaming RPC for each `Table::ReadRow()` call. This class collects
+ * the point reads that use the same filter, and sends them as a single
+ * `ReadRows()` request with a multi-key `RowSet`. The rows returned by the
+ * service, as well as the rows that were not found, are delivered to each
+ * caller through a `google::cloud::future<>`.
+ *
+ * A batch of keys is sent when it reaches `max_keys` distinct keys, or when
+ * the oldest read in the batch has waited for `max_delay`, whichever happens
+ * first. Reads for the same key in the same batch share the result.
+ *
+ * Batches are sent by a small pool of background threads owned by this
+ * object. The destructor sends any pending batches and waits for all the
+ * requests to complete.
+ *
+ * @par Example
+ * @code
+ * bigtable::Table table(client, "my-table");
+ * bigtable::ReadRowCoalescer coalescer(table);
+ * auto f = coalescer.AsyncReadRow("row-key", bigtable::Filter::Latest(1));
+ * // ... do something else ...
+ * std::pair<bool, bigtable::Row> result = f.get();
+ * @endcode
+ *
+ * @par Thread-safety
+ * Instances of this class are meant to be shared by many threads, all the
+ * member functions are thread-safe.
+ */
+class ReadRowCoalescer {
+ public:
+  /**
+   * Create a coalescer for the rows in @p table.
+   *
+   * @param table the table to read from. The coalescer uses a copy of this
+   *     object, including its retry, backoff and metadata policies.
+   * @param max_keys send a batch as soon as it contains this many keys.
+   * @param max_delay the maximum time a read waits for other reads to join
+   *     its batch.
+   * @param thread_count the number of threads sending batches.
+   */
+  explicit ReadRowCoalescer(
+      Table const& table, std::size_t max_keys = 100,
+      std::chrono::microseconds max_delay = std::chrono::milliseconds(2),
+      std::size_t thread_count = 4);
+
+  ReadRowCoalescer(ReadRowCoalescer const&) = delete;
+  ReadRowCoalescer& operator=(ReadRowCoalescer const&) = delete;
+
+  /// Send all the pending reads and wait for them to complete.
+  ~ReadRowCoalescer();
+
+  /**
+   * Read a single row, combining the request with other concurrent reads.
+   *
+   * @return a future satisfied with the same value as `Table::ReadRow()` would
+   *     return. If the batched `ReadRows()` request fails, the future is
+   *     satisfied with a `bigtable::GRpcError` exception.
+   */
+  future<std::pair<bool, Row>> AsyncReadRow(std::string row_key,
+                                            Filter filter);
+
+  /// Read a single row, blocking until the batch that contains it completes.
+  std::pair<bool, Row> ReadRow(std::string row_key, Filter filter) {
+    return AsyncReadRow(std::move(row_key), std::move(filter)).get();
+  }
+
+  /// The number of calls to `AsyncReadRow()` or `ReadRow()`.
+  std::int64_t read_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return read_count_;
+  }
+
+  /// The number of `ReadRows()` requests sent to the service.
+  std::int64_t batch_count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return batch_count_;
+  }
+
+ private:
+  struct Batch {
+    explicit Batch(Filter f) : filter(std::move(f)) {}
+
+    Filter filter;
+    std::chrono::steady_clock::time_point deadline;
+    std::map<std::string, std::vector<promise<std::pair<bool, Row>>>> waiters;
+  };
+
+  void WorkerLoop();
+  void SendBatch(Batch& batch);
+
+  noex::Table table_;
+  std::size_t const max_keys_;
+  std::chrono::microseconds const max_delay_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  /// The batches accepting new keys, indexed by the serialized filter.
+  std::map<std::string, std::unique_ptr<Batch>> open_;
+  /// The batches that are full or expired, waiting for a thread.
+  std::deque<std::unique_ptr<Batch>> ready_;
+  bool shutdown_;
+  std::int64_t read_count_;
+  std::int64_t batch_count_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_READ_ROW_COALESCER_H_
@@ -0,0 +1,158 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/read_row_coalescer.h"
+#include "google/cloud/bigtable/grpc_error.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace ::testing;
+
+namespace {
+class ReadRowCoalescerTest : public bigtable::testing::TableTestFixture {};
+using bigtable::testing::MockReadRowsReader;
+
+/// A stream returning one row for each key in @p keys.
+MockReadRowsReader* MakeStream(std::vector<std::string> const& keys,
+                               grpc::Status status = grpc::Status::OK) {
+  btproto::ReadRowsResponse response;
+  for (auto const& key : keys) {
+    auto& chunk = *response.add_chunks();
+    chunk.set_row_key(key);
+    chunk.mutable_family_name()->set_value("fam");
+    chunk.mutable_qualifier()->set_value("col");
+    chunk.set_timestamp_micros(42000);
+    chunk.set_value("value-" + key);
+    chunk.set_commit_row(true);
+  }
+  // must be a new pointer, it is wrapped in unique_ptr by ReadRows
+  auto stream = new MockReadRowsReader;
+  if (keys.empty()) {
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+  } else {
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+        .WillOnce(Return(false));
+  }
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(status));
+  return stream;
+}
+}  // anonymous namespace
+
+/// @test Verify that concurrent reads are sent as a single request.
+TEST_F(ReadRowCoalescerTest, CombinesReads) {
+  auto stream = MakeStream({"r1", "r3"});
+  std::vector<std::string> requested;
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([stream, &requested](grpc::ClientContext*,
+                                            btproto::ReadRowsRequest const& r) {
+        for (auto const& key : r.rows().row_keys()) {
+          requested.push_back(key);
+        }
+        return stream->AsUniqueMocked();
+      }));
+
+  bigtable::ReadRowCoalescer coalescer(table_, 3, std::chrono::hours(1), 1);
+  auto filter = bigtable::Filter::Latest(1);
+  auto f1 = coalescer.AsyncReadRow("r1", filter);
+  auto f2 = coalescer.AsyncReadRow("r2", filter);
+  auto f3 = coalescer.AsyncReadRow("r3", filter);
+
+  auto r1 = f1.get();
+  EXPECT_TRUE(r1.first);
+  EXPECT_EQ("r1", r1.second.row_key());
+  ASSERT_EQ(1U, r1.second.cells().size());
+  EXPECT_EQ("value-r1", r1.second.cells().front().value());
+  EXPECT_FALSE(f2.get().first);
+  auto r3 = f3.get();
+  EXPECT_TRUE(r3.first);
+  EXPECT_EQ("r3", r3.second.row_key());
+
+  EXPECT_THAT(requested, ElementsAre("r1", "r2", "r3"));
+  EXPECT_EQ(3, coalescer.read_count());
+  EXPECT_EQ(1, coalescer.batch_count());
+}
+
+/// @test Verify that reads for the same key share the result.
+TEST_F(ReadRowCoalescerTest, DuplicateKeys) {
+  auto stream = MakeStream({"r1"});
+  int key_count = 0;
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke([stream, &key_count](grpc::ClientContext*,
+                                            btproto::ReadRowsRequest const& r) {
+        key_count = r.rows().row_keys_size();
+        return stream->AsUniqueMocked();
+      }));
+
+  bigtable::ReadRowCoalescer coalescer(table_, 100,
+                                       std::chrono::milliseconds(1), 1);
+  auto f1 = coalescer.AsyncReadRow("r1", bigtable::Filter::PassAllFilter());
+  auto f2 = coalescer.AsyncReadRow("r1", bigtable::Filter::PassAllFilter());
+
+  auto r1 = f1.get();
+  auto r2 = f2.get();
+  EXPECT_TRUE(r1.first);
+  EXPECT_TRUE(r2.first);
+  EXPECT_EQ("r1", r1.second.row_key());
+  EXPECT_EQ("r1", r2.second.row_key());
+  EXPECT_EQ(1, key_count);
+}
+
+/// @test Verify that reads with different filters use different requests.
+TEST_F(ReadRowCoalescerTest, DifferentFilters) {
+  auto s1 = MakeStream({"r1"});
+  auto s2 = MakeStream({"r2"});
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(s1->MakeMockReturner()))
+      .WillOnce(Invoke(s2->MakeMockReturner()));
+
+  bigtable::ReadRowCoalescer coalescer(table_, 100, std::chrono::hours(1), 1);
+  auto f1 = coalescer.AsyncReadRow("r1", bigtable::Filter::Latest(1));
+  auto f2 = coalescer.AsyncReadRow("r2", bigtable::Filter::Latest(2));
+  // The destructor sends the pending batches.
+  EXPECT_EQ(2, coalescer.read_count());
+  EXPECT_EQ(0, coalescer.batch_count());
+}
+
+/// @test Verify that the batch is sent when the delay expires.
+TEST_F(ReadRowCoalescerTest, DelayExpires) {
+  auto stream = MakeStream({});
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  bigtable::ReadRowCoalescer coalescer(table_, 100,
+                                       std::chrono::milliseconds(5), 2);
+  auto f = coalescer.AsyncReadRow("r1", bigtable::Filter::PassAllFilter());
+  auto result = f.get();
+  EXPECT_FALSE(result.first);
+  EXPECT_EQ(1, coalescer.batch_count());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that errors are reported to all the callers in the batch.
+TEST_F(ReadRowCoalescerTest, PermanentFailure) {
+  auto stream = MakeStream(
+      {}, grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh"));
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  bigtable::ReadRowCoalescer coalescer(table_, 2, std::chrono::hours(1), 1);
+  auto f1 = coalescer.AsyncReadRow("r1", bigtable::Filter::PassAllFilter());
+  auto f2 = coalescer.AsyncReadRow("r2", bigtable::Filter::PassAllFilter());
+  EXPECT_THROW(f1.get(), bigtable::GRpcError);
+  EXPECT_THROW(f2.get(), bigtable::GRpcError);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -0,0 +1,136 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/retry_budget.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+RetryBudget::RetryBudget(double retry_ratio, double minimum_retries_per_second,
+                         std::chrono::seconds window)
+    : retry_ratio_(std::max(retry_ratio, 0.0)),
+      minimum_retries_per_second_(std::max(minimum_retries_per_second, 0.0)),
+      buckets_(static_cast<std::size_t>(
+                   std::max<std::int64_t>(window.count(), 1)),
+               Bucket{-1, 0, 0}),
+      success_count_(0),
+      retry_count_(0),
+      rejected_retry_count_(0) {}
+
+void RetryBudget::OnSuccess() {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++CurrentBucket().successes;
+  ++success_count_;
+}
+
+bool RetryBudget::OnRetry() {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& current = CurrentBucket();
+  std::uint64_t successes = 0;
+  std::uint64_t retries = 0;
+  auto const oldest =
+      current.second - static_cast<std::int64_t>(buckets_.size());
+  for (auto const& b : buckets_) {
+    // Buckets are only reset when reused, skip any that fell out of the window.
+    if (b.second > oldest) {
+      successes += b.successes;
+      retries += b.retries;
+    }
+  }
+  auto const allowed =
+      retry_ratio_ * static_cast<double>(successes) +
+      minimum_retries_per_second_ * static_cast<double>(buckets_.size());
+  if (static_cast<double>(retries) >= allowed) {
+    ++rejected_retry_count_;
+    return false;
+  }
+  ++current.retries;
+  ++retry_count_;
+  return true;
+}
+
+std::uint64_t RetryBudget::success_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return success_count_;
+}
+
+std::uint64_t RetryBudget::retry_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return retry_count_;
+}
+
+std::uint64_t RetryBudget::rejected_retry_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return rejected_retry_count_;
+}
+
+RetryBudget::Bucket& RetryBudget::CurrentBucket() {
+  auto const second = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+  auto& bucket = buckets_[static_cast<std::size_t>(second) % buckets_.size()];
+  if (bucket.second != second) {
+    bucket = Bucket{second, 0, 0};
+  }
+  return bucket;
+}
+
+BudgetedRetryPolicy::BudgetedRetryPolicy(RPCRetryPolicy const& policy,
+                                         std::shared_ptr<RetryBudget> budget)
+    : policy_(policy.clone()),
+      budget_(std::move(budget)),
+      attempt_pending_(false),
+      retry_rejected_(false) {}
+
+BudgetedRetryPolicy::~BudgetedRetryPolicy() {
+  if (attempt_pending_) {
+    budget_->OnSuccess();
+  }
+}
+
+std::unique_ptr<RPCRetryPolicy> BudgetedRetryPolicy::clone() const {
+  return std::unique_ptr<RPCRetryPolicy>(
+      new BudgetedRetryPolicy(*policy_, budget_));
+}
+
+void BudgetedRetryPolicy::Setup(grpc::ClientContext& context) const {
+  policy_->Setup(context);
+  attempt_pending_ = true;
+}
+
+bool BudgetedRetryPolicy::OnFailure(grpc::Status const& status) {
+  attempt_pending_ = false;
+  if (!policy_->OnFailure(status)) {
+    return false;
+  }
+  retry_rejected_ = !budget_->OnRetry();
+  return !retry_rejected_;
+}
+
+grpc::Status BudgetedRetryPolicy::FinalStatus(
+    grpc::Status const& status) const {
+  if (retry_rejected_) {
+    return grpc::Status(
+        grpc::StatusCode::RESOURCE_EXHAUSTED,
+        "retry budget exhausted, last error: " + status.error_message());
+  }
+  return policy_->FinalStatus(status);
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,141 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_RETRY_BUDGET_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_RETRY_BUDGET_H_
+
+#include "google/cloud/bigtable/rpc_retry_policy.h"
+#include "google/cloud/bigtable/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/**
+ * Limit the retries to a fraction of the successful calls.
+ *
+ * During a partial outage each operation retries independently, and the
+ * retries multiply the load on a service that is already struggling. A retry
+ * budget is shared by many operations, and allows a retry only if the number
+ * of retries in a sliding window is below:
+ *
+ * `retry_ratio * successful_calls + minimum_retries_per_second * window`
+ *
+ * The second term allows a small number of retries when there is little or no
+ * successful traffic.
+ *
+ * This class is thread-safe, use it with `BudgetedRetryPolicy`.
+ */
+class RetryBudget {
+ public:
+  /**
+   * Create a budget.
+   *
+   * @param retry_ratio the number of retries allowed for each successful call.
+   * @param minimum_retries_per_second the retries allowed regardless of the
+   *     successful calls.
+   * @param window the length of the sliding window, in seconds.
+   */
+  explicit RetryBudget(double retry_ratio = 0.1,
+                       double minimum_retries_per_second = 10.0,
+                       std::chrono::seconds window = std::chrono::seconds(10));
+
+  /// Record a successful call.
+  void OnSuccess();
+
+  /**
+   * Record a retry if the budget allows it.
+   *
+   * @return true if the retry is allowed.
+   */
+  bool OnRetry();
+
+  /// The number of successful calls recorded.
+  std::uint64_t success_count() const;
+
+  /// The number of retries allowed.
+  std::uint64_t retry_count() const;
+
+  /// The number of retries rejected because the budget was exhausted.
+  std::uint64_t rejected_retry_count() const;
+
+ private:
+  struct Bucket {
+    std::int64_t second;
+    std::uint64_t successes;
+    std::uint64_t retries;
+  };
+
+  Bucket& CurrentBucket();
+
+  double retry_ratio_;
+  double minimum_retries_per_second_;
+
+  mutable std::mutex mu_;
+  std::vector<Bucket> buckets_;
+  std::uint64_t success_count_;
+  std::uint64_t retry_count_;
+  std::uint64_t rejected_retry_count_;
+};
+
+/**
+ * Decorate a retry policy to share a `RetryBudget` across operations.
+ *
+ * Each clone of this policy (the library clones the policy for each
+ * operation) shares the same budget. A failed attempt is retried only if the
+ * decorated policy allows it *and* the budget is not exhausted. If the budget
+ * stops the operation it reports `RESOURCE_EXHAUSTED`, with a message that
+ * includes the last error returned by the service.
+ *
+ * @par Example
+ * @code
+ * auto budget = std::make_shared<bigtable::RetryBudget>(0.1);
+ * bigtable::Table table(data_client, "my-table",
+ *                       bigtable::BudgetedRetryPolicy(
+ *                           bigtable::LimitedErrorCountRetryPolicy(5),
+ *                           budget));
+ * @endcode
+ */
+class BudgetedRetryPolicy : public RPCRetryPolicy {
+ public:
+  BudgetedRetryPolicy(RPCRetryPolicy const& policy,
+                      std::shared_ptr<RetryBudget> budget);
+  ~BudgetedRetryPolicy() override;
+
+  std::unique_ptr<RPCRetryPolicy> clone() const override;
+  void Setup(grpc::ClientContext& context) const override;
+  bool OnFailure(grpc::Status const& status) override;
+  grpc::Status FinalStatus(grpc::Status const& status) const override;
+
+ private:
+  std::unique_ptr<RPCRetryPolicy> policy_;
+  std::shared_ptr<RetryBudget> budget_;
+  // `Setup()` is called before each attempt, and `OnFailure()` after each
+  // failed attempt. If the last attempt has not failed when the policy is
+  // destroyed the call succeeded.
+  mutable bool attempt_pending_;
+  bool retry_rejected_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_RETRY_BUDGET_H_
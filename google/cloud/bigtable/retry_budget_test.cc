@@ -0,0 +1,106 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/retry_budget.h"
+#include <gmock/gmock.h>
+
+namespace {
+namespace bigtable = google::cloud::bigtable;
+using ::testing::HasSubstr;
+
+grpc::Status CreateTransientError() {
+  return grpc::Status(grpc::StatusCode::UNAVAILABLE, "please try again");
+}
+
+}  // anonymous namespace
+
+/// @test Verify that retries are limited to a fraction of the successes.
+TEST(RetryBudgetTest, RatioOfSuccesses) {
+  bigtable::RetryBudget tested(0.5, 0.0);
+  EXPECT_FALSE(tested.OnRetry());
+
+  for (int i = 0; i != 4; ++i) {
+    tested.OnSuccess();
+  }
+  EXPECT_TRUE(tested.OnRetry());
+  EXPECT_TRUE(tested.OnRetry());
+  EXPECT_FALSE(tested.OnRetry());
+
+  EXPECT_EQ(4U, tested.success_count());
+  EXPECT_EQ(2U, tested.retry_count());
+  EXPECT_EQ(2U, tested.rejected_retry_count());
+}
+
+/// @test Verify that some retries are allowed without successful calls.
+TEST(RetryBudgetTest, MinimumRetries) {
+  bigtable::RetryBudget tested(0.1, 1.0, std::chrono::seconds(3));
+  EXPECT_TRUE(tested.OnRetry());
+  EXPECT_TRUE(tested.OnRetry());
+  EXPECT_TRUE(tested.OnRetry());
+  EXPECT_FALSE(tested.OnRetry());
+}
+
+/// @test Verify that all clones of the policy share the budget.
+TEST(BudgetedRetryPolicyTest, ClonesShareBudget) {
+  auto budget = std::make_shared<bigtable::RetryBudget>(1.0, 0.0);
+  bigtable::BudgetedRetryPolicy prototype(
+      bigtable::LimitedErrorCountRetryPolicy(10), budget);
+
+  // A call that succeeds in the first attempt.
+  {
+    auto policy = prototype.clone();
+    grpc::ClientContext context;
+    policy->Setup(context);
+  }
+  EXPECT_EQ(1U, budget->success_count());
+
+  auto first = prototype.clone();
+  auto second = prototype.clone();
+  grpc::ClientContext context;
+  first->Setup(context);
+  EXPECT_TRUE(first->OnFailure(CreateTransientError()));
+  second->Setup(context);
+  EXPECT_FALSE(second->OnFailure(CreateTransientError()));
+  EXPECT_EQ(1U, budget->retry_count());
+  EXPECT_EQ(1U, budget->rejected_retry_count());
+
+  // The operation stopped by the budget reports it, with the last error.
+  auto status = second->FinalStatus(CreateTransientError());
+  EXPECT_EQ(grpc::StatusCode::RESOURCE_EXHAUSTED, status.error_code());
+  EXPECT_THAT(status.error_message(), HasSubstr("retry budget exhausted"));
+  EXPECT_THAT(status.error_message(), HasSubstr("please try again"));
+
+  // Permanent errors are not retried and do not consume the budget.
+  grpc::Status failed(grpc::StatusCode::FAILED_PRECONDITION, "failed");
+  EXPECT_FALSE(first->OnFailure(failed));
+  EXPECT_EQ(1U, budget->rejected_retry_count());
+  status = first->FinalStatus(failed);
+  EXPECT_EQ(grpc::StatusCode::FAILED_PRECONDITION, status.error_code());
+  EXPECT_EQ("failed", status.error_message());
+}
+
+/// @test Verify that the decorated policy still limits the retries.
+TEST(BudgetedRetryPolicyTest, DecoratedPolicyLimits) {
+  auto budget = std::make_shared<bigtable::RetryBudget>(1.0, 100.0);
+  bigtable::BudgetedRetryPolicy prototype(
+      bigtable::LimitedErrorCountRetryPolicy(2), budget);
+  auto tested = prototype.clone();
+  EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+  EXPECT_TRUE(tested->OnFailure(CreateTransientError()));
+  EXPECT_FALSE(tested->OnFailure(CreateTransientError()));
+  EXPECT_EQ(2U, budget->retry_count());
+  // The decorated policy stopped the operation, report the service error.
+  EXPECT_EQ(grpc::StatusCode::UNAVAILABLE,
+            tested->FinalStatus(CreateTransientError()).error_code());
+}
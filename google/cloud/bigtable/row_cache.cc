@@ -0,0 +1,189 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_cache.h"
+#include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+#include <iterator>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/// Estimate the memory used by an entry, including the container overhead.
+std::size_t EntrySize(std::size_t key_bytes, Row const& row) {
+  // Each entry is stored in a list node and a map node, both have a copy of
+  // the key.
+  std::size_t bytes = 128 + 2 * key_bytes + row.row_key().size();
+  for (auto const& cell : row.cells()) {
+    bytes += sizeof(Cell) + cell.row_key().size() +
+             cell.family_name().size() + cell.column_qualifier().size() +
+             cell.value().size();
+    for (auto const& label : cell.labels()) {
+      bytes += sizeof(std::string) + label.size();
+    }
+  }
+  return bytes;
+}
+}  // anonymous namespace
+
+RowCache::RowCache(std::size_t max_bytes, std::chrono::milliseconds ttl,
+                   std::chrono::milliseconds negative_ttl,
+                   std::size_t shard_count)
+    : max_shard_bytes_(max_bytes / (std::max)(shard_count, std::size_t(1))),
+      ttl_(ttl),
+      negative_ttl_(negative_ttl),
+      hit_count_(0),
+      miss_count_(0),
+      coalesced_count_(0),
+      eviction_count_(0) {
+  shard_count = (std::max)(shard_count, std::size_t(1));
+  shards_.reserve(shard_count);
+  for (std::size_t i = 0; i != shard_count; ++i) {
+    shards_.push_back(google::cloud::internal::make_unique<Shard>());
+  }
+}
+
+void RowCache::Invalidate(std::string const& table_name,
+                          std::string const& row_key) {
+  auto& shard = ShardFor(table_name, row_key);
+  Key const first(table_name, row_key, std::string());
+  auto same_row = [&table_name, &row_key](Key const& key) {
+    return std::get<0>(key) == table_name && std::get<1>(key) == row_key;
+  };
+
+  std::lock_guard<std::mutex> lk(shard.mu);
+  for (auto i = shard.entries.lower_bound(first);
+       i != shard.entries.end() && same_row(i->first);) {
+    auto next = std::next(i);
+    EraseEntry(shard, i);
+    i = next;
+  }
+  // A read in progress may have fetched the row before the mutation, its
+  // result is delivered to the callers but not cached.
+  for (auto i = shard.flights.lower_bound(first);
+       i != shard.flights.end() && same_row(i->first); ++i) {
+    i->second->invalidated = true;
+  }
+}
+
+void RowCache::Clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    shard->entries.clear();
+    shard->lru.clear();
+    shard->bytes = 0;
+    for (auto& kv : shard->flights) {
+      kv.second->invalidated = true;
+    }
+  }
+}
+
+std::size_t RowCache::size_bytes() const {
+  std::size_t bytes = 0;
+  for (auto const& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    bytes += shard->bytes;
+  }
+  return bytes;
+}
+
+RowCache::Key RowCache::MakeKey(std::string const& table_name,
+                                std::string row_key, Filter const& filter) {
+  return Key(table_name, std::move(row_key),
+             filter.as_proto().SerializeAsString());
+}
+
+RowCache::LookupResult RowCache::Lookup(Key const& key,
+                                        std::pair<bool, Row>& result,
+                                        Callback callback) {
+  auto& shard = ShardFor(std::get<0>(key), std::get<1>(key));
+  std::lock_guard<std::mutex> lk(shard.mu);
+  auto i = shard.entries.find(key);
+  if (i != shard.entries.end()) {
+    if (i->second->expiration > std::chrono::steady_clock::now()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, i->second);
+      result = i->second->value;
+      ++hit_count_;
+      return LookupResult::HIT;
+    }
+    EraseEntry(shard, i);
+  }
+  auto& flight = shard.flights[key];
+  if (flight) {
+    flight->callbacks.push_back(std::move(callback));
+    ++coalesced_count_;
+    return LookupResult::PENDING;
+  }
+  flight = std::make_shared<Flight>();
+  ++miss_count_;
+  return LookupResult::MISS;
+}
+
+void RowCache::Complete(Key const& key, std::pair<bool, Row> const& result,
+                        grpc::Status const& status) {
+  auto& shard = ShardFor(std::get<0>(key), std::get<1>(key));
+  std::unique_lock<std::mutex> lk(shard.mu);
+  auto f = shard.flights.find(key);
+  if (f == shard.flights.end()) {
+    return;
+  }
+  auto flight = std::move(f->second);
+  shard.flights.erase(f);
+
+  auto const ttl = result.first ? ttl_ : negative_ttl_;
+  auto const bytes = EntrySize(std::get<0>(key).size() +
+                                   std::get<1>(key).size() +
+                                   std::get<2>(key).size(),
+                               result.second);
+  if (status.ok() && !flight->invalidated && ttl.count() > 0 &&
+      bytes <= max_shard_bytes_) {
+    auto i = shard.entries.find(key);
+    if (i != shard.entries.end()) {
+      EraseEntry(shard, i);
+    }
+    shard.lru.push_front(
+        Entry{key, result, bytes, std::chrono::steady_clock::now() + ttl});
+    shard.entries.emplace(key, shard.lru.begin());
+    shard.bytes += bytes;
+    while (shard.bytes > max_shard_bytes_) {
+      EraseEntry(shard, shard.entries.find(shard.lru.back().key));
+      ++eviction_count_;
+    }
+  }
+  lk.unlock();
+
+  for (auto& callback : flight->callbacks) {
+    callback(result, status);
+  }
+}
+
+RowCache::Shard& RowCache::ShardFor(std::string const& table_name,
+                                    std::string const& row_key) {
+  std::hash<std::string> hash;
+  auto const h = hash(row_key) ^ (hash(table_name) * 31);
+  return *shards_[h % shards_.size()];
+}
+
+void RowCache::EraseEntry(Shard& shard, EntryMap::iterator i) {
+  shard.bytes -= i->second->bytes;
+  shard.lru.erase(i->second);
+  shard.entries.erase(i);
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,198 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_CACHE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_CACHE_H_
+
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/row.h"
+#include "google/cloud/bigtable/version.h"
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace noex {
+class Table;
+}  // namespace noex
+
+/**
+ * A size-bounded cache for the results of `Table::ReadRow()`.
+ *
+ * When a `Table` is configured with a row cache, `ReadRow()` and
+ * `AsyncReadRow()` return a cached copy of the row if the same row was read
+ * recently with the same filter. Rows that do not exist are also cached (for
+ * a shorter time by default), so repeated reads of a missing row do not reach
+ * the service either.
+ *
+ * Concurrent reads of a row that is not in the cache share a single request,
+ * the first read sends it and the other reads wait for its result. Failed
+ * reads are never cached.
+ *
+ * Mutations sent through a `Table` configured with the cache (`Apply()`,
+ * `BulkApply()`, `CheckAndMutateRow()`, `ReadModifyWriteRow()` and their
+ * asynchronous versions) remove the affected rows from the cache when they
+ * complete. Mutations sent through other `Table` objects, or by other
+ * processes, are only observed when the cached entries expire.
+ *
+ * The cache is shared by all the copies of a `Table`, and can be shared by
+ * several tables, the entries are keyed by the table name, the row key and
+ * the filter.
+ *
+ * @par Example
+ * @code
+ * auto cache = std::make_shared<bigtable::RowCache>(64 * 1024 * 1024);
+ * bigtable::Table table(client, "my-table", cache);
+ * auto row = table.ReadRow("hot-row", bigtable::Filter::Latest(1));
+ * @endcode
+ *
+ * @par Thread-safety
+ * Instances of this class are meant to be shared by many threads, all the
+ * member functions are thread-safe. The entries are split into shards with
+ * their own lock, reads of different rows rarely contend with each other.
+ */
+class RowCache {
+ public:
+  /**
+   * Create a row cache.
+   *
+   * @param max_bytes the approximate maximum memory used by the cached rows.
+   *     The least recently used rows are evicted to stay under this limit.
+   * @param ttl how long a row is returned from the cache after it is read.
+   * @param negative_ttl how long a missing row is returned from the cache
+   *     after it is read. Use zero to disable caching missing rows.
+   * @param shard_count the number of independently locked shards.
+   */
+  explicit RowCache(
+      std::size_t max_bytes,
+      std::chrono::milliseconds ttl = std::chrono::seconds(10),
+      std::chrono::milliseconds negative_ttl = std::chrono::seconds(1),
+      std::size_t shard_count = 16);
+
+  RowCache(RowCache const&) = delete;
+  RowCache& operator=(RowCache const&) = delete;
+
+  /// Remove all the cached entries for @p row_key in @p table_name.
+  void Invalidate(std::string const& table_name, std::string const& row_key);
+
+  /// Remove all the cached entries.
+  void Clear();
+
+  /// The number of reads returned from the cache.
+  std::int64_t hit_count() const { return hit_count_.load(); }
+
+  /// The number of reads sent to the service.
+  std::int64_t miss_count() const { return miss_count_.load(); }
+
+  /// The number of reads that waited for a concurrent read of the same row.
+  std::int64_t coalesced_count() const { return coalesced_count_.load(); }
+
+  /// The number of entries removed to stay under the memory limit.
+  std::int64_t eviction_count() const { return eviction_count_.load(); }
+
+  /// The approximate memory used by the cached entries.
+  std::size_t size_bytes() const;
+
+ private:
+  friend class noex::Table;
+
+  /// Table name, row key and serialized filter.
+  using Key = std::tuple<std::string, std::string, std::string>;
+  using Callback =
+      std::function<void(std::pair<bool, Row> const&, grpc::Status const&)>;
+
+  /// The outcome of `Lookup()`.
+  enum class LookupResult {
+    /// The result was found in the cache.
+    HIT,
+    /// Another read of the same row is in progress, the callback will be
+    /// called when it completes.
+    PENDING,
+    /// The caller must read the row and then call `Complete()`.
+    MISS,
+  };
+
+  static Key MakeKey(std::string const& table_name, std::string row_key,
+                     Filter const& filter);
+
+  /**
+   * Find @p key in the cache, or join the read in progress for it.
+   *
+   * @p callback is only used (and called later) when the result is `PENDING`.
+   */
+  LookupResult Lookup(Key const& key, std::pair<bool, Row>& result,
+                      Callback callback);
+
+  /// Store the result of a `MISS` and deliver it to any `PENDING` reads.
+  void Complete(Key const& key, std::pair<bool, Row> const& result,
+                grpc::Status const& status);
+
+  struct Entry {
+    Key key;
+    std::pair<bool, Row> value;
+    std::size_t bytes;
+    std::chrono::steady_clock::time_point expiration;
+  };
+
+  struct Flight {
+    std::vector<Callback> callbacks;
+    /// Set if a mutation completed while the read was in progress.
+    bool invalidated = false;
+  };
+
+  using EntryMap = std::map<Key, std::list<Entry>::iterator>;
+
+  struct Shard {
+    std::mutex mu;
+    /// The most recently used entries are at the front.
+    std::list<Entry> lru;
+    EntryMap entries;
+    std::map<Key, std::shared_ptr<Flight>> flights;
+    std::size_t bytes = 0;
+  };
+
+  Shard& ShardFor(std::string const& table_name, std::string const& row_key);
+  void EraseEntry(Shard& shard, EntryMap::iterator i);
+
+  std::size_t const max_shard_bytes_;
+  std::chrono::milliseconds const ttl_;
+  std::chrono::milliseconds const negative_ttl_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::atomic<std::int64_t> hit_count_;
+  std::atomic<std::int64_t> miss_count_;
+  std::atomic<std::int64_t> coalesced_count_;
+  std::atomic<std::int64_t> eviction_count_;
+};
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_ROW_CACHE_H_
@@ -0,0 +1,305 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/row_cache.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_mutate_rows_reader.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include "google/cloud/testing_util/chrono_literals.h"
+#include <future>
+#include <thread>
+
+namespace bigtable = google::cloud::bigtable;
+namespace btproto = google::bigtable::v2;
+using namespace ::testing;
+using namespace google::cloud::testing_util::chrono_literals;
+
+namespace {
+class RowCacheTest : public bigtable::testing::TableTestFixture {};
+using bigtable::testing::MockReadRowsReader;
+
+/// A stream returning the row @p key, or no rows if @p key is empty.
+MockReadRowsReader* MakeStream(std::string const& key) {
+  // must be a new pointer, it is wrapped in unique_ptr by ReadRows
+  auto stream = new MockReadRowsReader;
+  if (key.empty()) {
+    EXPECT_CALL(*stream, Read(_)).WillOnce(Return(false));
+  } else {
+    btproto::ReadRowsResponse response;
+    auto& chunk = *response.add_chunks();
+    chunk.set_row_key(key);
+    chunk.mutable_family_name()->set_value("fam");
+    chunk.mutable_qualifier()->set_value("col");
+    chunk.set_timestamp_micros(42000);
+    chunk.set_value("value-" + key);
+    chunk.set_commit_row(true);
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+        .WillOnce(Return(false));
+  }
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  return stream;
+}
+}  // anonymous namespace
+
+/// @test Verify that repeated reads of a row are served from the cache.
+TEST_F(RowCacheTest, ReadRowHit) {
+  auto stream = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::Table table(client_, kTableId, cache);
+  for (int i = 0; i != 3; ++i) {
+    auto result = table.ReadRow("r1", bigtable::Filter::Latest(1));
+    ASSERT_TRUE(result.first);
+    EXPECT_EQ("r1", result.second.row_key());
+    ASSERT_EQ(1U, result.second.cells().size());
+    EXPECT_EQ("value-r1", result.second.cells().front().value());
+  }
+  EXPECT_EQ(2, cache->hit_count());
+  EXPECT_EQ(1, cache->miss_count());
+  EXPECT_LT(0U, cache->size_bytes());
+}
+
+/// @test Verify that the entries are keyed by the filter.
+TEST_F(RowCacheTest, DifferentFilters) {
+  auto s1 = MakeStream("r1");
+  auto s2 = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(s1->MakeMockReturner()))
+      .WillOnce(Invoke(s2->MakeMockReturner()));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::Table table(client_, kTableId, cache);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(2)).first);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(2)).first);
+  EXPECT_EQ(1, cache->hit_count());
+  EXPECT_EQ(2, cache->miss_count());
+}
+
+/// @test Verify that missing rows are cached unless disabled.
+TEST_F(RowCacheTest, NegativeCaching) {
+  auto s1 = MakeStream("");
+  auto s2 = MakeStream("");
+  auto s3 = MakeStream("");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(s1->MakeMockReturner()))
+      .WillOnce(Invoke(s2->MakeMockReturner()))
+      .WillOnce(Invoke(s3->MakeMockReturner()));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::Table table(client_, kTableId, cache);
+  EXPECT_FALSE(table.ReadRow("missing", bigtable::Filter::Latest(1)).first);
+  EXPECT_FALSE(table.ReadRow("missing", bigtable::Filter::Latest(1)).first);
+  EXPECT_EQ(1, cache->hit_count());
+
+  auto no_negative = std::make_shared<bigtable::RowCache>(
+      1024 * 1024, std::chrono::seconds(10), std::chrono::seconds(0));
+  bigtable::Table uncached(client_, kTableId, no_negative);
+  EXPECT_FALSE(uncached.ReadRow("missing", bigtable::Filter::Latest(1)).first);
+  EXPECT_FALSE(uncached.ReadRow("missing", bigtable::Filter::Latest(1)).first);
+  EXPECT_EQ(0, no_negative->hit_count());
+  EXPECT_EQ(2, no_negative->miss_count());
+}
+
+/// @test Verify that mutations through the table invalidate the cache.
+TEST_F(RowCacheTest, ApplyInvalidates) {
+  auto s1 = MakeStream("r1");
+  auto s2 = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(s1->MakeMockReturner()))
+      .WillOnce(Invoke(s2->MakeMockReturner()));
+  EXPECT_CALL(*client_, MutateRow(_, _, _)).WillOnce(Return(grpc::Status::OK));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::Table table(client_, kTableId, cache);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  // A copy of the table shares the cache.
+  bigtable::Table copy = table;
+  copy.Apply(bigtable::SingleRowMutation(
+      "r1", {bigtable::SetCell("fam", "col", 0_ms, "new-value")}));
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  EXPECT_EQ(0, cache->hit_count());
+  EXPECT_EQ(2, cache->miss_count());
+}
+
+/// @test Verify that bulk mutations invalidate all their rows.
+TEST_F(RowCacheTest, BulkApplyInvalidates) {
+  auto s1 = MakeStream("r1");
+  auto s2 = MakeStream("r2");
+  auto s3 = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(s1->MakeMockReturner()))
+      .WillOnce(Invoke(s2->MakeMockReturner()))
+      .WillOnce(Invoke(s3->MakeMockReturner()));
+
+  auto reader = new bigtable::testing::MockMutateRowsReader;
+  EXPECT_CALL(*reader, Read(_))
+      .WillOnce(Invoke([](btproto::MutateRowsResponse* r) {
+        for (int i = 0; i != 2; ++i) {
+          auto& e = *r->add_entries();
+          e.set_index(i);
+          e.mutable_status()->set_code(grpc::StatusCode::OK);
+        }
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, MutateRows(_, _))
+      .WillOnce(Invoke(reader->MakeMockReturner()));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::Table table(client_, kTableId, cache);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  EXPECT_TRUE(table.ReadRow("r2", bigtable::Filter::Latest(1)).first);
+  table.BulkApply(bigtable::BulkMutation(
+      bigtable::SingleRowMutation("r1",
+                                  {bigtable::SetCell("fam", "col", 0_ms, "a")}),
+      bigtable::SingleRowMutation(
+          "r3", {bigtable::SetCell("fam", "col", 0_ms, "b")})));
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  EXPECT_TRUE(table.ReadRow("r2", bigtable::Filter::Latest(1)).first);
+  EXPECT_EQ(1, cache->hit_count());
+  EXPECT_EQ(3, cache->miss_count());
+}
+
+/// @test Verify that the least recently used rows are evicted.
+TEST_F(RowCacheTest, Eviction) {
+  auto s1 = MakeStream("r1");
+  auto s2 = MakeStream("r2");
+  auto s3 = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(s1->MakeMockReturner()))
+      .WillOnce(Invoke(s2->MakeMockReturner()))
+      .WillOnce(Invoke(s3->MakeMockReturner()));
+
+  // A single shard with room for one row.
+  auto cache = std::make_shared<bigtable::RowCache>(
+      700, std::chrono::seconds(10), std::chrono::seconds(1), 1);
+  bigtable::Table table(client_, kTableId, cache);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  ASSERT_LT(350U, cache->size_bytes());
+  EXPECT_TRUE(table.ReadRow("r2", bigtable::Filter::Latest(1)).first);
+  EXPECT_EQ(1, cache->eviction_count());
+  EXPECT_TRUE(table.ReadRow("r2", bigtable::Filter::Latest(1)).first);
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1)).first);
+  EXPECT_EQ(1, cache->hit_count());
+  EXPECT_EQ(3, cache->miss_count());
+  EXPECT_GE(700U, cache->size_bytes());
+}
+
+/// @test Verify that concurrent misses for the same row share one request.
+TEST_F(RowCacheTest, SingleFlight) {
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+
+  btproto::ReadRowsResponse response;
+  auto& chunk = *response.add_chunks();
+  chunk.set_row_key("r1");
+  chunk.mutable_family_name()->set_value("fam");
+  chunk.mutable_qualifier()->set_value("col");
+  chunk.set_timestamp_micros(42000);
+  chunk.set_value("value-r1");
+  chunk.set_commit_row(true);
+  // must be a new pointer, it is wrapped in unique_ptr by ReadRows
+  auto stream = new MockReadRowsReader;
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(Invoke([cache, response](btproto::ReadRowsResponse* r) {
+        // Block the first read until the second read is waiting for it.
+        while (cache->coalesced_count() == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        *r = response;
+        return true;
+      }))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  bigtable::Table table(client_, kTableId, cache);
+  auto f1 = std::async(std::launch::async, [table]() mutable {
+    return table.ReadRow("r1", bigtable::Filter::Latest(1));
+  });
+  auto f2 = std::async(std::launch::async, [table]() mutable {
+    return table.ReadRow("r1", bigtable::Filter::Latest(1));
+  });
+  auto r1 = f1.get();
+  auto r2 = f2.get();
+  EXPECT_TRUE(r1.first);
+  EXPECT_TRUE(r2.first);
+  EXPECT_EQ("value-r1", r1.second.cells().front().value());
+  EXPECT_EQ("value-r1", r2.second.cells().front().value());
+  EXPECT_EQ(1, cache->miss_count());
+  EXPECT_EQ(1, cache->coalesced_count());
+}
+
+/// @test Verify that AsyncReadRow() returns cached rows on the queue.
+TEST_F(RowCacheTest, AsyncReadRowHit) {
+  auto stream = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::noex::Table table(client_, kTableId, cache);
+  grpc::Status status;
+  ASSERT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1), status).first);
+  ASSERT_TRUE(status.ok());
+
+  bigtable::CompletionQueue cq;
+  std::thread runner([&cq] { cq.Run(); });
+  std::promise<std::pair<bool, bigtable::Row>> p;
+  table.AsyncReadRow(
+      cq,
+      [&p](bigtable::CompletionQueue&, std::pair<bool, bigtable::Row> result,
+           grpc::Status const& status) {
+        EXPECT_TRUE(status.ok());
+        p.set_value(std::move(result));
+      },
+      "r1", bigtable::Filter::Latest(1));
+  auto result = p.get_future().get();
+  EXPECT_TRUE(result.first);
+  EXPECT_EQ("r1", result.second.row_key());
+  EXPECT_EQ(1, cache->hit_count());
+
+  cq.Shutdown();
+  runner.join();
+}
+
+/// @test Verify that failed reads are not cached.
+TEST_F(RowCacheTest, FailuresNotCached) {
+  auto failed = new MockReadRowsReader;
+  EXPECT_CALL(*failed, Read(_)).WillRepeatedly(Return(false));
+  EXPECT_CALL(*failed, Finish())
+      .WillRepeatedly(
+          Return(grpc::Status(grpc::StatusCode::PERMISSION_DENIED, "uh-oh")));
+  auto stream = MakeStream("r1");
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(failed->MakeMockReturner()))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  auto cache = std::make_shared<bigtable::RowCache>(1024 * 1024);
+  bigtable::noex::Table table(client_, kTableId, cache);
+  grpc::Status status;
+  EXPECT_FALSE(table.ReadRow("r1", bigtable::Filter::Latest(1), status).first);
+  EXPECT_FALSE(status.ok());
+
+  status = grpc::Status::OK;
+  EXPECT_TRUE(table.ReadRow("r1", bigtable::Filter::Latest(1), status).first);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0, cache->hit_count());
+  EXPECT_EQ(2, cache->miss_count());
+}
@@ -118,6 +118,9 @@ RowReader::RowReader(
       parser_factory_(std::move(parser_factory)),
       stream_is_open_(false),
       operation_cancelled_(false),
+      arena_(google::cloud::internal::make_unique<google::protobuf::Arena>()),
+      response_(google::protobuf::Arena::CreateMessage<
+                google::bigtable::v2::ReadRowsResponse>(arena_.get())),
       processed_chunks_count_(0),
       rows_count_(0),
       status_(grpc::Status::OK),
@@ -150,7 +153,7 @@ RowReader::iterator RowReader::end() {
 }
 
 void RowReader::MakeRequest() {
-  response_ = {};
+  response_->Clear();
   processed_chunks_count_ = 0;
 
   google::bigtable::v2::ReadRowsRequest request;
@@ -158,8 +161,9 @@ void RowReader::MakeRequest() {
   bigtable::internal::SetCommonTableOperationRequest<
       google::bigtable::v2::ReadRowsRequest>(request, app_profile_id_.get(),
                                              table_name_.get());
-  auto row_set_proto = row_set_.as_proto();
-  request.mutable_rows()->Swap(&row_set_proto);
+  // Move the row set into the request to avoid copying what can be a very
+  // large number of keys, it is moved back once the stub sends the request.
+  bigtable::internal::SwapRowSetProto(row_set_, *request.mutable_rows());
 
   auto filter_proto = filter_.as_proto();
   request.mutable_filter()->Swap(&filter_proto);
@@ -173,6 +177,7 @@ void RowReader::MakeRequest() {
   backoff_policy_->Setup(*context_);
   metadata_update_policy_.Setup(*context_);
   stream_ = client_->ReadRows(context_.get(), request);
+  bigtable::internal::SwapRowSetProto(row_set_, *request.mutable_rows());
   stream_is_open_ = true;
 
   parser_ = parser_factory_->Create();
@@ -180,11 +185,11 @@ void RowReader::MakeRequest() {
 
 bool RowReader::NextChunk() {
   ++processed_chunks_count_;
-  while (processed_chunks_count_ >= response_.chunks_size()) {
+  while (processed_chunks_count_ >= response_->chunks_size()) {
     processed_chunks_count_ = 0;
-    bool response_is_valid = stream_->Read(&response_);
+    bool response_is_valid = stream_->Read(response_);
     if (!response_is_valid) {
-      response_ = {};
+      response_->Clear();
       return false;
     }
   }
@@ -210,7 +215,7 @@ void RowReader::Advance(internal::OptionalRow& row) {
     if (!last_read_row_key_.empty()) {
       // We've returned some rows and need to make sure we don't
       // request them again.
-      row_set_ = row_set_.Intersect(RowRange::Open(last_read_row_key_, ""));
+      row_set_.RemoveRowsUpTo(last_read_row_key_);
     }
 
     // If we receive an error, but the retriable set is empty, stop.
@@ -219,9 +224,10 @@ void RowReader::Advance(internal::OptionalRow& row) {
     }
 
     if (!status.ok() && !retry_policy_->OnFailure(status)) {
+      status_ = retry_policy_->FinalStatus(status);
       if (raise_on_error_) {
         google::cloud::internal::ThrowRuntimeError("Unretriable error: " +
-                                                   status.error_message());
+                                                   status_.error_message());
         /*NOTREACHED*/
       }
       return;
@@ -240,9 +246,8 @@ grpc::Status RowReader::AdvanceOrFail(internal::OptionalRow& row) {
   row.reset();
   while (!parser_->HasNext()) {
     if (NextChunk()) {
-      parser_->HandleChunk(
-          std::move(*(response_.mutable_chunks(processed_chunks_count_))),
-          status);
+      parser_->HandleChunk(*response_->mutable_chunks(processed_chunks_count_),
+                           status);
       if (!status.ok()) {
         return status;
       }
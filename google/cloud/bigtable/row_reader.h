@@ -27,9 +27,11 @@
 #include "google/cloud/bigtable/rpc_retry_policy.h"
 #include "google/cloud/bigtable/table_strong_types.h"
 #include <google/bigtable/v2/bigtable.grpc.pb.h>
+#include <google/protobuf/arena.h>
 #include <grpcpp/grpcpp.h>
 #include <cinttypes>
 #include <iterator>
+#include <memory>
 
 namespace google {
 namespace cloud {
@@ -143,7 +145,7 @@ class RowReader {
    *
    * This call is used internally by AdvanceOrFail to prepare data for
    * parsing. When it returns true, the value of
-   * `response_.chunks(processed_chunks_count_)` is valid and holds
+   * `response_->chunks(processed_chunks_count_)` is valid and holds
    * the next chunk to parse.
    */
   bool NextChunk();
@@ -171,8 +173,17 @@ class RowReader {
   bool stream_is_open_;
   bool operation_cancelled_;
 
+  /**
+   * Owns the memory for `response_`.
+   *
+   * The response is reused for all the responses in a stream, and across
+   * retries. Its chunks and their strings are allocated from this arena the
+   * first time they are needed, after that the parser swaps the data out of
+   * each chunk and protobuf reuses the cleared objects for the next response.
+   */
+  std::unique_ptr<google::protobuf::Arena> arena_;
   /// The last received response, chunks are being parsed one by one from it.
-  google::bigtable::v2::ReadRowsResponse response_;
+  google::bigtable::v2::ReadRowsResponse* response_;
   /// Number of chunks already parsed in response_.
   int processed_chunks_count_;
 
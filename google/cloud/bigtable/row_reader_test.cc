@@ -46,7 +46,7 @@ class ReadRowsParserMock : public bigtable::internal::ReadRowsParser {
  public:
   MOCK_METHOD2(HandleChunkHook,
                void(ReadRowsResponse_CellChunk chunk, grpc::Status& status));
-  void HandleChunk(ReadRowsResponse_CellChunk chunk,
+  void HandleChunk(ReadRowsResponse_CellChunk& chunk,
                    grpc::Status& status) override {
     HandleChunkHook(chunk, status);
   }
@@ -13,11 +13,108 @@
 // limitations under the License.
 
 #include "google/cloud/bigtable/row_set.h"
+#include <algorithm>
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+namespace btproto = ::google::bigtable::v2;
+
+namespace {
+/// Return the start key of @p r, which must have a start key.
+std::string const& StartKey(btproto::RowRange const& r) {
+  return r.start_key_case() == btproto::RowRange::kStartKeyClosed
+             ? r.start_key_closed()
+             : r.start_key_open();
+}
+
+/// Return the end key of @p r, which must have an end key.
+std::string const& EndKey(btproto::RowRange const& r) {
+  return r.end_key_case() == btproto::RowRange::kEndKeyClosed
+             ? r.end_key_closed()
+             : r.end_key_open();
+}
+
+/// Return true if @p r has no upper limit, an empty end key means +infinity.
+bool EndsAtInfinity(btproto::RowRange const& r) {
+  return r.end_key_case() == btproto::RowRange::END_KEY_NOT_SET ||
+         EndKey(r).empty();
+}
+
+/// Return true if the range @p a starts before the range @p b.
+bool StartsBefore(btproto::RowRange const& a, btproto::RowRange const& b) {
+  if (b.start_key_case() == btproto::RowRange::START_KEY_NOT_SET) {
+    return false;
+  }
+  if (a.start_key_case() == btproto::RowRange::START_KEY_NOT_SET) {
+    return true;
+  }
+  int cmp = StartKey(a).compare(StartKey(b));
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  // With the same key a closed start includes more rows than an open start.
+  return a.start_key_case() == btproto::RowRange::kStartKeyClosed &&
+         b.start_key_case() == btproto::RowRange::kStartKeyOpen;
+}
+
+/// Return true if the range @p a ends after the range @p b.
+bool EndsAfter(btproto::RowRange const& a, btproto::RowRange const& b) {
+  if (EndsAtInfinity(b)) {
+    return false;
+  }
+  if (EndsAtInfinity(a)) {
+    return true;
+  }
+  int cmp = EndKey(a).compare(EndKey(b));
+  if (cmp != 0) {
+    return cmp > 0;
+  }
+  return a.end_key_case() == btproto::RowRange::kEndKeyClosed &&
+         b.end_key_case() == btproto::RowRange::kEndKeyOpen;
+}
+
+/// Return true if all the rows in @p r are before @p key.
+bool EndsBefore(btproto::RowRange const& r, std::string const& key) {
+  if (EndsAtInfinity(r)) {
+    return false;
+  }
+  int cmp = EndKey(r).compare(key);
+  return cmp < 0 ||
+         (cmp == 0 && r.end_key_case() == btproto::RowRange::kEndKeyOpen);
+}
+
+/**
+ * Return true if the range @p b, which does not start before @p a, overlaps
+ * @p a or starts right after it, so their union is a single range.
+ */
+bool Touches(btproto::RowRange const& a, btproto::RowRange const& b) {
+  if (EndsAtInfinity(a) ||
+      b.start_key_case() == btproto::RowRange::START_KEY_NOT_SET) {
+    return true;
+  }
+  auto const& end = EndKey(a);
+  auto const& start = StartKey(b);
+  bool const end_closed =
+      a.end_key_case() == btproto::RowRange::kEndKeyClosed;
+  bool const start_closed =
+      b.start_key_case() == btproto::RowRange::kStartKeyClosed;
+  int cmp = start.compare(end);
+  if (cmp < 0) {
+    return true;
+  }
+  if (cmp == 0) {
+    // [a, k) and [k, b) touch, (a, k) and (k, b) miss the key `k`.
+    return end_closed || start_closed;
+  }
+  // [a, k] and [k + "\0", b) touch too, there is no key between them.
+  return end_closed && start_closed &&
+         start.size() == end.size() + 1 && start.back() == '\0' &&
+         start.compare(0, end.size(), end) == 0;
+}
+}  // namespace
+
 RowSet RowSet::Intersect(bigtable::RowRange const& range) const {
   // Special case: "all rows", return the argument range.
   if (row_set_.row_keys().empty() && row_set_.row_ranges().empty()) {
@@ -26,6 +123,8 @@ RowSet RowSet::Intersect(bigtable::RowRange const& range) const {
   // Normal case: find the intersection with
   // row keys and row ranges in the RowSet.
   RowSet result;
+  // A subsequence of sorted keys is also sorted.
+  result.keys_sorted_ = keys_sorted_;
   for (auto const& key : row_set_.row_keys()) {
     if (range.Contains(key)) {
       *result.row_set_.add_row_keys() = key;
@@ -59,6 +158,148 @@ bool RowSet::IsEmpty() const {
   // (meaning "all rows").
   return row_set_.row_ranges_size() > 0;
 }
+
+void RowSet::RemoveRowsUpTo(std::string const& row_key) {
+  auto const range = RowRange::Open(row_key, "");
+  // Special case: "all rows", the result is the open range.
+  if (row_set_.row_keys().empty() && row_set_.row_ranges().empty()) {
+    *this = RowSet(range);
+    return;
+  }
+
+  SortKeys();
+  auto& keys = *row_set_.mutable_row_keys();
+  auto first = std::upper_bound(keys.begin(), keys.end(), row_key);
+  keys.DeleteSubrange(0, static_cast<int>(first - keys.begin()));
+
+  // There are usually few ranges, simply recompute them.
+  google::protobuf::RepeatedPtrField<::google::bigtable::v2::RowRange> ranges;
+  for (auto& r : *row_set_.mutable_row_ranges()) {
+    auto i = range.Intersect(RowRange(std::move(r)));
+    if (std::get<0>(i)) {
+      *ranges.Add() = std::move(std::get<1>(i)).as_proto();
+    }
+  }
+  row_set_.mutable_row_ranges()->Swap(&ranges);
+
+  // Like Intersect(), a RowSet() with no entries means "all rows", but we want
+  // "no rows".
+  if (row_set_.row_keys().empty() && row_set_.row_ranges().empty()) {
+    *this = RowSet(bigtable::RowRange::Empty());
+  }
+}
+
+std::vector<RowSet> RowSet::Split(std::size_t count) const {
+  if (count <= 1 ||
+      (row_set_.row_keys().empty() && row_set_.row_ranges().empty())) {
+    return {*this};
+  }
+
+  RowSet sorted(*this);
+  sorted.Normalize();
+  // Only empty ranges, return them unchanged, an empty RowSet means "all
+  // rows".
+  if (sorted.row_set_.row_keys().empty() &&
+      sorted.row_set_.row_ranges().empty()) {
+    return {*this};
+  }
+  auto& keys = *sorted.row_set_.mutable_row_keys();
+  auto& ranges = *sorted.row_set_.mutable_row_ranges();
+  auto const key_count = static_cast<std::size_t>(keys.size());
+  auto const range_count = static_cast<std::size_t>(ranges.size());
+  count = (std::min)(count, (std::max)(key_count, range_count));
+
+  std::vector<RowSet> result(count);
+  for (std::size_t i = 0; i != count; ++i) {
+    // The keys in [begin, end) go to the i-th set, moving them from the
+    // sorted copy.
+    auto const begin = static_cast<int>(key_count * i / count);
+    auto const end = static_cast<int>(key_count * (i + 1) / count);
+    auto& part = result[i].row_set_;
+    part.mutable_row_keys()->Reserve(end - begin);
+    for (int k = begin; k != end; ++k) {
+      *part.add_row_keys() = std::move(*keys.Mutable(k));
+    }
+  }
+  for (std::size_t r = 0; r != range_count; ++r) {
+    auto* range = ranges.Mutable(static_cast<int>(r));
+    *result[r % count].row_set_.add_row_ranges() = std::move(*range);
+  }
+  return result;
+}
+
+void RowSet::Normalize() {
+  SortKeys();
+
+  // Sort the non-empty ranges by their start, then merge each range with the
+  // previous one if they overlap or are adjacent.
+  std::vector<btproto::RowRange*> sorted;
+  for (auto& r : *row_set_.mutable_row_ranges()) {
+    if (!RowRange(r).IsEmpty()) {
+      sorted.push_back(&r);
+    }
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](btproto::RowRange const* a, btproto::RowRange const* b) {
+                     return StartsBefore(*a, *b);
+                   });
+  google::protobuf::RepeatedPtrField<btproto::RowRange> ranges;
+  for (auto* r : sorted) {
+    if (ranges.empty() || !Touches(ranges.Get(ranges.size() - 1), *r)) {
+      *ranges.Add() = std::move(*r);
+      continue;
+    }
+    auto& last = *ranges.Mutable(ranges.size() - 1);
+    if (!EndsAfter(*r, last)) {
+      continue;
+    }
+    if (EndsAtInfinity(*r)) {
+      last.clear_end_key_closed();
+      last.clear_end_key_open();
+    } else if (r->end_key_case() == btproto::RowRange::kEndKeyClosed) {
+      last.set_end_key_closed(std::move(*r->mutable_end_key_closed()));
+    } else {
+      last.set_end_key_open(std::move(*r->mutable_end_key_open()));
+    }
+  }
+  row_set_.mutable_row_ranges()->Swap(&ranges);
+
+  // Both the keys and the ranges are sorted, remove the keys contained in a
+  // range with a single pass.
+  auto& keys = *row_set_.mutable_row_keys();
+  auto const& merged = row_set_.row_ranges();
+  int r = 0;
+  auto last = std::remove_if(
+      keys.begin(), keys.end(), [&merged, &r](std::string const& key) {
+        // Skip the ranges that end before `key`.
+        while (r != merged.size() && EndsBefore(merged.Get(r), key)) {
+          ++r;
+        }
+        return r != merged.size() && RowRange(merged.Get(r)).Contains(key);
+      });
+  keys.DeleteSubrange(static_cast<int>(last - keys.begin()),
+                      static_cast<int>(keys.end() - last));
+}
+
+void RowSet::SortKeys() {
+  if (keys_sorted_) {
+    return;
+  }
+  auto& keys = *row_set_.mutable_row_keys();
+  // Sort the pointers to avoid moving the strings.
+  std::sort(keys.pointer_begin(), keys.pointer_end(),
+            [](std::string const* a, std::string const* b) { return *a < *b; });
+  auto last = std::unique(keys.begin(), keys.end());
+  keys.DeleteSubrange(static_cast<int>(last - keys.begin()),
+                      static_cast<int>(keys.end() - last));
+  keys_sorted_ = true;
+}
+
+namespace internal {
+void SwapRowSetProto(RowSet& row_set, ::google::bigtable::v2::RowSet& proto) {
+  row_set.row_set_.Swap(&proto);
+}
+}  // namespace internal
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
 }  // namespace cloud
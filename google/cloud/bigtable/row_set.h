@@ -17,11 +17,27 @@
 
 #include "google/cloud/bigtable/internal/conjunction.h"
 #include "google/cloud/bigtable/row_range.h"
+#include <cstddef>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+class RowSet;
+
+namespace internal {
+/**
+ * Exchange the row keys and ranges in @p row_set with @p proto.
+ *
+ * The readers use this function to move a row set into a request, and to move
+ * it back once the request is serialized, without copying the row keys. Two
+ * calls with the same arguments restore @p row_set.
+ */
+void SwapRowSetProto(RowSet& row_set, ::google::bigtable::v2::RowSet& proto);
+}  // namespace internal
+
 /**
  * Represent a (possibly non-continuous) set of row keys.
  *
@@ -56,6 +72,9 @@ class RowSet {
    * Add @p row_key to the set, minimize copies when possible.
    */
   void Append(std::string row_key) {
+    auto const& keys = row_set_.row_keys();
+    keys_sorted_ =
+        keys_sorted_ && (keys.empty() || keys.Get(keys.size() - 1) < row_key);
     *row_set_.add_row_keys() = std::move(row_key);
   }
 
@@ -68,6 +87,34 @@ class RowSet {
    */
   RowSet Intersect(bigtable::RowRange const& range) const;
 
+  /**
+   * Remove the rows up to, and including, @p row_key from the set.
+   *
+   * The result is the same as `*this = Intersect(RowRange::Open(row_key, ""))`
+   * but the set is modified in place. The row keys are sorted and deduplicated
+   * the first time this function is called, after that each call finds the
+   * keys to remove with a binary search and does not copy any keys. Retried
+   * scans use this function to skip the rows already returned, which makes
+   * retrying a scan over a very large set of keys cheap.
+   */
+  void RemoveRowsUpTo(std::string const& row_key);
+
+  /**
+   * Split the set into at most @p count disjoint sets that cover the same rows.
+   *
+   * The row keys are sorted and deduplicated, overlapping or adjacent ranges
+   * are merged, and the keys contained in a range are removed, so no row
+   * appears in more than one set. Each set receives a contiguous slice of
+   * about the same number of keys, and the ranges are assigned to the sets in
+   * round-robin order. Use this function to read a large set of keys with
+   * several parallel requests.
+   *
+   * A default constructed set (all the rows in the table) cannot be split
+   * without information about the table, the result contains a single
+   * element in that case. Use `Table::SampleRows()` to split a table scan.
+   */
+  std::vector<RowSet> Split(std::size_t count) const;
+
   /**
    * Returns true if the set is empty.
    *
@@ -106,8 +153,22 @@ class RowSet {
   /// Terminate the recursion.
   void AppendAll() {}
 
+  /// Sort the row keys and remove duplicates, unless they already are.
+  void SortKeys();
+
+  /**
+   * Sort the keys, merge the overlapping or adjacent ranges, and remove the
+   * keys contained in a range. Drops the empty ranges.
+   */
+  void Normalize();
+
+  friend void internal::SwapRowSetProto(RowSet& row_set,
+                                        ::google::bigtable::v2::RowSet& proto);
+
  private:
   ::google::bigtable::v2::RowSet row_set_;
+  /// True if the row keys are known to be sorted and without duplicates.
+  bool keys_sorted_ = true;
 };
 }  // namespace BIGTABLE_CLIENT_NS
 }  // namespace bigtable
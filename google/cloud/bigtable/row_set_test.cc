@@ -15,6 +15,9 @@
 #include "google/cloud/bigtable/row_set.h"
 
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace bigtable = google::cloud::bigtable;
 
@@ -116,3 +119,170 @@ TEST(RowSetTest, IntersectWithDisjointIsEmpty) {
   EXPECT_TRUE(
       RowSet("a", R::Range("a", "b")).Intersect(R::Range("c", "d")).IsEmpty());
 }
+
+TEST(RowSetTest, RemoveRowsUpToKeys) {
+  using bigtable::RowSet;
+  RowSet row_set("d", "b", "a", "c", "b");
+  row_set.RemoveRowsUpTo("b");
+  auto proto = row_set.as_proto();
+  ASSERT_EQ(2, proto.row_keys_size());
+  EXPECT_EQ("c", proto.row_keys(0));
+  EXPECT_EQ("d", proto.row_keys(1));
+
+  // Keys that are not in the set work too.
+  row_set.RemoveRowsUpTo("cc");
+  proto = row_set.as_proto();
+  ASSERT_EQ(1, proto.row_keys_size());
+  EXPECT_EQ("d", proto.row_keys(0));
+  EXPECT_FALSE(row_set.IsEmpty());
+
+  row_set.RemoveRowsUpTo("d");
+  EXPECT_TRUE(row_set.IsEmpty());
+}
+
+TEST(RowSetTest, RemoveRowsUpToRanges) {
+  using R = bigtable::RowRange;
+  using bigtable::RowSet;
+  RowSet row_set("a", R::Range("a", "c"), R::Range("e", "g"), "f");
+  row_set.RemoveRowsUpTo("b");
+  auto proto = row_set.as_proto();
+  ASSERT_EQ(1, proto.row_keys_size());
+  EXPECT_EQ("f", proto.row_keys(0));
+  ASSERT_EQ(2, proto.row_ranges_size());
+  EXPECT_EQ(R::Open("b", "c"), R(proto.row_ranges(0)));
+  EXPECT_EQ(R::Range("e", "g"), R(proto.row_ranges(1)));
+}
+
+TEST(RowSetTest, RemoveRowsUpToDefaultSet) {
+  using R = bigtable::RowRange;
+  using bigtable::RowSet;
+  RowSet row_set;
+  row_set.RemoveRowsUpTo("b");
+  auto proto = row_set.as_proto();
+  EXPECT_TRUE(proto.row_keys().empty());
+  ASSERT_EQ(1, proto.row_ranges_size());
+  EXPECT_EQ(R::Open("b", ""), R(proto.row_ranges(0)));
+}
+
+/// @test Verify RemoveRowsUpTo() and Intersect() produce the same rows.
+TEST(RowSetTest, RemoveRowsUpToMatchesIntersect) {
+  using R = bigtable::RowRange;
+  using bigtable::RowSet;
+  RowSet row_set;
+  for (int i = 0; i != 100; ++i) {
+    // Append the keys in a scrambled order.
+    row_set.Append("key-" + std::to_string((i * 37) % 100 + 100));
+  }
+  for (int i = 100; i != 200; i += 10) {
+    auto const last = "key-" + std::to_string(i);
+    auto expected = row_set.Intersect(R::Open(last, ""));
+    row_set.RemoveRowsUpTo(last);
+    auto actual = row_set.as_proto();
+    auto expected_keys = expected.as_proto().row_keys();
+    std::sort(expected_keys.begin(), expected_keys.end());
+    ASSERT_EQ(expected_keys.size(), actual.row_keys().size());
+    EXPECT_TRUE(std::equal(expected_keys.begin(), expected_keys.end(),
+                           actual.row_keys().begin()));
+  }
+}
+
+TEST(RowSetTest, Split) {
+  using R = bigtable::RowRange;
+  using bigtable::RowSet;
+  RowSet row_set;
+  for (int i = 0; i != 10; ++i) {
+    row_set.Append("key-" + std::to_string(9 - i));
+  }
+  row_set.Append("key-5");
+  row_set.Append(R::Range("a", "b"));
+  row_set.Append(R::Range("x", "y"));
+
+  auto parts = row_set.Split(3);
+  ASSERT_EQ(3U, parts.size());
+  std::vector<std::string> keys;
+  int range_count = 0;
+  for (auto const& p : parts) {
+    auto const& proto = p.as_proto();
+    EXPECT_FALSE(proto.row_keys().empty());
+    keys.insert(keys.end(), proto.row_keys().begin(), proto.row_keys().end());
+    range_count += proto.row_ranges_size();
+  }
+  EXPECT_EQ(2, range_count);
+  ASSERT_EQ(10U, keys.size());
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  EXPECT_EQ("key-0", keys.front());
+  EXPECT_EQ("key-9", keys.back());
+
+  // The original set is unchanged.
+  EXPECT_EQ(11, row_set.as_proto().row_keys_size());
+}
+
+TEST(RowSetTest, SplitSmallSets) {
+  using bigtable::RowSet;
+  EXPECT_EQ(1U, RowSet().Split(4).size());
+  EXPECT_EQ(2U, RowSet("a", "b").Split(4).size());
+  EXPECT_EQ(1U, RowSet("a", "b").Split(1).size());
+}
+
+TEST(RowSetTest, SplitOverlappingRanges) {
+  using R = bigtable::RowRange;
+  using bigtable::RowSet;
+  RowSet row_set(R::Range("c", "f"), R::Range("a", "d"), R::Closed("f", "g"),
+                 R::Open("m", "n"), R::Open("n", "p"), R::Empty(), "b", "f",
+                 "g", "n", "x");
+
+  auto parts = row_set.Split(4);
+  std::vector<std::string> keys;
+  std::vector<R> ranges;
+  for (auto const& p : parts) {
+    auto const& proto = p.as_proto();
+    keys.insert(keys.end(), proto.row_keys().begin(), proto.row_keys().end());
+    for (auto const& r : proto.row_ranges()) {
+      ranges.emplace_back(r);
+    }
+  }
+  // "b", "f", and "g" are in a range, ["a", "g"] is the union of the first
+  // three ranges. The ranges around "n" are not adjacent, they exclude "n".
+  EXPECT_THAT(keys, ::testing::ElementsAre("n", "x"));
+  ASSERT_EQ(3U, ranges.size());
+  EXPECT_THAT(ranges, ::testing::UnorderedElementsAre(
+                          R::Closed("a", "g"), R::Open("m", "n"),
+                          R::Open("n", "p")));
+
+  // No row appears in more than one set.
+  for (auto const& key : {"a", "b", "c", "d", "f", "g", "m", "n", "o", "x"}) {
+    int count = 0;
+    for (auto const& p : parts) {
+      count += p.Intersect(R::Closed(key, key)).IsEmpty() ? 0 : 1;
+    }
+    EXPECT_GE(1, count) << "key=" << key;
+  }
+}
+
+TEST(RowSetTest, SplitKeysInsideRange) {
+  using R = bigtable::RowRange;
+  using bigtable::RowSet;
+  auto parts = RowSet(R::StartingAt("k"), "a", "k", "z").Split(3);
+  ASSERT_EQ(1U, parts.size());
+  ASSERT_EQ(1, parts[0].as_proto().row_keys_size());
+  EXPECT_EQ("a", parts[0].as_proto().row_keys(0));
+  ASSERT_EQ(1, parts[0].as_proto().row_ranges_size());
+  EXPECT_EQ(R::StartingAt("k"), R(parts[0].as_proto().row_ranges(0)));
+
+  // Only empty ranges, there is nothing to split.
+  EXPECT_EQ(1U, RowSet(R::Empty()).Split(2).size());
+}
+
+TEST(RowSetTest, SwapRowSetProto) {
+  using bigtable::RowSet;
+  RowSet row_set("b", "a");
+  google::bigtable::v2::RowSet proto;
+  bigtable::internal::SwapRowSetProto(row_set, proto);
+  EXPECT_EQ(2, proto.row_keys_size());
+  EXPECT_TRUE(row_set.as_proto().row_keys().empty());
+
+  bigtable::internal::SwapRowSetProto(row_set, proto);
+  EXPECT_TRUE(proto.row_keys().empty());
+  ASSERT_EQ(2, row_set.as_proto().row_keys_size());
+  EXPECT_EQ("b", row_set.as_proto().row_keys(0));
+}
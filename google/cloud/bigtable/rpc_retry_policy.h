@@ -87,6 +87,18 @@ class RPCRetryPolicy {
    */
   virtual bool OnFailure(grpc::Status const& status) = 0;
 
+  /**
+   * Return the error to report after `OnFailure()` stops the operation.
+   *
+   * The default implementation returns @p status, the last error returned by
+   * the service. Policies that stop an operation for their own reasons, such
+   * as `BudgetedRetryPolicy` and `CircuitBreakerRetryPolicy`, return an error
+   * describing that reason.
+   */
+  virtual grpc::Status FinalStatus(grpc::Status const& status) const {
+    return status;
+  }
+
   static bool IsPermanentFailure(grpc::Status const& status) {
     return SafeGrpcRetry::IsPermanentFailure(status);
   }
@@ -112,6 +112,21 @@ RowReader Table::ReadRows(RowSet row_set, std::int64_t rows_limit,
                         true);
 }
 
+AsyncRowStream Table::AsyncReadRows(CompletionQueue& cq, RowSet row_set,
+                                   Filter filter,
+                                   AsyncRowStreamOptions const& options) {
+  return AsyncRowStream(impl_.MakeAsyncRowStream(
+      cq, std::move(row_set), options.rows_limit(), std::move(filter),
+      options.max_buffered_rows(), options.max_buffered_bytes()));
+}
+
+ColumnarReader Table::ReadColumns(RowSet row_set, Filter filter,
+                                  std::vector<ColumnSpec> schema,
+                                  std::size_t batch_size) {
+  return impl_.ReadColumns(std::move(row_set), std::move(filter),
+                           std::move(schema), batch_size, true);
+}
+
 std::pair<bool, Row> Table::ReadRow(std::string row_key, Filter filter) {
   grpc::Status status;
   auto result = impl_.ReadRow(std::move(row_key), std::move(filter), status);
@@ -15,14 +15,20 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TABLE_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TABLE_H_
 
+#include "google/cloud/bigtable/async_row_stream.h"
+#include "google/cloud/bigtable/circuit_breaker.h"
 #include "google/cloud/bigtable/internal/grpc_error_delegate.h"
 #include "google/cloud/bigtable/internal/table.h"
+#include "google/cloud/bigtable/retry_budget.h"
 #include "google/cloud/future.h"
 
 namespace google {
 namespace cloud {
 namespace bigtable {
 inline namespace BIGTABLE_CLIENT_NS {
+class CounterAggregator;
+class ReadRowCoalescer;
+
 /**
  * The main interface to interact with data in a Cloud Bigtable table.
  *
@@ -114,11 +120,25 @@ class Table {
    *       `LimitedErrorCountRetryPolicy` to limit the number of failures
    *       allowed. Use `LimitedTimeRetryPolicy` to bound the time for any
    *       request. You can also create your own policies that combine time and
-   *       error counts.
+   *       error counts. Wrap a policy in `BudgetedRetryPolicy` or
+   *       `CircuitBreakerRetryPolicy` to limit the retries across all the
+   *       operations that share a `RetryBudget` or a `CircuitBreaker`.
+   *     - `HedgingPolicy` when to send a duplicate request for a slow
+   *       `ReadRow()`. Pass a `std::shared_ptr<>` to a policy to share it (and
+   *       its counters) with the application. Use `PercentileHedgingPolicy`
+   *       to hedge requests slower than a given latency percentile. By default
+   *       requests are not hedged.
+   *     - `BulkApplyOptions` how `BulkApply()` and `AsyncBulkApply()` split
+   *       large `BulkMutation` objects into several concurrent requests.
+   *     - `std::shared_ptr<RowCache>` a cache for the results of `ReadRow()`.
+   *       The cache is shared with the copies of this object, and the
+   *       mutations sent through them remove the affected rows from it. By
+   *       default rows are not cached.
    *
    * @see SafeIdempotentMutationPolicy, AlwaysRetryMutationPolicy,
    *     ExponentialBackoffPolicy, LimitedErrorCountRetryPolicy,
-   *     LimitedTimeRetryPolicy.
+   *     LimitedTimeRetryPolicy, PercentileHedgingPolicy, RowCache,
+   *     BudgetedRetryPolicy, CircuitBreakerRetryPolicy.
    */
   template <typename... Policies>
   Table(std::shared_ptr<DataClient> client, std::string const& table_id,
@@ -168,11 +188,25 @@ class Table {
    *       `LimitedErrorCountRetryPolicy` to limit the number of failures
    *       allowed. Use `LimitedTimeRetryPolicy` to bound the time for any
    *       request. You can also create your own policies that combine time and
-   *       error counts.
+   *       error counts. Wrap a policy in `BudgetedRetryPolicy` or
+   *       `CircuitBreakerRetryPolicy` to limit the retries across all the
+   *       operations that share a `RetryBudget` or a `CircuitBreaker`.
+   *     - `HedgingPolicy` when to send a duplicate request for a slow
+   *       `ReadRow()`. Pass a `std::shared_ptr<>` to a policy to share it (and
+   *       its counters) with the application. Use `PercentileHedgingPolicy`
+   *       to hedge requests slower than a given latency percentile. By default
+   *       requests are not hedged.
+   *     - `BulkApplyOptions` how `BulkApply()` and `AsyncBulkApply()` split
+   *       large `BulkMutation` objects into several concurrent requests.
+   *     - `std::shared_ptr<RowCache>` a cache for the results of `ReadRow()`.
+   *       The cache is shared with the copies of this object, and the
+   *       mutations sent through them remove the affected rows from it. By
+   *       default rows are not cached.
    *
    * @see SafeIdempotentMutationPolicy, AlwaysRetryMutationPolicy,
    *     ExponentialBackoffPolicy, LimitedErrorCountRetryPolicy,
-   *     LimitedTimeRetryPolicy.
+   *     LimitedTimeRetryPolicy, PercentileHedgingPolicy, RowCache,
+   *     BudgetedRetryPolicy, CircuitBreakerRetryPolicy.
    */
   template <typename... Policies>
   Table(std::shared_ptr<DataClient> client,
@@ -285,6 +319,46 @@ class Table {
    */
   RowReader ReadRows(RowSet row_set, std::int64_t rows_limit, Filter filter);
 
+  /**
+   * Reads a set of rows from the table asynchronously, with flow control.
+   *
+   * The application pulls the rows from the returned stream, and the stream
+   * only reads from the service while it has room in its buffer. Use this
+   * function when the application may process rows slower than the service
+   * sends them.
+   *
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @param row_set the rows to read from.
+   * @param filter is applied on the server-side to data in the rows.
+   * @param options how many rows to read ahead of the application.
+   */
+  AsyncRowStream AsyncReadRows(
+      CompletionQueue& cq, RowSet row_set, Filter filter,
+      AsyncRowStreamOptions const& options = AsyncRowStreamOptions());
+
+  /**
+   * Reads a set of rows from the table into typed column buffers.
+   *
+   * Use this function to scan many rows when only a few columns are needed,
+   * for example to compute aggregates. The returned reader copies the newest
+   * value of each column in @p schema to a `ColumnarBatch`, without creating a
+   * `Row` object for each row.
+   *
+   * @param row_set the rows to read from.
+   * @param filter is applied on the server-side to data in the rows. Consider
+   *     using `Filter::Latest(1)`, only the newest cell in each column is used.
+   * @param schema the columns to extract, and their types.
+   * @param batch_size the maximum number of rows in each batch.
+   *
+   * @throws std::runtime_error if a value in an `INT64` column is not 8 bytes
+   *     long, or if the read failed after retries.
+   */
+  ColumnarReader ReadColumns(
+      RowSet row_set, Filter filter, std::vector<ColumnSpec> schema,
+      std::size_t batch_size = ColumnarReader::DEFAULT_BATCH_SIZE);
+
   /**
    * Read and return a single row from the table.
    *
@@ -381,6 +455,9 @@ class Table {
   }
 
  private:
+  friend class BulkLoader;
+  friend class CounterAggregator;
+  friend class ReadRowCoalescer;
   noex::Table impl_;
 };
 
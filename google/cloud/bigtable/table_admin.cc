@@ -135,6 +135,21 @@ std::future<btadmin::Snapshot> TableAdmin::SnapshotTable(
                     cluster_id, snapshot_id, table_id, duration_ttl);
 }
 
+future<btadmin::Snapshot> TableAdmin::AsyncSnapshotTable(
+    CompletionQueue& cq, bigtable::ClusterId const& cluster_id,
+    bigtable::SnapshotId const& snapshot_id, bigtable::TableId const& table_id,
+    std::chrono::seconds duration_ttl) {
+  promise<btadmin::Snapshot> p;
+  auto result = p.get_future();
+
+  impl_.AsyncSnapshotTable(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p), "AsyncSnapshotTable"),
+      cluster_id, snapshot_id, table_id, duration_ttl);
+
+  return result;
+}
+
 btadmin::Snapshot TableAdmin::SnapshotTableImpl(
     bigtable::ClusterId const& cluster_id,
     bigtable::SnapshotId const& snapshot_id, bigtable::TableId const& table_id,
@@ -217,6 +232,26 @@ bool TableAdmin::WaitForConsistencyCheckImpl(
   return consistent;
 }
 
+future<bool> TableAdmin::AsyncWaitForConsistencyCheck(
+    CompletionQueue& cq, bigtable::TableId const& table_id,
+    bigtable::ConsistencyToken const& consistency_token) {
+  promise<bool> p;
+  auto result = p.get_future();
+
+  // The polling loop delivers the result by value, adapt it to the callback
+  // type used to satisfy the future.
+  auto callback = std::make_shared<internal::AsyncFutureFromCallback<bool>>(
+      std::move(p), "AsyncWaitForConsistencyCheck");
+  impl_.AsyncWaitForConsistencyCheck(
+      cq,
+      [callback](CompletionQueue& cq, bool consistent, grpc::Status& status) {
+        (*callback)(cq, consistent, status);
+      },
+      table_id, consistency_token);
+
+  return result;
+}
+
 void TableAdmin::DeleteSnapshot(bigtable::ClusterId const& cluster_id,
                                 bigtable::SnapshotId const& snapshot_id) {
   grpc::Status status;
@@ -234,6 +269,21 @@ std::future<btadmin::Table> TableAdmin::CreateTableFromSnapshot(
                     snapshot_id, table_id);
 }
 
+future<btadmin::Table> TableAdmin::AsyncCreateTableFromSnapshot(
+    CompletionQueue& cq, bigtable::ClusterId const& cluster_id,
+    bigtable::SnapshotId const& snapshot_id, std::string table_id) {
+  promise<btadmin::Table> p;
+  auto result = p.get_future();
+
+  impl_.AsyncCreateTableFromSnapshot(
+      cq,
+      internal::MakeAsyncFutureFromCallback(std::move(p),
+                                            "AsyncCreateTableFromSnapshot"),
+      cluster_id, snapshot_id, std::move(table_id));
+
+  return result;
+}
+
 btadmin::Table TableAdmin::CreateTableFromSnapshotImpl(
     bigtable::ClusterId const& cluster_id,
     bigtable::SnapshotId const& snapshot_id, std::string table_id) {
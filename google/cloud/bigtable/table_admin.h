@@ -293,6 +293,10 @@ class TableAdmin {
    * @return the consistency status for the table.
    * @throws std::exception if the operation cannot be completed.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncWaitForConsistencyCheck()` when many
+   *   operations are in progress at the same time.
+   *
    * @par Example
    * @snippet table_admin_snippets.cc wait for consistency check
    */
@@ -304,6 +308,31 @@ class TableAdmin {
                       consistency_token);
   }
 
+  /**
+   * Asynchronously wait until the replication of a table catches up with a
+   * consistency token.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * The table is polled using timers in @p cq, no threads are blocked while
+   * waiting for the replication.
+   *
+   * @param table_id the id of the table for which we want to check
+   *     consistency.
+   * @param consistency_token the consistency token of the table.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @return a future that is satisfied with `true` once the replication has
+   *     caught up. If the polling policy expires first, or the operation
+   *     fails, the future is satisfied with an exception.
+   */
+  future<bool> AsyncWaitForConsistencyCheck(
+      CompletionQueue& cq, bigtable::TableId const& table_id,
+      bigtable::ConsistencyToken const& consistency_token);
+
   /**
    * Delete all the rows in a table.
    *
@@ -349,12 +378,45 @@ class TableAdmin {
    *   time allocated by the retry policies has expired, in which case the
    *   future contains an exception of type `bigtable::PollTimeout`.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncSnapshotTable()` when many operations are
+   *   in progress at the same time.
+   *
    */
   std::future<google::bigtable::admin::v2::Snapshot> SnapshotTable(
       bigtable::ClusterId const& cluster_id,
       bigtable::SnapshotId const& snapshot_id,
       bigtable::TableId const& table_id, std::chrono::seconds duration_ttl);
 
+  /**
+   * Create a new snapshot of a table, without blocking any threads.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @warning This is a private alpha release of Cloud Bigtable snapshots. This
+   * feature is not currently available to most Cloud Bigtable customers. This
+   * feature might be changed in backward-incompatible ways and is not
+   * recommended for production use. It is not subject to any SLA or deprecation
+   * policy.
+   *
+   * @param cluster_id the cluster id to which snapshot is created.
+   * @param snapshot_id the id of the snapshot.
+   * @param table_id the id of the table for which snapshot is created.
+   * @param duration_ttl time to live for snapshot being created.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @return a future that becomes satisfied when the operation completes, or
+   *   with an exception (typically `bigtable::GrpcError`) if the operation
+   *   fails or the polling policy expires before it completes.
+   */
+  future<google::bigtable::admin::v2::Snapshot> AsyncSnapshotTable(
+      CompletionQueue& cq, bigtable::ClusterId const& cluster_id,
+      bigtable::SnapshotId const& snapshot_id,
+      bigtable::TableId const& table_id, std::chrono::seconds duration_ttl);
+
   /**
    * Get information about a single snapshot.
    *
@@ -410,6 +472,10 @@ class TableAdmin {
    * @param table_id the id of the table which needs to be created.
    * @throws std::exception if the operation cannot be completed.
    *
+   * @note This function uses a separate thread to wait for the operation to
+   *   complete, consider using `AsyncCreateTableFromSnapshot()` when many
+   *   operations are in progress at the same time.
+   *
    * @par Example
    * @snippet table_admin_snippets.cc create table from snapshot
    */
@@ -417,6 +483,33 @@ class TableAdmin {
       bigtable::ClusterId const& cluster_id,
       bigtable::SnapshotId const& snapshot_id, std::string table_id);
 
+  /**
+   * Create a table from a snapshot, without blocking any threads.
+   *
+   * @warning This is an early version of the asynchronous APIs for Cloud
+   *     Bigtable. These APIs might be changed in backward-incompatible ways. It
+   *     is not subject to any SLA or deprecation policy.
+   *
+   * @warning This is a private alpha release of Cloud Bigtable snapshots. This
+   * feature is not currently available to most Cloud Bigtable customers. This
+   * feature might be changed in backward-incompatible ways and is not
+   * recommended for production use. It is not subject to any SLA or deprecation
+   * policy.
+   *
+   * @param cluster_id the id of the cluster to which snapshot belongs.
+   * @param snapshot_id the id of the snapshot to which table belongs.
+   * @param table_id the id of the table which needs to be created.
+   * @param cq the completion queue that will execute the asynchronous calls,
+   *     the application must ensure that one or more threads are blocked on
+   *     `cq.Run()`.
+   * @return a future that becomes satisfied when the operation completes, or
+   *   with an exception (typically `bigtable::GrpcError`) if the operation
+   *   fails or the polling policy expires before it completes.
+   */
+  future<google::bigtable::admin::v2::Table> AsyncCreateTableFromSnapshot(
+      CompletionQueue& cq, bigtable::ClusterId const& cluster_id,
+      bigtable::SnapshotId const& snapshot_id, std::string table_id);
+
   //@}
 
   /**
@@ -15,6 +15,8 @@
 #include "google/cloud/bigtable/table_admin.h"
 #include "google/cloud/bigtable/grpc_error.h"
 #include "google/cloud/bigtable/testing/mock_admin_client.h"
+#include "google/cloud/bigtable/testing/mock_completion_queue.h"
+#include "google/cloud/bigtable/testing/mock_response_reader.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/testing_util/chrono_literals.h"
 #include <google/protobuf/text_format.h>
@@ -27,6 +29,11 @@ namespace btadmin = ::google::bigtable::admin::v2;
 namespace bigtable = google::cloud::bigtable;
 using namespace google::cloud::testing_util::chrono_literals;
 using MockAdminClient = bigtable::testing::MockAdminClient;
+using MockAsyncLongrunningOpReader =
+    bigtable::testing::MockAsyncResponseReader<google::longrunning::Operation>;
+using MockAsyncCheckConsistencyReader =
+    bigtable::testing::MockAsyncResponseReader<
+        btadmin::CheckConsistencyResponse>;
 
 std::string const kProjectId = "the-project";
 std::string const kInstanceId = "the-instance";
@@ -1511,3 +1518,194 @@ TEST_F(TableAdminTest, CreateTableFromSnapshot_ExhaustPollingPolicyFailure) {
   EXPECT_THROW(future.get(), bigtable::GRpcError);
 }
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+/// @test Verify that `TableAdmin::AsyncSnapshotTable` polls using the queue.
+TEST_F(TableAdminTest, AsyncSnapshotTable) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::TableAdmin tested(client_, "the-instance");
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto snapshot_reader =
+      google::cloud::internal::make_unique<MockAsyncLongrunningOpReader>();
+  EXPECT_CALL(*snapshot_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](google::longrunning::Operation* response,
+                          grpc::Status* status, void*) {
+        response->set_name("operation-name");
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(*client_, AsyncSnapshotTable(_, _, _))
+      .WillOnce(Invoke([&snapshot_reader](
+                           grpc::ClientContext*,
+                           btadmin::SnapshotTableRequest const& request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("projects/the-project/instances/the-instance/tables/the-table",
+                  request.name());
+        EXPECT_EQ("random-snapshot", request.snapshot_id());
+        EXPECT_EQ(100, request.ttl().seconds());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(snapshot_reader.get());
+      }));
+
+  auto get_operation_reader =
+      google::cloud::internal::make_unique<MockAsyncLongrunningOpReader>();
+  EXPECT_CALL(*get_operation_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](google::longrunning::Operation* response,
+                          grpc::Status* status, void*) {
+        btadmin::Snapshot snapshot;
+        snapshot.set_name("the-snapshot-name");
+        response->set_done(true);
+        auto any =
+            google::cloud::internal::make_unique<google::protobuf::Any>();
+        any->PackFrom(snapshot);
+        response->set_allocated_response(any.release());
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(*client_, AsyncGetOperation(_, _, _))
+      .WillOnce(Invoke([&get_operation_reader](
+                           grpc::ClientContext*,
+                           google::longrunning::GetOperationRequest const&
+                               request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("operation-name", request.name());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(get_operation_reader.get());
+      }));
+
+  auto future = tested.AsyncSnapshotTable(
+      cq, bigtable::ClusterId("the-cluster"),
+      bigtable::SnapshotId("random-snapshot"), bigtable::TableId("the-table"),
+      100_s);
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncSnapshotTable
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncGetOperation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  EXPECT_EQ("the-snapshot-name", future.get().name());
+}
+
+/// @test Verify that `AsyncWaitForConsistencyCheck` polls until consistent.
+TEST_F(TableAdminTest, AsyncWaitForConsistencyCheck) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::TableAdmin tested(client_, "the-instance");
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto not_consistent_reader =
+      google::cloud::internal::make_unique<MockAsyncCheckConsistencyReader>();
+  EXPECT_CALL(*not_consistent_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btadmin::CheckConsistencyResponse* response,
+                          grpc::Status* status, void*) {
+        response->set_consistent(false);
+        *status = grpc::Status::OK;
+      }));
+  auto consistent_reader =
+      google::cloud::internal::make_unique<MockAsyncCheckConsistencyReader>();
+  EXPECT_CALL(*consistent_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](btadmin::CheckConsistencyResponse* response,
+                          grpc::Status* status, void*) {
+        response->set_consistent(true);
+        *status = grpc::Status::OK;
+      }));
+
+  auto make_returner = [](MockAsyncCheckConsistencyReader* reader) {
+    return [reader](grpc::ClientContext*,
+                    btadmin::CheckConsistencyRequest const& request,
+                    grpc::CompletionQueue*) {
+      EXPECT_EQ("projects/the-project/instances/the-instance/tables/the-table",
+                request.name());
+      EXPECT_EQ("test-token", request.consistency_token());
+      // This is safe, see comments in MockAsyncResponseReader.
+      return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+          btadmin::CheckConsistencyResponse>>(reader);
+    };
+  };
+  EXPECT_CALL(*client_, AsyncCheckConsistency(_, _, _))
+      .WillOnce(Invoke(make_returner(not_consistent_reader.get())))
+      .WillOnce(Invoke(make_returner(consistent_reader.get())));
+
+  auto future = tested.AsyncWaitForConsistencyCheck(
+      cq, bigtable::TableId("the-table"),
+      bigtable::ConsistencyToken("test-token"));
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncCheckConsistency
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // Timer before the next attempt
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_FALSE(future.is_ready());
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncCheckConsistency
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  EXPECT_TRUE(future.get());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that `AsyncCreateTableFromSnapshot` reports failures.
+TEST_F(TableAdminTest, AsyncCreateTableFromSnapshotFailure) {
+  using ::testing::_;
+  using ::testing::Invoke;
+
+  bigtable::TableAdmin tested(client_, "the-instance");
+  auto cq_impl = std::make_shared<bigtable::testing::MockCompletionQueue>();
+  bigtable::CompletionQueue cq(cq_impl);
+
+  auto create_reader =
+      google::cloud::internal::make_unique<MockAsyncLongrunningOpReader>();
+  EXPECT_CALL(*create_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](google::longrunning::Operation* response,
+                          grpc::Status* status, void*) {
+        // The operation fails immediately, no polling is needed.
+        response->set_name("operation-name");
+        response->set_done(true);
+        auto error =
+            google::cloud::internal::make_unique<google::rpc::Status>();
+        error->set_code(grpc::StatusCode::FAILED_PRECONDITION);
+        error->set_message("something is broken");
+        response->set_allocated_error(error.release());
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(*client_, AsyncCreateTableFromSnapshot(_, _, _))
+      .WillOnce(Invoke([&create_reader](
+                           grpc::ClientContext*,
+                           btadmin::CreateTableFromSnapshotRequest const&
+                               request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("projects/the-project/instances/the-instance",
+                  request.parent());
+        EXPECT_EQ("table-1", request.table_id());
+        // This is safe, see comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(create_reader.get());
+      }));
+  EXPECT_CALL(*client_, AsyncGetOperation(_, _, _)).Times(0);
+
+  auto future = tested.AsyncCreateTableFromSnapshot(
+      cq, bigtable::ClusterId("the-cluster"),
+      bigtable::SnapshotId("random-snapshot"), "table-1");
+
+  EXPECT_EQ(1U, cq_impl->size());  // AsyncCreateTableFromSnapshot
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_EQ(1U, cq_impl->size());  // RunAsync() with the completed operation
+  cq_impl->SimulateCompletion(cq, true);
+  EXPECT_TRUE(cq_impl->empty());
+
+  ASSERT_TRUE(future.is_ready());
+  EXPECT_THROW(future.get(), bigtable::GRpcError);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -17,6 +17,7 @@
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/testing_util/chrono_literals.h"
+#include <mutex>
 
 namespace btproto = google::bigtable::v2;
 namespace bigtable = google::cloud::bigtable;
@@ -298,3 +299,57 @@ TEST_F(TableBulkApplyTest, FailedRPC) {
   }
 }
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that Table::BulkApply() splits large mutations.
+TEST_F(TableBulkApplyTest, SplitLargeMutation) {
+  std::mutex mu;
+  std::vector<std::string> requested;
+  // Accept all the mutations except those for row "bar".
+  EXPECT_CALL(*client_, MutateRows(_, _))
+      .Times(4)
+      .WillRepeatedly(Invoke([&mu, &requested](
+                                 grpc::ClientContext*,
+                                 btproto::MutateRowsRequest const& request) {
+        EXPECT_EQ(1, request.entries_size());
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          requested.push_back(request.entries(0).row_key());
+        }
+        auto code = request.entries(0).row_key() == "bar"
+                        ? grpc::StatusCode::OUT_OF_RANGE
+                        : grpc::StatusCode::OK;
+        auto reader =
+            google::cloud::internal::make_unique<MockMutateRowsReader>();
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce(Invoke([code](btproto::MutateRowsResponse* r) {
+              auto& e = *r->add_entries();
+              e.set_index(0);
+              e.mutable_status()->set_code(code);
+              return true;
+            }))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status::OK));
+        return reader.release()->AsUniqueMocked();
+      }));
+
+  bt::Table table(client_, kTableId,
+                  bt::BulkApplyOptions()
+                      .set_max_entries_per_request(1)
+                      .set_max_concurrent_requests(2));
+  try {
+    table.BulkApply(bt::BulkMutation(
+        bt::SingleRowMutation("foo", {bt::SetCell("fam", "col", 0_ms, "v0")}),
+        bt::SingleRowMutation("baz", {bt::SetCell("fam", "col", 0_ms, "v1")}),
+        bt::SingleRowMutation("bar", {bt::SetCell("fam", "col", 0_ms, "v2")}),
+        bt::SingleRowMutation("qux",
+                              {bt::SetCell("fam", "col", 0_ms, "v3")})));
+    FAIL() << "expected a PermanentMutationFailure";
+  } catch (bt::PermanentMutationFailure const& ex) {
+    ASSERT_EQ(1UL, ex.failures().size());
+    EXPECT_EQ(2, ex.failures()[0].original_index());
+    EXPECT_EQ("bar", ex.failures()[0].mutation().row_key());
+  }
+  EXPECT_THAT(requested, UnorderedElementsAre("foo", "baz", "bar", "qux"));
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
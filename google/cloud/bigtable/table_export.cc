@@ -0,0 +1,203 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table_export.h"
+#include "google/cloud/bigtable/internal/sorted_row_file.h"
+#include "google/cloud/bigtable/row_set.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+namespace {
+/**
+ * Run @p worker in @p thread_count threads and wait for all of them.
+ *
+ * The first exception raised by any worker is rethrown once all the threads
+ * finish.
+ */
+template <typename Functor>
+void RunWorkers(std::size_t thread_count, Functor worker) {
+  std::vector<std::future<void>> workers;
+  workers.reserve(thread_count);
+  for (std::size_t i = 0; i != thread_count; ++i) {
+    workers.push_back(std::async(std::launch::async, worker));
+  }
+  std::exception_ptr error;
+  for (auto& w : workers) {
+    try {
+      w.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+std::string PartitionPath(std::string const& directory,
+                          std::string const& prefix, std::size_t index) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%05zu", index);
+  std::string path = directory;
+  if (!path.empty() && path.back() != '/') {
+    path += '/';
+  }
+  return path + prefix + buf;
+}
+
+RowRange PartitionRange(std::string const& begin, std::string const& end) {
+  if (end.empty()) {
+    return begin.empty() ? RowRange::InfiniteRange()
+                         : RowRange::StartingAt(begin);
+  }
+  return RowRange::RightOpen(begin, end);
+}
+}  // namespace
+
+namespace internal {
+std::vector<std::string> ExportPartitionBoundaries(
+    std::vector<RowKeySample> const& samples, std::size_t partition_count) {
+  // The samples are sorted, but may include the empty key for "end of table".
+  std::vector<std::string> keys;
+  for (auto const& s : samples) {
+    if (s.row_key.empty() || (!keys.empty() && keys.back() == s.row_key)) {
+      continue;
+    }
+    keys.push_back(s.row_key);
+  }
+  auto const parts = (std::min)(partition_count, keys.size() + 1);
+  std::vector<std::string> boundaries;
+  for (std::size_t i = 1; i < parts; ++i) {
+    boundaries.push_back(keys[i * keys.size() / parts]);
+  }
+  return boundaries;
+}
+}  // namespace internal
+
+std::vector<ExportedFile> ExportTable(Table const& table,
+                                      std::string const& directory,
+                                      ExportOptions const& options) {
+  // The Table member functions are not const, each thread uses its own copy.
+  Table sampler = table;
+  auto boundaries = internal::ExportPartitionBoundaries(
+      sampler.SampleRows(), options.partition_count());
+
+  std::vector<ExportedFile> partitions(boundaries.size() + 1);
+  for (std::size_t i = 0; i != partitions.size(); ++i) {
+    auto& p = partitions[i];
+    p.path = PartitionPath(directory, options.file_prefix(), i);
+    p.begin_key = i == 0 ? std::string{} : boundaries[i - 1];
+    p.end_key = i == boundaries.size() ? std::string{} : boundaries[i];
+    p.row_count = 0;
+    p.file_size = 0;
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> failed(false);
+  auto worker = [&] {
+    Table t = table;
+    try {
+      for (auto i = next++; i < partitions.size() && !failed; i = next++) {
+        auto& p = partitions[i];
+        internal::SortedRowFileWriter writer(p.path, options.block_size());
+        auto reader = t.ReadRows(
+            RowSet(PartitionRange(p.begin_key, p.end_key)), options.filter());
+        for (auto const& row : reader) {
+          writer.Append(row);
+        }
+        writer.Close();
+        p.row_count = writer.row_count();
+        p.file_size = writer.file_size();
+      }
+    } catch (...) {
+      failed = true;
+      throw;
+    }
+  };
+  RunWorkers((std::min)(options.thread_count(), partitions.size()), worker);
+
+  std::vector<ExportedFile> result;
+  for (auto& p : partitions) {
+    if (p.row_count == 0) {
+      std::remove(p.path.c_str());
+      continue;
+    }
+    result.push_back(std::move(p));
+  }
+  return result;
+}
+
+std::int64_t ImportTable(Table const& table,
+                         std::vector<std::string> const& paths,
+                         ImportOptions const& options) {
+  // Read all the indices first, so corrupted files are detected before any
+  // rows are applied.
+  std::vector<internal::SortedRowFileReader> readers;
+  std::vector<std::pair<std::size_t, std::size_t>> blocks;
+  readers.reserve(paths.size());
+  for (auto const& path : paths) {
+    readers.emplace_back(path);
+    for (std::size_t b = 0; b != readers.back().block_count(); ++b) {
+      blocks.emplace_back(readers.size() - 1, b);
+    }
+  }
+  if (blocks.empty()) {
+    return 0;
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::atomic<std::int64_t> row_count(0);
+  auto worker = [&] {
+    Table t = table;
+    try {
+      for (auto i = next++; i < blocks.size() && !failed; i = next++) {
+        auto rows = readers[blocks[i].first].ReadBlock(blocks[i].second);
+        BulkMutation mutation;
+        for (auto& row : rows) {
+          SingleRowMutation m(row.row_key());
+          for (auto const& cell : row.cells()) {
+            m.emplace_back(SetCell(
+                cell.family_name(), cell.column_qualifier(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    cell.timestamp()),
+                cell.value()));
+          }
+          mutation.emplace_back(std::move(m));
+        }
+        t.BulkApply(std::move(mutation));
+        row_count += static_cast<std::int64_t>(rows.size());
+      }
+    } catch (...) {
+      failed = true;
+      throw;
+    }
+  };
+  RunWorkers((std::min)(options.thread_count(), blocks.size()), worker);
+  return row_count.load();
+}
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,210 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TABLE_EXPORT_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TABLE_EXPORT_H_
+
+#include "google/cloud/bigtable/filters.h"
+#include "google/cloud/bigtable/row_key_sample.h"
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/version.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace bigtable {
+inline namespace BIGTABLE_CLIENT_NS {
+/// The number of threads used by default to export and import tables.
+inline std::size_t DefaultExportThreadCount() {
+  auto const n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+/**
+ * Control how `ExportTable()` partitions and writes a table.
+ */
+class ExportOptions {
+ public:
+  ExportOptions()
+      : thread_count_(DefaultExportThreadCount()),
+        partition_count_(4 * thread_count_),
+        block_size_(64 * 1024),
+        filter_(Filter::PassAllFilter()),
+        file_prefix_("export-") {}
+
+  /// Set the number of partitions read at the same time.
+  ExportOptions& set_thread_count(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ExportOptions::set_thread_count requires v > 0");
+    }
+    thread_count_ = v;
+    return *this;
+  }
+  std::size_t thread_count() const { return thread_count_; }
+
+  /**
+   * Set the maximum number of partitions, and therefore files.
+   *
+   * The partitions are chosen from the `SampleRows()` results, small tables
+   * may use fewer partitions.
+   */
+  ExportOptions& set_partition_count(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ExportOptions::set_partition_count requires v > 0");
+    }
+    partition_count_ = v;
+    return *this;
+  }
+  std::size_t partition_count() const { return partition_count_; }
+
+  /// Set the approximate size of the blocks in each file.
+  ExportOptions& set_block_size(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ExportOptions::set_block_size requires v > 0");
+    }
+    block_size_ = v;
+    return *this;
+  }
+  std::size_t block_size() const { return block_size_; }
+
+  /// Set the filter applied to the exported rows, use it to skip old cells.
+  ExportOptions& set_filter(Filter v) {
+    filter_ = std::move(v);
+    return *this;
+  }
+  Filter const& filter() const { return filter_; }
+
+  /// Set the prefix for the file names, the partition number follows it.
+  ExportOptions& set_file_prefix(std::string v) {
+    file_prefix_ = std::move(v);
+    return *this;
+  }
+  std::string const& file_prefix() const { return file_prefix_; }
+
+ private:
+  std::size_t thread_count_;
+  std::size_t partition_count_;
+  std::size_t block_size_;
+  Filter filter_;
+  std::string file_prefix_;
+};
+
+/// Describe one of the files created by `ExportTable()`.
+struct ExportedFile {
+  std::string path;
+  /// The partition exported to this file is [begin_key, end_key).
+  std::string begin_key;
+  /// An empty value represents the end of the table.
+  std::string end_key;
+  std::int64_t row_count;
+  std::uint64_t file_size;
+};
+
+/**
+ * Export the contents of a table to local files.
+ *
+ * The key space is partitioned using `Table::SampleRows()`, and the partitions
+ * are read at the same time, using `options.thread_count()` threads. Each
+ * partition is written to its own file, with the rows sorted by key. The files
+ * are split in checksummed blocks, with prefix-compressed keys, and end with
+ * an index of the first key in each block.
+ *
+ * @param table the table to export.
+ * @param directory the directory where the files are created, it must exist.
+ * @param options how to partition the table and write the files.
+ * @return the files created, in key order. Partitions without rows do not
+ *     create a file.
+ *
+ * @throws bigtable::GRpcError if reading the table fails, or
+ *     `std::runtime_error` if a file cannot be written.
+ *
+ * @par Example
+ * @code
+ * auto files = bigtable::ExportTable(table, "/var/backups/my-table");
+ * // ... later, possibly to a different table ...
+ * std::vector<std::string> paths;
+ * for (auto const& f : files) paths.push_back(f.path);
+ * bigtable::ImportTable(other_table, paths);
+ * @endcode
+ */
+std::vector<ExportedFile> ExportTable(Table const& table,
+                                      std::string const& directory,
+                                      ExportOptions const& options = {});
+
+/**
+ * Control how `ImportTable()` applies the rows in the exported files.
+ */
+class ImportOptions {
+ public:
+  ImportOptions() : thread_count_(DefaultExportThreadCount()) {}
+
+  /// Set the number of blocks read and applied at the same time.
+  ImportOptions& set_thread_count(std::size_t v) {
+    if (v == 0) {
+      google::cloud::internal::ThrowRangeError(
+          "ImportOptions::set_thread_count requires v > 0");
+    }
+    thread_count_ = v;
+    return *this;
+  }
+  std::size_t thread_count() const { return thread_count_; }
+
+ private:
+  std::size_t thread_count_;
+};
+
+/**
+ * Apply the rows in files created by `ExportTable()` to a table.
+ *
+ * The blocks in all the files are read and applied with `BulkApply()` at the
+ * same time, using `options.thread_count()` threads, so even a single large
+ * file is imported in parallel. The cells keep their original timestamps,
+ * which makes the import idempotent.
+ *
+ * @return the number of rows imported.
+ *
+ * @throws bigtable::PermanentMutationFailure if some rows cannot be applied,
+ *     or `std::runtime_error` if a file cannot be read or is corrupted.
+ */
+std::int64_t ImportTable(Table const& table,
+                         std::vector<std::string> const& paths,
+                         ImportOptions const& options = {});
+
+namespace internal {
+/**
+ * Compute the partitions used by `ExportTable()`.
+ *
+ * @return the boundaries between partitions, in increasing order. The first
+ *     partition starts at the beginning of the table, and the last one ends at
+ *     the end of the table.
+ */
+std::vector<std::string> ExportPartitionBoundaries(
+    std::vector<RowKeySample> const& samples, std::size_t partition_count);
+}  // namespace internal
+
+}  // namespace BIGTABLE_CLIENT_NS
+}  // namespace bigtable
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_BIGTABLE_TABLE_EXPORT_H_
@@ -0,0 +1,91 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table_export.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+#include <gmock/gmock.h>
+
+namespace bigtable = google::cloud::bigtable;
+using bigtable::internal::ExportPartitionBoundaries;
+
+namespace {
+std::vector<bigtable::RowKeySample> MakeSamples(
+    std::vector<std::string> const& keys) {
+  std::vector<bigtable::RowKeySample> samples;
+  std::int64_t offset = 0;
+  for (auto const& k : keys) {
+    offset += 1000;
+    samples.push_back(bigtable::RowKeySample{k, offset});
+  }
+  return samples;
+}
+
+class TableExportTest : public bigtable::testing::TableTestFixture {};
+}  // anonymous namespace
+
+/// @test Verify that a table without samples is exported as one partition.
+TEST(ExportPartitionBoundariesTest, NoSamples) {
+  EXPECT_TRUE(ExportPartitionBoundaries({}, 8).empty());
+  EXPECT_TRUE(ExportPartitionBoundaries(MakeSamples({""}), 8).empty());
+}
+
+/// @test Verify that small tables use fewer partitions.
+TEST(ExportPartitionBoundariesTest, FewSamples) {
+  auto actual = ExportPartitionBoundaries(MakeSamples({"b", "d", ""}), 8);
+  EXPECT_EQ((std::vector<std::string>{"b", "d"}), actual);
+}
+
+/// @test Verify that duplicate samples do not create empty partitions.
+TEST(ExportPartitionBoundariesTest, DuplicateSamples) {
+  auto actual =
+      ExportPartitionBoundaries(MakeSamples({"b", "b", "d", "d", ""}), 8);
+  EXPECT_EQ((std::vector<std::string>{"b", "d"}), actual);
+}
+
+/// @test Verify that the boundaries are evenly spaced among the samples.
+TEST(ExportPartitionBoundariesTest, EvenlySpaced) {
+  std::vector<std::string> keys;
+  for (char c = 'a'; c <= 'p'; ++c) {
+    keys.push_back(std::string(1, c));
+  }
+  auto actual = ExportPartitionBoundaries(MakeSamples(keys), 4);
+  EXPECT_EQ((std::vector<std::string>{"e", "i", "m"}), actual);
+}
+
+/// @test Verify that importing no files does not make any requests.
+TEST_F(TableExportTest, ImportNoFiles) {
+  using namespace ::testing;
+  EXPECT_CALL(*client_, MutateRows(_, _)).Times(0);
+  EXPECT_EQ(0, bigtable::ImportTable(table_, {}));
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that the options reject invalid values.
+TEST(ExportOptionsTest, RejectsZero) {
+  bigtable::ExportOptions options;
+  EXPECT_THROW(options.set_thread_count(0), std::range_error);
+  EXPECT_THROW(options.set_partition_count(0), std::range_error);
+  EXPECT_THROW(options.set_block_size(0), std::range_error);
+  bigtable::ImportOptions import_options;
+  EXPECT_THROW(import_options.set_thread_count(0), std::range_error);
+}
+
+/// @test Verify that missing files are reported before any requests.
+TEST_F(TableExportTest, ImportMissingFile) {
+  using namespace ::testing;
+  EXPECT_CALL(*client_, MutateRows(_, _)).Times(0);
+  EXPECT_THROW(bigtable::ImportTable(table_, {"/nonexistent/export-00000"}),
+               std::runtime_error);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
@@ -0,0 +1,201 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/bigtable/table.h"
+#include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/table_test_fixture.h"
+
+namespace bigtable = google::cloud::bigtable;
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::Return;
+using testing::SetArgPointee;
+
+/// Define helper types and functions for this test.
+namespace {
+class TableReadColumnsTest : public bigtable::testing::TableTestFixture {};
+using bigtable::testing::MockReadRowsReader;
+
+std::vector<bigtable::ColumnSpec> TestSchema() {
+  return {{"fam", "counter", bigtable::ColumnType::INT64},
+          {"fam", "name", bigtable::ColumnType::BYTES}};
+}
+}  // anonymous namespace
+
+TEST_F(TableReadColumnsTest, ReadColumnsInBatches) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "counter" }
+        timestamp_micros: 42000
+        value: "\000\000\000\000\000\000\000\001"
+      }
+      chunks {
+        qualifier { value: "name" }
+        timestamp_micros: 42000
+        value: "name-1"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "counter" }
+        timestamp_micros: 42000
+        value: "\000\000\000\000\000\000\000\002"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r3"
+        family_name { value: "fam" }
+        qualifier { value: "name" }
+        timestamp_micros: 42000
+        value: "name-3"
+        commit_row: true
+      }
+      )");
+
+  // must be a new pointer, it is wrapped in unique_ptr by ReadRows
+  auto stream = new MockReadRowsReader;
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  auto reader = table_.ReadColumns(
+      bigtable::RowSet(), bigtable::Filter::PassAllFilter(), TestSchema(), 2);
+
+  bigtable::ColumnarBatch batch;
+  ASSERT_TRUE(reader.NextBatch(batch));
+  ASSERT_EQ(2U, batch.row_count());
+  EXPECT_EQ("r1", batch.row_key(0));
+  EXPECT_EQ("r2", batch.row_key(1));
+  EXPECT_EQ(1, batch.column(0).int64_values()[0]);
+  EXPECT_EQ(2, batch.column(0).int64_values()[1]);
+  EXPECT_EQ("name-1", batch.column(1).bytes_value(0));
+  EXPECT_TRUE(batch.column(1).is_null(1));
+
+  ASSERT_TRUE(reader.NextBatch(batch));
+  ASSERT_EQ(1U, batch.row_count());
+  EXPECT_EQ("r3", batch.row_key(0));
+  EXPECT_TRUE(batch.column(0).is_null(0));
+  EXPECT_EQ("name-3", batch.column(1).bytes_value(0));
+
+  EXPECT_FALSE(reader.NextBatch(batch));
+  EXPECT_EQ(0U, batch.row_count());
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST_F(TableReadColumnsTest, ReadColumnsWithRetries) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "counter" }
+        timestamp_micros: 42000
+        value: "\000\000\000\000\000\000\000\001"
+        commit_row: true
+      }
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "name" }
+        timestamp_micros: 42000
+        value: "partial"
+      }
+      )");
+
+  auto response_retry = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r2"
+        family_name { value: "fam" }
+        qualifier { value: "name" }
+        timestamp_micros: 42000
+        value: "name-2"
+        commit_row: true
+      }
+      )");
+
+  // must be a new pointer, it is wrapped in unique_ptr by ReadRows
+  auto stream = new MockReadRowsReader;
+  auto stream_retry = new MockReadRowsReader;
+
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()))
+      .WillOnce(Invoke([stream_retry](grpc::ClientContext*,
+                                      google::bigtable::v2::ReadRowsRequest
+                                          const& req) {
+        // The retry starts after the last row in the batch.
+        EXPECT_EQ("r1", req.rows().row_ranges(0).start_key_open());
+        return stream_retry->AsUniqueMocked();
+      }));
+
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream, Finish())
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+
+  EXPECT_CALL(*stream_retry, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(response_retry), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*stream_retry, Finish()).WillOnce(Return(grpc::Status::OK));
+
+  auto reader = table_.ReadColumns(
+      bigtable::RowSet(), bigtable::Filter::PassAllFilter(), TestSchema());
+
+  bigtable::ColumnarBatch batch;
+  ASSERT_TRUE(reader.NextBatch(batch));
+  ASSERT_EQ(2U, batch.row_count());
+  EXPECT_EQ("r1", batch.row_key(0));
+  EXPECT_EQ("r2", batch.row_key(1));
+  EXPECT_EQ("name-2", batch.column(1).bytes_value(1));
+  EXPECT_EQ("name-2", batch.column(1).bytes_data());
+  EXPECT_FALSE(reader.NextBatch(batch));
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST_F(TableReadColumnsTest, ReadColumnsThrowsOnInvalidInt64) {
+  auto response = bigtable::testing::ReadRowsResponseFromString(R"(
+      chunks {
+        row_key: "r1"
+        family_name { value: "fam" }
+        qualifier { value: "counter" }
+        timestamp_micros: 42000
+        value: "not-a-counter"
+        commit_row: true
+      }
+      )");
+
+  // must be a new pointer, it is wrapped in unique_ptr by ReadRows
+  auto stream = new MockReadRowsReader;
+  EXPECT_CALL(*stream, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(response), Return(true)))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*stream, Finish()).WillOnce(Return(grpc::Status::OK));
+  EXPECT_CALL(*client_, ReadRows(_, _))
+      .WillOnce(Invoke(stream->MakeMockReturner()));
+
+  auto reader = table_.ReadColumns(
+      bigtable::RowSet(), bigtable::Filter::PassAllFilter(), TestSchema());
+
+  bigtable::ColumnarBatch batch;
+  EXPECT_THROW(reader.NextBatch(batch), std::exception);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
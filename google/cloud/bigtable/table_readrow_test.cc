@@ -14,8 +14,12 @@
 
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/bigtable/testing/mock_read_rows_reader.h"
+#include "google/cloud/bigtable/testing/mock_response_reader.h"
 #include "google/cloud/bigtable/testing/table_test_fixture.h"
 #include "google/cloud/internal/make_unique.h"
+#include <grpcpp/alarm.h>
+#include <chrono>
+#include <vector>
 
 namespace bigtable = google::cloud::bigtable;
 
@@ -23,6 +27,29 @@ namespace bigtable = google::cloud::bigtable;
 namespace {
 class TableReadRowTest : public bigtable::testing::TableTestFixture {};
 using bigtable::testing::MockReadRowsReader;
+
+/// A hedging policy that always hedges after a short delay.
+class AlwaysHedgePolicy : public bigtable::HedgingPolicy {
+ public:
+  std::unique_ptr<bigtable::HedgingPolicy> clone() const override {
+    return std::unique_ptr<bigtable::HedgingPolicy>(new AlwaysHedgePolicy);
+  }
+  std::chrono::milliseconds HedgeDelay() override {
+    return std::chrono::milliseconds(1);
+  }
+  bool OnHedge() override {
+    ++hedge_count;
+    return true;
+  }
+  void OnCompletion(std::chrono::milliseconds, bool h, bool) override {
+    ++completion_count;
+    hedged = h;
+  }
+
+  int hedge_count = 0;
+  int completion_count = 0;
+  bool hedged = false;
+};
 }  // anonymous namespace
 
 TEST_F(TableReadRowTest, ReadRowSimple) {
@@ -112,3 +139,99 @@ TEST_F(TableReadRowTest, UnrecoverableFailure) {
       "exceptions are disabled");
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 }
+
+TEST_F(TableReadRowTest, ReadRowHedged) {
+  using namespace ::testing;
+  namespace btproto = ::google::bigtable::v2;
+  using bigtable::testing::MockClientAsyncReaderInterface;
+  using Reader = MockClientAsyncReaderInterface<btproto::ReadRowsResponse>;
+
+  // The hedged attempts run on a completion queue created by ReadRow(), the
+  // mocks use alarms on that queue to complete each asynchronous call.
+  std::vector<std::unique_ptr<grpc::Alarm>> alarms;
+  auto post = [&alarms](grpc::CompletionQueue* cq, void* tag, bool ok) {
+    alarms.emplace_back(new grpc::Alarm);
+    // A cancelled alarm completes with `ok == false`.
+    alarms.back()->Set(cq,
+                       ok ? std::chrono::system_clock::now()
+                          : std::chrono::system_clock::now() +
+                                std::chrono::hours(1),
+                       tag);
+    if (!ok) {
+      alarms.back()->Cancel();
+    }
+  };
+
+  // The first attempt stalls until the duplicate attempt finishes, then it
+  // reports the stream as cancelled.
+  grpc::CompletionQueue* cq = nullptr;
+  grpc::Alarm stalled_read;
+  std::unique_ptr<Reader> slow(new Reader);
+  EXPECT_CALL(*slow, Read(_, _))
+      .WillOnce(Invoke([&](btproto::ReadRowsResponse*, void* tag) {
+        stalled_read.Set(cq,
+                         std::chrono::system_clock::now() +
+                             std::chrono::hours(1),
+                         tag);
+      }));
+  EXPECT_CALL(*slow, Finish(_, _))
+      .WillOnce(Invoke([&](grpc::Status* status, void* tag) {
+        *status = grpc::Status(grpc::StatusCode::CANCELLED, "cancelled");
+        post(cq, tag, true);
+      }));
+
+  std::unique_ptr<Reader> fast(new Reader);
+  EXPECT_CALL(*fast, Read(_, _))
+      .WillOnce(Invoke([&](btproto::ReadRowsResponse* r, void* tag) {
+        auto chunk = r->add_chunks();
+        chunk->set_row_key("r1");
+        chunk->mutable_family_name()->set_value("fam");
+        chunk->mutable_qualifier()->set_value("col");
+        chunk->set_timestamp_micros(42000);
+        chunk->set_value("value");
+        chunk->set_commit_row(true);
+        post(cq, tag, true);
+      }))
+      .WillRepeatedly(Invoke([&](btproto::ReadRowsResponse*, void* tag) {
+        post(cq, tag, false);
+      }));
+  EXPECT_CALL(*fast, Finish(_, _))
+      .WillOnce(Invoke([&](grpc::Status* status, void* tag) {
+        *status = grpc::Status::OK;
+        stalled_read.Cancel();
+        post(cq, tag, true);
+      }));
+
+  EXPECT_CALL(*client_, AsyncReadRows(_, _, _, _))
+      .WillOnce(Invoke([&](grpc::ClientContext*,
+                           btproto::ReadRowsRequest const& req,
+                           grpc::CompletionQueue* q, void* tag) {
+        EXPECT_EQ("r1", req.rows().row_keys(0));
+        cq = q;
+        post(cq, tag, true);
+        return std::unique_ptr<
+            grpc::ClientAsyncReaderInterface<btproto::ReadRowsResponse>>(
+            slow.release());
+      }))
+      .WillOnce(Invoke([&](grpc::ClientContext*,
+                           btproto::ReadRowsRequest const& req,
+                           grpc::CompletionQueue* q, void* tag) {
+        EXPECT_EQ("r1", req.rows().row_keys(0));
+        EXPECT_EQ(cq, q);
+        post(cq, tag, true);
+        return std::unique_ptr<
+            grpc::ClientAsyncReaderInterface<btproto::ReadRowsResponse>>(
+            fast.release());
+      }));
+
+  auto policy = std::make_shared<AlwaysHedgePolicy>();
+  bigtable::Table table(client_, kTableId, policy);
+  auto result = table.ReadRow("r1", bigtable::Filter::PassAllFilter());
+  EXPECT_TRUE(std::get<0>(result));
+  EXPECT_EQ("r1", std::get<1>(result).row_key());
+  EXPECT_EQ(1, policy->hedge_count);
+  EXPECT_EQ(1, policy->completion_count);
+  EXPECT_TRUE(policy->hedged);
+  // ReadRow() returns only after the losing attempt completes, there is no
+  // need to wait for it before the mocks are destroyed.
+}
@@ -186,6 +186,24 @@ InProcessAdminClient::AsyncDeleteSnapshot(
   return Stub()->AsyncDeleteSnapshot(context, request, cq);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+InProcessAdminClient::AsyncSnapshotTable(
+    grpc::ClientContext* context,
+    google::bigtable::admin::v2::SnapshotTableRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return Stub()->AsyncSnapshotTable(context, request, cq);
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+InProcessAdminClient::AsyncCreateTableFromSnapshot(
+    grpc::ClientContext* context,
+    google::bigtable::admin::v2::CreateTableFromSnapshotRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return Stub()->AsyncCreateTableFromSnapshot(context, request, cq);
+}
+
 std::unique_ptr<
     grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
 InProcessAdminClient::AsyncGetOperation(
@@ -165,6 +165,19 @@ class InProcessAdminClient : public bigtable::AdminClient {
       grpc::CompletionQueue* cq) override;
   std::unique_ptr<
       grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+  AsyncSnapshotTable(
+      grpc::ClientContext* context,
+      google::bigtable::admin::v2::SnapshotTableRequest const& request,
+      grpc::CompletionQueue* cq) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
+  AsyncCreateTableFromSnapshot(
+      grpc::ClientContext* context,
+      google::bigtable::admin::v2::CreateTableFromSnapshotRequest const&
+          request,
+      grpc::CompletionQueue* cq) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::longrunning::Operation>>
   AsyncGetOperation(grpc::ClientContext* context,
                     const google::longrunning::GetOperationRequest& request,
                     grpc::CompletionQueue* cq) override;
@@ -173,6 +173,20 @@ class MockAdminClient : public bigtable::AdminClient {
           grpc::ClientContext* context,
           google::bigtable::admin::v2::DeleteSnapshotRequest const& request,
           grpc::CompletionQueue* cq));
+  MOCK_METHOD3(
+      AsyncSnapshotTable,
+      std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+          google::longrunning::Operation>>(
+          grpc::ClientContext* context,
+          google::bigtable::admin::v2::SnapshotTableRequest const& request,
+          grpc::CompletionQueue* cq));
+  MOCK_METHOD3(AsyncCreateTableFromSnapshot,
+               std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                   google::longrunning::Operation>>(
+                   grpc::ClientContext* context,
+                   google::bigtable::admin::v2::
+                       CreateTableFromSnapshotRequest const& request,
+                   grpc::CompletionQueue* cq));
   MOCK_METHOD3(AsyncGetOperation,
                std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
                    google::longrunning::Operation>>(
@@ -12,14 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "google/cloud/bigtable/bulk_loader.h"
 #include "google/cloud/bigtable/table.h"
 #include "google/cloud/storage/client.h"
-#include <condition_variable>
-#include <fstream>
+#include <algorithm>
 #include <future>
 #include <iomanip>
-#include <mutex>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 /**
@@ -27,94 +27,32 @@
  *
  * Shows how to upload CSV data from Google Cloud Storage to Google Cloud
  * Bigtable.
+ *
+ * The objects are read in parallel, and each object is split in several byte
+ * ranges, also read in parallel. The records are parsed, converted to
+ * mutations, and applied by a `bigtable::BulkLoader`.
  */
 namespace cbt = google::cloud::bigtable;
 namespace gcs = google::cloud::storage;
 
 namespace {
-template <typename T>
-class GenericCircularBuffer {
- public:
-  explicit GenericCircularBuffer(std::size_t size)
-      : buffer_(size), head_(0), tail_(0), empty_(true), is_shutdown_(false) {}
-
-  void Shutdown() {
-    std::unique_lock<std::mutex> lk(mu_);
-    is_shutdown_ = true;
-    lk.unlock();
-    cv_.notify_all();
-  }
-
-  bool Pop(T& next) {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this]() { return !Empty() || is_shutdown_; });
-    if (!Empty()) {
-      next = std::move(buffer_[head_]);
-      ++head_;
-      if (head_ >= buffer_.size()) {
-        head_ = 0;
-      }
-      empty_ = head_ == tail_;
-      lk.unlock();
-      cv_.notify_all();
-      return true;
-    }
-    return !is_shutdown_;
-  }
-
-  void Push(T data) {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this]() { return !Full(); });
-    buffer_[tail_] = std::move(data);
-    ++tail_;
-    if (tail_ >= buffer_.size()) {
-      tail_ = 0;
-    }
-    empty_ = false;
-    lk.unlock();
-    cv_.notify_all();
-  }
-
- private:
-  bool Empty() { return head_ == tail_ && empty_; }
-  bool Full() { return head_ == tail_ && !empty_; }
-
- private:
-  std::mutex mu_;
-  std::condition_variable cv_;
-  std::vector<T> buffer_;
-  std::size_t head_;
-  std::size_t tail_;
-  bool empty_;
-  bool is_shutdown_;
-};
-
-/**
- * Breakdown a CSV file line into fields.
- *
- * TODO() - handle escape sequences with backslash.
- *
- * TODO() - handle quoted fields with embedded separators.
- *
- * TODO() - make the separator configurable.
- */
-std::vector<std::string> ParseLine(long lineno, std::string const& line,
-                                   char separator);
-
-using CircularBuffer = GenericCircularBuffer<cbt::BulkMutation>;
+/// The size of the chunks passed to the `BulkLoader`.
+std::size_t const kChunkSize = 4 * 1024 * 1024;
 
 struct Options {
-  char separator;
+  char separator = ',';
   std::vector<int> keys;
   std::string keys_separator;
+  int ranges = 0;
 
   std::string ConsumeArg(int& argc, char* argv[], char const* arg_name) {
     std::string const separator_option = "--separator=";
     std::string const key_option = "--key=";
     std::string const keys_separator_option = "--key-separator=";
+    std::string const ranges_option = "--ranges=";
 
     std::string const usage = R""(
-[options] <project> <instance> <table> <family> <bucket> <object>
+[options] <project> <instance> <table> <family> <bucket> <object> [object...]
 The options are:
     --help: produce this help.
     --separator=c: use the 'c' character instead of comma (',') to separate the
@@ -123,12 +61,16 @@ The options are:
         starting at one. They are concatenated in the order provided.
     --key-separator=sep: use 'sep' to separate the fields when forming the row
         key.
+    --ranges=N: read each object as N byte ranges in parallel, the default is
+        one range per core. Use --ranges=1 if the quoted fields in the CSV file
+        contain newlines.
     project: the Google Cloud Platform project id for your table.
     instance: the Cloud Bigtable instance hosting your table.
     table: the table where you want to upload the CSV file.
     family: the column family where you want to upload the CSV file.
     bucket: the name of the GCS bucket that contains the data.
-    object: the name of the GCS object that contains the data.
+    object: the name of the GCS objects that contain the data, all the objects
+        must have the same header line.
 )"";
     while (argc >= 2) {
       std::string argument(argv[1]);
@@ -141,6 +83,8 @@ The options are:
         keys.push_back(std::stoi(argument.substr(key_option.size())) - 1);
       } else if (0 == argument.find(keys_separator_option)) {
         keys_separator = argument.substr(keys_separator_option.size());
+      } else if (0 == argument.find(ranges_option)) {
+        ranges = std::stoi(argument.substr(ranges_option.size()));
       } else {
         return argument;
       }
@@ -156,6 +100,52 @@ The options are:
   }
 };
 
+/**
+ * Read the records that start in the [begin, end) byte range of an object.
+ *
+ * Each record belongs to the range that contains its first byte. The read
+ * starts one byte before @p begin, to discard the tail of a record started in
+ * the previous range, and continues past @p end to complete the last record.
+ */
+void ReadObjectRange(gcs::Client client, std::string const& bucket,
+                     std::string const& object, std::int64_t begin,
+                     std::int64_t end, std::int64_t object_size,
+                     cbt::BulkLoader& loader) {
+  std::int64_t offset = begin == 0 ? 0 : begin - 1;
+  auto is =
+      client.ReadObject(bucket, object, gcs::ReadRange(offset, object_size));
+  std::string line;
+  if (begin != 0) {
+    std::getline(is, line, '\n');
+    offset += static_cast<std::int64_t>(line.size()) + 1;
+  }
+  std::string chunk;
+  while (offset < end && std::getline(is, line, '\n')) {
+    offset += static_cast<std::int64_t>(line.size()) + 1;
+    chunk += line;
+    chunk += '\n';
+    if (chunk.size() >= kChunkSize) {
+      loader.AddChunk(std::move(chunk));
+      chunk = {};
+    }
+  }
+  loader.AddChunk(std::move(chunk));
+  // Reading stops early for all but the last range, that is not an error.
+  if (offset < end && !is.status().ok()) {
+    std::ostringstream os;
+    os << "Error reading gs://" << bucket << "/" << object << " at offset "
+       << offset << ": " << is.status();
+    throw std::runtime_error(os.str());
+  }
+}
+
+void ReportProgress(cbt::BulkLoader const& loader) {
+  std::cout << loader.row_count() << " rows, " << std::fixed
+            << std::setprecision(1) << loader.rows_per_second() << " rows/s, "
+            << loader.bytes_per_second() / (1024.0 * 1024.0) << " MiB/s"
+            << std::endl;
+}
+
 }  // anonymous namespace
 
 int main(int argc, char* argv[]) try {
@@ -166,63 +156,28 @@ int main(int argc, char* argv[]) try {
   std::string const table_id = options.ConsumeArg(argc, argv, "table_id");
   std::string const family = options.ConsumeArg(argc, argv, "family");
   std::string const bucket = options.ConsumeArg(argc, argv, "bucket");
-  std::string const object = options.ConsumeArg(argc, argv, "object");
+  std::vector<std::string> objects{options.ConsumeArg(argc, argv, "object")};
+  while (argc >= 2) {
+    objects.push_back(options.ConsumeArg(argc, argv, "object"));
+  }
 
   // If the user does not say, use the first column as the row key.
   if (options.keys.empty()) {
     options.keys.push_back(0);
   }
+  unsigned int const cores =
+      (std::max)(std::thread::hardware_concurrency(), 1U);
+  if (options.ranges <= 0) {
+    options.ranges = static_cast<int>(cores);
+  }
 
   // Create a connection to Cloud Bigtable and an object to manipulate the
   // specific table used in this demo.
   cbt::Table table(cbt::CreateDefaultDataClient(
                        project_id, instance_id,
-                       cbt::ClientOptions().set_connection_pool_size(
-                           std::thread::hardware_concurrency())),
+                       cbt::ClientOptions().set_connection_pool_size(cores)),
                    table_id);
 
-  // How often do we print a progress marker ('.') in the reader thread.
-  int const report_reader_progress_rate = 500000;
-  // How often do we print a progress marker ('+') in the worker threads.
-  int const report_worker_progress_rate = 5;
-  // The size of the thread pool pushing data to Cloud Bigtable
-  std::size_t const thread_pool_size = []() -> std::size_t {
-    if (std::thread::hardware_concurrency() != 0U) {
-      return std::thread::hardware_concurrency() - 1;
-    }
-    return 1;
-  }();
-
-  // The size of the circular buffer. It is tempting to make it larger, but each
-  // element in the circular buffer can be a few MiB in size. We limit this to
-  // the number of threads, once it becomes that large all threads will have
-  // work to do after they finish their current work.
-  int const buffer_size = static_cast<int>(thread_pool_size);
-
-  // Create a circular buffer to communicate between the main thread that reads
-  // the file and the threads that upload the parsed lines to Cloud Bigtable.
-  CircularBuffer buffer(buffer_size);
-  // Then create a few threads, each one of which pulls mutations out of the
-  // circular buffer and then applies the mutation to the table.
-  auto read_buffer = [&buffer](cbt::Table table, int report_progress_rate) {
-    long count = 0;
-    cbt::BulkMutation mutation;
-    while (buffer.Pop(mutation)) {
-      table.BulkApply(std::move(mutation));
-      if (++count % report_progress_rate == 0) {
-        std::cout << '+' << std::flush;
-      }
-    }
-  };
-
-  std::cout << "Starting " << thread_pool_size << " workers ..." << std::flush;
-  std::vector<std::future<void>> workers;
-  for (std::size_t i = 0; i != thread_pool_size; ++i) {
-    workers.push_back(std::async(std::launch::async, read_buffer, table,
-                                 report_worker_progress_rate));
-  }
-  std::cout << " DONE" << std::endl;
-
   google::cloud::StatusOr<gcs::ClientOptions> opts =
       gcs::ClientOptions::CreateDefaultClientOptions();
   if (!opts) {
@@ -230,32 +185,27 @@ int main(int argc, char* argv[]) try {
     return 1;
   }
   gcs::Client client(opts->set_project_id(project_id));
-  // The main thread just reads the file one line at a time.
-  auto is = client.ReadObject(bucket, object);
-  std::string line;
-  std::getline(is, line, '\n');
-  int lineno = 0;
-  auto headers = ParseLine(++lineno, line, options.separator);
 
+  // All the objects have the same header, read it from the first one.
+  std::string line;
+  {
+    auto is = client.ReadObject(bucket, objects.front());
+    std::getline(is, line, '\n');
+  }
+  if (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  auto const headers = cbt::ParseCsvRecord(line, options.separator);
   std::cout << "# HEADER " << line << std::endl;
 
-  std::cout << "Reading input file " << std::flush;
-  auto start = std::chrono::steady_clock::now();
-
-  // We can only do about 100,000 Apply operations in each BulkApply (see the
-  // Cloud Bigtable bigtable.proto file for details), and each SingleRowMutation
-  // we create below has roughly headers.size() elements. So we want at most:
-  auto bulk_apply_size = static_cast<int>(100000 / headers.size());
-  cbt::BulkMutation bulk;
-  int count = 0;
-  while (!is.eof()) {
-    ++lineno;
-    std::getline(is, line, '\n');
-    if (line.empty()) {
-      break;
+  // Create a mutation that inserts one column per field, the name of the
+  // column is derived from the header.
+  auto mapper = [&headers, &family, &options](
+                    std::vector<std::string> const& fields) {
+    using MaybeMutation = google::cloud::optional<cbt::SingleRowMutation>;
+    if (fields == headers) {
+      return MaybeMutation();
     }
-    auto parsed = ParseLine(lineno, line, options.separator);
-
     using std::chrono::milliseconds;
     auto ts = std::chrono::duration_cast<milliseconds>(
         std::chrono::system_clock::now().time_since_epoch());
@@ -266,84 +216,86 @@ int main(int argc, char* argv[]) try {
     for (auto&& index : options.keys) {
       row_key += row_key_separator;
       row_key_separator = options.keys_separator;
-      if (index == -1) {
-        // Magic index, use the line number
-        row_key += std::to_string(lineno);
-      } else {
-        row_key += parsed.at(index);
-      }
+      row_key += fields.at(index);
     }
-
-    // Create a mutation that inserts one column per field, the name of the
-    // column is derived from the header.
     cbt::SingleRowMutation mutation(row_key);
-    auto field_count = std::min(headers.size(), parsed.size());
+    auto field_count = std::min(headers.size(), fields.size());
     for (std::size_t i = 0; i != field_count; ++i) {
-      mutation.emplace_back(cbt::SetCell(family, headers[i], ts, parsed[i]));
-    }
-    bulk.emplace_back(std::move(mutation));
-    // If we have too many mutations in the bulk mutation it is time to push it
-    // to the queue, where one of the running threads will pick it up.
-    if (++count >= bulk_apply_size) {
-      buffer.Push(std::move(bulk));
-      bulk = {};
-      count = 0;
+      mutation.emplace_back(cbt::SetCell(family, headers[i], ts, fields[i]));
     }
+    return MaybeMutation(std::move(mutation));
+  };
 
-    if (lineno % report_reader_progress_rate == 0) {
-      std::cout << '.' << std::flush;
-    }
+  // The completion queue threads send the mutations, the BulkLoader threads
+  // parse the records.
+  cbt::CompletionQueue cq;
+  std::vector<std::thread> cq_threads;
+  for (unsigned int i = 0; i != (std::max)(cores / 4, 1U); ++i) {
+    cq_threads.emplace_back([&cq] { cq.Run(); });
   }
-  if (count != 0) {
-    buffer.Push(std::move(bulk));
+  cbt::BulkLoader loader(table, cq, mapper,
+                         cbt::BulkLoaderOptions()
+                             .set_separator(options.separator)
+                             .set_parser_thread_count(cores));
+
+  std::cout << "Starting readers ..." << std::flush;
+  std::vector<std::future<void>> readers;
+  for (auto const& object : objects) {
+    auto metadata = client.GetObjectMetadata(bucket, object);
+    if (!metadata) {
+      std::cerr << "Cannot get metadata for gs://" << bucket << "/" << object
+                << ", status=" << metadata.status() << std::endl;
+      continue;
+    }
+    auto const size = static_cast<std::int64_t>(metadata->size());
+    auto const range_size = (size + options.ranges - 1) / options.ranges;
+    for (std::int64_t begin = 0; begin < size; begin += range_size) {
+      auto const end = (std::min)(begin + range_size, size);
+      readers.push_back(std::async(std::launch::async, ReadObjectRange, client,
+                                   bucket, object, begin, end, size,
+                                   std::ref(loader)));
+    }
   }
-  std::cout << " DONE" << std::endl;
+  std::cout << " DONE, " << readers.size() << " ranges" << std::endl;
 
-  std::cout << "Waiting for worker threads " << std::flush;
-  // Let the workers know that they can exit.
-  buffer.Shutdown();
-  int worker_count = 0;
-  for (auto& task : workers) {
-    // If there was an exception in any thread continue, and report any
-    // exceptions raised by other threads too.
+  auto start = std::chrono::steady_clock::now();
+  int reader_count = 0;
+  for (auto& reader : readers) {
+    while (reader.wait_for(std::chrono::seconds(10)) ==
+           std::future_status::timeout) {
+      ReportProgress(loader);
+    }
+    // If there was an exception in any reader continue, and report any
+    // exceptions raised by other readers too.
     try {
-      task.get();
+      reader.get();
     } catch (std::exception const& ex) {
-      std::cerr << "Exception raised by worker " << worker_count << ": "
+      std::cerr << "Exception raised by reader " << reader_count << ": "
                 << ex.what() << std::endl;
     }
-    ++worker_count;
-    std::cout << '.' << std::flush;
+    ++reader_count;
   }
+
+  std::cout << "Waiting for pending mutations " << std::flush;
+  auto failures = loader.Finish();
   std::cout << " DONE" << std::endl;
+  for (auto const& failure : failures) {
+    std::cerr << "Failed to apply row " << failure.mutation().row_key() << ": "
+              << failure.status().error_message() << std::endl;
+  }
+  ReportProgress(loader);
+
+  cq.Shutdown();
+  for (auto& t : cq_threads) {
+    t.join();
+  }
 
   auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
       std::chrono::steady_clock::now() - start);
   std::cout << "Total running time " << elapsed.count() << "s" << std::endl;
 
-  return 0;
+  return failures.empty() ? 0 : 1;
 } catch (std::exception const& ex) {
   std::cerr << "Standard exception raised: " << ex.what() << std::endl;
   return 1;
 }
-
-namespace {
-std::vector<std::string> ParseLine(long lineno, std::string const& line,
-                                   char separator) try {
-  std::vector<std::string> result;
-
-  // Extract the fields one at a time using a std::istringstream.
-  std::istringstream tokens(line);
-  while (!tokens.eof()) {
-    std::string tk;
-    std::getline(tokens, tk, separator);
-    result.emplace_back(std::move(tk));
-  }
-  return result;
-} catch (std::exception const& ex) {
-  std::ostringstream os;
-  os << ex.what() << " in line #" << lineno << " (" << line << ")";
-  throw std::runtime_error(os.str());
-}
-
-}  // namespace
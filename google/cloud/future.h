@@ -15,6 +15,8 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FUTURE_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FUTURE_H_
 
+#include "google/cloud/future_combinators.h"
+#include "google/cloud/internal/future_coroutines.h"
 #include "google/cloud/internal/future_then_impl.h"
 
 #endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FUTURE_H_
@@ -0,0 +1,530 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FUTURE_COMBINATORS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FUTURE_COMBINATORS_H_
+/**
+ * @file
+ *
+ * Implement `when_all()` and `when_any()` from ISO/IEC TS 19571:2016, and a
+ * `for_each_async()` helper to fan out asynchronous operations.
+ *
+ * None of these functions block, or create threads, they attach continuations
+ * to the input futures. The combined future becomes satisfied by whichever
+ * thread satisfies the last (or first, for `when_any()`) input future.
+ */
+
+#include "google/cloud/internal/future_then_impl.h"
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+/**
+ * The result of `when_any()`, as defined in ISO/IEC TS 19571:2016.
+ *
+ * @tparam Sequence either a `std::vector<future<T>>` or a
+ *     `std::tuple<future<T>...>`.
+ */
+template <typename Sequence>
+struct when_any_result {
+  /// The index of the first future to become satisfied.
+  std::size_t index;
+  /// The futures, `futures[index]` is satisfied, the rest may not be.
+  Sequence futures;
+};
+
+namespace internal {
+/// Determine if @p T is a `future<U>`.
+template <typename T>
+struct is_future : public std::false_type {};
+
+template <typename T>
+struct is_future<future<T>> : public std::true_type {};
+
+/// Invoke `functor(std::integral_constant<std::size_t, I>{}, std::get<I>(t))`
+/// for each element of a tuple.
+template <std::size_t I, std::size_t N>
+struct tuple_for_each {
+  template <typename Tuple, typename Functor>
+  static void apply(Tuple& t, Functor& functor) {
+    functor(std::integral_constant<std::size_t, I>{}, std::get<I>(t));
+    tuple_for_each<I + 1, N>::apply(t, functor);
+  }
+};
+
+template <std::size_t N>
+struct tuple_for_each<N, N> {
+  template <typename Tuple, typename Functor>
+  static void apply(Tuple&, Functor&) {}
+};
+
+template <typename Tuple, typename Functor>
+void for_each_element(Tuple& t, Functor&& functor) {
+  tuple_for_each<0, std::tuple_size<Tuple>::value>::apply(t, functor);
+}
+
+/// Raise `std::future_error` if the future is not valid.
+struct check_valid_futures {
+  template <typename I, typename U>
+  void operator()(I, future<U> const& f) const {
+    if (!f.valid()) {
+      ThrowFutureError(std::future_errc::no_state, "when_all/when_any");
+    }
+  }
+};
+
+/// Transfer the value (or exception) from a satisfied future to a promise.
+template <typename T>
+void forward_future(future<T> f, promise<T>& p) {
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  try {
+    p.set_value(f.get());
+  } catch (...) {
+    p.set_exception(std::current_exception());
+  }
+#else
+  p.set_value(f.get());
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+inline void forward_future(future<void> f, promise<void>& p) {
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  try {
+    f.get();
+    p.set_value();
+  } catch (...) {
+    p.set_exception(std::current_exception());
+  }
+#else
+  f.get();
+  p.set_value();
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+}
+
+/**
+ * The state shared by the continuations created in `when_all()`.
+ *
+ * Each continuation stores its (satisfied) future in a different element of
+ * `results`, the last one to decrement `pending` satisfies the promise.
+ */
+template <typename Sequence>
+struct when_all_state {
+  when_all_state(Sequence r, std::size_t count)
+      : results(std::move(r)), pending(count) {}
+
+  void mark_ready() {
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    result.set_value(std::move(results));
+  }
+
+  promise<Sequence> result;
+  Sequence results;
+  std::atomic<std::size_t> pending;
+};
+
+/// The continuation attached to each input future in `when_all()`.
+template <typename Sequence, typename T, typename Index>
+struct when_all_callback {
+  void operator()(future<T> f) {
+    store(std::move(f), Index{});
+    state->mark_ready();
+  }
+
+  void store(future<T> f, std::size_t) {
+    state->results[index] = std::move(f);
+  }
+
+  template <std::size_t I>
+  void store(future<T> f, std::integral_constant<std::size_t, I>) {
+    std::get<I>(state->results) = std::move(f);
+  }
+
+  std::shared_ptr<when_all_state<Sequence>> state;
+  std::size_t index;
+};
+
+/// Attach a `when_all_callback` to each element of a tuple of futures.
+template <typename Sequence>
+struct when_all_attach {
+  template <std::size_t I, typename U>
+  void operator()(std::integral_constant<std::size_t, I>, future<U>& f) {
+    using index_t = std::integral_constant<std::size_t, I>;
+    f.then(when_all_callback<Sequence, U, index_t>{state, I});
+  }
+
+  std::shared_ptr<when_all_state<Sequence>> state;
+};
+
+/**
+ * The state shared by the continuations created in `when_any()`.
+ *
+ * The futures returned to the application are created from `promises`, each
+ * continuation forwards the value from an input future to the corresponding
+ * promise. The first continuation to complete satisfies the `result` promise.
+ */
+template <typename Sequence, typename Promises>
+struct when_any_state {
+  void mark_ready(std::size_t index) {
+    if (done.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    result.set_value(when_any_result<Sequence>{index, std::move(futures)});
+  }
+
+  promise<when_any_result<Sequence>> result;
+  Promises promises;
+  Sequence futures;
+  std::atomic<bool> done{false};
+};
+
+/// The continuation attached to each input future in `when_any()`.
+template <typename Sequence, typename Promises, typename T, typename Index>
+struct when_any_callback {
+  void operator()(future<T> f) {
+    forward_future(std::move(f), target(Index{}));
+    state->mark_ready(index);
+  }
+
+  promise<T>& target(std::size_t) { return state->promises[index]; }
+
+  template <std::size_t I>
+  promise<T>& target(std::integral_constant<std::size_t, I>) {
+    return std::get<I>(state->promises);
+  }
+
+  std::shared_ptr<when_any_state<Sequence, Promises>> state;
+  std::size_t index;
+};
+
+/// Initialize the futures returned by `when_any()` from its promises.
+template <typename Sequence>
+struct when_any_get_futures {
+  template <std::size_t I, typename U>
+  void operator()(std::integral_constant<std::size_t, I>, promise<U>& p) {
+    std::get<I>(futures) = p.get_future();
+  }
+
+  Sequence& futures;
+};
+
+/// Attach a `when_any_callback` to each element of a tuple of futures.
+template <typename Sequence, typename Promises>
+struct when_any_attach {
+  template <std::size_t I, typename U>
+  void operator()(std::integral_constant<std::size_t, I>, future<U>& f) {
+    using index_t = std::integral_constant<std::size_t, I>;
+    f.then(when_any_callback<Sequence, Promises, U, index_t>{state, I});
+  }
+
+  std::shared_ptr<when_any_state<Sequence, Promises>> state;
+};
+
+/**
+ * The state for `for_each_async()`.
+ *
+ * Each call to `launch()` takes elements from the range until one of the
+ * futures returned by the functor is not satisfied. Then it attaches a
+ * continuation that calls `launch()` again. The application starts at most
+ * `max_concurrency` calls to `launch()`, so at most that many futures are
+ * pending at any time.
+ */
+template <typename ForwardIterator, typename Functor, typename Future>
+struct for_each_async_state {
+  using value_type = decltype(std::declval<Future>().get());
+  using sequence_type = std::vector<Future>;
+
+  for_each_async_state(ForwardIterator first, ForwardIterator last,
+                       std::size_t count, Functor f)
+      : next(first),
+        end(last),
+        next_index(0),
+        functor(std::move(f)),
+        done(sequence_type(count), count) {}
+
+  struct on_ready {
+    void operator()(Future f) {
+      self->done.results[index] = std::move(f);
+      self->done.mark_ready();
+      launch(std::move(self));
+    }
+
+    std::shared_ptr<for_each_async_state> self;
+    std::size_t index;
+  };
+
+  static void launch(std::shared_ptr<for_each_async_state> self) {
+    for (;;) {
+      std::unique_lock<std::mutex> lk(self->mu);
+      if (self->next == self->end) {
+        return;
+      }
+      auto it = self->next++;
+      auto index = self->next_index++;
+      lk.unlock();
+      auto f = self->invoke(it);
+      if (!f.valid() || f.is_ready()) {
+        // Avoid recursion (and a continuation) when the future is satisfied.
+        self->done.results[index] = std::move(f);
+        self->done.mark_ready();
+        continue;
+      }
+      f.then(on_ready{std::move(self), index});
+      return;
+    }
+  }
+
+  Future invoke(ForwardIterator it) {
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    try {
+      return functor(*it);
+    } catch (...) {
+      promise<value_type> p;
+      p.set_exception(std::current_exception());
+      return p.get_future();
+    }
+#else
+    return functor(*it);
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  }
+
+  std::mutex mu;
+  ForwardIterator next;
+  ForwardIterator end;
+  std::size_t next_index;
+  Functor functor;
+  when_all_state<sequence_type> done;
+};
+}  // namespace internal
+
+/**
+ * Create a future that becomes satisfied when all the futures in the range are
+ * satisfied.
+ *
+ * The futures in the range are moved into the result, they are all satisfied
+ * when the returned future is. If the range is empty the returned future is
+ * satisfied immediately.
+ *
+ * @throws std::future_error with `std::future_errc::no_state` if any of the
+ *     futures in the range is not valid.
+ */
+template <typename InputIterator,
+          typename std::enable_if<!internal::is_future<InputIterator>::value,
+                                  int>::type = 0>
+future<std::vector<typename std::iterator_traits<InputIterator>::value_type>>
+when_all(InputIterator first, InputIterator last) {
+  using future_t = typename std::iterator_traits<InputIterator>::value_type;
+  using value_t = decltype(std::declval<future_t>().get());
+  using sequence_t = std::vector<future_t>;
+  static_assert(internal::is_future<future_t>::value,
+                "when_all() requires a range of future<T>");
+
+  sequence_t inputs;
+  for (auto it = first; it != last; ++it) {
+    inputs.push_back(std::move(*it));
+  }
+  for (auto const& f : inputs) {
+    internal::check_valid_futures{}(0, f);
+  }
+  auto const count = inputs.size();
+  auto state = std::make_shared<internal::when_all_state<sequence_t>>(
+      sequence_t(count), count);
+  auto result = state->result.get_future();
+  if (count == 0) {
+    state->result.set_value(sequence_t{});
+    return result;
+  }
+  for (std::size_t i = 0; i != count; ++i) {
+    inputs[i].then(
+        internal::when_all_callback<sequence_t, value_t, std::size_t>{state,
+                                                                      i});
+  }
+  return result;
+}
+
+/**
+ * Create a future that becomes satisfied when all of @p futures are satisfied.
+ *
+ * @throws std::future_error with `std::future_errc::no_state` if any of the
+ *     input futures is not valid.
+ */
+template <typename... T>
+future<std::tuple<future<T>...>> when_all(future<T>... futures) {
+  using sequence_t = std::tuple<future<T>...>;
+  sequence_t inputs(std::move(futures)...);
+  internal::for_each_element(inputs, internal::check_valid_futures{});
+  auto state = std::make_shared<internal::when_all_state<sequence_t>>(
+      sequence_t{}, sizeof...(T));
+  auto result = state->result.get_future();
+  if (sizeof...(T) == 0) {
+    state->result.set_value(sequence_t{});
+    return result;
+  }
+  internal::for_each_element(inputs,
+                             internal::when_all_attach<sequence_t>{state});
+  return result;
+}
+
+/**
+ * Create a future that becomes satisfied when any of the futures in the range
+ * is satisfied.
+ *
+ * The result contains the index of the first future to become satisfied, and
+ * futures that become satisfied with the same values (or exceptions) as the
+ * input futures. If the range is empty the returned future is satisfied
+ * immediately, with an `index` equal to `static_cast<std::size_t>(-1)`.
+ *
+ * @throws std::future_error with `std::future_errc::no_state` if any of the
+ *     futures in the range is not valid.
+ */
+template <typename InputIterator,
+          typename std::enable_if<!internal::is_future<InputIterator>::value,
+                                  int>::type = 0>
+future<when_any_result<
+    std::vector<typename std::iterator_traits<InputIterator>::value_type>>>
+when_any(InputIterator first, InputIterator last) {
+  using future_t = typename std::iterator_traits<InputIterator>::value_type;
+  using value_t = decltype(std::declval<future_t>().get());
+  using sequence_t = std::vector<future_t>;
+  using promises_t = std::vector<promise<value_t>>;
+  using state_t = internal::when_any_state<sequence_t, promises_t>;
+  static_assert(internal::is_future<future_t>::value,
+                "when_any() requires a range of future<T>");
+
+  sequence_t inputs;
+  for (auto it = first; it != last; ++it) {
+    inputs.push_back(std::move(*it));
+  }
+  for (auto const& f : inputs) {
+    internal::check_valid_futures{}(0, f);
+  }
+  auto const count = inputs.size();
+  auto state = std::make_shared<state_t>();
+  auto result = state->result.get_future();
+  if (count == 0) {
+    state->result.set_value(when_any_result<sequence_t>{
+        static_cast<std::size_t>(-1), sequence_t{}});
+    return result;
+  }
+  // Create all the output futures before attaching any continuation, the
+  // continuations may run (and consume the output futures) immediately.
+  state->promises.resize(count);
+  state->futures.reserve(count);
+  for (auto& p : state->promises) {
+    state->futures.push_back(p.get_future());
+  }
+  for (std::size_t i = 0; i != count; ++i) {
+    inputs[i].then(internal::when_any_callback<sequence_t, promises_t, value_t,
+                                               std::size_t>{state, i});
+  }
+  return result;
+}
+
+/**
+ * Create a future that becomes satisfied when any of @p futures is satisfied.
+ *
+ * @throws std::future_error with `std::future_errc::no_state` if any of the
+ *     input futures is not valid.
+ */
+template <typename... T>
+future<when_any_result<std::tuple<future<T>...>>> when_any(
+    future<T>... futures) {
+  using sequence_t = std::tuple<future<T>...>;
+  using promises_t = std::tuple<promise<T>...>;
+  using state_t = internal::when_any_state<sequence_t, promises_t>;
+  sequence_t inputs(std::move(futures)...);
+  internal::for_each_element(inputs, internal::check_valid_futures{});
+  auto state = std::make_shared<state_t>();
+  auto result = state->result.get_future();
+  if (sizeof...(T) == 0) {
+    state->result.set_value(when_any_result<sequence_t>{
+        static_cast<std::size_t>(-1), sequence_t{}});
+    return result;
+  }
+  internal::for_each_element(
+      state->promises,
+      internal::when_any_get_futures<sequence_t>{state->futures});
+  internal::for_each_element(
+      inputs, internal::when_any_attach<sequence_t, promises_t>{state});
+  return result;
+}
+
+/**
+ * Call @p functor on each element of a range, with at most @p max_concurrency
+ * pending results at a time.
+ *
+ * This is useful to fan out asynchronous operations, such as
+ * `Table::AsyncApply()`, without overwhelming the service or the local
+ * completion queue. When one of the futures returned by @p functor is
+ * satisfied the next element in the range is processed, in the thread that
+ * satisfied the future.
+ *
+ * @param first the beginning of the range, the range must remain valid until
+ *     the returned future is satisfied.
+ * @param last the end of the range.
+ * @param max_concurrency the maximum number of pending futures, a value of 0
+ *     is treated as 1.
+ * @param functor called with each element of the range, it must return a
+ *     `future<R>`. It may be called from multiple threads, but never
+ *     concurrently with the same element.
+ *
+ * @return a future that becomes satisfied when all the futures returned by
+ *     @p functor are satisfied. It contains those (satisfied) futures, in the
+ *     same order as the range.
+ */
+template <typename ForwardIterator, typename Functor>
+future<std::vector<typename std::decay<decltype(
+    std::declval<Functor&>()(*std::declval<ForwardIterator>()))>::type>>
+for_each_async(ForwardIterator first, ForwardIterator last,
+               std::size_t max_concurrency, Functor&& functor) {
+  using future_t = typename std::decay<decltype(
+      std::declval<Functor&>()(*std::declval<ForwardIterator>()))>::type;
+  static_assert(internal::is_future<future_t>::value,
+                "for_each_async() requires a functor returning future<T>");
+  using state_t =
+      internal::for_each_async_state<ForwardIterator,
+                                     typename std::decay<Functor>::type,
+                                     future_t>;
+
+  auto const count = static_cast<std::size_t>(std::distance(first, last));
+  auto state = std::make_shared<state_t>(first, last, count,
+                                         std::forward<Functor>(functor));
+  auto result = state->done.result.get_future();
+  if (count == 0) {
+    state->done.result.set_value(std::vector<future_t>{});
+    return result;
+  }
+  if (max_concurrency == 0) {
+    max_concurrency = 1;
+  }
+  for (std::size_t i = 0; i != max_concurrency && i != count; ++i) {
+    state_t::launch(state);
+  }
+  return result;
+}
+
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_FUTURE_COMBINATORS_H_
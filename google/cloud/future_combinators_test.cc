@@ -0,0 +1,319 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/future.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/testing_util/chrono_literals.h"
+#include "google/cloud/testing_util/expect_future_error.h"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+using ::testing::ElementsAre;
+using namespace testing_util::chrono_literals;
+using testing_util::ExpectFutureError;
+
+TEST(FutureCombinatorsTest, WhenAllRange) {
+  std::vector<promise<int>> promises(3);
+  std::vector<future<int>> futures;
+  for (auto& p : promises) {
+    futures.push_back(p.get_future());
+  }
+
+  auto all = when_all(futures.begin(), futures.end());
+  for (auto const& f : futures) {
+    EXPECT_FALSE(f.valid());
+  }
+  EXPECT_EQ(std::future_status::timeout, all.wait_for(0_ms));
+
+  promises[2].set_value(2);
+  promises[0].set_value(0);
+  EXPECT_EQ(std::future_status::timeout, all.wait_for(0_ms));
+  promises[1].set_value(1);
+  EXPECT_EQ(std::future_status::ready, all.wait_for(0_ms));
+
+  auto results = all.get();
+  ASSERT_EQ(3U, results.size());
+  std::vector<int> values;
+  for (auto& f : results) {
+    EXPECT_TRUE(f.is_ready());
+    values.push_back(f.get());
+  }
+  EXPECT_THAT(values, ElementsAre(0, 1, 2));
+}
+
+TEST(FutureCombinatorsTest, WhenAllRangeEmpty) {
+  std::vector<future<int>> futures;
+  auto all = when_all(futures.begin(), futures.end());
+  EXPECT_TRUE(all.is_ready());
+  EXPECT_TRUE(all.get().empty());
+}
+
+TEST(FutureCombinatorsTest, WhenAllRangeReady) {
+  std::vector<future<void>> futures;
+  for (int i = 0; i != 3; ++i) {
+    promise<void> p;
+    futures.push_back(p.get_future());
+    p.set_value();
+  }
+  auto all = when_all(futures.begin(), futures.end());
+  EXPECT_TRUE(all.is_ready());
+  EXPECT_EQ(3U, all.get().size());
+}
+
+TEST(FutureCombinatorsTest, WhenAllRangeInvalid) {
+  std::vector<future<int>> futures(2);
+  ExpectFutureError([&] { when_all(futures.begin(), futures.end()); },
+                    std::future_errc::no_state);
+}
+
+TEST(FutureCombinatorsTest, WhenAllVariadic) {
+  promise<int> p0;
+  promise<std::string> p1;
+  promise<void> p2;
+
+  auto all = when_all(p0.get_future(), p1.get_future(), p2.get_future());
+  EXPECT_EQ(std::future_status::timeout, all.wait_for(0_ms));
+  p1.set_value("one");
+  p2.set_value();
+  EXPECT_EQ(std::future_status::timeout, all.wait_for(0_ms));
+  p0.set_value(0);
+  EXPECT_EQ(std::future_status::ready, all.wait_for(0_ms));
+
+  auto results = all.get();
+  EXPECT_EQ(0, std::get<0>(results).get());
+  EXPECT_EQ("one", std::get<1>(results).get());
+  std::get<2>(results).get();
+}
+
+TEST(FutureCombinatorsTest, WhenAllVariadicEmpty) {
+  auto all = when_all();
+  EXPECT_TRUE(all.is_ready());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST(FutureCombinatorsTest, WhenAllException) {
+  promise<int> p0;
+  promise<int> p1;
+  auto all = when_all(p0.get_future(), p1.get_future());
+  p0.set_exception(std::make_exception_ptr(std::runtime_error("test")));
+  p1.set_value(1);
+  auto results = all.get();
+  EXPECT_THROW(std::get<0>(results).get(), std::runtime_error);
+  EXPECT_EQ(1, std::get<1>(results).get());
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+TEST(FutureCombinatorsTest, WhenAnyRange) {
+  std::vector<promise<int>> promises(3);
+  std::vector<future<int>> futures;
+  for (auto& p : promises) {
+    futures.push_back(p.get_future());
+  }
+
+  auto any = when_any(futures.begin(), futures.end());
+  EXPECT_EQ(std::future_status::timeout, any.wait_for(0_ms));
+
+  promises[1].set_value(1);
+  EXPECT_EQ(std::future_status::ready, any.wait_for(0_ms));
+  auto result = any.get();
+  EXPECT_EQ(1U, result.index);
+  ASSERT_EQ(3U, result.futures.size());
+  EXPECT_TRUE(result.futures[1].is_ready());
+  EXPECT_FALSE(result.futures[0].is_ready());
+  EXPECT_FALSE(result.futures[2].is_ready());
+  EXPECT_EQ(1, result.futures[1].get());
+
+  // The remaining futures become satisfied with the original values.
+  promises[2].set_value(2);
+  promises[0].set_value(0);
+  EXPECT_EQ(0, result.futures[0].get());
+  EXPECT_EQ(2, result.futures[2].get());
+}
+
+TEST(FutureCombinatorsTest, WhenAnyRangeEmpty) {
+  std::vector<future<int>> futures;
+  auto any = when_any(futures.begin(), futures.end());
+  EXPECT_TRUE(any.is_ready());
+  auto result = any.get();
+  EXPECT_EQ(static_cast<std::size_t>(-1), result.index);
+  EXPECT_TRUE(result.futures.empty());
+}
+
+TEST(FutureCombinatorsTest, WhenAnyRangeReady) {
+  std::vector<promise<void>> promises(3);
+  std::vector<future<void>> futures;
+  for (auto& p : promises) {
+    futures.push_back(p.get_future());
+  }
+  promises[2].set_value();
+
+  auto any = when_any(futures.begin(), futures.end());
+  EXPECT_TRUE(any.is_ready());
+  auto result = any.get();
+  EXPECT_EQ(2U, result.index);
+  EXPECT_TRUE(result.futures[2].is_ready());
+}
+
+TEST(FutureCombinatorsTest, WhenAnyVariadic) {
+  promise<int> p0;
+  promise<std::string> p1;
+
+  auto any = when_any(p0.get_future(), p1.get_future());
+  EXPECT_EQ(std::future_status::timeout, any.wait_for(0_ms));
+  p1.set_value("one");
+  EXPECT_EQ(std::future_status::ready, any.wait_for(0_ms));
+
+  auto result = any.get();
+  EXPECT_EQ(1U, result.index);
+  EXPECT_EQ("one", std::get<1>(result.futures).get());
+  p0.set_value(0);
+  EXPECT_EQ(0, std::get<0>(result.futures).get());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST(FutureCombinatorsTest, WhenAnyException) {
+  promise<int> p0;
+  promise<int> p1;
+  auto any = when_any(p0.get_future(), p1.get_future());
+  p0.set_exception(std::make_exception_ptr(std::runtime_error("test")));
+  auto result = any.get();
+  EXPECT_EQ(0U, result.index);
+  EXPECT_THROW(std::get<0>(result.futures).get(), std::runtime_error);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+/// @test Verify that when_all() and when_any() work with multiple producers.
+TEST(FutureCombinatorsTest, ThreadedProducers) {
+  int const thread_count = 8;
+  for (int iteration = 0; iteration != 100; ++iteration) {
+    std::vector<promise<int>> promises(thread_count);
+    std::vector<future<int>> all_inputs;
+    std::vector<future<int>> any_inputs;
+    std::vector<promise<int>> any_promises(thread_count);
+    for (int i = 0; i != thread_count; ++i) {
+      all_inputs.push_back(promises[i].get_future());
+      any_inputs.push_back(any_promises[i].get_future());
+    }
+    auto all = when_all(all_inputs.begin(), all_inputs.end());
+    auto any = when_any(any_inputs.begin(), any_inputs.end());
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i != thread_count; ++i) {
+      threads.emplace_back([&promises, &any_promises, i] {
+        any_promises[i].set_value(i);
+        promises[i].set_value(i);
+      });
+    }
+    auto results = all.get();
+    auto any_result = any.get();
+    for (auto& t : threads) {
+      t.join();
+    }
+    int sum = 0;
+    for (auto& f : results) {
+      sum += f.get();
+    }
+    EXPECT_EQ(thread_count * (thread_count - 1) / 2, sum);
+    ASSERT_LT(any_result.index, any_result.futures.size());
+    EXPECT_EQ(static_cast<int>(any_result.index),
+              any_result.futures[any_result.index].get());
+  }
+}
+
+TEST(FutureCombinatorsTest, ForEachAsyncBounded) {
+  std::vector<int> inputs{0, 1, 2, 3, 4, 5, 6};
+  std::deque<promise<int>> pending;
+  std::size_t max_pending = 0;
+
+  auto done = for_each_async(inputs.begin(), inputs.end(), 3,
+                             [&pending, &max_pending](int) {
+                               pending.emplace_back();
+                               max_pending =
+                                   (std::max)(max_pending, pending.size());
+                               return pending.back().get_future();
+                             });
+  EXPECT_EQ(3U, pending.size());
+
+  int value = 0;
+  while (!pending.empty()) {
+    auto p = std::move(pending.front());
+    pending.pop_front();
+    p.set_value(value++);
+  }
+  EXPECT_EQ(3U, max_pending);
+  EXPECT_EQ(std::future_status::ready, done.wait_for(0_ms));
+
+  auto results = done.get();
+  std::vector<int> values;
+  for (auto& f : results) {
+    values.push_back(f.get());
+  }
+  EXPECT_THAT(values, ElementsAre(0, 1, 2, 3, 4, 5, 6));
+}
+
+TEST(FutureCombinatorsTest, ForEachAsyncReady) {
+  std::vector<int> inputs(1000);
+  int calls = 0;
+  auto done = for_each_async(inputs.begin(), inputs.end(), 1, [&calls](int) {
+    ++calls;
+    promise<void> p;
+    p.set_value();
+    return p.get_future();
+  });
+  EXPECT_TRUE(done.is_ready());
+  EXPECT_EQ(1000, calls);
+  EXPECT_EQ(1000U, done.get().size());
+}
+
+TEST(FutureCombinatorsTest, ForEachAsyncEmpty) {
+  std::vector<int> inputs;
+  auto done = for_each_async(inputs.begin(), inputs.end(), 4, [](int) {
+    promise<int> p;
+    return p.get_future();
+  });
+  EXPECT_TRUE(done.is_ready());
+  EXPECT_TRUE(done.get().empty());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST(FutureCombinatorsTest, ForEachAsyncFunctorThrows) {
+  std::vector<int> inputs{0, 1, 2};
+  auto done = for_each_async(inputs.begin(), inputs.end(), 2, [](int i) {
+    if (i == 1) {
+      google::cloud::internal::ThrowRuntimeError("test");
+    }
+    promise<int> p;
+    p.set_value(i);
+    return p.get_future();
+  });
+  auto results = done.get();
+  ASSERT_EQ(3U, results.size());
+  EXPECT_EQ(0, results[0].get());
+  EXPECT_THROW(results[1].get(), std::runtime_error);
+  EXPECT_EQ(2, results[2].get());
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
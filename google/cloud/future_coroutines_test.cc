@@ -0,0 +1,154 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/future.h"
+#include "google/cloud/internal/throw_delegate.h"
+#include "google/cloud/testing_util/expect_future_error.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <thread>
+
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace {
+using ::testing::HasSubstr;
+using testing_util::ExpectFutureError;
+
+future<int> AddOne(future<int> f) { co_return co_await std::move(f) + 1; }
+
+future<void> Await(future<void> f, bool& resumed) {
+  co_await std::move(f);
+  resumed = true;
+}
+
+future<int> Throw() {
+  internal::ThrowRuntimeError("test message");
+  co_return 0;
+}
+
+future<std::thread::id> ResumedOn(future<void> f) {
+  co_await std::move(f);
+  co_return std::this_thread::get_id();
+}
+
+/// @test Verify that a coroutine resumes when the future is satisfied.
+TEST(FutureCoroutinesTest, AwaitValue) {
+  promise<int> p;
+  auto f = AddOne(p.get_future());
+  EXPECT_TRUE(f.valid());
+  EXPECT_FALSE(f.is_ready());
+
+  p.set_value(41);
+  EXPECT_TRUE(f.is_ready());
+  EXPECT_EQ(42, f.get());
+}
+
+/// @test Verify that awaiting a satisfied future does not suspend.
+TEST(FutureCoroutinesTest, AwaitReady) {
+  promise<int> p;
+  p.set_value(41);
+  auto f = AddOne(p.get_future());
+  EXPECT_TRUE(f.is_ready());
+  EXPECT_EQ(42, f.get());
+}
+
+/// @test Verify that coroutines can be chained.
+TEST(FutureCoroutinesTest, Chain) {
+  promise<int> p;
+  auto f = p.get_future();
+  for (int i = 0; i != 10; ++i) {
+    f = AddOne(std::move(f));
+  }
+  p.set_value(0);
+  EXPECT_EQ(10, f.get());
+}
+
+/// @test Verify that co_await works with future<void>.
+TEST(FutureCoroutinesTest, AwaitVoid) {
+  promise<void> p;
+  bool resumed = false;
+  auto f = Await(p.get_future(), resumed);
+  EXPECT_FALSE(resumed);
+  EXPECT_FALSE(f.is_ready());
+
+  p.set_value();
+  EXPECT_TRUE(resumed);
+  f.get();
+  SUCCEED();
+}
+
+/// @test Verify that co_await invalidates the future, like get().
+TEST(FutureCoroutinesTest, AwaitInvalidates) {
+  promise<void> p;
+  bool resumed = false;
+  auto source = p.get_future();
+  auto f = [&source](bool& r) -> future<void> {
+    co_await source;
+    r = true;
+  }(resumed);
+  EXPECT_FALSE(source.valid());
+  p.set_value();
+  f.get();
+  EXPECT_TRUE(resumed);
+}
+
+/// @test Verify that the coroutine resumes in the thread satisfying the future.
+TEST(FutureCoroutinesTest, ResumesInProducerThread) {
+  promise<void> p;
+  auto f = ResumedOn(p.get_future());
+  std::thread::id producer;
+  std::thread t([&p, &producer] {
+    producer = std::this_thread::get_id();
+    p.set_value();
+  });
+  t.join();
+  EXPECT_EQ(producer, f.get());
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+/// @test Verify that exceptions in the awaited future are propagated.
+TEST(FutureCoroutinesTest, AwaitException) {
+  promise<int> p;
+  auto f = AddOne(p.get_future());
+  p.set_exception(std::make_exception_ptr(std::runtime_error("test message")));
+  EXPECT_TRUE(f.is_ready());
+  try {
+    f.get();
+    FAIL() << "expected an exception";
+  } catch (std::runtime_error const& ex) {
+    EXPECT_THAT(ex.what(), HasSubstr("test message"));
+  }
+}
+
+/// @test Verify that exceptions raised in the coroutine are stored.
+TEST(FutureCoroutinesTest, CoroutineThrows) {
+  auto f = Throw();
+  EXPECT_TRUE(f.is_ready());
+  EXPECT_THROW(f.get(), std::runtime_error);
+}
+
+/// @test Verify that awaiting an invalid future raises.
+TEST(FutureCoroutinesTest, AwaitInvalid) {
+  auto f = AddOne(future<int>());
+  ExpectFutureError([&] { f.get(); }, std::future_errc::no_state);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+}  // namespace
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
@@ -123,6 +123,8 @@ class future final : private internal::future_base<T> {
   template <typename U>
   friend class future;
   friend class future<void>;
+  template <typename U>
+  friend class internal::future_awaiter;
 };
 
 /**
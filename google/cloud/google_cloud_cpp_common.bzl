@@ -18,6 +18,7 @@
 
 google_cloud_cpp_common_hdrs = [
     "future.h",
+    "future_combinators.h",
     "future_generic.h",
     "future_void.h",
     "iam_binding.h",
@@ -29,17 +30,20 @@ google_cloud_cpp_common_hdrs = [
     "internal/disjunction.h",
     "internal/filesystem.h",
     "internal/future_base.h",
+    "internal/future_coroutines.h",
     "internal/future_fwd.h",
     "internal/future_impl.h",
     "internal/future_then_impl.h",
     "internal/future_then_meta.h",
     "internal/getenv.h",
+    "internal/hedging_policy.h",
     "internal/ios_flags_saver.h",
     "internal/make_unique.h",
     "internal/port_platform.h",
     "internal/random.h",
     "internal/invoke_result.h",
     "internal/retry_policy.h",
+    "internal/ring_buffer.h",
     "internal/setenv.h",
     "internal/throw_delegate.h",
     "log.h",
@@ -57,6 +61,7 @@ google_cloud_cpp_common_srcs = [
     "internal/filesystem.cc",
     "internal/future_impl.cc",
     "internal/getenv.cc",
+    "internal/hedging_policy.cc",
     "internal/random.cc",
     "internal/setenv.cc",
     "internal/throw_delegate.cc",
@@ -17,6 +17,8 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 google_cloud_cpp_common_unit_tests = [
+    "future_combinators_test.cc",
+    "future_coroutines_test.cc",
     "future_generic_test.cc",
     "future_generic_then_test.cc",
     "future_void_test.cc",
@@ -26,9 +28,11 @@ google_cloud_cpp_common_unit_tests = [
     "internal/big_endian_test.cc",
     "internal/filesystem_test.cc",
     "internal/future_impl_test.cc",
+    "internal/hedging_policy_test.cc",
     "internal/invoke_result_test.cc",
     "internal/random_test.cc",
     "internal/retry_policy_test.cc",
+    "internal/ring_buffer_test.cc",
     "internal/throw_delegate_test.cc",
     "log_test.cc",
     "optional_test.cc",
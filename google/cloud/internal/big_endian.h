@@ -16,6 +16,8 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_BIG_ENDIAN_H_
 
 #include "google/cloud/version.h"
+#include <cstddef>
+#include <cstdint>
 #ifdef _MSC_VER
 #include <stdlib.h>
 #elif defined(__APPLE__)
@@ -175,6 +177,20 @@ constexpr IntegralType FromBigEndian(IntegralType big_endian) {
   return EndianTransform<IsBigEndian()>::as_native(big_endian);
 }
 
+/**
+ * Convert @p count values from big-endian to native order, in place.
+ *
+ * The iterations are independent and have no branches, optimizing compilers
+ * vectorize this loop on targets with byte shuffle instructions, for example
+ * SSSE3 or AVX2 on x86-64.
+ */
+template <typename IntegralType>
+void FromBigEndianArray(IntegralType* values, std::size_t count) {
+  for (std::size_t i = 0; i != count; ++i) {
+    values[i] = FromBigEndian(values[i]);
+  }
+}
+
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
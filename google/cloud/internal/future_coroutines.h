@@ -0,0 +1,148 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FUTURE_COROUTINES_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FUTURE_COROUTINES_H_
+/**
+ * @file
+ *
+ * Support C++20 coroutines with `google::cloud::future<T>`.
+ *
+ * When the compiler supports coroutines, `future<T>` can be used with
+ * `co_await`, and coroutines can return `future<T>`:
+ *
+ * @code
+ * future<int> ApplyAll(bigtable::Table& table, bigtable::CompletionQueue& cq,
+ *                      std::vector<bigtable::SingleRowMutation> mutations) {
+ *   int count = 0;
+ *   for (auto& m : mutations) {
+ *     co_await table.AsyncApply(std::move(m), cq);
+ *     ++count;
+ *   }
+ *   co_return count;
+ * }
+ * @endcode
+ *
+ * The coroutine is resumed by the thread that satisfies the future, for the
+ * asynchronous RPCs that is the thread running the completion queue. Suspending
+ * does not allocate memory: the resumption handle is stored in the buffer for
+ * continuations in the future shared state.
+ *
+ * The application should not block in a coroutine resumed this way, just as it
+ * should not block in a callback passed to `future<T>::then()`.
+ */
+
+#include "google/cloud/future_generic.h"
+#include "google/cloud/future_void.h"
+#include "google/cloud/internal/future_impl.h"
+
+#if GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+#include <coroutine>
+#include <exception>
+#include <memory>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/**
+ * Implement `co_await` for `future<T>`.
+ *
+ * Like `future<T>::get()`, this invalidates the future. The awaiter holds the
+ * shared state until the coroutine resumes and retrieves the value.
+ */
+template <typename T>
+class future_awaiter {
+ public:
+  explicit future_awaiter(future<T>&& f) {
+    f.check_valid();
+    state_.swap(f.shared_state_);
+  }
+
+  bool await_ready() const { return state_->is_ready(); }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    // If the future is satisfied before the continuation is published, the
+    // coroutine resumes (and may finish, destroying this object) before this
+    // function returns. Keep the shared state alive until then.
+    auto state = state_;
+    state->template emplace_and_publish_continuation<resume_continuation>(
+        handle);
+  }
+
+  T await_resume() { return state_->get(); }
+
+ private:
+  struct resume_continuation : public continuation_base {
+    explicit resume_continuation(std::coroutine_handle<> h) : handle(h) {}
+    void execute() override { handle.resume(); }
+    std::coroutine_handle<> handle;
+  };
+
+  std::shared_ptr<future_shared_state<T>> state_;
+};
+
+/// The promise type for coroutines returning `future<T>`.
+template <typename T>
+struct future_promise_type_base {
+  promise<T> result;
+
+  future<T> get_return_object() { return result.get_future(); }
+  std::suspend_never initial_suspend() noexcept { return {}; }
+  std::suspend_never final_suspend() noexcept { return {}; }
+  void unhandled_exception() { result.set_exception(std::current_exception()); }
+};
+
+template <typename T>
+struct future_promise_type : public future_promise_type_base<T> {
+  void return_value(T value) { this->result.set_value(std::move(value)); }
+};
+
+template <>
+struct future_promise_type<void> : public future_promise_type_base<void> {
+  void return_void() { this->result.set_value(); }
+};
+}  // namespace internal
+
+/**
+ * Suspend the calling coroutine until @p f is satisfied.
+ *
+ * @return the value stored in the future.
+ * @throws any exceptions stored in the shared state.
+ * @throws std::future_error with std::no_state if the future does not have
+ *   a shared state.
+ */
+template <typename T>
+internal::future_awaiter<T> operator co_await(future<T>&& f) {
+  return internal::future_awaiter<T>(std::move(f));
+}
+
+/// @copydoc operator co_await(future<T>&&)
+template <typename T>
+internal::future_awaiter<T> operator co_await(future<T>& f) {
+  return internal::future_awaiter<T>(std::move(f));
+}
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+/// Allow coroutines to return `google::cloud::future<T>`.
+template <typename T, typename... Args>
+struct std::coroutine_traits<google::cloud::future<T>, Args...> {
+  using promise_type = google::cloud::internal::future_promise_type<T>;
+};
+
+#endif  // GOOGLE_CLOUD_CPP_HAVE_COROUTINES
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_FUTURE_COROUTINES_H_
@@ -39,6 +39,12 @@ template <>
 class promise<void>;
 template <>
 class future<void>;
+
+namespace internal {
+// Forward declare the type used to `co_await` a future.
+template <typename R>
+class future_awaiter;
+}  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
 }  // namespace google
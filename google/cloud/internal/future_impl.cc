@@ -34,6 +34,13 @@ namespace internal {
   google::cloud::Terminate(full_msg.c_str());
 #endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
 }
+
+// Before C++17 static constexpr data members need a definition if odr-used.
+std::size_t constexpr future_shared_state_base::kContinuationBufferSize;
+std::uint32_t constexpr future_shared_state_base::kClaimed;
+std::uint32_t constexpr future_shared_state_base::kReady;
+std::uint32_t constexpr future_shared_state_base::kHasContinuation;
+std::uint32_t constexpr future_shared_state_base::kWaiting;
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
 }  // namespace cloud
@@ -23,10 +23,13 @@
 #include "google/cloud/internal/future_then_meta.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/terminate_handler.h"
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <exception>
 #include <future>
 #include <mutex>
+#include <type_traits>
 
 namespace google {
 namespace cloud {
@@ -53,6 +56,18 @@ class continuation_base {
   virtual void execute() = 0;
 };
 
+/**
+ * The synchronization primitives used to block in `future<T>::get()`.
+ *
+ * Most shared states are satisfied before (or without) any thread blocking on
+ * them, for example, because the value is consumed by a continuation. The
+ * shared state only creates these objects when some thread needs to block.
+ */
+struct future_waiter {
+  std::mutex mu;
+  std::condition_variable cv;
+};
+
 /**
  * Common base class for all shared state classes.
  *
@@ -60,6 +75,25 @@ class continuation_base {
  * future<void> share a lot of code. This class refactors that code, it
  * represents a shared state of unknown type.
  *
+ * The shared state is a small state machine, stored in a single atomic
+ * variable. In the common case there is a single producer (the promise) and a
+ * single consumer (the future, or its continuation), and the state transitions
+ * require no locks:
+ *
+ * - The producer claims the state (`kClaimed`), stores the value or exception,
+ *   and then publishes it (`kReady`).
+ * - The consumer stores the continuation and then publishes it
+ *   (`kHasContinuation`).
+ * - Whichever of the two publishes last observes the other flag, and calls the
+ *   continuation. The continuation is called exactly once, without any locks
+ *   held.
+ * - Only threads that block in `wait()`, `wait_for()`, `wait_until()` or
+ *   `get()` create a `future_waiter` and set `kWaiting`. The producer only
+ *   locks the mutex and notifies the condition variable if this flag is set.
+ *
+ * Continuations are typically small, they are stored in a buffer inside the
+ * shared state to avoid a separate allocation for each `.then()` call.
+ *
  * @note While most of the invariants for promises and futures are implemented
  *   by this class, not all of them are. Notably, future values can only be
  *   retrieved once, but this is enforced because calling .get() or .then() on a
@@ -68,18 +102,35 @@ class continuation_base {
  */
 class future_shared_state_base {
  public:
-  future_shared_state_base() : mu_(), cv_(), current_state_(state::not_ready) {}
+  future_shared_state_base()
+      : flags_(0),
+        waiter_(nullptr),
+        current_state_(state::not_ready),
+        continuation_(nullptr),
+        continuation_is_inline_(false) {}
+
+  ~future_shared_state_base() {
+    destroy_continuation();
+    delete waiter_.load(std::memory_order_acquire);
+  }
+
+  future_shared_state_base(future_shared_state_base const&) = delete;
+  future_shared_state_base& operator=(future_shared_state_base const&) =
+      delete;
 
   /// Return true if the shared state has a value or an exception.
   bool is_ready() const {
-    std::unique_lock<std::mutex> lk(mu_);
-    return is_ready_unlocked();
+    return (flags_.load(std::memory_order_acquire) & kReady) != 0;
   }
 
   /// Block until is_ready() returns true ...
   void wait() {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this] { return is_ready_unlocked(); });
+    if (is_ready()) {
+      return;
+    }
+    auto& w = waiter();
+    std::unique_lock<std::mutex> lk(w.mu);
+    w.cv.wait(lk, [this] { return is_ready(); });
   }
 
   /**
@@ -106,16 +157,16 @@ class future_shared_state_base {
    */
   template <typename Rep, typename Period>
   std::future_status wait_for(std::chrono::duration<Rep, Period> duration) {
-    std::unique_lock<std::mutex> lk(mu_);
-    bool result =
-        cv_.wait_for(lk, duration, [this] { return is_ready_unlocked(); });
-    if (result) {
+    if (is_ready()) {
       return std::future_status::ready;
     }
-    if (continuation_) {
-      return std::future_status::deferred;
+    auto& w = waiter();
+    std::unique_lock<std::mutex> lk(w.mu);
+    bool result = w.cv.wait_for(lk, duration, [this] { return is_ready(); });
+    if (result) {
+      return std::future_status::ready;
     }
-    return std::future_status::timeout;
+    return not_ready_status();
   }
 
   /**
@@ -136,26 +187,23 @@ class future_shared_state_base {
    */
   template <typename Clock>
   std::future_status wait_until(std::chrono::time_point<Clock> deadline) {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (!lk.owns_lock()) {
-      return std::future_status::timeout;
+    if (is_ready()) {
+      return std::future_status::ready;
     }
-    bool result =
-        cv_.wait_until(lk, deadline, [this] { return is_ready_unlocked(); });
+    auto& w = waiter();
+    std::unique_lock<std::mutex> lk(w.mu);
+    bool result = w.cv.wait_until(lk, deadline, [this] { return is_ready(); });
     if (result) {
       return std::future_status::ready;
     }
-    if (continuation_) {
-      return std::future_status::deferred;
-    }
-    return std::future_status::timeout;
+    return not_ready_status();
   }
 
   /// Set the shared state to hold an exception and notify immediately.
   void set_exception(std::exception_ptr ex) {
-    std::unique_lock<std::mutex> lk(mu_);
-    set_exception(std::move(ex), lk);
-    notify_now(std::move(lk));
+    claim(__func__);
+    exception_ = std::move(ex);
+    publish(state::has_exception, true);
   }
 
   /**
@@ -167,60 +215,121 @@ class future_shared_state_base {
    * `std::future_errc::broken_promise`.
    */
   void abandon() {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (is_ready_unlocked()) {
+    if ((flags_.fetch_or(kClaimed, std::memory_order_acq_rel) & kClaimed) !=
+        0) {
       return;
     }
-    set_exception(std::make_exception_ptr(
-                      std::future_error(std::future_errc::broken_promise)),
-                  lk);
-    cv_.notify_all();
+    exception_ = std::make_exception_ptr(
+        std::future_error(std::future_errc::broken_promise));
+    // Abandoning the state only wakes up blocked threads, the continuation (if
+    // any) is not called.
+    publish(state::has_exception, false);
   }
 
   void set_continuation(std::unique_ptr<continuation_base> c) {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (continuation_) {
-      ThrowFutureError(std::future_errc::future_already_retrieved, __func__);
-    }
-    // If the future is already satisfied, invoke the continuation immediately.
-    if (is_ready_unlocked()) {
-      // Release the lock before calling the user's code, holding locks during
-      // callbacks is a bad practice.
-      lk.unlock();
-      c->execute();
-      return;
-    }
-    continuation_ = std::move(c);
+    check_no_continuation();
+    continuation_ = c.release();
+    continuation_is_inline_ = false;
+    publish_continuation();
+  }
+
+  /**
+   * Construct a continuation in place, then publish it.
+   *
+   * Like `set_continuation()`, but small continuations are stored in the
+   * shared state buffer, so no memory is allocated. The continuation may run
+   * before this function returns, if the shared state is already satisfied.
+   */
+  template <typename Continuation, typename... Args>
+  void emplace_and_publish_continuation(Args&&... args) {
+    emplace_continuation<Continuation>(std::forward<Args>(args)...);
+    publish_continuation();
   }
 
  protected:
-  bool is_ready_unlocked() const { return current_state_ != state::not_ready; }
+  enum class state {
+    not_ready,
+    has_exception,
+    has_value,
+  };
 
-  /// Satisfy the shared state using an exception.
-  void set_exception(std::exception_ptr ex, std::unique_lock<std::mutex>& lk) {
-    if (is_ready_unlocked()) {
-      ThrowFutureError(std::future_errc::promise_already_satisfied, __func__);
+  /// The size of the buffer used to store continuations without allocations.
+  static std::size_t constexpr kContinuationBufferSize = 96;
+
+  /**
+   * Create the continuation for this shared state, but do not publish it.
+   *
+   * Small continuations are constructed in a buffer inside the shared state,
+   * larger continuations are allocated from the heap. The caller must call
+   * `publish_continuation()` once it has finished using the returned object,
+   * after that point the continuation may run (and be destroyed) at any time.
+   */
+  template <typename Continuation, typename... Args>
+  Continuation* emplace_continuation(Args&&... args) {
+    check_no_continuation();
+    using fits = std::integral_constant<
+        bool, sizeof(Continuation) <= kContinuationBufferSize &&
+                  alignof(Continuation) <= alignof(continuation_buffer_t)>;
+    auto* c = construct_continuation<Continuation>(
+        fits{}, std::forward<Args>(args)...);
+    continuation_ = c;
+    continuation_is_inline_ = fits::value;
+    return c;
+  }
+
+  /// Publish the continuation, call it if the shared state is satisfied.
+  void publish_continuation() {
+    auto const old =
+        flags_.fetch_or(kHasContinuation, std::memory_order_acq_rel);
+    if ((old & kReady) == 0) {
+      // The producer will call the continuation.
+      return;
     }
-    exception_ = std::move(ex);
-    current_state_ = state::has_exception;
+    // If the future is already satisfied, invoke the continuation immediately.
+    continuation_->execute();
+    destroy_continuation();
   }
 
-  /// If needed, notify any waiting threads that the shared state is satisfied.
-  void notify_now(std::unique_lock<std::mutex>&& lk) {
-    if (continuation_) {
-      // Release the lock before calling the continuation because the
-      // continuation will likely call get() to fetch the state of the future.
-      lk.unlock();
-      continuation_->execute();
+  /// Claim the right to satisfy the shared state.
+  void claim(char const* func) {
+    if ((flags_.fetch_or(kClaimed, std::memory_order_acq_rel) & kClaimed) !=
+        0) {
+      ThrowFutureError(std::future_errc::promise_already_satisfied, func);
+    }
+  }
+
+  /// Release the claim, used if storing the value fails.
+  void release_claim() {
+    flags_.fetch_and(~kClaimed, std::memory_order_acq_rel);
+  }
+
+  /**
+   * Mark the state as satisfied and notify the continuation or any waiters.
+   *
+   * The caller must have successfully called `claim()` and stored the value
+   * or exception.
+   */
+  void publish(state s, bool call_continuation) {
+    current_state_ = s;
+    auto const old = flags_.fetch_or(kReady, std::memory_order_acq_rel);
+    if ((old & kHasContinuation) != 0 && call_continuation) {
       // If there is a continuation there can be no threads blocked on get() or
       // wait() because then() invalidates the future. Therefore we can return
       // without notifying any other threads.
+      continuation_->execute();
+      destroy_continuation();
+      return;
+    }
+    if ((old & kWaiting) == 0) {
       return;
     }
-    // Unlock first to avoid waking up a thread which becomes immediately
-    // blocked on the mutex.
-    lk.unlock();
-    cv_.notify_all();
+    auto* w = waiter_.load(std::memory_order_acquire);
+    // Acquire the lock to synchronize with any thread that checked `is_ready()`
+    // but is not yet blocked on the condition variable. Release it before
+    // notifying to avoid waking up a thread which becomes immediately blocked
+    // on the mutex.
+    { std::lock_guard<std::mutex> lk(w->mu); }
+    w->cv.notify_all();
   }
 
   /**
@@ -260,16 +369,79 @@ class future_shared_state_base {
   /// Keep track of whether `get_future()` has been called.
   std::atomic_flag retrieved_ = ATOMIC_FLAG_INIT;
 
-  mutable std::mutex mu_;
-  std::condition_variable cv_;
-  enum class state {
-    not_ready,
-    has_exception,
-    has_value,
-  };
+  /// A producer has claimed the shared state, it may not be ready yet.
+  static std::uint32_t constexpr kClaimed = 1U << 0U;
+  /// The value or exception is stored, and `current_state_` is valid.
+  static std::uint32_t constexpr kReady = 1U << 1U;
+  /// The continuation is stored.
+  static std::uint32_t constexpr kHasContinuation = 1U << 2U;
+  /// At least one thread may be blocked on `waiter_->cv`.
+  static std::uint32_t constexpr kWaiting = 1U << 3U;
+  std::atomic<std::uint32_t> flags_;
+  std::atomic<future_waiter*> waiter_;
+
+  /// Only valid after `kReady` is observed.
   state current_state_;
   std::exception_ptr exception_;
 
+ private:
+  using continuation_buffer_t =
+      std::aligned_storage<kContinuationBufferSize>::type;
+
+  template <typename Continuation, typename... Args>
+  Continuation* construct_continuation(std::true_type, Args&&... args) {
+    return new (&continuation_buffer_)
+        Continuation(std::forward<Args>(args)...);
+  }
+
+  template <typename Continuation, typename... Args>
+  Continuation* construct_continuation(std::false_type, Args&&... args) {
+    return new Continuation(std::forward<Args>(args)...);
+  }
+
+  void check_no_continuation() const {
+    if ((flags_.load(std::memory_order_acquire) & kHasContinuation) != 0 ||
+        continuation_ != nullptr) {
+      ThrowFutureError(std::future_errc::future_already_retrieved,
+                       "set_continuation");
+    }
+  }
+
+  void destroy_continuation() {
+    if (continuation_ == nullptr) {
+      return;
+    }
+    if (continuation_is_inline_) {
+      continuation_->~continuation_base();
+    } else {
+      delete continuation_;
+    }
+    continuation_ = nullptr;
+  }
+
+  std::future_status not_ready_status() const {
+    if ((flags_.load(std::memory_order_acquire) & kHasContinuation) != 0) {
+      return std::future_status::deferred;
+    }
+    return std::future_status::timeout;
+  }
+
+  /// Return the waiter, creating it if needed, and set `kWaiting`.
+  future_waiter& waiter() {
+    auto* w = waiter_.load(std::memory_order_acquire);
+    if (w == nullptr) {
+      auto* created = new future_waiter;
+      if (waiter_.compare_exchange_strong(w, created,
+                                          std::memory_order_acq_rel)) {
+        w = created;
+      } else {
+        delete created;
+      }
+    }
+    flags_.fetch_or(kWaiting, std::memory_order_acq_rel);
+    return *w;
+  }
+
   /**
    * The continuation, if any, associated with this shared state.
    *
@@ -277,7 +449,9 @@ class future_shared_state_base {
    * exception. Setting a continuation does not change the `current_state_`
    * member variable and does not satisfy the shared state.
    */
-  std::unique_ptr<continuation_base> continuation_;
+  continuation_base* continuation_;
+  bool continuation_is_inline_;
+  continuation_buffer_t continuation_buffer_;
 };
 
 /**
@@ -317,6 +491,7 @@ class future_shared_state final : private future_shared_state_base {
   }
 
   using future_shared_state_base::abandon;
+  using future_shared_state_base::emplace_and_publish_continuation;
   using future_shared_state_base::is_ready;
   using future_shared_state_base::set_continuation;
   using future_shared_state_base::set_exception;
@@ -326,8 +501,7 @@ class future_shared_state final : private future_shared_state_base {
 
   /// The implementation details for `future<T>::get()`
   T get() {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this] { return is_ready_unlocked(); });
+    wait();
     if (current_state_ == state::has_exception) {
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
       std::rethrow_exception(exception_);
@@ -353,21 +527,23 @@ class future_shared_state final : private future_shared_state_base {
    *     error code is `std::future_errc::promise_already_satisfied`.
    */
   void set_value(T&& value) {
-    std::unique_lock<std::mutex> lk(mu_);
-    if (is_ready_unlocked()) {
-      ThrowFutureError(std::future_errc::promise_already_satisfied, __func__);
-    }
+    claim(__func__);
     // We can only reach this point once, all other states are terminal.
     // Therefore we know that `buffer_` has not been initialized and calling
     // placement new via the move constructor is the best way to initialize the
-    // buffer.
-
-    // TODO(#1405) - this is calling application code while holding a lock.
-    // That could result in a deadlock (or at least unbounded priority
-    // inversions) if the move constructor for `T` takes a long time to execute.
+    // buffer. No locks are held, so calling application code is safe.
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    try {
+      new (reinterpret_cast<T*>(&buffer_)) T(std::move(value));
+    } catch (...) {
+      // Allow the promise to store an exception, or to abandon the state.
+      release_claim();
+      throw;
+    }
+#else
     new (reinterpret_cast<T*>(&buffer_)) T(std::move(value));
-    current_state_ = state::has_value;
-    notify_now(std::move(lk));
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    publish(state::has_value, true);
   }
 
   /**
@@ -442,6 +618,7 @@ class future_shared_state<void> final : private future_shared_state_base {
   future_shared_state() : future_shared_state_base() {}
 
   using future_shared_state_base::abandon;
+  using future_shared_state_base::emplace_and_publish_continuation;
   using future_shared_state_base::is_ready;
   using future_shared_state_base::set_continuation;
   using future_shared_state_base::set_exception;
@@ -451,8 +628,7 @@ class future_shared_state<void> final : private future_shared_state_base {
 
   /// The implementation details for `future<void>::get()`
   void get() {
-    std::unique_lock<std::mutex> lk(mu_);
-    cv_.wait(lk, [this] { return is_ready_unlocked(); });
+    wait();
     if (current_state_ == state::has_exception) {
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
       std::rethrow_exception(exception_);
@@ -465,9 +641,8 @@ class future_shared_state<void> final : private future_shared_state_base {
 
   /// The implementation details for `promise<void>::set_value()`
   void set_value() {
-    std::unique_lock<std::mutex> lk(mu_);
-    set_value(lk);
-    notify_now(std::move(lk));
+    claim(__func__);
+    publish(state::has_value, true);
   }
 
   /**
@@ -531,14 +706,6 @@ class future_shared_state<void> final : private future_shared_state_base {
   static void mark_retrieved(std::shared_ptr<future_shared_state> const& sh) {
     future_shared_state_base::mark_retrieved(sh.get());
   }
-
- private:
-  void set_value(std::unique_lock<std::mutex> const& lk) {
-    if (is_ready_unlocked()) {
-      ThrowFutureError(std::future_errc::promise_already_satisfied, __func__);
-    }
-    current_state_ = state::has_value;
-  }
 };
 
 /**
@@ -751,11 +918,12 @@ std::shared_ptr<typename internal::continuation_helper<F, T>::state_t>
 future_shared_state<T>::make_continuation(
     std::shared_ptr<future_shared_state<T>> self, F&& functor) {
   using continuation_type = internal::continuation<F, T>;
-  auto continuation = google::cloud::internal::make_unique<continuation_type>(
+  auto* continuation = self->template emplace_continuation<continuation_type>(
       std::forward<F>(functor), self);
+  // Save the value of `continuation->output`, the continuation may run, and
+  // be destroyed, as soon as it is published.
   auto result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -773,13 +941,12 @@ future_shared_state<T>::make_continuation(
 
   // First create a continuation that calls the functor, and stores the result
   // in a `future_shared_state<future_shared_state<R>>`
-  auto continuation = google::cloud::internal::make_unique<continuation_type>(
+  auto* continuation = self->template emplace_continuation<continuation_type>(
       std::forward<F>(functor), self);
-  // Save the value of `continuation->output`, because the move will make it
-  // inaccessible.
+  // Save the value of `continuation->output`, the continuation may run, and
+  // be destroyed, as soon as it is published.
   std::shared_ptr<future_shared_state<R>> result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -789,13 +956,12 @@ std::shared_ptr<typename internal::continuation_helper<F, void>::state_t>
 future_shared_state<void>::make_continuation(
     std::shared_ptr<future_shared_state<void>> self, F&& functor) {
   using continuation_type = internal::continuation<F, void>;
-  auto continuation = google::cloud::internal::make_unique<continuation_type>(
+  auto* continuation = self->template emplace_continuation<continuation_type>(
       std::forward<F>(functor), self);
-  // Save the value of `continuation->output`, because the move will make it
-  // inaccessible.
+  // Save the value of `continuation->output`, the continuation may run, and
+  // be destroyed, as soon as it is published.
   auto result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
@@ -815,13 +981,12 @@ future_shared_state<void>::make_continuation(
 
   // First create a continuation that calls the functor, and stores the result
   // in a `future_shared_state<future_shared_state<R>>`
-  auto continuation = google::cloud::internal::make_unique<continuation_type>(
+  auto* continuation = self->template emplace_continuation<continuation_type>(
       std::forward<F>(functor), self);
-  // Save the value of `continuation->output`, because the move will make it
-  // inaccessible.
+  // Save the value of `continuation->output`, the continuation may run, and
+  // be destroyed, as soon as it is published.
   std::shared_ptr<future_shared_state<R>> result = continuation->output;
-  self->set_continuation(
-      std::unique_ptr<continuation_base>(std::move(continuation)));
+  self->publish_continuation();
   return result;
 }
 
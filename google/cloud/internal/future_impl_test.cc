@@ -18,6 +18,9 @@
 #include "google/cloud/testing_util/expect_future_error.h"
 #include "google/cloud/testing_util/testing_types.h"
 #include <gmock/gmock.h>
+#include <array>
+#include <atomic>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -579,6 +582,80 @@ TEST(FutureImplObservable, SetValue) {
   EXPECT_EQ(3, Observable::destructor);
 }
 
+/// @test Verify that continuations larger than the inline buffer work.
+TEST(FutureImplInt, LargeContinuation) {
+  std::array<int, 64> large{};
+  large.back() = 42;
+  auto functor = [large](std::shared_ptr<future_shared_state<int>> state) {
+    return state->get() + large.back();
+  };
+
+  auto input = std::make_shared<future_shared_state<int>>();
+  auto output = input->make_continuation(input, std::move(functor));
+  EXPECT_FALSE(output->is_ready());
+  input->set_value(0);
+  EXPECT_TRUE(output->is_ready());
+  EXPECT_EQ(42, output->get());
+}
+
+/// @test Verify that get() blocks until the value is set by another thread.
+TEST(FutureImplInt, GetBlocksUntilSetValue) {
+  future_shared_state<int> shared_state;
+  std::thread t([&shared_state] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    shared_state.set_value(42);
+  });
+  EXPECT_EQ(42, shared_state.get());
+  t.join();
+}
+
+/// @test Verify that continuations run exactly once when racing set_value().
+TEST(FutureImplInt, ContinuationRace) {
+  for (int i = 0; i != 1000; ++i) {
+    std::atomic<int> counter(0);
+    auto input = std::make_shared<future_shared_state<int>>();
+    std::thread t([input, i] { input->set_value(int(i)); });
+    auto output = input->make_continuation(
+        input, [&counter](std::shared_ptr<future_shared_state<int>> state) {
+          ++counter;
+          return state->get() + 1;
+        });
+    EXPECT_EQ(i + 1, output->get());
+    t.join();
+    EXPECT_EQ(1, counter.load());
+  }
+}
+
+/// @test Verify that waiters are woken up when racing set_value().
+TEST(FutureImplInt, WaitRace) {
+  for (int i = 0; i != 1000; ++i) {
+    future_shared_state<int> shared_state;
+    std::thread t([&shared_state, i] { shared_state.set_value(int(i)); });
+    EXPECT_EQ(i, shared_state.get());
+    t.join();
+  }
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+struct ThrowOnMove {
+  ThrowOnMove() = default;
+  ThrowOnMove(ThrowOnMove const&) = default;
+  ThrowOnMove(ThrowOnMove&&) { throw std::runtime_error("cannot move"); }
+};
+
+/// @test Verify that a failed set_value() does not satisfy the shared state.
+TEST(FutureImplThrowOnMove, SetValueThrows) {
+  future_shared_state<ThrowOnMove> shared_state;
+  EXPECT_THROW(shared_state.set_value(ThrowOnMove{}), std::runtime_error);
+  EXPECT_FALSE(shared_state.is_ready());
+
+  shared_state.abandon();
+  EXPECT_TRUE(shared_state.is_ready());
+  ExpectFutureError([&] { shared_state.get(); },
+                    std::future_errc::broken_promise);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
 }  // namespace
 }  // namespace internal
 }  // namespace GOOGLE_CLOUD_CPP_NS
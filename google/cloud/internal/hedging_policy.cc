@@ -0,0 +1,117 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/hedging_policy.h"
+#include "google/cloud/internal/make_unique.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+/// Do not hedge until the window has at least this many samples.
+std::size_t const kMinimumSamples = 32;
+/// Recompute the percentile after this many new samples.
+std::uint64_t const kRecomputeInterval = 16;
+/// The maximum number of hedging tokens that can be accumulated.
+double const kMaximumBudget = 10.0;
+}  // namespace
+
+PercentileHedgingPolicy::PercentileHedgingPolicy(
+    double percentile, double maximum_hedge_ratio,
+    std::chrono::milliseconds minimum_delay, std::size_t window_size)
+    : percentile_(std::min(std::max(percentile, 0.0), 100.0)),
+      maximum_hedge_ratio_(std::max(maximum_hedge_ratio, 0.0)),
+      minimum_delay_(minimum_delay),
+      window_size_(std::max(window_size, std::size_t(1))),
+      next_sample_(0),
+      cached_delay_(0),
+      cached_delay_valid_(false),
+      budget_(0.0),
+      request_count_(0),
+      hedge_count_(0),
+      hedge_won_count_(0) {
+  samples_.reserve(window_size_);
+}
+
+std::unique_ptr<HedgingPolicy> PercentileHedgingPolicy::clone() const {
+  return google::cloud::internal::make_unique<PercentileHedgingPolicy>(
+      percentile_, maximum_hedge_ratio_, minimum_delay_, window_size_);
+}
+
+std::chrono::milliseconds PercentileHedgingPolicy::HedgeDelay() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (samples_.size() < std::min(kMinimumSamples, window_size_)) {
+    return std::chrono::milliseconds(0);
+  }
+  if (!cached_delay_valid_) {
+    auto sorted = samples_;
+    auto index = static_cast<std::size_t>(
+        static_cast<double>(sorted.size() - 1) * percentile_ / 100.0);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    cached_delay_ = std::max(sorted[index], minimum_delay_);
+    cached_delay_valid_ = true;
+  }
+  return cached_delay_;
+}
+
+bool PercentileHedgingPolicy::OnHedge() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (budget_ < 1.0) {
+    return false;
+  }
+  budget_ -= 1.0;
+  ++hedge_count_;
+  return true;
+}
+
+void PercentileHedgingPolicy::OnCompletion(std::chrono::milliseconds latency,
+                                           bool, bool hedge_won) {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++request_count_;
+  if (hedge_won) {
+    ++hedge_won_count_;
+  }
+  budget_ = std::min(budget_ + maximum_hedge_ratio_, kMaximumBudget);
+  if (samples_.size() < window_size_) {
+    samples_.push_back(latency);
+  } else {
+    samples_[next_sample_] = latency;
+    next_sample_ = (next_sample_ + 1) % window_size_;
+  }
+  if (request_count_ % kRecomputeInterval == 0) {
+    cached_delay_valid_ = false;
+  }
+}
+
+std::uint64_t PercentileHedgingPolicy::request_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return request_count_;
+}
+
+std::uint64_t PercentileHedgingPolicy::hedge_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return hedge_count_;
+}
+
+std::uint64_t PercentileHedgingPolicy::hedge_won_count() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return hedge_won_count_;
+}
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
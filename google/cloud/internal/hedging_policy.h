@@ -0,0 +1,147 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_HEDGING_POLICY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_HEDGING_POLICY_H_
+
+#include "google/cloud/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/**
+ * Define the interface for the hedging policy.
+ *
+ * Hedging reduces the tail latency of small, idempotent read operations. If
+ * the first request has not completed after some delay the library sends a
+ * duplicate request, and uses whichever response arrives first. The losing
+ * request is cancelled, and its result discarded.
+ *
+ * Hedged requests increase the load on the service, the policy controls both
+ * the delay before sending a duplicate request and how many duplicate requests
+ * can be sent.
+ *
+ * Unlike the retry and backoff policies, a single instance of the hedging
+ * policy is shared by all the operations of a client, because the policy needs
+ * to observe the latency across many requests. Implementations must be
+ * thread-safe.
+ */
+class HedgingPolicy {
+ public:
+  virtual ~HedgingPolicy() = default;
+
+  /// Create a new copy of this object, the copy does not share any state.
+  virtual std::unique_ptr<HedgingPolicy> clone() const = 0;
+
+  /**
+   * Return how long to wait before sending a duplicate request.
+   *
+   * A zero value disables hedging for the current request.
+   */
+  virtual std::chrono::milliseconds HedgeDelay() = 0;
+
+  /**
+   * Called before sending a duplicate request.
+   *
+   * @return true if the duplicate request can be sent, false if the hedging
+   *     budget is exhausted.
+   */
+  virtual bool OnHedge() = 0;
+
+  /**
+   * Called when a (possibly hedged) request completes.
+   *
+   * @param latency the time between the start of the first request and the
+   *     arrival of the winning response.
+   * @param hedged true if a duplicate request was sent.
+   * @param hedge_won true if the duplicate request produced the result.
+   */
+  virtual void OnCompletion(std::chrono::milliseconds latency, bool hedged,
+                            bool hedge_won) = 0;
+};
+
+/**
+ * Hedge requests that take longer than a given latency percentile.
+ *
+ * This policy keeps a sliding window of the most recent latencies, and sends a
+ * duplicate request when a request takes longer than the configured percentile
+ * of that window. Hedging is disabled until the window has enough samples.
+ *
+ * The number of duplicate requests is limited by a budget: each request earns
+ * `maximum_hedge_ratio` tokens, and each duplicate request consumes one token.
+ * For example, with a ratio of `0.05` at most 5% of the requests are hedged
+ * (after a small initial burst).
+ */
+class PercentileHedgingPolicy : public HedgingPolicy {
+ public:
+  /**
+   * Create a policy.
+   *
+   * @param percentile the latency percentile (in the `(0, 100)` range) after
+   *     which a duplicate request is sent.
+   * @param maximum_hedge_ratio the maximum fraction of requests that are
+   *     hedged.
+   * @param minimum_delay never hedge requests faster than this value.
+   * @param window_size the number of latency samples used to estimate the
+   *     percentile.
+   */
+  explicit PercentileHedgingPolicy(
+      double percentile = 95.0, double maximum_hedge_ratio = 0.05,
+      std::chrono::milliseconds minimum_delay = std::chrono::milliseconds(5),
+      std::size_t window_size = 1024);
+
+  std::unique_ptr<HedgingPolicy> clone() const override;
+  std::chrono::milliseconds HedgeDelay() override;
+  bool OnHedge() override;
+  void OnCompletion(std::chrono::milliseconds latency, bool hedged,
+                    bool hedge_won) override;
+
+  /// The number of completed requests observed by this policy.
+  std::uint64_t request_count() const;
+
+  /// The number of duplicate requests sent.
+  std::uint64_t hedge_count() const;
+
+  /// The number of duplicate requests that completed before the original.
+  std::uint64_t hedge_won_count() const;
+
+ private:
+  double percentile_;
+  double maximum_hedge_ratio_;
+  std::chrono::milliseconds minimum_delay_;
+  std::size_t window_size_;
+
+  mutable std::mutex mu_;
+  std::vector<std::chrono::milliseconds> samples_;
+  std::size_t next_sample_;
+  std::chrono::milliseconds cached_delay_;
+  bool cached_delay_valid_;
+  double budget_;
+  std::uint64_t request_count_;
+  std::uint64_t hedge_count_;
+  std::uint64_t hedge_won_count_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_HEDGING_POLICY_H_
@@ -0,0 +1,89 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/hedging_policy.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+using ms = std::chrono::milliseconds;
+
+/// @test Verify that hedging is disabled until there are enough samples.
+TEST(PercentileHedgingPolicyTest, DisabledDuringWarmup) {
+  PercentileHedgingPolicy tested(50.0, 1.0, ms(1), 100);
+  EXPECT_EQ(0, tested.HedgeDelay().count());
+  for (int i = 0; i != 10; ++i) {
+    tested.OnCompletion(ms(10), false, false);
+  }
+  EXPECT_EQ(0, tested.HedgeDelay().count());
+}
+
+/// @test Verify that the delay tracks the configured percentile.
+TEST(PercentileHedgingPolicyTest, Percentile) {
+  PercentileHedgingPolicy tested(90.0, 1.0, ms(1), 100);
+  for (int i = 1; i <= 100; ++i) {
+    tested.OnCompletion(ms(i), false, false);
+  }
+  auto delay = tested.HedgeDelay();
+  EXPECT_LE(ms(85), delay);
+  EXPECT_GE(ms(95), delay);
+  EXPECT_EQ(100U, tested.request_count());
+}
+
+/// @test Verify that the delay is never smaller than the minimum.
+TEST(PercentileHedgingPolicyTest, MinimumDelay) {
+  PercentileHedgingPolicy tested(50.0, 1.0, ms(20), 64);
+  for (int i = 0; i != 64; ++i) {
+    tested.OnCompletion(ms(1), false, false);
+  }
+  EXPECT_EQ(ms(20), tested.HedgeDelay());
+}
+
+/// @test Verify that the budget limits the number of hedges.
+TEST(PercentileHedgingPolicyTest, Budget) {
+  PercentileHedgingPolicy tested(50.0, 0.1, ms(1), 64);
+  EXPECT_FALSE(tested.OnHedge());
+  for (int i = 0; i != 20; ++i) {
+    tested.OnCompletion(ms(1), false, false);
+  }
+  // 20 requests at 10% earn 2 hedges.
+  EXPECT_TRUE(tested.OnHedge());
+  EXPECT_TRUE(tested.OnHedge());
+  EXPECT_FALSE(tested.OnHedge());
+  EXPECT_EQ(2U, tested.hedge_count());
+
+  tested.OnCompletion(ms(1), true, true);
+  EXPECT_EQ(1U, tested.hedge_won_count());
+}
+
+/// @test Verify that clone() does not copy the accumulated state.
+TEST(PercentileHedgingPolicyTest, Clone) {
+  PercentileHedgingPolicy tested(50.0, 1.0, ms(1), 32);
+  for (int i = 0; i != 32; ++i) {
+    tested.OnCompletion(ms(10), false, false);
+  }
+  EXPECT_EQ(ms(10), tested.HedgeDelay());
+  auto copy = tested.clone();
+  EXPECT_EQ(0, copy->HedgeDelay().count());
+  EXPECT_FALSE(copy->OnHedge());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
@@ -46,6 +46,17 @@ class RetryPolicy {
   }
   virtual bool IsExhausted() const = 0;
 
+  /**
+   * Return how long the policy keeps retrying.
+   *
+   * Callers use this value to avoid waiting (e.g. for a rate limiter) longer
+   * than the policy would allow. Policies without a time limit return
+   * `std::chrono::milliseconds::max()`.
+   */
+  virtual std::chrono::milliseconds RemainingTime() const {
+    return std::chrono::milliseconds::max();
+  }
+
  protected:
   virtual void OnFailureImpl() = 0;
 };
@@ -135,6 +146,14 @@ class LimitedTimeRetryPolicy : public RetryPolicy<StatusType, RetryablePolicy> {
   bool IsExhausted() const override {
     return std::chrono::system_clock::now() >= deadline_;
   }
+  std::chrono::milliseconds RemainingTime() const override {
+    auto now = std::chrono::system_clock::now();
+    if (now >= deadline_) {
+      return std::chrono::milliseconds(0);
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(deadline_ -
+                                                                 now);
+  }
 
   std::chrono::system_clock::time_point deadline() const { return deadline_; }
 
@@ -74,6 +74,16 @@ TEST(LimitedTimeRetryPolicy, OnNonRetryable) {
   EXPECT_FALSE(tested.OnFailure(CreatePermanentError()));
 }
 
+/// @test Verify that the remaining time decreases until the deadline.
+TEST(LimitedTimeRetryPolicy, RemainingTime) {
+  LimitedTimeRetryPolicyForTest tested(std::chrono::milliseconds(1000));
+  EXPECT_LE(tested.RemainingTime(), std::chrono::milliseconds(1000));
+  EXPECT_GT(tested.RemainingTime(), std::chrono::milliseconds(0));
+
+  LimitedTimeRetryPolicyForTest expired(std::chrono::milliseconds(0));
+  EXPECT_EQ(std::chrono::milliseconds(0), expired.RemainingTime());
+}
+
 /// @test A simple test for the LimitedErrorCountRetryPolicy.
 TEST(LimitedErrorCountRetryPolicy, Simple) {
   LimitedErrorCountRetryPolicyForTest tested(3);
@@ -100,3 +110,9 @@ TEST(LimitedErrorCountRetryPolicy, OnNonRetryable) {
   LimitedErrorCountRetryPolicyForTest tested(3);
   EXPECT_FALSE(tested.OnFailure(CreatePermanentError()));
 }
+
+/// @test Verify that policies without a time limit report no time limit.
+TEST(LimitedErrorCountRetryPolicy, RemainingTime) {
+  LimitedErrorCountRetryPolicyForTest tested(3);
+  EXPECT_EQ(std::chrono::milliseconds::max(), tested.RemainingTime());
+}
@@ -0,0 +1,149 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RING_BUFFER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RING_BUFFER_H_
+
+#include "google/cloud/version.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+/**
+ * A bounded, lock-free, multiple-producer multiple-consumer queue.
+ *
+ * This is the well-known design by Dmitry Vyukov: each cell in the buffer has
+ * a sequence number, producers and consumers claim a position with a
+ * compare-and-swap, and then use the sequence number of the cell to publish
+ * the value (or release the cell) to the other side. Neither `TryPush()` nor
+ * `TryPop()` ever block, they fail if the queue is full or empty respectively.
+ *
+ * @tparam T the type of the elements, it must be default constructible and
+ *     move assignable.
+ */
+template <typename T>
+class RingBuffer {
+ public:
+  /// Create a buffer, @p capacity is rounded up to a power of two.
+  explicit RingBuffer(std::size_t capacity)
+      : capacity_(RoundUp(capacity)),
+        mask_(capacity_ - 1),
+        cells_(new Cell[capacity_]),
+        pad0_(),
+        enqueue_pos_(0),
+        pad1_(),
+        dequeue_pos_(0) {
+    for (std::size_t i = 0; i != capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  RingBuffer(RingBuffer const&) = delete;
+  RingBuffer& operator=(RingBuffer const&) = delete;
+
+  std::size_t capacity() const { return capacity_; }
+
+  /// Move @p value into the queue, leave it unmodified if the queue is full.
+  bool TryPush(T& value) {
+    Cell* cell;
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      auto const seq = cell->sequence.load(std::memory_order_acquire);
+      auto const diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Move the oldest element into @p value, return false if the queue is empty.
+  bool TryPop(T& value) {
+    Cell* cell;
+    auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      auto const seq = cell->sequence.load(std::memory_order_acquire);
+      auto const diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    // Release any resources held by the moved-from value.
+    cell->value = T();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  static std::size_t RoundUp(std::size_t capacity) {
+    std::size_t result = 2;
+    while (result < capacity) {
+      result *= 2;
+    }
+    return result;
+  }
+
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  // Keep the producer and consumer positions in different cache lines, they
+  // are modified by different threads.
+  static std::size_t constexpr kCacheLineSize = 64;
+
+  std::size_t const capacity_;
+  std::size_t const mask_;
+  std::unique_ptr<Cell[]> cells_;
+  struct Padding {
+    char unused[kCacheLineSize];
+  };
+  Padding pad0_;
+  std::atomic<std::size_t> enqueue_pos_;
+  Padding pad1_;
+  std::atomic<std::size_t> dequeue_pos_;
+};
+
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_INTERNAL_RING_BUFFER_H_
@@ -0,0 +1,105 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/internal/ring_buffer.h"
+#include <gmock/gmock.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+inline namespace GOOGLE_CLOUD_CPP_NS {
+namespace internal {
+namespace {
+
+TEST(RingBufferTest, CapacityIsPowerOfTwo) {
+  EXPECT_EQ(2U, RingBuffer<int>(0).capacity());
+  EXPECT_EQ(8U, RingBuffer<int>(8).capacity());
+  EXPECT_EQ(16U, RingBuffer<int>(9).capacity());
+}
+
+TEST(RingBufferTest, PushPop) {
+  RingBuffer<std::string> buffer(4);
+  std::string value;
+  EXPECT_FALSE(buffer.TryPop(value));
+
+  for (int i = 0; i != 4; ++i) {
+    value = "value-" + std::to_string(i);
+    EXPECT_TRUE(buffer.TryPush(value));
+  }
+  // A failed push leaves the value unmodified.
+  value = "overflow";
+  EXPECT_FALSE(buffer.TryPush(value));
+  EXPECT_EQ("overflow", value);
+
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_TRUE(buffer.TryPop(value));
+    EXPECT_EQ("value-" + std::to_string(i), value);
+  }
+  EXPECT_FALSE(buffer.TryPop(value));
+
+  // Verify the positions wrap around correctly.
+  for (int i = 0; i != 10; ++i) {
+    value = std::to_string(i);
+    EXPECT_TRUE(buffer.TryPush(value));
+    ASSERT_TRUE(buffer.TryPop(value));
+    EXPECT_EQ(std::to_string(i), value);
+  }
+}
+
+/// @test Verify the buffer works with multiple producers and one consumer.
+TEST(RingBufferTest, MultipleProducers) {
+  int const producer_count = 4;
+  int const per_producer = 10000;
+  RingBuffer<int> buffer(64);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p != producer_count; ++p) {
+    producers.emplace_back([&buffer, p] {
+      for (int i = 0; i != per_producer; ++i) {
+        int value = p * per_producer + i;
+        while (!buffer.TryPush(value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<int> last(producer_count, -1);
+  int received = 0;
+  while (received != producer_count * per_producer) {
+    int value;
+    if (!buffer.TryPop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ++received;
+    // Values from the same producer are received in order.
+    auto const producer = value / per_producer;
+    EXPECT_LT(last[producer], value);
+    last[producer] = value;
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  int value;
+  EXPECT_FALSE(buffer.TryPop(value));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace GOOGLE_CLOUD_CPP_NS
+}  // namespace cloud
+}  // namespace google
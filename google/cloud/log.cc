@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "google/cloud/log.h"
+#include "google/cloud/internal/ring_buffer.h"
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -38,11 +44,149 @@ std::ostream& operator<<(std::ostream& os, LogRecord const& rhs) {
             << rhs.filename << ':' << rhs.lineno << ')';
 }
 
+// Before C++17 static constexpr data members need a definition if odr-used.
+std::size_t constexpr LogSink::kDefaultAsyncBufferSize;
+
+/**
+ * Buffer log records and deliver them from a background thread.
+ *
+ * The records are stored in several ring buffers, each thread prefers the
+ * buffer selected by hashing its id, so threads rarely contend on the same
+ * buffer positions. The background thread wakes up periodically, or when
+ * `Flush()` is called, and drains all the buffers.
+ */
+class LogSink::AsyncDispatcher {
+ public:
+  AsyncDispatcher(LogSink& sink, std::size_t buffer_size) : sink_(sink) {
+    auto const shard_count = (std::max)(
+        1U, (std::min)(kMaximumShardCount, std::thread::hardware_concurrency()));
+    auto const shard_size = (std::max)(buffer_size / shard_count,
+                                       static_cast<std::size_t>(2));
+    for (unsigned i = 0; i != shard_count; ++i) {
+      shards_.emplace_back(new internal::RingBuffer<LogRecord>(shard_size));
+    }
+    thread_ = std::thread([this] { Run(); });
+    thread_id_ = thread_.get_id();
+  }
+
+  // Deliver any records pushed after the background thread stopped.
+  ~AsyncDispatcher() { Drain(); }
+
+  /// Buffer @p log_record, leave it unmodified if the buffer is full.
+  bool TryPush(LogRecord& log_record) {
+    auto const index =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+        shards_.size();
+    return shards_[index]->TryPush(log_record);
+  }
+
+  /**
+   * Block until the records buffered before this call are delivered.
+   *
+   * Returns immediately if called from the background thread, e.g., when a
+   * backend logs, as that thread cannot wait for itself.
+   */
+  void Flush() {
+    if (std::this_thread::get_id() == thread_id_) {
+      return;
+    }
+    std::unique_lock<std::mutex> lk(mu_);
+    auto const generation = ++flush_requested_;
+    cv_.notify_all();
+    cv_.wait(lk, [this, generation] {
+      return stopped_ || flush_completed_ >= generation;
+    });
+  }
+
+  void Shutdown() {
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+ private:
+  static unsigned constexpr kMaximumShardCount = 16;
+
+  void Run() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+      auto const requested = flush_requested_;
+      auto const stop = shutdown_;
+      lk.unlock();
+      auto const count = Drain();
+      lk.lock();
+      flush_completed_ = requested;
+      cv_.notify_all();
+      if (stop) {
+        // Any records pushed after this point are delivered by the destructor.
+        stopped_ = true;
+        cv_.notify_all();
+        return;
+      }
+      if (count != 0) {
+        // Under load there are probably more records waiting.
+        continue;
+      }
+      cv_.wait_for(lk, std::chrono::milliseconds(10), [this] {
+        return shutdown_ || flush_requested_ != flush_completed_;
+      });
+    }
+  }
+
+  /**
+   * Deliver the records in each buffer.
+   *
+   * At most one buffer's worth of records is delivered from each buffer, so
+   * this function terminates even if other threads keep logging. All the
+   * records buffered before the call are delivered.
+   */
+  std::size_t Drain() {
+    std::size_t count = 0;
+    LogRecord record;
+    for (auto& shard : shards_) {
+      for (std::size_t i = 0; i != shard->capacity(); ++i) {
+        if (!shard->TryPop(record)) {
+          break;
+        }
+        sink_.Dispatch(std::move(record));
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  LogSink& sink_;
+  std::vector<std::unique_ptr<internal::RingBuffer<LogRecord>>> shards_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool shutdown_ = false;
+  bool stopped_ = false;
+  std::uint64_t flush_requested_ = 0;
+  std::uint64_t flush_completed_ = 0;
+  std::thread thread_;
+  std::thread::id thread_id_;
+};
+
+unsigned constexpr LogSink::AsyncDispatcher::kMaximumShardCount;
+
 LogSink::LogSink()
     : empty_(true),
       minimum_severity_(static_cast<int>(Severity::GCP_LS_LOWEST_ENABLED)),
       next_id_(0),
-      clog_backend_id_(0) {}
+      clog_backend_id_(0),
+      snapshot_(std::make_shared<BackendMap const>()),
+      rate_limit_(0),
+      rate_window_(0),
+      rate_window_count_(0),
+      dropped_count_(0),
+      rate_limited_count_(0) {}
+
+LogSink::~LogSink() { DisableAsync(); }
 
 LogSink& LogSink::Instance() {
   static LogSink instance;
@@ -63,7 +207,7 @@ void LogSink::ClearBackends() {
   std::unique_lock<std::mutex> lk(mu_);
   backends_.clear();
   clog_backend_id_ = 0;
-  empty_.store(backends_.empty());
+  PublishBackends();
 }
 
 std::size_t LogSink::BackendCount() const {
@@ -72,25 +216,97 @@ std::size_t LogSink::BackendCount() const {
 }
 
 void LogSink::Log(LogRecord log_record) {
-  // Make a copy of the backends because calling user-defined functions while
-  // holding a lock is a bad idea: the application may change the backends while
-  // we are holding this lock, and soon deadlock occurs.
-  auto copy = [this]() {
+  if (log_record.severity < Severity::GCP_LS_WARNING && RateLimited()) {
+    return;
+  }
+  auto async = std::atomic_load(&async_);
+  if (!async) {
+    Dispatch(std::move(log_record));
+    return;
+  }
+  if (async->TryPush(log_record)) {
+    return;
+  }
+  if (log_record.severity < Severity::GCP_LS_WARNING) {
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  // Do not drop important messages, even if that blocks this thread. Deliver
+  // the records already buffered first, so the records from this thread are
+  // still delivered in order.
+  async->Flush();
+  Dispatch(std::move(log_record));
+}
+
+void LogSink::EnableAsync(std::size_t buffer_size) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (std::atomic_load(&async_)) {
+    return;
+  }
+  std::atomic_store(&async_,
+                    std::make_shared<AsyncDispatcher>(*this, buffer_size));
+}
+
+void LogSink::DisableAsync() {
+  std::shared_ptr<AsyncDispatcher> async;
+  {
     std::unique_lock<std::mutex> lk(mu_);
-    return backends_;
-  }();
-  if (copy.empty()) {
+    async = std::atomic_exchange(&async_, std::shared_ptr<AsyncDispatcher>());
+  }
+  if (async) {
+    async->Shutdown();
+  }
+}
+
+bool LogSink::async_enabled() const {
+  return static_cast<bool>(std::atomic_load(&async_));
+}
+
+void LogSink::Flush() {
+  auto async = std::atomic_load(&async_);
+  if (async) {
+    async->Flush();
+  }
+}
+
+bool LogSink::RateLimited() {
+  auto const limit = rate_limit_.load(std::memory_order_relaxed);
+  if (limit <= 0) {
+    return false;
+  }
+  auto const now = std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+  auto window = rate_window_.load(std::memory_order_relaxed);
+  if (window != now &&
+      rate_window_.compare_exchange_strong(window, now,
+                                           std::memory_order_relaxed)) {
+    rate_window_count_.store(0, std::memory_order_relaxed);
+  }
+  if (rate_window_count_.fetch_add(1, std::memory_order_relaxed) < limit) {
+    return false;
+  }
+  rate_limited_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void LogSink::Dispatch(LogRecord log_record) {
+  // Use the snapshot because calling user-defined functions while holding a
+  // lock is a bad idea: the application may change the backends while we are
+  // holding this lock, and soon deadlock occurs.
+  auto backends = std::atomic_load(&snapshot_);
+  if (backends->empty()) {
     return;
   }
   // In general, we just give each backend a const-reference and the backends
   // must make a copy if needed.  But if there is only one backend we can give
   // the backend an opportunity to optimize things by transferring ownership of
   // the LogRecord to it.
-  if (1U == copy.size()) {
-    copy.begin()->second->ProcessWithOwnership(std::move(log_record));
+  if (1U == backends->size()) {
+    backends->begin()->second->ProcessWithOwnership(std::move(log_record));
     return;
   }
-  for (auto& kv : copy) {
+  for (auto const& kv : *backends) {
     kv.second->Process(log_record);
   }
 }
@@ -130,7 +346,7 @@ void LogSink::DisableStdClogImpl() {
 long LogSink::AddBackendImpl(std::shared_ptr<LogBackend> backend) {
   long id = ++next_id_;
   backends_.emplace(id, std::move(backend));
-  empty_.store(backends_.empty());
+  PublishBackends();
   return id;
 }
 
@@ -140,6 +356,11 @@ void LogSink::RemoveBackendImpl(long id) {
     return;
   }
   backends_.erase(it);
+  PublishBackends();
+}
+
+void LogSink::PublishBackends() {
+  std::atomic_store(&snapshot_, std::make_shared<BackendMap const>(backends_));
   empty_.store(backends_.empty());
 }
 
@@ -60,6 +60,17 @@
  * Note that while `std::clog` is buffered, the framework will flush any log
  * message at severity `WARNING` or higher.
  *
+ * @par Example: Deliver Logs From a Background Thread
+ * Backends such as `std::clog` can be slow, and their cost is paid by the
+ * thread that logs. The application can move this work to a background thread:
+ *
+ * @code
+ * void AppCode() {
+ *   google::cloud::LogSink::Instance().EnableAsync();
+ *   google::cloud::LogSink::Instance().set_rate_limit(10000);
+ * }
+ * @endcode
+ *
  * @par Example: Capture Logs
  * The application can implement simple backends by wrapping a functor:
  *
@@ -79,6 +90,7 @@
 #include "google/cloud/version.h"
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -228,11 +240,21 @@ class LogBackend {
 };
 
 /**
+ * Dispatch log records to the backends.
  *
+ * By default the backends are called in the thread that logs the record. The
+ * application can call `EnableAsync()` to deliver the records from a
+ * background thread instead. In that case `Log()` moves the record into a
+ * lock-free buffer and returns immediately, records that do not fit in the
+ * buffer are dropped and counted in `dropped_count()`.
  */
 class LogSink {
  public:
   LogSink();
+  ~LogSink();
+
+  /// The default number of records buffered by `EnableAsync()`.
+  static std::size_t constexpr kDefaultAsyncBufferSize = 16 * 1024;
 
   /// Return true if the severity is enabled at compile time.
   constexpr static bool CompileTimeEnabled(Severity level) {
@@ -297,6 +319,64 @@ class LogSink {
 
   void Log(LogRecord log_record);
 
+  /**
+   * Deliver log records from a background thread.
+   *
+   * The records are buffered in lock-free ring buffers, sharded by thread, and
+   * a background thread drains the buffers and calls the backends. Records
+   * from the same thread are delivered in order, but records from different
+   * threads may be reordered. Records below `Severity::GCP_LS_WARNING` are
+   * dropped if the buffers are full, records at `Severity::GCP_LS_WARNING` or
+   * higher are delivered synchronously instead, after waiting for the records
+   * already buffered.
+   *
+   * @param buffer_size the approximate number of records buffered across all
+   *     threads.
+   */
+  void EnableAsync(std::size_t buffer_size = kDefaultAsyncBufferSize);
+
+  /**
+   * Stop the background thread, delivering any buffered records.
+   *
+   * @note This function must not be called from a backend.
+   */
+  void DisableAsync();
+
+  /// Return true if `EnableAsync()` is in effect.
+  bool async_enabled() const;
+
+  /**
+   * Block until all the records buffered before this call are delivered.
+   *
+   * Has no effect unless `EnableAsync()` is in effect.
+   *
+   * @note This function must not be called from a backend.
+   */
+  void Flush();
+
+  /**
+   * Limit the number of records below `Severity::GCP_LS_WARNING` logged each
+   * second.
+   *
+   * Records over the limit are discarded and counted in
+   * `rate_limited_count()`. The limit is approximate, it is enforced without
+   * locks. Use 0 (the default) to disable rate limiting.
+   */
+  void set_rate_limit(long max_records_per_second) {
+    rate_limit_.store(max_records_per_second, std::memory_order_relaxed);
+  }
+  long rate_limit() const {
+    return rate_limit_.load(std::memory_order_relaxed);
+  }
+
+  /// The number of records discarded because the async buffers were full.
+  std::uint64_t dropped_count() const { return dropped_count_.load(); }
+
+  /// The number of records discarded by the rate limit.
+  std::uint64_t rate_limited_count() const {
+    return rate_limited_count_.load();
+  }
+
   /// Enable `std::clog` on `LogSink::Instance()`.
   static void EnableStdClog() { Instance().EnableStdClogImpl(); }
 
@@ -304,10 +384,16 @@ class LogSink {
   static void DisableStdClog() { Instance().DisableStdClogImpl(); }
 
  private:
+  class AsyncDispatcher;
+  using BackendMap = std::map<long, std::shared_ptr<LogBackend>>;
+
   void EnableStdClogImpl();
   void DisableStdClogImpl();
   long AddBackendImpl(std::shared_ptr<LogBackend> backend);
   void RemoveBackendImpl(long id);
+  void PublishBackends();
+  bool RateLimited();
+  void Dispatch(LogRecord log_record);
 
   std::atomic<bool> empty_;
   std::atomic<int> minimum_severity_;
@@ -315,6 +401,24 @@ class LogSink {
   long next_id_;
   long clog_backend_id_;
   std::map<long, std::shared_ptr<LogBackend>> backends_;
+
+  /**
+   * An immutable copy of `backends_`.
+   *
+   * `Log()` reads this snapshot without taking `mu_` or copying the map. The
+   * snapshot is replaced (while holding `mu_`) each time `backends_` changes.
+   * Always use `std::atomic_load()` and `std::atomic_store()` to access it.
+   */
+  std::shared_ptr<BackendMap const> snapshot_;
+
+  /// The background dispatcher, use `std::atomic_load()` to access it.
+  std::shared_ptr<AsyncDispatcher> async_;
+
+  std::atomic<long> rate_limit_;
+  std::atomic<std::int64_t> rate_window_;
+  std::atomic<long> rate_window_count_;
+  std::atomic<std::uint64_t> dropped_count_;
+  std::atomic<std::uint64_t> rate_limited_count_;
 };
 
 /**
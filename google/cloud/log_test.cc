@@ -14,6 +14,11 @@
 
 #include "google/cloud/log.h"
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 
 using namespace google::cloud;
 using namespace ::testing;
@@ -219,3 +224,164 @@ TEST(LogSinkTest, DisabledLogsMakeNoCalls) {
   // With no backends, we expect no calls to the expressions in the log line.
   EXPECT_EQ(0, counter);
 }
+
+namespace {
+/// A thread-safe backend to capture log records.
+class CollectingBackend : public LogBackend {
+ public:
+  void Process(LogRecord const& lr) override { ProcessWithOwnership(lr); }
+  void ProcessWithOwnership(LogRecord lr) override {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (lr.message == "block") {
+      blocked_ = true;
+      cv_.notify_all();
+      cv_.wait(lk, [this] { return released_; });
+    }
+    records_.push_back(std::move(lr));
+  }
+
+  void WaitUntilBlocked() {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this] { return blocked_; });
+  }
+
+  void Release() {
+    std::unique_lock<std::mutex> lk(mu_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  std::vector<LogRecord> records() {
+    std::unique_lock<std::mutex> lk(mu_);
+    return records_;
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool blocked_ = false;
+  bool released_ = false;
+  std::vector<LogRecord> records_;
+};
+}  // namespace
+
+TEST(LogSinkTest, AsyncDeliversAfterFlush) {
+  LogSink sink;
+  auto backend = std::make_shared<CollectingBackend>();
+  sink.AddBackend(backend);
+  EXPECT_FALSE(sink.async_enabled());
+  sink.EnableAsync();
+  EXPECT_TRUE(sink.async_enabled());
+
+  int const thread_count = 4;
+  int const per_thread = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != thread_count; ++t) {
+    threads.emplace_back([&sink, t] {
+      for (int i = 0; i != per_thread; ++i) {
+        GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << t << " " << i;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  sink.Flush();
+
+  auto records = backend->records();
+  EXPECT_EQ(static_cast<std::size_t>(thread_count * per_thread),
+            records.size());
+  // Records from the same thread are delivered in order.
+  std::vector<int> last(thread_count, -1);
+  for (auto const& r : records) {
+    std::istringstream is(r.message);
+    int t;
+    int i;
+    is >> t >> i;
+    ASSERT_LE(0, t);
+    ASSERT_LT(t, thread_count);
+    EXPECT_LT(last[t], i);
+    last[t] = i;
+  }
+  EXPECT_EQ(0U, sink.dropped_count());
+}
+
+TEST(LogSinkTest, AsyncDisableDeliversBufferedRecords) {
+  LogSink sink;
+  auto backend = std::make_shared<CollectingBackend>();
+  sink.AddBackend(backend);
+  sink.EnableAsync();
+  for (int i = 0; i != 10; ++i) {
+    GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "message " << i;
+  }
+  sink.DisableAsync();
+  EXPECT_FALSE(sink.async_enabled());
+  EXPECT_EQ(10U, backend->records().size());
+
+  // After disabling the async mode the records are delivered immediately.
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "sync message";
+  EXPECT_EQ(11U, backend->records().size());
+}
+
+TEST(LogSinkTest, AsyncDropsWhenFull) {
+  LogSink sink;
+  auto backend = std::make_shared<CollectingBackend>();
+  sink.AddBackend(backend);
+  // The smallest buffers hold 2 records.
+  sink.EnableAsync(1);
+
+  // Block the background thread in the backend.
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "block";
+  backend->WaitUntilBlocked();
+
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "buffered 1";
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "buffered 2";
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "dropped";
+  EXPECT_EQ(1U, sink.dropped_count());
+
+  // Important messages are never dropped, they wait for the buffered records
+  // instead, so release the backend from another thread.
+  std::thread release([&backend] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    backend->Release();
+  });
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_WARNING, sink) << "warning";
+  EXPECT_EQ(1U, sink.dropped_count());
+  release.join();
+
+  sink.Flush();
+  std::vector<std::string> messages;
+  for (auto const& r : backend->records()) {
+    messages.push_back(r.message);
+  }
+  // The records from this thread are delivered in order.
+  EXPECT_THAT(messages,
+              ElementsAre("block", "buffered 1", "buffered 2", "warning"));
+}
+
+TEST(LogSinkTest, RateLimit) {
+  LogSink sink;
+  auto backend = std::make_shared<CollectingBackend>();
+  sink.AddBackend(backend);
+  EXPECT_EQ(0, sink.rate_limit());
+  sink.set_rate_limit(1);
+  EXPECT_EQ(1, sink.rate_limit());
+
+  int const count = 100;
+  for (int i = 0; i != count; ++i) {
+    GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_INFO, sink) << "info " << i;
+  }
+  GOOGLE_CLOUD_CPP_LOG_I(GCP_LS_WARNING, sink) << "warning";
+
+  auto const records = backend->records();
+  auto const warnings =
+      std::count_if(records.begin(), records.end(), [](LogRecord const& r) {
+        return r.severity == Severity::GCP_LS_WARNING;
+      });
+  auto const infos = static_cast<std::uint64_t>(records.size() - warnings);
+  EXPECT_EQ(1, warnings);
+  EXPECT_LE(1U, infos);
+  EXPECT_GT(static_cast<std::uint64_t>(count), infos);
+  EXPECT_EQ(static_cast<std::uint64_t>(count),
+            infos + sink.rate_limited_count());
+}
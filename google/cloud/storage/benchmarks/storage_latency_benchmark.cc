@@ -18,6 +18,8 @@
 #include "google/cloud/internal/throw_delegate.h"
 #include "google/cloud/storage/client.h"
 #include "google/cloud/storage/internal/format_rfc3339.h"
+#include <algorithm>
+#include <cmath>
 #include <future>
 #include <iomanip>
 #include <sstream>
@@ -53,7 +55,12 @@
  * - Capture the time taken to read and/or write the object.
  *
  * The loop runs for a prescribed number of seconds, at the end of the loop the
- * program prints the captured performance data.
+ * program prints the captured performance data, and a summary of the p50, p99
+ * and p99.9 latency for each operation.
+ *
+ * With `--enable-hedging=true` the program runs the loop twice, first without
+ * hedging and then with hedging, and prints the latency summary for both runs.
+ * Only the data for the second run is printed in full.
  *
  * Then the program remotes all the objects in the bucket, and reports the time
  * taken to delete each one.
@@ -75,12 +82,14 @@ struct Options {
   int thread_count;
   bool enable_connection_pool;
   bool enable_xml_api;
+  bool enable_hedging;
 
   Options()
       : duration(kDefaultDuration),
         object_count(kDefaultObjectCount),
         enable_connection_pool(true),
-        enable_xml_api(true) {
+        enable_xml_api(true),
+        enable_hedging(false) {
     thread_count = std::thread::hardware_concurrency();
     if (thread_count == 0) {
       thread_count = 1;
@@ -106,14 +115,15 @@ using TestResult = std::vector<IterationResult>;
 
 char const* ToString(OpType type);
 void PrintResult(TestResult const& result);
+void PrintLatencySummary(TestResult const& result, bool hedging);
 
 std::vector<std::string> CreateAllObjects(
     gcs::Client client, google::cloud::internal::DefaultPRNG& gen,
     std::string const& bucket_name, Options const& options);
 
-void RunTest(gcs::Client client, std::string const& bucket_name,
-             Options const& options,
-             std::vector<std::string> const& object_names);
+TestResult RunTest(gcs::Client client, std::string const& bucket_name,
+                   Options const& options,
+                   std::vector<std::string> const& object_names);
 
 void DeleteAllObjects(gcs::Client client, std::string const& bucket_name,
                       Options const& options,
@@ -141,6 +151,8 @@ int main(int argc, char* argv[]) try {
   if (!options.enable_connection_pool) {
     client_options->set_connection_pool_size(0);
   }
+  auto hedging_policy = std::make_shared<gcs::PercentileHedgingPolicy>();
+  gcs::Client hedging_client(*client_options, hedging_policy);
   gcs::Client client(*std::move(client_options));
 
   google::cloud::internal::DefaultPRNG generator =
@@ -170,11 +182,26 @@ int main(int argc, char* argv[]) try {
             << "\n# Thread Count: " << options.thread_count
             << "\n# Enable connection pool: " << options.enable_connection_pool
             << "\n# Enable XML API: " << options.enable_xml_api
+            << "\n# Enable hedging: " << options.enable_hedging
             << "\n# Build info: " << notes << std::endl;
 
   std::vector<std::string> object_names =
       CreateAllObjects(client, generator, bucket_name, options);
-  RunTest(client, bucket_name, options, object_names);
+  if (options.enable_hedging) {
+    // Run the same workload without hedging, to compare the tail latency.
+    PrintLatencySummary(RunTest(client, bucket_name, options, object_names),
+                        false);
+  }
+  auto result = RunTest(options.enable_hedging ? hedging_client : client,
+                        bucket_name, options, object_names);
+  PrintResult(result);
+  PrintLatencySummary(result, options.enable_hedging);
+  if (options.enable_hedging) {
+    std::cout << "# Hedging: requests=" << hedging_policy->request_count()
+              << ", hedges=" << hedging_policy->hedge_count()
+              << ", hedges won=" << hedging_policy->hedge_won_count()
+              << std::endl;
+  }
   DeleteAllObjects(client, bucket_name, options, object_names);
   std::cout << "# Deleting " << bucket_name << std::endl;
   auto status = client.DeleteBucket(bucket_name);
@@ -257,6 +284,31 @@ void PrintResult(TestResult const& result) {
   }
 }
 
+void PrintLatencySummary(TestResult const& result, bool hedging) {
+  for (auto op : {OP_READ, OP_WRITE}) {
+    std::vector<std::chrono::milliseconds> latencies;
+    for (auto const& r : result) {
+      if (r.op == op && r.success) {
+        latencies.push_back(r.elapsed);
+      }
+    }
+    if (latencies.empty()) {
+      continue;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+      auto rank = std::ceil(p / 100.0 * static_cast<double>(latencies.size()));
+      auto index = std::max(static_cast<std::size_t>(rank), std::size_t(1)) - 1;
+      return latencies[std::min(index, latencies.size() - 1)].count();
+    };
+    std::cout << "# Latency " << ToString(op) << " (hedging=" << std::boolalpha
+              << hedging << "): count=" << latencies.size()
+              << ", p50=" << percentile(50.0) << "ms"
+              << ", p99=" << percentile(99.0) << "ms"
+              << ", p99.9=" << percentile(99.9) << "ms" << std::endl;
+  }
+}
+
 IterationResult WriteCommon(gcs::Client client, std::string const& bucket_name,
                             std::string const& object_name,
                             std::string const& random_data,
@@ -406,18 +458,21 @@ TestResult RunTestThread(gcs::Client const& client,
   return result;
 }
 
-void RunTest(gcs::Client client, std::string const& bucket_name,
-             Options const& options,
-             std::vector<std::string> const& object_names) {
+TestResult RunTest(gcs::Client client, std::string const& bucket_name,
+                   Options const& options,
+                   std::vector<std::string> const& object_names) {
   std::vector<std::future<TestResult>> tasks;
   for (int i = 0; i != options.thread_count; ++i) {
     tasks.emplace_back(std::async(std::launch::async, &RunTestThread, client,
                                   bucket_name, options, object_names));
   }
 
+  TestResult result;
   for (auto& t : tasks) {
-    PrintResult(t.get());
+    auto partial = t.get();
+    result.insert(result.end(), partial.begin(), partial.end());
   }
+  return result;
 }
 
 TestResult DeleteGroup(gcs::Client client,
@@ -482,6 +537,7 @@ std::string Options::ConsumeArg(int& argc, char* argv[], char const* arg_name) {
   std::string const thread_count = "--thread-count=";
   std::string const enable_connection_pool = "--enable-connection-pool=";
   std::string const enable_xml_api = "--enable-xml-api=";
+  std::string const enable_hedging = "--enable-hedging=";
 
   std::string const usage = R""(
 [options] <region>
@@ -492,6 +548,8 @@ The options are:
     --thread-count: the number of threads to use in the benchmark.
     --enable-connection-pool: reuse connections across requests.
     --enable-xml-api: configure read+write operations to use XML API.
+    --enable-hedging: send duplicate requests for slow read operations, and
+       compare the latency with a run without hedging.
 
     region: a Google Cloud Storage region where all the objects used in this
        test will be located.
@@ -542,6 +600,16 @@ The options are:
         error = "Invalid enable-xml-api argument (" + arg + ")";
         break;
       }
+    } else if (0 == argument.rfind(enable_hedging, 0)) {
+      auto arg = argument.substr(enable_hedging.size());
+      if (arg == "true" or arg == "yes" or arg == "1") {
+        this->enable_hedging = true;
+      } else if (arg == "false" or arg == "no" or arg == "0") {
+        this->enable_hedging = false;
+      } else {
+        error = "Invalid enable-hedging argument (" + arg + ")";
+        break;
+      }
     } else {
       return argument;
     }
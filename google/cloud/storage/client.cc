@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/curl_client.h"
 #include "google/cloud/storage/internal/curl_handle.h"
 #include "google/cloud/storage/internal/openssl_util.h"
+#include "google/cloud/storage/internal/upload_checkpoint.h"
 #include "google/cloud/storage/oauth2/service_account_credentials.h"
 #include <openssl/md5.h>
 #include <fstream>
@@ -100,9 +101,60 @@ integrity checks using the DisableMD5Hash() and DisableCrc32cChecksum() options.
   // class checks before calling it.
   std::uint64_t source_size = google::cloud::internal::file_size(file_name);
 
+  if (request.HasOption<UseUploadCheckpoint>()) {
+    source.close();
+    return UploadFileWithCheckpoint(file_name, source_size, request);
+  }
   return UploadStreamResumable(source, source_size, request);
 }
 
+StatusOr<ObjectMetadata> Client::UploadFileWithCheckpoint(
+    std::string const& file_name, std::uint64_t source_size,
+    internal::ResumableUploadRequest request) {
+  auto const checkpoint_path = request.GetOption<UseUploadCheckpoint>().value();
+  internal::UploadCheckpoint checkpoint(
+      request.bucket_name(), request.object_name(), file_name, source_size,
+      request.HasOption<DisableMD5Hash>(),
+      request.HasOption<DisableCrc32cChecksum>());
+
+  std::unique_ptr<internal::ResumableUploadSession> session;
+  auto saved = internal::UploadCheckpoint::Load(checkpoint_path);
+  if (saved && saved->SameUpload(checkpoint)) {
+    request.set_option(RestoreResumableUploadSession(saved->session_id()));
+    auto restored = raw_client()->CreateResumableSession(request);
+    if (restored) {
+      session = std::move(*restored);
+      checkpoint = *std::move(saved);
+    } else if (restored.status().code() != StatusCode::kNotFound) {
+      return std::move(restored).status();
+    } else {
+      GCP_LOG(INFO) << "upload session in checkpoint " << checkpoint_path
+                    << " has expired, starting a new upload";
+    }
+  }
+  if (!session) {
+    request.set_option(NewResumableUploadSession());
+    auto created = raw_client()->CreateResumableSession(request);
+    if (!created) {
+      return std::move(created).status();
+    }
+    session = std::move(*created);
+  }
+
+  std::ifstream source(file_name, std::ios::binary);
+  if (!source.is_open()) {
+    std::string msg = __func__;
+    msg += ": cannot open source file ";
+    msg += file_name;
+    return Status(StatusCode::kNotFound, std::move(msg));
+  }
+  // GCS requires chunks to be a multiple of 256KiB.
+  auto chunk_size = internal::UploadChunkRequest::RoundUpToQuantum(
+      raw_client()->client_options().upload_buffer_size());
+  return internal::UploadWithCheckpoint(*session, source, chunk_size,
+                                        checkpoint, checkpoint_path);
+}
+
 StatusOr<ObjectMetadata> Client::UploadStreamResumable(
     std::istream& source, std::uint64_t source_size,
     internal::ResumableUploadRequest const& request) {
@@ -113,6 +165,10 @@ StatusOr<ObjectMetadata> Client::UploadStreamResumable(
   }
 
   auto session = std::move(*session_status);
+  // A restored session continues from the last byte committed by the service.
+  if (session->next_expected_byte() != 0) {
+    source.seekg(session->next_expected_byte(), std::ios::beg);
+  }
 
   // GCS requires chunks to be a multiple of 256KiB.
   auto chunk_size = internal::UploadChunkRequest::RoundUpToQuantum(
@@ -19,6 +19,10 @@
 #include "google/cloud/internal/throw_delegate.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
+#include "google/cloud/storage/connection_pool_stats.h"
+#include "google/cloud/storage/download_cache.h"
+#include "google/cloud/storage/hedging_policy.h"
+#include "google/cloud/storage/internal/caching_client.h"
 #include "google/cloud/storage/internal/logging_client.h"
 #include "google/cloud/storage/internal/retry_client.h"
 #include "google/cloud/storage/internal/signed_url_requests.h"
@@ -29,6 +33,7 @@
 #include "google/cloud/storage/oauth2/google_credentials.h"
 #include "google/cloud/storage/object_rewriter.h"
 #include "google/cloud/storage/object_stream.h"
+#include "google/cloud/storage/rate_limiting_policy.h"
 #include "google/cloud/storage/retry_policy.h"
 #include "google/cloud/storage/upload_options.h"
 
@@ -168,6 +173,17 @@ inline namespace STORAGE_CLIENT_NS {
  *
  * @see `AlwaysRetryIdempotencyPolicy` and `StrictIdempotencyPolicy` for
  * alternative idempotency policies.
+ *
+ * @see `PercentileHedgingPolicy` to send duplicate requests for slow
+ * `ReadObject()` and `GetObjectMetadata()` calls. Hedging is disabled by
+ * default.
+ *
+ * @see `AimdRateLimitingPolicy` to ramp up the request rate gradually and
+ * queue requests when the service throttles them. Rate limiting is disabled
+ * by default.
+ *
+ * @see `DownloadCache` to keep the contents of downloaded objects in a local
+ * directory. Downloads are not cached by default.
  */
 class Client {
  public:
@@ -236,6 +252,18 @@ class Client {
     return raw_client_;
   }
 
+  /**
+   * Return the counters for the connection pools used by this client.
+   *
+   * Use these counters to tune `ClientOptions::connection_pool_size()`,
+   * `connection_pool_prewarm_size()` and `maximum_connection_idle_time()`: a
+   * high miss count means the pool is too small, a high eviction count means
+   * connections are closed (and later reopened) too eagerly.
+   */
+  ConnectionPoolStats connection_pool_stats() const {
+    return raw_client_->connection_pool_stats();
+  }
+
   //@{
   /**
    * @name Bucket operations.
@@ -965,7 +993,8 @@ class Client {
    *   `Crc32cChecksumValue`, `DisableCrc32cChecksum`, `DisableMD5Hash`,
    *   `EncryptionKey`, `IfGenerationMatch`, `IfGenerationNotMatch`,
    *   `IfMetagenerationMatch`, `IfMetagenerationNotMatch`, `KmsKeyName`,
-   *   `MD5HashValue`, `PredefinedAcl`, `Projection`, `UserProject`, and
+   *   `MD5HashValue`, `PredefinedAcl`, `Projection`,
+   *   `UseResumableUploadSession`, `UseUploadCheckpoint`, `UserProject`, and
    *   `WithObjectMetadata`.
    *
    * @par Idempotency
@@ -977,6 +1006,15 @@ class Client {
    *
    * @par Example: manually selecting a resumable upload
    * @snippet storage_object_samples.cc upload file resumable
+   *
+   * @par Example: resuming an upload after a restart
+   * @code
+   * // If the program crashes, running it again continues the upload from the
+   * // last chunk committed by the service.
+   * auto metadata = client.UploadFile(
+   *     "/data/large.bin", "my-bucket", "large.bin",
+   *     gcs::UseUploadCheckpoint("/data/large.bin.upload"));
+   * @endcode
    */
   template <typename... Options>
   StatusOr<ObjectMetadata> UploadFile(std::string const& file_name,
@@ -988,7 +1026,8 @@ class Client {
     // does not support (nor should it support) the UseResumableUploadSession
     // option.
     using HasUseResumableUpload = google::cloud::internal::disjunction<
-        std::is_same<UseResumableUploadSession, Options>...>;
+        std::is_same<UseResumableUploadSession, Options>...,
+        std::is_same<UseUploadCheckpoint, Options>...>;
     return UploadFileImpl(file_name, bucket_name, object_name,
                           HasUseResumableUpload{},
                           std::forward<Options>(options)...);
@@ -2472,9 +2511,14 @@ class Client {
   std::shared_ptr<internal::RawClient> Decorate(
       std::shared_ptr<internal::RawClient> client, Policies&&... policies) {
     auto logging = std::make_shared<internal::LoggingClient>(std::move(client));
-    auto retry = std::make_shared<internal::RetryClient>(
-        std::move(logging), std::forward<Policies>(policies)...);
-    return retry;
+    auto retry =
+        std::make_shared<internal::RetryClient>(std::move(logging), policies...);
+    auto cache = internal::FindDownloadCache(policies...);
+    if (!cache) {
+      return retry;
+    }
+    return std::make_shared<internal::CachingClient>(std::move(retry),
+                                                     std::move(cache));
   }
 
   // The version of UploadFile() where UseResumableUploadSession is one of the
@@ -2522,6 +2566,10 @@ class Client {
       std::istream& source, std::uint64_t source_size,
       internal::ResumableUploadRequest const& request);
 
+  StatusOr<ObjectMetadata> UploadFileWithCheckpoint(
+      std::string const& file_name, std::uint64_t source_size,
+      internal::ResumableUploadRequest request);
+
   Status DownloadFileImpl(internal::ReadObjectRangeRequest const& request,
                           std::string const& file_name);
 
@@ -17,6 +17,7 @@
 
 #include "google/cloud/internal/throw_delegate.h"
 #include "google/cloud/storage/oauth2/credentials.h"
+#include <chrono>
 #include <memory>
 
 namespace google {
@@ -98,6 +99,57 @@ class ClientOptions {
     return *this;
   }
 
+  /**
+   * The number of connections created when the client is constructed.
+   *
+   * Pre-warming the connection pool creates the handles and, in a background
+   * thread, makes a lightweight request on each one concurrently. This
+   * resolves the endpoint name and opens (and performs the TLS handshake for)
+   * one connection per handle, so the first requests after the client is
+   * created do not pay for these costs. The value is capped to
+   * `connection_pool_size()`, the default is 0, i.e., no pre-warming.
+   */
+  std::size_t connection_pool_prewarm_size() const {
+    return connection_pool_prewarm_size_;
+  }
+  ClientOptions& set_connection_pool_prewarm_size(std::size_t size) {
+    connection_pool_prewarm_size_ = size;
+    return *this;
+  }
+
+  /**
+   * The maximum time spent pre-warming the connection pool.
+   *
+   * Pre-warming runs in the background, any connections not established
+   * before this timeout are abandoned. Destroying the client stops the
+   * pre-warming early. The default is 5 seconds.
+   */
+  std::chrono::milliseconds connection_pool_prewarm_timeout() const {
+    return connection_pool_prewarm_timeout_;
+  }
+  ClientOptions& set_connection_pool_prewarm_timeout(
+      std::chrono::milliseconds v) {
+    connection_pool_prewarm_timeout_ = v;
+    return *this;
+  }
+
+  /**
+   * Connections idle for longer than this time are not reused.
+   *
+   * libcurl closes these connections the next time the client looks for a
+   * connection to reuse, and the connection pool releases the handles idle
+   * for longer than this time. libcurl measures the connection idle time in
+   * seconds, the value is rounded up. The default, zero, uses the libcurl
+   * default, and keeps the pooled handles until the client is destroyed.
+   */
+  std::chrono::milliseconds maximum_connection_idle_time() const {
+    return maximum_connection_idle_time_;
+  }
+  ClientOptions& set_maximum_connection_idle_time(std::chrono::milliseconds v) {
+    maximum_connection_idle_time_ = v;
+    return *this;
+  }
+
   std::size_t download_buffer_size() const { return download_buffer_size_; }
   ClientOptions& SetDownloadBufferSize(std::size_t size);
 
@@ -146,6 +198,11 @@ class ClientOptions {
   bool enable_raw_client_tracing_;
   std::string project_id_;
   std::size_t connection_pool_size_;
+  std::size_t connection_pool_prewarm_size_ = 0;
+  std::chrono::milliseconds connection_pool_prewarm_timeout_ =
+      std::chrono::seconds(5);
+  std::chrono::milliseconds maximum_connection_idle_time_ =
+      std::chrono::milliseconds(0);
   std::size_t download_buffer_size_;
   std::size_t upload_buffer_size_;
   std::string user_agent_prefix_;
@@ -13,12 +13,16 @@
 // limitations under the License.
 
 #include "google/cloud/storage/client.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/internal/random.h"
 #include "google/cloud/storage/internal/curl_client.h"
 #include "google/cloud/storage/oauth2/google_credentials.h"
 #include "google/cloud/storage/retry_policy.h"
 #include "google/cloud/storage/testing/canonical_errors.h"
 #include "google/cloud/storage/testing/mock_client.h"
 #include <gmock/gmock.h>
+#include <cstdio>
+#include <fstream>
 
 namespace google {
 namespace cloud {
@@ -26,7 +30,9 @@ namespace storage {
 inline namespace STORAGE_CLIENT_NS {
 namespace {
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
+using ::testing::ReturnRef;
 using testing::canonical_errors::TransientError;
 
 class ObservableRetryPolicy : public LimitedErrorCountRetryPolicy {
@@ -144,6 +150,60 @@ TEST_F(ClientTest, DefaultDecorators) {
   ASSERT_TRUE(curl != nullptr);
 }
 
+/// @test Verify that UploadFile() skips the data committed by a restored
+/// session.
+TEST_F(ClientTest, UploadFileRestoredSession) {
+  auto const quantum = internal::UploadChunkRequest::kChunkSizeQuantum;
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  auto const file_name =
+      ::testing::TempDir() + "client-test-" +
+      google::cloud::internal::Sample(generator, 16,
+                                      "abcdefghijklmnopqrstuvwxyz0123456789");
+  auto const contents = google::cloud::internal::Sample(
+      generator, static_cast<int>(2 * quantum + 10), "0123456789");
+  std::ofstream(file_name, std::ios::binary) << contents;
+
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  // Upload the rest of the file in a single chunk.
+  client_options.SetUploadBufferSize(4 * quantum);
+  EXPECT_CALL(*mock, client_options())
+      .WillRepeatedly(ReturnRef(client_options));
+
+  std::uint64_t committed = quantum;
+  EXPECT_CALL(*mock, CreateResumableSession(_))
+      .WillOnce(Invoke([&](internal::ResumableUploadRequest const& request) {
+        EXPECT_EQ("test-session-id",
+                  request.GetOption<UseResumableUploadSession>().value());
+        auto session = google::cloud::internal::make_unique<
+            testing::MockResumableUploadSession>();
+        EXPECT_CALL(*session, next_expected_byte())
+            .WillRepeatedly(Invoke([&committed] { return committed; }));
+        EXPECT_CALL(*session, UploadChunk(_, _))
+            .WillOnce(Invoke([&](std::string const& buffer,
+                                 std::uint64_t upload_size) {
+              // Only the data not committed by the service is uploaded.
+              EXPECT_EQ(contents.substr(quantum), buffer);
+              EXPECT_EQ(contents.size(), upload_size);
+              committed = upload_size;
+              return make_status_or(internal::ResumableUploadResponse{
+                  "", upload_size - 1, R"""({"name": "test-object-name"})"""});
+            }));
+        return make_status_or(
+            std::unique_ptr<internal::ResumableUploadSession>(
+                std::move(session)));
+      }));
+
+  Client client{std::shared_ptr<internal::RawClient>(mock),
+                Client::NoDecorations{}};
+  auto actual = client.UploadFile(
+      file_name, "test-bucket-name", "test-object-name",
+      RestoreResumableUploadSession("test-session-id"));
+  ASSERT_TRUE(actual.ok()) << "status=" << actual.status();
+  EXPECT_EQ("test-object-name", actual->name());
+
+  std::remove(file_name.c_str());
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
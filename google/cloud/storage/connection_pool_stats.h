@@ -0,0 +1,59 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CONNECTION_POOL_STATS_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CONNECTION_POOL_STATS_H_
+
+#include "google/cloud/storage/version.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Counters for the connection pools used by a `storage::Client`.
+ *
+ * The values are cumulative since the client was created, except for
+ * `idle_handles`, which is the number of handles in the pools at the time the
+ * stats were collected. All the values are zero if the client does not use a
+ * connection pool, i.e., when `ClientOptions::connection_pool_size()` is 0.
+ */
+struct ConnectionPoolStats {
+  /// The number of requests that used a handle from the pool.
+  std::uint64_t hit_count;
+  /// The number of requests that had to create a new handle.
+  std::uint64_t miss_count;
+  /// The number of handles released because they were idle for too long.
+  std::uint64_t idle_eviction_count;
+  /// The number of handles currently in the pool.
+  std::size_t idle_handles;
+};
+
+inline ConnectionPoolStats& operator+=(ConnectionPoolStats& lhs,
+                                       ConnectionPoolStats const& rhs) {
+  lhs.hit_count += rhs.hit_count;
+  lhs.miss_count += rhs.miss_count;
+  lhs.idle_eviction_count += rhs.idle_eviction_count;
+  lhs.idle_handles += rhs.idle_handles;
+  return lhs;
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_CONNECTION_POOL_STATS_H_
@@ -0,0 +1,326 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/download_cache.h"
+#include "google/cloud/internal/random.h"
+#include <openssl/sha.h>
+#include <sys/types.h>
+// The order of these two includes cannot be changed.
+#include <sys/stat.h>
+#if _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif  // _WIN32
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+/// The suffix for files that are still being downloaded.
+char const kTemporarySuffix[] = ".tmp";
+/// Temporary files older than this are left over from a crash.
+auto const kStaleTemporaryFile = std::chrono::hours(1);
+/// Discard expired generations once the cache remembers this many objects.
+std::size_t const kMaximumTrustedObjects = 100000;
+
+#if _WIN32
+using os_stat_type = struct ::_stat;
+int OsStat(std::string const& path, os_stat_type& s) {
+  return ::_stat(path.c_str(), &s);
+}
+#else
+using os_stat_type = struct stat;
+int OsStat(std::string const& path, os_stat_type& s) {
+  return ::stat(path.c_str(), &s);
+}
+#endif  // _WIN32
+
+struct FileInfo {
+  std::string name;
+  std::uint64_t size;
+  std::time_t modified;
+};
+
+/// Return the regular files in @p directory.
+std::vector<FileInfo> ListFiles(std::string const& directory) {
+  std::vector<std::string> names;
+#if _WIN32
+  WIN32_FIND_DATAA data;
+  HANDLE handle = ::FindFirstFileA((directory + "/*").c_str(), &data);
+  if (handle != INVALID_HANDLE_VALUE) {
+    do {
+      names.emplace_back(data.cFileName);
+    } while (::FindNextFileA(handle, &data));
+    ::FindClose(handle);
+  }
+#else
+  DIR* dir = ::opendir(directory.c_str());
+  if (dir != nullptr) {
+    for (auto* entry = ::readdir(dir); entry != nullptr;
+         entry = ::readdir(dir)) {
+      names.emplace_back(entry->d_name);
+    }
+    ::closedir(dir);
+  }
+#endif  // _WIN32
+  std::vector<FileInfo> files;
+  for (auto& name : names) {
+    os_stat_type s;
+    if (OsStat(directory + "/" + name, s) != 0 ||
+        (s.st_mode & S_IFMT) != S_IFREG) {
+      continue;
+    }
+    files.push_back(FileInfo{std::move(name),
+                             static_cast<std::uint64_t>(s.st_size),
+                             s.st_mtime});
+  }
+  return files;
+}
+
+void MakeDirectory(std::string const& directory) {
+  // Errors are ignored, if the directory is unusable the downloads simply
+  // bypass the cache.
+#if _WIN32
+  ::_mkdir(directory.c_str());
+#else
+  ::mkdir(directory.c_str(), 0700);
+#endif  // _WIN32
+}
+
+bool IsCacheFileName(std::string const& name) {
+  return name.size() == 2 * SHA256_DIGEST_LENGTH &&
+         name.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+bool EndsWith(std::string const& value, std::string const& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+}  // namespace
+
+DownloadCache::DownloadCache(std::string directory,
+                             std::uint64_t maximum_size_bytes,
+                             std::chrono::seconds trust_period)
+    : directory_(std::move(directory)),
+      maximum_size_bytes_(maximum_size_bytes),
+      trust_period_(trust_period),
+      temporary_count_(0) {
+  auto generator = google::cloud::internal::MakeDefaultPRNG();
+  temporary_prefix_ = google::cloud::internal::Sample(
+      generator, 16, "abcdefghijklmnopqrstuvwxyz0123456789");
+  MakeDirectory(directory_);
+  LoadDirectory();
+}
+
+std::string DownloadCache::Lookup(std::string const& bucket_name,
+                                  std::string const& object_name,
+                                  std::int64_t generation) {
+  auto file_name = FileName(bucket_name, object_name, generation);
+  auto path = Path(file_name);
+  os_stat_type s;
+  bool exists = OsStat(path, s) == 0;
+
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = entries_.find(file_name);
+  if (!exists) {
+    // Another process sharing the directory may have removed the file.
+    if (i != entries_.end()) {
+      RemoveUnlocked(i);
+    }
+    ++stats_.miss_count;
+    return std::string{};
+  }
+  if (i == entries_.end()) {
+    // Another process sharing the directory may have added the file.
+    AddUnlocked(file_name, static_cast<std::uint64_t>(s.st_size));
+  } else {
+    lru_.splice(lru_.begin(), lru_, i->second.lru);
+  }
+  ++stats_.hit_count;
+  return path;
+}
+
+std::string DownloadCache::MakeTemporaryPath() {
+  std::lock_guard<std::mutex> lk(mu_);
+  return Path(temporary_prefix_ + "-" + std::to_string(++temporary_count_) +
+              kTemporarySuffix);
+}
+
+Status DownloadCache::Insert(std::string const& bucket_name,
+                             std::string const& object_name,
+                             std::int64_t generation,
+                             std::string const& temporary_path,
+                             std::uint64_t size) {
+  auto file_name = FileName(bucket_name, object_name, generation);
+  if (size > maximum_size_bytes_) {
+    std::remove(temporary_path.c_str());
+    return Status(StatusCode::kOutOfRange,
+                  "object is larger than the download cache");
+  }
+  std::lock_guard<std::mutex> lk(mu_);
+  auto path = Path(file_name);
+  if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    // On some platforms rename() fails if the destination exists, that is
+    // fine, the contents of an object generation never change.
+    std::remove(temporary_path.c_str());
+    return Status(StatusCode::kUnavailable,
+                  "cannot rename " + temporary_path + " to " + path);
+  }
+  auto i = entries_.find(file_name);
+  if (i != entries_.end()) {
+    RemoveUnlocked(i);
+  }
+  AddUnlocked(file_name, size);
+  ++stats_.insert_count;
+  EvictUnlocked();
+  return Status();
+}
+
+bool DownloadCache::TrustedGeneration(std::string const& bucket_name,
+                                      std::string const& object_name,
+                                      std::int64_t& generation,
+                                      Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = trusted_.find(ObjectKey(bucket_name, object_name));
+  if (i == trusted_.end() || i->second.expiration <= now) {
+    return false;
+  }
+  generation = i->second.generation;
+  return true;
+}
+
+void DownloadCache::OnValidation(std::string const& bucket_name,
+                                 std::string const& object_name,
+                                 std::int64_t generation,
+                                 Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  ++stats_.validation_count;
+  if (trust_period_.count() <= 0) {
+    return;
+  }
+  if (trusted_.size() >= kMaximumTrustedObjects) {
+    for (auto i = trusted_.begin(); i != trusted_.end();) {
+      if (i->second.expiration <= now) {
+        i = trusted_.erase(i);
+      } else {
+        ++i;
+      }
+    }
+  }
+  trusted_[ObjectKey(bucket_name, object_name)] =
+      TrustedEntry{generation, now + trust_period_};
+}
+
+void DownloadCache::Invalidate(std::string const& bucket_name,
+                               std::string const& object_name) {
+  std::lock_guard<std::mutex> lk(mu_);
+  trusted_.erase(ObjectKey(bucket_name, object_name));
+}
+
+DownloadCacheStats DownloadCache::stats() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return stats_;
+}
+
+std::string DownloadCache::FileName(std::string const& bucket_name,
+                                    std::string const& object_name,
+                                    std::int64_t generation) const {
+  // Object names can be longer than the file names supported by most file
+  // systems, use a hash of the object name and generation instead.
+  std::string key = bucket_name;
+  key.push_back('\0');
+  key += object_name;
+  key.push_back('\0');
+  key += std::to_string(generation);
+
+  unsigned char hash[SHA256_DIGEST_LENGTH];
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  SHA256_Update(&sha256, key.c_str(), key.size());
+  SHA256_Final(hash, &sha256);
+
+  char const digits[] = "0123456789abcdef";
+  std::string result;
+  result.reserve(2 * SHA256_DIGEST_LENGTH);
+  for (auto c : hash) {
+    result.push_back(digits[(c >> 4) & 0xf]);
+    result.push_back(digits[c & 0xf]);
+  }
+  return result;
+}
+
+std::string DownloadCache::Path(std::string const& file_name) const {
+  return directory_ + "/" + file_name;
+}
+
+void DownloadCache::LoadDirectory() {
+  auto files = ListFiles(directory_);
+  auto const stale =
+      std::time(nullptr) -
+      std::chrono::duration_cast<std::chrono::seconds>(kStaleTemporaryFile)
+          .count();
+  // Add the oldest files first, so they are the first to be evicted.
+  std::sort(files.begin(), files.end(),
+            [](FileInfo const& a, FileInfo const& b) {
+              return a.modified < b.modified;
+            });
+  std::lock_guard<std::mutex> lk(mu_);
+  for (auto const& f : files) {
+    if (IsCacheFileName(f.name)) {
+      AddUnlocked(f.name, f.size);
+    } else if (EndsWith(f.name, kTemporarySuffix) && f.modified < stale) {
+      std::remove(Path(f.name).c_str());
+    }
+  }
+  EvictUnlocked();
+}
+
+void DownloadCache::AddUnlocked(std::string const& file_name,
+                                std::uint64_t size) {
+  lru_.push_front(file_name);
+  entries_[file_name] = Entry{size, lru_.begin()};
+  ++stats_.entry_count;
+  stats_.size_bytes += size;
+}
+
+void DownloadCache::RemoveUnlocked(
+    std::map<std::string, Entry>::iterator entry) {
+  --stats_.entry_count;
+  stats_.size_bytes -= entry->second.size;
+  lru_.erase(entry->second.lru);
+  entries_.erase(entry);
+}
+
+void DownloadCache::EvictUnlocked() {
+  while (stats_.size_bytes > maximum_size_bytes_ && !lru_.empty()) {
+    auto i = entries_.find(lru_.back());
+    // Readers that have the file open keep reading it on POSIX systems.
+    std::remove(Path(i->first).c_str());
+    RemoveUnlocked(i);
+    ++stats_.eviction_count;
+  }
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
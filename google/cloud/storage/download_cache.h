@@ -0,0 +1,191 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_DOWNLOAD_CACHE_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_DOWNLOAD_CACHE_H_
+
+#include "google/cloud/status.h"
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/// The counters for a `DownloadCache`.
+struct DownloadCacheStats {
+  /// The downloads served from the cache.
+  std::uint64_t hit_count = 0;
+  /// The downloads sent to the service.
+  std::uint64_t miss_count = 0;
+  /// The object generations added to the cache.
+  std::uint64_t insert_count = 0;
+  /// The object generations removed to stay within the size budget.
+  std::uint64_t eviction_count = 0;
+  /// The metadata requests used to find the current generation of an object.
+  std::uint64_t validation_count = 0;
+  /// The number of cached object generations.
+  std::uint64_t entry_count = 0;
+  /// The total size of the cached object generations.
+  std::uint64_t size_bytes = 0;
+};
+
+/**
+ * Cache the contents of downloaded objects in a local directory.
+ *
+ * Each object generation is immutable, so its contents can be cached safely.
+ * Pass a `std::shared_ptr<DownloadCache>` to the `Client` constructor and
+ * `ReadObject()` (and therefore `DownloadToFile()`) read from the cache when
+ * possible:
+ *
+ * - If the request names a `Generation` the cached copy is used directly.
+ * - Otherwise the client fetches the object metadata to find the current
+ *   generation. With a non-zero @p trust_period the last generation seen for
+ *   an object is used, without any requests, for that long.
+ * - Ranged reads are served from the cache if the object is already cached,
+ *   but do not populate it.
+ * - Reads using customer-supplied encryption keys bypass the cache, their
+ *   contents are never stored on disk.
+ *
+ * Objects are downloaded to a temporary file in the cache directory, and
+ * renamed into place once the download completes successfully, so a cached
+ * file is never partially written. The least recently used files are removed
+ * when the cache exceeds @p maximum_size_bytes. Files left by previous runs of
+ * the program are found when the cache is created.
+ *
+ * @par Example
+ * @code
+ * auto cache = std::make_shared<gcs::DownloadCache>(
+ *     "/var/cache/my-models", 16LL * 1024 * 1024 * 1024,
+ *     std::chrono::minutes(5));
+ * gcs::Client client(gcs::ClientOptions(credentials), cache);
+ * client.DownloadToFile("my-bucket", "model.bin", "/tmp/model.bin");
+ * @endcode
+ *
+ * @note This class is thread-safe. Several processes may share the same
+ *     directory, but each one enforces the size budget on its own.
+ */
+class DownloadCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Create a cache, creating @p directory if needed.
+   *
+   * @param directory where to store the cached files.
+   * @param maximum_size_bytes the total size of the cached files.
+   * @param trust_period how long to use the last generation seen for an object
+   *     without checking for newer generations.
+   */
+  DownloadCache(std::string directory, std::uint64_t maximum_size_bytes,
+                std::chrono::seconds trust_period = std::chrono::seconds(0));
+
+  DownloadCache(DownloadCache const&) = delete;
+  DownloadCache& operator=(DownloadCache const&) = delete;
+
+  std::string const& directory() const { return directory_; }
+  std::uint64_t maximum_size_bytes() const { return maximum_size_bytes_; }
+  std::chrono::seconds trust_period() const { return trust_period_; }
+
+  /**
+   * Return the file with the contents of an object generation.
+   *
+   * @return the path of the cached file, or an empty string if the generation
+   *     is not cached.
+   */
+  std::string Lookup(std::string const& bucket_name,
+                     std::string const& object_name, std::int64_t generation);
+
+  /// Return the path for a new temporary file in the cache directory.
+  std::string MakeTemporaryPath();
+
+  /**
+   * Atomically publish a downloaded object generation.
+   *
+   * Renames @p temporary_path into the cache, and removes the least recently
+   * used files if the cache exceeds its size budget. The temporary file is
+   * removed on failure.
+   */
+  Status Insert(std::string const& bucket_name, std::string const& object_name,
+                std::int64_t generation, std::string const& temporary_path,
+                std::uint64_t size);
+
+  /**
+   * Return the generation of an object if it was seen recently enough.
+   *
+   * @return true and sets @p generation if the object was validated less than
+   *     `trust_period()` ago.
+   */
+  bool TrustedGeneration(std::string const& bucket_name,
+                         std::string const& object_name,
+                         std::int64_t& generation,
+                         Clock::time_point now = Clock::now());
+
+  /// Record the current generation of an object, as reported by the service.
+  void OnValidation(std::string const& bucket_name,
+                    std::string const& object_name, std::int64_t generation,
+                    Clock::time_point now = Clock::now());
+
+  /// Forget the generation of an object modified through the client.
+  void Invalidate(std::string const& bucket_name,
+                  std::string const& object_name);
+
+  DownloadCacheStats stats() const;
+
+ private:
+  using ObjectKey = std::pair<std::string, std::string>;
+  struct Entry {
+    std::uint64_t size;
+    std::list<std::string>::iterator lru;
+  };
+  struct TrustedEntry {
+    std::int64_t generation;
+    Clock::time_point expiration;
+  };
+
+  std::string FileName(std::string const& bucket_name,
+                       std::string const& object_name,
+                       std::int64_t generation) const;
+  std::string Path(std::string const& file_name) const;
+  void LoadDirectory();
+  void AddUnlocked(std::string const& file_name, std::uint64_t size);
+  void RemoveUnlocked(std::map<std::string, Entry>::iterator entry);
+  void EvictUnlocked();
+
+  std::string const directory_;
+  std::uint64_t const maximum_size_bytes_;
+  std::chrono::seconds const trust_period_;
+
+  mutable std::mutex mu_;
+  std::map<std::string, Entry> entries_;
+  // The file names, the most recently used at the front.
+  std::list<std::string> lru_;
+  std::map<ObjectKey, TrustedEntry> trusted_;
+  DownloadCacheStats stats_;
+  std::string temporary_prefix_;
+  std::uint64_t temporary_count_;
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_DOWNLOAD_CACHE_H_
@@ -0,0 +1,158 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/download_cache.h"
+#include "google/cloud/internal/random.h"
+#include <gmock/gmock.h>
+#include <fstream>
+#include <iterator>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+
+class DownloadCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto generator = google::cloud::internal::MakeDefaultPRNG();
+    directory_ = ::testing::TempDir() + "download-cache-" +
+                 google::cloud::internal::Sample(
+                     generator, 16, "abcdefghijklmnopqrstuvwxyz0123456789");
+  }
+
+  /// Insert an object generation with the given contents.
+  Status Insert(DownloadCache& cache, std::string const& object_name,
+                std::int64_t generation, std::string const& contents) {
+    auto temporary = cache.MakeTemporaryPath();
+    std::ofstream(temporary, std::ios::binary) << contents;
+    return cache.Insert("test-bucket", object_name, generation, temporary,
+                        contents.size());
+  }
+
+  static std::string ReadFile(std::string const& path) {
+    std::ifstream is(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), {});
+  }
+
+  std::string directory_;
+};
+
+TEST_F(DownloadCacheTest, InsertAndLookup) {
+  DownloadCache cache(directory_, 1024);
+  EXPECT_EQ("", cache.Lookup("test-bucket", "foo", 1));
+
+  ASSERT_TRUE(Insert(cache, "foo", 1, "the contents").ok());
+  auto path = cache.Lookup("test-bucket", "foo", 1);
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ("the contents", ReadFile(path));
+  // Other generations, and other objects, are not cached.
+  EXPECT_EQ("", cache.Lookup("test-bucket", "foo", 2));
+  EXPECT_EQ("", cache.Lookup("test-bucket", "bar", 1));
+
+  auto stats = cache.stats();
+  EXPECT_EQ(1U, stats.hit_count);
+  EXPECT_EQ(3U, stats.miss_count);
+  EXPECT_EQ(1U, stats.insert_count);
+  EXPECT_EQ(1U, stats.entry_count);
+  EXPECT_EQ(12U, stats.size_bytes);
+}
+
+TEST_F(DownloadCacheTest, EvictLeastRecentlyUsed) {
+  DownloadCache cache(directory_, 20);
+  ASSERT_TRUE(Insert(cache, "a", 1, "0123456789").ok());
+  ASSERT_TRUE(Insert(cache, "b", 1, "0123456789").ok());
+  // Make "a" the most recently used object, "b" is evicted next.
+  EXPECT_NE("", cache.Lookup("test-bucket", "a", 1));
+  ASSERT_TRUE(Insert(cache, "c", 1, "0123456789").ok());
+
+  EXPECT_NE("", cache.Lookup("test-bucket", "a", 1));
+  EXPECT_EQ("", cache.Lookup("test-bucket", "b", 1));
+  EXPECT_NE("", cache.Lookup("test-bucket", "c", 1));
+  auto stats = cache.stats();
+  EXPECT_EQ(1U, stats.eviction_count);
+  EXPECT_EQ(2U, stats.entry_count);
+  EXPECT_EQ(20U, stats.size_bytes);
+}
+
+TEST_F(DownloadCacheTest, RejectTooLarge) {
+  DownloadCache cache(directory_, 4);
+  auto status = Insert(cache, "foo", 1, "too large");
+  EXPECT_EQ(StatusCode::kOutOfRange, status.code());
+  EXPECT_EQ("", cache.Lookup("test-bucket", "foo", 1));
+  EXPECT_EQ(0U, cache.stats().entry_count);
+}
+
+TEST_F(DownloadCacheTest, TrustedGeneration) {
+  using std::chrono::seconds;
+  DownloadCache cache(directory_, 1024, seconds(10));
+  auto const now = DownloadCache::Clock::now();
+  std::int64_t generation = 0;
+  EXPECT_FALSE(cache.TrustedGeneration("test-bucket", "foo", generation, now));
+
+  cache.OnValidation("test-bucket", "foo", 42, now);
+  EXPECT_TRUE(cache.TrustedGeneration("test-bucket", "foo", generation,
+                                      now + seconds(5)));
+  EXPECT_EQ(42, generation);
+  EXPECT_FALSE(cache.TrustedGeneration("test-bucket", "foo", generation,
+                                       now + seconds(10)));
+
+  cache.OnValidation("test-bucket", "foo", 43, now);
+  cache.Invalidate("test-bucket", "foo");
+  EXPECT_FALSE(cache.TrustedGeneration("test-bucket", "foo", generation, now));
+  EXPECT_EQ(2U, cache.stats().validation_count);
+}
+
+TEST_F(DownloadCacheTest, NoTrustPeriod) {
+  DownloadCache cache(directory_, 1024);
+  cache.OnValidation("test-bucket", "foo", 42);
+  std::int64_t generation = 0;
+  EXPECT_FALSE(cache.TrustedGeneration("test-bucket", "foo", generation));
+}
+
+TEST_F(DownloadCacheTest, LoadExistingFiles) {
+  {
+    DownloadCache cache(directory_, 1024);
+    ASSERT_TRUE(Insert(cache, "foo", 1, "the contents").ok());
+    // Abandoned downloads are not part of the cache.
+    std::ofstream(cache.MakeTemporaryPath()) << "partial";
+  }
+  DownloadCache cache(directory_, 1024);
+  auto stats = cache.stats();
+  EXPECT_EQ(1U, stats.entry_count);
+  EXPECT_EQ(12U, stats.size_bytes);
+  auto path = cache.Lookup("test-bucket", "foo", 1);
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ("the contents", ReadFile(path));
+}
+
+TEST_F(DownloadCacheTest, RemovedFile) {
+  DownloadCache cache(directory_, 1024);
+  ASSERT_TRUE(Insert(cache, "foo", 1, "the contents").ok());
+  auto path = cache.Lookup("test-bucket", "foo", 1);
+  ASSERT_FALSE(path.empty());
+  std::remove(path.c_str());
+
+  EXPECT_EQ("", cache.Lookup("test-bucket", "foo", 1));
+  auto stats = cache.stats();
+  EXPECT_EQ(0U, stats.entry_count);
+  EXPECT_EQ(0U, stats.size_bytes);
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
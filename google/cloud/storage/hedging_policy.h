@@ -0,0 +1,47 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_HEDGING_POLICY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_HEDGING_POLICY_H_
+
+#include "google/cloud/internal/hedging_policy.h"
+#include "google/cloud/storage/version.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * The hedging policy base class.
+ *
+ * The library hedges `ReadObject()` and `GetObjectMetadata()` calls when the
+ * `Client` is configured with a hedging policy. Operations that are not
+ * idempotent, as determined by the `IdempotencyPolicy`, are never hedged.
+ *
+ * A hedged `ReadObject()` waits for the first chunk of data (the full object,
+ * for small objects) before it returns, and the policy observes the latency
+ * to that point. The rest of the download is not hedged.
+ */
+using HedgingPolicy = google::cloud::internal::HedgingPolicy;
+
+/// Hedge requests slower than a given latency percentile.
+using PercentileHedgingPolicy =
+    google::cloud::internal::PercentileHedgingPolicy;
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_HEDGING_POLICY_H_
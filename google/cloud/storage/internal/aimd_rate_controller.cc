@@ -0,0 +1,181 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/aimd_rate_controller.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+/// The rate never drops below this value, in requests per second.
+double const kMinimumRate = 1.0;
+/// Throttling errors within this period after a reduction are ignored.
+auto const kDecreaseCooldown = std::chrono::seconds(1);
+/// The window used to measure the accepted requests per second.
+auto const kWindow = std::chrono::seconds(1);
+/// Start discarding idle keys once the controller tracks this many keys.
+std::size_t const kMaximumIdleKeys = 4096;
+/// Keys without requests for this long are discarded.
+auto const kIdleTimeout = std::chrono::minutes(5);
+
+double ToSeconds(AimdRateController::Clock::duration d) {
+  return std::chrono::duration<double>(d).count();
+}
+}  // namespace
+
+AimdRateController::AimdRateController(double initial_rate,
+                                       double maximum_rate, double ramp_up,
+                                       double backoff_factor)
+    : initial_rate_(std::max(initial_rate, kMinimumRate)),
+      maximum_rate_(std::max(maximum_rate, initial_rate_)),
+      ramp_up_(std::max(ramp_up, 0.0)),
+      backoff_factor_(std::min(std::max(backoff_factor, 0.0), 1.0)),
+      window_start_(),
+      window_count_(0),
+      previous_window_count_(0) {}
+
+AimdRateController::Clock::duration AimdRateController::Reserve(
+    std::string const& key, Clock::time_point now) {
+  return *TryReserve(key, now, std::chrono::milliseconds::max());
+}
+
+google::cloud::optional<AimdRateController::Clock::duration>
+AimdRateController::TryReserve(std::string const& key, Clock::time_point now,
+                               std::chrono::milliseconds maximum_delay) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& state = FindOrCreate(key, now);
+  // Only grow the rate while it is limiting the requests, otherwise an idle
+  // key would accumulate a rate it has never been tested at.
+  if (state.next_slot > now && now > state.last_update &&
+      now - state.last_decrease >= kDecreaseCooldown) {
+    auto elapsed = ToSeconds(now - state.last_update);
+    state.rate = std::min(maximum_rate_, state.rate + ramp_up_ * elapsed);
+  }
+  state.last_update = std::max(state.last_update, now);
+
+  auto slot = std::max(now, state.next_slot);
+  // Compare in milliseconds, converting `maximum_delay` to the clock duration
+  // could overflow.
+  if (std::chrono::duration_cast<std::chrono::milliseconds>(slot - now) >
+      maximum_delay) {
+    ++stats_.rejected_count;
+    return {};
+  }
+  state.next_slot =
+      slot + std::chrono::duration_cast<Clock::duration>(
+                 std::chrono::duration<double>(1.0 / state.rate));
+
+  auto delay = slot - now;
+  auto delay_us = std::chrono::duration_cast<std::chrono::microseconds>(delay);
+  ++stats_.admitted_count;
+  stats_.total_queue_delay += delay_us;
+  stats_.max_queue_delay = std::max(stats_.max_queue_delay, delay_us);
+  return google::cloud::optional<Clock::duration>(delay);
+}
+
+void AimdRateController::OnCompletion(std::string const& key, bool throttled,
+                                      Clock::time_point now) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!throttled) {
+    ++stats_.accepted_count;
+    AdvanceWindow(now);
+    ++window_count_;
+    return;
+  }
+  ++stats_.throttled_count;
+  auto& state = FindOrCreate(key, now);
+  if (now - state.last_decrease < kDecreaseCooldown) {
+    return;
+  }
+  state.rate = std::max(kMinimumRate, state.rate * backoff_factor_);
+  state.last_decrease = now;
+}
+
+double AimdRateController::rate(std::string const& key) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto i = keys_.find(key);
+  if (i == keys_.end()) {
+    return initial_rate_;
+  }
+  return i->second.rate;
+}
+
+RateControllerStats AimdRateController::stats(Clock::time_point now) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  RateControllerStats result = stats_;
+  for (auto const& kv : keys_) {
+    result.allowed_qps += kv.second.rate;
+  }
+
+  // Estimate the rate over the last second, weighting the previous window by
+  // how much of it overlaps with the last second.
+  auto elapsed = now - window_start_;
+  auto current = window_count_;
+  auto previous = previous_window_count_;
+  if (elapsed >= 2 * kWindow) {
+    current = 0;
+    previous = 0;
+    elapsed = Clock::duration(0);
+  } else if (elapsed >= kWindow) {
+    previous = current;
+    current = 0;
+    elapsed -= kWindow;
+  }
+  auto fraction =
+      std::min(std::max(ToSeconds(elapsed) / ToSeconds(kWindow), 0.0), 1.0);
+  result.accepted_qps = static_cast<double>(previous) * (1.0 - fraction) +
+                        static_cast<double>(current);
+  return result;
+}
+
+AimdRateController::KeyState& AimdRateController::FindOrCreate(
+    std::string const& key, Clock::time_point now) {
+  auto i = keys_.find(key);
+  if (i != keys_.end()) {
+    return i->second;
+  }
+  if (keys_.size() >= kMaximumIdleKeys) {
+    for (auto j = keys_.begin(); j != keys_.end();) {
+      if (j->second.next_slot + kIdleTimeout < now) {
+        j = keys_.erase(j);
+      } else {
+        ++j;
+      }
+    }
+  }
+  KeyState state{initial_rate_, now, now, now - kDecreaseCooldown};
+  return keys_.emplace(key, state).first->second;
+}
+
+void AimdRateController::AdvanceWindow(Clock::time_point now) {
+  auto elapsed = now - window_start_;
+  if (elapsed >= 2 * kWindow) {
+    previous_window_count_ = 0;
+    window_count_ = 0;
+    window_start_ = now;
+  } else if (elapsed >= kWindow) {
+    previous_window_count_ = window_count_;
+    window_count_ = 0;
+    window_start_ += kWindow;
+  }
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
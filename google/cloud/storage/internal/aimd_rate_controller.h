@@ -0,0 +1,144 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_AIMD_RATE_CONTROLLER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_AIMD_RATE_CONTROLLER_H_
+
+#include "google/cloud/optional.h"
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+/// Counters reported by `AimdRateController`.
+struct RateControllerStats {
+  /// The number of requests that received a slot to send.
+  std::uint64_t admitted_count = 0;
+  /// The number of requests that could not get a slot soon enough.
+  std::uint64_t rejected_count = 0;
+  /// The number of requests that completed without being throttled.
+  std::uint64_t accepted_count = 0;
+  /// The number of requests that were throttled by the service.
+  std::uint64_t throttled_count = 0;
+  /// The rate of accepted requests, measured over the last second.
+  double accepted_qps = 0.0;
+  /// The sum of the rates currently allowed for each key.
+  double allowed_qps = 0.0;
+  /// The total time requests have spent queued before being sent.
+  std::chrono::microseconds total_queue_delay{0};
+  /// The longest time any request has spent queued before being sent.
+  std::chrono::microseconds max_queue_delay{0};
+};
+
+/**
+ * Schedule requests using additive-increase / multiplicative-decrease.
+ *
+ * Each key (typically a bucket, or a bucket and an object prefix) has its own
+ * allowed rate. Requests are assigned evenly spaced send slots at that rate,
+ * so a burst of requests is queued instead of sent all at once. While a key
+ * has queued requests its rate increases linearly, and every throttling error
+ * reduces it by a constant factor. Throttling errors that arrive shortly after
+ * a reduction are attributed to requests sent at the old rate and ignored.
+ *
+ * This class does not sleep or read the clock, the caller provides the current
+ * time, which makes the scheduling logic easy to test.
+ */
+class AimdRateController {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Create a controller.
+   *
+   * @param initial_rate the rate (in requests per second) for new keys.
+   * @param maximum_rate the rate never grows beyond this value.
+   * @param ramp_up how fast (in requests per second, per second) the rate
+   *     grows while requests are queued.
+   * @param backoff_factor the rate is multiplied by this factor (in the
+   *     `(0, 1)` range) when a request is throttled.
+   */
+  AimdRateController(double initial_rate, double maximum_rate, double ramp_up,
+                     double backoff_factor);
+
+  /**
+   * Reserve a slot to send a request for @p key.
+   *
+   * @return how long the request must wait before it is sent.
+   */
+  Clock::duration Reserve(std::string const& key, Clock::time_point now);
+
+  /**
+   * Reserve a slot to send a request for @p key within @p maximum_delay.
+   *
+   * @return how long the request must wait before it is sent, or an empty
+   *     value if no slot is available within @p maximum_delay. In the latter
+   *     case no slot is reserved.
+   */
+  google::cloud::optional<Clock::duration> TryReserve(
+      std::string const& key, Clock::time_point now,
+      std::chrono::milliseconds maximum_delay);
+
+  /// Update the rate for @p key after a request completes.
+  void OnCompletion(std::string const& key, bool throttled,
+                    Clock::time_point now);
+
+  /// The rate currently allowed for @p key.
+  double rate(std::string const& key) const;
+
+  /// The aggregate counters across all keys.
+  RateControllerStats stats(Clock::time_point now) const;
+
+  double initial_rate() const { return initial_rate_; }
+  double maximum_rate() const { return maximum_rate_; }
+  double ramp_up() const { return ramp_up_; }
+  double backoff_factor() const { return backoff_factor_; }
+
+ private:
+  struct KeyState {
+    double rate;
+    Clock::time_point next_slot;
+    Clock::time_point last_update;
+    Clock::time_point last_decrease;
+  };
+
+  KeyState& FindOrCreate(std::string const& key, Clock::time_point now);
+  void AdvanceWindow(Clock::time_point now);
+
+  double initial_rate_;
+  double maximum_rate_;
+  double ramp_up_;
+  double backoff_factor_;
+
+  mutable std::mutex mu_;
+  std::unordered_map<std::string, KeyState> keys_;
+  RateControllerStats stats_;
+  Clock::time_point window_start_;
+  std::uint64_t window_count_;
+  std::uint64_t previous_window_count_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_AIMD_RATE_CONTROLLER_H_
@@ -0,0 +1,138 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/aimd_rate_controller.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+using Clock = AimdRateController::Clock;
+using ms = std::chrono::milliseconds;
+
+/// @test Verify that a burst of requests is spread at the allowed rate.
+TEST(AimdRateControllerTest, QueuesBurst) {
+  AimdRateController tested(100.0, 1000.0, 0.0, 0.5);
+  auto const now = Clock::now();
+  for (int i = 0; i != 10; ++i) {
+    auto delay = tested.Reserve("bucket", now);
+    EXPECT_EQ(ms(10 * i), std::chrono::duration_cast<ms>(delay));
+  }
+  // Other keys are not affected.
+  EXPECT_EQ(0, tested.Reserve("other-bucket", now).count());
+
+  auto stats = tested.stats(now);
+  EXPECT_EQ(11U, stats.admitted_count);
+  EXPECT_EQ(ms(90), std::chrono::duration_cast<ms>(stats.max_queue_delay));
+  EXPECT_EQ(ms(450), std::chrono::duration_cast<ms>(stats.total_queue_delay));
+  EXPECT_DOUBLE_EQ(200.0, stats.allowed_qps);
+}
+
+/// @test Verify that TryReserve() does not queue requests past the limit.
+TEST(AimdRateControllerTest, TryReserve) {
+  AimdRateController tested(100.0, 1000.0, 0.0, 0.5);
+  auto const now = Clock::now();
+  for (int i = 0; i != 5; ++i) {
+    auto delay = tested.TryReserve("bucket", now, ms(40));
+    ASSERT_TRUE(delay.has_value());
+    EXPECT_EQ(ms(10 * i), std::chrono::duration_cast<ms>(*delay));
+  }
+  EXPECT_FALSE(tested.TryReserve("bucket", now, ms(40)).has_value());
+  EXPECT_FALSE(tested.TryReserve("bucket", now, ms(0)).has_value());
+
+  // The rejected requests did not consume a slot.
+  auto delay = tested.TryReserve("bucket", now, ms(50));
+  ASSERT_TRUE(delay.has_value());
+  EXPECT_EQ(ms(50), std::chrono::duration_cast<ms>(*delay));
+
+  auto stats = tested.stats(now);
+  EXPECT_EQ(6U, stats.admitted_count);
+  EXPECT_EQ(2U, stats.rejected_count);
+}
+
+/// @test Verify that the rate grows while requests are queued.
+TEST(AimdRateControllerTest, RampUp) {
+  AimdRateController tested(10.0, 15.0, 2.0, 0.5);
+  auto now = Clock::now();
+  // Keep the key saturated for a few seconds.
+  for (int i = 0; i != 1000; ++i) {
+    tested.Reserve("bucket", now);
+  }
+  now += std::chrono::seconds(2);
+  tested.Reserve("bucket", now);
+  EXPECT_DOUBLE_EQ(14.0, tested.rate("bucket"));
+
+  // The rate never grows beyond the maximum.
+  now += std::chrono::seconds(10);
+  tested.Reserve("bucket", now);
+  EXPECT_DOUBLE_EQ(15.0, tested.rate("bucket"));
+}
+
+/// @test Verify that idle keys do not ramp up.
+TEST(AimdRateControllerTest, NoRampUpWhenIdle) {
+  AimdRateController tested(10.0, 100.0, 5.0, 0.5);
+  auto now = Clock::now();
+  tested.Reserve("bucket", now);
+  now += std::chrono::seconds(10);
+  tested.Reserve("bucket", now);
+  EXPECT_DOUBLE_EQ(10.0, tested.rate("bucket"));
+}
+
+/// @test Verify that throttling reduces the rate, once per cooldown period.
+TEST(AimdRateControllerTest, Backoff) {
+  AimdRateController tested(100.0, 1000.0, 10.0, 0.5);
+  auto now = Clock::now();
+  tested.Reserve("bucket", now);
+  tested.OnCompletion("bucket", true, now);
+  EXPECT_DOUBLE_EQ(50.0, tested.rate("bucket"));
+
+  // Errors from requests sent at the old rate are ignored.
+  tested.OnCompletion("bucket", true, now + ms(100));
+  tested.OnCompletion("bucket", true, now + ms(200));
+  EXPECT_DOUBLE_EQ(50.0, tested.rate("bucket"));
+
+  tested.OnCompletion("bucket", true, now + ms(1500));
+  EXPECT_DOUBLE_EQ(25.0, tested.rate("bucket"));
+  EXPECT_EQ(4U, tested.stats(now).throttled_count);
+
+  // The rate never drops below one request per second.
+  for (int i = 0; i != 20; ++i) {
+    now += std::chrono::seconds(2);
+    tested.OnCompletion("bucket", true, now);
+  }
+  EXPECT_DOUBLE_EQ(1.0, tested.rate("bucket"));
+}
+
+/// @test Verify that the accepted rate is measured over the last second.
+TEST(AimdRateControllerTest, AcceptedQps) {
+  AimdRateController tested(100.0, 1000.0, 10.0, 0.5);
+  auto const start = Clock::now();
+  for (int i = 0; i != 50; ++i) {
+    tested.OnCompletion("bucket", false, start);
+  }
+  EXPECT_DOUBLE_EQ(50.0, tested.stats(start).accepted_qps);
+  EXPECT_DOUBLE_EQ(25.0, tested.stats(start + ms(1500)).accepted_qps);
+  EXPECT_DOUBLE_EQ(0.0, tested.stats(start + ms(2500)).accepted_qps);
+  EXPECT_EQ(50U, tested.stats(start).accepted_count);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,369 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/caching_client.h"
+#include "google/cloud/storage/internal/download_cache_streambuf.h"
+#include <limits>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+/// Copy @p Option from @p source to @p destination, if it is set.
+template <typename Option, typename Source, typename Destination>
+void CopyOption(Source const& source, Destination& destination) {
+  if (source.template HasOption<Option>()) {
+    destination.set_option(source.template GetOption<Option>());
+  }
+}
+}  // namespace
+
+CachingClient::CachingClient(std::shared_ptr<RawClient> client,
+                             std::shared_ptr<DownloadCache> cache)
+    : client_(std::move(client)), cache_(std::move(cache)) {}
+
+ClientOptions const& CachingClient::client_options() const {
+  return client_->client_options();
+}
+
+ConnectionPoolStats CachingClient::connection_pool_stats() const {
+  return client_->connection_pool_stats();
+}
+
+StatusOr<ListBucketsResponse> CachingClient::ListBuckets(
+    ListBucketsRequest const& request) {
+  return client_->ListBuckets(request);
+}
+
+StatusOr<BucketMetadata> CachingClient::CreateBucket(
+    CreateBucketRequest const& request) {
+  return client_->CreateBucket(request);
+}
+
+StatusOr<BucketMetadata> CachingClient::GetBucketMetadata(
+    GetBucketMetadataRequest const& request) {
+  return client_->GetBucketMetadata(request);
+}
+
+StatusOr<EmptyResponse> CachingClient::DeleteBucket(
+    DeleteBucketRequest const& request) {
+  return client_->DeleteBucket(request);
+}
+
+StatusOr<BucketMetadata> CachingClient::UpdateBucket(
+    UpdateBucketRequest const& request) {
+  return client_->UpdateBucket(request);
+}
+
+StatusOr<BucketMetadata> CachingClient::PatchBucket(
+    PatchBucketRequest const& request) {
+  return client_->PatchBucket(request);
+}
+
+StatusOr<IamPolicy> CachingClient::GetBucketIamPolicy(
+    GetBucketIamPolicyRequest const& request) {
+  return client_->GetBucketIamPolicy(request);
+}
+
+StatusOr<IamPolicy> CachingClient::SetBucketIamPolicy(
+    SetBucketIamPolicyRequest const& request) {
+  return client_->SetBucketIamPolicy(request);
+}
+
+StatusOr<TestBucketIamPermissionsResponse>
+CachingClient::TestBucketIamPermissions(
+    TestBucketIamPermissionsRequest const& request) {
+  return client_->TestBucketIamPermissions(request);
+}
+
+StatusOr<BucketMetadata> CachingClient::LockBucketRetentionPolicy(
+    LockBucketRetentionPolicyRequest const& request) {
+  return client_->LockBucketRetentionPolicy(request);
+}
+
+StatusOr<ObjectMetadata> CachingClient::InsertObjectMedia(
+    InsertObjectMediaRequest const& request) {
+  auto result = client_->InsertObjectMedia(request);
+  cache_->Invalidate(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<ObjectMetadata> CachingClient::CopyObject(
+    CopyObjectRequest const& request) {
+  auto result = client_->CopyObject(request);
+  cache_->Invalidate(request.destination_bucket(),
+                     request.destination_object());
+  return result;
+}
+
+StatusOr<ObjectMetadata> CachingClient::GetObjectMetadata(
+    GetObjectMetadataRequest const& request) {
+  return client_->GetObjectMetadata(request);
+}
+
+StatusOr<std::unique_ptr<ObjectReadStreambuf>>
+CachingClient::ReadObject(ReadObjectRangeRequest const& request) {
+  // Objects encrypted with customer-supplied keys are never stored on disk.
+  if (request.HasOption<EncryptionKey>()) {
+    return client_->ReadObject(request);
+  }
+  std::int64_t generation;
+  if (!FindGeneration(request, generation)) {
+    // Let the service report the error.
+    return client_->ReadObject(request);
+  }
+
+  auto const buffer_size = client_->client_options().download_buffer_size();
+  bool const ranged = request.HasOption<ReadRange>();
+  std::int64_t begin = 0;
+  std::int64_t end = std::numeric_limits<std::int64_t>::max();
+  if (ranged) {
+    auto const range = request.GetOption<ReadRange>().value();
+    begin = range.begin;
+    end = range.end;
+  }
+  auto path = cache_->Lookup(request.bucket_name(), request.object_name(),
+                             generation);
+  if (!path.empty()) {
+    std::unique_ptr<ObjectReadStreambuf> cached(
+        new CachedReadStreambuf(path, begin, end, buffer_size));
+    if (cached->IsOpen()) {
+      return std::move(cached);
+    }
+  }
+
+  // Download the generation found above, even if the object changes
+  // concurrently, so the cached contents match the generation.
+  ReadObjectRangeRequest pinned = request;
+  pinned.set_option(Generation(generation));
+  auto source = client_->ReadObject(pinned);
+  if (!source.ok() || ranged) {
+    return source;
+  }
+  return std::unique_ptr<ObjectReadStreambuf>(new CacheFillingReadStreambuf(
+      std::move(source).value(), cache_, request.bucket_name(),
+      request.object_name(), generation, buffer_size));
+}
+
+StatusOr<std::unique_ptr<ObjectWriteStreambuf>>
+CachingClient::WriteObject(InsertObjectStreamingRequest const& request) {
+  cache_->Invalidate(request.bucket_name(), request.object_name());
+  return client_->WriteObject(request);
+}
+
+StatusOr<ListObjectsResponse> CachingClient::ListObjects(
+    ListObjectsRequest const& request) {
+  return client_->ListObjects(request);
+}
+
+StatusOr<EmptyResponse> CachingClient::DeleteObject(
+    DeleteObjectRequest const& request) {
+  auto result = client_->DeleteObject(request);
+  cache_->Invalidate(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<ObjectMetadata> CachingClient::UpdateObject(
+    UpdateObjectRequest const& request) {
+  return client_->UpdateObject(request);
+}
+
+StatusOr<ObjectMetadata> CachingClient::PatchObject(
+    PatchObjectRequest const& request) {
+  return client_->PatchObject(request);
+}
+
+StatusOr<ObjectMetadata> CachingClient::ComposeObject(
+    ComposeObjectRequest const& request) {
+  auto result = client_->ComposeObject(request);
+  cache_->Invalidate(request.bucket_name(), request.object_name());
+  return result;
+}
+
+StatusOr<RewriteObjectResponse> CachingClient::RewriteObject(
+    RewriteObjectRequest const& request) {
+  auto result = client_->RewriteObject(request);
+  cache_->Invalidate(request.destination_bucket(),
+                     request.destination_object());
+  return result;
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+CachingClient::CreateResumableSession(ResumableUploadRequest const& request) {
+  cache_->Invalidate(request.bucket_name(), request.object_name());
+  return client_->CreateResumableSession(request);
+}
+
+StatusOr<std::unique_ptr<ResumableUploadSession>>
+CachingClient::RestoreResumableSession(std::string const& request) {
+  return client_->RestoreResumableSession(request);
+}
+
+StatusOr<ListBucketAclResponse> CachingClient::ListBucketAcl(
+    ListBucketAclRequest const& request) {
+  return client_->ListBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CachingClient::GetBucketAcl(
+    GetBucketAclRequest const& request) {
+  return client_->GetBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CachingClient::CreateBucketAcl(
+    CreateBucketAclRequest const& request) {
+  return client_->CreateBucketAcl(request);
+}
+
+StatusOr<EmptyResponse> CachingClient::DeleteBucketAcl(
+    DeleteBucketAclRequest const& request) {
+  return client_->DeleteBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CachingClient::UpdateBucketAcl(
+    UpdateBucketAclRequest const& request) {
+  return client_->UpdateBucketAcl(request);
+}
+
+StatusOr<BucketAccessControl> CachingClient::PatchBucketAcl(
+    PatchBucketAclRequest const& request) {
+  return client_->PatchBucketAcl(request);
+}
+
+StatusOr<ListObjectAclResponse> CachingClient::ListObjectAcl(
+    ListObjectAclRequest const& request) {
+  return client_->ListObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::CreateObjectAcl(
+    CreateObjectAclRequest const& request) {
+  return client_->CreateObjectAcl(request);
+}
+
+StatusOr<EmptyResponse> CachingClient::DeleteObjectAcl(
+    DeleteObjectAclRequest const& request) {
+  return client_->DeleteObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::GetObjectAcl(
+    GetObjectAclRequest const& request) {
+  return client_->GetObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::UpdateObjectAcl(
+    UpdateObjectAclRequest const& request) {
+  return client_->UpdateObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::PatchObjectAcl(
+    PatchObjectAclRequest const& request) {
+  return client_->PatchObjectAcl(request);
+}
+
+StatusOr<ListDefaultObjectAclResponse>
+CachingClient::ListDefaultObjectAcl(
+    ListDefaultObjectAclRequest const& request) {
+  return client_->ListDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::CreateDefaultObjectAcl(
+    CreateDefaultObjectAclRequest const& request) {
+  return client_->CreateDefaultObjectAcl(request);
+}
+
+StatusOr<EmptyResponse> CachingClient::DeleteDefaultObjectAcl(
+    DeleteDefaultObjectAclRequest const& request) {
+  return client_->DeleteDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::GetDefaultObjectAcl(
+    GetDefaultObjectAclRequest const& request) {
+  return client_->GetDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::UpdateDefaultObjectAcl(
+    UpdateDefaultObjectAclRequest const& request) {
+  return client_->UpdateDefaultObjectAcl(request);
+}
+
+StatusOr<ObjectAccessControl> CachingClient::PatchDefaultObjectAcl(
+    PatchDefaultObjectAclRequest const& request) {
+  return client_->PatchDefaultObjectAcl(request);
+}
+
+StatusOr<ServiceAccount> CachingClient::GetServiceAccount(
+    GetProjectServiceAccountRequest const& request) {
+  return client_->GetServiceAccount(request);
+}
+
+StatusOr<ListNotificationsResponse> CachingClient::ListNotifications(
+    ListNotificationsRequest const& request) {
+  return client_->ListNotifications(request);
+}
+
+StatusOr<NotificationMetadata> CachingClient::CreateNotification(
+    CreateNotificationRequest const& request) {
+  return client_->CreateNotification(request);
+}
+
+StatusOr<NotificationMetadata> CachingClient::GetNotification(
+    GetNotificationRequest const& request) {
+  return client_->GetNotification(request);
+}
+
+StatusOr<EmptyResponse> CachingClient::DeleteNotification(
+    DeleteNotificationRequest const& request) {
+  return client_->DeleteNotification(request);
+}
+
+bool CachingClient::FindGeneration(ReadObjectRangeRequest const& request,
+                                   std::int64_t& generation) {
+  if (request.HasOption<Generation>()) {
+    generation = request.GetOption<Generation>().value();
+    return true;
+  }
+  // Preconditions must be evaluated by the service.
+  bool const conditional = request.HasOption<IfGenerationMatch>() ||
+                           request.HasOption<IfGenerationNotMatch>() ||
+                           request.HasOption<IfMetagenerationMatch>() ||
+                           request.HasOption<IfMetagenerationNotMatch>();
+  if (!conditional &&
+      cache_->TrustedGeneration(request.bucket_name(), request.object_name(),
+                                generation)) {
+    return true;
+  }
+
+  GetObjectMetadataRequest metadata_request(request.bucket_name(),
+                                            request.object_name());
+  CopyOption<IfGenerationMatch>(request, metadata_request);
+  CopyOption<IfGenerationNotMatch>(request, metadata_request);
+  CopyOption<IfMetagenerationMatch>(request, metadata_request);
+  CopyOption<IfMetagenerationNotMatch>(request, metadata_request);
+  CopyOption<UserProject>(request, metadata_request);
+  auto metadata = client_->GetObjectMetadata(metadata_request);
+  if (!metadata.ok()) {
+    return false;
+  }
+  generation = metadata->generation();
+  cache_->OnValidation(request.bucket_name(), request.object_name(),
+                       generation);
+  return true;
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,207 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/caching_client.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/storage/oauth2/google_credentials.h"
+#include "google/cloud/storage/testing/mock_client.h"
+#include <gmock/gmock.h>
+#include <iterator>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::ReturnRef;
+
+/// A `ObjectReadStreambuf` that returns a fixed string.
+class StringReadStreambuf : public ObjectReadStreambuf {
+ public:
+  explicit StringReadStreambuf(std::string contents)
+      : contents_(std::move(contents)), is_open_(true) {
+    setg(&contents_[0], &contents_[0], &contents_[0] + contents_.size());
+  }
+
+  void Close() override { is_open_ = false; }
+  bool IsOpen() const override { return is_open_; }
+  Status const& status() const override { return status_; }
+  std::string const& received_hash() const override { return hash_; }
+  std::string const& computed_hash() const override { return hash_; }
+  std::multimap<std::string, std::string> const& headers() const override {
+    return headers_;
+  }
+
+ private:
+  std::string contents_;
+  bool is_open_;
+  Status status_;
+  std::string hash_;
+  std::multimap<std::string, std::string> headers_;
+};
+
+std::string ReadAll(StatusOr<std::unique_ptr<ObjectReadStreambuf>>& buf) {
+  return std::string(std::istreambuf_iterator<char>(buf->get()), {});
+}
+
+class CachingClientTest : public ::testing::Test {
+ protected:
+  CachingClientTest()
+      : mock_(std::make_shared<testing::MockClient>()),
+        options_(oauth2::CreateAnonymousCredentials()) {}
+
+  void SetUp() override {
+    auto generator = google::cloud::internal::MakeDefaultPRNG();
+    cache_ = std::make_shared<DownloadCache>(
+        ::testing::TempDir() + "caching-client-" +
+            google::cloud::internal::Sample(
+                generator, 16, "abcdefghijklmnopqrstuvwxyz0123456789"),
+        1024 * 1024, std::chrono::seconds(60));
+    EXPECT_CALL(*mock_, client_options()).WillRepeatedly(ReturnRef(options_));
+  }
+
+  static ObjectMetadata MakeMetadata(std::int64_t generation) {
+    return ObjectMetadataParser::FromString(
+               R"""({"bucket": "test-bucket", "name": "test-object",)""" +
+               std::string(R"""("generation": ")""") +
+               std::to_string(generation) + R"""("})""")
+        .value();
+  }
+
+  std::shared_ptr<testing::MockClient> mock_;
+  ClientOptions options_;
+  std::shared_ptr<DownloadCache> cache_;
+};
+
+TEST_F(CachingClientTest, ReadWithGeneration) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_)).Times(0);
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillOnce(Invoke([](ReadObjectRangeRequest const& r) {
+        EXPECT_EQ(7, r.GetOption<Generation>().value());
+        return std::unique_ptr<ObjectReadStreambuf>(
+            new StringReadStreambuf("the contents"));
+      }));
+
+  CachingClient client(mock_, cache_);
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  request.set_option(Generation(7));
+  auto miss = client.ReadObject(request);
+  ASSERT_TRUE(miss.ok());
+  EXPECT_EQ("the contents", ReadAll(miss));
+
+  // The second read is served from the cache.
+  auto hit = client.ReadObject(request);
+  ASSERT_TRUE(hit.ok());
+  EXPECT_EQ("the contents", ReadAll(hit));
+  auto stats = cache_->stats();
+  EXPECT_EQ(1U, stats.hit_count);
+  EXPECT_EQ(1U, stats.insert_count);
+}
+
+TEST_F(CachingClientTest, ReadCurrentGeneration) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_))
+      .WillOnce(Invoke([](GetObjectMetadataRequest const& r) {
+        EXPECT_EQ("test-object", r.object_name());
+        return make_status_or(MakeMetadata(42));
+      }));
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .WillOnce(Invoke([](ReadObjectRangeRequest const& r) {
+        EXPECT_EQ(42, r.GetOption<Generation>().value());
+        return std::unique_ptr<ObjectReadStreambuf>(
+            new StringReadStreambuf("0123456789"));
+      }));
+
+  CachingClient client(mock_, cache_);
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  auto miss = client.ReadObject(request);
+  ASSERT_TRUE(miss.ok());
+  EXPECT_EQ("0123456789", ReadAll(miss));
+
+  // Within the trust period the generation is not validated again, and ranged
+  // reads are served from the cache.
+  request.set_option(ReadRange(2, 5));
+  auto hit = client.ReadObject(request);
+  ASSERT_TRUE(hit.ok());
+  EXPECT_EQ("234", ReadAll(hit));
+  EXPECT_EQ(1U, cache_->stats().validation_count);
+}
+
+TEST_F(CachingClientTest, PartialReadNotCached) {
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([](ReadObjectRangeRequest const&) {
+        return std::unique_ptr<ObjectReadStreambuf>(
+            new StringReadStreambuf("0123456789"));
+      }));
+
+  CachingClient client(mock_, cache_);
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  request.set_option(Generation(7));
+  auto partial = client.ReadObject(request);
+  ASSERT_TRUE(partial.ok());
+  EXPECT_EQ('0', (*partial)->sbumpc());
+  (*partial)->Close();
+
+  auto full = client.ReadObject(request);
+  ASSERT_TRUE(full.ok());
+  EXPECT_EQ("0123456789", ReadAll(full));
+  EXPECT_EQ(0U, cache_->stats().hit_count);
+}
+
+TEST_F(CachingClientTest, EncryptedObjectsBypassCache) {
+  EXPECT_CALL(*mock_, GetObjectMetadata(_)).Times(0);
+  EXPECT_CALL(*mock_, ReadObject(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([](ReadObjectRangeRequest const&) {
+        return std::unique_ptr<ObjectReadStreambuf>(
+            new StringReadStreambuf("secret"));
+      }));
+
+  CachingClient client(mock_, cache_);
+  ReadObjectRangeRequest request("test-bucket", "test-object");
+  request.set_multiple_options(Generation(7),
+                               EncryptionKey::FromBinaryKey("01234567"));
+  for (int i = 0; i != 2; ++i) {
+    auto r = client.ReadObject(request);
+    ASSERT_TRUE(r.ok());
+    EXPECT_EQ("secret", ReadAll(r));
+  }
+  EXPECT_EQ(0U, cache_->stats().insert_count);
+}
+
+TEST_F(CachingClientTest, DeleteInvalidatesGeneration) {
+  cache_->OnValidation("test-bucket", "test-object", 42);
+  EXPECT_CALL(*mock_, DeleteObject(_))
+      .WillOnce(Invoke([](DeleteObjectRequest const&) {
+        return make_status_or(EmptyResponse{});
+      }));
+
+  CachingClient client(mock_, cache_);
+  auto status =
+      client.DeleteObject(DeleteObjectRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(status.ok());
+  std::int64_t generation;
+  EXPECT_FALSE(
+      cache_->TrustedGeneration("test-bucket", "test-object", generation));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
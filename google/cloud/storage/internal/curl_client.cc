@@ -15,12 +15,15 @@
 #include "google/cloud/storage/internal/curl_client.h"
 #include "google/cloud/internal/getenv.h"
 #include "google/cloud/internal/make_unique.h"
+#include "google/cloud/log.h"
 #include "google/cloud/storage/internal/curl_request_builder.h"
 #include "google/cloud/storage/internal/curl_resumable_streambuf.h"
 #include "google/cloud/storage/internal/curl_resumable_upload_session.h"
 #include "google/cloud/storage/internal/curl_streambuf.h"
 #include "google/cloud/storage/internal/generate_message_boundary.h"
 #include "google/cloud/storage/object_stream.h"
+#include <algorithm>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -29,15 +32,16 @@ inline namespace STORAGE_CLIENT_NS {
 namespace internal {
 namespace {
 
-extern "C" void CurlShareLockCallback(CURL*, curl_lock_data, curl_lock_access,
-                                      void* userptr) {
+extern "C" void CurlShareLockCallback(CURL*, curl_lock_data data,
+                                      curl_lock_access, void* userptr) {
   auto* client = reinterpret_cast<CurlClient*>(userptr);
-  client->LockShared();
+  client->LockShared(data);
 }
 
-extern "C" void CurlShareUnlockCallback(CURL*, curl_lock_data, void* userptr) {
+extern "C" void CurlShareUnlockCallback(CURL*, curl_lock_data data,
+                                        void* userptr) {
   auto* client = reinterpret_cast<CurlClient*>(userptr);
-  client->UnlockShared();
+  client->UnlockShared(data);
 }
 
 std::shared_ptr<CurlHandleFactory> CreateHandleFactory(
@@ -46,7 +50,8 @@ std::shared_ptr<CurlHandleFactory> CreateHandleFactory(
     return std::make_shared<DefaultCurlHandleFactory>();
   }
   return std::make_shared<PooledCurlHandleFactory>(
-      options.connection_pool_size());
+      options.connection_pool_size(), options.connection_pool_prewarm_size(),
+      options.maximum_connection_idle_time());
 }
 
 std::unique_ptr<HashValidator> CreateHashValidator(bool disable_md5,
@@ -164,6 +169,8 @@ Status CurlClient::SetupBuilderCommon(CurlRequestBuilder& builder,
   builder.SetMethod(method)
       .SetDebugLogging(options_.enable_http_tracing())
       .SetCurlShare(share_.get())
+      .SetMaximumConnectionIdleTime(options_.maximum_connection_idle_time())
+      .SetResponseObserver(CurrentHttpResponseObserver())
       .AddUserAgentPrefix(options_.user_agent_prefix())
       .AddHeader(auth_header.value());
   return Status();
@@ -239,13 +246,22 @@ CurlClient::CreateResumableSessionGeneric(RequestType const& request) {
 }
 
 CurlClient::CurlClient(ClientOptions options)
+    : CurlClient(std::move(options), nullptr) {}
+
+CurlClient::CurlClient(ClientOptions options,
+                       std::shared_ptr<CurlHandleFactory> handle_factory)
     : options_(std::move(options)),
-      share_(curl_share_init(), &curl_share_cleanup),
       generator_(google::cloud::internal::MakeDefaultPRNG()),
-      storage_factory_(CreateHandleFactory(options_)),
-      upload_factory_(CreateHandleFactory(options_)),
-      xml_upload_factory_(CreateHandleFactory(options_)),
-      xml_download_factory_(CreateHandleFactory(options_)) {
+      share_(curl_share_init(), &curl_share_cleanup),
+      storage_factory_(handle_factory ? handle_factory
+                                      : CreateHandleFactory(options_)),
+      upload_factory_(handle_factory ? handle_factory
+                                     : CreateHandleFactory(options_)),
+      xml_upload_factory_(handle_factory ? handle_factory
+                                         : CreateHandleFactory(options_)),
+      xml_download_factory_(handle_factory ? handle_factory
+                                           : CreateHandleFactory(options_)),
+      prewarm_cancelled_(false) {
   storage_endpoint_ = options_.endpoint() + "/storage/" + options_.version();
   upload_endpoint_ =
       options_.endpoint() + "/upload/storage/" + options_.version();
@@ -269,6 +285,27 @@ CurlClient::CurlClient(ClientOptions options)
   curl_share_setopt(share_.get(), CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
 
   CurlInitializeOnce(options.enable_ssl_locking_callbacks());
+
+  if (options_.connection_pool_prewarm_size() != 0U &&
+      options_.connection_pool_size() != 0U) {
+    prewarm_thread_ = std::thread([this] { PrewarmConnections(); });
+  }
+}
+
+CurlClient::~CurlClient() {
+  prewarm_cancelled_.store(true);
+  if (prewarm_thread_.joinable()) {
+    prewarm_thread_.join();
+  }
+}
+
+ConnectionPoolStats CurlClient::connection_pool_stats() const {
+  ConnectionPoolStats stats{0, 0, 0, 0};
+  for (auto const& f : {storage_factory_, upload_factory_,
+                        xml_upload_factory_, xml_download_factory_}) {
+    stats += f->stats();
+  }
+  return stats;
 }
 
 StatusOr<ResumableUploadResponse> CurlClient::UploadChunk(
@@ -1053,9 +1090,71 @@ StatusOr<EmptyResponse> CurlClient::DeleteNotification(
   return ReturnEmptyResponse(builder.BuildRequest().MakeRequest(std::string{}));
 }
 
-void CurlClient::LockShared() { mu_.lock(); }
+void CurlClient::LockShared(curl_lock_data data) {
+  share_mu_[data % share_mu_.size()].lock();
+}
+
+void CurlClient::UnlockShared(curl_lock_data data) {
+  share_mu_[data % share_mu_.size()].unlock();
+}
+
+void CurlClient::PrewarmConnections() {
+  using std::chrono::steady_clock;
+  auto const count = (std::min)(options_.connection_pool_prewarm_size(),
+                                options_.connection_pool_size());
+  auto const timeout = options_.connection_pool_prewarm_timeout();
+  auto const deadline = steady_clock::now() + timeout;
+
+  CurlMulti multi = storage_factory_->CreateMultiHandle();
+  std::vector<CurlPtr> handles;
+  handles.reserve(count);
+  for (std::size_t i = 0; i != count; ++i) {
+    auto handle = storage_factory_->CreateHandle();
+    curl_easy_setopt(handle.get(), CURLOPT_URL, storage_endpoint_.c_str());
+    curl_easy_setopt(handle.get(), CURLOPT_NOBODY, 1L);
+    curl_easy_setopt(handle.get(), CURLOPT_SHARE, share_.get());
+    curl_easy_setopt(handle.get(), CURLOPT_TIMEOUT_MS,
+                     static_cast<long>(timeout.count()));
+    curl_easy_setopt(handle.get(), CURLOPT_NOSIGNAL, 1L);
+    curl_multi_add_handle(multi.get(), handle.get());
+    handles.push_back(std::move(handle));
+  }
+
+  // Wake up periodically to check if the client is being destroyed.
+  int const poll_ms = 100;
+  int running = static_cast<int>(handles.size());
+  while (running != 0 && !prewarm_cancelled_.load() &&
+         steady_clock::now() < deadline) {
+    CURLMcode result;
+    do {
+      result = curl_multi_perform(multi.get(), &running);
+    } while (result == CURLM_CALL_MULTI_PERFORM);
+    if (result != CURLM_OK || running == 0) {
+      break;
+    }
+    int numfds = 0;
+    (void)curl_multi_wait(multi.get(), nullptr, 0, poll_ms, &numfds);
+  }
 
-void CurlClient::UnlockShared() { mu_.unlock(); }
+  int remaining = 0;
+  while (auto* msg = curl_multi_info_read(multi.get(), &remaining)) {
+    if (msg->msg == CURLMSG_DONE && msg->data.result != CURLE_OK) {
+      GCP_LOG(INFO) << __func__ << "() - ignoring error: "
+                    << curl_easy_strerror(msg->data.result);
+    }
+  }
+  if (running != 0) {
+    GCP_LOG(INFO) << __func__ << "() - " << running
+                  << " connection(s) abandoned before completion";
+  }
+  // Removing an unfinished transfer closes its connection, the handles are
+  // reset before they are used again, so all of them can return to the pool.
+  for (auto& handle : handles) {
+    curl_multi_remove_handle(multi.get(), handle.get());
+    storage_factory_->CleanupHandle(std::move(handle));
+  }
+  storage_factory_->CleanupMultiHandle(std::move(multi));
+}
 
 StatusOr<ObjectMetadata> CurlClient::InsertObjectMediaXml(
     InsertObjectMediaRequest const& request) {
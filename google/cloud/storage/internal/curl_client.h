@@ -20,7 +20,10 @@
 #include "google/cloud/storage/internal/raw_client.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
 #include "google/cloud/storage/oauth2/credentials.h"
+#include <array>
+#include <atomic>
 #include <mutex>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -44,6 +47,8 @@ class CurlClient : public RawClient,
     return Create(ClientOptions(std::move(credentials)));
   }
 
+  ~CurlClient() override;
+
   CurlClient(CurlClient const& rhs) = delete;
   CurlClient(CurlClient&& rhs) = delete;
   CurlClient& operator=(CurlClient const& rhs) = delete;
@@ -67,6 +72,7 @@ class CurlClient : public RawClient,
   //@}
 
   ClientOptions const& client_options() const override { return options_; }
+  ConnectionPoolStats connection_pool_stats() const override;
 
   StatusOr<ListBucketsResponse> ListBuckets(
       ListBucketsRequest const& request) override;
@@ -169,14 +175,24 @@ class CurlClient : public RawClient,
   StatusOr<std::string> AuthorizationHeader(
       std::shared_ptr<google::cloud::storage::oauth2::Credentials> const&);
 
-  void LockShared();
-  void UnlockShared();
+  void LockShared(curl_lock_data data);
+  void UnlockShared(curl_lock_data data);
 
  protected:
   // The constructor is private because the class must always be created
   // as a shared_ptr<>.
   explicit CurlClient(ClientOptions options);
 
+  /**
+   * Create a client that gets all its handles from @p handle_factory.
+   *
+   * Tests use this constructor to control how the handles connect. If
+   * @p handle_factory is null each kind of request uses its own factory,
+   * configured using @p options.
+   */
+  CurlClient(ClientOptions options,
+             std::shared_ptr<CurlHandleFactory> handle_factory);
+
  private:
   /// Setup the configuration parameters that do not depend on the request.
   Status SetupBuilderCommon(CurlRequestBuilder& builder, char const* method);
@@ -198,6 +214,16 @@ class CurlClient : public RawClient,
       InsertObjectMediaRequest const& request);
   std::string PickBoundary(std::string const& text_to_avoid);
 
+  /**
+   * Open a connection for each pre-warmed handle, ignoring any errors.
+   *
+   * Each handle makes a `HEAD` request against the endpoint, all of them
+   * concurrently, so each one opens its own connection. The connections stay
+   * in the connection cache in `share_`, and the handles are returned to the
+   * pool. Runs in `prewarm_thread_`.
+   */
+  void PrewarmConnections();
+
   /// Insert an object using uploadType=media.
   StatusOr<ObjectMetadata> InsertObjectMediaSimple(
       InsertObjectMediaRequest const& request);
@@ -221,8 +247,13 @@ class CurlClient : public RawClient,
   std::string xml_download_endpoint_;
 
   std::mutex mu_;
-  CurlShare share_ /* GUARDED_BY(mu_) */;
-  google::cloud::internal::DefaultPRNG generator_;
+  google::cloud::internal::DefaultPRNG generator_ /* GUARDED_BY(mu_) */;
+
+  // libcurl locks the shared data (connections, DNS cache, SSL sessions)
+  // independently, use a separate mutex for each kind of data to avoid
+  // serializing unrelated operations.
+  std::array<std::mutex, CURL_LOCK_DATA_LAST> share_mu_;
+  CurlShare share_ /* GUARDED_BY(share_mu_) */;
 
   // The factories must be listed *after* the CurlShare. libcurl keeps a
   // usage count on each CURLSH* handle, which is only released once the CURL*
@@ -233,6 +264,9 @@ class CurlClient : public RawClient,
   std::shared_ptr<CurlHandleFactory> upload_factory_;
   std::shared_ptr<CurlHandleFactory> xml_upload_factory_;
   std::shared_ptr<CurlHandleFactory> xml_download_factory_;
+
+  std::atomic<bool> prewarm_cancelled_;
+  std::thread prewarm_thread_;
 };
 
 }  // namespace internal
@@ -20,9 +20,16 @@
 #include "google/cloud/storage/oauth2/google_credentials.h"
 #include "google/cloud/testing_util/environment_variable_restore.h"
 #include <gmock/gmock.h>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif  // _WIN32
 
 namespace google {
 namespace cloud {
@@ -401,6 +408,130 @@ TEST_P(CurlClientTest, DeleteNotification) {
   TestCorrectFailureStatus(status_or_foo.status());
 }
 
+/// @test Verify that pre-warming fills the pool without blocking the caller.
+TEST(CurlClientPrewarmTest, PrewarmFillsPool) {
+  using std::chrono::steady_clock;
+  auto const start = steady_clock::now();
+  auto client =
+      CurlClient::Create(ClientOptions(oauth2::CreateAnonymousCredentials())
+                             .set_endpoint("http://localhost:1")
+                             .set_connection_pool_size(4)
+                             .set_connection_pool_prewarm_size(4)
+                             .set_connection_pool_prewarm_timeout(
+                                 std::chrono::milliseconds(2000)));
+
+  // Each of the 4 pools starts with 4 handles. The requests fail, but each one
+  // takes a different handle from the pool and returns it when done.
+  auto done = [&client] {
+    auto stats = client->connection_pool_stats();
+    return stats.hit_count == 4U && stats.idle_handles == 16U;
+  };
+  for (int i = 0; i != 100 && !done(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  auto stats = client->connection_pool_stats();
+  EXPECT_EQ(4U, stats.hit_count);
+  EXPECT_EQ(0U, stats.miss_count);
+  EXPECT_EQ(16U, stats.idle_handles);
+
+  client.reset();
+  EXPECT_GT(std::chrono::seconds(3), steady_clock::now() - start);
+}
+
+#ifndef _WIN32
+/**
+ * Create handles connected to a local socket that never responds.
+ *
+ * The handles do not open any network connections, their requests wait until
+ * they timeout.
+ */
+class UnresponsiveHandleFactory : public DefaultCurlHandleFactory {
+ public:
+  ~UnresponsiveHandleFactory() override {
+    for (auto fd : peers_) {
+      close(fd);
+    }
+  }
+
+  CurlPtr CreateHandle() override {
+    auto handle = DefaultCurlHandleFactory::CreateHandle();
+    curl_easy_setopt(handle.get(), CURLOPT_OPENSOCKETFUNCTION, &OpenSocket);
+    curl_easy_setopt(handle.get(), CURLOPT_OPENSOCKETDATA, this);
+    curl_easy_setopt(handle.get(), CURLOPT_SOCKOPTFUNCTION, &SocketOptions);
+    return handle;
+  }
+
+  std::size_t socket_count() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return peers_.size();
+  }
+
+ private:
+  static curl_socket_t OpenSocket(void* userdata, curlsocktype,
+                                  struct curl_sockaddr*) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      return CURL_SOCKET_BAD;
+    }
+    auto* self = static_cast<UnresponsiveHandleFactory*>(userdata);
+    std::lock_guard<std::mutex> lk(self->mu_);
+    self->peers_.push_back(fds[1]);
+    return fds[0];
+  }
+
+  static int SocketOptions(void*, curl_socket_t, curlsocktype) {
+    return CURL_SOCKOPT_ALREADY_CONNECTED;
+  }
+
+  std::mutex mu_;
+  std::vector<int> peers_;
+};
+
+/// Expose the constructor that injects the handle factory.
+class TestCurlClient : public CurlClient {
+ public:
+  TestCurlClient(ClientOptions options,
+                 std::shared_ptr<CurlHandleFactory> handle_factory)
+      : CurlClient(std::move(options), std::move(handle_factory)) {}
+};
+
+/// @test Verify that destroying the client stops the pre-warming.
+TEST(CurlClientPrewarmTest, DestructorCancelsPrewarm) {
+  using std::chrono::steady_clock;
+  auto factory = std::make_shared<UnresponsiveHandleFactory>();
+  auto client = std::make_shared<TestCurlClient>(
+      ClientOptions(oauth2::CreateAnonymousCredentials())
+          .set_endpoint("http://127.0.0.1")
+          .set_connection_pool_size(2)
+          .set_connection_pool_prewarm_size(2)
+          .set_connection_pool_prewarm_timeout(std::chrono::seconds(60)),
+      factory);
+  // Wait until the pre-warming requests are blocked on their sockets.
+  for (int i = 0; i != 100 && factory->socket_count() != 2U; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(2U, factory->socket_count());
+
+  auto const start = steady_clock::now();
+  client.reset();
+  EXPECT_GT(std::chrono::seconds(5), steady_clock::now() - start);
+}
+#endif  // _WIN32
+
+/// @test Verify that the stats are zero without a connection pool.
+TEST(CurlClientPrewarmTest, NoPoolStats) {
+  auto client =
+      CurlClient::Create(ClientOptions(oauth2::CreateAnonymousCredentials())
+                             .set_endpoint("http://localhost:1")
+                             .set_connection_pool_size(0)
+                             .set_connection_pool_prewarm_size(4));
+  auto stats = client->connection_pool_stats();
+  EXPECT_EQ(0U, stats.hit_count);
+  EXPECT_EQ(0U, stats.miss_count);
+  EXPECT_EQ(0U, stats.idle_eviction_count);
+  EXPECT_EQ(0U, stats.idle_handles);
+}
+
 INSTANTIATE_TEST_CASE_P(CredentialsFailure, CurlClientTest,
                         ::testing::Values("credentials-failure"));
 
@@ -30,6 +30,7 @@ namespace internal {
 
 CurlDownloadRequest::CurlDownloadRequest(std::size_t initial_buffer_size)
     : headers_(nullptr, &curl_slist_free_all),
+      response_reported_(false),
       multi_(nullptr, &curl_multi_cleanup),
       closing_(false),
       curl_closed_(false),
@@ -58,6 +59,7 @@ StatusOr<HttpResponse> CurlDownloadRequest::Close() {
   if (!http_code.ok()) {
     return http_code.status();
   }
+  ReportResponse();
   return HttpResponse{http_code.value(), std::string{},
                       std::move(received_headers_)};
 }
@@ -70,6 +72,10 @@ StatusOr<HttpResponse> CurlDownloadRequest::GetMore(std::string& buffer) {
   if (!status.ok()) {
     return status;
   }
+  // The response code is known once the first data (or the end of the
+  // transfer) arrives, report it now, the application may read the object
+  // for a long time.
+  ReportResponse();
   GCP_LOG(DEBUG) << __func__ << "(), curl.size=" << buffer_.size()
                  << ", closing=" << closing_ << ", closed=" << curl_closed_;
   if (curl_closed_) {
@@ -135,6 +141,19 @@ void CurlDownloadRequest::ResetOptions() {
   handle_.EnableLogging(logging_enabled_);
 }
 
+void CurlDownloadRequest::ReportResponse() {
+  if (!response_observer_ || response_reported_) {
+    return;
+  }
+  auto http_code = handle_.GetResponseCode();
+  // libcurl returns 0 until the response headers arrive.
+  if (!http_code.ok() || *http_code < 200) {
+    return;
+  }
+  response_reported_ = true;
+  response_observer_(*http_code);
+}
+
 std::size_t CurlDownloadRequest::WriteCallback(void* ptr, std::size_t size,
                                                std::size_t nmemb) {
   handle_.FlushDebug(__func__);
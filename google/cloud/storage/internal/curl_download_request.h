@@ -52,6 +52,8 @@ class CurlDownloadRequest {
         payload_(std::move(rhs.payload_)),
         user_agent_(std::move(rhs.user_agent_)),
         logging_enabled_(rhs.logging_enabled_),
+        response_observer_(std::move(rhs.response_observer_)),
+        response_reported_(rhs.response_reported_),
         handle_(std::move(rhs.handle_)),
         multi_(std::move(rhs.multi_)),
         factory_(std::move(rhs.factory_)),
@@ -67,6 +69,8 @@ class CurlDownloadRequest {
     payload_ = std::move(rhs.payload_);
     user_agent_ = std::move(rhs.user_agent_);
     logging_enabled_ = rhs.logging_enabled_;
+    response_observer_ = std::move(rhs.response_observer_);
+    response_reported_ = rhs.response_reported_;
     handle_ = std::move(rhs.handle_);
     multi_ = std::move(rhs.multi_);
     factory_ = std::move(rhs.factory_);
@@ -100,6 +104,9 @@ class CurlDownloadRequest {
   /// Reset the underlying CurlHandle options after a move operation.
   void ResetOptions();
 
+  /// Report the response code to the observer, once it is known.
+  void ReportResponse();
+
   /// Called by libcurl to show that more data is available in the download.
   std::size_t WriteCallback(void* ptr, std::size_t size, std::size_t nmemb);
 
@@ -148,6 +155,8 @@ class CurlDownloadRequest {
   std::string user_agent_;
   CurlReceivedHeaders received_headers_;
   bool logging_enabled_;
+  HttpResponseObserver response_observer_;
+  bool response_reported_;
   CurlHandle handle_;
   CurlMulti multi_;
   std::shared_ptr<CurlHandleFactory> factory_;
@@ -80,6 +80,13 @@ extern "C" std::size_t CurlHandleHeaderCallback(char* contents,
   auto* callback = reinterpret_cast<CurlHandle::HeaderCallback*>(userdata);
   return callback->operator()(contents, size, nitems);
 }
+
+extern "C" int CurlHandleProgressCallback(void* userdata, curl_off_t, curl_off_t,
+                                          curl_off_t, curl_off_t) {
+  auto* flag = reinterpret_cast<std::atomic<bool>*>(userdata);
+  // Any non-zero value aborts the transfer with CURLE_ABORTED_BY_CALLBACK.
+  return flag->load() ? 1 : 0;
+}
 }  // namespace
 
 CurlHandle::CurlHandle() : handle_(curl_easy_init(), &curl_easy_cleanup) {
@@ -126,6 +133,19 @@ void CurlHandle::ResetHeaderCallback() {
   header_callback_ = HeaderCallback();
 }
 
+void CurlHandle::SetCancellationFlag(CancellationFlag flag) {
+  cancellation_flag_ = std::move(flag);
+  if (!cancellation_flag_) {
+    SetOption(CURLOPT_XFERINFODATA, nullptr);
+    SetOption(CURLOPT_XFERINFOFUNCTION, nullptr);
+    SetOption(CURLOPT_NOPROGRESS, 1L);
+    return;
+  }
+  SetOption(CURLOPT_XFERINFODATA, cancellation_flag_.get());
+  SetOption(CURLOPT_XFERINFOFUNCTION, &CurlHandleProgressCallback);
+  SetOption(CURLOPT_NOPROGRESS, 0L);
+}
+
 void CurlHandle::EnableLogging(bool enabled) {
   if (enabled) {
     SetOption(CURLOPT_DEBUGDATA, &debug_buffer_);
@@ -17,6 +17,7 @@
 
 #include "google/cloud/status_or.h"
 #include "google/cloud/storage/internal/curl_wrappers.h"
+#include "google/cloud/storage/internal/hedging_executor.h"
 #include <curl/curl.h>
 
 namespace google {
@@ -41,13 +42,16 @@ class CurlHandle {
   CurlHandle& operator=(CurlHandle const&) = delete;
 
   // Allow moves, they immediately disable callbacks.
-  CurlHandle(CurlHandle&& rhs) : handle_(std::move(rhs.handle_)) {
+  CurlHandle(CurlHandle&& rhs)
+      : handle_(std::move(rhs.handle_)),
+        cancellation_flag_(std::move(rhs.cancellation_flag_)) {
     ResetHeaderCallback();
     ResetReaderCallback();
     ResetWriterCallback();
   }
   CurlHandle& operator=(CurlHandle&& rhs) {
     handle_ = std::move(rhs.handle_);
+    cancellation_flag_ = std::move(rhs.cancellation_flag_);
     ResetHeaderCallback();
     ResetReaderCallback();
     ResetWriterCallback();
@@ -126,6 +130,15 @@ class CurlHandle {
   /// Resets the reader callback.
   void ResetHeaderCallback();
 
+  /**
+   * Aborts any transfers once @p flag is set.
+   *
+   * The flag is checked from the libcurl progress callback, which is called
+   * at least once per second, even when no data is transferred. A null flag
+   * disables the check.
+   */
+  void SetCancellationFlag(CancellationFlag flag);
+
   /// URL-escapes a string.
   CurlString MakeEscapedString(std::string const& s) {
     return CurlString(
@@ -194,6 +207,7 @@ class CurlHandle {
   ReaderCallback reader_callback_;
   WriterCallback writer_callback_;
   HeaderCallback header_callback_;
+  CancellationFlag cancellation_flag_;
 };
 
 }  // namespace internal
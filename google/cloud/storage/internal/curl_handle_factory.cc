@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/curl_handle_factory.h"
+#include <algorithm>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -22,6 +24,11 @@ namespace internal {
 std::once_flag default_curl_handle_factory_initialized;
 std::shared_ptr<CurlHandleFactory> default_curl_handle_factory;
 
+namespace {
+/// The maximum number of shards in a `PooledCurlHandleFactory`.
+std::size_t const kMaximumShardCount = 16;
+}  // namespace
+
 std::shared_ptr<CurlHandleFactory> GetDefaultCurlHandleFactory() {
   std::call_once(default_curl_handle_factory_initialized, [] {
     default_curl_handle_factory = std::make_shared<DefaultCurlHandleFactory>();
@@ -50,15 +57,44 @@ CurlMulti DefaultCurlHandleFactory::CreateMultiHandle() {
 
 void DefaultCurlHandleFactory::CleanupMultiHandle(CurlMulti&& m) { m.reset(); }
 
-PooledCurlHandleFactory::PooledCurlHandleFactory(std::size_t maximum_size)
-    : maximum_size_(maximum_size) {
-  handles_.reserve(maximum_size);
+PooledCurlHandleFactory::PooledCurlHandleFactory(
+    std::size_t maximum_size, std::size_t prewarm_size,
+    std::chrono::milliseconds maximum_idle_time)
+    : maximum_idle_time_(maximum_idle_time),
+      hit_count_(0),
+      miss_count_(0),
+      idle_eviction_count_(0),
+      maximum_size_(maximum_size) {
+  // Use (at most) one shard per hardware thread, there is little benefit in
+  // having more shards than threads that can run concurrently.
+  std::size_t shard_count = std::thread::hardware_concurrency();
+  shard_count = std::min(shard_count, kMaximumShardCount);
+  shard_count = std::min(shard_count, maximum_size);
+  shard_count = std::max(shard_count, std::size_t(1));
+  shard_capacity_ = (maximum_size + shard_count - 1) / shard_count;
+  shards_.reserve(shard_count);
+  for (std::size_t i = 0; i != shard_count; ++i) {
+    shards_.emplace_back(new Shard);
+    shards_.back()->handles.reserve(shard_capacity_);
+  }
   multi_handles_.reserve(maximum_size);
+
+  auto const now = Clock::now();
+  prewarm_size = std::min(prewarm_size, maximum_size);
+  for (std::size_t i = 0; i != prewarm_size; ++i) {
+    auto& shard = *shards_[i % shard_count];
+    if (shard.handles.size() >= shard_capacity_) {
+      break;
+    }
+    shard.handles.push_back(PooledHandle{curl_easy_init(), now});
+  }
 }
 
 PooledCurlHandleFactory::~PooledCurlHandleFactory() {
-  for (auto* h : handles_) {
-    curl_easy_cleanup(h);
+  for (auto& shard : shards_) {
+    for (auto& h : shard->handles) {
+      curl_easy_cleanup(h.handle);
+    }
   }
   for (auto* m : multi_handles_) {
     curl_multi_cleanup(m);
@@ -66,36 +102,112 @@ PooledCurlHandleFactory::~PooledCurlHandleFactory() {
 }
 
 CurlPtr PooledCurlHandleFactory::CreateHandle() {
-  std::unique_lock<std::mutex> lk(mu_);
-  if (!handles_.empty()) {
-    CURL* handle = handles_.back();
-    // Clear all the options in the handle so we do not leak its previous state.
-    (void)curl_easy_reset(handle);
-    handles_.pop_back();
-    return CurlPtr(handle, &curl_easy_cleanup);
+  auto const now = Clock::now();
+  auto const preferred = PreferredShard();
+  std::vector<CURL*> evicted;
+  CURL* handle = nullptr;
+  for (std::size_t i = 0; i != shards_.size() && handle == nullptr; ++i) {
+    auto& shard = *shards_[(preferred + i) % shards_.size()];
+    std::lock_guard<std::mutex> lk(shard.mu);
+    EvictIdle(shard, now, evicted);
+    if (shard.handles.empty()) {
+      continue;
+    }
+    handle = shard.handles.back().handle;
+    shard.handles.pop_back();
   }
-  return CurlPtr(curl_easy_init(), &curl_easy_cleanup);
+  CleanupEvicted(evicted);
+  if (handle == nullptr) {
+    ++miss_count_;
+    return CurlPtr(curl_easy_init(), &curl_easy_cleanup);
+  }
+  // Clear all the options in the handle so we do not leak its previous state.
+  (void)curl_easy_reset(handle);
+  ++hit_count_;
+  return CurlPtr(handle, &curl_easy_cleanup);
 }
 
 void PooledCurlHandleFactory::CleanupHandle(CurlPtr&& h) {
-  std::unique_lock<std::mutex> lk(mu_);
   char* ip;
   auto res = curl_easy_getinfo(h.get(), CURLINFO_LOCAL_IP, &ip);
   if (res == CURLE_OK && ip != nullptr) {
+    std::lock_guard<std::mutex> lk(ip_mu_);
     last_client_ip_address_ = ip;
   }
-  if (handles_.size() >= maximum_size_) {
-    CURL* tmp = handles_.front();
-    handles_.erase(handles_.begin());
-    curl_easy_cleanup(tmp);
+
+  auto const now = Clock::now();
+  auto const preferred = PreferredShard();
+  std::vector<CURL*> evicted;
+  for (std::size_t i = 0; i != shards_.size() && h; ++i) {
+    auto& shard = *shards_[(preferred + i) % shards_.size()];
+    std::lock_guard<std::mutex> lk(shard.mu);
+    EvictIdle(shard, now, evicted);
+    if (shard.handles.size() >= shard_capacity_) {
+      continue;
+    }
+    shard.handles.push_back(PooledHandle{h.get(), now});
+    // The shard now has ownership, so release it.
+    (void)h.release();
+  }
+
+  if (h) {
+    // All the shards are full, replace the oldest handle in the preferred
+    // shard.
+    auto& shard = *shards_[preferred];
+    std::lock_guard<std::mutex> lk(shard.mu);
+    if (!shard.handles.empty()) {
+      evicted.push_back(shard.handles.front().handle);
+      shard.handles.erase(shard.handles.begin());
+    }
+    shard.handles.push_back(PooledHandle{h.get(), now});
+    // The shard now has ownership, so release it.
+    (void)h.release();
+  }
+  CleanupEvicted(evicted);
+}
+
+std::size_t PooledCurlHandleFactory::size() const {
+  std::size_t total = 0;
+  for (auto const& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    total += shard->handles.size();
+  }
+  return total;
+}
+
+std::size_t PooledCurlHandleFactory::PreferredShard() const {
+  return std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+         shards_.size();
+}
+
+void PooledCurlHandleFactory::EvictIdle(Shard& shard, Clock::time_point now,
+                                        std::vector<CURL*>& evicted) {
+  if (maximum_idle_time_.count() == 0) {
+    return;
+  }
+  // Handles are returned to the back of the vector, so the front contains the
+  // handles that have been idle for the longest time.
+  auto const deadline = now - maximum_idle_time_;
+  auto end = shard.handles.begin();
+  while (end != shard.handles.end() && end->last_used < deadline) {
+    evicted.push_back(end->handle);
+    ++idle_eviction_count_;
+    ++end;
+  }
+  shard.handles.erase(shard.handles.begin(), end);
+}
+
+void PooledCurlHandleFactory::CleanupEvicted(std::vector<CURL*>& evicted) {
+  // Closing a handle may need the locks in the CURLSH* it uses, do not hold
+  // any shard mutex while closing them.
+  for (auto* h : evicted) {
+    curl_easy_cleanup(h);
   }
-  handles_.push_back(h.get());
-  // The handles_ vector now has ownership, so release it.
-  (void)h.release();
+  evicted.clear();
 }
 
 CurlMulti PooledCurlHandleFactory::CreateMultiHandle() {
-  std::unique_lock<std::mutex> lk(mu_);
+  std::unique_lock<std::mutex> lk(multi_mu_);
   if (!multi_handles_.empty()) {
     CURL* m = multi_handles_.back();
     multi_handles_.pop_back();
@@ -105,7 +217,7 @@ CurlMulti PooledCurlHandleFactory::CreateMultiHandle() {
 }
 
 void PooledCurlHandleFactory::CleanupMultiHandle(CurlMulti&& m) {
-  std::unique_lock<std::mutex> lk(mu_);
+  std::unique_lock<std::mutex> lk(multi_mu_);
   if (multi_handles_.size() >= maximum_size_) {
     CURLM* tmp = multi_handles_.front();
     multi_handles_.erase(multi_handles_.begin());
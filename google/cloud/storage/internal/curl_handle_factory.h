@@ -15,7 +15,11 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_HANDLE_FACTORY_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_HANDLE_FACTORY_H_
 
+#include "google/cloud/storage/connection_pool_stats.h"
 #include "google/cloud/storage/internal/curl_wrappers.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
 #include <vector>
 
@@ -38,6 +42,11 @@ class CurlHandleFactory {
   virtual void CleanupMultiHandle(CurlMulti&&) = 0;
 
   virtual std::string LastClientIpAddress() const = 0;
+
+  /// The counters for the handles in this factory, zero if it has no pool.
+  virtual ConnectionPoolStats stats() const {
+    return ConnectionPoolStats{0, 0, 0, 0};
+  }
 };
 
 std::shared_ptr<CurlHandleFactory> GetDefaultCurlHandleFactory();
@@ -72,12 +81,32 @@ class DefaultCurlHandleFactory : public CurlHandleFactory {
 /**
  * Implements a CurlHandleFactory that pools handles.
  *
- * This implementation keeps up to N handles in memory, they are only released
- * when the factory is destructed.
+ * This implementation keeps up to N handles in memory, they are released when
+ * the factory is destructed, or when they have been idle for longer than the
+ * configured maximum idle time. Releasing a handle does not close connections
+ * in a shared connection cache, use `CURLOPT_MAXAGE_CONN` to close them.
+ *
+ * To reduce contention when many threads share a client the pool is split in
+ * several shards, each protected by its own mutex. Each thread prefers the
+ * shard selected by its thread id, and only looks at the other shards when its
+ * preferred shard is empty (or full, when returning a handle).
  */
 class PooledCurlHandleFactory : public CurlHandleFactory {
  public:
-  explicit PooledCurlHandleFactory(std::size_t maximum_size);
+  explicit PooledCurlHandleFactory(std::size_t maximum_size)
+      : PooledCurlHandleFactory(maximum_size, 0, std::chrono::seconds(0)) {}
+
+  /**
+   * Creates a pool with up to @p maximum_size handles.
+   *
+   * @param maximum_size the maximum number of handles kept in the pool.
+   * @param prewarm_size the number of handles created by the constructor, the
+   *     value is capped to @p maximum_size.
+   * @param maximum_idle_time handles idle for longer than this time are
+   *     released. Use zero to never release idle handles.
+   */
+  PooledCurlHandleFactory(std::size_t maximum_size, std::size_t prewarm_size,
+                          std::chrono::milliseconds maximum_idle_time);
   ~PooledCurlHandleFactory() override;
 
   CurlPtr CreateHandle() override;
@@ -87,15 +116,61 @@ class PooledCurlHandleFactory : public CurlHandleFactory {
   void CleanupMultiHandle(CurlMulti&&) override;
 
   std::string LastClientIpAddress() const override {
-    std::lock_guard<std::mutex> lk(mu_);
+    std::lock_guard<std::mutex> lk(ip_mu_);
     return last_client_ip_address_;
   }
 
+  /// The number of calls to `CreateHandle()` satisfied from the pool.
+  std::uint64_t hit_count() const { return hit_count_.load(); }
+
+  /// The number of calls to `CreateHandle()` that created a new handle.
+  std::uint64_t miss_count() const { return miss_count_.load(); }
+
+  /// The number of handles released because they were idle for too long.
+  std::uint64_t idle_eviction_count() const {
+    return idle_eviction_count_.load();
+  }
+
+  /// The number of handles currently in the pool.
+  std::size_t size() const;
+
+  ConnectionPoolStats stats() const override {
+    return ConnectionPoolStats{hit_count(), miss_count(), idle_eviction_count(),
+                               size()};
+  }
+
  private:
+  using Clock = std::chrono::steady_clock;
+
+  struct PooledHandle {
+    CURL* handle;
+    Clock::time_point last_used;
+  };
+
+  struct Shard {
+    std::mutex mu;
+    std::vector<PooledHandle> handles;
+  };
+
+  std::size_t PreferredShard() const;
+  /// Move the handles idle for too long in @p shard to @p evicted.
+  void EvictIdle(Shard& shard, Clock::time_point now,
+                 std::vector<CURL*>& evicted);
+  /// Release the evicted handles, must be called without holding any locks.
+  static void CleanupEvicted(std::vector<CURL*>& evicted);
+
+  std::size_t shard_capacity_;
+  std::chrono::milliseconds maximum_idle_time_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<std::uint64_t> hit_count_;
+  std::atomic<std::uint64_t> miss_count_;
+  std::atomic<std::uint64_t> idle_eviction_count_;
+
   std::size_t maximum_size_;
-  mutable std::mutex mu_;
-  std::vector<CURL*> handles_;
+  mutable std::mutex multi_mu_;
   std::vector<CURLM*> multi_handles_;
+
+  mutable std::mutex ip_mu_;
   std::string last_client_ip_address_;
 };
 
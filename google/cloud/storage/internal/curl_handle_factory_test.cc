@@ -0,0 +1,120 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/curl_handle_factory.h"
+#include <gmock/gmock.h>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+/// @test Verify that handles are reused and the counters are updated.
+TEST(PooledCurlHandleFactoryTest, HitAndMiss) {
+  PooledCurlHandleFactory tested(4);
+  EXPECT_EQ(0U, tested.size());
+
+  auto h1 = tested.CreateHandle();
+  EXPECT_EQ(0U, tested.hit_count());
+  EXPECT_EQ(1U, tested.miss_count());
+  CURL* expected = h1.get();
+  tested.CleanupHandle(std::move(h1));
+  EXPECT_EQ(1U, tested.size());
+
+  auto h2 = tested.CreateHandle();
+  EXPECT_EQ(expected, h2.get());
+  EXPECT_EQ(1U, tested.hit_count());
+  EXPECT_EQ(1U, tested.miss_count());
+  tested.CleanupHandle(std::move(h2));
+
+  auto stats = tested.stats();
+  EXPECT_EQ(tested.hit_count(), stats.hit_count);
+  EXPECT_EQ(tested.miss_count(), stats.miss_count);
+  EXPECT_EQ(tested.idle_eviction_count(), stats.idle_eviction_count);
+  EXPECT_EQ(tested.size(), stats.idle_handles);
+}
+
+/// @test Verify that the pool never holds more than the maximum size.
+TEST(PooledCurlHandleFactoryTest, CappedSize) {
+  PooledCurlHandleFactory tested(2);
+  std::vector<CurlPtr> handles;
+  for (int i = 0; i != 5; ++i) {
+    handles.emplace_back(tested.CreateHandle());
+  }
+  for (auto& h : handles) {
+    tested.CleanupHandle(std::move(h));
+  }
+  EXPECT_GE(2U, tested.size());
+  EXPECT_LT(0U, tested.size());
+}
+
+/// @test Verify that pre-warming creates the handles in the constructor.
+TEST(PooledCurlHandleFactoryTest, Prewarm) {
+  PooledCurlHandleFactory tested(4, 8, std::chrono::seconds(0));
+  EXPECT_EQ(4U, tested.size());
+  for (int i = 0; i != 4; ++i) {
+    auto h = tested.CreateHandle();
+    EXPECT_NE(nullptr, h.get());
+  }
+  EXPECT_EQ(4U, tested.hit_count());
+  EXPECT_EQ(0U, tested.miss_count());
+  EXPECT_EQ(0U, tested.size());
+}
+
+/// @test Verify that idle handles are released.
+TEST(PooledCurlHandleFactoryTest, IdleEviction) {
+  PooledCurlHandleFactory tested(4, 2, std::chrono::milliseconds(10));
+  EXPECT_EQ(2U, tested.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  auto h = tested.CreateHandle();
+  EXPECT_NE(nullptr, h.get());
+  EXPECT_EQ(0U, tested.hit_count());
+  EXPECT_EQ(1U, tested.miss_count());
+  EXPECT_LE(1U, tested.idle_eviction_count());
+  tested.CleanupHandle(std::move(h));
+  EXPECT_LE(1U, tested.size());
+}
+
+/// @test Verify that the pool can be used from multiple threads.
+TEST(PooledCurlHandleFactoryTest, MultipleThreads) {
+  PooledCurlHandleFactory tested(8);
+  auto worker = [&tested] {
+    for (int i = 0; i != 100; ++i) {
+      auto h = tested.CreateHandle();
+      EXPECT_NE(nullptr, h.get());
+      tested.CleanupHandle(std::move(h));
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(400U, tested.hit_count() + tested.miss_count());
+  EXPECT_GE(8U, tested.size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -36,6 +36,9 @@ StatusOr<HttpResponse> CurlRequest::MakeRequest(std::string const& payload) {
   if (!code.ok()) {
     return std::move(code).status();
   }
+  if (response_observer_) {
+    response_observer_(code.value());
+  }
   return HttpResponse{code.value(), std::move(response_payload_),
                       std::move(received_headers_)};
 }
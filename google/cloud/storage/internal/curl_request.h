@@ -18,6 +18,7 @@
 #include "google/cloud/storage/internal/curl_handle.h"
 #include "google/cloud/storage/internal/curl_handle_factory.h"
 #include "google/cloud/storage/internal/http_response.h"
+#include "google/cloud/storage/internal/http_response_observer.h"
 
 namespace google {
 namespace cloud {
@@ -49,6 +50,7 @@ class CurlRequest {
         response_payload_(std::move(rhs.response_payload_)),
         received_headers_(std::move(rhs.received_headers_)),
         logging_enabled_(rhs.logging_enabled_),
+        response_observer_(std::move(rhs.response_observer_)),
         handle_(std::move(rhs.handle_)),
         factory_(std::move(rhs.factory_)) {
     ResetOptions();
@@ -61,6 +63,7 @@ class CurlRequest {
     response_payload_ = std::move(rhs.response_payload_);
     received_headers_ = std::move(rhs.received_headers_);
     logging_enabled_ = rhs.logging_enabled_;
+    response_observer_ = std::move(rhs.response_observer_);
     handle_ = std::move(rhs.handle_);
     factory_ = std::move(rhs.factory_);
 
@@ -89,6 +92,7 @@ class CurlRequest {
   std::string response_payload_;
   CurlReceivedHeaders received_headers_;
   bool logging_enabled_;
+  HttpResponseObserver response_observer_;
   CurlHandle handle_;
   std::shared_ptr<CurlHandleFactory> factory_;
 };
@@ -33,7 +33,13 @@ CurlRequestBuilder::CurlRequestBuilder(
       url_(std::move(base_url)),
       query_parameter_separator_("?"),
       logging_enabled_(false),
-      initial_buffer_size_(GOOGLE_CLOUD_CPP_STORAGE_INITIAL_BUFFER_SIZE) {}
+      initial_buffer_size_(GOOGLE_CLOUD_CPP_STORAGE_INITIAL_BUFFER_SIZE) {
+  // Requests made by a hedged attempt are aborted if the attempt loses.
+  auto flag = CurrentCancellationFlag();
+  if (flag) {
+    handle_.SetCancellationFlag(std::move(flag));
+  }
+}
 
 CurlRequest CurlRequestBuilder::BuildRequest() {
   ValidateBuilderState(__func__);
@@ -44,6 +50,7 @@ CurlRequest CurlRequestBuilder::BuildRequest() {
   request.handle_ = std::move(handle_);
   request.factory_ = std::move(factory_);
   request.logging_enabled_ = logging_enabled_;
+  request.response_observer_ = std::move(response_observer_);
   request.ResetOptions();
   return request;
 }
@@ -58,6 +65,7 @@ CurlUploadRequest CurlRequestBuilder::BuildUpload() {
   request.multi_ = factory_->CreateMultiHandle();
   request.factory_ = factory_;
   request.logging_enabled_ = logging_enabled_;
+  request.response_observer_ = std::move(response_observer_);
   request.SetOptions();
   return request;
 }
@@ -74,6 +82,7 @@ CurlDownloadRequest CurlRequestBuilder::BuildDownloadRequest(
   request.multi_ = factory_->CreateMultiHandle();
   request.factory_ = factory_;
   request.logging_enabled_ = logging_enabled_;
+  request.response_observer_ = std::move(response_observer_);
   request.SetOptions();
   return request;
 }
@@ -116,6 +125,19 @@ CurlRequestBuilder& CurlRequestBuilder::SetCurlShare(CURLSH* share) {
   return *this;
 }
 
+CurlRequestBuilder& CurlRequestBuilder::SetMaximumConnectionIdleTime(
+    std::chrono::milliseconds idle_time) {
+  ValidateBuilderState(__func__);
+  if (idle_time.count() <= 0) {
+    return *this;
+  }
+#if LIBCURL_VERSION_NUM >= 0x074100
+  auto const seconds = (idle_time.count() + 999) / 1000;
+  handle_.SetOption(CURLOPT_MAXAGE_CONN, static_cast<long>(seconds));
+#endif  // LIBCURL_VERSION_NUM >= 0x074100
+  return *this;
+}
+
 CurlRequestBuilder& CurlRequestBuilder::SetDebugLogging(bool enabled) {
   ValidateBuilderState(__func__);
   logging_enabled_ = enabled;
@@ -128,6 +150,13 @@ CurlRequestBuilder& CurlRequestBuilder::SetInitialBufferSize(std::size_t size) {
   return *this;
 }
 
+CurlRequestBuilder& CurlRequestBuilder::SetResponseObserver(
+    HttpResponseObserver observer) {
+  ValidateBuilderState(__func__);
+  response_observer_ = std::move(observer);
+  return *this;
+}
+
 std::string CurlRequestBuilder::UserAgentSuffix() const {
   ValidateBuilderState(__func__);
   // Pre-compute and cache the user agent string:
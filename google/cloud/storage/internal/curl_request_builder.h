@@ -20,7 +20,9 @@
 #include "google/cloud/storage/internal/curl_handle_factory.h"
 #include "google/cloud/storage/internal/curl_request.h"
 #include "google/cloud/storage/internal/curl_upload_request.h"
+#include "google/cloud/storage/internal/http_response_observer.h"
 #include "google/cloud/storage/well_known_headers.h"
+#include <chrono>
 
 namespace google {
 namespace cloud {
@@ -158,8 +160,22 @@ class CurlRequestBuilder {
   /// Sets the CURLSH* handle to share resources.
   CurlRequestBuilder& SetCurlShare(CURLSH* share);
 
+  /**
+   * Do not reuse connections idle for longer than @p idle_time.
+   *
+   * libcurl closes these connections, including any in the shared connection
+   * cache, when the request looks for a connection to reuse. libcurl measures
+   * the idle time in seconds, the value is rounded up. Use zero to keep the
+   * libcurl default.
+   */
+  CurlRequestBuilder& SetMaximumConnectionIdleTime(
+      std::chrono::milliseconds idle_time);
+
   CurlRequestBuilder& SetInitialBufferSize(std::size_t size);
 
+  /// Sets the observer that receives the HTTP status code of the response.
+  CurlRequestBuilder& SetResponseObserver(HttpResponseObserver observer);
+
   /// Gets the user-agent suffix.
   std::string UserAgentSuffix() const;
 
@@ -187,6 +203,7 @@ class CurlRequestBuilder {
   std::string user_agent_prefix_;
 
   bool logging_enabled_;
+  HttpResponseObserver response_observer_;
 
   std::size_t initial_buffer_size_;
 };
@@ -24,6 +24,7 @@ StatusOr<ResumableUploadResponse>
 CurlResumableUploadSession::UploadChunk(std::string const& buffer,
                                         std::uint64_t upload_size) {
   UploadChunkRequest request(session_id_, next_expected_, buffer, upload_size);
+  ScopedHttpResponseObserver observer(response_observer_);
   auto result = client_->UploadChunk(request);
   Update(result);
   return result;
@@ -32,6 +33,7 @@ CurlResumableUploadSession::UploadChunk(std::string const& buffer,
 StatusOr<ResumableUploadResponse>
 CurlResumableUploadSession::ResetSession() {
   QueryResumableUploadRequest request(session_id_);
+  ScopedHttpResponseObserver observer(response_observer_);
   auto result = client_->QueryResumableUpload(request);
   Update(result);
   return result;
@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_CURL_RESUMABLE_UPLOAD_SESSION_H_
 
 #include "google/cloud/storage/internal/curl_client.h"
+#include "google/cloud/storage/internal/http_response_observer.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
 
 namespace google {
@@ -30,7 +31,9 @@ class CurlResumableUploadSession : public ResumableUploadSession {
  public:
   explicit CurlResumableUploadSession(std::shared_ptr<CurlClient> client,
                                       std::string session_id)
-      : client_(std::move(client)), session_id_(std::move(session_id)) {}
+      : client_(std::move(client)),
+        session_id_(std::move(session_id)),
+        response_observer_(CurrentHttpResponseObserver()) {}
 
   StatusOr<ResumableUploadResponse> UploadChunk(
       std::string const& buffer, std::uint64_t upload_size) override;
@@ -46,6 +49,9 @@ class CurlResumableUploadSession : public ResumableUploadSession {
 
   std::shared_ptr<CurlClient> client_;
   std::string session_id_;
+  // The chunks are uploaded after the operation that created the session
+  // returns, report their responses to the observer of that operation.
+  HttpResponseObserver response_observer_;
   std::uint64_t next_expected_ = 0;
 };
 
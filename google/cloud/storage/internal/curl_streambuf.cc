@@ -76,35 +76,58 @@ CurlReadStreambuf::int_type CurlReadStreambuf::underflow() {
     return traits_type::eof();
   }
 
+  auto status = FetchData();
+  if (!status.ok()) {
+    return ReportError(std::move(status));
+  }
+  if (gptr() != egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+
+  // This is an actual EOF, there is no more data to download, verify the
+  // checksums, and return the EOF character.
+  hash_validator_result_ = std::move(*hash_validator_).Finish();
+  if (hash_validator_result_.is_mismatch) {
+    return report_hash_mismatch();
+  }
+  return traits_type::eof();
+}
+
+Status CurlReadStreambuf::WaitForFirstResponse() {
+  // Only the first call (before any data is read) needs to do any work.
+  if (!status_.ok() || gptr() != egptr() || !IsOpen()) {
+    return status_;
+  }
+  auto status = FetchData();
+  if (!status.ok()) {
+    status_ = status;
+  }
+  return status;
+}
+
+Status CurlReadStreambuf::FetchData() {
   current_ios_buffer_.reserve(target_buffer_size_);
   StatusOr<HttpResponse> response = download_.GetMore(current_ios_buffer_);
   if (!response.ok()) {
-    return ReportError(std::move(response).status());
+    return std::move(response).status();
   }
   for (auto const& kv : response->headers) {
     hash_validator_->ProcessHeader(kv.first, kv.second);
     headers_.emplace(kv.first, kv.second);
   }
   if (response->status_code >= 300) {
-    return ReportError(AsStatus(*response));
-  }
-
-  if (!current_ios_buffer_.empty()) {
-    hash_validator_->Update(current_ios_buffer_);
-    char* data = &current_ios_buffer_[0];
-    setg(data, data, data + current_ios_buffer_.size());
-    return traits_type::to_int_type(*data);
+    return AsStatus(*response);
   }
 
-  // This is an actual EOF, there is no more data to download, create an
-  // empty (but valid) region:
-  SetEmptyRegion();
-  // Verify the checksums, and return the EOF character.
-  hash_validator_result_ = std::move(*hash_validator_).Finish();
-  if (hash_validator_result_.is_mismatch) {
-    return report_hash_mismatch();
+  if (current_ios_buffer_.empty()) {
+    // There is no more data to download, create an empty (but valid) region.
+    SetEmptyRegion();
+    return Status();
   }
-  return traits_type::eof();
+  hash_validator_->Update(current_ios_buffer_);
+  char* data = &current_ios_buffer_[0];
+  setg(data, data, data + current_ios_buffer_.size());
+  return Status();
 }
 
 CurlReadStreambuf::int_type CurlReadStreambuf::ReportError(Status status) {
@@ -48,12 +48,16 @@ class CurlReadStreambuf : public ObjectReadStreambuf {
   std::multimap<std::string, std::string> const& headers() const override {
     return headers_;
   }
+  Status WaitForFirstResponse() override;
 
  protected:
   int_type underflow() override;
 
   int_type ReportError(Status status);
 
+  /// Fetches the next chunk of data into the get area, empty at the end.
+  Status FetchData();
+
   void SetEmptyRegion();
 
  private:
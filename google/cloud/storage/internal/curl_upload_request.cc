@@ -77,6 +77,9 @@ StatusOr<HttpResponse> CurlUploadRequest::Close() {
   if (!http_code.ok()) {
     return std::move(http_code).status();
   }
+  if (response_observer_) {
+    response_observer_(http_code.value());
+  }
   return HttpResponse{http_code.value(), std::move(response_payload_),
                       std::move(received_headers_)};
 }
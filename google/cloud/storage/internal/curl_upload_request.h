@@ -52,6 +52,7 @@ class CurlUploadRequest {
         headers_(std::move(rhs.headers_)),
         user_agent_(std::move(rhs.user_agent_)),
         logging_enabled_(rhs.logging_enabled_),
+        response_observer_(std::move(rhs.response_observer_)),
         handle_(std::move(rhs.handle_)),
         multi_(std::move(rhs.multi_)),
         factory_(std::move(rhs.factory_)),
@@ -67,6 +68,7 @@ class CurlUploadRequest {
     headers_ = std::move(rhs.headers_);
     user_agent_ = std::move(rhs.user_agent_);
     logging_enabled_ = rhs.logging_enabled_;
+    response_observer_ = std::move(rhs.response_observer_);
     handle_ = std::move(rhs.handle_);
     multi_ = std::move(rhs.multi_);
     factory_ = std::move(rhs.factory_);
@@ -156,6 +158,7 @@ class CurlUploadRequest {
   std::string response_payload_;
   CurlReceivedHeaders received_headers_;
   bool logging_enabled_;
+  HttpResponseObserver response_observer_;
   CurlHandle handle_;
   CurlMulti multi_;
   std::shared_ptr<CurlHandleFactory> factory_;
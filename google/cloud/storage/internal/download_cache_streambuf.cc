@@ -0,0 +1,135 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/download_cache_streambuf.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+CachedReadStreambuf::CachedReadStreambuf(std::string const& path,
+                                         std::int64_t begin, std::int64_t end,
+                                         std::size_t buffer_size)
+    : is_(path, std::ios::binary), remaining_(0), buffer_(buffer_size) {
+  is_.seekg(0, std::ios::end);
+  std::int64_t const size = is_.tellg();
+  // Let the service report any errors for ranges past the end of the object.
+  if (!is_ || begin < 0 || (begin >= size && size != 0)) {
+    is_.close();
+    return;
+  }
+  remaining_ = std::max<std::int64_t>(std::min(end, size) - begin, 0);
+  is_.seekg(begin);
+  // Start with an empty read area, to force an underflow() on the first
+  // extraction.
+  setg(buffer_.data(), buffer_.data(), buffer_.data());
+}
+
+void CachedReadStreambuf::Close() { is_.close(); }
+
+bool CachedReadStreambuf::IsOpen() const { return is_.is_open(); }
+
+CachedReadStreambuf::int_type CachedReadStreambuf::underflow() {
+  if (!is_.is_open() || remaining_ == 0) {
+    is_.close();
+    return traits_type::eof();
+  }
+  auto const n = static_cast<std::streamsize>(
+      std::min<std::int64_t>(remaining_, buffer_.size()));
+  is_.read(buffer_.data(), n);
+  if (is_.gcount() != n) {
+    is_.close();
+    status_ = Status(StatusCode::kDataLoss, "short read from cached file");
+    return traits_type::eof();
+  }
+  remaining_ -= n;
+  setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+  return traits_type::to_int_type(buffer_[0]);
+}
+
+CacheFillingReadStreambuf::CacheFillingReadStreambuf(
+    std::unique_ptr<ObjectReadStreambuf> source,
+    std::shared_ptr<DownloadCache> cache, std::string bucket_name,
+    std::string object_name, std::int64_t generation, std::size_t buffer_size)
+    : source_(std::move(source)),
+      cache_(std::move(cache)),
+      bucket_name_(std::move(bucket_name)),
+      object_name_(std::move(object_name)),
+      generation_(generation),
+      buffer_(buffer_size),
+      temporary_path_(cache_->MakeTemporaryPath()),
+      os_(temporary_path_, std::ios::binary),
+      size_(0),
+      done_(false) {
+  setg(buffer_.data(), buffer_.data(), buffer_.data());
+}
+
+CacheFillingReadStreambuf::~CacheFillingReadStreambuf() { Discard(); }
+
+void CacheFillingReadStreambuf::Close() {
+  source_->Close();
+  Discard();
+}
+
+CacheFillingReadStreambuf::int_type CacheFillingReadStreambuf::underflow() {
+  if (done_) {
+    return traits_type::eof();
+  }
+  auto n = source_->sgetn(buffer_.data(), buffer_.size());
+  if (n <= 0) {
+    done_ = true;
+    Publish();
+    return traits_type::eof();
+  }
+  if (os_.is_open()) {
+    os_.write(buffer_.data(), n);
+    size_ += static_cast<std::uint64_t>(n);
+    if (!os_) {
+      Discard();
+    }
+  }
+  setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+  return traits_type::to_int_type(buffer_[0]);
+}
+
+void CacheFillingReadStreambuf::Publish() {
+  if (!os_.is_open()) {
+    return;
+  }
+  os_.close();
+  if (!os_ || !source_->status().ok()) {
+    std::remove(temporary_path_.c_str());
+    return;
+  }
+  // Insert() removes the temporary file if it cannot publish it.
+  cache_->Insert(bucket_name_, object_name_, generation_, temporary_path_,
+                 size_);
+}
+
+void CacheFillingReadStreambuf::Discard() {
+  if (!os_.is_open()) {
+    return;
+  }
+  os_.close();
+  std::remove(temporary_path_.c_str());
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,118 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_DOWNLOAD_CACHE_STREAMBUF_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_DOWNLOAD_CACHE_STREAMBUF_H_
+
+#include "google/cloud/storage/download_cache.h"
+#include "google/cloud/storage/internal/object_streambuf.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+/**
+ * Reads an object, or a range of an object, from a `DownloadCache` file.
+ *
+ * The range is right-open, as in `ReadRange`, and it is clipped to the size
+ * of the file. If the file cannot be read, or the range starts past the end of
+ * the file, the stream is created closed and the caller should download the
+ * object instead.
+ */
+class CachedReadStreambuf : public ObjectReadStreambuf {
+ public:
+  CachedReadStreambuf(std::string const& path, std::int64_t begin,
+                      std::int64_t end, std::size_t buffer_size);
+  ~CachedReadStreambuf() override = default;
+
+  void Close() override;
+  bool IsOpen() const override;
+  Status const& status() const override { return status_; }
+  std::string const& received_hash() const override { return hash_; }
+  std::string const& computed_hash() const override { return hash_; }
+  std::multimap<std::string, std::string> const& headers() const override {
+    return headers_;
+  }
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  std::ifstream is_;
+  std::int64_t remaining_;
+  std::vector<char> buffer_;
+  Status status_;
+  std::string hash_;
+  std::multimap<std::string, std::string> headers_;
+};
+
+/**
+ * Copies a download into a `DownloadCache` as the application reads it.
+ *
+ * The data is written to a temporary file, which is published in the cache
+ * only if the application reads the full object and the download succeeds.
+ */
+class CacheFillingReadStreambuf : public ObjectReadStreambuf {
+ public:
+  CacheFillingReadStreambuf(std::unique_ptr<ObjectReadStreambuf> source,
+                            std::shared_ptr<DownloadCache> cache,
+                            std::string bucket_name, std::string object_name,
+                            std::int64_t generation, std::size_t buffer_size);
+  ~CacheFillingReadStreambuf() override;
+
+  void Close() override;
+  bool IsOpen() const override { return source_->IsOpen(); }
+  Status const& status() const override { return source_->status(); }
+  std::string const& received_hash() const override {
+    return source_->received_hash();
+  }
+  std::string const& computed_hash() const override {
+    return source_->computed_hash();
+  }
+  std::multimap<std::string, std::string> const& headers() const override {
+    return source_->headers();
+  }
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  void Publish();
+  void Discard();
+
+  std::unique_ptr<ObjectReadStreambuf> source_;
+  std::shared_ptr<DownloadCache> cache_;
+  std::string bucket_name_;
+  std::string object_name_;
+  std::int64_t generation_;
+  std::vector<char> buffer_;
+  std::string temporary_path_;
+  std::ofstream os_;
+  std::uint64_t size_;
+  bool done_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_DOWNLOAD_CACHE_STREAMBUF_H_
@@ -0,0 +1,89 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/hedging_executor.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+thread_local CancellationFlag current_cancellation_flag;
+}  // namespace
+
+CancellationFlag CurrentCancellationFlag() {
+  return current_cancellation_flag;
+}
+
+HedgingExecutor::HedgingExecutor(std::size_t thread_count)
+    : available_(thread_count), shutdown_(false) {
+  threads_.reserve(thread_count);
+  for (std::size_t i = 0; i != thread_count; ++i) {
+    threads_.emplace_back([this] { WorkerThread(); });
+  }
+}
+
+HedgingExecutor::~HedgingExecutor() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+bool HedgingExecutor::TrySchedule(std::function<void()> task,
+                                  CancellationFlag flag) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (shutdown_ || available_ == 0) {
+      return false;
+    }
+    --available_;
+    tasks_.push_back(Task{std::move(task), std::move(flag)});
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void HedgingExecutor::WorkerThread() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    cv_.wait(lk, [this] { return shutdown_ || !tasks_.empty(); });
+    // Run any scheduled tasks before shutting down, their callers are waiting
+    // for them.
+    if (tasks_.empty()) {
+      return;
+    }
+    Task task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lk.unlock();
+    current_cancellation_flag = std::move(task.flag);
+    task.function();
+    current_cancellation_flag.reset();
+    // Release any state captured by the task before the thread is available.
+    task.function = nullptr;
+    lk.lock();
+    ++available_;
+  }
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,94 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HEDGING_EXECUTOR_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HEDGING_EXECUTOR_H_
+
+#include "google/cloud/storage/version.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+/// A flag to abort the requests made by a (hedged) attempt.
+using CancellationFlag = std::shared_ptr<std::atomic<bool>>;
+
+/**
+ * Returns the cancellation flag for requests made by the current thread.
+ *
+ * The flag is null unless the thread is running a task scheduled with a
+ * `HedgingExecutor`. `CurlHandle` checks the flag in its progress callback,
+ * and aborts the transfer once the flag is set.
+ */
+CancellationFlag CurrentCancellationFlag();
+
+/**
+ * Runs the attempts of hedged operations in a fixed set of threads.
+ *
+ * Each task runs with its own `CancellationFlag`, so the caller can abort the
+ * losing attempt. The executor never queues work: `TrySchedule()` fails if all
+ * the threads are busy, and the caller should then make the request without
+ * hedging. The destructor waits for any running tasks, no thread outlives the
+ * executor.
+ */
+class HedgingExecutor {
+ public:
+  explicit HedgingExecutor(std::size_t thread_count);
+  ~HedgingExecutor();
+
+  HedgingExecutor(HedgingExecutor const&) = delete;
+  HedgingExecutor& operator=(HedgingExecutor const&) = delete;
+
+  /**
+   * Runs @p task in one of the threads, if any is available.
+   *
+   * @return false if all the threads are busy, in which case @p task is not
+   *     run.
+   */
+  bool TrySchedule(std::function<void()> task, CancellationFlag flag);
+
+  std::size_t thread_count() const { return threads_.size(); }
+
+ private:
+  struct Task {
+    std::function<void()> function;
+    CancellationFlag flag;
+  };
+
+  void WorkerThread();
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Task> tasks_;
+  std::size_t available_;
+  bool shutdown_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HEDGING_EXECUTOR_H_
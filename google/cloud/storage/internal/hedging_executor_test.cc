@@ -0,0 +1,92 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/hedging_executor.h"
+#include <gmock/gmock.h>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+
+/// @test Verify that tasks run with their cancellation flag.
+TEST(HedgingExecutorTest, RunsWithFlag) {
+  HedgingExecutor tested(2);
+  EXPECT_EQ(2U, tested.thread_count());
+  EXPECT_FALSE(CurrentCancellationFlag());
+
+  auto flag = std::make_shared<std::atomic<bool>>(false);
+  std::promise<CancellationFlag> observed;
+  ASSERT_TRUE(tested.TrySchedule(
+      [&observed] { observed.set_value(CurrentCancellationFlag()); }, flag));
+  EXPECT_EQ(flag, observed.get_future().get());
+}
+
+/// @test Verify that the executor does not queue tasks when all threads are busy.
+TEST(HedgingExecutorTest, RejectsWhenBusy) {
+  HedgingExecutor tested(2);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<void> started[2];
+  for (auto& s : started) {
+    auto* p = &s;
+    ASSERT_TRUE(tested.TrySchedule(
+        [p, released] {
+          p->set_value();
+          released.wait();
+        },
+        nullptr));
+  }
+  for (auto& s : started) {
+    s.get_future().wait();
+  }
+  EXPECT_FALSE(tested.TrySchedule([] {}, nullptr));
+
+  release.set_value();
+  // Eventually a thread becomes available again.
+  bool scheduled = false;
+  for (int i = 0; i != 1000 && !scheduled; ++i) {
+    scheduled = tested.TrySchedule([] {}, nullptr);
+    if (!scheduled) std::this_thread::yield();
+  }
+  EXPECT_TRUE(scheduled);
+}
+
+/// @test Verify that the destructor waits for the running tasks.
+TEST(HedgingExecutorTest, DestructorWaits) {
+  std::atomic<bool> done{false};
+  {
+    HedgingExecutor tested(1);
+    std::promise<void> started;
+    ASSERT_TRUE(tested.TrySchedule(
+        [&started, &done] {
+          started.set_value();
+          std::this_thread::sleep_for(std::chrono::milliseconds(50));
+          done.store(true);
+        },
+        nullptr));
+    started.get_future().wait();
+  }
+  EXPECT_TRUE(done.load());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
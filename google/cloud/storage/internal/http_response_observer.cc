@@ -0,0 +1,44 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/http_response_observer.h"
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+thread_local HttpResponseObserver current_http_response_observer;
+}  // namespace
+
+HttpResponseObserver CurrentHttpResponseObserver() {
+  return current_http_response_observer;
+}
+
+ScopedHttpResponseObserver::ScopedHttpResponseObserver(
+    HttpResponseObserver observer)
+    : previous_(std::move(current_http_response_observer)) {
+  current_http_response_observer = std::move(observer);
+}
+
+ScopedHttpResponseObserver::~ScopedHttpResponseObserver() {
+  current_http_response_observer = std::move(previous_);
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,63 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HTTP_RESPONSE_OBSERVER_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HTTP_RESPONSE_OBSERVER_H_
+
+#include "google/cloud/storage/version.h"
+#include <functional>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+/**
+ * Receives the HTTP status code of each response to a request.
+ *
+ * Requests that stream data (downloads and uploads) call the observer when
+ * their response arrives, which may be long after the operation that created
+ * them returned.
+ */
+using HttpResponseObserver = std::function<void(long)>;
+
+/**
+ * Returns the observer for the requests created by the current thread.
+ *
+ * The observer is null unless a `ScopedHttpResponseObserver` is active in the
+ * thread. `CurlClient` copies the observer into each request it creates.
+ */
+HttpResponseObserver CurrentHttpResponseObserver();
+
+/// Sets the observer for the current thread while this object is in scope.
+class ScopedHttpResponseObserver {
+ public:
+  explicit ScopedHttpResponseObserver(HttpResponseObserver observer);
+  ~ScopedHttpResponseObserver();
+
+  ScopedHttpResponseObserver(ScopedHttpResponseObserver const&) = delete;
+  ScopedHttpResponseObserver& operator=(ScopedHttpResponseObserver const&) =
+      delete;
+
+ private:
+  HttpResponseObserver previous_;
+};
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_HTTP_RESPONSE_OBSERVER_H_
@@ -87,6 +87,10 @@ ClientOptions const& LoggingClient::client_options() const {
   return client_->client_options();
 }
 
+ConnectionPoolStats LoggingClient::connection_pool_stats() const {
+  return client_->connection_pool_stats();
+}
+
 StatusOr<ListBucketsResponse> LoggingClient::ListBuckets(
     ListBucketsRequest const& request) {
   return MakeCall(*client_, &RawClient::ListBuckets, request, __func__);
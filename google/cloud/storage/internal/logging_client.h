@@ -31,6 +31,7 @@ class LoggingClient : public RawClient {
   ~LoggingClient() override = default;
 
   ClientOptions const& client_options() const override;
+  ConnectionPoolStats connection_pool_stats() const override;
 
   StatusOr<ListBucketsResponse> ListBuckets(
       ListBucketsRequest const& request) override;
@@ -368,7 +368,7 @@ class ResumableUploadRequest
           EncryptionKey, IfGenerationMatch, IfGenerationNotMatch,
           IfMetagenerationMatch, IfMetagenerationNotMatch, KmsKeyName,
           MD5HashValue, PredefinedAcl, Projection, UseResumableUploadSession,
-          UserProject, WithObjectMetadata> {
+          UseUploadCheckpoint, UserProject, WithObjectMetadata> {
  public:
   ResumableUploadRequest() = default;
 
@@ -48,6 +48,16 @@ class ObjectReadStreambuf : public std::basic_streambuf<char> {
   virtual std::string const& received_hash() const = 0;
   virtual std::string const& computed_hash() const = 0;
   virtual std::multimap<std::string, std::string> const& headers() const = 0;
+
+  /**
+   * Blocks until the download receives its first chunk of data.
+   *
+   * Downloads start when the application first reads from the stream. Hedged
+   * operations call this function so they race the download, and not just
+   * the preparation of the request. Errors are also reported by `status()`.
+   * The default implementation does nothing.
+   */
+  virtual Status WaitForFirstResponse() { return Status(); }
 };
 
 /**
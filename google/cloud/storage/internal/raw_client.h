@@ -19,6 +19,7 @@
 #include "google/cloud/status_or.h"
 #include "google/cloud/storage/bucket_metadata.h"
 #include "google/cloud/storage/client_options.h"
+#include "google/cloud/storage/connection_pool_stats.h"
 #include "google/cloud/storage/internal/bucket_acl_requests.h"
 #include "google/cloud/storage/internal/bucket_requests.h"
 #include "google/cloud/storage/internal/default_object_acl_requests.h"
@@ -47,6 +48,11 @@ class RawClient {
 
   virtual ClientOptions const& client_options() const = 0;
 
+  /// Return the counters for the connection pools, if any.
+  virtual ConnectionPoolStats connection_pool_stats() const {
+    return ConnectionPoolStats{0, 0, 0, 0};
+  }
+
   //@{
   /// @name Bucket resource operations
   virtual StatusOr<ListBucketsResponse> ListBuckets(
@@ -14,10 +14,14 @@
 
 #include "google/cloud/storage/internal/retry_client.h"
 #include "google/cloud/internal/make_unique.h"
+#include "google/cloud/optional.h"
+#include "google/cloud/storage/internal/http_response_observer.h"
 #include "google/cloud/storage/internal/raw_client_wrapper_utils.h"
 #include "google/cloud/storage/internal/retry_resumable_upload_session.h"
+#include <array>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
-#include <thread>
 
 // Define the defaults using a pre-processor macro, this allows the application
 // developers to change the defaults for their application by compiling with
@@ -48,35 +52,22 @@ namespace {
 using raw_client_wrapper_utils::CheckSignature;
 
 /**
- * Calls a client operation with retries borrowing the RPC policies.
+ * Runs @p attempt until it succeeds or the retry policy is exhausted.
  *
- * @tparam MemberFunction the signature of the member function.
- * @param client the storage::Client object to make the call through.
- * @param retry_policy the policy controlling what failures are retryable, and
- *     for how long we can retry
- * @param backoff_policy the policy controlling how long to wait before
- *     retrying.
- * @param function the pointer to the member function to call.
- * @param request an initialized request parameter for the call.
- * @param error_message include this message in any exception or error log.
- * @return the result from making the call;
- * @throw std::exception with a description of the last error.
+ * @tparam ReturnType the type returned by each attempt.
+ * @tparam Attempt a callable to make a single attempt at the operation.
  */
-template <typename MemberFunction>
-typename std::enable_if<
-    CheckSignature<MemberFunction>::value,
-    typename CheckSignature<MemberFunction>::ReturnType>::type
-MakeCall(RetryPolicy& retry_policy, BackoffPolicy& backoff_policy,
-         bool is_idempotent, RawClient& client, MemberFunction function,
-         typename CheckSignature<MemberFunction>::RequestType const& request,
-         char const* error_message) {
+template <typename ReturnType, typename Attempt>
+ReturnType MakeCallImpl(RetryPolicy& retry_policy,
+                        BackoffPolicy& backoff_policy, bool is_idempotent,
+                        Attempt&& attempt, char const* error_message) {
   Status last_status;
   auto error = [&last_status](std::string const& msg) {
     return Status(last_status.code(), msg);
   };
 
   while (!retry_policy.IsExhausted()) {
-    auto result = (client.*function)(request);
+    ReturnType result = attempt();
     if (result.ok()) {
       return result;
     }
@@ -106,6 +97,281 @@ MakeCall(RetryPolicy& retry_policy, BackoffPolicy& backoff_policy,
   os << "Retry policy exhausted in " << error_message << ": " << last_status;
   return error(std::move(os).str());
 }
+
+/// The bucket and object used to rate limit a request.
+struct RateLimitingKey {
+  std::string bucket_name;
+  std::string object_name;
+};
+
+/// Rank the `MakeRateLimitingKey()` overloads, higher ranks are preferred.
+template <int N>
+struct Rank : public Rank<N - 1> {};
+template <>
+struct Rank<0> {};
+
+// Copy and rewrite requests are rate limited by their destination, as the
+// writes are more likely to be throttled than the reads.
+template <typename Request>
+auto MakeRateLimitingKey(Request const& request, Rank<3>)
+    -> decltype(request.destination_object(), RateLimitingKey{}) {
+  return RateLimitingKey{request.destination_bucket(),
+                         request.destination_object()};
+}
+
+template <typename Request>
+auto MakeRateLimitingKey(Request const& request, Rank<2>)
+    -> decltype(request.object_name(), RateLimitingKey{}) {
+  return RateLimitingKey{request.bucket_name(), request.object_name()};
+}
+
+template <typename Request>
+auto MakeRateLimitingKey(Request const& request, Rank<1>)
+    -> decltype(request.bucket_name(), RateLimitingKey{}) {
+  return RateLimitingKey{request.bucket_name(), std::string{}};
+}
+
+template <typename Request>
+RateLimitingKey MakeRateLimitingKey(Request const&, Rank<0>) {
+  return RateLimitingKey{};
+}
+
+/**
+ * Makes a single attempt of a client operation, waiting for the rate limiter.
+ *
+ * The attempt is queued until @p rate_limiting_policy admits it. If the policy
+ * cannot admit it within @p maximum_wait (the time left in the retry policy)
+ * the attempt fails immediately with a permanent error. The HTTP responses
+ * to the requests made by the attempt are reported to the policy, including
+ * the responses of downloads and uploads that complete after the attempt
+ * returns. Without a policy the attempt runs immediately.
+ */
+template <typename Request, typename Attempt>
+auto MakeRateLimitedAttempt(
+    std::shared_ptr<RateLimitingPolicy> const& rate_limiting_policy,
+    std::chrono::milliseconds maximum_wait, Request const& request,
+    Attempt&& attempt) -> decltype(attempt()) {
+  if (!rate_limiting_policy) {
+    return attempt();
+  }
+  auto key = MakeRateLimitingKey(request, Rank<3>{});
+  if (!rate_limiting_policy->Admit(key.bucket_name, key.object_name,
+                                   maximum_wait)) {
+    return Status(StatusCode::kResourceExhausted,
+                  "the rate limiting policy cannot admit the request before"
+                  " the retry policy expires");
+  }
+  ScopedHttpResponseObserver observer(
+      [rate_limiting_policy, key](long http_status_code) {
+        rate_limiting_policy->OnResponse(key.bucket_name, key.object_name,
+                                         http_status_code);
+      });
+  return attempt();
+}
+
+/**
+ * Calls a client operation with retries borrowing the RPC policies.
+ *
+ * @tparam MemberFunction the signature of the member function.
+ * @param client the storage::Client object to make the call through.
+ * @param retry_policy the policy controlling what failures are retryable, and
+ *     for how long we can retry
+ * @param backoff_policy the policy controlling how long to wait before
+ *     retrying.
+ * @param rate_limiting_policy if not null, the policy controlling how fast
+ *     requests are sent.
+ * @param function the pointer to the member function to call.
+ * @param request an initialized request parameter for the call.
+ * @param error_message include this message in any exception or error log.
+ * @return the result from making the call;
+ * @throw std::exception with a description of the last error.
+ */
+template <typename MemberFunction>
+typename std::enable_if<
+    CheckSignature<MemberFunction>::value,
+    typename CheckSignature<MemberFunction>::ReturnType>::type
+MakeCall(RetryPolicy& retry_policy, BackoffPolicy& backoff_policy,
+         bool is_idempotent,
+         std::shared_ptr<RateLimitingPolicy> const& rate_limiting_policy,
+         RawClient& client, MemberFunction function,
+         typename CheckSignature<MemberFunction>::RequestType const& request,
+         char const* error_message) {
+  using ReturnType = typename CheckSignature<MemberFunction>::ReturnType;
+  return MakeCallImpl<ReturnType>(
+      retry_policy, backoff_policy, is_idempotent,
+      [&retry_policy, &rate_limiting_policy, &client, function, &request] {
+        return MakeRateLimitedAttempt(
+            rate_limiting_policy, retry_policy.RemainingTime(), request,
+            [&client, function, &request] {
+              return (client.*function)(request);
+            });
+      },
+      error_message);
+}
+
+/**
+ * Completes the part of an operation that hedged attempts race.
+ *
+ * Most operations are complete when the client returns. `ReadObject()` only
+ * prepares the download, which starts when the stream is first read, so the
+ * hedged attempts wait for the first chunk of data.
+ */
+template <typename T>
+StatusOr<T> AwaitFirstResponse(StatusOr<T> result) {
+  return result;
+}
+
+StatusOr<std::unique_ptr<ObjectReadStreambuf>> AwaitFirstResponse(
+    StatusOr<std::unique_ptr<ObjectReadStreambuf>> result) {
+  if (!result.ok()) {
+    return result;
+  }
+  auto status = (*result)->WaitForFirstResponse();
+  if (!status.ok()) {
+    return status;
+  }
+  return result;
+}
+
+/**
+ * Makes a single attempt of a client operation, hedging it if it is slow.
+ *
+ * The request runs in one of the @p executor threads. If it does not complete
+ * before the delay set by @p hedging_policy, and the policy budget allows it, a
+ * duplicate request runs in another thread. The first successful response is
+ * returned, and the other request is cancelled. If both requests fail the last
+ * error is returned. If the executor has no threads available the request runs
+ * in the calling thread, without hedging.
+ */
+template <typename MemberFunction>
+typename std::enable_if<
+    CheckSignature<MemberFunction>::value,
+    typename CheckSignature<MemberFunction>::ReturnType>::type
+MakeHedgedAttempt(
+    HedgingPolicy& hedging_policy, HedgingExecutor& executor,
+    std::shared_ptr<RawClient> const& client, MemberFunction function,
+    typename CheckSignature<MemberFunction>::RequestType const& request) {
+  using ReturnType = typename CheckSignature<MemberFunction>::ReturnType;
+
+  auto const start = std::chrono::steady_clock::now();
+  auto elapsed = [start] {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+  };
+  auto run_inline = [&] {
+    auto result = AwaitFirstResponse((client.get()->*function)(request));
+    hedging_policy.OnCompletion(elapsed(), false, false);
+    return result;
+  };
+  auto delay = hedging_policy.HedgeDelay();
+  if (delay.count() == 0) {
+    return run_inline();
+  }
+
+  struct State {
+    std::mutex mu;
+    std::condition_variable cv;
+    int pending = 0;
+    int winner = -1;
+    google::cloud::optional<ReturnType> result;
+    std::array<CancellationFlag, 2> cancelled;
+  };
+  auto state = std::make_shared<State>();
+  for (auto& flag : state->cancelled) {
+    flag = std::make_shared<std::atomic<bool>>(false);
+  }
+  // Returns true if the request was scheduled, the caller must hold the lock.
+  // The requests run in other threads, report their responses to the
+  // observer of this attempt.
+  auto observer = CurrentHttpResponseObserver();
+  auto launch = [&state, &executor, &client, function, &request,
+                 &observer](int index) {
+    auto scheduled = executor.TrySchedule(
+        [state, client, function, index, request, observer] {
+          ScopedHttpResponseObserver scoped_observer(observer);
+          ReturnType result =
+              AwaitFirstResponse((client.get()->*function)(request));
+          std::unique_lock<std::mutex> lk(state->mu);
+          --state->pending;
+          if (state->winner >= 0) {
+            // Lost the race, release the result without holding the lock.
+            lk.unlock();
+            return;
+          }
+          if (!result.ok() && state->pending != 0) {
+            // Wait for the other request before reporting a failure.
+            return;
+          }
+          state->winner = index;
+          state->result.emplace(std::move(result));
+          // Abort the other request, if any, its result is not needed.
+          state->cancelled[1 - index]->store(true);
+          state->cv.notify_all();
+        },
+        state->cancelled[index]);
+    if (scheduled) {
+      ++state->pending;
+    }
+    return scheduled;
+  };
+
+  std::unique_lock<std::mutex> lk(state->mu);
+  if (!launch(0)) {
+    lk.unlock();
+    return run_inline();
+  }
+  auto has_result = [&state] { return state->winner >= 0; };
+  bool hedged = false;
+  if (!state->cv.wait_for(lk, delay, has_result) && hedging_policy.OnHedge()) {
+    hedged = launch(1);
+  }
+  state->cv.wait(lk, has_result);
+  ReturnType result = std::move(*state->result);
+  bool hedge_won = state->winner == 1;
+  lk.unlock();
+  hedging_policy.OnCompletion(elapsed(), hedged, hedge_won);
+  return result;
+}
+
+/**
+ * Calls a client operation with retries, hedging each attempt.
+ *
+ * Hedging is only used for idempotent operations, and only when the client is
+ * configured with a `HedgingPolicy` (which also creates @p executor).
+ */
+template <typename MemberFunction>
+typename std::enable_if<
+    CheckSignature<MemberFunction>::value,
+    typename CheckSignature<MemberFunction>::ReturnType>::type
+MakeHedgedCall(
+    RetryPolicy& retry_policy, BackoffPolicy& backoff_policy,
+    bool is_idempotent, HedgingPolicy* hedging_policy,
+    HedgingExecutor* executor,
+    std::shared_ptr<RateLimitingPolicy> const& rate_limiting_policy,
+    std::shared_ptr<RawClient> const& client, MemberFunction function,
+    typename CheckSignature<MemberFunction>::RequestType const& request,
+    char const* error_message) {
+  if (hedging_policy == nullptr || executor == nullptr || !is_idempotent) {
+    return MakeCall(retry_policy, backoff_policy, is_idempotent,
+                    rate_limiting_policy, *client, function, request,
+                    error_message);
+  }
+  using ReturnType = typename CheckSignature<MemberFunction>::ReturnType;
+  // The duplicate request, if any, is sent without consulting the rate
+  // limiter, the hedging budget already caps the additional load.
+  return MakeCallImpl<ReturnType>(
+      retry_policy, backoff_policy, is_idempotent,
+      [&retry_policy, hedging_policy, executor, &rate_limiting_policy, &client,
+       function, &request] {
+        return MakeRateLimitedAttempt(
+            rate_limiting_policy, retry_policy.RemainingTime(), request,
+            [hedging_policy, executor, &client, function, &request] {
+              return MakeHedgedAttempt(*hedging_policy, *executor, client,
+                                       function, request);
+            });
+      },
+      error_message);
+}
 }  // namespace
 
 RetryClient::RetryClient(std::shared_ptr<RawClient> client, DefaultPolicies)
@@ -121,18 +387,31 @@ RetryClient::RetryClient(std::shared_ptr<RawClient> client, DefaultPolicies)
   idempotency_policy_ = AlwaysRetryIdempotencyPolicy().clone();
 }
 
+void RetryClient::Apply(std::shared_ptr<HedgingPolicy> policy) {
+  hedging_policy_ = std::move(policy);
+  if (!hedging_executor_) {
+    // Each hedged operation uses at most two threads.
+    hedging_executor_ = google::cloud::internal::make_unique<HedgingExecutor>(
+        2 * STORAGE_CLIENT_DEFAULT_MAXIMUM_HEDGED_OPERATIONS);
+  }
+}
+
 ClientOptions const& RetryClient::client_options() const {
   return client_->client_options();
 }
 
+ConnectionPoolStats RetryClient::connection_pool_stats() const {
+  return client_->connection_pool_stats();
+}
+
 StatusOr<ListBucketsResponse> RetryClient::ListBuckets(
     ListBucketsRequest const& request) {
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ListBuckets, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ListBuckets, request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::CreateBucket(
@@ -140,9 +419,9 @@ StatusOr<BucketMetadata> RetryClient::CreateBucket(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::CreateBucket, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::CreateBucket, request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::GetBucketMetadata(
@@ -150,9 +429,9 @@ StatusOr<BucketMetadata> RetryClient::GetBucketMetadata(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetBucketMetadata, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetBucketMetadata, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteBucket(
@@ -160,9 +439,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteBucket(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::DeleteBucket, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::DeleteBucket, request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::UpdateBucket(
@@ -170,9 +449,9 @@ StatusOr<BucketMetadata> RetryClient::UpdateBucket(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::UpdateBucket, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::UpdateBucket, request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::PatchBucket(
@@ -180,9 +459,9 @@ StatusOr<BucketMetadata> RetryClient::PatchBucket(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::PatchBucket, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::PatchBucket, request, __func__);
 }
 
 StatusOr<IamPolicy> RetryClient::GetBucketIamPolicy(
@@ -190,9 +469,9 @@ StatusOr<IamPolicy> RetryClient::GetBucketIamPolicy(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetBucketIamPolicy, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetBucketIamPolicy, request, __func__);
 }
 
 StatusOr<IamPolicy> RetryClient::SetBucketIamPolicy(
@@ -200,9 +479,9 @@ StatusOr<IamPolicy> RetryClient::SetBucketIamPolicy(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::SetBucketIamPolicy, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::SetBucketIamPolicy, request, __func__);
 }
 
 StatusOr<TestBucketIamPermissionsResponse>
@@ -211,9 +490,9 @@ RetryClient::TestBucketIamPermissions(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::TestBucketIamPermissions, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::TestBucketIamPermissions, request, __func__);
 }
 
 StatusOr<BucketMetadata> RetryClient::LockBucketRetentionPolicy(
@@ -221,9 +500,9 @@ StatusOr<BucketMetadata> RetryClient::LockBucketRetentionPolicy(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::LockBucketRetentionPolicy, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::LockBucketRetentionPolicy, request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::InsertObjectMedia(
@@ -231,9 +510,9 @@ StatusOr<ObjectMetadata> RetryClient::InsertObjectMedia(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::InsertObjectMedia, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::InsertObjectMedia, request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::CopyObject(
@@ -241,9 +520,9 @@ StatusOr<ObjectMetadata> RetryClient::CopyObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::CopyObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::CopyObject, request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::GetObjectMetadata(
@@ -251,9 +530,10 @@ StatusOr<ObjectMetadata> RetryClient::GetObjectMetadata(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetObjectMetadata, request,
-                  __func__);
+  return MakeHedgedCall(*retry_policy, *backoff_policy, is_idempotent,
+                        hedging_policy_.get(), hedging_executor_.get(),
+                        rate_limiting_policy_, client_,
+                        &RawClient::GetObjectMetadata, request, __func__);
 }
 
 StatusOr<std::unique_ptr<ObjectReadStreambuf>> RetryClient::ReadObject(
@@ -261,9 +541,10 @@ StatusOr<std::unique_ptr<ObjectReadStreambuf>> RetryClient::ReadObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ReadObject, request,
-                  __func__);
+  return MakeHedgedCall(*retry_policy, *backoff_policy, is_idempotent,
+                        hedging_policy_.get(), hedging_executor_.get(),
+                        rate_limiting_policy_, client_,
+                        &RawClient::ReadObject, request, __func__);
 }
 
 StatusOr<std::unique_ptr<ObjectWriteStreambuf>>
@@ -272,9 +553,9 @@ RetryClient::WriteObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::WriteObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::WriteObject, request, __func__);
 }
 
 StatusOr<ListObjectsResponse> RetryClient::ListObjects(
@@ -282,9 +563,9 @@ StatusOr<ListObjectsResponse> RetryClient::ListObjects(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ListObjects, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ListObjects, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteObject(
@@ -292,9 +573,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::DeleteObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::DeleteObject, request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::UpdateObject(
@@ -302,9 +583,9 @@ StatusOr<ObjectMetadata> RetryClient::UpdateObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::UpdateObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::UpdateObject, request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::PatchObject(
@@ -312,9 +593,9 @@ StatusOr<ObjectMetadata> RetryClient::PatchObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::PatchObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::PatchObject, request, __func__);
 }
 
 StatusOr<ObjectMetadata> RetryClient::ComposeObject(
@@ -322,9 +603,9 @@ StatusOr<ObjectMetadata> RetryClient::ComposeObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ComposeObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ComposeObject, request, __func__);
 }
 
 StatusOr<RewriteObjectResponse> RetryClient::RewriteObject(
@@ -332,9 +613,9 @@ StatusOr<RewriteObjectResponse> RetryClient::RewriteObject(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::RewriteObject, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::RewriteObject, request, __func__);
 }
 
 StatusOr<std::unique_ptr<ResumableUploadSession>>
@@ -343,8 +624,8 @@ RetryClient::CreateResumableSession(ResumableUploadRequest const& request) {
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
   auto result = MakeCall(*retry_policy, *backoff_policy, is_idempotent,
-                         *client_, &RawClient::CreateResumableSession, request,
-                         __func__);
+                         rate_limiting_policy_, *client_,
+                         &RawClient::CreateResumableSession, request, __func__);
   if (!result.ok()) {
     return result;
   }
@@ -360,9 +641,9 @@ RetryClient::RestoreResumableSession(std::string const& request) {
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = true;
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::RestoreResumableSession, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::RestoreResumableSession, request, __func__);
 }
 
 StatusOr<ListBucketAclResponse> RetryClient::ListBucketAcl(
@@ -370,9 +651,9 @@ StatusOr<ListBucketAclResponse> RetryClient::ListBucketAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ListBucketAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ListBucketAcl, request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::GetBucketAcl(
@@ -380,9 +661,9 @@ StatusOr<BucketAccessControl> RetryClient::GetBucketAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetBucketAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetBucketAcl, request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::CreateBucketAcl(
@@ -390,9 +671,9 @@ StatusOr<BucketAccessControl> RetryClient::CreateBucketAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::CreateBucketAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::CreateBucketAcl, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteBucketAcl(
@@ -400,9 +681,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteBucketAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::DeleteBucketAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::DeleteBucketAcl, request, __func__);
 }
 
 StatusOr<ListObjectAclResponse> RetryClient::ListObjectAcl(
@@ -410,9 +691,9 @@ StatusOr<ListObjectAclResponse> RetryClient::ListObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ListObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ListObjectAcl, request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::UpdateBucketAcl(
@@ -420,9 +701,9 @@ StatusOr<BucketAccessControl> RetryClient::UpdateBucketAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::UpdateBucketAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::UpdateBucketAcl, request, __func__);
 }
 
 StatusOr<BucketAccessControl> RetryClient::PatchBucketAcl(
@@ -430,9 +711,9 @@ StatusOr<BucketAccessControl> RetryClient::PatchBucketAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::PatchBucketAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::PatchBucketAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::CreateObjectAcl(
@@ -440,9 +721,9 @@ StatusOr<ObjectAccessControl> RetryClient::CreateObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::CreateObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::CreateObjectAcl, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteObjectAcl(
@@ -450,9 +731,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::DeleteObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::DeleteObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::GetObjectAcl(
@@ -460,9 +741,9 @@ StatusOr<ObjectAccessControl> RetryClient::GetObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::UpdateObjectAcl(
@@ -470,9 +751,9 @@ StatusOr<ObjectAccessControl> RetryClient::UpdateObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::UpdateObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::UpdateObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::PatchObjectAcl(
@@ -480,9 +761,9 @@ StatusOr<ObjectAccessControl> RetryClient::PatchObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::PatchObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::PatchObjectAcl, request, __func__);
 }
 
 StatusOr<ListDefaultObjectAclResponse>
@@ -490,9 +771,9 @@ RetryClient::ListDefaultObjectAcl(ListDefaultObjectAclRequest const& request) {
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ListDefaultObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ListDefaultObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::CreateDefaultObjectAcl(
@@ -500,9 +781,9 @@ StatusOr<ObjectAccessControl> RetryClient::CreateDefaultObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::CreateDefaultObjectAcl, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::CreateDefaultObjectAcl, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteDefaultObjectAcl(
@@ -510,9 +791,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteDefaultObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::DeleteDefaultObjectAcl, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::DeleteDefaultObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::GetDefaultObjectAcl(
@@ -520,9 +801,9 @@ StatusOr<ObjectAccessControl> RetryClient::GetDefaultObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetDefaultObjectAcl, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetDefaultObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::UpdateDefaultObjectAcl(
@@ -530,9 +811,9 @@ StatusOr<ObjectAccessControl> RetryClient::UpdateDefaultObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::UpdateDefaultObjectAcl, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::UpdateDefaultObjectAcl, request, __func__);
 }
 
 StatusOr<ObjectAccessControl> RetryClient::PatchDefaultObjectAcl(
@@ -540,9 +821,9 @@ StatusOr<ObjectAccessControl> RetryClient::PatchDefaultObjectAcl(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::PatchDefaultObjectAcl, request,
-                   __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::PatchDefaultObjectAcl, request, __func__);
 }
 
 StatusOr<ServiceAccount> RetryClient::GetServiceAccount(
@@ -550,9 +831,9 @@ StatusOr<ServiceAccount> RetryClient::GetServiceAccount(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetServiceAccount, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetServiceAccount, request, __func__);
 }
 
 StatusOr<ListNotificationsResponse> RetryClient::ListNotifications(
@@ -560,9 +841,9 @@ StatusOr<ListNotificationsResponse> RetryClient::ListNotifications(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::ListNotifications, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::ListNotifications, request, __func__);
 }
 
 StatusOr<NotificationMetadata> RetryClient::CreateNotification(
@@ -570,9 +851,9 @@ StatusOr<NotificationMetadata> RetryClient::CreateNotification(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::CreateNotification, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::CreateNotification, request, __func__);
 }
 
 StatusOr<NotificationMetadata> RetryClient::GetNotification(
@@ -580,9 +861,9 @@ StatusOr<NotificationMetadata> RetryClient::GetNotification(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::GetNotification, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::GetNotification, request, __func__);
 }
 
 StatusOr<EmptyResponse> RetryClient::DeleteNotification(
@@ -590,9 +871,9 @@ StatusOr<EmptyResponse> RetryClient::DeleteNotification(
   auto retry_policy = retry_policy_->clone();
   auto backoff_policy = backoff_policy_->clone();
   auto is_idempotent = idempotency_policy_->IsIdempotent(request);
-  return MakeCall(*retry_policy, *backoff_policy, is_idempotent, *client_,
-                  &RawClient::DeleteNotification, request,
-                  __func__);
+  return MakeCall(*retry_policy, *backoff_policy, is_idempotent,
+                  rate_limiting_policy_, *client_,
+                  &RawClient::DeleteNotification, request, __func__);
 }
 
 }  // namespace internal
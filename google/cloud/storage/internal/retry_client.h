@@ -15,11 +15,22 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_RETRY_CLIENT_H_
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_RETRY_CLIENT_H_
 
+#include "google/cloud/storage/download_cache.h"
+#include "google/cloud/storage/hedging_policy.h"
 #include "google/cloud/storage/idempotency_policy.h"
+#include "google/cloud/storage/internal/hedging_executor.h"
 #include "google/cloud/storage/internal/raw_client.h"
 #include "google/cloud/storage/internal/resumable_upload_session.h"
+#include "google/cloud/storage/rate_limiting_policy.h"
 #include "google/cloud/storage/retry_policy.h"
 
+// The maximum number of operations hedged concurrently by each client, any
+// other operations run without hedging. Applications can change the default
+// by compiling with a different value.
+#ifndef STORAGE_CLIENT_DEFAULT_MAXIMUM_HEDGED_OPERATIONS
+#define STORAGE_CLIENT_DEFAULT_MAXIMUM_HEDGED_OPERATIONS 16
+#endif  // STORAGE_CLIENT_DEFAULT_MAXIMUM_HEDGED_OPERATIONS
+
 namespace google {
 namespace cloud {
 namespace storage {
@@ -45,6 +56,7 @@ class RetryClient : public RawClient {
   ~RetryClient() override = default;
 
   ClientOptions const& client_options() const override;
+  ConnectionPoolStats connection_pool_stats() const override;
 
   StatusOr<ListBucketsResponse> ListBuckets(
       ListBucketsRequest const& request) override;
@@ -153,6 +165,23 @@ class RetryClient : public RawClient {
     idempotency_policy_ = policy.clone();
   }
 
+  void Apply(HedgingPolicy& policy) {
+    Apply(std::shared_ptr<HedgingPolicy>(policy.clone()));
+  }
+
+  void Apply(std::shared_ptr<HedgingPolicy> policy);
+
+  void Apply(RateLimitingPolicy& policy) {
+    rate_limiting_policy_ = policy.clone();
+  }
+
+  void Apply(std::shared_ptr<RateLimitingPolicy> policy) {
+    rate_limiting_policy_ = std::move(policy);
+  }
+
+  // The cache is used by `CachingClient`, which decorates this class.
+  void Apply(std::shared_ptr<DownloadCache> const&) {}
+
   void ApplyPolicies() {}
 
   template <typename P, typename... Policies>
@@ -165,6 +194,16 @@ class RetryClient : public RawClient {
   std::shared_ptr<RetryPolicy> retry_policy_;
   std::shared_ptr<BackoffPolicy> backoff_policy_;
   std::shared_ptr<IdempotencyPolicy> idempotency_policy_;
+  // Unlike the other policies this one is not cloned for each request, it
+  // needs to observe the latency of all the requests.
+  std::shared_ptr<HedgingPolicy> hedging_policy_;
+  // Shared by all the requests for the same reason, the rate limits apply to
+  // the aggregate traffic of the client.
+  std::shared_ptr<RateLimitingPolicy> rate_limiting_policy_;
+  // Runs the hedged attempts, it is only created with a hedging policy. This
+  // is the last member, so its threads are joined before `client_` and the
+  // policies are destroyed.
+  std::unique_ptr<HedgingExecutor> hedging_executor_;
 };
 
 }  // namespace internal
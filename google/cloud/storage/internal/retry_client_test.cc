@@ -13,10 +13,15 @@
 // limitations under the License.
 
 #include "google/cloud/storage/internal/retry_client.h"
+#include "google/cloud/storage/internal/http_response_observer.h"
 #include "google/cloud/storage/testing/canonical_errors.h"
 #include "google/cloud/storage/testing/mock_client.h"
 #include "google/cloud/testing_util/chrono_literals.h"
+#include "google/cloud/internal/make_unique.h"
 #include <gmock/gmock.h>
+#include <atomic>
+#include <future>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -26,6 +31,7 @@ namespace internal {
 namespace {
 using ::testing::_;
 using ::testing::HasSubstr;
+using ::testing::Invoke;
 using ::testing::Return;
 using testing::canonical_errors::PermanentError;
 using testing::canonical_errors::TransientError;
@@ -90,6 +96,355 @@ TEST_F(RetryClientTest, TooManyTransientsHandling) {
   EXPECT_EQ(TransientError().code(), result.status().code());
 }
 
+/// A hedging policy for the tests, it always hedges after a fixed delay.
+class TestHedgingPolicy : public HedgingPolicy {
+ public:
+  explicit TestHedgingPolicy(std::chrono::milliseconds delay)
+      : delay_(delay) {}
+
+  std::unique_ptr<HedgingPolicy> clone() const override {
+    return google::cloud::internal::make_unique<TestHedgingPolicy>(delay_);
+  }
+  std::chrono::milliseconds HedgeDelay() override { return delay_; }
+  bool OnHedge() override {
+    ++hedge_count;
+    return true;
+  }
+  void OnCompletion(std::chrono::milliseconds, bool, bool won) override {
+    ++completion_count;
+    hedge_won = won;
+  }
+
+  std::chrono::milliseconds delay_;
+  std::atomic<int> hedge_count{0};
+  std::atomic<int> completion_count{0};
+  std::atomic<bool> hedge_won{false};
+};
+
+/// @test Verify that a slow request is hedged and the fastest result is used.
+TEST_F(RetryClientTest, HedgedSlowRequest) {
+  auto policy = std::make_shared<TestHedgingPolicy>(10_ms);
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock),
+                     LimitedErrorCountRetryPolicy(3), policy,
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  std::promise<bool> slow_cancelled;
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Invoke([&slow_cancelled](GetObjectMetadataRequest const&) {
+        // Block until the request is cancelled, like a stalled download.
+        auto flag = CurrentCancellationFlag();
+        for (int i = 0; i != 500 && flag && !flag->load(); ++i) {
+          std::this_thread::sleep_for(10_ms);
+        }
+        slow_cancelled.set_value(flag && flag->load());
+        return StatusOr<ObjectMetadata>(TransientError());
+      }))
+      .WillOnce(Invoke([](GetObjectMetadataRequest const& r) {
+        ObjectMetadata meta;
+        meta.upsert_metadata("object", r.object_name());
+        return make_status_or(meta);
+      }));
+
+  StatusOr<ObjectMetadata> result = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_EQ("test-object", result->metadata("object"));
+  EXPECT_EQ(1, policy->hedge_count.load());
+  EXPECT_EQ(1, policy->completion_count.load());
+  EXPECT_TRUE(policy->hedge_won.load());
+  EXPECT_TRUE(slow_cancelled.get_future().get());
+}
+
+/// @test Verify that requests are not hedged if the executor is busy.
+TEST_F(RetryClientTest, HedgedExecutorExhausted) {
+  auto policy = std::make_shared<TestHedgingPolicy>(1_ms);
+  auto client = std::make_shared<RetryClient>(
+      std::shared_ptr<internal::RawClient>(mock),
+      LimitedErrorCountRetryPolicy(3), policy,
+      // Make the tests faster.
+      ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  // Block all the hedging threads with slow requests, one at a time so each
+  // request takes two threads.
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic<int> blocked{0};
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillRepeatedly(Invoke([&](GetObjectMetadataRequest const& r) {
+        if (r.object_name() == "fast") {
+          return make_status_or(ObjectMetadata{});
+        }
+        ++blocked;
+        released.wait();
+        return StatusOr<ObjectMetadata>(PermanentError());
+      }));
+
+  std::vector<std::thread> slow;
+  int const operations = STORAGE_CLIENT_DEFAULT_MAXIMUM_HEDGED_OPERATIONS;
+  for (int i = 0; i != operations; ++i) {
+    slow.emplace_back([client] {
+      client->GetObjectMetadata(GetObjectMetadataRequest("bkt", "slow"));
+    });
+    while (blocked.load() != 2 * (i + 1)) {
+      std::this_thread::sleep_for(1_ms);
+    }
+  }
+
+  // The fast request runs in this thread, without hedging.
+  auto hedge_count = policy->hedge_count.load();
+  StatusOr<ObjectMetadata> result =
+      client->GetObjectMetadata(GetObjectMetadataRequest("bkt", "fast"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_EQ(hedge_count, policy->hedge_count.load());
+
+  release.set_value();
+  for (auto& t : slow) {
+    t.join();
+  }
+}
+
+/// @test Verify that fast requests are not hedged.
+TEST_F(RetryClientTest, HedgedFastRequest) {
+  auto policy = std::make_shared<TestHedgingPolicy>(std::chrono::seconds(10));
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock),
+                     LimitedErrorCountRetryPolicy(3), policy,
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*mock, GetObjectMetadata(_))
+      .WillOnce(Return(StatusOr<ObjectMetadata>(TransientError())))
+      .WillOnce(Return(make_status_or(ObjectMetadata{})));
+
+  StatusOr<ObjectMetadata> result = client.GetObjectMetadata(
+      GetObjectMetadataRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_EQ(0, policy->hedge_count.load());
+  EXPECT_EQ(2, policy->completion_count.load());
+  EXPECT_FALSE(policy->hedge_won.load());
+}
+
+/// A download for the tests, it can stall or fail before the first response.
+class TestReadStreambuf : public ObjectReadStreambuf {
+ public:
+  explicit TestReadStreambuf(bool stalled, Status status = Status())
+      : stalled_(stalled),
+        flag_(CurrentCancellationFlag()),
+        status_(std::move(status)) {}
+
+  void Close() override {}
+  bool IsOpen() const override { return true; }
+  Status const& status() const override { return status_; }
+  std::string const& received_hash() const override { return hash_; }
+  std::string const& computed_hash() const override { return hash_; }
+  std::multimap<std::string, std::string> const& headers() const override {
+    return headers_;
+  }
+  Status WaitForFirstResponse() override {
+    // Block until the request is cancelled, like a stalled download.
+    for (int i = 0; i != 500 && stalled_ && flag_ && !flag_->load(); ++i) {
+      std::this_thread::sleep_for(10_ms);
+    }
+    if (stalled_) {
+      status_ = TransientError();
+    }
+    return status_;
+  }
+
+ private:
+  bool stalled_;
+  CancellationFlag flag_;
+  Status status_;
+  std::string hash_;
+  std::multimap<std::string, std::string> headers_;
+};
+
+StatusOr<std::unique_ptr<ObjectReadStreambuf>> MakeTestReadStreambuf(
+    bool stalled, Status status = Status()) {
+  return std::unique_ptr<ObjectReadStreambuf>(
+      new TestReadStreambuf(stalled, std::move(status)));
+}
+
+/// @test Verify that downloads are hedged until their first response.
+TEST_F(RetryClientTest, HedgedReadObjectStalled) {
+  auto policy = std::make_shared<TestHedgingPolicy>(10_ms);
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock),
+                     LimitedErrorCountRetryPolicy(3), policy,
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*mock, ReadObject(_))
+      .WillOnce(Invoke([](ReadObjectRangeRequest const&) {
+        return MakeTestReadStreambuf(true);
+      }))
+      .WillOnce(Invoke([](ReadObjectRangeRequest const&) {
+        return MakeTestReadStreambuf(false);
+      }));
+
+  auto result =
+      client.ReadObject(ReadObjectRangeRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_TRUE((*result)->status().ok());
+  EXPECT_EQ(1, policy->hedge_count.load());
+  EXPECT_TRUE(policy->hedge_won.load());
+}
+
+/// @test Verify that errors in the first response of a download are retried.
+TEST_F(RetryClientTest, HedgedReadObjectRetriesFirstResponse) {
+  auto policy = std::make_shared<TestHedgingPolicy>(std::chrono::seconds(10));
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock),
+                     LimitedErrorCountRetryPolicy(3), policy,
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*mock, ReadObject(_))
+      .WillOnce(Invoke([](ReadObjectRangeRequest const&) {
+        return MakeTestReadStreambuf(false, TransientError());
+      }))
+      .WillOnce(Invoke([](ReadObjectRangeRequest const&) {
+        return MakeTestReadStreambuf(false);
+      }));
+
+  auto result =
+      client.ReadObject(ReadObjectRangeRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_EQ(0, policy->hedge_count.load());
+  EXPECT_EQ(2, policy->completion_count.load());
+}
+
+/// A rate limiting policy for the tests, it records the calls.
+class TestRateLimitingPolicy : public RateLimitingPolicy {
+ public:
+  std::unique_ptr<RateLimitingPolicy> clone() const override {
+    return google::cloud::internal::make_unique<TestRateLimitingPolicy>();
+  }
+  bool Admit(std::string const& bucket_name, std::string const& object_name,
+             std::chrono::milliseconds maximum_wait) override {
+    admitted.push_back(bucket_name + "/" + object_name);
+    maximum_waits.push_back(maximum_wait);
+    return admit;
+  }
+  void OnResponse(std::string const&, std::string const&,
+                  long http_status_code) override {
+    responses.push_back(http_status_code);
+  }
+
+  bool admit = true;
+  std::vector<std::string> admitted;
+  std::vector<std::chrono::milliseconds> maximum_waits;
+  std::vector<long> responses;
+};
+
+/// Simulate a response from the service in a mocked request.
+void ReportResponse(long http_status_code) {
+  auto observer = CurrentHttpResponseObserver();
+  ASSERT_TRUE(static_cast<bool>(observer));
+  observer(http_status_code);
+}
+
+/// @test Verify that each attempt is admitted by the rate limiting policy.
+TEST_F(RetryClientTest, RateLimitedRetries) {
+  auto policy = std::make_shared<TestRateLimitingPolicy>();
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock),
+                     LimitedErrorCountRetryPolicy(3), policy,
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*mock, DeleteObject(_))
+      .WillOnce(Invoke([](DeleteObjectRequest const&) {
+        ReportResponse(503);
+        return StatusOr<EmptyResponse>(TransientError());
+      }))
+      .WillOnce(Invoke([](DeleteObjectRequest const&) {
+        // A network error, the service never responds.
+        return StatusOr<EmptyResponse>(TransientError());
+      }))
+      .WillOnce(Invoke([](DeleteObjectRequest const&) {
+        ReportResponse(204);
+        return make_status_or(EmptyResponse{});
+      }));
+
+  StatusOr<EmptyResponse> result =
+      client.DeleteObject(DeleteObjectRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_THAT(policy->admitted,
+              ::testing::ElementsAre("test-bucket/test-object",
+                                     "test-bucket/test-object",
+                                     "test-bucket/test-object"));
+  // Only the responses from the service are reported.
+  EXPECT_THAT(policy->responses, ::testing::ElementsAre(503, 204));
+  // The retry policy has no time limit.
+  EXPECT_THAT(policy->maximum_waits,
+              ::testing::Each(std::chrono::milliseconds::max()));
+}
+
+/// @test Verify that the wait for the rate limiting policy is bounded.
+TEST_F(RetryClientTest, RateLimitedRejected) {
+  auto policy = std::make_shared<TestRateLimitingPolicy>();
+  policy->admit = false;
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock),
+                     LimitedTimeRetryPolicy(std::chrono::seconds(10)), policy,
+                     // Make the tests faster.
+                     ExponentialBackoffPolicy(1_us, 2_us, 2));
+
+  EXPECT_CALL(*mock, DeleteObject(_)).Times(0);
+
+  StatusOr<EmptyResponse> result =
+      client.DeleteObject(DeleteObjectRequest("test-bucket", "test-object"));
+  EXPECT_EQ(StatusCode::kResourceExhausted, result.status().code());
+  // The operation fails on the first rejection, it does not retry.
+  ASSERT_EQ(1U, policy->maximum_waits.size());
+  EXPECT_GT(policy->maximum_waits[0], std::chrono::milliseconds(0));
+  EXPECT_LE(policy->maximum_waits[0], std::chrono::milliseconds(10000));
+}
+
+/// @test Verify that responses streamed after an attempt are reported.
+TEST_F(RetryClientTest, RateLimitedReportsLateResponses) {
+  auto policy = std::make_shared<TestRateLimitingPolicy>();
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock), policy);
+
+  HttpResponseObserver observer;
+  EXPECT_CALL(*mock, DeleteObject(_))
+      .WillOnce(Invoke([&observer](DeleteObjectRequest const&) {
+        // Simulate a download, which captures the observer and reports the
+        // response when the data arrives.
+        observer = CurrentHttpResponseObserver();
+        return make_status_or(EmptyResponse{});
+      }));
+
+  auto result =
+      client.DeleteObject(DeleteObjectRequest("test-bucket", "test-object"));
+  ASSERT_TRUE(result.ok()) << "status=" << result.status();
+  EXPECT_TRUE(policy->responses.empty());
+  EXPECT_FALSE(static_cast<bool>(CurrentHttpResponseObserver()));
+
+  ASSERT_TRUE(static_cast<bool>(observer));
+  observer(429);
+  EXPECT_THAT(policy->responses, ::testing::ElementsAre(429));
+}
+
+/// @test Verify that copies are rate limited by their destination.
+TEST_F(RetryClientTest, RateLimitedCopyUsesDestination) {
+  auto policy = std::make_shared<TestRateLimitingPolicy>();
+  RetryClient client(std::shared_ptr<internal::RawClient>(mock), policy);
+
+  EXPECT_CALL(*mock, CopyObject(_))
+      .WillOnce(Return(make_status_or(ObjectMetadata{})));
+  EXPECT_CALL(*mock, ListBuckets(_))
+      .WillOnce(Return(make_status_or(ListBucketsResponse{})));
+
+  auto copy = client.CopyObject(
+      CopyObjectRequest("source-bucket", "source-object", "destination-bucket",
+                        "destination-object"));
+  ASSERT_TRUE(copy.ok()) << "status=" << copy.status();
+  auto list = client.ListBuckets(ListBucketsRequest("test-project"));
+  ASSERT_TRUE(list.ok()) << "status=" << list.status();
+
+  EXPECT_THAT(policy->admitted,
+              ::testing::ElementsAre("destination-bucket/destination-object",
+                                     "/"));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace STORAGE_CLIENT_NS
@@ -0,0 +1,303 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/upload_checkpoint.h"
+#include "google/cloud/internal/big_endian.h"
+#include "google/cloud/storage/internal/metadata_parser.h"
+#include "google/cloud/storage/internal/nljson.h"
+#include "google/cloud/storage/internal/openssl_util.h"
+#include <crc32c/crc32c.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+/// The buffer size used to hash data committed before a restart.
+std::size_t const kCatchUpBufferSize = 1024 * 1024;
+
+std::string EncodeCrc32c(std::uint32_t crc32c) {
+  std::uint32_t big_endian = google::cloud::internal::ToBigEndian(crc32c);
+  std::string hash(sizeof(big_endian), '\0');
+  std::memcpy(&hash[0], &big_endian, sizeof(big_endian));
+  return OpenSslUtils::Base64Encode(hash);
+}
+
+std::string EncodeMD5(MD5_CTX context) {
+  std::string hash(MD5_DIGEST_LENGTH, ' ');
+  MD5_Final(reinterpret_cast<unsigned char*>(&hash[0]), &context);
+  return OpenSslUtils::Base64Encode(hash);
+}
+}  // namespace
+
+UploadCheckpoint::UploadCheckpoint(std::string bucket_name,
+                                   std::string object_name,
+                                   std::string source_file,
+                                   std::uint64_t source_size, bool disable_md5,
+                                   bool disable_crc32c)
+    : bucket_name_(std::move(bucket_name)),
+      object_name_(std::move(object_name)),
+      source_file_(std::move(source_file)),
+      source_size_(source_size),
+      disable_md5_(disable_md5),
+      disable_crc32c_(disable_crc32c),
+      committed_bytes_(0),
+      crc32c_(0),
+      md5_{} {
+  ResetHashes();
+}
+
+StatusOr<UploadCheckpoint> UploadCheckpoint::Load(std::string const& path) {
+  std::ifstream is(path, std::ios::binary);
+  if (!is.is_open()) {
+    return Status(StatusCode::kNotFound, "cannot open checkpoint " + path);
+  }
+  std::string contents{std::istreambuf_iterator<char>{is}, {}};
+  auto json = nl::json::parse(contents, nullptr, false);
+  auto invalid = [&path](char const* field) {
+    return Status(StatusCode::kInvalidArgument,
+                  "invalid checkpoint " + path + ", bad field " + field);
+  };
+  if (!json.is_object()) {
+    return invalid("<root>");
+  }
+  for (char const* field :
+       {"bucket", "object", "source_file", "session_id", "md5_context"}) {
+    if (!json[field].is_string()) {
+      return invalid(field);
+    }
+  }
+  for (char const* field : {"source_size", "committed_bytes", "crc32c"}) {
+    if (!json[field].is_number_unsigned()) {
+      return invalid(field);
+    }
+  }
+  for (char const* field : {"disable_md5", "disable_crc32c"}) {
+    if (!json[field].is_boolean()) {
+      return invalid(field);
+    }
+  }
+  UploadCheckpoint checkpoint(
+      json["bucket"].get<std::string>(), json["object"].get<std::string>(),
+      json["source_file"].get<std::string>(),
+      json["source_size"].get<std::uint64_t>(), json["disable_md5"].get<bool>(),
+      json["disable_crc32c"].get<bool>());
+  checkpoint.session_id_ = json["session_id"].get<std::string>();
+  checkpoint.committed_bytes_ = json["committed_bytes"].get<std::uint64_t>();
+  checkpoint.crc32c_ =
+      static_cast<std::uint32_t>(json["crc32c"].get<std::uint64_t>());
+  auto md5 =
+      OpenSslUtils::Base64Decode(json["md5_context"].get<std::string>());
+  if (md5.size() != sizeof(checkpoint.md5_)) {
+    return invalid("md5_context");
+  }
+  std::memcpy(&checkpoint.md5_, md5.data(), md5.size());
+  return checkpoint;
+}
+
+Status UploadCheckpoint::Save(std::string const& path) const {
+  nl::json json{
+      {"bucket", bucket_name_},
+      {"object", object_name_},
+      {"source_file", source_file_},
+      {"source_size", source_size_},
+      {"disable_md5", disable_md5_},
+      {"disable_crc32c", disable_crc32c_},
+      {"session_id", session_id_},
+      {"committed_bytes", committed_bytes_},
+      {"crc32c", crc32c_},
+      {"md5_context",
+       OpenSslUtils::Base64Encode(std::string(
+           reinterpret_cast<char const*>(&md5_), sizeof(md5_)))},
+  };
+  auto const temporary = path + ".tmp";
+  std::ofstream os(temporary, std::ios::binary | std::ios::trunc);
+  os << json.dump();
+  os.close();
+  if (!os) {
+    std::remove(temporary.c_str());
+    return Status(StatusCode::kUnavailable,
+                  "cannot write checkpoint " + temporary);
+  }
+#if _WIN32
+  // rename() does not replace existing files on Windows.
+  std::remove(path.c_str());
+#endif  // _WIN32
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    return Status(StatusCode::kUnavailable,
+                  "cannot rename " + temporary + " to " + path);
+  }
+  return Status();
+}
+
+bool UploadCheckpoint::SameUpload(UploadCheckpoint const& other) const {
+  return !session_id_.empty() && bucket_name_ == other.bucket_name_ &&
+         object_name_ == other.object_name_ &&
+         source_file_ == other.source_file_ &&
+         source_size_ == other.source_size_ &&
+         disable_md5_ == other.disable_md5_ &&
+         disable_crc32c_ == other.disable_crc32c_;
+}
+
+void UploadCheckpoint::Commit(char const* data, std::size_t size) {
+  if (!disable_crc32c_) {
+    crc32c_ = crc32c::Extend(
+        crc32c_, reinterpret_cast<std::uint8_t const*>(data), size);
+  }
+  if (!disable_md5_) {
+    MD5_Update(&md5_, data, size);
+  }
+  committed_bytes_ += size;
+}
+
+Status UploadCheckpoint::CatchUp(std::istream& source,
+                                 std::uint64_t committed_bytes) {
+  if (committed_bytes < committed_bytes_) {
+    ResetHashes();
+  }
+  if (committed_bytes == committed_bytes_) {
+    return Status();
+  }
+  source.clear();
+  source.seekg(static_cast<std::streamoff>(committed_bytes_));
+  std::vector<char> buffer(kCatchUpBufferSize);
+  while (committed_bytes_ < committed_bytes) {
+    auto const n = static_cast<std::size_t>(std::min<std::uint64_t>(
+        buffer.size(), committed_bytes - committed_bytes_));
+    source.read(buffer.data(), n);
+    if (static_cast<std::size_t>(source.gcount()) != n) {
+      return Status(StatusCode::kFailedPrecondition,
+                    "the source is shorter than the data committed by the"
+                    " service");
+    }
+    Commit(buffer.data(), n);
+  }
+  return Status();
+}
+
+Status UploadCheckpoint::ValidateHashes(ObjectMetadata const& metadata) const {
+  std::string computed;
+  std::string received;
+  bool is_mismatch = false;
+  if (!disable_crc32c_) {
+    auto value = EncodeCrc32c(crc32c_);
+    is_mismatch = is_mismatch ||
+                  (!metadata.crc32c().empty() && metadata.crc32c() != value);
+    computed += "crc32c=" + value;
+    received += "crc32c=" + metadata.crc32c();
+  }
+  if (!disable_md5_) {
+    auto value = EncodeMD5(md5_);
+    is_mismatch =
+        is_mismatch ||
+        (!metadata.md5_hash().empty() && metadata.md5_hash() != value);
+    computed += (computed.empty() ? "md5=" : ",md5=") + value;
+    received += (received.empty() ? "md5=" : ",md5=") + metadata.md5_hash();
+  }
+  if (!is_mismatch) {
+    return Status();
+  }
+  return Status(StatusCode::kDataLoss,
+                "mismatched hashes in upload, expected=" + computed +
+                    ", received=" + received);
+}
+
+void UploadCheckpoint::ResetHashes() {
+  committed_bytes_ = 0;
+  crc32c_ = 0;
+  MD5_Init(&md5_);
+}
+
+StatusOr<ObjectMetadata> UploadWithCheckpoint(
+    ResumableUploadSession& session, std::istream& source,
+    std::size_t chunk_size, UploadCheckpoint& checkpoint,
+    std::string const& checkpoint_path) {
+  auto status = checkpoint.CatchUp(source, session.next_expected_byte());
+  if (!status.ok()) {
+    return status;
+  }
+  checkpoint.set_session_id(session.session_id());
+  status = checkpoint.Save(checkpoint_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string buffer;
+  while (true) {
+    // Always continue from the last byte committed by the service, the data
+    // before it is never read again.
+    auto const offset = session.next_expected_byte();
+    source.clear();
+    source.seekg(static_cast<std::streamoff>(offset));
+    buffer.resize(chunk_size);
+    source.read(&buffer[0], buffer.size());
+    buffer.resize(static_cast<std::size_t>(source.gcount()));
+    auto upload_size = checkpoint.source_size();
+    bool const last_chunk = buffer.size() < chunk_size ||
+                            offset + buffer.size() == upload_size;
+    if (buffer.size() < chunk_size) {
+      upload_size = offset + buffer.size();
+    }
+
+    auto response = session.UploadChunk(buffer, upload_size);
+    if (!response) {
+      return std::move(response).status();
+    }
+    if (!response->payload.empty() ||
+        (last_chunk && session.next_expected_byte() == upload_size)) {
+      checkpoint.Commit(buffer.data(), buffer.size());
+      auto metadata = ObjectMetadataParser::FromString(response->payload);
+      // The session is finalized, the checkpoint cannot be used again.
+      std::remove(checkpoint_path.c_str());
+      if (!metadata) {
+        return std::move(metadata).status();
+      }
+      status = checkpoint.ValidateHashes(*metadata);
+      if (!status.ok()) {
+        return status;
+      }
+      return metadata;
+    }
+
+    auto const committed = session.next_expected_byte();
+    if (committed >= offset && committed <= offset + buffer.size()) {
+      checkpoint.Commit(buffer.data(),
+                        static_cast<std::size_t>(committed - offset));
+    } else {
+      status = checkpoint.CatchUp(source, committed);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    checkpoint.set_session_id(session.session_id());
+    status = checkpoint.Save(checkpoint_path);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
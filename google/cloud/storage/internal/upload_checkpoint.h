@@ -0,0 +1,128 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_UPLOAD_CHECKPOINT_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_UPLOAD_CHECKPOINT_H_
+
+#include "google/cloud/status_or.h"
+#include "google/cloud/storage/internal/resumable_upload_session.h"
+#include "google/cloud/storage/object_metadata.h"
+#include <openssl/md5.h>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+/**
+ * The state of a resumable upload, as saved by `UseUploadCheckpoint`.
+ *
+ * Besides the session id this records how many bytes the service has
+ * committed, and the CRC32C and MD5 hashes of those bytes. The hashes are
+ * updated only with committed data, so an upload restored from a checkpoint
+ * continues hashing where the service continues receiving.
+ *
+ * The MD5 state is saved as the raw contents of the OpenSSL context, the
+ * checkpoint files are only meant to be used on the machine that created them.
+ */
+class UploadCheckpoint {
+ public:
+  UploadCheckpoint(std::string bucket_name, std::string object_name,
+                   std::string source_file, std::uint64_t source_size,
+                   bool disable_md5, bool disable_crc32c);
+
+  /**
+   * Load a checkpoint saved by `Save()`.
+   *
+   * @return the checkpoint, `kNotFound` if the file does not exist, or
+   *     `kInvalidArgument` if it cannot be parsed.
+   */
+  static StatusOr<UploadCheckpoint> Load(std::string const& path);
+
+  /// Atomically replace the contents of @p path with this checkpoint.
+  Status Save(std::string const& path) const;
+
+  /// Return true if @p other describes the same upload as this checkpoint.
+  bool SameUpload(UploadCheckpoint const& other) const;
+
+  std::string const& bucket_name() const { return bucket_name_; }
+  std::string const& object_name() const { return object_name_; }
+  std::string const& source_file() const { return source_file_; }
+  std::uint64_t source_size() const { return source_size_; }
+
+  std::string const& session_id() const { return session_id_; }
+  void set_session_id(std::string session_id) {
+    session_id_ = std::move(session_id);
+  }
+
+  /// The number of bytes committed by the service, and hashed.
+  std::uint64_t committed_bytes() const { return committed_bytes_; }
+
+  /// Update the hashes with the next @p size committed bytes.
+  void Commit(char const* data, std::size_t size);
+
+  /**
+   * Update the hashes to cover the first @p committed_bytes of @p source.
+   *
+   * If the service committed more data than the checkpoint recorded, for
+   * example because the program crashed before saving the checkpoint, only the
+   * missing range is read. If it committed less, the hashes are computed
+   * again from the start of @p source.
+   */
+  Status CatchUp(std::istream& source, std::uint64_t committed_bytes);
+
+  /**
+   * Compare the hashes of the uploaded data against the object metadata.
+   *
+   * @return an error with `kDataLoss` if the hashes do not match.
+   */
+  Status ValidateHashes(ObjectMetadata const& metadata) const;
+
+ private:
+  void ResetHashes();
+
+  std::string bucket_name_;
+  std::string object_name_;
+  std::string source_file_;
+  std::uint64_t source_size_;
+  bool disable_md5_;
+  bool disable_crc32c_;
+  std::string session_id_;
+  std::uint64_t committed_bytes_;
+  std::uint32_t crc32c_;
+  MD5_CTX md5_;
+};
+
+/**
+ * Upload @p source using @p session, saving @p checkpoint after each chunk.
+ *
+ * The upload continues from `session.next_expected_byte()`. The checkpoint is
+ * saved to @p checkpoint_path after every successful chunk, and removed once
+ * the upload completes.
+ */
+StatusOr<ObjectMetadata> UploadWithCheckpoint(
+    ResumableUploadSession& session, std::istream& source,
+    std::size_t chunk_size, UploadCheckpoint& checkpoint,
+    std::string const& checkpoint_path);
+
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_INTERNAL_UPLOAD_CHECKPOINT_H_
@@ -0,0 +1,253 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/internal/upload_checkpoint.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/storage/internal/nljson.h"
+#include <gmock/gmock.h>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace internal {
+namespace {
+std::string const kQuickFox = "The quick brown fox jumps over the lazy dog";
+std::string const kQuickFoxMD5 = "nhB9nTcrtoJr2B01QqQZ1g==";
+std::string const kQuickFoxCrc32c = "ImIEBA==";
+
+/// A session that commits at most @p commit_size bytes of each chunk.
+class FakeSession : public ResumableUploadSession {
+ public:
+  explicit FakeSession(std::size_t commit_size, std::uint64_t committed = 0)
+      : commit_size_(commit_size), committed_(committed), id_("session-1") {}
+
+  StatusOr<ResumableUploadResponse> UploadChunk(
+      std::string const& buffer, std::uint64_t upload_size) override {
+    if (chunks.size() == fail_after) {
+      return Status(StatusCode::kUnavailable, "try again");
+    }
+    chunks.push_back(buffer);
+    committed_ += std::min(buffer.size(), commit_size_);
+    if (committed_ != upload_size) {
+      return ResumableUploadResponse{id_, committed_ - 1, {}};
+    }
+    nl::json metadata{{"bucket", "test-bucket"},
+                      {"name", "test-object"},
+                      {"crc32c", crc32c},
+                      {"md5Hash", md5}};
+    return ResumableUploadResponse{id_, committed_ - 1, metadata.dump()};
+  }
+  StatusOr<ResumableUploadResponse> ResetSession() override {
+    return ResumableUploadResponse{id_, committed_ - 1, {}};
+  }
+  std::uint64_t next_expected_byte() const override { return committed_; }
+  std::string const& session_id() const override { return id_; }
+
+  std::vector<std::string> chunks;
+  std::string crc32c = kQuickFoxCrc32c;
+  std::string md5 = kQuickFoxMD5;
+  std::size_t fail_after = std::numeric_limits<std::size_t>::max();
+
+ private:
+  std::size_t commit_size_;
+  std::uint64_t committed_;
+  std::string id_;
+};
+
+class UploadCheckpointTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto generator = google::cloud::internal::MakeDefaultPRNG();
+    path_ = ::testing::TempDir() + "upload-checkpoint-" +
+            google::cloud::internal::Sample(
+                generator, 16, "abcdefghijklmnopqrstuvwxyz0123456789");
+  }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  static UploadCheckpoint MakeCheckpoint() {
+    return UploadCheckpoint("test-bucket", "test-object", "/tmp/fox.txt",
+                            kQuickFox.size(), false, false);
+  }
+
+  static ObjectMetadata MakeMetadata(std::string const& crc32c,
+                                     std::string const& md5) {
+    return ObjectMetadataParser::FromJson(nl::json{
+                                              {"crc32c", crc32c},
+                                              {"md5Hash", md5},
+                                          })
+        .value();
+  }
+
+  bool CheckpointExists() const { return std::ifstream(path_).is_open(); }
+
+  std::string path_;
+};
+
+TEST_F(UploadCheckpointTest, SaveAndLoad) {
+  auto checkpoint = MakeCheckpoint();
+  checkpoint.set_session_id("session-1");
+  checkpoint.Commit(kQuickFox.data(), 10);
+  ASSERT_TRUE(checkpoint.Save(path_).ok());
+
+  auto loaded = UploadCheckpoint::Load(path_);
+  ASSERT_TRUE(loaded.ok()) << loaded.status();
+  EXPECT_EQ("test-bucket", loaded->bucket_name());
+  EXPECT_EQ("test-object", loaded->object_name());
+  EXPECT_EQ("/tmp/fox.txt", loaded->source_file());
+  EXPECT_EQ(kQuickFox.size(), loaded->source_size());
+  EXPECT_EQ("session-1", loaded->session_id());
+  EXPECT_EQ(10U, loaded->committed_bytes());
+  EXPECT_TRUE(loaded->SameUpload(MakeCheckpoint()));
+
+  // The hash state survives the round trip.
+  loaded->Commit(kQuickFox.data() + 10, kQuickFox.size() - 10);
+  EXPECT_TRUE(
+      loaded->ValidateHashes(MakeMetadata(kQuickFoxCrc32c, kQuickFoxMD5)).ok());
+}
+
+TEST_F(UploadCheckpointTest, LoadErrors) {
+  auto missing = UploadCheckpoint::Load(path_);
+  EXPECT_EQ(StatusCode::kNotFound, missing.status().code());
+
+  std::ofstream(path_) << R"""({"bucket": "test-bucket"})""";
+  auto invalid = UploadCheckpoint::Load(path_);
+  EXPECT_EQ(StatusCode::kInvalidArgument, invalid.status().code());
+
+  std::ofstream(path_) << "not json";
+  invalid = UploadCheckpoint::Load(path_);
+  EXPECT_EQ(StatusCode::kInvalidArgument, invalid.status().code());
+}
+
+TEST_F(UploadCheckpointTest, SameUpload) {
+  auto checkpoint = MakeCheckpoint();
+  // Checkpoints without a session cannot be resumed.
+  EXPECT_FALSE(checkpoint.SameUpload(MakeCheckpoint()));
+  checkpoint.set_session_id("session-1");
+  EXPECT_TRUE(checkpoint.SameUpload(MakeCheckpoint()));
+  EXPECT_FALSE(checkpoint.SameUpload(UploadCheckpoint(
+      "test-bucket", "test-object", "/tmp/fox.txt", 7, false, false)));
+  EXPECT_FALSE(checkpoint.SameUpload(UploadCheckpoint(
+      "test-bucket", "other-object", "/tmp/fox.txt", kQuickFox.size(), false,
+      false)));
+}
+
+TEST_F(UploadCheckpointTest, ValidateHashes) {
+  auto checkpoint = MakeCheckpoint();
+  checkpoint.Commit(kQuickFox.data(), kQuickFox.size());
+  EXPECT_TRUE(
+      checkpoint.ValidateHashes(MakeMetadata(kQuickFoxCrc32c, kQuickFoxMD5))
+          .ok());
+  // Missing values in the metadata are not mismatches.
+  EXPECT_TRUE(checkpoint.ValidateHashes(MakeMetadata("", "")).ok());
+  auto status =
+      checkpoint.ValidateHashes(MakeMetadata(kQuickFoxCrc32c, "bad-md5"));
+  EXPECT_EQ(StatusCode::kDataLoss, status.code());
+  EXPECT_THAT(status.message(), ::testing::HasSubstr(kQuickFoxMD5));
+
+  UploadCheckpoint disabled("test-bucket", "test-object", "/tmp/fox.txt",
+                            kQuickFox.size(), true, true);
+  disabled.Commit(kQuickFox.data(), kQuickFox.size());
+  EXPECT_TRUE(disabled.ValidateHashes(MakeMetadata("bad", "bad")).ok());
+}
+
+TEST_F(UploadCheckpointTest, Upload) {
+  FakeSession session(16);
+  std::istringstream source(kQuickFox);
+  auto checkpoint = MakeCheckpoint();
+  auto metadata = UploadWithCheckpoint(session, source, 16, checkpoint, path_);
+  ASSERT_TRUE(metadata.ok()) << metadata.status();
+  EXPECT_EQ(kQuickFoxMD5, metadata->md5_hash());
+  EXPECT_THAT(session.chunks,
+              ::testing::ElementsAre(kQuickFox.substr(0, 16),
+                                     kQuickFox.substr(16, 16),
+                                     kQuickFox.substr(32)));
+  // Completed uploads remove the checkpoint.
+  EXPECT_FALSE(CheckpointExists());
+}
+
+TEST_F(UploadCheckpointTest, PartialCommits) {
+  // The service commits only part of each chunk, the upload resends the rest.
+  FakeSession session(10);
+  std::istringstream source(kQuickFox);
+  auto checkpoint = MakeCheckpoint();
+  auto metadata = UploadWithCheckpoint(session, source, 16, checkpoint, path_);
+  ASSERT_TRUE(metadata.ok()) << metadata.status();
+  ASSERT_EQ(5U, session.chunks.size());
+  EXPECT_EQ(kQuickFox.substr(10, 16), session.chunks[1]);
+}
+
+TEST_F(UploadCheckpointTest, ResumeFromCheckpoint) {
+  // Simulate a crash after the first chunk was committed and saved.
+  auto saved = MakeCheckpoint();
+  saved.set_session_id("session-1");
+  saved.Commit(kQuickFox.data(), 16);
+
+  FakeSession session(16, 16);
+  // Poison the committed prefix, it must not be read again.
+  std::istringstream source(std::string(16, 'x') + kQuickFox.substr(16));
+  auto metadata = UploadWithCheckpoint(session, source, 16, saved, path_);
+  ASSERT_TRUE(metadata.ok()) << metadata.status();
+  EXPECT_THAT(session.chunks,
+              ::testing::ElementsAre(kQuickFox.substr(16, 16),
+                                     kQuickFox.substr(32)));
+}
+
+TEST_F(UploadCheckpointTest, CatchUpWithService) {
+  // The service committed a chunk that was never recorded in the checkpoint,
+  // only that chunk is read to update the hashes.
+  auto saved = MakeCheckpoint();
+  saved.set_session_id("session-1");
+  saved.Commit(kQuickFox.data(), 16);
+
+  FakeSession session(16, 32);
+  std::istringstream source(std::string(16, 'x') + kQuickFox.substr(16));
+  auto metadata = UploadWithCheckpoint(session, source, 16, saved, path_);
+  ASSERT_TRUE(metadata.ok()) << metadata.status();
+  EXPECT_THAT(session.chunks, ::testing::ElementsAre(kQuickFox.substr(32)));
+}
+
+TEST_F(UploadCheckpointTest, SavedAfterEachChunk) {
+  FakeSession session(16);
+  session.fail_after = 2;
+  std::istringstream source(kQuickFox);
+  auto checkpoint = MakeCheckpoint();
+  auto metadata = UploadWithCheckpoint(session, source, 16, checkpoint, path_);
+  EXPECT_EQ(StatusCode::kUnavailable, metadata.status().code());
+
+  auto loaded = UploadCheckpoint::Load(path_);
+  ASSERT_TRUE(loaded.ok()) << loaded.status();
+  EXPECT_EQ("session-1", loaded->session_id());
+  EXPECT_EQ(32U, loaded->committed_bytes());
+}
+
+TEST_F(UploadCheckpointTest, HashMismatch) {
+  FakeSession session(16);
+  session.md5 = "bad-md5";
+  std::istringstream source(kQuickFox);
+  auto checkpoint = MakeCheckpoint();
+  auto metadata = UploadWithCheckpoint(session, source, 16, checkpoint, path_);
+  EXPECT_EQ(StatusCode::kDataLoss, metadata.status().code());
+  EXPECT_FALSE(CheckpointExists());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,84 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/rate_limiting_policy.h"
+#include "google/cloud/internal/make_unique.h"
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+AimdRateLimitingPolicy::AimdRateLimitingPolicy(double initial_rate,
+                                               double maximum_rate,
+                                               double ramp_up,
+                                               double backoff_factor,
+                                               std::size_t object_prefix_length)
+    : object_prefix_length_(object_prefix_length),
+      controller_(initial_rate, maximum_rate, ramp_up, backoff_factor) {}
+
+std::unique_ptr<RateLimitingPolicy> AimdRateLimitingPolicy::clone() const {
+  return google::cloud::internal::make_unique<AimdRateLimitingPolicy>(
+      controller_.initial_rate(), controller_.maximum_rate(),
+      controller_.ramp_up(), controller_.backoff_factor(),
+      object_prefix_length_);
+}
+
+bool AimdRateLimitingPolicy::Admit(std::string const& bucket_name,
+                                   std::string const& object_name,
+                                   std::chrono::milliseconds maximum_wait) {
+  auto delay =
+      controller_.TryReserve(Key(bucket_name, object_name),
+                             internal::AimdRateController::Clock::now(),
+                             maximum_wait);
+  if (!delay.has_value()) {
+    return false;
+  }
+  if (delay->count() > 0) {
+    std::this_thread::sleep_for(*delay);
+  }
+  return true;
+}
+
+void AimdRateLimitingPolicy::OnResponse(std::string const& bucket_name,
+                                        std::string const& object_name,
+                                        long http_status_code) {
+  // Only the service throttles with these codes, other errors (including 500
+  // and 502, which also map to `kUnavailable`) say nothing about the rate.
+  bool throttled = http_status_code == 429 || http_status_code == 503;
+  controller_.OnCompletion(Key(bucket_name, object_name), throttled,
+                           internal::AimdRateController::Clock::now());
+}
+
+double AimdRateLimitingPolicy::rate(std::string const& bucket_name,
+                                    std::string const& object_name) const {
+  return controller_.rate(Key(bucket_name, object_name));
+}
+
+RateLimitingStats AimdRateLimitingPolicy::stats() const {
+  return controller_.stats(internal::AimdRateController::Clock::now());
+}
+
+std::string AimdRateLimitingPolicy::Key(std::string const& bucket_name,
+                                        std::string const& object_name) const {
+  if (object_prefix_length_ == 0) {
+    return bucket_name;
+  }
+  return bucket_name + "/" + object_name.substr(0, object_prefix_length_);
+}
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,160 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_RATE_LIMITING_POLICY_H_
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_RATE_LIMITING_POLICY_H_
+
+#include "google/cloud/storage/internal/aimd_rate_controller.h"
+#include "google/cloud/storage/version.h"
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+/**
+ * Define the interface for the rate limiting policy.
+ *
+ * Cloud Storage scales the request rate it can serve for a bucket (or a range
+ * of object names) gradually. Applications that start sending requests to a
+ * new bucket or prefix at a very high rate receive throttling errors, and
+ * retrying each request independently can make the problem worse.
+ *
+ * A rate limiting policy controls how fast the client sends requests. The
+ * policy may delay a request before it is sent. It rejects the request only
+ * if the delay would exceed the time left in the retry policy, in which case
+ * the operation fails with `kResourceExhausted` instead of waiting.
+ *
+ * Unlike the retry and backoff policies, a single instance of the rate limiting
+ * policy is shared by all the operations of a client. Implementations must be
+ * thread-safe.
+ */
+class RateLimitingPolicy {
+ public:
+  virtual ~RateLimitingPolicy() = default;
+
+  /// Create a new copy of this object, the copy does not share any state.
+  virtual std::unique_ptr<RateLimitingPolicy> clone() const = 0;
+
+  /**
+   * Block until a request on the given bucket and object can be sent.
+   *
+   * @param bucket_name the bucket targeted by the request, empty for requests
+   *     that do not target a bucket, such as `ListBuckets()`.
+   * @param object_name the object targeted by the request, empty for requests
+   *     that do not target an object.
+   * @param maximum_wait how long the request may wait, typically the time left
+   *     in the retry policy.
+   * @return false, without blocking, if the request cannot be sent within
+   *     @p maximum_wait.
+   */
+  virtual bool Admit(std::string const& bucket_name,
+                     std::string const& object_name,
+                     std::chrono::milliseconds maximum_wait) = 0;
+
+  /**
+   * Called with the HTTP status code of each response to an admitted request.
+   *
+   * Downloads and streaming uploads report their response when it arrives,
+   * which may be after the operation returned, and possibly from a different
+   * thread. Requests that fail without a response (e.g. because the
+   * connection could not be established) are not reported.
+   */
+  virtual void OnResponse(std::string const& bucket_name,
+                          std::string const& object_name,
+                          long http_status_code) = 0;
+};
+
+/// The counters reported by `AimdRateLimitingPolicy`.
+using RateLimitingStats = internal::RateControllerStats;
+
+/**
+ * Ramp up the request rate gradually and back off when throttled.
+ *
+ * This policy keeps a separate request rate for each bucket, or, if
+ * `object_prefix_length` is not zero, for each bucket and object name prefix.
+ * Requests are queued and sent at the current rate. While requests are queued
+ * the rate grows linearly (additive increase), and each throttling response
+ * (HTTP 429 or 503) reduces the rate by a constant factor (multiplicative
+ * decrease). Other errors, including network errors, do not change the rate.
+ *
+ * Requests are not queued longer than the time left in their retry policy,
+ * and `stats().rejected_count` counts the requests that failed for this
+ * reason.
+ *
+ * Because all the threads using a client share the policy, a burst of requests
+ * that hits a new prefix is spread over time, instead of each thread retrying
+ * independently.
+ *
+ * @par Example
+ * @code
+ * auto rate_limiting = std::make_shared<gcs::AimdRateLimitingPolicy>();
+ * gcs::Client client(gcs::ClientOptions(credentials), rate_limiting);
+ * // ... later ...
+ * auto stats = rate_limiting->stats();
+ * std::cout << "accepted QPS=" << stats.accepted_qps << "\n";
+ * @endcode
+ */
+class AimdRateLimitingPolicy : public RateLimitingPolicy {
+ public:
+  /**
+   * Create a policy.
+   *
+   * @param initial_rate the initial rate for each bucket or prefix, in
+   *     requests per second.
+   * @param maximum_rate the maximum rate for each bucket or prefix, in
+   *     requests per second.
+   * @param ramp_up how fast the rate grows while requests are queued, in
+   *     requests per second, per second.
+   * @param backoff_factor multiply the rate by this factor (in the `(0, 1)`
+   *     range) when a request is throttled.
+   * @param object_prefix_length if not zero, keep a separate rate for each
+   *     distinct object name prefix of this length.
+   */
+  explicit AimdRateLimitingPolicy(double initial_rate = 1000.0,
+                                  double maximum_rate = 100000.0,
+                                  double ramp_up = 50.0,
+                                  double backoff_factor = 0.5,
+                                  std::size_t object_prefix_length = 0);
+
+  std::unique_ptr<RateLimitingPolicy> clone() const override;
+  bool Admit(std::string const& bucket_name, std::string const& object_name,
+             std::chrono::milliseconds maximum_wait) override;
+  void OnResponse(std::string const& bucket_name,
+                  std::string const& object_name,
+                  long http_status_code) override;
+
+  /// The rate currently allowed for the given bucket and object.
+  double rate(std::string const& bucket_name,
+              std::string const& object_name) const;
+
+  /// The aggregate counters across all buckets and prefixes.
+  RateLimitingStats stats() const;
+
+ private:
+  std::string Key(std::string const& bucket_name,
+                  std::string const& object_name) const;
+
+  std::size_t object_prefix_length_;
+  internal::AimdRateController controller_;
+};
+
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_STORAGE_RATE_LIMITING_POLICY_H_
@@ -0,0 +1,60 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/storage/rate_limiting_policy.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace storage {
+inline namespace STORAGE_CLIENT_NS {
+namespace {
+using ms = std::chrono::milliseconds;
+
+/// @test Verify that only the throttling responses reduce the rate.
+TEST(AimdRateLimitingPolicyTest, ThrottlingResponses) {
+  AimdRateLimitingPolicy tested(100.0, 1000.0, 0.0, 0.5);
+  for (long code : {200L, 404L, 500L, 502L}) {
+    tested.OnResponse("bucket", "object", code);
+  }
+  EXPECT_DOUBLE_EQ(100.0, tested.rate("bucket", "object"));
+  EXPECT_EQ(4U, tested.stats().accepted_count);
+
+  tested.OnResponse("bucket", "object", 429);
+  EXPECT_DOUBLE_EQ(50.0, tested.rate("bucket", "object"));
+  EXPECT_EQ(1U, tested.stats().throttled_count);
+
+  AimdRateLimitingPolicy unavailable(100.0, 1000.0, 0.0, 0.5);
+  unavailable.OnResponse("bucket", "object", 503);
+  EXPECT_DOUBLE_EQ(50.0, unavailable.rate("bucket", "object"));
+}
+
+/// @test Verify that Admit() does not wait longer than allowed.
+TEST(AimdRateLimitingPolicyTest, AdmitBounded) {
+  // At one request per second the second request waits for a second.
+  AimdRateLimitingPolicy tested(1.0, 1.0, 0.0, 0.5);
+  EXPECT_TRUE(tested.Admit("bucket", "object", ms(0)));
+  EXPECT_FALSE(tested.Admit("bucket", "object", ms(100)));
+  EXPECT_FALSE(tested.Admit("bucket", "object", ms(0)));
+
+  auto stats = tested.stats();
+  EXPECT_EQ(1U, stats.admitted_count);
+  EXPECT_EQ(2U, stats.rejected_count);
+}
+
+}  // namespace
+}  // namespace STORAGE_CLIENT_NS
+}  // namespace storage
+}  // namespace cloud
+}  // namespace google
@@ -21,13 +21,18 @@ storage_client_hdrs = [
     "bucket_metadata.h",
     "client.h",
     "client_options.h",
+    "connection_pool_stats.h",
     "download_options.h",
+    "download_cache.h",
     "hashing_options.h",
+    "hedging_policy.h",
     "idempotency_policy.h",
     "internal/access_control_common.h",
+    "internal/aimd_rate_controller.h",
     "internal/binary_data_as_debug_string.h",
     "internal/bucket_acl_requests.h",
     "internal/bucket_requests.h",
+    "internal/caching_client.h",
     "internal/complex_option.h",
     "internal/common_metadata.h",
     "internal/compute_engine_util.h",
@@ -43,13 +48,16 @@ storage_client_hdrs = [
     "internal/curl_resumable_upload_session.h",
     "internal/curl_streambuf.h",
     "internal/default_object_acl_requests.h",
+    "internal/download_cache_streambuf.h",
     "internal/empty_response.h",
     "internal/format_rfc3339.h",
     "internal/generate_message_boundary.h",
     "internal/generic_object_request.h",
     "internal/generic_request.h",
     "internal/hash_validator.h",
+    "internal/hedging_executor.h",
     "internal/http_response.h",
+    "internal/http_response_observer.h",
     "internal/logging_client.h",
     "internal/logging_resumable_upload_session.h",
     "internal/metadata_parser.h",
@@ -68,6 +76,7 @@ storage_client_hdrs = [
     "internal/retry_resumable_upload_session.h",
     "internal/service_account_requests.h",
     "internal/signed_url_requests.h",
+    "internal/upload_checkpoint.h",
     "lifecycle_rule.h",
     "list_buckets_reader.h",
     "list_objects_reader.h",
@@ -87,6 +96,7 @@ storage_client_hdrs = [
     "object_metadata.h",
     "object_rewriter.h",
     "object_stream.h",
+    "rate_limiting_policy.h",
     "retry_policy.h",
     "service_account.h",
     "signed_url_options.h",
@@ -102,12 +112,15 @@ storage_client_srcs = [
     "bucket_metadata.cc",
     "client.cc",
     "client_options.cc",
+    "download_cache.cc",
     "hashing_options.cc",
     "idempotency_policy.cc",
     "internal/access_control_common.cc",
+    "internal/aimd_rate_controller.cc",
     "internal/binary_data_as_debug_string.cc",
     "internal/bucket_acl_requests.cc",
     "internal/bucket_requests.cc",
+    "internal/caching_client.cc",
     "internal/compute_engine_util.cc",
     "internal/curl_handle.cc",
     "internal/curl_handle_factory.cc",
@@ -121,10 +134,13 @@ storage_client_srcs = [
     "internal/curl_resumable_upload_session.cc",
     "internal/curl_streambuf.cc",
     "internal/default_object_acl_requests.cc",
+    "internal/download_cache_streambuf.cc",
     "internal/empty_response.cc",
     "internal/format_rfc3339.cc",
     "internal/hash_validator.cc",
+    "internal/hedging_executor.cc",
     "internal/http_response.cc",
+    "internal/http_response_observer.cc",
     "internal/logging_client.cc",
     "internal/logging_resumable_upload_session.cc",
     "internal/metadata_parser.cc",
@@ -138,6 +154,7 @@ storage_client_srcs = [
     "internal/retry_resumable_upload_session.cc",
     "internal/service_account_requests.cc",
     "internal/signed_url_requests.cc",
+    "internal/upload_checkpoint.cc",
     "lifecycle_rule.cc",
     "list_buckets_reader.cc",
     "list_objects_reader.cc",
@@ -152,6 +169,7 @@ storage_client_srcs = [
     "object_metadata.cc",
     "object_rewriter.cc",
     "object_stream.cc",
+    "rate_limiting_policy.cc",
     "service_account.cc",
     "signed_url_options.cc",
     "version.cc",
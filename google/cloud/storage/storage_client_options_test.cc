@@ -169,6 +169,31 @@ TEST_F(ClientOptionsTest, SetEnableLockingCallbacks) {
   EXPECT_TRUE(client_options.enable_ssl_locking_callbacks());
 }
 
+TEST_F(ClientOptionsTest, SetConnectionPoolPrewarmSize) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(0U, client_options.connection_pool_prewarm_size());
+  client_options.set_connection_pool_prewarm_size(8);
+  EXPECT_EQ(8U, client_options.connection_pool_prewarm_size());
+}
+
+TEST_F(ClientOptionsTest, SetConnectionPoolPrewarmTimeout) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(std::chrono::milliseconds(5000),
+            client_options.connection_pool_prewarm_timeout());
+  client_options.set_connection_pool_prewarm_timeout(
+      std::chrono::milliseconds(250));
+  EXPECT_EQ(std::chrono::milliseconds(250),
+            client_options.connection_pool_prewarm_timeout());
+}
+
+TEST_F(ClientOptionsTest, SetMaximumConnectionIdleTime) {
+  ClientOptions client_options(oauth2::CreateAnonymousCredentials());
+  EXPECT_EQ(0, client_options.maximum_connection_idle_time().count());
+  client_options.set_maximum_connection_idle_time(std::chrono::seconds(30));
+  EXPECT_EQ(std::chrono::milliseconds(30000),
+            client_options.maximum_connection_idle_time());
+}
+
 }  // namespace
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
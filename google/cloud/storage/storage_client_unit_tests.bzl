@@ -29,14 +29,18 @@ storage_client_unit_tests = [
     "client_sign_url_test.cc",
     "client_test.cc",
     "client_write_object_test.cc",
+    "download_cache_test.cc",
     "hashing_options_test.cc",
     "idempotency_policy_test.cc",
     "internal/access_control_common_test.cc",
+    "internal/aimd_rate_controller_test.cc",
     "internal/binary_data_as_debug_string_test.cc",
     "internal/bucket_acl_requests_test.cc",
     "internal/bucket_requests_test.cc",
+    "internal/caching_client_test.cc",
     "internal/compute_engine_util_test.cc",
     "internal/curl_client_test.cc",
+    "internal/curl_handle_factory_test.cc",
     "internal/curl_resumable_upload_session_test.cc",
     "internal/curl_wrappers_locking_already_present_test.cc",
     "internal/curl_wrappers_locking_enabled_test.cc",
@@ -45,6 +49,7 @@ storage_client_unit_tests = [
     "internal/format_rfc3339_test.cc",
     "internal/generate_message_boundary_test.cc",
     "internal/hash_validator_test.cc",
+    "internal/hedging_executor_test.cc",
     "internal/http_response_test.cc",
     "internal/logging_client_test.cc",
     "internal/logging_resumable_upload_session_test.cc",
@@ -59,6 +64,7 @@ storage_client_unit_tests = [
     "internal/retry_resumable_upload_session_test.cc",
     "internal/service_account_requests_test.cc",
     "internal/signed_url_requests_test.cc",
+    "internal/upload_checkpoint_test.cc",
     "lifecycle_rule_test.cc",
     "list_buckets_reader_test.cc",
     "list_objects_reader_test.cc",
@@ -72,6 +78,7 @@ storage_client_unit_tests = [
     "object_metadata_test.cc",
     "object_test.cc",
     "notification_metadata_test.cc",
+    "rate_limiting_policy_test.cc",
     "retry_policy_test.cc",
     "service_account_test.cc",
     "signed_url_options_test.cc",
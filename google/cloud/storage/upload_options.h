@@ -49,6 +49,34 @@ inline UseResumableUploadSession NewResumableUploadSession() {
   return UseResumableUploadSession("");
 }
 
+/**
+ * Record the progress of a resumable upload in a checkpoint file.
+ *
+ * When this option is used `Client::UploadFile()` always uses a resumable
+ * upload, and saves the session id, the number of bytes committed by the
+ * service, and the running CRC32C and MD5 hashes to the given file after each
+ * chunk. If the program is restarted and calls `UploadFile()` again with the
+ * same file, object, and checkpoint file, the upload continues from the last
+ * byte committed by the service, without reading the committed data again.
+ * The checkpoint file is removed when the upload completes.
+ *
+ * The checkpoint file is replaced atomically, a crash never leaves a partially
+ * written checkpoint. The application must not modify the source file until
+ * the upload completes.
+ *
+ * @par Example
+ * @code
+ * auto metadata = client.UploadFile(
+ *     "/data/large.bin", "my-bucket", "large.bin",
+ *     gcs::UseUploadCheckpoint("/data/large.bin.upload"));
+ * @endcode
+ */
+struct UseUploadCheckpoint
+    : public internal::ComplexOption<UseUploadCheckpoint, std::string> {
+  using ComplexOption<UseUploadCheckpoint, std::string>::ComplexOption;
+  static char const* name() { return "upload-checkpoint"; }
+};
+
 }  // namespace STORAGE_CLIENT_NS
 }  // namespace storage
 }  // namespace cloud